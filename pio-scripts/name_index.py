@@ -0,0 +1,78 @@
+# Generates wled00/fx_names.h: the position and length of every effect and palette name within
+# JSON_mode_names and JSON_palette_names (FX.h) and their alphabetical order, so names are looked up
+# without scanning the strings. Runs before every build, the header is only rewritten if it changed.
+# Can also be run by hand from the project directory: python pio-scripts/name_index.py
+import os
+import re
+
+SOURCE = os.path.join("wled00", "FX.h")
+TARGET = os.path.join("wled00", "fx_names.h")
+
+
+def names_of(text, array):
+    m = re.search(r'const char ' + array + r'\[\] PROGMEM = R"=====\((.*?)\)====="', text, re.S)
+    if not m:
+        raise Exception(f"name_index.py: {array} not found in {SOURCE}")
+    body = m.group(1)
+    names = []
+    for q in re.finditer(r'"([^"]*)"', body):
+        name = q.group(1).split("@")[0]  # settings extension
+        names.append((q.start(1), len(name), name))
+    return names
+
+
+def alpha_order(names, keep):
+    # case insensitive like the former usermod_v2_mode_sort, the first entries stay in place
+    key = lambda i: names[i][2].translate(str.maketrans("abcdefghijklmnopqrstuvwxyz", "ABCDEFGHIJKLMNOPQRSTUVWXYZ"))
+    return list(range(keep)) + sorted(range(keep, len(names)), key=key)
+
+
+def table(ctype, name, values, comment):
+    lines = [f"//{comment}", f"const {ctype} {name}[] PROGMEM = {{"]
+    for i in range(0, len(values), 20):
+        lines.append("  " + ",".join(str(v) for v in values[i:i + 20]) + ",")
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def generate():
+    with open(SOURCE, "r", encoding="utf-8") as f:
+        text = f.read()
+    modes = names_of(text, "JSON_mode_names")
+    palettes = names_of(text, "JSON_palette_names")
+    keep = 1
+    while keep < len(palettes) and palettes[keep][2].startswith("*"):
+        keep += 1
+
+    out = [
+        "//generated from JSON_mode_names and JSON_palette_names in FX.h by pio-scripts/name_index.py, do not edit",
+        "#ifndef WLED_FX_NAMES_H",
+        "#define WLED_FX_NAMES_H",
+        "",
+        f"#define FX_NAME_COUNT  {len(modes)}",
+        f"#define PAL_NAME_COUNT {len(palettes)}",
+        f"#define PAL_NAME_FIXED {keep} //Default and the color palettes, not sorted",
+        "",
+        table("uint16_t", "JSON_mode_name_pos", [n[0] for n in modes], "offset of each effect name in JSON_mode_names"),
+        table("uint8_t", "JSON_mode_name_len", [n[1] for n in modes], "its length, without a settings extension"),
+        table("uint8_t", "JSON_mode_alpha", alpha_order(modes, 1), "effects in alphabetical order, Solid first"),
+        "",
+        table("uint16_t", "JSON_palette_name_pos", [n[0] for n in palettes], "offset of each palette name in JSON_palette_names"),
+        table("uint8_t", "JSON_palette_name_len", [n[1] for n in palettes], "its length"),
+        table("uint8_t", "JSON_palette_alpha", alpha_order(palettes, keep), "palettes in alphabetical order after the fixed ones"),
+        "",
+        "#endif",
+        "",
+    ]
+    header = "\n".join(out)
+    old = None
+    if os.path.exists(TARGET):
+        with open(TARGET, "r", encoding="utf-8") as f:
+            old = f.read()
+    if header != old:
+        with open(TARGET, "w", encoding="utf-8") as f:
+            f.write(header)
+        print(f"name_index.py: wrote {TARGET}")
+
+
+generate()
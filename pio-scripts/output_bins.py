@@ -66,4 +66,11 @@ def bin_gzip(source, target, env):
         with gzip.open(gzip_file, "wb", compresslevel = 9) as f:
             shutil.copyfileobj(fp, f)
 
+    # the release image is also offered compressed, /update inflates it while writing to flash
+    release_name = _get_cpp_define_value(env, "WLED_RELEASE_NAME")
+    if release_name:
+        version = _get_cpp_define_value(env, "WLED_VERSION")
+        release_file = "{}release{}WLED_{}_{}.bin".format(OUTPUT_DIR, os.path.sep, version, release_name)
+        shutil.copy(gzip_file, release_file + ".gz")
+
 env.AddPostAction("$BUILD_DIR/${PROGNAME}.bin", [bin_rename_copy, bin_gzip])
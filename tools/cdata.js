@@ -42,6 +42,7 @@ function hexdump(buffer) {
 
 const inliner = require("inliner");
 const zlib = require("zlib");
+const crypto = require("crypto");
 
 function strReplace(str, search, replacement) {
   return str.split(search).join(replacement);
@@ -86,6 +87,8 @@ function writeHtmlGzipped(sourceFile, resultFile) {
 
       console.info("Compressed " + result.length + " bytes");
       const array = hexdump(result);
+      // content hash of the compressed page, the ETag only changes when the UI does
+      const hash = crypto.createHash("sha1").update(result).digest("hex").substring(0, 8);
       const src = `/*
  * Binary array for the Web UI.
  * gzip is used for smaller size and improved speeds.
@@ -96,6 +99,7 @@ function writeHtmlGzipped(sourceFile, resultFile) {
  
 // Autogenerated from ${sourceFile}, do not edit!!
 const uint16_t PAGE_index_L = ${result.length};
+const char PAGE_index_hash[] PROGMEM = "${hash}"; // content hash, used as ETag
 const uint8_t PAGE_index[] PROGMEM = {
 ${array}
 };
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""
+Realtime ingest load test for WLED.
+
+Streams frames to a node using DDP, E1.31, Art-Net, WARLS or DNRGB at a given rate and size,
+then reads the realtime counters of /json/info ("rts") before and after the run and prints
+how many packets and frames the node received, rejected, dropped and pushed.
+
+  python3 tools/rt_load.py 192.168.1.50 --proto ddp --leds 1200 --fps 60 --seconds 20
+  python3 tools/rt_load.py 192.168.1.50 --proto e131 --leds 680 --fps 40 --jitter 10
+
+Raise --fps or --leds until "drop" grows or "push" falls behind the frames sent.
+E1.31 and Art-Net use consecutive universes from --universe with 170 RGB LEDs each (DMX mode
+"Multi RGB", start address 1). WARLS covers at most 255 LEDs.
+"""
+
+import argparse
+import json
+import random
+import socket
+import struct
+import time
+import urllib.request
+
+PORTS = {"ddp": 4048, "e131": 5568, "artnet": 6454, "warls": 21324, "dnrgb": 21324}
+LEDS_PER_UNIVERSE = 170
+DDP_LEDS_PER_PACKET = 480
+DNRGB_LEDS_PER_PACKET = 489
+
+
+def ddp_packets(frame, seq):
+    n = len(frame) // 3
+    packets = []
+    for first in range(0, n, DDP_LEDS_PER_PACKET):
+        data = frame[first * 3:(first + DDP_LEDS_PER_PACKET) * 3]
+        last = first + DDP_LEDS_PER_PACKET >= n
+        flags = 0x40 | (0x01 if last else 0)  # version 1, push with the last packet
+        header = struct.pack(">BBBBIH", flags, seq % 15 + 1, 0x0B, 1, first * 3, len(data))  # RGB 8 bit, display 1
+        packets.append(header + data)
+    return packets
+
+
+def e131_packet(universe, seq, data):
+    cid = b"WLED-rt-loadtest"
+    dmp = struct.pack(">HBBHHH", 0x7000 | (10 + len(data) + 1), 0x02, 0xA1, 0, 1, len(data) + 1) + b"\x00" + data
+    framing = struct.pack(">HI", 0x7000 | (77 + len(dmp)), 0x00000002) + b"rt_load".ljust(64, b"\x00") \
+        + struct.pack(">BHBBH", 100, 0, seq, 0, universe) + dmp
+    return struct.pack(">HH", 0x0010, 0) + b"ASC-E1.17\x00\x00\x00" \
+        + struct.pack(">HI", 0x7000 | (22 + len(framing)), 0x00000004) + cid + framing
+
+
+def artnet_packet(universe, seq, data):
+    if len(data) % 2:
+        data += b"\x00"
+    return b"Art-Net\x00" + struct.pack("<H", 0x5000) + struct.pack(">HBB", 14, seq, 0) \
+        + struct.pack("<H", universe) + struct.pack(">H", len(data)) + data
+
+
+def universe_packets(proto, frame, seq, first_universe):
+    packets = []
+    for i, first in enumerate(range(0, len(frame), LEDS_PER_UNIVERSE * 3)):
+        data = frame[first:first + LEDS_PER_UNIVERSE * 3]
+        u = first_universe + i
+        packets.append(e131_packet(u, seq, data) if proto == "e131" else artnet_packet(u, seq, data))
+    return packets
+
+
+def warls_packets(frame, timeout):
+    n = min(len(frame) // 3, 255)
+    p = bytearray([1, timeout])
+    for i in range(n):
+        p += bytes([i]) + frame[i * 3:i * 3 + 3]
+    return [bytes(p)]
+
+
+def dnrgb_packets(frame, timeout):
+    n = len(frame) // 3
+    packets = []
+    for first in range(0, n, DNRGB_LEDS_PER_PACKET):
+        data = frame[first * 3:(first + DNRGB_LEDS_PER_PACKET) * 3]
+        packets.append(bytes([4, timeout, first >> 8, first & 0xFF]) + data)
+    return packets
+
+
+def read_counters(host):
+    try:
+        with urllib.request.urlopen("http://%s/json/info" % host, timeout=3) as r:
+            return json.load(r).get("rts")
+    except (OSError, ValueError) as e:
+        print("could not read /json/info: %s" % e)
+        return None
+
+
+def make_frame(leds, n):
+    # a moving gradient, so every frame differs
+    return bytes((((i + n) * 4) & 0xFF, (i * 2) & 0xFF, (n * 3) & 0xFF)[c] for i in range(leds) for c in range(3))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="WLED realtime ingest load test")
+    ap.add_argument("host", help="IP address of the node")
+    ap.add_argument("--proto", choices=sorted(PORTS), default="ddp")
+    ap.add_argument("--leds", type=int, default=300, help="LEDs per frame")
+    ap.add_argument("--fps", type=float, default=40, help="frames per second")
+    ap.add_argument("--seconds", type=float, default=10, help="duration of the run")
+    ap.add_argument("--jitter", type=float, default=0, help="random delay of each frame, up to this many ms")
+    ap.add_argument("--loss", type=float, default=0, help="fraction of packets not sent, to exercise frame timeouts")
+    ap.add_argument("--reorder", type=float, default=0, help="fraction of frames whose packets are sent in reverse order")
+    ap.add_argument("--universe", type=int, default=1, help="first universe (E1.31, Art-Net)")
+    ap.add_argument("--port", type=int, help="override the default port of the protocol")
+    args = ap.parse_args()
+
+    port = args.port or PORTS[args.proto]
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    before = read_counters(args.host)
+
+    interval = 1.0 / args.fps
+    frames = packets = sent_bytes = 0
+    start = time.monotonic()
+    next_frame = start
+    late = 0
+    while time.monotonic() - start < args.seconds:
+        frame = make_frame(args.leds, frames)
+        seq = frames & 0xFF
+        if args.proto == "ddp":
+            out = ddp_packets(frame, frames)
+        elif args.proto in ("e131", "artnet"):
+            out = universe_packets(args.proto, frame, seq or 1, args.universe)
+        elif args.proto == "warls":
+            out = warls_packets(frame, 2)
+        else:
+            out = dnrgb_packets(frame, 2)
+        if args.reorder and random.random() < args.reorder:
+            out.reverse()
+        if args.jitter:
+            time.sleep(random.uniform(0, args.jitter) / 1000.0)
+        for p in out:
+            if args.loss and random.random() < args.loss:
+                continue
+            sock.sendto(p, (args.host, port))
+            packets += 1
+            sent_bytes += len(p)
+        frames += 1
+        next_frame += interval
+        wait = next_frame - time.monotonic()
+        if wait > 0:
+            time.sleep(wait)
+        else:
+            late += 1
+    elapsed = time.monotonic() - start
+
+    time.sleep(0.5)  # let the node finish the last frame
+    after = read_counters(args.host)
+    print("sent %d frames, %d packets, %.1f kB in %.1f s (%.1f fps, %d late on this host)"
+          % (frames, packets, sent_bytes / 1024.0, elapsed, frames / elapsed, late))
+    if before is None or after is None:
+        return
+    for key in ("rx", "seq", "drop", "push"):
+        print("%-5s %8d" % (key, after.get(key, 0) - before.get(key, 0)))
+    print("processing %d us avg, %d us max per packet" % (after.get("avg", 0), after.get("max", 0)))
+
+
+if __name__ == "__main__":
+    main()
@@ -212,6 +212,8 @@ class MyExampleUsermod : public Usermod {
      * handleOverlayDraw() is called just before every show() (LED strip update frame) after effects have set the colors.
      * Use this to blank out some LEDs or set them to a different color regardless of the set effect mode.
      * Commonly used for custom clocks (Cronixie, 7 segment)
+     * Overlays that rarely change can instead set their pixels once with overlaySetPixel()/overlaySetRange(getId(), ...)
+     * after overlayClear(getId()), they are then drawn over every frame until changed.
      */
     void handleOverlayDraw()
     {
@@ -228,6 +230,50 @@ class MyExampleUsermod : public Usermod {
       return USERMOD_ID_EXAMPLE;
     }
 
+    /*
+     * getLoopInterval() and getLoopPriority() let the usermod manager schedule loop().
+     * loop() is called at most every getLoopInterval() ms (0: every pass). Once the usermods took
+     * WLED_USERMOD_BUDGET_US in a pass, those with lower priority wait for the next one, so keep loop() short
+     * and avoid delay(). Runtimes are reported in info.umloop of /json/info.
+     */
+    uint16_t getLoopInterval()
+    {
+      return 0;
+    }
+
+    uint8_t getLoopPriority()
+    {
+      return USERMOD_PRIORITY_NORMAL;
+    }
+
+    /*
+     * getEventMask() selects the events (UM_EVENT_STATE, UM_EVENT_COLOR, UM_EVENT_PRESET, UM_EVENT_CONNECTED, ...
+     * see const.h) onEvent() is called for, so loop() does not have to compare state with cached copies.
+     */
+    uint16_t getEventMask()
+    {
+      return 0;
+    }
+
+    void onEvent(uint16_t event, uint8_t arg)
+    {
+    }
+
+    /*
+     * Blocking I/O (a sensor conversion, a display transfer) can be moved out of loop() with
+     * usermods.startTask(this, taskId, arg). runTask() is then called until it returns true, on a worker task on
+     * ESP32 or once per loop pass on ESP8266, so split long work into steps and do not touch strip or state there.
+     * onTaskDone() is called from the main loop afterwards, arg is yours again from then on.
+     */
+    bool runTask(uint8_t taskId, void* arg)
+    {
+      return true;
+    }
+
+    void onTaskDone(uint8_t taskId, void* arg)
+    {
+    }
+
    //More methods can be added in the future, this example will then be extended.
    //Your usermod will remain compatible as it does not need to implement all methods from the Usermod base class!
 };
\ No newline at end of file
@@ -7,10 +7,13 @@
 #include <TFT_eSPI.h>
 #include "Hardware.h"
 #include "ChipSelect.h"
+#include "../ST7789_display/tft_regions.h"
 
 class TFTs : public TFT_eSPI {
 private:
   uint8_t digits[NUM_DIGITS];
+  uint8_t pending = 0; // digits to show, one bit each
+  TftRegions display{*this}; // DMA transfers on ESP32
 
 
   // These read 16- and 32-bit types from the SD card file.
@@ -33,16 +36,16 @@ private:
     return result;
   }
 
-  uint16_t output_buffer[TFT_HEIGHT][TFT_WIDTH];
+  uint16_t output_buffer[TFT_HEIGHT][TFT_WIDTH]; // in display byte order, sent by DMA
   int16_t w = 135, h = 240, x = 0, y = 0, bufferedDigit = 255;
   uint16_t digitR, digitG, digitB, dimming = 255;
   uint32_t digitColor = 0;
 
+  static uint16_t swapped(uint16_t c) { return (c >> 8) | (c << 8); }
+
+  // returns while the buffer is sent, showDigit() waits for it before the buffer is reused
   void drawBuffer() {
-    bool oldSwapBytes = getSwapBytes();
-    setSwapBytes(true);
-    pushImage(x, y, w, h, (uint16_t *)output_buffer);
-    setSwapBytes(oldSwapBytes);
+    display.pushImage(x, y, w, h, (uint16_t *)output_buffer);
   }
 
   // These BMP functions are stolen directly from the TFT_SPIFFS_BMP example in the TFT_eSPI library.
@@ -87,7 +90,7 @@ private:
       for (col = 0; col < w; col++)
       {
         if (dimming == 255 && !digitColor) { // not needed, copy directly
-          output_buffer[row][col] = (lineBuffer[col*2+1] << 8) | (lineBuffer[col*2]);
+          output_buffer[row][col] = (lineBuffer[col*2]   << 8) | (lineBuffer[col*2+1]);
         } else {
           // 16 BPP pixel format: R5, G6, B5 ; bin: RRRR RGGG GGGB BBBB
           PixM = lineBuffer[col*2+1];
@@ -104,7 +107,7 @@ private:
             r *= digitR; g *= digitG; b *= digitB;
             r  = r >> 8; g  = g >> 8; b  = b >> 8;
           }
-          output_buffer[row][col] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+          output_buffer[row][col] = swapped(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
         }
       }
     }
@@ -209,7 +212,7 @@ private:
           r *= digitR; g *= digitG; b *= digitB;
           r  = r >> 8; g  = g >> 8; b  = b >> 8;
         }
-        output_buffer[row][col] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xFF) >> 3);
+        output_buffer[row][col] = swapped(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | ((b & 0xFF) >> 3));
       }
     }
     
@@ -262,7 +265,7 @@ private:
       for (col = 0; col < w; col++)
       {
         if (dimming == 255 && !digitColor) { // not needed, copy directly
-          output_buffer[row][col+x] = (lineBuffer[col*2+1] << 8) | (lineBuffer[col*2]);
+          output_buffer[row][col+x] = (lineBuffer[col*2]   << 8) | (lineBuffer[col*2+1]);
         } else {
           // 16 BPP pixel format: R5, G6, B5 ; bin: RRRR RGGG GGGB BBBB
           PixM = lineBuffer[col*2+1];
@@ -279,7 +282,7 @@ private:
             r *= digitR; g *= digitG; b *= digitB;
             r  = r >> 8; g  = g >> 8; b  = b >> 8;
           }
-          output_buffer[row][col+x] = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+          output_buffer[row][col+x] = swapped(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
         }
       }
     }
@@ -313,9 +316,11 @@ public:
 
     // Initialize the super class.
     init();
+    display.begin();
   }
 
   void showDigit(uint8_t digit) {
+    display.finish(); // the last digit is sent from the buffer, with its chip select
     chip_select.setDigit(digit);
     uint8_t digitToDraw = digits[digit];
     if (digitToDraw < 10) digitToDraw += digitOffset;
@@ -324,8 +329,20 @@ public:
       fillScreen(TFT_BLACK); return;
     }
 
+    // Color in grayscale bitmaps if Segment 1 exists
+    // TODO If secondary and tertiary are black, color all in primary,
+    // else color first three from Seg 1 color slots and last three from Seg 2 color slots
+    WS2812FX::Segment& seg1 = strip.getSegment(tubeSegment);
+    if (seg1.isActive()) {
+      digitColor = strip.getPixelColor(seg1.start + digit);
+      dimming = seg1.opacity;
+    } else {
+      digitColor = 0;
+      dimming = 255;
+    }
+
     // if last digit was the same, skip loading from FS to buffer
-    if (!digitColor && digitToDraw == bufferedDigit) drawBuffer();
+    if (!digitColor && digitToDraw == bufferedDigit) { drawBuffer(); return; }
     digitR = R(digitColor); digitG = G(digitColor); digitB = B(digitColor);
 
     // Filenames are no bigger than "254.bmp\0"
@@ -333,18 +350,18 @@ public:
     // Fastest, raw RGB565
     sprintf(file_name, "/%d.bin", digitToDraw);
     if (WLED_FS.exists(file_name)) {
-      if (drawBin(file_name)) bufferedDigit = digitToDraw;
+      if (drawBin(file_name)) bufferedDigit = digitColor ? 255 : digitToDraw;
       return;
     }
     // Fast, raw RGB565, see https://github.com/aly-fly/EleksTubeHAX on how to create this clk format
     sprintf(file_name, "/%d.clk", digitToDraw);
     if (WLED_FS.exists(file_name)) {
-      if (drawClk(file_name)) bufferedDigit = digitToDraw;
+      if (drawClk(file_name)) bufferedDigit = digitColor ? 255 : digitToDraw;
       return;
     }
     // Slow, regular RGB888 or 1,4,8 bit palette BMP
     sprintf(file_name, "/%d.bmp", digitToDraw);
-    if (drawBmp(file_name)) bufferedDigit = digitToDraw;
+    if (drawBmp(file_name)) bufferedDigit = digitColor ? 255 : digitToDraw;
     return;
   } 
 
@@ -352,22 +369,20 @@ public:
     uint8_t old_value = digits[digit];
     digits[digit] = value;
 
-    // Color in grayscale bitmaps if Segment 1 exists
-    // TODO If secondary and tertiary are black, color all in primary,
-    // else color first three from Seg 1 color slots and last three from Seg 2 color slots
-    WS2812FX::Segment& seg1 = strip.getSegment(tubeSegment);
-    if (seg1.isActive()) {
-      digitColor = strip.getPixelColor(seg1.start + digit);
-      dimming = seg1.opacity;
-    } else {
-      digitColor = 0;
-      dimming = 255;
-    }
-
     if (show != no && (old_value != value || show == force)) {
-      showDigit(digit);
+      pending |= 1 << digit;
     }
   }
+
+  // from loop(): shows one of the digits set since, at most TFT_MAX_FPS per second
+  void showPending() {
+    display.flush(); // frees the bus after a transfer
+    if (!pending || !display.ready()) return;
+    uint8_t digit = 0;
+    while (!(pending & (1 << digit))) digit++;
+    pending &= ~(1 << digit);
+    showDigit(digit);
+  }
   uint8_t getDigit(uint8_t digit) {return digits[digit];}
 
   void showAllDigits()            {for (uint8_t digit=0; digit < NUM_DIGITS; digit++) showDigit(digit);}
@@ -60,6 +60,7 @@ class ElekstubeIPSUsermod : public Usermod {
     }
 
     void loop() {
+      tfts.showPending();
       if (!toki.isTick()) return;
       updateLocalTime();
 
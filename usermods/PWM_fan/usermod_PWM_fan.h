@@ -104,7 +104,7 @@ class PWMFanUsermod : public Usermod {
       }
 
       #ifdef ESP8266
-      analogWriteRange(255);
+      analogWriteRange(WLED_PWM_MAX_DUTY); //shared with the analog LED busses
       analogWriteFreq(WLED_PWM_FREQ);
       #else
       pwmChannel = pinManager.allocateLedc(1);
@@ -133,7 +133,7 @@ class PWMFanUsermod : public Usermod {
       if (pwmPin < 0) return;
 
       #ifdef ESP8266
-      analogWrite(pwmPin, pwmValue);
+      analogWrite(pwmPin, ((uint32_t)pwmValue * WLED_PWM_MAX_DUTY) / 255);
       #else
       ledcWrite(pwmChannel, pwmValue);
       #endif
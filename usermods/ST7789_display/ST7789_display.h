@@ -6,6 +6,7 @@
 #include "wled.h"
 #include <TFT_eSPI.h>
 #include <SPI.h>
+#include "tft_regions.h"
 
 #define USERMOD_ST7789_DISPLAY 97
 
@@ -24,6 +25,7 @@
 #define TFT_BL              26  // Display backlight control pin
 
 TFT_eSPI tft = TFT_eSPI(240, 240); // Invoke custom library
+TftRegions tftRows(tft); // only changed rows are sent to the display
 
 // How often we are redrawing screen
 #define USER_LOOP_REFRESH_RATE_MS 1000
@@ -47,6 +49,18 @@ class St7789DisplayUsermod : public Usermod {
     uint8_t knownPalette = 0;
     uint8_t tftcharwidth = 19;  // Number of chars that fit on screen with text size set to 2
     long lastUpdate = 0;
+    // top of the text rows, each has a region of the screen drawn into a sprite
+    const uint8_t rowY[6] = {40, 64, 86, 108, 130, 152};
+
+    // clears a text row for printing
+    TFT_eSprite& line(uint8_t row, uint16_t color) {
+      TFT_eSprite& s = tftRows.draw(row);
+      s.fillSprite(TFT_BLACK);
+      s.setTextSize(2);
+      s.setTextColor(color);
+      s.setCursor(3, 0);
+      return s;
+    }
 
   public:
     //Functions called by WLED
@@ -60,11 +74,11 @@ class St7789DisplayUsermod : public Usermod {
         tft.init();
         tft.setRotation(0);  //Rotation here is set up for the text to be readable with the port on the left. Use 1 to flip.
         tft.fillScreen(TFT_BLACK);
-        tft.setTextColor(TFT_RED);
-        tft.setCursor(60, 100);
-        tft.setTextDatum(MC_DATUM);
-        tft.setTextSize(2);
-        tft.print("Loading...");
+        tftRows.begin();
+        for (uint8_t i = 0; i < 6; i++) tftRows.add(0, rowY[i], 240, 16, 8);
+        TFT_eSprite& loading = line(2, TFT_RED);
+        loading.setCursor(60, 0);
+        loading.print("Loading...");
         if (TFT_BL > 0) 
         { // TFT_BL has been set in the TFT_eSPI library
          pinMode(TFT_BL, OUTPUT); // Set backlight pin to output mode
@@ -91,6 +105,7 @@ class St7789DisplayUsermod : public Usermod {
      *    Instead, use a timer check as shown here.
      */
     void loop() {
+    tftRows.flush();
 // Check if we time interval for redrawing passes.
     if (millis() - lastUpdate < USER_LOOP_REFRESH_RATE_MS)
         {
@@ -151,48 +166,40 @@ class St7789DisplayUsermod : public Usermod {
   knownMode = strip.getMainSegment().mode;
   knownPalette = strip.getMainSegment().palette;
 
-    tft.fillScreen(TFT_BLACK);
-    tft.setTextSize(2);
 // First row with Wifi name
-    tft.setTextColor(TFT_SILVER);
-    tft.setCursor(3, 40);
-    tft.print(knownSsid.substring(0, tftcharwidth > 1 ? tftcharwidth - 1 : 0));
+    TFT_eSprite& ssidRow = line(0, TFT_SILVER);
+    ssidRow.print(knownSsid.substring(0, tftcharwidth > 1 ? tftcharwidth - 1 : 0));
 // Print `~` char to indicate that SSID is longer, than our dicplay
     if (knownSsid.length() > tftcharwidth)
-        tft.print("~");
+        ssidRow.print("~");
 
 // Second row with AP IP and Password or IP
-    tft.setTextColor(TFT_GREEN);
-    tft.setTextSize(2);
-    tft.setCursor(3, 64);
 // Print AP IP and password in AP mode or knownIP if AP not active.
 
     if (apActive)
     {
-    tft.setTextColor(TFT_YELLOW);
-    tft.print("AP IP: ");
-    tft.print(knownIp);
-    tft.setCursor(3,86);
-    tft.setTextColor(TFT_YELLOW);
-    tft.print("AP Pass:");
-    tft.print(apPass);
+    TFT_eSprite& ipRow = line(1, TFT_YELLOW);
+    ipRow.print("AP IP: ");
+    ipRow.print(knownIp);
+    TFT_eSprite& passRow = line(2, TFT_YELLOW);
+    passRow.print("AP Pass:");
+    passRow.print(apPass);
     }
     else
     {
-    tft.setTextColor(TFT_GREEN);
-    tft.print("IP: ");
-    tft.print(knownIp);
-    tft.setCursor(3,86);
+    TFT_eSprite& ipRow = line(1, TFT_GREEN);
+    ipRow.print("IP: ");
+    ipRow.print(knownIp);
     //tft.print("Signal Strength: ");
     //tft.print(i.wifi.signal);
-    tft.setTextColor(TFT_WHITE);
-    tft.print("Bri: ");
-    tft.print(((float(bri)/255)*100),0);
-    tft.print("%");
+    TFT_eSprite& briRow = line(2, TFT_WHITE);
+    briRow.print("Bri: ");
+    briRow.print(((float(bri)/255)*100),0);
+    briRow.print("%");
     }
 
 // Third row with mode name
-    tft.setCursor(3, 108);
+    TFT_eSprite& modeRow = line(3, TFT_MAGENTA);
     uint8_t qComma = 0;
     bool insideQuotes = false;
     uint8_t printedChars = 0;
@@ -214,16 +221,14 @@ class St7789DisplayUsermod : public Usermod {
         default:
             if (!insideQuotes || (qComma != knownMode))
             break;
-        tft.setTextColor(TFT_MAGENTA);
-        tft.print(singleJsonSymbol);
+        modeRow.print(singleJsonSymbol);
         printedChars++;
         }
     if ((qComma > knownMode) || (printedChars > tftcharwidth - 1))
       break;
     }
 // Fourth row with palette name
-    tft.setTextColor(TFT_YELLOW);
-    tft.setCursor(3, 130);
+    TFT_eSprite& paletteRow = line(4, TFT_YELLOW);
     qComma = 0;
     insideQuotes = false;
     printedChars = 0;
@@ -244,7 +249,7 @@ class St7789DisplayUsermod : public Usermod {
         default:
             if (!insideQuotes || (qComma != knownPalette))
             break;
-        tft.print(singleJsonSymbol);
+        paletteRow.print(singleJsonSymbol);
         printedChars++;
         }
 // The following is modified from the code from the u8g2/u8g8 based code (knownPalette was knownMode)
@@ -252,12 +257,11 @@ class St7789DisplayUsermod : public Usermod {
       break;
     }
 // Fifth row with estimated mA usage
-    tft.setTextColor(TFT_SILVER);
-    tft.setCursor(3, 152);
+    TFT_eSprite& currentRow = line(5, TFT_SILVER);
 // Print estimated milliamp usage (must specify the LED type in LED prefs for this to be a reasonable estimate).
-    tft.print("Current: ");
-    tft.print(strip.currentMilliamps);
-    tft.print("mA");
+    currentRow.print("Current: ");
+    currentRow.print(strip.currentMilliamps);
+    currentRow.print("mA");
     }
     /*
      * addToJsonInfo() can be used to add custom entries to the /json/info part of the JSON API.
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "wled.h"
+#include <TFT_eSPI.h>
+
+//
+// Partial display updates for the TFT_eSPI usermods (ST7789_display, TTGO-T-Display, EleksTube_IPS).
+//
+// The usermod draws into sprites covering regions of the screen (e.g. a line of text). flush() sends the
+// rows of a region that changed since they were last sent, recognized by a checksum per row, at most one
+// region per call and one round over all regions every 1000/maxFps ms. On ESP32 the rows are copied to a
+// transfer buffer and sent by DMA while the loop continues, the next region waits until the bus is free
+// again, so nothing ever waits for the display. On ESP8266 pushImage() blocks as before.
+// Drawing directly to the display (fillScreen(), rotation...) needs finish() first.
+//
+
+#ifndef TFT_MAX_REGIONS
+  #define TFT_MAX_REGIONS 6
+#endif
+#ifndef TFT_MAX_FPS
+  #define TFT_MAX_FPS 20 // default for begin()
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+  #define TFT_REGIONS_DMA
+#endif
+
+class TftRegions {
+  private:
+    struct Region {
+      TFT_eSprite* sprite;  // drawn by the usermod
+      uint32_t* rowSum;     // checksum of each row as on the display
+      int16_t x, y;
+      uint16_t w, h;
+      bool drawn;           // since it was last sent
+      bool all;             // everything is sent with the next flush
+    };
+
+    TFT_eSPI& tft;
+    Region regions[TFT_MAX_REGIONS];
+    uint8_t count = 0;
+    uint8_t next = TFT_MAX_REGIONS; // region flush() checks next, all done if >= count
+    uint16_t frameMs = 50;
+    unsigned long lastRound = 0;
+    uint16_t* buf = nullptr; // rows in transfer, in display byte order
+    size_t bufPixels = 0;
+    bool writing = false;    // a transfer holds the bus
+
+    static uint32_t checksum(const uint8_t* p, size_t len) {
+      uint32_t h = 2166136261UL; // FNV-1a
+      while (len--) h = (h ^ *p++) * 16777619UL;
+      return h;
+    }
+
+    bool busy() {
+      #ifdef TFT_REGIONS_DMA
+      return writing && tft.dmaBusy();
+      #else
+      return false;
+      #endif
+    }
+
+    // data must stay untouched until the transfer is done, see finish()
+    void send(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* data) {
+      bool swap = tft.getSwapBytes();
+      tft.setSwapBytes(false);
+      if (!writing) { tft.startWrite(); writing = true; }
+      #ifdef TFT_REGIONS_DMA
+      tft.pushImageDMA(x, y, w, h, data);
+      #else
+      tft.pushImage(x, y, w, h, data);
+      #endif
+      tft.setSwapBytes(swap);
+    }
+
+    // copies rows first to last of the region into the transfer buffer and sends them
+    void sendRows(Region& r, uint16_t first, uint16_t last) {
+      uint16_t* out = buf;
+      for (uint16_t row = first; row <= last; row++) {
+        for (uint16_t col = 0; col < r.w; col++) {
+          uint16_t c = r.sprite->readPixel(col, row);
+          *out++ = (c >> 8) | (c << 8);
+        }
+      }
+      send(r.x, r.y + first, r.w, last - first + 1, buf);
+    }
+
+  public:
+    TftRegions(TFT_eSPI& display) : tft(display) {}
+
+    // after tft.init()
+    void begin(uint8_t maxFps = TFT_MAX_FPS) {
+      frameMs = 1000 / (maxFps ? maxFps : 1);
+      #ifdef TFT_REGIONS_DMA
+      tft.initDMA();
+      #endif
+    }
+
+    // a region of the screen, colorDepth 8 (RGB332) halves the memory of the sprite; -1 if out of memory
+    int8_t add(int16_t x, int16_t y, uint16_t w, uint16_t h, uint8_t colorDepth = 16) {
+      if (count >= TFT_MAX_REGIONS) return -1;
+      Region& r = regions[count];
+      r.sprite = new TFT_eSprite(&tft);
+      r.sprite->setColorDepth(colorDepth);
+      r.rowSum = (uint32_t*)calloc(h, sizeof(uint32_t));
+      if (!r.rowSum || !r.sprite->createSprite(w, h)) {
+        free(r.rowSum); delete r.sprite;
+        return -1;
+      }
+      if (bufPixels < (size_t)w * h) {
+        finish();
+        free(buf);
+        #ifdef TFT_REGIONS_DMA
+        buf = (uint16_t*)heap_caps_malloc(w * h * 2, MALLOC_CAP_DMA); // not in PSRAM
+        #else
+        buf = (uint16_t*)malloc(w * h * 2);
+        #endif
+        bufPixels = buf ? w * h : 0;
+        if (!buf) { r.sprite->deleteSprite(); delete r.sprite; free(r.rowSum); return -1; }
+      }
+      r.x = x; r.y = y; r.w = w; r.h = h;
+      r.drawn = r.all = true;
+      return count++;
+    }
+
+    // the sprite of a region, to draw into
+    TFT_eSprite& draw(uint8_t id) {
+      regions[id].drawn = true;
+      return *regions[id].sprite;
+    }
+
+    // sends all regions again with the next round, e.g. after fillScreen()
+    void invalidate() {
+      for (uint8_t i = 0; i < count; i++) regions[i].drawn = regions[i].all = true;
+    }
+
+    // from loop(): sends the changed rows of the next region that has some
+    void flush() {
+      if (busy()) return;
+      if (writing) { tft.endWrite(); writing = false; } // frees the bus between transfers
+      if (next >= count) {
+        if (!count || millis() - lastRound < frameMs) return;
+        lastRound = millis();
+        next = 0;
+      }
+      for (; next < count; next++) {
+        Region& r = regions[next];
+        if (!r.drawn) continue;
+        r.drawn = false;
+        int16_t first = -1, last = -1;
+        const uint8_t* img = (const uint8_t*)r.sprite->getPointer();
+        size_t rowBytes = r.w * r.sprite->getColorDepth() / 8;
+        for (uint16_t row = 0; row < r.h; row++) {
+          uint32_t sum = checksum(img + row * rowBytes, rowBytes);
+          if (sum == r.rowSum[row] && !r.all) continue;
+          r.rowSum[row] = sum;
+          if (first < 0) first = row;
+          last = row;
+        }
+        r.all = false;
+        if (first < 0) continue;
+        sendRows(r, first, last);
+        next++;
+        return;
+      }
+    }
+
+    // true if an image can be sent with pushImage() without waiting or exceeding the frame rate
+    bool ready() {
+      return !busy() && millis() - lastRound >= frameMs;
+    }
+
+    // sends a whole image (RGB565 in display byte order), which must stay untouched until finish()
+    void pushImage(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t* data) {
+      finish();
+      lastRound = millis();
+      send(x, y, w, h, data);
+    }
+
+    // waits for a running transfer and frees the bus
+    void finish() {
+      if (!writing) return;
+      #ifdef TFT_REGIONS_DMA
+      tft.dmaWait();
+      #endif
+      tft.endWrite();
+      writing = false;
+    }
+};
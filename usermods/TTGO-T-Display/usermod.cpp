@@ -25,6 +25,7 @@
 #include <SPI.h>
 #include "WiFi.h"
 #include <Wire.h>
+#include "../usermods/ST7789_display/tft_regions.h" // as copied to wled00
 
 #ifndef TFT_DISPOFF
 #define TFT_DISPOFF 0x28
@@ -44,6 +45,19 @@
 #define ADC_EN          14  // Used for enabling battery voltage measurements - not used in this program
 
 TFT_eSPI tft = TFT_eSPI(135, 240); // Invoke custom library
+TftRegions tftRows(tft); // only changed rows are sent to the display
+// top of the text rows, each has a region of the screen drawn into a sprite
+const uint8_t rowY[6] = {1, 24, 46, 68, 90, 112};
+
+// clears a text row for printing
+TFT_eSprite& line(uint8_t row) {
+  TFT_eSprite& s = tftRows.draw(row);
+  s.fillSprite(TFT_BLACK);
+  s.setTextSize(2);
+  s.setTextColor(TFT_WHITE);
+  s.setCursor(1, 0);
+  return s;
+}
 
 //gets called once at boot. Do all initialization that doesn't depend on network here
 void userSetup() {
@@ -52,12 +66,9 @@ void userSetup() {
     tft.init();
     tft.setRotation(3);  //Rotation here is set up for the text to be readable with the port on the left. Use 1 to flip.
     tft.fillScreen(TFT_BLACK);
-    tft.setTextSize(2);
-    tft.setTextColor(TFT_WHITE);
-    tft.setCursor(1, 10);
-    tft.setTextDatum(MC_DATUM);
-    tft.setTextSize(3);
-    tft.print("Loading...");
+    tftRows.begin();
+    for (uint8_t i = 0; i < 6; i++) tftRows.add(0, rowY[i], 240, 16, 8);
+    line(0).print("Loading...");
 
     if (TFT_BL > 0) { // TFT_BL has been set in the TFT_eSPI library in the User Setup file TTGO_T_Display.h
          pinMode(TFT_BL, OUTPUT); // Set backlight pin to output mode
@@ -90,6 +101,7 @@ bool displayTurnedOff = false;
 #define USER_LOOP_REFRESH_RATE_MS 5000
 
 void userLoop() {
+  tftRows.flush();
 
   // Check if we time interval for redrawing passes.
   if (millis() - lastUpdate < USER_LOOP_REFRESH_RATE_MS) {
@@ -139,18 +151,15 @@ void userLoop() {
   knownMode = strip.getMainSegment().mode;
   knownPalette = strip.getMainSegment().palette;
 
-  tft.fillScreen(TFT_BLACK);
-  tft.setTextSize(2);
   // First row with Wifi name
-  tft.setCursor(1, 1);
-  tft.print(knownSsid.substring(0, tftcharwidth > 1 ? tftcharwidth - 1 : 0));
+  TFT_eSprite& ssidRow = line(0);
+  ssidRow.print(knownSsid.substring(0, tftcharwidth > 1 ? tftcharwidth - 1 : 0));
   // Print `~` char to indicate that SSID is longer, than our dicplay
   if (knownSsid.length() > tftcharwidth)
-    tft.print("~");
+    ssidRow.print("~");
 
   // Second row with AP IP and Password or IP
-  tft.setTextSize(2);
-  tft.setCursor(1, 24);
+  TFT_eSprite& ipRow = line(1);
   // Print AP IP and password in AP mode or knownIP if AP not active.
   // if (apActive && bri == 0)
   //   tft.print(apPass);
@@ -158,25 +167,25 @@ void userLoop() {
   //   tft.print(knownIp);
 
   if (apActive) {
-    tft.print("AP IP: ");
-    tft.print(knownIp);
-    tft.setCursor(1,46);
-    tft.print("AP Pass:");
-    tft.print(apPass);
+    ipRow.print("AP IP: ");
+    ipRow.print(knownIp);
+    TFT_eSprite& passRow = line(2);
+    passRow.print("AP Pass:");
+    passRow.print(apPass);
   }
   else {
-    tft.print("IP: ");
-    tft.print(knownIp);
-    tft.setCursor(1,46);
+    ipRow.print("IP: ");
+    ipRow.print(knownIp);
+    TFT_eSprite& briRow = line(2);
     //tft.print("Signal Strength: ");
     //tft.print(i.wifi.signal);
-    tft.print("Brightness: ");
-    tft.print(((float(bri)/255)*100));
-    tft.print("%");
+    briRow.print("Brightness: ");
+    briRow.print(((float(bri)/255)*100));
+    briRow.print("%");
   }
 
   // Third row with mode name
-  tft.setCursor(1, 68);
+  TFT_eSprite& modeRow = line(3);
   uint8_t qComma = 0;
   bool insideQuotes = false;
   uint8_t printedChars = 0;
@@ -196,14 +205,14 @@ void userLoop() {
     default:
       if (!insideQuotes || (qComma != knownMode))
         break;
-      tft.print(singleJsonSymbol);
+      modeRow.print(singleJsonSymbol);
       printedChars++;
     }
     if ((qComma > knownMode) || (printedChars > tftcharwidth - 1))
       break;
   }
   // Fourth row with palette name
-  tft.setCursor(1, 90);
+  TFT_eSprite& paletteRow = line(4);
   qComma = 0;
   insideQuotes = false;
   printedChars = 0;
@@ -222,7 +231,7 @@ void userLoop() {
     default:
       if (!insideQuotes || (qComma != knownPalette))
         break;
-      tft.print(singleJsonSymbol);
+      paletteRow.print(singleJsonSymbol);
       printedChars++;
     }
     // The following is modified from the code from the u8g2/u8g8 based code (knownPalette was knownMode)
@@ -230,9 +239,9 @@ void userLoop() {
       break;
   }
   // Fifth row with estimated mA usage
-  tft.setCursor(1, 112);
+  TFT_eSprite& currentRow = line(5);
   // Print estimated milliamp usage (must specify the LED type in LED prefs for this to be a reasonable estimate).
-  tft.print(strip.currentMilliamps);
-  tft.print("mA (estimated)");
+  currentRow.print(strip.currentMilliamps);
+  currentRow.print("mA (estimated)");
   
 }
@@ -321,6 +321,12 @@ class UsermodTemperature : public Usermod {
     {
       return USERMOD_ID_TEMPERATURE;
     }
+
+    // polling the sensor can wait while other usermods use the loop budget
+    uint8_t getLoopPriority()
+    {
+      return USERMOD_PRIORITY_LOW;
+    }
 };
 
 // strings to reduce flash memory usage (used more than twice)
@@ -10,6 +10,7 @@
 // * effect intensity
 // * mode (effect)
 // * palette
+// * colors and other settings of the main segment
 //
 // but it will wait for configurable number of seconds, a "settle" 
 // period in case there are other changes (any change will 
@@ -41,10 +42,8 @@ class AutoSaveUsermod : public Usermod {
     unsigned long autoSaveAfter = 0;
 
     uint8_t knownBrightness = 0;
-    uint8_t knownEffectSpeed = 0;
-    uint8_t knownEffectIntensity = 0;
-    uint8_t knownMode = 0;
-    uint8_t knownPalette = 0;
+    uint16_t knownSegmentGen = 0;         // Segment::gen of the main segment, counts its changes
+    bool stateChanged = true;             // set by UM_EVENT_STATE, the known values are only compared then
 
     #ifdef USERMOD_FOUR_LINE_DISPLAY
     FourLineDisplayUsermod* display;
@@ -89,10 +88,7 @@ class AutoSaveUsermod : public Usermod {
       initDone = true;
       if (enabled && applyAutoSaveOnBoot) applyPreset(autoSavePreset);
       knownBrightness = bri;
-      knownEffectSpeed = effectSpeed;
-      knownEffectIntensity = effectIntensity;
-      knownMode = strip.getMainSegment().mode;
-      knownPalette = strip.getMainSegment().palette;
+      knownSegmentGen = strip.getMainSegment().gen;
     }
 
     // gets called every time WiFi is (re-)connected. Initialize own network
@@ -106,25 +102,15 @@ class AutoSaveUsermod : public Usermod {
       if (!autoSaveAfterSec || !enabled || strip.isUpdating() || currentPreset>0) return;  // setting 0 as autosave seconds disables autosave
 
       unsigned long now = millis();
-      uint8_t currentMode = strip.getMainSegment().mode;
-      uint8_t currentPalette = strip.getMainSegment().palette;
-
-      unsigned long wouldAutoSaveAfter = now + autoSaveAfterSec*1000;
-      if (knownBrightness != bri) {
-        knownBrightness = bri;
-        autoSaveAfter = wouldAutoSaveAfter;
-      } else if (knownEffectSpeed != effectSpeed) {
-        knownEffectSpeed = effectSpeed;
-        autoSaveAfter = wouldAutoSaveAfter;
-      } else if (knownEffectIntensity != effectIntensity) {
-        knownEffectIntensity = effectIntensity;
-        autoSaveAfter = wouldAutoSaveAfter;
-      } else if (knownMode != currentMode) {
-        knownMode = currentMode;
-        autoSaveAfter = wouldAutoSaveAfter;
-      } else if (knownPalette != currentPalette) {
-        knownPalette = currentPalette;
-        autoSaveAfter = wouldAutoSaveAfter;
+      uint16_t segmentGen = strip.getMainSegment().gen;
+
+      if (stateChanged) {
+        stateChanged = false;
+        if (knownBrightness != bri || knownSegmentGen != segmentGen) {
+          knownBrightness = bri;
+          knownSegmentGen = segmentGen;
+          autoSaveAfter = now + autoSaveAfterSec*1000;
+        }
       }
 
       if (autoSaveAfter && now > autoSaveAfter) {
@@ -135,6 +121,10 @@ class AutoSaveUsermod : public Usermod {
       }
     }
 
+    uint16_t getEventMask() { return UM_EVENT_STATE; }
+
+    void onEvent(uint16_t event, uint8_t arg) { stateChanged = true; }
+
     /*
      * addToJsonInfo() can be used to add custom entries to the /json/info part of the JSON API.
      * Creating an "u" object allows you to add custom key/value pairs to the Info section of the WLED web UI.
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "wled.h"
+#include <U8x8lib.h>
+
+//
+// Dirty tile updates for the four line display usermods (shared by usermod_v2_four_line_display_ALT).
+//
+// Once installed, the tiles U8x8 draws are only written to a buffer. flush() compares it with a shadow
+// of what the display shows and queues the rows that changed, at most every FLD_FLUSH_MS. The rows are
+// then sent, as runs of changed tiles, by the usermod's runTask(): on ESP32 from the usermod worker task,
+// so the LED loop does not wait for the I2C/SPI bus, on ESP8266 one row per loop pass.
+// Commands sent directly to the display (contrast, power save, flip) must call finish() first.
+//
+
+#ifndef FLD_FLUSH_MS
+  #define FLD_FLUSH_MS 100 // minimum time between two display updates
+#endif
+
+class FourLineTiles {
+  private:
+    static FourLineTiles* instance; // U8x8 callbacks have no user pointer
+
+    Usermod* owner = nullptr;
+    u8x8_t* u8 = nullptr;
+    u8x8_msg_cb displayCb = nullptr; // the display driver
+    uint8_t cols = 0, rows = 0;
+    uint8_t* drawn = nullptr;  // tiles as drawn by the usermod
+    uint8_t* shown = nullptr;  // tiles as on the display
+    uint32_t dirty[16];        // per row, a bit for each tile still to send
+    uint8_t nextRow = 0;
+    bool changed = false;
+    volatile bool flushing = false;
+    unsigned long lastFlush = 0;
+
+    static uint8_t captureCb(u8x8_t* u8x8, uint8_t msg, uint8_t arg_int, void* arg_ptr) {
+      FourLineTiles* t = instance;
+      if (!t || u8x8 != t->u8) return 0;
+      if (msg != U8X8_MSG_DISPLAY_DRAW_TILE) return t->displayCb(u8x8, msg, arg_int, arg_ptr);
+      u8x8_tile_t* tile = (u8x8_tile_t*)arg_ptr;
+      uint8_t x = tile->x_pos;
+      // arg_int is how often the tiles are repeated along the row
+      for (uint8_t r = 0; r < arg_int; r++) {
+        for (uint8_t c = 0; c < tile->cnt && x < t->cols; c++, x++) {
+          if (tile->y_pos < t->rows) memcpy(t->drawn + (tile->y_pos * t->cols + x) * 8, tile->tile_ptr + c * 8, 8);
+        }
+      }
+      t->changed = true;
+      return 1;
+    }
+
+  public:
+    ~FourLineTiles() { end(); }
+
+    // after display->begin(), what is drawn from then on goes to the buffer
+    bool begin(U8X8* display, Usermod* um) {
+      end();
+      u8 = display->getU8x8();
+      cols = display->getCols();
+      rows = display->getRows();
+      if (instance || cols > 32 || rows > 16) { u8 = nullptr; return false; } // drawn directly
+      drawn = (uint8_t*)malloc(cols * rows * 8);
+      shown = (uint8_t*)malloc(cols * rows * 8);
+      if (!drawn || !shown) { free(drawn); free(shown); drawn = shown = nullptr; u8 = nullptr; return false; }
+      memset(drawn, 0, cols * rows * 8);
+      memset(shown, 0xFF, cols * rows * 8); // everything is sent with the first flush
+      memset(dirty, 0, sizeof(dirty));
+      owner = um;
+      displayCb = u8->display_cb;
+      instance = this;
+      u8->display_cb = captureCb;
+      return true;
+    }
+
+    // before the display is deleted
+    void end() {
+      if (!u8) return;
+      finish();
+      u8->display_cb = displayCb;
+      instance = nullptr;
+      free(drawn); free(shown);
+      drawn = shown = nullptr;
+      u8 = nullptr;
+    }
+
+    // sends everything again with the next flush, e.g. after a flip
+    void invalidate() {
+      if (!u8) return;
+      finish();
+      memset(shown, 0xFF, cols * rows * 8);
+      changed = true;
+    }
+
+    // from loop(): queues the rows that changed since the last flush
+    void flush() {
+      if (!u8 || flushing || !changed || millis() - lastFlush < FLD_FLUSH_MS) return;
+      changed = false;
+      bool any = false;
+      for (uint8_t r = 0; r < rows; r++) {
+        for (uint8_t c = 0; c < cols; c++) {
+          uint16_t ofs = (r * cols + c) * 8;
+          if (!memcmp(drawn + ofs, shown + ofs, 8)) continue;
+          memcpy(shown + ofs, drawn + ofs, 8);
+          dirty[r] |= 1UL << c;
+          any = true;
+        }
+      }
+      if (!any) return;
+      lastFlush = millis();
+      nextRow = 0;
+      flushing = true;
+      if (!usermods.startTask(owner, 0)) { flushing = false; changed = true; } // retried, the tiles stay dirty
+    }
+
+    // from runTask(): sends the next row that changed, true when all are sent
+    bool sendRow() {
+      while (nextRow < rows && !dirty[nextRow]) nextRow++;
+      if (nextRow >= rows) { flushing = false; return true; }
+      uint32_t bits = dirty[nextRow];
+      dirty[nextRow] = 0;
+      for (uint8_t c = 0; c < cols; c++) {
+        if (!(bits & (1UL << c))) continue;
+        uint8_t n = 1;
+        while (c + n < cols && (bits & (1UL << (c + n)))) n++;
+        u8x8_tile_t tile;
+        tile.tile_ptr = shown + (nextRow * cols + c) * 8;
+        tile.cnt = n;
+        tile.x_pos = c;
+        tile.y_pos = nextRow;
+        displayCb(u8, U8X8_MSG_DISPLAY_DRAW_TILE, 1, &tile);
+        c += n;
+      }
+      nextRow++;
+      return false;
+    }
+
+    // waits for a running update, the display can then take commands
+    void finish() {
+      #ifdef WLED_USERMOD_TASK
+      while (flushing) delay(1);
+      #else
+      while (flushing) sendRow();
+      #endif
+    }
+};
+
+FourLineTiles* FourLineTiles::instance = nullptr;
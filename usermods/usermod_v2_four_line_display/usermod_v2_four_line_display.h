@@ -2,6 +2,7 @@
 
 #include "wled.h"
 #include <U8x8lib.h> // from https://github.com/olikraus/u8g2/
+#include "four_line_tiles.h"
 
 //
 // Insired by the v1 usermod: ssd1306_i2c_oled_u8g2
@@ -162,6 +163,7 @@ class FourLineDisplayUsermod : public Usermod {
     unsigned long lastRedraw = 0;
     unsigned long overlayUntil = 0;
     Line4Type lineType = FLD_LINE_BRIGHTNESS;
+    FourLineTiles tiles; // only changed tiles are sent to the display
     // Set to 2 or 3 to mark lines 2 or 3. Other values ignored.
     byte markLineNum = 0;
 
@@ -254,6 +256,7 @@ class FourLineDisplayUsermod : public Usermod {
       DEBUG_PRINTLN(F("Starting display."));
       /*if (!(type == SSD1306_SPI || type == SSD1306_SPI64))*/ u8x8->setBusClock(ioFrequency);  // can be used for SPI too
       u8x8->begin();
+      tiles.begin(u8x8, this);
       setFlipMode(flip);
       setContrast(contrast); //Contrast setup will help to preserve OLED lifetime. In case OLED need to be brighter increase number up to 255
       setPowerSave(0);
@@ -264,10 +267,16 @@ class FourLineDisplayUsermod : public Usermod {
     // interfaces here
     void connected() {}
 
+    // sends the rows changed since the last update, see four_line_tiles.h
+    bool runTask(uint8_t taskId, void* arg) {
+      return tiles.sendRow();
+    }
+
     /**
      * Da loop.
      */
     void loop() {
+      if (enabled && type != NONE) tiles.flush();
       if (!enabled || millis() - lastUpdate < (clockMode?1000:refreshRate) || strip.isUpdating()) return;
       lastUpdate = millis();
 
@@ -279,10 +288,13 @@ class FourLineDisplayUsermod : public Usermod {
      */
     void setFlipMode(uint8_t mode) {
       if (type == NONE || !enabled) return;
+      tiles.finish();
       u8x8->setFlipMode(mode);
+      tiles.invalidate();
     }
     void setContrast(uint8_t contrast) {
       if (type == NONE || !enabled) return;
+      tiles.finish();
       u8x8->setContrast(contrast);
     }
     void drawString(uint8_t col, uint8_t row, const char *string, bool ignoreLH=false) {
@@ -312,6 +324,7 @@ class FourLineDisplayUsermod : public Usermod {
     }
     void setPowerSave(uint8_t save) {
       if (type == NONE || !enabled) return;
+      tiles.finish();
       u8x8->setPowerSave(save);
     }
 
@@ -455,13 +468,13 @@ class FourLineDisplayUsermod : public Usermod {
           drawString(2, line*lineHeight, lineBuffer);
           break;
         case FLD_LINE_MODE:
-          printedChars = extractModeName(knownMode, JSON_mode_names, lineBuffer, LINE_BUFFER_SIZE-1);
+          printedChars = extractFxName(knownMode, lineBuffer, LINE_BUFFER_SIZE-1);
           for (;printedChars < getCols()-2 && printedChars < LINE_BUFFER_SIZE-3; printedChars++) lineBuffer[printedChars]=' ';
           lineBuffer[printedChars] = 0;
           drawString(2, line*lineHeight, lineBuffer);
           break;
         case FLD_LINE_PALETTE:
-          printedChars = extractModeName(knownPalette, JSON_palette_names, lineBuffer, LINE_BUFFER_SIZE-1);
+          printedChars = extractPaletteName(knownPalette, lineBuffer, LINE_BUFFER_SIZE-1);
           for (;printedChars < getCols()-2 && printedChars < LINE_BUFFER_SIZE-3; printedChars++) lineBuffer[printedChars]=' ';
           lineBuffer[printedChars] = 0;
           drawString(2, line*lineHeight, lineBuffer);
@@ -716,6 +729,7 @@ class FourLineDisplayUsermod : public Usermod {
         bool pinsChanged = false;
         for (byte i=0; i<5; i++) if (ioPin[i] != newPin[i]) { pinsChanged = true; break; }
         if (pinsChanged || type!=newType) {
+          tiles.end();
           if (type != NONE) delete u8x8;
           PinOwner po = PinOwner::UM_FourLineDisplay;
           if (ioPin[0]==HW_PIN_SCL && ioPin[1]==HW_PIN_SDA) po = PinOwner::HW_I2C;  // allow multiple allocations of HW I2C bus pins
@@ -728,6 +742,7 @@ class FourLineDisplayUsermod : public Usermod {
           setup();
           needsRedraw |= true;
         }
+        tiles.finish();
         if (!(type == SSD1306_SPI || type == SSD1306_SPI64)) u8x8->setBusClock(ioFrequency); // can be used for SPI too
         setContrast(contrast);
         setFlipMode(flip);
@@ -3,6 +3,7 @@
 #include "wled.h"
 #include <U8x8lib.h> // from https://github.com/olikraus/u8g2/
 #include "4LD_wled_fonts.c"
+#include "../usermod_v2_four_line_display/four_line_tiles.h"
 
 //
 // Insired by the usermod_v2_four_line_display
@@ -162,6 +163,7 @@ class FourLineDisplayUsermod : public Usermod {
     unsigned long nextUpdate = 0;
     unsigned long lastRedraw = 0;
     unsigned long overlayUntil = 0;
+    FourLineTiles tiles; // only changed tiles are sent to the display
 
     // Set to 2 or 3 to mark lines 2 or 3. Other values ignored.
     byte markLineNum = 255;
@@ -188,6 +190,7 @@ class FourLineDisplayUsermod : public Usermod {
 
     // some displays need this to properly apply contrast
     void setVcomh(bool highContrast) {
+      tiles.finish();
       u8x8_t *u8x8_struct = u8x8->getU8x8();
       u8x8_cad_StartTransfer(u8x8_struct);
       u8x8_cad_SendCmd(u8x8_struct, 0x0db); //address of value
@@ -298,6 +301,7 @@ class FourLineDisplayUsermod : public Usermod {
       DEBUG_PRINTLN(F("Starting display."));
       u8x8->setBusClock(ioFrequency);  // can be used for SPI too
       u8x8->begin();
+      tiles.begin(u8x8, this);
       setFlipMode(flip);
       setVcomh(contrastFix);
       setContrast(contrast); //Contrast setup will help to preserve OLED lifetime. In case OLED need to be brighter increase number up to 255
@@ -315,10 +319,16 @@ class FourLineDisplayUsermod : public Usermod {
       networkOverlay(PSTR("NETWORK INFO"),7000);
     }
 
+    // sends the rows changed since the last update, see four_line_tiles.h
+    bool runTask(uint8_t taskId, void* arg) {
+      return tiles.sendRow();
+    }
+
     /**
      * Da loop.
      */
     void loop() {
+      if (enabled && type != NONE) tiles.flush();
       if (!enabled || strip.isUpdating()) return;
       unsigned long now = millis();
       if (now < nextUpdate) return;
@@ -331,10 +341,13 @@ class FourLineDisplayUsermod : public Usermod {
      */
     void setFlipMode(uint8_t mode) {
       if (type == NONE || !enabled) return;
+      tiles.finish();
       u8x8->setFlipMode(mode);
+      tiles.invalidate();
     }
     void setContrast(uint8_t contrast) {
       if (type == NONE || !enabled) return;
+      tiles.finish();
       u8x8->setContrast(contrast);
     }
     void drawString(uint8_t col, uint8_t row, const char *string, bool ignoreLH=false) {
@@ -369,6 +382,7 @@ class FourLineDisplayUsermod : public Usermod {
     }
     void setPowerSave(uint8_t save) {
       if (type == NONE || !enabled) return;
+      tiles.finish();
       u8x8->setPowerSave(save);
     }
 
@@ -576,7 +590,10 @@ class FourLineDisplayUsermod : public Usermod {
       char lineBuffer[MAX_JSON_CHARS];
       if (overlayUntil == 0) {
         // Find the mode name in JSON
-        uint8_t printedChars = extractModeName(inputEffPal, qstring, lineBuffer, MAX_JSON_CHARS-1);
+        uint8_t printedChars;
+        if (qstring == JSON_mode_names)         printedChars = extractFxName(inputEffPal, lineBuffer, MAX_JSON_CHARS-1);
+        else if (qstring == JSON_palette_names) printedChars = extractPaletteName(inputEffPal, lineBuffer, MAX_JSON_CHARS-1);
+        else                                    printedChars = extractModeName(inputEffPal, qstring, lineBuffer, MAX_JSON_CHARS-1);
         if (lineBuffer[0]=='*' && lineBuffer[1]==' ') {
           // remove "* " from dynamic palettes
           for (byte i=2; i<=printedChars; i++) lineBuffer[i-2] = lineBuffer[i]; //include '\0'
@@ -1024,6 +1041,7 @@ class FourLineDisplayUsermod : public Usermod {
         bool pinsChanged = false;
         for (byte i=0; i<5; i++) if (ioPin[i] != newPin[i]) { pinsChanged = true; break; }
         if (pinsChanged || type!=newType) {
+          tiles.end();
           if (type != NONE) delete u8x8;
           PinOwner po = PinOwner::UM_FourLineDisplay;
           if (ioPin[0]==HW_PIN_SCL && ioPin[1]==HW_PIN_SDA) po = PinOwner::HW_I2C;  // allow multiple allocations of HW I2C bus pins
@@ -1036,6 +1054,7 @@ class FourLineDisplayUsermod : public Usermod {
           setup();
           needsRedraw |= true;
         } else {
+          tiles.finish();
           u8x8->setBusClock(ioFrequency); // can be used for SPI too
           setVcomh(contrastFix);
           setContrast(contrast);
@@ -265,7 +265,7 @@ public:
       }
     }
 
-    for (uint8_t i = 0; i < strip.getPaletteCount(); i++) {
+    for (uint8_t i = 0; i < PAL_NAME_COUNT; i++) {
       //byte value = palettes_alpha_indexes[i];
       if (palettes_alpha_indexes[i] == strip.getSegment(0).palette) {
         effectPaletteIndex = i;
@@ -367,10 +367,10 @@ public:
     }
 #endif
     if (increase) {
-      effectPaletteIndex = (effectPaletteIndex + 1 >= strip.getPaletteCount()) ? 0 : (effectPaletteIndex + 1);
+      effectPaletteIndex = (effectPaletteIndex + 1 >= PAL_NAME_COUNT) ? 0 : (effectPaletteIndex + 1);
     }
     else {
-      effectPaletteIndex = (effectPaletteIndex - 1 < 0) ? (strip.getPaletteCount() - 1) : (effectPaletteIndex - 1);
+      effectPaletteIndex = (effectPaletteIndex - 1 < 0) ? (PAL_NAME_COUNT - 1) : (effectPaletteIndex - 1);
     }
     effectPalette = palettes_alpha_indexes[effectPaletteIndex];
     lampUdated();
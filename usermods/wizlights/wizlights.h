@@ -4,9 +4,11 @@
 #include <WiFiUdp.h>
 
 // Maximum number of lights supported
-#define MAX_WIZ_LIGHTS 15
+#ifndef MAX_WIZ_LIGHTS
+  #define MAX_WIZ_LIGHTS 15
+#endif
 
-WiFiUDP UDP;
+WiFiUDP UDP; // one socket for all lights, created with the first packet
 
 
 
@@ -14,7 +16,7 @@ WiFiUDP UDP;
 class WizLightsUsermod : public Usermod {
   
   private:
-    unsigned long lastTime = 0;
+    unsigned long lastSend = 0;  // last packet to any light
     long updateInterval;
     long sendDelay;
     
@@ -28,6 +30,10 @@ class WizLightsUsermod : public Usermod {
     IPAddress lightsIP[MAX_WIZ_LIGHTS];    // Stores Light IP addresses
     bool      lightsValid[MAX_WIZ_LIGHTS]; // Stores Light IP address validity
     uint32_t  colorsSent[MAX_WIZ_LIGHTS];  // Stores last color sent for each light
+    unsigned long lightsSent[MAX_WIZ_LIGHTS] = {0}; // millis() of the last packet to each light
+    uint8_t   nextLight = 0;               // lights are checked round robin from here
+
+    char packet[80];                       // longest: {"method":"setPilot","params":{"r":255,"g":255,"b":255}}
 
 
 
@@ -35,69 +41,65 @@ class WizLightsUsermod : public Usermod {
 
 
 
-    // Send JSON blob to WiZ Light over UDP
+    // Format JSON blob for a WiZ Light into packet, returns its length (0: nothing to send)
     // RGB or C/W white
     // TODO:
     //   Better utilize WLED existing white mixing logic
-    void wizSendColor(IPAddress ip, uint32_t color) {
-      UDP.beginPacket(ip, 38899);
-
+    size_t wizFormatColor(uint32_t color) {
       // If no LED color, turn light off. Note wiz light setting for "Off fade-out" will be applied by the light itself.
-      if (color == 0) { 
-        UDP.print("{\"method\":\"setPilot\",\"params\":{\"state\":false}}");
+      if (color == 0) {
+        return snprintf_P(packet, sizeof(packet), PSTR("{\"method\":\"setPilot\",\"params\":{\"state\":false}}"));
+      }
 
       // If color is WHITE, try and use the lights WHITE LEDs instead of mixing RGB LEDs
-      } else if (color == 16777215 && useEnhancedWhite){
-
+      if (color == 16777215 && useEnhancedWhite) {
         // set cold white light only
-        if (coldWhite > 0 && warmWhite == 0){
-          UDP.print("{\"method\":\"setPilot\",\"params\":{\"c\":"); UDP.print(coldWhite) ;UDP.print("}}");}
-          
+        if (coldWhite > 0 && warmWhite == 0)
+          return snprintf_P(packet, sizeof(packet), PSTR("{\"method\":\"setPilot\",\"params\":{\"c\":%ld}}"), coldWhite);
         // set warm white light only
-        if (warmWhite > 0 && coldWhite == 0){
-          UDP.print("{\"method\":\"setPilot\",\"params\":{\"w\":"); UDP.print(warmWhite) ;UDP.print("}}");}
-          
+        if (warmWhite > 0 && coldWhite == 0)
+          return snprintf_P(packet, sizeof(packet), PSTR("{\"method\":\"setPilot\",\"params\":{\"w\":%ld}}"), warmWhite);
         // set combination of warm and cold white light
-        if (coldWhite > 0 && warmWhite > 0){
-          UDP.print("{\"method\":\"setPilot\",\"params\":{\"c\":"); UDP.print(coldWhite) ;UDP.print(",\"w\":"); UDP.print(warmWhite); UDP.print("}}");}
-
-      // Send color as RGB  
-      } else {
-        UDP.print("{\"method\":\"setPilot\",\"params\":{\"r\":");
-        UDP.print(R(color));
-        UDP.print(",\"g\":");
-        UDP.print(G(color));
-        UDP.print(",\"b\":");
-        UDP.print(B(color));
-        UDP.print("}}");
+        if (coldWhite > 0 && warmWhite > 0)
+          return snprintf_P(packet, sizeof(packet), PSTR("{\"method\":\"setPilot\",\"params\":{\"c\":%ld,\"w\":%ld}}"), coldWhite, warmWhite);
+        return 0;
       }
-    
-      UDP.endPacket();
+
+      // Send color as RGB
+      return snprintf_P(packet, sizeof(packet), PSTR("{\"method\":\"setPilot\",\"params\":{\"r\":%u,\"g\":%u,\"b\":%u}}"),
+        R(color), G(color), B(color));
     }
 
 
 
-    // TODO: Check millis() rollover
+    // Sends at most one packet per call, to the next light (round robin) whose color changed,
+    // which was not updated for "Interval (ms)" and at least "Send Delay (ms)" after the last packet.
     void loop() {
       
       // Make sure we are connected first
       if (!WLED_CONNECTED) return;
-      
-      unsigned long ellapsedTime = millis() - lastTime;
-      if (ellapsedTime > updateInterval) {
-        bool update = false;
-        for (uint8_t i = 0; i < MAX_WIZ_LIGHTS; i++) {
-          if (!lightsValid[i]) { continue; }
-          uint32_t newColor = strip.getPixelColor(i);
-          if (forceUpdate || (newColor != colorsSent[i]) || (ellapsedTime > forceUpdateMinutes*60000)){
-            wizSendColor(lightsIP[i], newColor);
-            colorsSent[i] = newColor;
-            update = true;
-            delay(sendDelay);
-            }
-          }
-        if (update) lastTime = millis();
+
+      unsigned long now = millis();
+      if (now - lastSend < (unsigned long)sendDelay) return;
+
+      for (uint8_t n = 0; n < MAX_WIZ_LIGHTS; n++) {
+        uint8_t i = nextLight;
+        nextLight = (nextLight + 1) % MAX_WIZ_LIGHTS;
+        if (!lightsValid[i] || now - lightsSent[i] < (unsigned long)updateInterval) continue;
+        uint32_t newColor = strip.getPixelColor(i);
+        bool stale = now - lightsSent[i] > (unsigned long)forceUpdateMinutes*60000UL;
+        if (!forceUpdate && newColor == colorsSent[i] && !stale) continue;
+
+        size_t len = wizFormatColor(newColor);
+        if (len) {
+          UDP.beginPacket(lightsIP[i], 38899);
+          UDP.write((const uint8_t*)packet, len);
+          UDP.endPacket();
         }
+        colorsSent[i] = newColor;
+        lightsSent[i] = lastSend = now;
+        return;
+      }
     }
 
 
@@ -788,7 +788,7 @@ uint16_t WS2812FX::mode_chase_random(void) {
 uint16_t WS2812FX::mode_chase_rainbow(void) {
   uint8_t color_sep = 256 / SEGLEN;
   if (color_sep == 0) color_sep = 1;                                           // correction for segments longer than 256 LEDs
-  uint8_t color_index = SEGENV.call & 0xFF;
+  uint8_t color_index = effectFrames() & 0xFF;
   uint32_t color = color_wheel(((SEGENV.step * color_sep) + color_index) & 0xFF);
 
   return chase(color, SEGCOLOR(0), SEGCOLOR(1), false);
@@ -801,8 +801,8 @@ uint16_t WS2812FX::mode_chase_rainbow(void) {
 uint16_t WS2812FX::mode_chase_rainbow_white(void) {
   uint16_t n = SEGENV.step;
   uint16_t m = (SEGENV.step + 1) % SEGLEN;
-  uint32_t color2 = color_wheel(((n * 256 / SEGLEN) + (SEGENV.call & 0xFF)) & 0xFF);
-  uint32_t color3 = color_wheel(((m * 256 / SEGLEN) + (SEGENV.call & 0xFF)) & 0xFF);
+  uint32_t color2 = color_wheel(((n * 256 / SEGLEN) + (effectFrames() & 0xFF)) & 0xFF);
+  uint32_t color3 = color_wheel(((m * 256 / SEGLEN) + (effectFrames() & 0xFF)) & 0xFF);
 
   return chase(SEGCOLOR(0), color2, color3, false);
 }
@@ -995,35 +995,38 @@ uint16_t WS2812FX::mode_halloween(void) {
 }
 
 
+// hue of the next pixel of a "Stream", seed is the zone color and count the pixels of the zone so far
+static uint8_t streamZoneHue(uint16_t &seed, uint32_t &count, uint8_t zoneSize)
+{
+  if (count >= zoneSize) {
+    uint8_t lastrand = seed >> 8;
+    int16_t diff = 0;
+    while (abs(diff) < 42) { // make sure the difference between adjacent colors is big enough
+      seed = (uint16_t)(seed * 2053) + 13849; // next zone, next 'random' number
+      diff = (seed >> 8) - lastrand;
+    }
+    count = 0;
+  }
+  count++;
+  return seed >> 8;
+}
+
 /*
  * Random colored pixels running. ("Stream")
+ * New pixels come in at the start, the rest scrolls one pixel per cycle.
  */
 uint16_t WS2812FX::mode_running_random(void) {
   uint32_t cycleTime = 25 + (3 * (uint32_t)(255 - SEGMENT.speed));
   uint32_t it = now / cycleTime;
-  if (SEGENV.call == 0) SEGENV.aux0 = random16(); // random seed for PRNG on start
-
   uint8_t zoneSize = ((255-SEGMENT.intensity) >> 4) +1;
-  uint16_t PRNG16 = SEGENV.aux0;
-
-  uint8_t z = it % zoneSize;
-  bool nzone = (!z && it != SEGENV.aux1);
-  for (uint16_t i=SEGLEN-1; i > 0; i--) {
-    if (nzone || z >= zoneSize) {
-      uint8_t lastrand = PRNG16 >> 8;
-      int16_t diff = 0;
-      while (abs(diff) < 42) { // make sure the difference between adjacent colors is big enough
-        PRNG16 = (uint16_t)(PRNG16 * 2053) + 13849; // next zone, next 'random' number
-        diff = (PRNG16 >> 8) - lastrand;
-      }
-      if (nzone) {
-        SEGENV.aux0 = PRNG16; // save next starting seed
-        nzone = false;
-      }
-      z = 0;
-    }
-    setPixelColor(i, color_wheel(PRNG16 >> 8));
-    z++;
+
+  if (SEGENV.call == 0) {
+    SEGENV.aux0 = random16(); // random seed for PRNG on start
+    SEGENV.step = zoneSize;
+    for (uint16_t i = SEGLEN; i > 0; i--) setPixelColor(i - 1, color_wheel(streamZoneHue(SEGENV.aux0, SEGENV.step, zoneSize)));
+  } else {
+    uint16_t steps = MIN((uint16_t)(it - SEGENV.aux1), SEGLEN);
+    for (uint16_t k = 0; k < steps; k++) scroll(true, color_wheel(streamZoneHue(SEGENV.aux0, SEGENV.step, zoneSize)));
   }
 
   SEGENV.aux1 = it;
@@ -1117,7 +1120,7 @@ uint16_t WS2812FX::mode_fireworks() {
 
   for(uint16_t i=0; i<MAX(1, SEGLEN/20); i++) {
     if(random8(129 - (SEGMENT.intensity >> 1)) == 0) {
-      uint16_t index = random(SEGLEN);
+      uint16_t index = random16(SEGLEN);
       setPixelColor(index, color_from_palette(random8(), false, false, 0));
       SEGENV.aux1 = SEGENV.aux0;
       SEGENV.aux0 = index;
@@ -1130,15 +1133,10 @@ uint16_t WS2812FX::mode_fireworks() {
 //Twinkling LEDs running. Inspired by https://github.com/kitesurfer1404/WS2812FX/blob/master/src/custom/Rain.h
 uint16_t WS2812FX::mode_rain()
 {
-  SEGENV.step += FRAMETIME;
+  SEGENV.step += deltaTime();
   if (SEGENV.step > SPEED_FORMULA_L) {
     SEGENV.step = 0;
-    //shift all leds left
-    uint32_t ctemp = getPixelColor(0);
-    for(uint16_t i = 0; i < SEGLEN - 1; i++) {
-      setPixelColor(i, getPixelColor(i+1));
-    }
-    setPixelColor(SEGLEN -1, ctemp);
+    scroll(false, 0, true); //shift all leds left
     SEGENV.aux0++;
     SEGENV.aux1++;
     if (SEGENV.aux0 == 0) SEGENV.aux0 = UINT16_MAX;
@@ -1275,7 +1273,7 @@ typedef struct Flasher {
 
 uint16_t WS2812FX::mode_fairy() {
 	//set every pixel to a 'random' color from palette (using seed so it doesn't change between frames)
-	uint16_t PRNG16 = 5100 + _segment_index;
+	uint16_t PRNG16 = 5100 + RCTX.segIndex;
 	for (uint16_t i = 0; i < SEGLEN; i++) {
 		PRNG16 = (uint16_t)(PRNG16 * 2053) + 1384; //next 'random' number
 		setPixelColor(i, color_from_palette(PRNG16 >> 8, false, false, 0));
@@ -1355,7 +1353,7 @@ uint16_t WS2812FX::mode_fairytwinkle() {
   if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
 	Flasher* flashers = reinterpret_cast<Flasher*>(SEGENV.data);
 	uint16_t now16 = now & 0xFFFF;
-	uint16_t PRNG16 = 5100 + _segment_index;
+	uint16_t PRNG16 = 5100 + RCTX.segIndex;
 
 	uint16_t riseFallTime = 400 + (255-SEGMENT.speed)*3;
 	uint16_t maxDur = riseFallTime/100 + ((255 - SEGMENT.intensity) >> 2) + 13 + ((255 - SEGMENT.intensity) >> 1);
@@ -1576,7 +1574,7 @@ uint16_t WS2812FX::mode_multi_comet(void)
       }
       comets[i]++;
     } else {
-      if(!random(SEGLEN)) {
+      if(!random16(SEGLEN)) {
         comets[i] = 0;
       }
     }
@@ -1596,33 +1594,37 @@ uint16_t WS2812FX::mode_dual_larson_scanner(void){
 }
 
 
+// the previous pixel of a "Stream 2" with each channel replaced by a random value 1 in 6 times
+static uint32_t chaseNextColor(uint32_t color)
+{
+  uint8_t r = random8(6) != 0 ? (color >> 16 & 0xFF) : random8();
+  uint8_t g = random8(6) != 0 ? (color >> 8  & 0xFF) : random8();
+  uint8_t b = random8(6) != 0 ? (color       & 0xFF) : random8();
+  return RGBW32(r, g, b, 0);
+}
+
 /*
  * Running random pixels ("Stream 2")
  * Custom mode by Keith Lord: https://github.com/kitesurfer1404/WS2812FX/blob/master/src/custom/RandomChase.h
+ * New pixels come in at the start, the rest scrolls one pixel per cycle.
  */
 uint16_t WS2812FX::mode_random_chase(void)
 {
-  if (SEGENV.call == 0) {
-    SEGENV.step = RGBW32(random8(), random8(), random8(), 0);
-    SEGENV.aux0 = random16();
-  }
   uint16_t prevSeed = random16_get_seed(); // save seed so we can restore it at the end of the function
   uint32_t cycleTime = 25 + (3 * (uint32_t)(255 - SEGMENT.speed));
   uint32_t it = now / cycleTime;
-  uint32_t color = SEGENV.step;
-  random16_set_seed(SEGENV.aux0);
-
-  for(uint16_t i = SEGLEN -1; i > 0; i--) {
-    uint8_t r = random8(6) != 0 ? (color >> 16 & 0xFF) : random8();
-    uint8_t g = random8(6) != 0 ? (color >> 8  & 0xFF) : random8();
-    uint8_t b = random8(6) != 0 ? (color       & 0xFF) : random8();
-    color = RGBW32(r, g, b, 0);
-    setPixelColor(i, r, g, b);
-    if (i == SEGLEN -1 && SEGENV.aux1 != (it & 0xFFFF)) { //new first color in next frame
-      SEGENV.step = color;
-      SEGENV.aux0 = random16_get_seed();
-    }
+
+  if (SEGENV.call == 0) {
+    SEGENV.step = RGBW32(random8(), random8(), random8(), 0); // color of pixel 0
+    SEGENV.aux0 = random16();
+    random16_set_seed(SEGENV.aux0);
+    for (uint16_t i = SEGLEN; i > 0; i--) setPixelColor(i - 1, SEGENV.step = chaseNextColor(SEGENV.step));
+  } else {
+    random16_set_seed(SEGENV.aux0);
+    uint16_t steps = MIN((uint16_t)((it & 0xFFFF) - SEGENV.aux1), SEGLEN);
+    for (uint16_t k = 0; k < steps; k++) scroll(true, SEGENV.step = chaseNextColor(SEGENV.step));
   }
+  SEGENV.aux0 = random16_get_seed();
 
   SEGENV.aux1 = it & 0xFFFF;
 
@@ -1716,10 +1718,10 @@ uint16_t WS2812FX::mode_lightning(void)
     }
     SEGENV.aux1--;
 
-    SEGENV.step = millis();
+    SEGENV.step = uptimeMs();
     //return random8(4, 10); // each flash only lasts one frame/every 24ms... originally 4-10 milliseconds
   } else {
-    if (millis() - SEGENV.step > SEGENV.aux0) {
+    if (uptimeMs() - SEGENV.step > SEGENV.aux0) {
       SEGENV.aux1--;
       if (SEGENV.aux1 < 2) SEGENV.aux1 = 0;
 
@@ -1727,7 +1729,7 @@ uint16_t WS2812FX::mode_lightning(void)
       if (SEGENV.aux1 == 2) {
         SEGENV.aux0 = (random8(255 - SEGMENT.speed) * 100); // delay between strikes
       }
-      SEGENV.step = millis();
+      SEGENV.step = uptimeMs();
     }
   }
   return FRAMETIME;
@@ -1754,7 +1756,8 @@ uint16_t WS2812FX::mode_pride_2015(void)
   sPseudotime += duration * msmultiplier;
   sHue16 += duration * beatsin88( 400, 5,9);
   uint16_t brightnesstheta16 = sPseudotime;
-  CRGB fastled_col;
+  CRGB* leds = segmentLeds();
+  if (!leds) return mode_static(); //allocation failed
 
   for (uint16_t i = 0 ; i < SEGLEN; i++) {
     hue16 += hueinc16;
@@ -1768,11 +1771,9 @@ uint16_t WS2812FX::mode_pride_2015(void)
     bri8 += (255 - brightdepth);
 
     CRGB newcolor = CHSV( hue8, sat8, bri8);
-    fastled_col = col_to_crgb(getPixelColor(i));
-
-    nblend(fastled_col, newcolor, 64);
-    setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
+    nblend(leds[i], newcolor, 64);
   }
+  setPixels(leds);
   SEGENV.step = sPseudotime;
   SEGENV.aux0 = sHue16;
   return FRAMETIME;
@@ -1781,16 +1782,25 @@ uint16_t WS2812FX::mode_pride_2015(void)
 
 //eight colored dots, weaving in and out of sync with each other
 uint16_t WS2812FX::mode_juggle(void){
-  fade_out(SEGMENT.intensity);
-  CRGB fastled_col;
+  CRGB* leds = segmentLeds();
+  if (!leds) return mode_static(); //allocation failed
+
+  // same rate as fade_out(), which keeps 1 - 1/(rate + 1.1) of the color per frame
+  uint8_t fadeBy = 256 / (((255 - SEGMENT.intensity) >> 1) + 1.1f);
+  CRGB bg = col_to_crgb(SEGCOLOR(1));
+  if (bg) {
+    for (uint16_t i = 0; i < SEGLEN; i++) nblend(leds[i], bg, fadeBy);
+  } else {
+    ::fadeToBlackBy(leds, SEGLEN, fadeBy);
+  }
+
   byte dothue = 0;
   for ( byte i = 0; i < 8; i++) {
     uint16_t index = 0 + beatsin88((128 + SEGMENT.speed)*(i + 7), 0, SEGLEN -1);
-    fastled_col = col_to_crgb(getPixelColor(index));
-    fastled_col |= (SEGMENT.palette==0)?CHSV(dothue, 220, 255):ColorFromPalette(currentPalette, dothue, 255);
-    setPixelColor(index, fastled_col.red, fastled_col.green, fastled_col.blue);
+    leds[index] |= (SEGMENT.palette==0)?CHSV(dothue, 220, 255):ColorFromPalette(RCTX.palette, dothue, 255);
     dothue += 32;
   }
+  setPixels(leds);
   return FRAMETIME;
 }
 
@@ -1880,7 +1890,7 @@ uint16_t WS2812FX::mode_fire_2012()
 
   // Step 4.  Map from heat cells to LED colors
   for (uint16_t j = 0; j < SEGLEN; j++) {
-    CRGB color = ColorFromPalette(currentPalette, MIN(heat[j],240), 255, LINEARBLEND);
+    CRGB color = ColorFromPalette(RCTX.palette, MIN(heat[j],240), 255, LINEARBLEND);
     setPixelColor(j, color.red, color.green, color.blue);
   }
   return FRAMETIME;
@@ -1907,7 +1917,8 @@ uint16_t WS2812FX::mode_colorwaves()
   sPseudotime += duration * msmultiplier;
   sHue16 += duration * beatsin88(400, 5, 9);
   uint16_t brightnesstheta16 = sPseudotime;
-  CRGB fastled_col;
+  CRGB* leds = segmentLeds();
+  if (!leds) return mode_static(); //allocation failed
 
   for ( uint16_t i = 0 ; i < SEGLEN; i++) {
     hue16 += hueinc16;
@@ -1926,12 +1937,10 @@ uint16_t WS2812FX::mode_colorwaves()
     uint8_t bri8 = (uint32_t)(((uint32_t)bri16) * brightdepth) / 65536;
     bri8 += (255 - brightdepth);
 
-    CRGB newcolor = ColorFromPalette(currentPalette, hue8, bri8);
-    fastled_col = col_to_crgb(getPixelColor(i));
-
-    nblend(fastled_col, newcolor, 128);
-    setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
+    CRGB newcolor = ColorFromPalette(RCTX.palette, hue8, bri8);
+    nblend(leds[i], newcolor, 128);
   }
+  setPixels(leds);
   SEGENV.step = sPseudotime;
   SEGENV.aux0 = sHue16;
   return FRAMETIME;
@@ -1945,7 +1954,7 @@ uint16_t WS2812FX::mode_bpm()
   uint32_t stp = (now / 20) & 0xFF;
   uint8_t beat = beatsin8(SEGMENT.speed, 64, 255);
   for (uint16_t i = 0; i < SEGLEN; i++) {
-    fastled_col = ColorFromPalette(currentPalette, stp + (i * 2), beat - stp + (i * 10));
+    fastled_col = ColorFromPalette(RCTX.palette, stp + (i * 2), beat - stp + (i * 10));
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
   return FRAMETIME;
@@ -1958,26 +1967,59 @@ uint16_t WS2812FX::mode_fillnoise8()
   CRGB fastled_col;
   for (uint16_t i = 0; i < SEGLEN; i++) {
     uint8_t index = inoise8(i * SEGLEN, SEGENV.step + i * SEGLEN);
-    fastled_col = ColorFromPalette(currentPalette, index, 255, LINEARBLEND);
+    fastled_col = ColorFromPalette(RCTX.palette, index, 255, LINEARBLEND);
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
-  SEGENV.step += beatsin8(SEGMENT.speed, 1, 6); //10,1,4
+  SEGENV.step += frameStep(beatsin8(SEGMENT.speed, 1, 6)); //10,1,4
 
   return FRAMETIME;
 }
 
+/*
+ * Noise row cache: noise sampled at x = (k + shift) * scale for pixel k with fixed y and z.
+ * When only shift moves between frames, the samples still in view are moved instead of recalculated,
+ * so only the pixels entering the row need a call to inoise16().
+ */
+typedef struct NoiseRow {
+  uint32_t y, z;
+  uint16_t scale;
+  uint16_t shift; // shift of values[0]
+  uint16_t len;   // number of valid values
+} noise_row;
+
+// returns SEGLEN 8 bit noise samples (inoise16() >> 8) for the current shift, row must be followed by SEGLEN bytes
+static const uint8_t* noiseRow(NoiseRow* row, uint16_t len, uint16_t shift, uint16_t scale, uint32_t y, uint32_t z)
+{
+  uint8_t* values = reinterpret_cast<uint8_t*>(row + 1);
+  int32_t delta = (int32_t)shift - row->shift;
+  uint16_t from = 0, to = len; // range of samples to (re)calculate
+
+  if (row->len != len || row->scale != scale || row->y != y || row->z != z || abs(delta) >= len) {
+    row->len = len; row->scale = scale; row->y = y; row->z = z;
+  } else if (delta > 0) {
+    memmove(values, values + delta, len - delta);
+    from = len - delta;
+  } else if (delta < 0) {
+    memmove(values - delta, values, len + delta);
+    to = -delta;
+  } else {
+    return values;
+  }
+  row->shift = shift;
+  for (uint16_t i = from; i < to; i++) values[i] = inoise16(uint32_t(i + shift) * scale, y, z) >> 8;
+  return values;
+}
+
 uint16_t WS2812FX::mode_noise16_1()
 {
   uint16_t scale = 320;                                      // the "zoom factor" for the noise
   CRGB fastled_col;
-  SEGENV.step += (1 + SEGMENT.speed/16);
-
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = beatsin8(11);                           // the x position of the noise field swings @ 17 bpm
-    uint16_t shift_y = SEGENV.step/42;             // the y position becomes slowly incremented
+  SEGENV.step += frameStep(1 + SEGMENT.speed/16);
 
+  uint16_t shift_x = beatsin8(11);                           // the x position of the noise field swings @ 17 bpm
+  uint16_t shift_y = SEGENV.step/42;                         // the y position becomes slowly incremented
 
+  for (uint16_t i = 0; i < SEGLEN; i++) {
     uint16_t real_x = (i + shift_x) * scale;                  // the x position of the noise field swings @ 17 bpm
     uint16_t real_y = (i + shift_y) * scale;                  // the y position becomes slowly incremented
     uint32_t real_z = SEGENV.step;                          // the z position becomes quickly incremented
@@ -1986,7 +2028,7 @@ uint16_t WS2812FX::mode_noise16_1()
 
     uint8_t index = sin8(noise * 3);                         // map LED color based on noise data
 
-    fastled_col = ColorFromPalette(currentPalette, index, 255, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+    fastled_col = ColorFromPalette(RCTX.palette, index, 255, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
 
@@ -1998,19 +2040,25 @@ uint16_t WS2812FX::mode_noise16_2()
 {
   uint16_t scale = 1000;                                       // the "zoom factor" for the noise
   CRGB fastled_col;
-  SEGENV.step += (1 + (SEGMENT.speed >> 1));
+  SEGENV.step += frameStep(1 + (SEGMENT.speed >> 1));
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
+  uint16_t shift_x = SEGENV.step >> 6;                         // x as a function of time
 
-    uint16_t shift_x = SEGENV.step >> 6;                         // x as a function of time
+  // the noise field only slides along x, reuse the samples of the previous frame
+  const uint8_t* row = nullptr;
+  if (SEGENV.allocateData(sizeof(noise_row) + SEGLEN)) {
+    row = noiseRow(reinterpret_cast<NoiseRow*>(SEGENV.data), SEGLEN, shift_x, scale, 0, 4223);
+  }
+
+  for (uint16_t i = 0; i < SEGLEN; i++) {
 
     uint32_t real_x = (i + shift_x) * scale;                  // calculate the coordinates within the noise field
 
-    uint8_t noise = inoise16(real_x, 0, 4223) >> 8;    // get the noise data and scale it down
+    uint8_t noise = row ? row[i] : inoise16(real_x, 0, 4223) >> 8; // get the noise data and scale it down
 
     uint8_t index = sin8(noise * 3);                          // map led color based on noise data
 
-    fastled_col = ColorFromPalette(currentPalette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+    fastled_col = ColorFromPalette(RCTX.palette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
 
@@ -2022,22 +2070,21 @@ uint16_t WS2812FX::mode_noise16_3()
 {
   uint16_t scale = 800;                                       // the "zoom factor" for the noise
   CRGB fastled_col;
-  SEGENV.step += (1 + SEGMENT.speed);
+  SEGENV.step += frameStep(1 + SEGMENT.speed);
 
-  for (uint16_t i = 0; i < SEGLEN; i++) {
-
-    uint16_t shift_x = 4223;                                  // no movement along x and y
-    uint16_t shift_y = 1234;
+  uint16_t shift_x = 4223;                                    // no movement along x and y
+  uint16_t shift_y = 1234;
+  uint32_t real_z = SEGENV.step*8;
 
+  for (uint16_t i = 0; i < SEGLEN; i++) {
     uint32_t real_x = (i + shift_x) * scale;                  // calculate the coordinates within the noise field
     uint32_t real_y = (i + shift_y) * scale;                  // based on the precalculated positions
-    uint32_t real_z = SEGENV.step*8;  
 
     uint8_t noise = inoise16(real_x, real_y, real_z) >> 8;    // get the noise data and scale it down
 
     uint8_t index = sin8(noise * 3);                          // map led color based on noise data
 
-    fastled_col = ColorFromPalette(currentPalette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
+    fastled_col = ColorFromPalette(RCTX.palette, index, noise, LINEARBLEND);   // With that value, look up the 8 bit colour palette value and assign it to the current LED.
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
 
@@ -2052,7 +2099,7 @@ uint16_t WS2812FX::mode_noise16_4()
   uint32_t stp = (now * SEGMENT.speed) >> 7;
   for (uint16_t i = 0; i < SEGLEN; i++) {
     int16_t index = inoise16(uint32_t(i) << 12, stp);
-    fastled_col = ColorFromPalette(currentPalette, index);
+    fastled_col = ColorFromPalette(RCTX.palette, index);
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
   return FRAMETIME;
@@ -2099,7 +2146,7 @@ uint16_t WS2812FX::mode_colortwinkle()
       for (uint8_t times = 0; times < 5; times++) { //attempt to spawn a new pixel 5 times
         int i = random16(SEGLEN);
         if (getPixelColor(i) == 0) {
-          fastled_col = ColorFromPalette(currentPalette, random8(), 64, NOBLEND);
+          fastled_col = ColorFromPalette(RCTX.palette, random8(), 64, NOBLEND);
           uint16_t index = i >> 3;
           uint8_t  bitNum = i & 0x07;
           bitWrite(SEGENV.data[index], bitNum, true);
@@ -2125,7 +2172,7 @@ uint16_t WS2812FX::mode_lake() {
   {
     int index = cos8((i*15)+ wave1)/2 + cubicwave8((i*23)+ wave2)/2;           
     uint8_t lum = (index > wave3) ? index - wave3 : 0;
-    fastled_col = ColorFromPalette(currentPalette, map(index,0,255,0,240), lum, LINEARBLEND);
+    fastled_col = ColorFromPalette(RCTX.palette, map(index,0,255,0,240), lum, LINEARBLEND);
     setPixelColor(i, fastled_col.red, fastled_col.green, fastled_col.blue);
   }
   return FRAMETIME;
@@ -2202,7 +2249,7 @@ uint16_t WS2812FX::mode_meteor_smooth() {
     trail[index] = 240;
   }
 
-  SEGENV.step += SEGMENT.speed +1;
+  SEGENV.step += frameStep(SEGMENT.speed +1);
   return FRAMETIME;
 }
 
@@ -2233,7 +2280,7 @@ uint16_t WS2812FX::mode_railway()
       setPixelColor(i + 1, color_from_palette(pos, false, false, 255));
     }
   }
-  SEGENV.step += FRAMETIME;
+  SEGENV.step += deltaTime();
   return FRAMETIME;
 }
 
@@ -2383,7 +2430,7 @@ CRGB IRAM_ATTR WS2812FX::twinklefox_one_twinkle(uint32_t ms, uint8_t salt, bool
   uint8_t hue = slowcycle8 - salt;
   CRGB c;
   if (bright > 0) {
-    c = ColorFromPalette(currentPalette, hue, bright, NOBLEND);
+    c = ColorFromPalette(RCTX.palette, hue, bright, NOBLEND);
     if(COOL_LIKE_INCANDESCENT == 1) {
       // This code takes a pixel, and if its in the 'fading down'
       // part of the cycle, it adjusts the color a little bit like the
@@ -2624,11 +2671,58 @@ uint16_t WS2812FX::mode_spots_fade()
 }
 
 
+/*
+ * Fixed point particle kinematics, shared by Bouncing Balls, Popcorn, Starburst, Exploding Fireworks and Drip.
+ * Positions, velocities and gravity are Q16.16 (pixels, pixels/frame and pixels/frame^2 unless noted),
+ * so the frame loop needs no float math or sqrt()/pow() (ESP8266 has no FPU).
+ */
+typedef int32_t q16_t;
+#define Q16_ONE      65536
+#define Q16_FRAC(n, d) ((q16_t)(((int64_t)(n) << 16) / (d))) // n/d in Q16.16
+
+static inline q16_t q16_mul(q16_t a, q16_t b) { return ((int64_t)a * b) >> 16; }
+static inline q16_t q16_fromInt(int32_t i)   { return i << 16; }
+static inline int32_t q16_toInt(q16_t a)     { return a >> 16; } // floor
+static inline int32_t q16_round(q16_t a)     { return (a + (Q16_ONE >> 1)) >> 16; }
+
+// square root of a non-negative Q16.16 value
+static q16_t q16_sqrt(uint64_t a)
+{
+  uint64_t x = a << 16, res = 0, bit = 1ULL << 62;
+  while (bit > x) bit >>= 2;
+  while (bit) {
+    if (x >= res + bit) { x -= res + bit; res = (res >> 1) + bit; }
+    else res >>= 1;
+    bit >>= 2;
+  }
+  return res;
+}
+
+// velocity needed to reach a height of h pixels against gravity g (negative), sqrt(-2*g*h)
+static inline q16_t particleLaunchVelocity(q16_t gravity, uint16_t h)
+{
+  return q16_sqrt((uint64_t)(-2 * (int64_t)gravity) * h);
+}
+
+// one integration step
+static inline void particleMove(q16_t &pos, q16_t &vel, q16_t gravity)
+{
+  pos += vel;
+  vel += gravity;
+}
+
+// gravity in pixels/frame^2 scaled with segment length: -(base + speed) / div * len
+static inline q16_t particleGravity(uint16_t base, uint8_t speed, uint32_t div, uint16_t len)
+{
+  return -(q16_t)(((int64_t)(base + speed) * len << 16) / div);
+}
+
+
 //each needs 12 bytes
 typedef struct Ball {
   unsigned long lastBounceTime;
-  float impactVelocity;
-  float height;
+  q16_t impactVelocity; // segment lengths per second
+  q16_t height;         // segment lengths
 } ball;
 
 /*
@@ -2644,12 +2738,12 @@ uint16_t WS2812FX::mode_bouncing_balls(void) {
   
   // number of balls based on intensity setting to max of 7 (cycles colors)
   // non-chosen color is a random color
-  uint8_t numBalls = int(((SEGMENT.intensity * (maxNumBalls - 0.8f)) / 255) + 1);
+  uint8_t numBalls = (SEGMENT.intensity * 76) / 1275 + 1; // intensity * (maxNumBalls - 0.8) / 255 + 1
   
-  float gravity                           = -9.81; // standard value of gravity
-  float impactVelocityStart               = sqrt( -2 * gravity);
+  const q16_t gravity             = -642908; // -9.81, standard value of gravity
+  const q16_t impactVelocityStart =  290289; // sqrt(-2 * gravity)
 
-  unsigned long time = millis();
+  unsigned long time = uptimeMs();
 
   if (SEGENV.call == 0) {
     for (uint8_t i = 0; i < maxNumBalls; i++) balls[i].lastBounceTime = time;
@@ -2659,17 +2753,19 @@ uint16_t WS2812FX::mode_bouncing_balls(void) {
   fill(hasCol2 ? BLACK : SEGCOLOR(1));
   
   for (uint8_t i = 0; i < numBalls; i++) {
-    float timeSinceLastBounce = (time - balls[i].lastBounceTime)/((255-SEGMENT.speed)*8/256 +1);
-    balls[i].height = 0.5 * gravity * pow(timeSinceLastBounce/1000 , 2.0) + balls[i].impactVelocity * timeSinceLastBounce/1000;
+    uint32_t timeSinceLastBounce = (time - balls[i].lastBounceTime)/((255-SEGMENT.speed)*8/256 +1);
+    if (timeSinceLastBounce > 10000) timeSinceLastBounce = 10000; // way past a bounce, keeps the math in range
+    q16_t t = Q16_FRAC(timeSinceLastBounce, 1000); // seconds
+    balls[i].height = q16_mul(q16_mul(gravity >> 1, t), t) + q16_mul(balls[i].impactVelocity, t);
 
     if (balls[i].height < 0) { //start bounce
       balls[i].height = 0;
       //damping for better effect using multiple balls
-      float dampening = 0.90 - float(i)/pow(numBalls,2);
-      balls[i].impactVelocity = dampening * balls[i].impactVelocity;
+      q16_t dampening = Q16_FRAC(90, 100) - Q16_FRAC(i, numBalls * numBalls);
+      balls[i].impactVelocity = q16_mul(dampening, balls[i].impactVelocity);
       balls[i].lastBounceTime = time;
 
-      if (balls[i].impactVelocity < 0.015) {
+      if (balls[i].impactVelocity < Q16_FRAC(15, 1000)) {
         balls[i].impactVelocity = impactVelocityStart;
       }
     }
@@ -2681,7 +2777,7 @@ uint16_t WS2812FX::mode_bouncing_balls(void) {
       color = SEGCOLOR(i % NUM_COLORS);
     }
 
-    uint16_t pos = round(balls[i].height * (SEGLEN - 1));
+    uint16_t pos = q16_round(balls[i].height * (SEGLEN - 1));
     setPixelColor(pos, color);
   }
 
@@ -2756,8 +2852,8 @@ uint16_t WS2812FX::mode_glitter()
 //each needs 12 bytes
 //Spark type is used for popcorn, 1D fireworks, and drip
 typedef struct Spark {
-  float pos;
-  float vel;
+  q16_t pos;
+  q16_t vel;
   uint16_t col;
   uint8_t colIndex;
 } spark;
@@ -2774,8 +2870,7 @@ uint16_t WS2812FX::mode_popcorn(void) {
   
   Spark* popcorn = reinterpret_cast<Spark*>(SEGENV.data);
 
-  float gravity = -0.0001 - (SEGMENT.speed/200000.0); // m/s/s
-  gravity *= SEGLEN;
+  q16_t gravity = particleGravity(20, SEGMENT.speed, 200000, SEGLEN); // (-0.0001 - speed/200000) * SEGLEN
 
   bool hasCol2 = SEGCOLOR(2);
   fill(hasCol2 ? BLACK : SEGCOLOR(1));
@@ -2784,16 +2879,15 @@ uint16_t WS2812FX::mode_popcorn(void) {
   if (numPopcorn == 0) numPopcorn = 1;
 
   for(uint8_t i = 0; i < numPopcorn; i++) {
-    if (popcorn[i].pos >= 0.0f) { // if kernel is active, update its position
-      popcorn[i].pos += popcorn[i].vel;
-      popcorn[i].vel += gravity;
+    if (popcorn[i].pos >= 0) { // if kernel is active, update its position
+      particleMove(popcorn[i].pos, popcorn[i].vel, gravity);
     } else { // if kernel is inactive, randomly pop it
       if (random8() < 2) { // POP!!!
-        popcorn[i].pos = 0.01f;
+        popcorn[i].pos = Q16_FRAC(1, 100);
         
         uint16_t peakHeight = 128 + random8(128); //0-255
         peakHeight = (peakHeight * (SEGLEN -1)) >> 8;
-        popcorn[i].vel = sqrt(-2.0 * gravity * peakHeight);
+        popcorn[i].vel = particleLaunchVelocity(gravity, peakHeight);
         
         if (SEGMENT.palette)
         {
@@ -2805,11 +2899,11 @@ uint16_t WS2812FX::mode_popcorn(void) {
         }
       }
     }
-    if (popcorn[i].pos >= 0.0f) { // draw now active popcorn (either active before or just popped)
+    if (popcorn[i].pos >= 0) { // draw now active popcorn (either active before or just popped)
       uint32_t col = color_wheel(popcorn[i].colIndex);
       if (!SEGMENT.palette && popcorn[i].colIndex < NUM_COLORS) col = SEGCOLOR(popcorn[i].colIndex);
       
-      uint16_t ledIndex = popcorn[i].pos;
+      uint16_t ledIndex = q16_toInt(popcorn[i].pos);
       if (ledIndex < SEGLEN) setPixelColor(ledIndex, col);
     }
   }
@@ -2924,9 +3018,9 @@ typedef struct particle {
   CRGB     color;
   uint32_t birth  =0;
   uint32_t last   =0;
-  float    vel    =0;
+  q16_t    vel    =0; // pixels per second
   uint16_t pos    =-1;
-  float    fragment[STARBURST_MAX_FRAG];
+  q16_t    fragment[STARBURST_MAX_FRAG];
 } star;
 
 uint16_t WS2812FX::mode_starburst(void) {
@@ -2942,13 +3036,13 @@ uint16_t WS2812FX::mode_starburst(void) {
 
   if (!SEGENV.allocateData(dataSize)) return mode_static(); //allocation failed
   
-  uint32_t it = millis();
+  uint32_t it = uptimeMs();
   
   star* stars = reinterpret_cast<star*>(SEGENV.data);
   
-  float          maxSpeed                = 375.0f;  // Max velocity
-  float          particleIgnition        = 250.0f;  // How long to "flash"
-  float          particleFadeTime        = 1500.0f; // Fade out time
+  const uint32_t maxSpeed                = 375;  // Max velocity
+  const uint32_t particleIgnition        = 250;  // How long to "flash"
+  const uint32_t particleFadeTime        = 1500; // Fade out time
      
   for (int j = 0; j < numStars; j++)
   {
@@ -2957,18 +3051,18 @@ uint16_t WS2812FX::mode_starburst(void) {
     {
       // Pick a random color and location.  
       uint16_t startPos = random16(SEGLEN-1);
-      float multiplier = (float)(random8())/255.0 * 1.0;
+      uint8_t multiplier = random8();
 
       stars[j].color = col_to_crgb(color_wheel(random8()));
       stars[j].pos = startPos; 
-      stars[j].vel = maxSpeed * (float)(random8())/255.0 * multiplier;
+      stars[j].vel = Q16_FRAC(maxSpeed * random8() * multiplier, 255 * 255);
       stars[j].birth = it;
       stars[j].last = it;
       // more fragments means larger burst effect
       int num = random8(3,6 + (SEGMENT.intensity >> 5));
 
       for (int i=0; i < STARBURST_MAX_FRAG; i++) {
-        if (i < num) stars[j].fragment[i] = startPos;
+        if (i < num) stars[j].fragment[i] = q16_fromInt(startPos);
         else stars[j].fragment[i] = -1;
       }
     }
@@ -2979,54 +3073,53 @@ uint16_t WS2812FX::mode_starburst(void) {
   for (int j=0; j<numStars; j++)
   {
     if (stars[j].birth != 0) {
-      float dt = (it-stars[j].last)/1000.0;
+      uint32_t dt = it-stars[j].last; // ms
 
       for (int i=0; i < STARBURST_MAX_FRAG; i++) {
         int var = i >> 1;
         
         if (stars[j].fragment[i] > 0) {
           //all fragments travel right, will be mirrored on other side
-          stars[j].fragment[i] += stars[j].vel * dt * (float)var/3.0;
+          stars[j].fragment[i] += (int64_t)stars[j].vel * dt * var / 3000;
         }
       }
       stars[j].last = it;
-      stars[j].vel -= 3*stars[j].vel*dt;
+      stars[j].vel -= (int64_t)stars[j].vel * dt * 3 / 1000;
     }
   
     CRGB c = stars[j].color;
 
     // If the star is brand new, it flashes white briefly.  
     // Otherwise it just fades over time.
-    float fade = 0.0f;
-    float age = it-stars[j].birth;
+    uint32_t fade = 0; // in 1/particleFadeTime
+    uint32_t age = it-stars[j].birth;
 
     if (age < particleIgnition) {
-      c = col_to_crgb(color_blend(WHITE, crgb_to_col(c), 254.5f*((age / particleIgnition))));
+      c = col_to_crgb(color_blend(WHITE, crgb_to_col(c), age * 509 / (2 * particleIgnition)));
     } else {
       // Figure out how much to fade and shrink the star based on 
       // its age relative to its lifetime
       if (age > particleIgnition + particleFadeTime) {
-        fade = 1.0f;                  // Black hole, all faded out
+        fade = particleFadeTime;      // Black hole, all faded out
         stars[j].birth = 0;
         c = col_to_crgb(SEGCOLOR(1));
       } else {
-        age -= particleIgnition;
-        fade = (age / particleFadeTime);  // Fading star
-        byte f = 254.5f*fade;
+        fade = age - particleIgnition; // Fading star
+        byte f = fade * 509 / (2 * particleFadeTime);
         c = col_to_crgb(color_blend(crgb_to_col(c), SEGCOLOR(1), f));
       }
     }
     
-    float particleSize = (1.0 - fade) * 2;
+    q16_t particleSize = Q16_FRAC(2 * (particleFadeTime - fade), particleFadeTime);
 
     for (uint8_t index=0; index < STARBURST_MAX_FRAG*2; index++) {
       bool mirrored = index & 0x1;
       uint8_t i = index >> 1;
       if (stars[j].fragment[i] > 0) {
-        float loc = stars[j].fragment[i];
-        if (mirrored) loc -= (loc-stars[j].pos)*2;
-        int start = loc - particleSize;
-        int end = loc + particleSize;
+        q16_t loc = stars[j].fragment[i];
+        if (mirrored) loc = q16_fromInt(2 * stars[j].pos) - loc;
+        int start = q16_toInt(loc - particleSize);
+        int end = q16_toInt(loc + particleSize);
         if (start < 0) start = 0;
         if (start == end) end++;
         if (end > SEGLEN) end = SEGLEN;    
@@ -3071,15 +3164,14 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
   Spark* sparks = reinterpret_cast<Spark*>(SEGENV.data);
   Spark* flare = sparks; //first spark is flare data
 
-  float gravity = -0.0004 - (SEGMENT.speed/800000.0); // m/s/s
-  gravity *= SEGLEN;
+  q16_t gravity = particleGravity(320, SEGMENT.speed, 800000, SEGLEN); // (-0.0004 - speed/800000) * SEGLEN
   
   if (SEGENV.aux0 < 2) { //FLARE
     if (SEGENV.aux0 == 0) { //init flare
       flare->pos = 0;
       uint16_t peakHeight = 75 + random8(180); //0-255
       peakHeight = (peakHeight * (SEGLEN -1)) >> 8;
-      flare->vel = sqrt(-2.0 * gravity * peakHeight);
+      flare->vel = particleLaunchVelocity(gravity, peakHeight);
       flare->col = 255; //brightness
 
       SEGENV.aux0 = 1; 
@@ -3088,11 +3180,10 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
     // launch 
     if (flare->vel > 12 * gravity) {
       // flare
-      setPixelColor(int(flare->pos),flare->col,flare->col,flare->col);
+      setPixelColor(q16_toInt(flare->pos),flare->col,flare->col,flare->col);
   
-      flare->pos += flare->vel;
-      flare->pos = constrain(flare->pos, 0, SEGLEN-1);
-      flare->vel += gravity;
+      particleMove(flare->pos, flare->vel, gravity);
+      flare->pos = constrain(flare->pos, 0, q16_fromInt(SEGLEN-1));
       flare->col -= 2;
     } else {
       SEGENV.aux0 = 2;  // ready to explode
@@ -3104,20 +3195,20 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
      * Explosion happens where the flare ended.
      * Size is proportional to the height.
      */
-    int nSparks = flare->pos;
+    int nSparks = q16_toInt(flare->pos);
     nSparks = constrain(nSparks, 0, numSparks);
-    static float dying_gravity;
+    static q16_t dying_gravity;
   
     // initialize sparks
     if (SEGENV.aux0 == 2) {
       for (int i = 1; i < nSparks; i++) { 
         sparks[i].pos = flare->pos; 
-        sparks[i].vel = (float(random16(0, 20000)) / 10000.0) - 0.9; // from -0.9 to 1.1
+        sparks[i].vel = Q16_FRAC(random16(0, 20000), 10000) - Q16_FRAC(9, 10); // from -0.9 to 1.1
         sparks[i].col = 345;//abs(sparks[i].vel * 750.0); // set colors before scaling velocity to keep them bright 
         //sparks[i].col = constrain(sparks[i].col, 0, 345); 
         sparks[i].colIndex = random8();
-        sparks[i].vel *= flare->pos/SEGLEN; // proportional to height 
-        sparks[i].vel *= -gravity *50;
+        sparks[i].vel = q16_mul(sparks[i].vel, flare->pos / SEGLEN); // proportional to height 
+        sparks[i].vel = q16_mul(sparks[i].vel, -gravity * 50);
       } 
       //sparks[1].col = 345; // this will be our known spark 
       dying_gravity = gravity/2; 
@@ -3126,11 +3217,10 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
   
     if (sparks[1].col > 4) {//&& sparks[1].pos > 0) { // as long as our known spark is lit, work with all the sparks
       for (int i = 1; i < nSparks; i++) { 
-        sparks[i].pos += sparks[i].vel; 
-        sparks[i].vel += dying_gravity; 
+        particleMove(sparks[i].pos, sparks[i].vel, dying_gravity); 
         if (sparks[i].col > 3) sparks[i].col -= 4; 
 
-        if (sparks[i].pos > 0 && sparks[i].pos < SEGLEN) {
+        if (sparks[i].pos > 0 && sparks[i].pos < q16_fromInt(SEGLEN)) {
           uint16_t prog = sparks[i].col;
           uint32_t spColor = (SEGMENT.palette) ? color_wheel(sparks[i].colIndex) : SEGCOLOR(0);
           CRGB c = CRGB::Black; //HeatColor(sparks[i].col);
@@ -3142,10 +3232,10 @@ uint16_t WS2812FX::mode_exploding_fireworks(void)
             c.g = qsub8(c.g, cooling);
             c.b = qsub8(c.b, cooling * 2);
           }
-          setPixelColor(int(sparks[i].pos), c.red, c.green, c.blue);
+          setPixelColor(q16_toInt(sparks[i].pos), c.red, c.green, c.blue);
         }
       }
-      dying_gravity *= .99; // as sparks burn out they fall slower
+      dying_gravity = q16_mul(dying_gravity, Q16_FRAC(99, 100)); // as sparks burn out they fall slower
     } else {
       SEGENV.aux0 = 6 + random8(10); //wait for this many frames
     }
@@ -3181,13 +3271,12 @@ uint16_t WS2812FX::mode_drip(void)
 
   numDrops = 1 + (SEGMENT.intensity >> 6); // 255>>6 = 3
 
-  float gravity = -0.0005 - (SEGMENT.speed/50000.0);
-  gravity *= SEGLEN;
+  q16_t gravity = particleGravity(25, SEGMENT.speed, 50000, SEGLEN); // (-0.0005 - speed/50000) * SEGLEN
   int sourcedrop = 12;
 
   for (uint8_t j=0;j<numDrops;j++) {
     if (drops[j].colIndex == 0) { //init
-      drops[j].pos = SEGLEN-1;    // start at end
+      drops[j].pos = q16_fromInt(SEGLEN-1); // start at end
       drops[j].vel = 0;           // speed
       drops[j].col = sourcedrop;  // brightness
       drops[j].colIndex = 1;      // drop state (0 init, 1 forming, 2 falling, 5 bouncing) 
@@ -3196,7 +3285,7 @@ uint16_t WS2812FX::mode_drip(void)
     setPixelColor(SEGLEN-1,color_blend(BLACK,SEGCOLOR(0), sourcedrop));// water source
     if (drops[j].colIndex==1) {
       if (drops[j].col>255) drops[j].col=255;
-      setPixelColor(uint16_t(drops[j].pos),color_blend(BLACK,SEGCOLOR(0),drops[j].col));
+      setPixelColor(q16_toInt(drops[j].pos),color_blend(BLACK,SEGCOLOR(0),drops[j].col));
       
       drops[j].col += map(SEGMENT.speed, 0, 255, 1, 6); // swelling
       
@@ -3207,12 +3296,11 @@ uint16_t WS2812FX::mode_drip(void)
     }  
     if (drops[j].colIndex > 1) {           // falling
       if (drops[j].pos > 0) {              // fall until end of segment
-        drops[j].pos += drops[j].vel;
+        particleMove(drops[j].pos, drops[j].vel, gravity); // gravity is negative
         if (drops[j].pos < 0) drops[j].pos = 0;
-        drops[j].vel += gravity;           // gravity is negative
 
         for (uint16_t i=1;i<7-drops[j].colIndex;i++) { // some minor math so we don't expand bouncing droplets
-          uint16_t pos = constrain(uint16_t(drops[j].pos) +i, 0, SEGLEN-1); //this is BAD, returns a pos >= SEGLEN occasionally
+          uint16_t pos = constrain(uint16_t(q16_toInt(drops[j].pos)) +i, 0, SEGLEN-1); //this is BAD, returns a pos >= SEGLEN occasionally
           setPixelColor(pos,color_blend(BLACK,SEGCOLOR(0),drops[j].col/i)); //spread pixel with fade while falling
         }
 
@@ -3310,7 +3398,7 @@ uint16_t WS2812FX::mode_plasma(void) {
     uint8_t colorIndex = cubicwave8((i*(2+ 3*(SEGMENT.speed >> 5))+thisPhase) & 0xFF)/2   // factor=23 // Create a wave and add a phase change and add another wave with its own phase change.
                              + cos8((i*(1+ 2*(SEGMENT.speed >> 5))+thatPhase) & 0xFF)/2;  // factor=15 // Hey, you can even change the frequencies if you wish.
     uint8_t thisBright = qsub8(colorIndex, beatsin8(7,0, (128 - (SEGMENT.intensity>>1))));
-    CRGB color = ColorFromPalette(currentPalette, colorIndex, thisBright, LINEARBLEND);
+    CRGB color = ColorFromPalette(RCTX.palette, colorIndex, thisBright, LINEARBLEND);
     setPixelColor(i, color.red, color.green, color.blue);
   }
 
@@ -3374,7 +3462,7 @@ uint16_t WS2812FX::mode_heartbeat(void) {
   bri_lower = bri_lower * 2042 / (2048 + SEGMENT.intensity);
   SEGENV.aux1 = bri_lower;
 
-  unsigned long beatTimer = millis() - SEGENV.step;
+  unsigned long beatTimer = uptimeMs() - SEGENV.step;
   if((beatTimer > secondBeat) && !SEGENV.aux0) { // time for the second beat?
     SEGENV.aux1 = UINT16_MAX; //full bri
     SEGENV.aux0 = 1;
@@ -3382,7 +3470,7 @@ uint16_t WS2812FX::mode_heartbeat(void) {
   if(beatTimer > msPerBeat) { // time to reset the beat timer?
     SEGENV.aux1 = UINT16_MAX; //full bri
     SEGENV.aux0 = 0;
-    SEGENV.step = millis();
+    SEGENV.step = uptimeMs();
   }
 
   for (uint16_t i = 0; i < SEGLEN; i++) {
@@ -3432,9 +3520,9 @@ uint16_t WS2812FX::mode_pacifica()
       0x000E39, 0x001040, 0x001450, 0x001860, 0x001C70, 0x002080, 0x1040BF, 0x2060FF };
 
   if (SEGMENT.palette) {
-    pacifica_palette_1 = currentPalette;
-    pacifica_palette_2 = currentPalette;
-    pacifica_palette_3 = currentPalette;
+    pacifica_palette_1 = RCTX.palette;
+    pacifica_palette_2 = RCTX.palette;
+    pacifica_palette_3 = RCTX.palette;
   }
 
   // Increment the four "color index start" counters, one for each wave layer.
@@ -3463,14 +3551,19 @@ uint16_t WS2812FX::mode_pacifica()
 
   uint8_t basethreshold = beatsin8( 9, 55, 65);
   uint8_t wave = beat8( 7 );
+
+  // layer parameters only depend on time, evaluate them once per frame
+  uint16_t scale1 = beatsin16(3, 11 * 256, 14 * 256), scale2 = beatsin16(4, 6 * 256, 9 * 256);
+  uint8_t  bri1 = beatsin8(10, 70, 130), bri2 = beatsin8(17, 40, 80), bri3 = beatsin8(9, 10, 38), bri4 = beatsin8(8, 10, 28);
+  uint16_t off1 = 0-beat16(301), off2 = beat16(401), off3 = 0-beat16(503), off4 = beat16(601);
   
   for( uint16_t i = 0; i < SEGLEN; i++) {
     CRGB c = CRGB(2, 6, 10);
     // Render each of four layers, with different scales and speeds, that vary over time
-    c += pacifica_one_layer(i, pacifica_palette_1, sCIStart1, beatsin16(3, 11 * 256, 14 * 256), beatsin8(10, 70, 130), 0-beat16(301));
-    c += pacifica_one_layer(i, pacifica_palette_2, sCIStart2, beatsin16(4,  6 * 256,  9 * 256), beatsin8(17, 40,  80),   beat16(401));
-    c += pacifica_one_layer(i, pacifica_palette_3, sCIStart3,                         6 * 256 , beatsin8(9, 10,38)   , 0-beat16(503));
-    c += pacifica_one_layer(i, pacifica_palette_3, sCIStart4,                         5 * 256 , beatsin8(8, 10,28)   ,   beat16(601));
+    c += pacifica_one_layer(i, pacifica_palette_1, sCIStart1, scale1 , bri1, off1);
+    c += pacifica_one_layer(i, pacifica_palette_2, sCIStart2, scale2 , bri2, off2);
+    c += pacifica_one_layer(i, pacifica_palette_3, sCIStart3, 6 * 256, bri3, off3);
+    c += pacifica_one_layer(i, pacifica_palette_3, sCIStart4, 5 * 256, bri4, off4);
     
     // Add extra 'white' to areas where the four layers of light have lined up brightly
     uint8_t threshold = scale8( sin8( wave), 20) + basethreshold;
@@ -3532,14 +3625,14 @@ uint16_t WS2812FX::mode_sunrise() {
   //speed 60 - 120 : sunset time in minutes - 60;
   //speed above: "breathing" rise and set
   if (SEGENV.call == 0 || SEGMENT.speed != SEGENV.aux0) {
-	  SEGENV.step = millis(); //save starting time, millis() because now can change from sync
+	  SEGENV.step = uptimeMs(); //save starting time, uptime because now can change from sync
     SEGENV.aux0 = SEGMENT.speed;
   }
   
   fill(0);
   uint16_t stage = 0xFFFF;
   
-  uint32_t s10SinceStart = (millis() - SEGENV.step) /100; //tenths of seconds
+  uint32_t s10SinceStart = (uptimeMs() - SEGENV.step) /100; //tenths of seconds
   
   if (SEGMENT.speed > 120) { //quick sunrise and sunset
 	  uint16_t counter = (now >> 1) * (((SEGMENT.speed -120) >> 1) +1);
@@ -3644,9 +3737,9 @@ uint16_t WS2812FX::mode_noisepal(void) {                                    // S
   CRGBPalette16* palettes = reinterpret_cast<CRGBPalette16*>(SEGENV.data);
 
   uint16_t changePaletteMs = 4000 + SEGMENT.speed *10; //between 4 - 6.5sec
-  if (millis() - SEGENV.step > changePaletteMs)
+  if (uptimeMs() - SEGENV.step > changePaletteMs)
   {
-    SEGENV.step = millis();
+    SEGENV.step = uptimeMs();
 
     uint8_t baseI = random8();
     palettes[1] = CRGBPalette16(CHSV(baseI+random8(64), 255, random8(128,255)), CHSV(baseI+128, 255, random8(128,255)), CHSV(baseI+random8(92), 192, random8(128,255)), CHSV(baseI+random8(92), 255, random8(128,255)));
@@ -3657,7 +3750,7 @@ uint16_t WS2812FX::mode_noisepal(void) {                                    // S
   //EVERY_N_MILLIS(10) { //(don't have to time this, effect function is only called every 24ms)
   nblendPaletteTowardPalette(palettes[0], palettes[1], 48);               // Blend towards the target palette over 48 iterations.
 
-  if (SEGMENT.palette > 0) palettes[0] = currentPalette;
+  if (SEGMENT.palette > 0) palettes[0] = RCTX.palette;
 
   for(int i = 0; i < SEGLEN; i++) {
     uint8_t index = inoise8(i*scale, SEGENV.aux0+i*scale);                // Get a value from the noise function. I'm using both x and y axis.
@@ -3665,7 +3758,7 @@ uint16_t WS2812FX::mode_noisepal(void) {                                    // S
     setPixelColor(i, color.red, color.green, color.blue);
   }
 
-  SEGENV.aux0 += beatsin8(10,1,4);                                        // Moving along the distance. Vary it a bit with a sine wave.
+  SEGENV.aux0 += frameStep(beatsin8(10,1,4));                                       // Moving along the distance. Vary it a bit with a sine wave.
 
   return FRAMETIME;
 }
@@ -3679,7 +3772,7 @@ uint16_t WS2812FX::mode_sinewave(void) {             // Adjustable sinewave. By
 
   uint16_t colorIndex = now /32;//(256 - SEGMENT.fft1);  // Amount of colour change.
 
-  SEGENV.step += SEGMENT.speed/16;                   // Speed of animation.
+  SEGENV.step += frameStep(SEGMENT.speed/16);        // Speed of animation.
   uint16_t freq = SEGMENT.intensity/4;//SEGMENT.fft2/8;                       // Frequency of the signal.
 
   for (int i=0; i<SEGLEN; i++) {                   // For each of the LED's in the strand, set a brightness based on a wave as follows:
@@ -3793,7 +3886,7 @@ uint16_t WS2812FX::mode_dancing_shadows(void)
 
   fill(BLACK);
 
-  unsigned long time = millis();
+  unsigned long time = uptimeMs();
   bool respawn = false;
 
   for (uint8_t i = 0; i < numSpotlights; i++) {
@@ -3907,10 +4000,10 @@ uint16_t WS2812FX::mode_washing_machine(void) {
   float quot  = 32.0f - ((float)SEGMENT.speed / 16.0f);
   speed /= quot;
 
-  SEGENV.step += (speed * 128.0f);
+  SEGENV.step += frameStep(speed * 32768.0f); // 1/32768 steps, so the fraction of each frame carries over
   
   for (int i=0; i<SEGLEN; i++) {
-    uint8_t col = sin8(((SEGMENT.intensity / 25 + 1) * 255 * i / SEGLEN) + (SEGENV.step >> 7));
+    uint8_t col = sin8(((SEGMENT.intensity / 25 + 1) * 255 * i / SEGLEN) + (SEGENV.step >> 15));
     setPixelColor(i, color_from_palette(col, false, PALETTE_SOLID_WRAP, 3));
   }
 
@@ -3985,8 +4078,8 @@ uint16_t WS2812FX::mode_tv_simulator(void) {
   }
 
     // create a new sceene
-    if (((millis() - tvSimulator->sceeneStart) >= tvSimulator->sceeneDuration) || SEGENV.aux1 == 0) {
-      tvSimulator->sceeneStart    = millis();                                               // remember the start of the new sceene
+    if (((uptimeMs() - tvSimulator->sceeneStart) >= tvSimulator->sceeneDuration) || SEGENV.aux1 == 0) {
+      tvSimulator->sceeneStart    = uptimeMs();                                               // remember the start of the new sceene
       tvSimulator->sceeneDuration = random16(60* 250* colorSpeed, 60* 750 * colorSpeed);    // duration of a "movie sceene" which has similar colors (5 to 15 minutes with max speed slider)
       tvSimulator->sceeneColorHue = random16(   0, 768);                                    // random start color-tone for the sceene
       tvSimulator->sceeneColorSat = random8 ( 100, 130 + colorIntensity);                   // random start color-saturation for the sceene
@@ -4037,11 +4130,11 @@ uint16_t WS2812FX::mode_tv_simulator(void) {
     tvSimulator->fadeTime  = random16(0, tvSimulator->totalTime);   // Pixel-to-pixel transition time
     if (random8(10) < 3) tvSimulator->fadeTime = 0;                 // Force scene cut 30% of time
 
-    tvSimulator->startTime = millis();
+    tvSimulator->startTime = uptimeMs();
   } // end of initialization
 
   // how much time is elapsed ?
-  tvSimulator->elapsed = millis() - tvSimulator->startTime;
+  tvSimulator->elapsed = uptimeMs() - tvSimulator->startTime;
 
   // fade from prev volor to next color
   if (tvSimulator->elapsed < tvSimulator->fadeTime) {
@@ -4098,15 +4191,15 @@ class AuroraWave {
 
   public:
     void init(uint32_t segment_length, CRGB color) {
-      ttl = random(500, 1501);
+      ttl = random16(500, 1501);
       basecolor = color;
-      basealpha = random(60, 101) / (float)100;
+      basealpha = random16(60, 101) / (float)100;
       age = 0;
-      width = random(segment_length / 20, segment_length / W_WIDTH_FACTOR); //half of width to make math easier
+      width = random16(segment_length / 20, segment_length / W_WIDTH_FACTOR); //half of width to make math easier
       if (!width) width = 1;
-      center = random(101) / (float)100 * segment_length;
-      goingleft = random(0, 2) == 0;
-      speed_factor = (random(10, 31) / (float)100 * W_MAX_SPEED / 255);
+      center = random16(101) / (float)100 * segment_length;
+      goingleft = random16(0, 2) == 0;
+      speed_factor = (random16(10, 31) / (float)100 * W_MAX_SPEED / 255);
       alive = true;
     }
 
@@ -4188,7 +4281,7 @@ uint16_t WS2812FX::mode_aurora(void) {
     waves = reinterpret_cast<AuroraWave*>(SEGENV.data);
 
     for(int i = 0; i < SEGENV.aux1; i++) {
-      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random(0, 3))));
+      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random8(0, 3))));
     }
   } else {
     waves = reinterpret_cast<AuroraWave*>(SEGENV.data);
@@ -4200,7 +4293,7 @@ uint16_t WS2812FX::mode_aurora(void) {
 
     if(!(waves[i].stillAlive())) {
       //If a wave dies, reinitialize it starts over.
-      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random(0, 3))));
+      waves[i].init(SEGLEN, col_to_crgb(color_from_palette(random8(), false, false, random8(0, 3))));
     }
   }
 
@@ -4226,4 +4319,108 @@ uint16_t WS2812FX::mode_aurora(void) {
   }
   
   return FRAMETIME;
-}
\ No newline at end of file
+}
+
+/*
+ * Playback of pre-rendered animations from the file system, /anim<n>.wla with n the intensity slider.
+ * Speed sets the rate, 128 as recorded, 0 holds the first frame. The frame shown follows strip.now, so nodes
+ * sharing the time base play in step, and the last frame is followed by the first.
+ * While a frame is shown the next one is read ahead into the second buffer, a frame is only read
+ * directly if playback jumped. Files with another length than the segment are stretched to it.
+ *
+ * File (little endian): 0-2 "WLA", 3 version (1), 4 bytes per pixel (3 RGB or 4 RGBW), 5 unused, 6-7 pixels,
+ * 8-11 frames, 12-13 frame duration in ms, 14-15 unused, then the frames, each pixels * bytes per pixel
+ */
+typedef struct Playback {
+  uint32_t frames;
+  uint32_t shown;     // frame in buffer cur
+  uint32_t ahead;     // frame in the other buffer
+  uint16_t pixels;
+  uint16_t frameMs;
+  uint8_t  bpp;
+  uint8_t  cur;
+  uint8_t  file;      // intensity it was opened for
+} playback;
+
+static File     playFiles[MAX_NUM_SEGMENTS]; // kept open while the segment plays, see closeIdlePlayback()
+static uint32_t playChecked = 0;
+
+static bool readAnimFrame(File& f, uint32_t frame, uint16_t size, uint8_t* dst) {
+  return f.seek(ANIM_HEADER + frame * size) && f.read(dst, size) == size;
+}
+
+uint16_t WS2812FX::mode_playback(void) {
+  uint8_t id = RCTX.segIndex;
+  File& f = playFiles[id];
+  Playback* pb = reinterpret_cast<Playback*>(SEGENV.data);
+
+  if (SEGENV.aux1 == SEGMENT.intensity + 1U) return mode_static(); //file missing or invalid, retried once intensity changes
+
+  if (SEGENV.call == 0 || !pb || pb->file != SEGMENT.intensity || !f) {
+    char name[16];
+    snprintf_P(name, sizeof(name), PSTR("/anim%u.wla"), SEGMENT.intensity);
+    f.close();
+    f = WLED_FS.open(name, "r");
+    uint8_t h[ANIM_HEADER] = {0};
+    bool valid = f && f.read(h, ANIM_HEADER) == ANIM_HEADER && h[0] == 'W' && h[1] == 'L' && h[2] == 'A' && h[3] == 1 && (h[4] == 3 || h[4] == 4);
+    uint16_t pixels  = h[6] | (h[7] << 8);
+    uint32_t frames  = h[8] | (h[9] << 8) | ((uint32_t)h[10] << 16) | ((uint32_t)h[11] << 24);
+    uint16_t frameMs = h[12] | (h[13] << 8);
+    uint32_t frameSize = (uint32_t)pixels * h[4];
+    valid = valid && pixels && frames && frameMs && 2 * frameSize <= UINT16_MAX - sizeof(Playback);
+    if (!valid || !SEGENV.allocateData(sizeof(Playback) + 2 * frameSize)) {
+      f.close();
+      SEGENV.aux1 = SEGMENT.intensity + 1;
+      return mode_static();
+    }
+    pb = reinterpret_cast<Playback*>(SEGENV.data);
+    pb->frames  = frames;
+    pb->pixels  = pixels;
+    pb->frameMs = frameMs;
+    pb->bpp     = h[4];
+    pb->cur     = 0;
+    pb->file    = SEGMENT.intensity;
+    pb->shown = pb->ahead = UINT32_MAX;
+  }
+
+  uint16_t frameSize = pb->pixels * pb->bpp;
+  uint8_t* buf = SEGENV.data + sizeof(Playback);
+  uint32_t frame = (((uint64_t)now * SEGMENT.speed) >> 7) / pb->frameMs % pb->frames;
+  if (frame != pb->shown) {
+    if (frame == pb->ahead) { //the usual case, swap buffers
+      pb->cur ^= 1;
+      pb->ahead = pb->shown;
+      pb->shown = frame;
+    } else if (readAnimFrame(f, frame, frameSize, buf + pb->cur * frameSize)) {
+      pb->shown = frame;
+    } else { //file shortened or removed
+      f.close();
+      SEGENV.aux1 = SEGMENT.intensity + 1;
+      return mode_static();
+    }
+  }
+
+  const uint8_t* px = buf + pb->cur * frameSize;
+  for (uint16_t i = 0; i < SEGLEN; i++) {
+    uint16_t p = (pb->pixels == SEGLEN) ? i : (uint32_t)i * pb->pixels / SEGLEN;
+    const uint8_t* c = px + p * pb->bpp;
+    setPixelColor(i, c[0], c[1], c[2], pb->bpp == 4 ? c[3] : 0);
+  }
+
+  uint32_t next = (frame + 1 < pb->frames) ? frame + 1 : 0;
+  if (pb->ahead != next) {
+    pb->ahead = readAnimFrame(f, next, frameSize, buf + (pb->cur ^ 1) * frameSize) ? next : UINT32_MAX;
+  }
+  return FRAMETIME;
+}
+
+//closes the files of segments no longer playing, checked once a second
+void WS2812FX::closeIdlePlayback(uint32_t nowUp) {
+  if (nowUp - playChecked < 1000) return;
+  playChecked = nowUp;
+  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    if (!playFiles[i]) continue;
+    if (_segments[i].isActive() && _segments[i].mode == FX_MODE_PLAYBACK && _segment_runtimes[i].data) continue;
+    playFiles[i].close();
+  }
+}
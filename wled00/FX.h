@@ -28,6 +28,7 @@
 #define WS2812FX_h
 
 #include "const.h"
+#include "wled_alloc.h"
 
 #define FASTLED_INTERNAL //remove annoying pragma messages
 #define USE_GET_MILLISECOND_TIMER
@@ -55,34 +56,167 @@
 #define WLED_FPS         42
 #define FRAMETIME_FIXED  (1000/WLED_FPS)
 #define FRAMETIME        _frametime
+#define FX_MAX_DELTA_MS  250 // longer gaps between effect calls (frozen, paused) count as this much effect time
 
 /* each segment uses 52 bytes of SRAM memory, so if you're application fails because of
   insufficient memory, decreasing MAX_NUM_SEGMENTS may help */
 #ifdef ESP8266
-  #define MAX_NUM_SEGMENTS    16
-  /* How many color transitions can run at once */
-  #define MAX_NUM_TRANSITIONS  8
+  #ifndef MAX_NUM_SEGMENTS
+    #define MAX_NUM_SEGMENTS  16
+  #endif
   /* How much data bytes all segments combined may allocate */
   #define MAX_SEGMENT_DATA  4096
 #else
   #ifndef MAX_NUM_SEGMENTS
     #define MAX_NUM_SEGMENTS  32
   #endif
-  #define MAX_NUM_TRANSITIONS 24
   #define MAX_SEGMENT_DATA  20480
 #endif
+/* Boards with PSRAM may use this share of the free PSRAM for effect data if it exceeds MAX_SEGMENT_DATA */
+#define SEGMENT_DATA_PSRAM_SHARE 8
 
 /* How much data bytes each segment should max allocate to leave enough space for other segments,
   assuming each segment uses the same amount of data. 256 for ESP8266, 640 for ESP32. */
 #define FAIR_DATA_PER_SEG (MAX_SEGMENT_DATA / MAX_NUM_SEGMENTS)
+// color transitions keep the segment id in 6 bits, _segmentsToRelease has one bit per segment
+#if MAX_NUM_SEGMENTS > 64
+  #error "MAX_NUM_SEGMENTS must not exceed 64"
+#endif
 
-#define MIN_SHOW_DELAY   (_frametime < 16 ? 8 : 15)
+/* With WLED_USE_SEGMENT_DATA_ARENA effect data is taken from a single MAX_SEGMENT_DATA block allocated once.
+  Space freed in the middle is reclaimed by moving the data of the other segments down when needed,
+  so switching effects does not fragment the heap. Default on ESP8266 (-D WLED_DISABLE_SEGMENT_DATA_ARENA to opt out). */
+#if defined(ESP8266) && !defined(WLED_DISABLE_SEGMENT_DATA_ARENA) && !defined(WLED_USE_SEGMENT_DATA_ARENA)
+  #define WLED_USE_SEGMENT_DATA_ARENA
+#endif
+
+/* With WLED_USE_SEGMENT_BUFFERS each active segment renders into its own virtual-length RGBW buffer,
+  which is composited onto the busses once per frame. How many bytes all segment buffers may use combined. */
+#ifndef MAX_SEGMENT_PIXEL_DATA
+  #define MAX_SEGMENT_PIXEL_DATA (MAX_LEDS * 4)
+#endif
+
+/* With segment buffers, an effect change keeps the outgoing effect running in a second buffer for the
+  transition time and crossfades both. Falls back to a hard cut if the second buffer does not fit. */
+#if defined(WLED_USE_SEGMENT_BUFFERS) && !defined(WLED_DISABLE_EFFECT_TRANSITIONS)
+  #define WLED_USE_EFFECT_TRANSITIONS
+#endif
+
+/* Per-segment lookup tables from virtual to physical pixel index, rebuilt only when segment geometry or ledmap change.
+  Cost about 2 bytes per LED, so they are opt-in (-D WLED_USE_SEGMENT_MAPS) on ESP8266. */
+#if !defined(ESP8266) && !defined(WLED_DISABLE_SEGMENT_MAPS) && !defined(WLED_USE_SEGMENT_MAPS)
+  #define WLED_USE_SEGMENT_MAPS
+#endif
+#ifndef MAX_SEGMENT_MAP_DATA
+  #define MAX_SEGMENT_MAP_DATA (MAX_LEDS * 4)
+#endif
+
+/* Each segment keeps its own expanded palette, rebuilt only when palette ID or colors change, so palette
+  transitions also work with multiple segments. Costs about 110 bytes per segment, opt-in (-D WLED_USE_SEGMENT_PALETTES) on ESP8266. */
+#if !defined(ESP8266) && !defined(WLED_DISABLE_SEGMENT_PALETTES) && !defined(WLED_USE_SEGMENT_PALETTES)
+  #define WLED_USE_SEGMENT_PALETTES
+#endif
+
+/* 256 entry color table per segment palette so color_from_palette() is a single lookup in the common case.
+  1kB per segment using a palette, opt-in (-D WLED_USE_PALETTE_LUT) on ESP8266. Requires WLED_USE_SEGMENT_PALETTES. */
+#if !defined(ESP8266) && !defined(WLED_DISABLE_PALETTE_LUT) && !defined(WLED_USE_PALETTE_LUT)
+  #define WLED_USE_PALETTE_LUT
+#endif
+#ifndef WLED_USE_SEGMENT_PALETTES
+  #undef WLED_USE_PALETTE_LUT
+#endif
+#ifndef MAX_PALETTE_LUT_DATA
+  #ifdef ESP8266
+    #define MAX_PALETTE_LUT_DATA 4096
+  #else
+    #define MAX_PALETTE_LUT_DATA 16384
+  #endif
+#endif
+
+/* Once effect calls of one service() pass took this long, further due segments wait for the next pass (once) */
+#ifndef SEGMENT_SERVICE_BUDGET_US
+  #define SEGMENT_SERVICE_BUDGET_US (FRAMETIME * 500U) // half a frame
+#endif
+
+/* With WLED_ENABLE_PARALLEL_RENDER (dual core ESP32) the segments due in a frame are split between service() and a
+  render worker task on the other core, balanced by their measured effect call time, and joined before compositing.
+  Requires segment buffers and segment palettes. Only segments whose buffer and effect state already exist are handed
+  to the worker, effect starts and crossfades always render in service(). */
+#if defined(WLED_ENABLE_PARALLEL_RENDER) && (defined(ESP8266) || defined(CONFIG_FREERTOS_UNICORE) || !defined(WLED_USE_SEGMENT_BUFFERS) \
+    || !defined(WLED_USE_SEGMENT_PALETTES) || defined(WLED_USE_SEGMENT_DATA_ARENA))
+  #undef WLED_ENABLE_PARALLEL_RENDER
+#endif
+
+/* With WLED_ENABLE_ADAPTIVE_QUALITY frames that stay late (the smoothed interval between frames exceeds the frame time
+  of setTargetFps()) lower the quality one step at a time: first housekeeping of the main loop is deferred, then the
+  update rate of the segment with the longest effect call time is halved (twice at most per segment), then effect
+  crossfades are cut. Steps are undone in reverse order once frames were on time for a while. Decisions are logged
+  to /json/info "aq". */
+#ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+  #ifndef QUALITY_INTERVAL_MS
+    #define QUALITY_INTERVAL_MS 500    // between decisions
+  #endif
+  #define QUALITY_MAX_STEPS     24     // housekeeping + crossfades + 2 per segment is enough for 11 segments
+  #define QUALITY_LOG_SIZE      8
+  #define QUALITY_MAX_THROTTLE  2      // a segment is updated at 1/4 of its rate at most
+  #define QUALITY_HOUSEKEEPING  0
+  #define QUALITY_THROTTLE      1
+  #define QUALITY_CROSSFADE     2
+  #define QUALITY_HOUSEKEEPING_MS 2000 // deferred housekeeping still runs this often
+#endif
+/* With WLED_ENABLE_FRAME_TIMER an esp_timer ticks every 1/target FPS. The render task sends the frame it rendered
+  ahead on each tick and then renders the next one, so frames leave at exact intervals however long rendering took.
+  A segment is due on the tick closest to its next call. */
+#ifdef WLED_ENABLE_FRAME_TIMER
+  #include <esp_timer.h>
+#endif
+
+#if defined(WLED_ENABLE_PARALLEL_RENDER) || defined(WLED_ENABLE_ADAPTIVE_QUALITY)
+  #define WLED_TRACK_RENDER_TIME
+#endif
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+  #ifndef WLED_PARALLEL_RENDER_STACK
+    #define WLED_PARALLEL_RENDER_STACK 6144
+  #endif
+  #define RENDER_CONTEXTS 2
+  #define RCTX _rc[xPortGetCoreID() == fxWorkerCore] // the worker renders with its own context
+  extern uint8_t fxWorkerCore; // core of the render worker task, 0xFF before it is started
+  // guards the memory counters, effects on both cores may allocate
+  extern portMUX_TYPE fxAllocMux;
+  #define SEGMENT_ALLOC_LOCK()   portENTER_CRITICAL(&fxAllocMux)
+  #define SEGMENT_ALLOC_UNLOCK() portEXIT_CRITICAL(&fxAllocMux)
+
+  // FastLED keeps a single random8()/random16() state, the worker core gets its own so per-segment streams stay reproducible
+  extern uint16_t fxWorkerRandSeed;
+  inline uint16_t& fxRandSeed() { return xPortGetCoreID() == fxWorkerCore ? fxWorkerRandSeed : rand16seed; }
+  inline uint16_t fxRandom16() {
+    uint16_t& seed = fxRandSeed();
+    seed = (seed * FASTLED_RAND16_2053) + FASTLED_RAND16_13849;
+    return seed;
+  }
+  inline uint16_t fxRandom16(uint16_t lim) { return ((uint32_t)fxRandom16() * lim) >> 16; }
+  inline uint16_t fxRandom16(uint16_t min, uint16_t lim) { return fxRandom16(lim - min) + min; }
+  inline uint8_t fxRandom8() { uint16_t r = fxRandom16(); return (uint8_t)(r & 0xFF) + (uint8_t)(r >> 8); }
+  inline uint8_t fxRandom8(uint8_t lim) { return (fxRandom8() * lim) >> 8; }
+  inline uint8_t fxRandom8(uint8_t min, uint8_t lim) { return fxRandom8(lim - min) + min; }
+  inline uint16_t fxRandom16GetSeed() { return fxRandSeed(); }
+  inline void fxRandom16SetSeed(uint16_t seed) { fxRandSeed() = seed; }
+  #define random8           fxRandom8
+  #define random16          fxRandom16
+  #define random16_get_seed fxRandom16GetSeed
+  #define random16_set_seed fxRandom16SetSeed
+#else
+  #define RENDER_CONTEXTS 1
+  #define RCTX _rc[0]
+  #define SEGMENT_ALLOC_LOCK()
+  #define SEGMENT_ALLOC_UNLOCK()
+#endif
 
 #define NUM_COLORS       3 /* number of colors per segment */
-#define SEGMENT          _segments[_segment_index]
-#define SEGCOLOR(x)      _colors_t[x]
-#define SEGENV           _segment_runtimes[_segment_index]
-#define SEGLEN           _virtualSegmentLength
+#define SEGMENT          _segments[RCTX.segIndex]
+#define SEGCOLOR(x)      RCTX.colors[x]
+#define SEGENV           _segment_runtimes[RCTX.segIndex]
+#define SEGLEN           RCTX.vLength
 #define SEGACT           SEGMENT.stop
 #define SPEED_FORMULA_L  5U + (50U*(255U - SEGMENT.speed))/SEGLEN
 
@@ -119,7 +253,15 @@
 #define IS_REVERSE      ((SEGMENT.options & REVERSE     ) == REVERSE     )
 #define IS_SELECTED     ((SEGMENT.options & SELECTED    ) == SELECTED    )
 
-#define MODE_COUNT  118
+// 2D layout (Segment::layout2D), only used if the segment has a width
+// bits 0-1: clockwise rotation of the effect in quarter turns
+// bit    2: serpentine, every other row (or column) runs backwards
+// bit    3: wired by columns instead of rows
+#define SEG2D_ROTATION   (uint8_t)0x03
+#define SEG2D_SERPENTINE (uint8_t)0x04
+#define SEG2D_VERTICAL   (uint8_t)0x08
+
+#define MODE_COUNT  119
 
 #define FX_MODE_STATIC                   0
 #define FX_MODE_BLINK                    1
@@ -239,11 +381,60 @@
 #define FX_MODE_BLENDS                 115
 #define FX_MODE_TV_SIMULATOR           116
 #define FX_MODE_DYNAMIC_SMOOTH         117
+#define FX_MODE_PLAYBACK               118
+
+#define ANIM_HEADER 16 // header of the /anim<n>.wla files of FX_MODE_PLAYBACK, see mode_playback()
+
+/*
+ * Effect subset for single purpose builds: with -D WLED_FX_SUBSET=FX_MODE_RAINBOW,FX_MODE_FIRE_2012 (or a header
+ * defining it and WLED_PALETTE_SUBSET, given as -D WLED_FX_CONFIG=\"my_fx.h\") only the listed effects and Solid are registered in _mode[].
+ * The other effect functions are no longer referenced and dropped by the linker, along with the helpers only they use.
+ * Effect IDs stay the same, the missing ones run Solid and are named "RSVD" in /json/eff.
+ */
+#ifdef WLED_FX_CONFIG
+  #include WLED_FX_CONFIG
+#endif
+#ifdef WLED_FX_SUBSET
+constexpr uint8_t fxSubset[] = { FX_MODE_STATIC, WLED_FX_SUBSET };
+constexpr bool fxIncluded(uint8_t m, uint8_t i = 0) {
+  return i < sizeof(fxSubset) && (fxSubset[i] == m || fxIncluded(m, i + 1));
+}
+#else
+constexpr bool fxIncluded(uint8_t m) { return m < MODE_COUNT; }
+#endif
+// the condition is a constant, so excluded effects are not referenced at all
+#define FX_ADD(id, fn) _mode[id] = fxIncluded(id) ? &WS2812FX::fn : &WS2812FX::mode_static
+
+// the same for gradient palettes (IDs 13 and up) with WLED_PALETTE_SUBSET, left out ones show the default palette
+#ifdef WLED_PALETTE_SUBSET
+constexpr uint8_t palSubset[] = { WLED_PALETTE_SUBSET };
+constexpr bool palIncluded(uint8_t p, uint8_t i = 0) {
+  return p < 13 || (i < sizeof(palSubset) && (palSubset[i] == p || palIncluded(p, i + 1)));
+}
+#else
+constexpr bool palIncluded(uint8_t) { return true; }
+#endif
+#define PAL_ADD(id, gp) (palIncluded(id) ? gp : nullptr)
+
+// effect capability flags, see JSON_mode_meta[]
+#define FX_USES_PALETTE   0x01 // colors come from the segment palette (color_from_palette(), color_wheel(), currentPalette)
+#define FX_NEEDS_READBACK 0x02 // reads back previously rendered pixels (getPixelColor(), fade_out(), blur() ...)
+#define FX_IS_STATIC      0x04 // output only changes with segment settings
+#define FX_DATA_FIXED     0x08 // allocates segment data independent of segment length
+#define FX_DATA_PER_PIXEL 0x10 // allocates segment data growing with segment length
+
+typedef struct EffectMeta {
+  uint8_t flags; // FX_* capability flags
+  uint8_t cost;  // relative cost per pixel, 1 (plain fill) to 4 (several noise/wave evaluations per pixel)
+} effect_meta;
 
 
 class WS2812FX {
   typedef uint16_t (WS2812FX::*mode_ptr)(void);
 
+  // writes virtual pixel i of the current segment, selected per segment by selectPixelWriter()
+  typedef void (WS2812FX::*pixel_writer)(uint16_t i, uint32_t col);
+
   // pre show callback
   typedef void (*show_callback) (void);
 
@@ -251,9 +442,9 @@ class WS2812FX {
   
   // segment parameters
   public:
-    typedef struct Segment { // 31 (32 in memory) bytes
-      uint16_t start;
-      uint16_t stop; //segment invalid if stop == 0
+    typedef struct Segment { // 38 (40 in memory) bytes
+      pixidx_t start;
+      pixidx_t stop; //segment invalid if stop == 0, at most 65535 LEDs after start
       uint16_t offset;
       uint8_t  speed;
       uint8_t  intensity;
@@ -265,14 +456,35 @@ class WS2812FX {
       uint32_t colors[NUM_COLORS];
       uint8_t  cct; //0==1900K, 255==10091K
       uint8_t  _capabilities;
+      uint8_t  fps; //target frame rate of this segment, 0: strip target FPS
+      uint8_t  layout2D; //SEG2D_* bits
+      uint8_t  renderScale; //effects render 1 of (1 << renderScale) pixels, interpolated on composing (1D with segment buffer)
+      uint8_t  layer; //z-order, higher layers are composed over lower ones, segment ID within a layer
+      uint8_t  blendMode; //SEG_BLEND_*, how the segment is composed onto the layers below (with segment buffer)
+      uint8_t  live; //shows realtime data instead of its effect while realtime mode is active, see setRealtimePixels()
+      uint8_t  link; //ID + 1 of the segment whose effect continues over this one (with segment maps), 0: runs its own effect
+      uint8_t  instanceOf; //ID + 1 of the segment whose rendered pixels this one shows (with segment buffers), 0: runs its own effect
+      uint16_t width; //columns of a matrix as wired (in virtual pixels), 0: 1D segment
       char *name;
+      // change tracking: the setters (and WS2812FX::setMode(), setSegment()...) set the SEG_DIFFERS_* bits of
+      // what they changed in `changed`, which a caller clears to see what it changed, and count up `gen`,
+      // so usermods and caches can tell a segment changed without keeping a copy of it
+      uint8_t  changed;
+      uint16_t gen;
+      void touch(uint8_t what) {
+        changed |= what; gen++;
+        instance->_segmentsGen++;
+      }
       bool setColor(uint8_t slot, uint32_t c, uint8_t segn) { //returns true if changed
         if (slot >= NUM_COLORS || segn >= MAX_NUM_SEGMENTS) return false;
         if (c == colors[slot]) return false;
         uint8_t b = (slot == 1) ? cct : opacity;
         ColorTransition::startTransition(b, colors[slot], instance->_transitionDur, segn, slot);
-        colors[slot] = c; return true;
+        colors[slot] = c; touch(SEG_DIFFERS_COL); return true;
       }
+      bool setSpeed(uint8_t v)     { if (speed == v)     return false; speed = v;     touch(SEG_DIFFERS_FX); return true; }
+      bool setIntensity(uint8_t v) { if (intensity == v) return false; intensity = v; touch(SEG_DIFFERS_FX); return true; }
+      bool setPalette(uint8_t v)   { if (palette == v)   return false; palette = v;   touch(SEG_DIFFERS_FX); return true; }
       void setCCT(uint16_t k, uint8_t segn) {
         if (segn >= MAX_NUM_SEGMENTS) return;
         if (k > 255) { //kelvin value, convert to 0-255
@@ -283,15 +495,18 @@ class WS2812FX {
         if (cct == k) return;
         ColorTransition::startTransition(cct, colors[1], instance->_transitionDur, segn, 1);
         cct = k;
+        touch(SEG_DIFFERS_COL);
       }
       void setOpacity(uint8_t o, uint8_t segn) {
         if (segn >= MAX_NUM_SEGMENTS) return;
         if (opacity == o) return;
         ColorTransition::startTransition(opacity, colors[0], instance->_transitionDur, segn, 0);
         opacity = o;
+        touch(SEG_DIFFERS_BRI);
       }
       void setOption(uint8_t n, bool val, uint8_t segn = 255)
       {
+        uint8_t prevOptions = options;
         bool prevOn = false;
         if (n == SEG_OPTION_ON) {
           prevOn = getOption(SEG_OPTION_ON);
@@ -310,6 +525,9 @@ class WS2812FX {
         if (n == SEG_OPTION_ON && val && !prevOn) { //fade on
           ColorTransition::startTransition(0, colors[0], instance->_transitionDur, segn, 0);
         }
+        uint8_t diff = prevOptions ^ options;
+        if (diff & 0x01)       touch(SEG_DIFFERS_SEL);
+        if (diff & 0b00101110) touch(SEG_DIFFERS_OPT);
       }
       bool getOption(uint8_t n)
       {
@@ -337,44 +555,283 @@ class WS2812FX {
         uint16_t vLength = (length() + groupLen - 1) / groupLen;
         if (options & MIRROR)
           vLength = (vLength + 1) /2;  // divide by 2 if mirror, leave at least a single LED
+        if (width && width <= vLength) vLength -= vLength % width; // whole rows only
         return vLength;
       }
-      uint8_t differs(Segment& b);
+      inline bool is2D() { return width > 1 && width < virtualLength(); }
+      // pixels the effect renders, the virtual pixels in between are interpolated by composeSegments()
+      uint16_t renderLength() {
+        uint16_t vLen = virtualLength();
+        #ifdef WLED_USE_SEGMENT_BUFFERS
+        if (renderScale && vLen > 1 && !is2D()) return ((vLen - 1) >> renderScale) + 1;
+        #endif
+        return vLen;
+      }
+      // width and height of the matrix as effects see it, after rotation
+      uint16_t virtualWidth() {
+        if (!is2D()) return virtualLength();
+        return (layout2D & 0x01) ? virtualLength() / width : width;
+      }
+      uint16_t virtualHeight() {
+        if (!is2D()) return 1;
+        return (layout2D & 0x01) ? width : virtualLength() / width;
+      }
+      // virtual pixel along the wiring for pixel i = y * virtualWidth() + x of the effect
+      uint16_t map2D(uint16_t i) {
+        if (!width) return i;
+        uint16_t vLen = virtualLength();
+        if (width < 2 || width >= vLen || i >= vLen) return i; // single row, or past the last row
+        uint16_t w = width, h = vLen / width;
+        uint16_t vW = (layout2D & 0x01) ? h : w;
+        uint16_t x = i % vW, y = i / vW;
+        uint16_t col, row;
+        switch (layout2D & SEG2D_ROTATION) {
+          case 0: col = x;         row = y;         break;
+          case 1: col = w - 1 - y; row = x;         break;
+          case 2: col = w - 1 - x; row = h - 1 - y; break;
+          default: col = y;        row = h - 1 - x; break;
+        }
+        if (layout2D & SEG2D_VERTICAL) {
+          if ((layout2D & SEG2D_SERPENTINE) && (col & 0x01)) row = h - 1 - row;
+          return col * h + row;
+        }
+        if ((layout2D & SEG2D_SERPENTINE) && (row & 0x01)) col = w - 1 - col;
+        return row * w + col;
+      }
       inline uint8_t getLightCapabilities() {return _capabilities;}
       void refreshLightCapabilities();
     } segment;
 
   // segment runtime parameters
-    typedef struct Segment_runtime { // 28 bytes
+    typedef struct Segment_runtime { // 32 bytes
       unsigned long next_time;  // millis() of next update
       uint32_t step;  // custom "step" var
       uint32_t call;  // call counter
+      uint32_t lastCall = 0; // strip.now of the previous effect call
+      uint32_t elapsed = 0;  // effect time in ms including the current call, see WS2812FX::frameStep()
       uint16_t aux0;  // custom var
       uint16_t aux1;  // custom var
+      uint16_t rand16 = 0;      // random8()/random16() state while the effect runs, seeded each frame by seedRandom()
+      uint16_t missedFrames = 0; // times the effect ran more than one frame late
+      bool deferred = false;     // effect call was postponed to the next service() pass
+      #ifdef WLED_TRACK_RENDER_TIME
+      uint16_t renderUs = 0;     // effect call time in µs, smoothed, balances segments between the render cores
+      #endif
+      #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+      uint8_t throttle = 0;      // effect called at most every segment frame time << throttle
+      #endif
       byte* data = nullptr;
       bool allocateData(uint16_t len){
         if (data && _dataLen == len) return true; //already allocated
         deallocateData();
-        if (WS2812FX::instance->_usedSegmentData + len > MAX_SEGMENT_DATA) return false; //not enough memory
-        // if possible use SPI RAM on ESP32
-        #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
-        if (psramFound())
-          data = (byte*) ps_malloc(len);
-        else
+        if (WS2812FX::instance->_usedSegmentData + len > WS2812FX::instance->_maxSegmentData) { memAllocFailed(MEM_SEGMENTS); return false; } //not enough memory
+        #ifdef WLED_USE_SEGMENT_DATA_ARENA
+        data = WS2812FX::instance->allocateArenaData(len);
+        #else
+        data = (byte*) wledAlloc(len, ALLOC_COLD);
         #endif
-          data = (byte*) malloc(len);
-        if (!data) return false; //allocation failed
+        if (!data) { memAllocFailed(MEM_SEGMENTS); return false; } //allocation failed
+        SEGMENT_ALLOC_LOCK();
         WS2812FX::instance->_usedSegmentData += len;
+        SEGMENT_ALLOC_UNLOCK();
         _dataLen = len;
         memset(data, 0, len);
         return true;
       }
       void deallocateData(){
+        #ifdef WLED_USE_SEGMENT_DATA_ARENA
+        WS2812FX::instance->freeArenaData(data, _dataLen);
+        #else
         free(data);
+        #endif
         data = nullptr;
+        SEGMENT_ALLOC_LOCK();
         WS2812FX::instance->_usedSegmentData -= _dataLen;
+        SEGMENT_ALLOC_UNLOCK();
         _dataLen = 0;
       }
+      inline uint16_t dataSize() { return _dataLen; }
+
+      // advances the effect time to t (strip.now) before each effect call, returns the ms since the previous call
+      uint16_t advanceTime(uint32_t t) {
+        uint32_t d = FRAMETIME_FIXED;
+        if (!call) elapsed = 0;
+        else d = MIN(t - lastCall, FX_MAX_DELTA_MS);
+        lastCall = t;
+        elapsed += d;
+        return d;
+      }
+
+      #ifdef WLED_USE_SEGMENT_BUFFERS
+      uint32_t* pixels = nullptr; // render buffer (virtual length), composited onto the busses before show()
+      bool pixelsChanged = false; // buffer was written since the last compositing pass
+      int16_t pixelsCCT = -1;     // bus CCT the buffer was rendered with, re-applied when compositing (-1: none)
+      uint16_t pixelsStart = 0;   // buffer index of virtual pixel 0, scroll() rotates it instead of moving the pixels
+      bool allocatePixels(uint16_t len){
+        if (pixels && _pixelsLen == len) return true; //already allocated
+        deallocatePixels();
+        if (len == 0) return false;
+        uint32_t bytes = len * sizeof(uint32_t);
+        if (WS2812FX::instance->_usedSegmentPixels + bytes > MAX_SEGMENT_PIXEL_DATA) return false; //not enough memory, render directly
+        pixels = (uint32_t*) wledAlloc(bytes, ALLOC_HOT); // composited every frame
+        if (!pixels) { memAllocFailed(MEM_SEGMENTS); return false; } //allocation failed
+        WS2812FX::instance->_usedSegmentPixels += bytes;
+        _pixelsLen = len;
+        memset(pixels, 0, bytes);
+        pixelsChanged = false;
+        pixelsStart = 0;
+        return true;
+      }
+      void deallocatePixels(){
+        if (!pixels) return;
+        free(pixels);
+        pixels = nullptr;
+        WS2812FX::instance->_usedSegmentPixels -= _pixelsLen * sizeof(uint32_t);
+        _pixelsLen = 0;
+      }
+      inline uint16_t pixelsLength() { return _pixelsLen; }
+      // buffer index of virtual pixel i < pixelsLength()
+      inline uint16_t pixelIndex(uint16_t i) {
+        uint32_t j = i + pixelsStart;
+        return (j >= _pixelsLen) ? j - _pixelsLen : j;
+      }
+      // moves the pixels so virtual pixel 0 is at index 0 again, for code walking the buffer in order
+      void unrotatePixels() {
+        if (!pixelsStart) return;
+        std::rotate(pixels, pixels + pixelsStart, pixels + _pixelsLen);
+        pixelsStart = 0;
+      }
+      #endif
+
+      #ifdef WLED_USE_EFFECT_TRANSITIONS
+      typedef struct EffectTransition { // state of the outgoing effect
+        unsigned long next_time;
+        uint32_t step, call;
+        uint32_t lastCall, elapsed;
+        uint16_t aux0, aux1;
+        byte* data;
+        uint16_t dataLen;
+        uint32_t* pixels;
+        uint16_t pixelsLen;
+        uint16_t pixelsStart;
+        uint32_t start;
+        uint16_t duration;
+        uint8_t mode;
+      } effect_transition;
+      effect_transition* fxTransition = nullptr;
+      // hands the running effect's state and buffer over to fxTransition, the new effect starts from scratch
+      bool startEffectTransition(uint8_t oldMode, uint16_t dur) {
+        if (!pixels || dur == 0 || _requiresReset) return false; // nothing rendered yet, keep the running transition
+        endEffectTransition();
+        if (WS2812FX::instance->_usedSegmentPixels + _pixelsLen * sizeof(uint32_t) > MAX_SEGMENT_PIXEL_DATA) return false; //no room for a second buffer
+        fxTransition = (effect_transition*) malloc(sizeof(effect_transition));
+        if (!fxTransition) return false;
+        fxTransition->mode = oldMode;
+        fxTransition->start = WS2812FX::instance->uptimeMs();
+        fxTransition->duration = dur;
+        fxTransition->data = nullptr; fxTransition->dataLen = 0;
+        fxTransition->pixels = nullptr; fxTransition->pixelsLen = 0; fxTransition->pixelsStart = 0;
+        swapEffectState();
+        return true;
+      }
+      void endEffectTransition() {
+        if (!fxTransition) return;
+        swapEffectState();
+        deallocateData();
+        deallocatePixels();
+        swapEffectState();
+        free(fxTransition);
+        fxTransition = nullptr;
+      }
+      // exchanges the running and the outgoing effect, used to render the outgoing one
+      void swapEffectState() {
+        effect_transition &t = *fxTransition;
+        std::swap(next_time, t.next_time); std::swap(step, t.step); std::swap(call, t.call);
+        std::swap(lastCall, t.lastCall); std::swap(elapsed, t.elapsed);
+        std::swap(aux0, t.aux0); std::swap(aux1, t.aux1);
+        std::swap(data, t.data); std::swap(_dataLen, t.dataLen);
+        std::swap(pixels, t.pixels); std::swap(_pixelsLen, t.pixelsLen); std::swap(pixelsStart, t.pixelsStart);
+      }
+      #endif
+
+      #ifdef WLED_USE_SEGMENT_MAPS
+      pixidx_t* map = nullptr; // physical pixel index for each virtual pixel, mapStride() entries each (PIXIDX_NONE: not set)
+      bool mapMatches(Segment& seg, uint32_t ledmapVersion) {
+        return _mapStart == seg.start && _mapStop == seg.stop && _mapOffset == seg.offset
+            && _mapGrouping == seg.grouping && _mapSpacing == seg.spacing
+            && _mapOptions == (seg.options & (REVERSE | MIRROR)) && _mapLedmap == ledmapVersion
+            && _mapWidth == seg.width && _mapLayout == seg.layout2D;
+      }
+      void setMapKey(Segment& seg, uint32_t ledmapVersion) {
+        _mapStart = seg.start; _mapStop = seg.stop; _mapOffset = seg.offset;
+        _mapGrouping = seg.grouping; _mapSpacing = seg.spacing;
+        _mapOptions = seg.options & (REVERSE | MIRROR); _mapLedmap = ledmapVersion;
+        _mapWidth = seg.width; _mapLayout = seg.layout2D;
+      }
+      bool allocateMap(Segment& seg, uint32_t ledmapVersion, uint16_t vLen, uint16_t stride) {
+        deallocateMap();
+        setMapKey(seg, ledmapVersion); // remember geometry even if allocation fails, so it is not retried every frame
+        uint32_t bytes = (uint32_t)vLen * stride * sizeof(pixidx_t);
+        if (bytes == 0 || WS2812FX::instance->_usedSegmentMapData + bytes > MAX_SEGMENT_MAP_DATA) return false;
+        map = (pixidx_t*) wledAlloc(bytes, ALLOC_HOT); // read for every pixel
+        if (!map) { memAllocFailed(MEM_SEGMENTS); return false; }
+        WS2812FX::instance->_usedSegmentMapData += bytes;
+        _mapVLen = vLen; _mapStride = stride;
+        return true;
+      }
+      void deallocateMap() {
+        _mapStop = 0; //invalidate geometry
+        if (!map) return;
+        free(map);
+        map = nullptr;
+        WS2812FX::instance->_usedSegmentMapData -= (uint32_t)_mapVLen * _mapStride * sizeof(pixidx_t);
+        _mapVLen = _mapStride = 0;
+      }
+      inline void invalidateMap() { _mapStop = 0; } // rebuilt before the next effect call, e.g. when linked segments change
+      inline uint16_t mapLength() { return _mapVLen; }
+      inline uint16_t mapStride() { return _mapStride; }
+      #endif
+
+      #ifdef WLED_USE_SEGMENT_PALETTES
+      CRGBPalette16 palette;          // palette used by the effect, blends toward targetPalette if paletteFade is set
+      CRGBPalette16 targetPalette;    // expanded palette, only rebuilt if paletteMatches() fails
+      uint32_t lastPaletteChange = 0; // millis() of last change of random palette (1)
+      bool paletteMatches(uint8_t id, const uint32_t* colors) {
+        if (_paletteId != id) return false;
+        return id < 2 || id > 5 || !memcmp(_paletteColors, colors, sizeof(_paletteColors)); // only 2-5 are built from colors
+      }
+      void setPaletteKey(uint8_t id, const uint32_t* colors) {
+        _paletteId = id;
+        memcpy(_paletteColors, colors, sizeof(_paletteColors));
+      }
+      inline void invalidatePalette() { _paletteId = UINT8_MAX; }
+      #endif
+
+      #ifdef WLED_USE_PALETTE_LUT
+      uint32_t* paletteLUT = nullptr; // palette expanded to 256 colors (full brightness), valid if paletteLUTValid
+      bool paletteLUTValid = false;
+      bool paletteLUTNoBlend = false; // built with NOBLEND
+      bool allocatePaletteLUT() {
+        if (paletteLUT) return true;
+        if (WS2812FX::instance->_usedPaletteLUTData + 256 * sizeof(uint32_t) > MAX_PALETTE_LUT_DATA) return false;
+        paletteLUT = (uint32_t*) malloc(256 * sizeof(uint32_t));
+        if (!paletteLUT) return false;
+        SEGMENT_ALLOC_LOCK();
+        WS2812FX::instance->_usedPaletteLUTData += 256 * sizeof(uint32_t);
+        SEGMENT_ALLOC_UNLOCK();
+        paletteLUTValid = false;
+        return true;
+      }
+      void deallocatePaletteLUT() {
+        paletteLUTValid = false;
+        if (!paletteLUT) return;
+        free(paletteLUT);
+        paletteLUT = nullptr;
+        SEGMENT_ALLOC_LOCK();
+        WS2812FX::instance->_usedPaletteLUTData -= 256 * sizeof(uint32_t);
+        SEGMENT_ALLOC_UNLOCK();
+      }
+      #endif
 
       /** 
        * If reset of this segment was request, clears runtime
@@ -385,8 +842,11 @@ class WS2812FX {
        */
       void resetIfRequired() {
         if (_requiresReset) {
-          next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0; 
+          next_time = 0; step = 0; call = 0; aux0 = 0; aux1 = 0; lastCall = 0; elapsed = 0;
           deallocateData();
+          #ifdef WLED_USE_SEGMENT_PALETTES
+          invalidatePalette();
+          #endif
           _requiresReset = false;
         }
       }
@@ -398,47 +858,57 @@ class WS2812FX {
        * Safe to call from interrupts and network requests.
        */
       inline void markForReset() { _requiresReset = true; }
+      inline bool resetRequired() { return _requiresReset; }
+
+      /**
+       * Seeds the random numbers of the next effect call from the effect seed, segment id and frame number
+       * of the effect clock, so nodes sharing strip.now and effectSeed draw the same numbers.
+       */
+      void seedRandom(uint16_t seed, uint8_t id, uint32_t frame) {
+        uint32_t h = frame * 2654435761UL ^ (uint32_t(seed) << 8 | id); // murmur3 finalizer
+        h ^= h >> 16; h *= 0x85ebca6bUL;
+        h ^= h >> 13; h *= 0xc2b2ae35UL;
+        h ^= h >> 16;
+        rand16 = h ^ (h >> 16);
+      }
       private:
         uint16_t _dataLen = 0;
+        #ifdef WLED_USE_SEGMENT_BUFFERS
+        uint16_t _pixelsLen = 0;
+        #endif
+        #ifdef WLED_USE_SEGMENT_MAPS
+        uint16_t _mapVLen = 0, _mapStride = 0;
+        pixidx_t _mapStart = 0, _mapStop = 0;
+        uint16_t _mapOffset = 0;
+        uint8_t  _mapGrouping = 0, _mapSpacing = 0, _mapOptions = 0;
+        uint32_t _mapLedmap = 0;
+        uint16_t _mapWidth = 0;
+        uint8_t  _mapLayout = 0;
+        #endif
+        #ifdef WLED_USE_SEGMENT_PALETTES
+        uint8_t  _paletteId = UINT8_MAX;
+        uint32_t _paletteColors[NUM_COLORS] = {0};
+        #endif
         bool _requiresReset = false;
     } segment_runtime;
 
-    typedef struct ColorTransition { // 12 bytes
+    typedef struct ColorTransition { // 12 bytes, one per color slot of a segment
       uint32_t colorOld = 0;
       uint32_t transitionStart;
       uint16_t transitionDur;
       uint8_t segment = 0xFF; //lower 6 bits: the segment this transition is for (255 indicates transition not in use/available) upper 2 bits: color channel
       uint8_t briOld = 0;
+      //continues a running transition of the slot, otherwise starts from oldBri and oldCol
       static void startTransition(uint8_t oldBri, uint32_t oldCol, uint16_t dur, uint8_t segn, uint8_t slot) {
         if (segn >= MAX_NUM_SEGMENTS || slot >= NUM_COLORS || dur == 0) return;
         if (instance->_brightness == 0) return; //do not need transitions if master bri is off
         if (!instance->_segments[segn].getOption(SEG_OPTION_ON)) return; //not if segment is off either
-        uint8_t tIndex = 0xFF; //none found
-        uint16_t tProgression = 0;
+        ColorTransition*& ts = instance->_transitions[segn];
+        if (!ts) ts = new (std::nothrow) ColorTransition[NUM_COLORS];
+        if (!ts) return; //without memory the change is immediate
         uint8_t s = segn + (slot << 6); //merge slot and segment into one byte
 
-        for (uint8_t i = 0; i < MAX_NUM_TRANSITIONS; i++) {
-          uint8_t tSeg = instance->transitions[i].segment;
-          //see if this segment + color already has a running transition
-          if (tSeg == s) {
-            tIndex = i; break;
-          }
-          if (tSeg == 0xFF) { //free transition
-            tIndex = i; tProgression = 0xFFFF;
-          }
-        }
-
-        if (tIndex == 0xFF) { //no slot found yet
-          for (uint8_t i = 0; i < MAX_NUM_TRANSITIONS; i++) {
-            //find most progressed transition to overwrite
-            uint16_t prog = instance->transitions[i].progress();
-            if (prog > tProgression) {
-              tIndex = i; tProgression = prog;
-            }
-          }
-        }
-
-        ColorTransition& t = instance->transitions[tIndex];
+        ColorTransition& t = ts[slot];
         if (t.segment == s) //this is an active transition on the same segment+color
         {
           bool wasTurningOff = (oldBri == 0);
@@ -447,24 +917,19 @@ class WS2812FX {
         } else {
           t.briOld = oldBri;
           t.colorOld = oldCol;
-          uint8_t prevSeg = t.segment & 0x3F;
-          if (prevSeg < MAX_NUM_SEGMENTS) instance->_segments[prevSeg].setOption(SEG_OPTION_TRANSITIONAL, false);
         }
         t.transitionDur = dur;
-        t.transitionStart = millis();
+        t.transitionStart = instance->uptimeMs();
         t.segment = s;
         instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, true);
         //refresh immediately, required for Solid mode
         if (instance->_segment_runtimes[segn].next_time > t.transitionStart + 22) instance->_segment_runtimes[segn].next_time = t.transitionStart;
       }
       uint16_t progress(bool allowEnd = false) { //transition progression between 0-65535
-        uint32_t timeNow = millis();
+        uint32_t timeNow = instance->uptimeMs();
+        if ((int32_t)(timeNow - transitionStart) < 0) return 0; // started by a network callback during this frame
         if (timeNow - transitionStart > transitionDur) {
-          if (allowEnd) {
-            uint8_t segn = segment & 0x3F;
-            if (segn < MAX_NUM_SEGMENTS) instance->_segments[segn].setOption(SEG_OPTION_TRANSITIONAL, false);
-            segment = 0xFF;
-          }
+          if (allowEnd) segment = 0xFF; //the segment stays transitional until all its slots ended, see renderSegment()
           return 0xFFFF;
         }
         uint32_t elapsed = timeNow - transitionStart;
@@ -490,129 +955,132 @@ class WS2812FX {
 
     WS2812FX() {
       WS2812FX::instance = this;
-      //assign each member of the _mode[] array to its respective function reference 
-      _mode[FX_MODE_STATIC]                  = &WS2812FX::mode_static;
-      _mode[FX_MODE_BLINK]                   = &WS2812FX::mode_blink;
-      _mode[FX_MODE_COLOR_WIPE]              = &WS2812FX::mode_color_wipe;
-      _mode[FX_MODE_COLOR_WIPE_RANDOM]       = &WS2812FX::mode_color_wipe_random;
-      _mode[FX_MODE_RANDOM_COLOR]            = &WS2812FX::mode_random_color;
-      _mode[FX_MODE_COLOR_SWEEP]             = &WS2812FX::mode_color_sweep;
-      _mode[FX_MODE_DYNAMIC]                 = &WS2812FX::mode_dynamic;
-      _mode[FX_MODE_RAINBOW]                 = &WS2812FX::mode_rainbow;
-      _mode[FX_MODE_RAINBOW_CYCLE]           = &WS2812FX::mode_rainbow_cycle;
-      _mode[FX_MODE_SCAN]                    = &WS2812FX::mode_scan;
-      _mode[FX_MODE_DUAL_SCAN]               = &WS2812FX::mode_dual_scan;
-      _mode[FX_MODE_FADE]                    = &WS2812FX::mode_fade;
-      _mode[FX_MODE_THEATER_CHASE]           = &WS2812FX::mode_theater_chase;
-      _mode[FX_MODE_THEATER_CHASE_RAINBOW]   = &WS2812FX::mode_theater_chase_rainbow;
-      _mode[FX_MODE_SAW]                     = &WS2812FX::mode_saw;
-      _mode[FX_MODE_TWINKLE]                 = &WS2812FX::mode_twinkle;
-      _mode[FX_MODE_DISSOLVE]                = &WS2812FX::mode_dissolve;
-      _mode[FX_MODE_DISSOLVE_RANDOM]         = &WS2812FX::mode_dissolve_random;
-      _mode[FX_MODE_SPARKLE]                 = &WS2812FX::mode_sparkle;
-      _mode[FX_MODE_FLASH_SPARKLE]           = &WS2812FX::mode_flash_sparkle;
-      _mode[FX_MODE_HYPER_SPARKLE]           = &WS2812FX::mode_hyper_sparkle;
-      _mode[FX_MODE_STROBE]                  = &WS2812FX::mode_strobe;
-      _mode[FX_MODE_STROBE_RAINBOW]          = &WS2812FX::mode_strobe_rainbow;
-      _mode[FX_MODE_MULTI_STROBE]            = &WS2812FX::mode_multi_strobe;
-      _mode[FX_MODE_BLINK_RAINBOW]           = &WS2812FX::mode_blink_rainbow;
-      _mode[FX_MODE_ANDROID]                 = &WS2812FX::mode_android;
-      _mode[FX_MODE_CHASE_COLOR]             = &WS2812FX::mode_chase_color;
-      _mode[FX_MODE_CHASE_RANDOM]            = &WS2812FX::mode_chase_random;
-      _mode[FX_MODE_CHASE_RAINBOW]           = &WS2812FX::mode_chase_rainbow;
-      _mode[FX_MODE_CHASE_FLASH]             = &WS2812FX::mode_chase_flash;
-      _mode[FX_MODE_CHASE_FLASH_RANDOM]      = &WS2812FX::mode_chase_flash_random;
-      _mode[FX_MODE_CHASE_RAINBOW_WHITE]     = &WS2812FX::mode_chase_rainbow_white;
-      _mode[FX_MODE_COLORFUL]                = &WS2812FX::mode_colorful;
-      _mode[FX_MODE_TRAFFIC_LIGHT]           = &WS2812FX::mode_traffic_light;
-      _mode[FX_MODE_COLOR_SWEEP_RANDOM]      = &WS2812FX::mode_color_sweep_random;
-      _mode[FX_MODE_RUNNING_COLOR]           = &WS2812FX::mode_running_color;
-      _mode[FX_MODE_AURORA]                  = &WS2812FX::mode_aurora;
-      _mode[FX_MODE_RUNNING_RANDOM]          = &WS2812FX::mode_running_random;
-      _mode[FX_MODE_LARSON_SCANNER]          = &WS2812FX::mode_larson_scanner;
-      _mode[FX_MODE_COMET]                   = &WS2812FX::mode_comet;
-      _mode[FX_MODE_FIREWORKS]               = &WS2812FX::mode_fireworks;
-      _mode[FX_MODE_RAIN]                    = &WS2812FX::mode_rain;
-      _mode[FX_MODE_TETRIX]                  = &WS2812FX::mode_tetrix;
-      _mode[FX_MODE_FIRE_FLICKER]            = &WS2812FX::mode_fire_flicker;
-      _mode[FX_MODE_GRADIENT]                = &WS2812FX::mode_gradient;
-      _mode[FX_MODE_LOADING]                 = &WS2812FX::mode_loading;
-      _mode[FX_MODE_POLICE]                  = &WS2812FX::mode_police;
-      _mode[FX_MODE_FAIRY]                   = &WS2812FX::mode_fairy;
-      _mode[FX_MODE_TWO_DOTS]                = &WS2812FX::mode_two_dots;
-      _mode[FX_MODE_FAIRYTWINKLE]            = &WS2812FX::mode_fairytwinkle;
-      _mode[FX_MODE_RUNNING_DUAL]            = &WS2812FX::mode_running_dual;
-      _mode[FX_MODE_HALLOWEEN]               = &WS2812FX::mode_halloween;
-      _mode[FX_MODE_TRICOLOR_CHASE]          = &WS2812FX::mode_tricolor_chase;
-      _mode[FX_MODE_TRICOLOR_WIPE]           = &WS2812FX::mode_tricolor_wipe;
-      _mode[FX_MODE_TRICOLOR_FADE]           = &WS2812FX::mode_tricolor_fade;
-      _mode[FX_MODE_BREATH]                  = &WS2812FX::mode_breath;
-      _mode[FX_MODE_RUNNING_LIGHTS]          = &WS2812FX::mode_running_lights;
-      _mode[FX_MODE_LIGHTNING]               = &WS2812FX::mode_lightning;
-      _mode[FX_MODE_ICU]                     = &WS2812FX::mode_icu;
-      _mode[FX_MODE_MULTI_COMET]             = &WS2812FX::mode_multi_comet;
-      _mode[FX_MODE_DUAL_LARSON_SCANNER]     = &WS2812FX::mode_dual_larson_scanner;
-      _mode[FX_MODE_RANDOM_CHASE]            = &WS2812FX::mode_random_chase;
-      _mode[FX_MODE_OSCILLATE]               = &WS2812FX::mode_oscillate;
-      _mode[FX_MODE_FIRE_2012]               = &WS2812FX::mode_fire_2012;
-      _mode[FX_MODE_PRIDE_2015]              = &WS2812FX::mode_pride_2015;
-      _mode[FX_MODE_BPM]                     = &WS2812FX::mode_bpm;
-      _mode[FX_MODE_JUGGLE]                  = &WS2812FX::mode_juggle;
-      _mode[FX_MODE_PALETTE]                 = &WS2812FX::mode_palette;
-      _mode[FX_MODE_COLORWAVES]              = &WS2812FX::mode_colorwaves;
-      _mode[FX_MODE_FILLNOISE8]              = &WS2812FX::mode_fillnoise8;
-      _mode[FX_MODE_NOISE16_1]               = &WS2812FX::mode_noise16_1;
-      _mode[FX_MODE_NOISE16_2]               = &WS2812FX::mode_noise16_2;
-      _mode[FX_MODE_NOISE16_3]               = &WS2812FX::mode_noise16_3;
-      _mode[FX_MODE_NOISE16_4]               = &WS2812FX::mode_noise16_4;
-      _mode[FX_MODE_COLORTWINKLE]            = &WS2812FX::mode_colortwinkle;
-      _mode[FX_MODE_LAKE]                    = &WS2812FX::mode_lake;
-      _mode[FX_MODE_METEOR]                  = &WS2812FX::mode_meteor;
-      _mode[FX_MODE_METEOR_SMOOTH]           = &WS2812FX::mode_meteor_smooth;
-      _mode[FX_MODE_RAILWAY]                 = &WS2812FX::mode_railway;
-      _mode[FX_MODE_RIPPLE]                  = &WS2812FX::mode_ripple;
-      _mode[FX_MODE_TWINKLEFOX]              = &WS2812FX::mode_twinklefox;
-      _mode[FX_MODE_TWINKLECAT]              = &WS2812FX::mode_twinklecat;
-      _mode[FX_MODE_HALLOWEEN_EYES]          = &WS2812FX::mode_halloween_eyes;
-      _mode[FX_MODE_STATIC_PATTERN]          = &WS2812FX::mode_static_pattern;
-      _mode[FX_MODE_TRI_STATIC_PATTERN]      = &WS2812FX::mode_tri_static_pattern;
-      _mode[FX_MODE_SPOTS]                   = &WS2812FX::mode_spots;
-      _mode[FX_MODE_SPOTS_FADE]              = &WS2812FX::mode_spots_fade;
-      _mode[FX_MODE_GLITTER]                 = &WS2812FX::mode_glitter;
-      _mode[FX_MODE_CANDLE]                  = &WS2812FX::mode_candle;
-      _mode[FX_MODE_STARBURST]               = &WS2812FX::mode_starburst;
-      _mode[FX_MODE_EXPLODING_FIREWORKS]     = &WS2812FX::mode_exploding_fireworks;
-      _mode[FX_MODE_BOUNCINGBALLS]           = &WS2812FX::mode_bouncing_balls;
-      _mode[FX_MODE_SINELON]                 = &WS2812FX::mode_sinelon;
-      _mode[FX_MODE_SINELON_DUAL]            = &WS2812FX::mode_sinelon_dual;
-      _mode[FX_MODE_SINELON_RAINBOW]         = &WS2812FX::mode_sinelon_rainbow;
-      _mode[FX_MODE_POPCORN]                 = &WS2812FX::mode_popcorn;
-      _mode[FX_MODE_DRIP]                    = &WS2812FX::mode_drip;
-      _mode[FX_MODE_PLASMA]                  = &WS2812FX::mode_plasma;
-      _mode[FX_MODE_PERCENT]                 = &WS2812FX::mode_percent;
-      _mode[FX_MODE_RIPPLE_RAINBOW]          = &WS2812FX::mode_ripple_rainbow;
-      _mode[FX_MODE_HEARTBEAT]               = &WS2812FX::mode_heartbeat;
-      _mode[FX_MODE_PACIFICA]                = &WS2812FX::mode_pacifica;
-      _mode[FX_MODE_CANDLE_MULTI]            = &WS2812FX::mode_candle_multi;
-      _mode[FX_MODE_SOLID_GLITTER]           = &WS2812FX::mode_solid_glitter;
-      _mode[FX_MODE_SUNRISE]                 = &WS2812FX::mode_sunrise;
-      _mode[FX_MODE_PHASED]                  = &WS2812FX::mode_phased;
-      _mode[FX_MODE_TWINKLEUP]               = &WS2812FX::mode_twinkleup;
-      _mode[FX_MODE_NOISEPAL]                = &WS2812FX::mode_noisepal;
-      _mode[FX_MODE_SINEWAVE]                = &WS2812FX::mode_sinewave;
-      _mode[FX_MODE_PHASEDNOISE]             = &WS2812FX::mode_phased_noise;
-      _mode[FX_MODE_FLOW]                    = &WS2812FX::mode_flow;
-      _mode[FX_MODE_CHUNCHUN]                = &WS2812FX::mode_chunchun;
-      _mode[FX_MODE_DANCING_SHADOWS]         = &WS2812FX::mode_dancing_shadows;
-      _mode[FX_MODE_WASHING_MACHINE]         = &WS2812FX::mode_washing_machine;
-      _mode[FX_MODE_CANDY_CANE]              = &WS2812FX::mode_candy_cane;
-      _mode[FX_MODE_BLENDS]                  = &WS2812FX::mode_blends;
-      _mode[FX_MODE_TV_SIMULATOR]            = &WS2812FX::mode_tv_simulator;
-      _mode[FX_MODE_DYNAMIC_SMOOTH]          = &WS2812FX::mode_dynamic_smooth;
+      //assign each member of the _mode[] array to its respective function reference, see WLED_FX_SUBSET
+      FX_ADD(FX_MODE_STATIC,                 mode_static);
+      FX_ADD(FX_MODE_BLINK,                  mode_blink);
+      FX_ADD(FX_MODE_COLOR_WIPE,             mode_color_wipe);
+      FX_ADD(FX_MODE_COLOR_WIPE_RANDOM,      mode_color_wipe_random);
+      FX_ADD(FX_MODE_RANDOM_COLOR,           mode_random_color);
+      FX_ADD(FX_MODE_COLOR_SWEEP,            mode_color_sweep);
+      FX_ADD(FX_MODE_DYNAMIC,                mode_dynamic);
+      FX_ADD(FX_MODE_RAINBOW,                mode_rainbow);
+      FX_ADD(FX_MODE_RAINBOW_CYCLE,          mode_rainbow_cycle);
+      FX_ADD(FX_MODE_SCAN,                   mode_scan);
+      FX_ADD(FX_MODE_DUAL_SCAN,              mode_dual_scan);
+      FX_ADD(FX_MODE_FADE,                   mode_fade);
+      FX_ADD(FX_MODE_THEATER_CHASE,          mode_theater_chase);
+      FX_ADD(FX_MODE_THEATER_CHASE_RAINBOW,  mode_theater_chase_rainbow);
+      FX_ADD(FX_MODE_SAW,                    mode_saw);
+      FX_ADD(FX_MODE_TWINKLE,                mode_twinkle);
+      FX_ADD(FX_MODE_DISSOLVE,               mode_dissolve);
+      FX_ADD(FX_MODE_DISSOLVE_RANDOM,        mode_dissolve_random);
+      FX_ADD(FX_MODE_SPARKLE,                mode_sparkle);
+      FX_ADD(FX_MODE_FLASH_SPARKLE,          mode_flash_sparkle);
+      FX_ADD(FX_MODE_HYPER_SPARKLE,          mode_hyper_sparkle);
+      FX_ADD(FX_MODE_STROBE,                 mode_strobe);
+      FX_ADD(FX_MODE_STROBE_RAINBOW,         mode_strobe_rainbow);
+      FX_ADD(FX_MODE_MULTI_STROBE,           mode_multi_strobe);
+      FX_ADD(FX_MODE_BLINK_RAINBOW,          mode_blink_rainbow);
+      FX_ADD(FX_MODE_ANDROID,                mode_android);
+      FX_ADD(FX_MODE_CHASE_COLOR,            mode_chase_color);
+      FX_ADD(FX_MODE_CHASE_RANDOM,           mode_chase_random);
+      FX_ADD(FX_MODE_CHASE_RAINBOW,          mode_chase_rainbow);
+      FX_ADD(FX_MODE_CHASE_FLASH,            mode_chase_flash);
+      FX_ADD(FX_MODE_CHASE_FLASH_RANDOM,     mode_chase_flash_random);
+      FX_ADD(FX_MODE_CHASE_RAINBOW_WHITE,    mode_chase_rainbow_white);
+      FX_ADD(FX_MODE_COLORFUL,               mode_colorful);
+      FX_ADD(FX_MODE_TRAFFIC_LIGHT,          mode_traffic_light);
+      FX_ADD(FX_MODE_COLOR_SWEEP_RANDOM,     mode_color_sweep_random);
+      FX_ADD(FX_MODE_RUNNING_COLOR,          mode_running_color);
+      FX_ADD(FX_MODE_AURORA,                 mode_aurora);
+      FX_ADD(FX_MODE_RUNNING_RANDOM,         mode_running_random);
+      FX_ADD(FX_MODE_LARSON_SCANNER,         mode_larson_scanner);
+      FX_ADD(FX_MODE_COMET,                  mode_comet);
+      FX_ADD(FX_MODE_FIREWORKS,              mode_fireworks);
+      FX_ADD(FX_MODE_RAIN,                   mode_rain);
+      FX_ADD(FX_MODE_TETRIX,                 mode_tetrix);
+      FX_ADD(FX_MODE_FIRE_FLICKER,           mode_fire_flicker);
+      FX_ADD(FX_MODE_GRADIENT,               mode_gradient);
+      FX_ADD(FX_MODE_LOADING,                mode_loading);
+      FX_ADD(FX_MODE_POLICE,                 mode_police);
+      FX_ADD(FX_MODE_FAIRY,                  mode_fairy);
+      FX_ADD(FX_MODE_TWO_DOTS,               mode_two_dots);
+      FX_ADD(FX_MODE_FAIRYTWINKLE,           mode_fairytwinkle);
+      FX_ADD(FX_MODE_RUNNING_DUAL,           mode_running_dual);
+      FX_ADD(FX_MODE_HALLOWEEN,              mode_halloween);
+      FX_ADD(FX_MODE_TRICOLOR_CHASE,         mode_tricolor_chase);
+      FX_ADD(FX_MODE_TRICOLOR_WIPE,          mode_tricolor_wipe);
+      FX_ADD(FX_MODE_TRICOLOR_FADE,          mode_tricolor_fade);
+      FX_ADD(FX_MODE_BREATH,                 mode_breath);
+      FX_ADD(FX_MODE_RUNNING_LIGHTS,         mode_running_lights);
+      FX_ADD(FX_MODE_LIGHTNING,              mode_lightning);
+      FX_ADD(FX_MODE_ICU,                    mode_icu);
+      FX_ADD(FX_MODE_MULTI_COMET,            mode_multi_comet);
+      FX_ADD(FX_MODE_DUAL_LARSON_SCANNER,    mode_dual_larson_scanner);
+      FX_ADD(FX_MODE_RANDOM_CHASE,           mode_random_chase);
+      FX_ADD(FX_MODE_OSCILLATE,              mode_oscillate);
+      FX_ADD(FX_MODE_FIRE_2012,              mode_fire_2012);
+      FX_ADD(FX_MODE_PRIDE_2015,             mode_pride_2015);
+      FX_ADD(FX_MODE_BPM,                    mode_bpm);
+      FX_ADD(FX_MODE_JUGGLE,                 mode_juggle);
+      FX_ADD(FX_MODE_PALETTE,                mode_palette);
+      FX_ADD(FX_MODE_COLORWAVES,             mode_colorwaves);
+      FX_ADD(FX_MODE_FILLNOISE8,             mode_fillnoise8);
+      FX_ADD(FX_MODE_NOISE16_1,              mode_noise16_1);
+      FX_ADD(FX_MODE_NOISE16_2,              mode_noise16_2);
+      FX_ADD(FX_MODE_NOISE16_3,              mode_noise16_3);
+      FX_ADD(FX_MODE_NOISE16_4,              mode_noise16_4);
+      FX_ADD(FX_MODE_COLORTWINKLE,           mode_colortwinkle);
+      FX_ADD(FX_MODE_LAKE,                   mode_lake);
+      FX_ADD(FX_MODE_METEOR,                 mode_meteor);
+      FX_ADD(FX_MODE_METEOR_SMOOTH,          mode_meteor_smooth);
+      FX_ADD(FX_MODE_RAILWAY,                mode_railway);
+      FX_ADD(FX_MODE_RIPPLE,                 mode_ripple);
+      FX_ADD(FX_MODE_TWINKLEFOX,             mode_twinklefox);
+      FX_ADD(FX_MODE_TWINKLECAT,             mode_twinklecat);
+      FX_ADD(FX_MODE_HALLOWEEN_EYES,         mode_halloween_eyes);
+      FX_ADD(FX_MODE_STATIC_PATTERN,         mode_static_pattern);
+      FX_ADD(FX_MODE_TRI_STATIC_PATTERN,     mode_tri_static_pattern);
+      FX_ADD(FX_MODE_SPOTS,                  mode_spots);
+      FX_ADD(FX_MODE_SPOTS_FADE,             mode_spots_fade);
+      FX_ADD(FX_MODE_GLITTER,                mode_glitter);
+      FX_ADD(FX_MODE_CANDLE,                 mode_candle);
+      FX_ADD(FX_MODE_STARBURST,              mode_starburst);
+      FX_ADD(FX_MODE_EXPLODING_FIREWORKS,    mode_exploding_fireworks);
+      FX_ADD(FX_MODE_BOUNCINGBALLS,          mode_bouncing_balls);
+      FX_ADD(FX_MODE_SINELON,                mode_sinelon);
+      FX_ADD(FX_MODE_SINELON_DUAL,           mode_sinelon_dual);
+      FX_ADD(FX_MODE_SINELON_RAINBOW,        mode_sinelon_rainbow);
+      FX_ADD(FX_MODE_POPCORN,                mode_popcorn);
+      FX_ADD(FX_MODE_DRIP,                   mode_drip);
+      FX_ADD(FX_MODE_PLASMA,                 mode_plasma);
+      FX_ADD(FX_MODE_PERCENT,                mode_percent);
+      FX_ADD(FX_MODE_RIPPLE_RAINBOW,         mode_ripple_rainbow);
+      FX_ADD(FX_MODE_HEARTBEAT,              mode_heartbeat);
+      FX_ADD(FX_MODE_PACIFICA,               mode_pacifica);
+      FX_ADD(FX_MODE_CANDLE_MULTI,           mode_candle_multi);
+      FX_ADD(FX_MODE_SOLID_GLITTER,          mode_solid_glitter);
+      FX_ADD(FX_MODE_SUNRISE,                mode_sunrise);
+      FX_ADD(FX_MODE_PHASED,                 mode_phased);
+      FX_ADD(FX_MODE_TWINKLEUP,              mode_twinkleup);
+      FX_ADD(FX_MODE_NOISEPAL,               mode_noisepal);
+      FX_ADD(FX_MODE_SINEWAVE,               mode_sinewave);
+      FX_ADD(FX_MODE_PHASEDNOISE,            mode_phased_noise);
+      FX_ADD(FX_MODE_FLOW,                   mode_flow);
+      FX_ADD(FX_MODE_CHUNCHUN,               mode_chunchun);
+      FX_ADD(FX_MODE_DANCING_SHADOWS,        mode_dancing_shadows);
+      FX_ADD(FX_MODE_WASHING_MACHINE,        mode_washing_machine);
+      FX_ADD(FX_MODE_CANDY_CANE,             mode_candy_cane);
+      FX_ADD(FX_MODE_BLENDS,                 mode_blends);
+      FX_ADD(FX_MODE_TV_SIMULATOR,           mode_tv_simulator);
+      FX_ADD(FX_MODE_DYNAMIC_SMOOTH,         mode_dynamic_smooth);
+      FX_ADD(FX_MODE_PLAYBACK,               mode_playback);
 
       _brightness = DEFAULT_BRIGHTNESS;
-      currentPalette = CRGBPalette16(CRGB::Black);
-      targetPalette = CloudColors_p;
+      for (uint8_t c = 0; c < RENDER_CONTEXTS; c++) {
+        _rc[c].palette = CRGBPalette16(CRGB::Black);
+        _rc[c].targetPalette = CloudColors_p;
+      }
       ablMilliampsMax = ABL_MILLIAMPS_DEFAULT;
       currentMilliamps = 0;
       timebase = 0;
@@ -620,7 +1088,7 @@ class WS2812FX {
     }
 
     void
-      finalizeInit(),
+      finalizeInit(bool resetSegments = true),
       service(void),
       blur(uint8_t),
       fill(uint32_t),
@@ -630,24 +1098,67 @@ class WS2812FX {
       setColor(uint8_t slot, uint32_t c),
       setCCT(uint16_t k),
       setBrightness(uint8_t b, bool direct = false),
-      setRange(uint16_t i, uint16_t i2, uint32_t col),
+      setBrightnessFine(uint16_t b, bool direct = false),
+      setRange(pixidx_t i, pixidx_t i2, uint32_t col),
       setShowCallback(show_callback cb),
       setTransition(uint16_t t),
       setTransitionMode(bool t),
       calcGammaTable(float),
       trigger(void),
-      setSegment(uint8_t n, uint16_t start, uint16_t stop, uint8_t grouping = 0, uint8_t spacing = 0, uint16_t offset = UINT16_MAX),
+      setSegment(uint8_t n, pixidx_t start, pixidx_t stop, uint8_t grouping = 0, uint8_t spacing = 0, uint16_t offset = UINT16_MAX),
+      setSegment2D(uint8_t n, uint16_t width, uint8_t layout),
+      setRenderScale(uint8_t n, uint8_t scale),
+      setSegmentLayer(uint8_t n, uint8_t layer, uint8_t blendMode),
+      setSegmentLink(uint8_t n, uint8_t leader),
+      setSegmentInstance(uint8_t n, uint8_t prototype),
+      freezeLiveSegments(bool freeze, bool clear = false),
       setMainSegmentId(uint8_t n),
       restartRuntime(),
       resetSegments(),
       makeAutoSegments(bool forceReset = false),
       fixInvalidSegments(),
-      setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0),
+      setPixelColor(pixidx_t n, uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0),
+      setRealtimePixels(pixidx_t n, uint16_t count, const uint8_t* data, uint8_t stride, bool gamma),
       show(void),
 			setTargetFps(uint8_t fps),
-      deserializeMap(uint8_t n=0);
+      #ifdef WLED_ENABLE_FRAME_TIMER
+      startFrameTimer(void),
+      waitFrameTick(void),
+      showFrame(void),
+      #endif
+      deserializeMap(uint8_t n=0),
+      loadMapAsync(uint8_t n);
+
+    //n is the virtual pixel of the current segment in effects, else the strip pixel (live data)
+    inline void setPixelColor(pixidx_t n, uint32_t c) {
+      if (SEGLEN) (this->*RCTX.pixelWriter)(n, c); // from segment/FX
+      else setPixelColor(n, byte(c>>16), byte(c>>8), byte(c), byte(c>>24));
+    }
+
+    // 2D helpers for the current segment, x and y as the effect sees them (see Segment::virtualWidth())
+    inline uint16_t XY(uint16_t x, uint16_t y) { return y * RCTX.vWidth + x; }
+    inline uint16_t virtualWidth()  { return RCTX.vWidth; }
+    inline uint16_t virtualHeight() { return RCTX.vWidth ? SEGLEN / RCTX.vWidth : 0; }
+    inline void setPixelColorXY(uint16_t x, uint16_t y, uint32_t c) {
+      if (x < RCTX.vWidth) setPixelColor(XY(x, y), c);
+    }
+    inline uint32_t getPixelColorXY(uint16_t x, uint16_t y) {
+      return (x < RCTX.vWidth) ? getPixelColor(XY(x, y)) : 0;
+    }
 
-    inline void setPixelColor(uint16_t n, uint32_t c) {setPixelColor(n, byte(c>>16), byte(c>>8), byte(c), byte(c>>24));}
+    // time based motion for effects, so animations keep their speed when frames are skipped or the frame rate is lowered:
+    // ms since the previous call, frames at the default frame rate since the effect started (instead of SEGENV.call)
+    // and per frame increments scaled to the time since the previous call (instead of SEGENV.step += perFrame)
+    inline uint16_t deltaTime() { return RCTX.deltaMs; }
+    inline uint32_t effectFrames() { return SEGENV.elapsed / FRAMETIME_FIXED - 1; }
+    int32_t frameStep(int32_t perFrame);
+    void
+      fillRow(uint16_t y, uint32_t c),
+      fillColumn(uint16_t x, uint32_t c),
+      shift2D(int16_t dx, int16_t dy, bool wrap = false),
+      scroll(bool up, uint32_t c, bool wrap = false),
+      blur2D(uint8_t blur_amount),
+      fadeToBlackBy(uint8_t fadeBy);
 
     bool
       gammaCorrectBri = false,
@@ -655,6 +1166,12 @@ class WS2812FX {
       checkSegmentAlignment(void),
       hasRGBWBus(void),
       hasCCTBus(void),
+      isLiveSegment(uint8_t n),
+      hasLiveSegments(void),
+      isLinkedSegment(uint8_t n),
+      isInstanceSegment(uint8_t n),
+      handleMapLoad(void),
+      isMapLoading(void),
       // return true if the strip is being sent pixel updates
       isUpdating(void);
 
@@ -666,12 +1183,16 @@ class WS2812FX {
       cctBlending = 0,
       getBrightness(void),
       getModeCount(void),
+      getModeFlags(uint8_t mode),
+      getModeCost(uint8_t mode),
       getPaletteCount(void),
       getMaxSegments(void),
       getActiveSegmentsNum(void),
       getFirstSelectedSegId(void),
       getMainSegmentId(void),
       getLastActiveSegmentId(void),
+      getActiveSegmentId(uint8_t n),
+      getInstanceSource(uint8_t n),
       getTargetFps(void),
       setPixelSegment(uint8_t n),
       gamma8(uint8_t),
@@ -690,10 +1211,58 @@ class WS2812FX {
       ablMilliampsMax,
       currentMilliamps,
       triwave16(uint16_t),
-      getLengthTotal(void),
-      getLengthPhysical(void),
+      getLedmapWidth(void),
+      getSegmentDataSize(uint8_t n),
+      getSegmentMissedFrames(uint8_t n),
+      getLinkedLength(uint8_t n),
+      getSegmentDataFragmentation(void),
+      getBrightnessFine(void),
+      gamma16(uint16_t),
       getFps();
 
+    uint16_t effectSeed = 0; // shared by synced nodes, seeds the random numbers of the effects together with segment and frame
+    uint16_t psuMilliampsMax[WLED_MAX_PSU] = {0}; // current limit of the power supplies 1.. of busses (Bus::psu), below 150 unlimited
+
+    #ifdef WLED_ENABLE_BENCHMARK
+    typedef struct BenchResult { // per frame of one effect
+      uint8_t  mode;
+      uint32_t fxUs;   // effect call
+      uint32_t showUs; // show() incl. composing, 0 without output
+      int32_t  heap;   // heap taken while the effect ran (effect data, segment buffer)
+    } bench_result;
+    bool benchmark(const uint8_t* modes, uint8_t count, uint16_t frames, uint16_t length, bool output, bench_result* results);
+    #endif
+    #ifdef WLED_ENABLE_BAKE
+    uint32_t bake(uint8_t file, uint16_t frames, uint16_t frameMs);
+    #endif
+
+    #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+    typedef struct QualityEvent {
+      uint32_t time;    // millis()
+      uint16_t frameUs; // smoothed frame interval that led to the decision
+      uint8_t  action;  // QUALITY_HOUSEKEEPING, QUALITY_THROTTLE or QUALITY_CROSSFADE
+      uint8_t  segment; // throttled segment
+      bool     restore; // step undone
+    } quality_event;
+    bool deferHousekeeping(void);
+    inline uint8_t getQualitySteps(void) { return _qualitySteps; }
+    inline uint32_t getQualityFrameTime(void) { return _qualityFrameUs; }
+    inline uint8_t getQualityEventCount(void) { return _qualityEventCount; }
+    inline const quality_event& getQualityEvent(uint8_t n) { // 0 is the latest
+      return _qualityLog[(_qualityLogHead + QUALITY_LOG_SIZE - 1 - n) % QUALITY_LOG_SIZE];
+    }
+    #endif
+
+    // frame clock: the uptime taken once at the start of service(), so all segments, transitions and palettes of
+    // a frame see the same time (now is it plus timebase). Outside service() the live clock. injectFrameClock()
+    // fixes it to given values until called with false, for deterministic runs (baking, off-device harnesses).
+    inline uint32_t uptimeMs(void) { return _frameClock ? _frameMs : millis(); }
+    inline uint32_t uptimeUs(void) { return _frameClock ? _frameUs : micros(); }
+    inline void injectFrameClock(bool on, uint32_t ms = 0, uint32_t us = 0) {
+      _frameClock = _frameClockInjected = on;
+      _frameMs = ms; _frameUs = us;
+    }
+
     uint32_t
       now,
       timebase,
@@ -703,7 +1272,16 @@ class WS2812FX {
       currentColor(uint32_t colorNew, uint8_t tNr),
       gamma32(uint32_t),
       getLastShow(void),
-      getPixelColor(uint16_t);
+      getUsedSegmentData(void),
+      getUsedSegmentBuffers(void),
+      getIdleTime(void),
+      getMaxSegmentData(void),
+      getPixelColor(pixidx_t);
+
+    pixidx_t
+      getLengthTotal(void),
+      getLengthPhysical(void),
+      getLedmapLength(void);
 
     WS2812FX::Segment
       &getSegment(uint8_t n),
@@ -713,6 +1291,9 @@ class WS2812FX {
     WS2812FX::Segment*
       getSegments(void);
 
+    // counts the changes to all segments, see Segment::gen
+    inline uint32_t getSegmentsGen(void) { return _segmentsGen; }
+
     // builtin modes
     uint16_t
       mode_static(void),
@@ -833,18 +1414,68 @@ class WS2812FX {
       mode_candy_cane(void),
       mode_blends(void),
       mode_tv_simulator(void),
-      mode_dynamic_smooth(void);
+      mode_dynamic_smooth(void),
+      mode_playback(void);
 
   private:
     uint32_t crgb_to_col(CRGB fastled);
     CRGB col_to_crgb(uint32_t);
-    CRGBPalette16 currentPalette;
-    CRGBPalette16 targetPalette;
+    // FastLED-style effects render into a CRGB array kept in segment data and write it out once per frame
+    CRGB* segmentLeds(uint16_t dataLen = 0);
+    void setPixels(const CRGB* leds);
+    // state of the segment being rendered, effects reach it through RCTX (SEGMENT, SEGLEN, SEGCOLOR())
+    typedef struct RenderContext {
+      uint8_t  segIndex = 0;
+      uint8_t  paletteLast = 99;  // segment the shared palette was last loaded for (without segment palettes)
+      uint16_t vLength = 0;       // virtualLength() of the current segment, 0 outside of effect calls
+      uint16_t vWidth = 0;        // virtualWidth() of the current segment, SEGLEN for 1D segments
+      uint16_t deltaMs = FRAMETIME_FIXED; // effect time since the previous call of the current effect
+      uint32_t colors[3];         // segment colors with transitions and gamma applied
+      uint8_t  bri;               // segment opacity with transitions applied
+      bool     noRgb = false;
+      uint16_t paletteMapLen = 0;   // SEGLEN that paletteMapScale was computed for
+      uint32_t paletteMapScale = 0; // 255/(SEGLEN-1) in 16.16 fixed point
+      pixel_writer pixelWriter = &WS2812FX::writePixelSegment<true>;
+      CRGBPalette16 palette;        // currentPalette of the effects
+      CRGBPalette16 targetPalette;
+    } render_context;
+    render_context _rc[RENDER_CONTEXTS];
+    #ifdef WLED_ENABLE_PARALLEL_RENDER
+    TaskHandle_t _workerTask = nullptr, _serviceTask = nullptr;
+    uint8_t  _workerSegments[MAX_NUM_SEGMENTS]; // handed to the worker for the current frame
+    uint8_t  _workerSegmentCount = 0;
+    uint32_t _workerNowUp = 0;
+    static void renderWorker(void* parameter);
+    uint8_t dispatchWorker(uint32_t nowUp, uint64_t &workerMask);
+    #endif
 
-    uint16_t _length, _virtualSegmentLength;
-    uint16_t _rand16seed;
+    pixidx_t _length;
     uint8_t _brightness;
-    uint16_t _usedSegmentData = 0;
+    uint16_t _brightnessFine = 0; // _brightness with 16 bit resolution, for outputs that can show it
+    uint32_t _usedSegmentData = 0;
+    uint32_t _maxSegmentData = MAX_SEGMENT_DATA; // raised with PSRAM, see finalizeInit()
+    #ifdef WLED_USE_SEGMENT_DATA_ARENA
+    byte*    _dataArena = nullptr;
+    uint16_t _dataArenaTop = 0; // bytes in use from the start of the arena, including holes
+    #endif
+    #ifdef WLED_USE_SEGMENT_BUFFERS
+    uint32_t _usedSegmentPixels = 0;
+    // layered composition (segments with a layer or blend mode), see composeLayers()
+    uint8_t   _layerOrder[MAX_NUM_SEGMENTS]; // active segment IDs by layer
+    bool      _layered = false;
+    bool      _layerTarget = false;      // setPixelColorInSegment() blends into _layerFrame
+    uint8_t   _layerBlend = SEG_BLEND_NORMAL;
+    uint32_t* _layerFrame = nullptr;     // physical pixels, followed by a bit per pixel set once a layer covered it
+    pixidx_t  _layerFrameLen = 0;
+    bool composeLayers(void);
+    bool      _liveChanged = false;      // realtime data was copied into a live segment buffer, composed by show()
+    #endif
+    #ifdef WLED_USE_SEGMENT_MAPS
+    uint32_t _usedSegmentMapData = 0;
+    #endif
+    #ifdef WLED_USE_PALETTE_LUT
+    uint16_t _usedPaletteLUTData = 0;
+    #endif
     uint16_t _transitionDur = 750;
 
 		uint8_t _targetFps = 42;
@@ -888,21 +1519,105 @@ class WS2812FX {
       blendPixelColor(uint16_t n, uint32_t color, uint8_t blend),
       startTransition(uint8_t oldBri, uint32_t oldCol, uint16_t dur, uint8_t segn, uint8_t slot),
       estimateCurrentAndLimitBri(void),
+      setPixelColorInSegment(uint8_t segIdx, uint16_t i, uint32_t col),
+      writeLiveLayer(pixidx_t n, uint16_t count, const uint32_t* cols),
+      writeMappedPixels(pixidx_t n, uint16_t count, const uint32_t* cols),
+      selectPixelWriter(void),
+      renderSegment(uint8_t n, uint32_t nowUp, bool runEffect, bool inTransition, bool onWorker),
+      #ifdef WLED_USE_SEGMENT_BUFFERS
+      composeSegments(void),
+      composeSegment(uint8_t s),
+      composeExtent(uint8_t s, pixidx_t &lo, pixidx_t &hi),
+      blendIntoLayers(pixidx_t i, uint32_t col),
+      #endif
+      #ifdef WLED_USE_SEGMENT_MAPS
+      buildSegmentMap(uint8_t n),
+      #endif
+      #ifdef WLED_USE_EFFECT_TRANSITIONS
+      renderOutgoingEffect(uint32_t nowUp),
+      #endif
+      #ifdef WLED_USE_SEGMENT_DATA_ARENA
+      freeArenaData(byte* data, uint16_t len),
+      compactArenaData(void),
+      #endif
+      blurLine(uint16_t first, uint16_t count, uint16_t stride, uint8_t keep, uint8_t seep),
       load_gradient_palette(uint8_t),
       handle_palette(void);
 
-    uint16_t* customMappingTable = nullptr;
-    uint16_t  customMappingSize  = 0;
+    #ifdef WLED_USE_SEGMENT_DATA_ARENA
+    byte* allocateArenaData(uint16_t len);
+    #endif
+    #ifdef WLED_USE_SEGMENT_MAPS
+    pixidx_t* fillSegmentMap(Segment& seg, pixidx_t* m, uint16_t stride);
+    #endif
+
+    bool loadPalette(uint8_t paletteIndex, bool singleSegmentMode, uint32_t &lastChange);
+
+    // strip pixel i through the ledmap, pixels outside its range are not mapped
+    inline pixidx_t mapPixel(pixidx_t i) {
+      pixidx_t k = i - customMappingStart; // wraps below the range
+      return k < customMappingSize ? customMappingTable[k] : i;
+    }
+
+    // specialized pixel writers, SCALE applies segment opacity (RCTX.bri)
+    template<bool SCALE> void writePixelSegment(uint16_t i, uint32_t col);
+    template<bool SCALE> void writePixelPlain(uint16_t i, uint32_t col);
+    template<bool SCALE> void writePixelReversed(uint16_t i, uint32_t col);
+    #ifdef WLED_USE_SEGMENT_MAPS
+    template<bool SCALE> void writePixelMapped(uint16_t i, uint32_t col);
+    #endif
+    #ifdef WLED_ENABLE_BAKE
+    void writePixelBake(uint16_t i, uint32_t col); // records the pixel for bake() and passes it on to _bakeWriter
+    uint32_t*    _bakeFrame = nullptr;
+    pixel_writer _bakeWriter = nullptr;
+    #endif
+    #ifdef WLED_USE_SEGMENT_BUFFERS
+    template<bool SCALE> void writePixelBuffer(uint16_t i, uint32_t col);
+    uint32_t* segmentSpan(uint16_t &len, bool ordered = true);
+    #endif
+
+    pixidx_t* customMappingTable = nullptr;
+    pixidx_t  customMappingSize  = 0;
+    pixidx_t  customMappingStart = 0; // first strip pixel the ledmap covers, see mapPixel()
+    uint32_t  _ledmapVersion     = 0; // incremented on each ledmap change, invalidates segment maps
+    uint16_t  _ledmapWidth       = 0; // optional "width" of ledmap.json, rows of a matrix for previews (0: none)
     
     uint32_t _lastPaletteChange = 0;
+    uint32_t _segmentsGen = 0;
     uint32_t _lastShow = 0;
+    uint32_t _renderTime = 0; // µs a service() pass that showed took to render, smoothed
+    uint32_t _frameMs = 0, _frameUs = 0; // frame clock, see uptimeMs()
+    bool     _frameClock = false, _frameClockInjected = false;
+    #ifdef WLED_ENABLE_FRAME_TIMER
+    esp_timer_handle_t _frameTimer = nullptr;
+    SemaphoreHandle_t  _frameTick = nullptr; // given by the timer, taken by the render task
+    volatile bool _frameReady = false;      // rendered ahead, sent on the next tick
+    uint8_t  _frameSlack = 0;               // ms, half a tick, so a segment is due on the tick closest to its next call
+    inline uint8_t frameSlack(void) const { return _frameSlack; }
+    #else
+    inline uint8_t frameSlack(void) const { return 0; }
+    #endif
+    #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+    uint32_t _qualityFrameUs = 0;        // interval between frames, smoothed. Counts only frames that were late
+    uint32_t _qualityLastFrame = 0;      // micros() of the last frame
+    uint32_t _qualityLastDecision = 0;
+    uint32_t _qualityLastHousekeeping = 0;
+    uint16_t _qualityCalm = 0;           // decisions on time since the last step
+    uint16_t _qualityRestoreAfter = 4;   // calm decisions before a step is undone, doubled when undoing made frames late
+    bool     _qualityRestored = false;   // last step was undone in the previous decision
+    bool     _qualityNoCrossfade = false;
+    bool     _qualityHousekeeping = false;
+    uint8_t  _qualitySteps = 0;
+    uint8_t  _qualityStack[QUALITY_MAX_STEPS]; // action | segment << 2 of each step taken, undone last first
+    quality_event _qualityLog[QUALITY_LOG_SIZE];
+    uint8_t  _qualityLogHead = 0, _qualityEventCount = 0;
+    void updateQuality(uint32_t frameStart, bool late);
+    bool lowerQuality(void);
+    void restoreQuality(void);
+    void logQuality(uint8_t action, uint8_t segment, bool restore);
+    #endif
+    uint64_t _lastAblKey = 0;
 
-    uint32_t _colors_t[3];
-    uint8_t _bri_t;
-    bool _no_rgb = false;
-    
-    uint8_t _segment_index = 0;
-    uint8_t _segment_index_palette_last = 99;
     uint8_t _mainSegment;
 
     segment _segments[MAX_NUM_SEGMENTS] = { // SRAM footprint: 24 bytes per element
@@ -910,17 +1625,35 @@ class WS2812FX {
       {0, 7, 0, DEFAULT_SPEED, 128, 0, DEFAULT_MODE, NO_OPTIONS, 1, 0, 255, {DEFAULT_COLOR}, 0}
     };
     segment_runtime _segment_runtimes[MAX_NUM_SEGMENTS]; // SRAM footprint: 28 bytes per element
+
+    // ids of the active segments in ascending order, so per frame loops skip unused slots
+    uint8_t  _activeSegments[MAX_NUM_SEGMENTS];
+    uint8_t  _activeSegmentCount = 0;
+    volatile bool _activeSegmentsDirty = true; // set when segment bounds change, the list is rebuilt on next use
+    uint64_t _segmentsToRelease = 0;           // segments deleted since the last service(), their buffers are freed there
+    void updateActiveSegments(void);
+    void releaseSegment(uint8_t n);
+    inline void writePhysical(pixidx_t i, uint32_t col);
+    void closeIdlePlayback(uint32_t nowUp);
     friend class Segment_runtime;
 
-    ColorTransition transitions[MAX_NUM_TRANSITIONS]; //12 bytes per element
+    ColorTransition* _transitions[MAX_NUM_SEGMENTS] = {nullptr}; // NUM_COLORS per segment, allocated with its first transition
     friend class ColorTransition;
-
-    uint16_t
-      transitionProgress(uint8_t tNr);
+    bool inColorTransition(uint8_t n);
   
   public:
     inline bool hasWhiteChannel(void) {return _hasWhiteChannel;}
     inline bool isOffRefreshRequired(void) {return _isOffRefreshRequired;}
+
+    // user palettes, palette IDs from getPaletteCount() - getCustomPaletteCount() on
+    void loadCustomPalettes(void);
+    inline void reloadCustomPalettes(void) {_customPalettesDirty = true;} // from the network task, loaded by service()
+    inline uint8_t getCustomPaletteCount(void) {return _customPaletteCount;}
+    inline const CRGBPalette16* getCustomPalette(uint8_t n) {return n < _customPaletteCount ? &_customPalettes[n] : nullptr;}
+  private:
+    CRGBPalette16* _customPalettes = nullptr; // expanded once, so loading one is a copy
+    uint8_t _customPaletteCount = 0;
+    volatile bool _customPalettesDirty = false;
 };
 
 //10 names per line
@@ -936,10 +1669,134 @@ const char JSON_mode_names[] PROGMEM = R"=====([
 "Twinklefox","Twinklecat","Halloween Eyes","Solid Pattern","Solid Pattern Tri","Spots","Spots Fade","Glitter","Candle","Fireworks Starburst",
 "Fireworks 1D","Bouncing Balls","Sinelon","Sinelon Dual","Sinelon Rainbow","Popcorn","Drip","Plasma","Percent","Ripple Rainbow",
 "Heartbeat","Pacifica","Candle Multi", "Solid Glitter","Sunrise","Phased","Twinkleup","Noise Pal", "Sine","Phased Noise",
-"Flow","Chunchun","Dancing Shadows","Washing Machine","Candy Cane","Blends","TV Simulator","Dynamic Smooth"
+"Flow","Chunchun","Dancing Shadows","Washing Machine","Candy Cane","Blends","TV Simulator","Dynamic Smooth","Playback"
 ])=====";
 
 
+//capabilities and cost hints, in the same order as _mode[] and JSON_mode_names
+const effect_meta JSON_mode_meta[] PROGMEM = {
+  { FX_IS_STATIC                                            , 1 }, // FX_MODE_STATIC
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_BLINK
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_BREATH
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_COLOR_WIPE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_COLOR_WIPE_RANDOM
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_RANDOM_COLOR
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_COLOR_SWEEP
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_PER_PIXEL , 1 }, // FX_MODE_DYNAMIC
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_RAINBOW
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_RAINBOW_CYCLE
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_SCAN
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_DUAL_SCAN
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_FADE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_THEATER_CHASE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_THEATER_CHASE_RAINBOW
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_RUNNING_LIGHTS
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_SAW
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_TWINKLE
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 1 }, // FX_MODE_DISSOLVE
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 1 }, // FX_MODE_DISSOLVE_RANDOM
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_SPARKLE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_FLASH_SPARKLE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_HYPER_SPARKLE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_STROBE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_STROBE_RAINBOW
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_MULTI_STROBE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_BLINK_RAINBOW
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_ANDROID
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_CHASE_COLOR
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_CHASE_RANDOM
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_CHASE_RAINBOW
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_CHASE_FLASH
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_CHASE_FLASH_RANDOM
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_CHASE_RAINBOW_WHITE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_COLORFUL
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_TRAFFIC_LIGHT
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_COLOR_SWEEP_RANDOM
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_RUNNING_COLOR
+  { FX_USES_PALETTE | FX_DATA_FIXED                         , 2 }, // FX_MODE_AURORA
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 1 }, // FX_MODE_RUNNING_RANDOM
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 2 }, // FX_MODE_LARSON_SCANNER
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 2 }, // FX_MODE_COMET
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 1 }, // FX_MODE_FIREWORKS
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 1 }, // FX_MODE_RAIN
+  { FX_USES_PALETTE | FX_DATA_FIXED                         , 1 }, // FX_MODE_TETRIX
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_FIRE_FLICKER
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_GRADIENT
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_LOADING
+  { 0                                                       , 1 }, // FX_MODE_POLICE
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_PER_PIXEL , 2 }, // FX_MODE_FAIRY
+  { 0                                                       , 1 }, // FX_MODE_TWO_DOTS
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 1 }, // FX_MODE_FAIRYTWINKLE
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_RUNNING_DUAL
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_HALLOWEEN
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_TRICOLOR_CHASE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_TRICOLOR_WIPE
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_TRICOLOR_FADE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_LIGHTNING
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_ICU
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_FIXED     , 2 }, // FX_MODE_MULTI_COMET
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 2 }, // FX_MODE_DUAL_LARSON_SCANNER
+  { FX_NEEDS_READBACK                                       , 1 }, // FX_MODE_RANDOM_CHASE
+  { FX_DATA_FIXED                                           , 1 }, // FX_MODE_OSCILLATE
+  { FX_DATA_PER_PIXEL                                       , 3 }, // FX_MODE_PRIDE_2015
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 2 }, // FX_MODE_JUGGLE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_PALETTE
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 1 }, // FX_MODE_FIRE_2012
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 3 }, // FX_MODE_COLORWAVES
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_BPM
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_FILLNOISE8
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_NOISE16_1
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 2 }, // FX_MODE_NOISE16_2
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_NOISE16_3
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_NOISE16_4
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_PER_PIXEL , 1 }, // FX_MODE_COLORTWINKLE
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_LAKE
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 2 }, // FX_MODE_METEOR
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_PER_PIXEL , 2 }, // FX_MODE_METEOR_SMOOTH
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_RAILWAY
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_FIXED     , 1 }, // FX_MODE_RIPPLE
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_TWINKLEFOX
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_TWINKLECAT
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_HALLOWEEN_EYES
+  { FX_USES_PALETTE | FX_IS_STATIC                          , 1 }, // FX_MODE_STATIC_PATTERN
+  { FX_IS_STATIC                                            , 1 }, // FX_MODE_TRI_STATIC_PATTERN
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_SPOTS
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_SPOTS_FADE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_GLITTER
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_CANDLE
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 3 }, // FX_MODE_STARBURST
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 2 }, // FX_MODE_EXPLODING_FIREWORKS
+  { FX_USES_PALETTE | FX_DATA_FIXED                         , 2 }, // FX_MODE_BOUNCINGBALLS
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 2 }, // FX_MODE_SINELON
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 2 }, // FX_MODE_SINELON_DUAL
+  { FX_USES_PALETTE | FX_NEEDS_READBACK                     , 2 }, // FX_MODE_SINELON_RAINBOW
+  { FX_USES_PALETTE | FX_DATA_FIXED                         , 2 }, // FX_MODE_POPCORN
+  { FX_DATA_FIXED                                           , 2 }, // FX_MODE_DRIP
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_PLASMA
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_PERCENT
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_FIXED     , 1 }, // FX_MODE_RIPPLE_RAINBOW
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_HEARTBEAT
+  { FX_USES_PALETTE                                         , 4 }, // FX_MODE_PACIFICA
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 2 }, // FX_MODE_CANDLE_MULTI
+  { 0                                                       , 1 }, // FX_MODE_SOLID_GLITTER
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_SUNRISE
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_PHASED
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_TWINKLEUP
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_FIXED     , 2 }, // FX_MODE_NOISEPAL
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_SINEWAVE
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_PHASEDNOISE
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_FLOW
+  { FX_USES_PALETTE                                         , 2 }, // FX_MODE_CHUNCHUN
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_FIXED     , 2 }, // FX_MODE_DANCING_SHADOWS
+  { FX_USES_PALETTE                                         , 3 }, // FX_MODE_WASHING_MACHINE
+  { FX_USES_PALETTE                                         , 1 }, // FX_MODE_CANDY_CANE
+  { FX_USES_PALETTE | FX_DATA_PER_PIXEL                     , 1 }, // FX_MODE_BLENDS
+  { FX_DATA_FIXED                                           , 2 }, // FX_MODE_TV_SIMULATOR
+  { FX_USES_PALETTE | FX_NEEDS_READBACK | FX_DATA_PER_PIXEL , 1 }, // FX_MODE_DYNAMIC_SMOOTH
+  { FX_DATA_FIXED                                           , 2 }, // FX_MODE_PLAYBACK
+};
+static_assert(sizeof(JSON_mode_meta) / sizeof(effect_meta) == MODE_COUNT, "JSON_mode_meta[] must have one entry per effect");
+
 const char JSON_palette_names[] PROGMEM = R"=====([
 "Default","* Random Cycle","* Color 1","* Colors 1&2","* Color Gradient","* Colors Only","Party","Cloud","Lava","Ocean",
 "Forest","Rainbow","Rainbow Bands","Sunset","Rivendell","Breeze","Red & Blue","Yellowout","Analogous","Splash",
@@ -951,4 +1808,7 @@ const char JSON_palette_names[] PROGMEM = R"=====([
 "Candy2"
 ])=====";
 
+#include "fx_names.h" //name positions and alphabetical order, generated from the two lists above
+static_assert(FX_NAME_COUNT == MODE_COUNT, "JSON_mode_names must have one name per effect");
+
 #endif
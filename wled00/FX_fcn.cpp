@@ -70,13 +70,19 @@
 #endif
 
 //do not call this method from system context (network callback)
-void WS2812FX::finalizeInit(void)
+void WS2812FX::finalizeInit(bool resetSegments)
 {
-  //reset segment runtimes
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
-    _segment_runtimes[i].markForReset();
-    _segment_runtimes[i].resetIfRequired();
-  }
+  #ifndef WLED_USE_SEGMENT_DATA_ARENA
+  if (!_usedSegmentData) _maxSegmentData = scaledMemoryLimit(MAX_SEGMENT_DATA, SEGMENT_DATA_PSRAM_SHARE);
+  #endif
+
+  //reset segment runtimes, or just redraw them on busses that were reconfigured
+  if (resetSegments) {
+    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+      _segment_runtimes[i].markForReset();
+      _segment_runtimes[i].resetIfRequired();
+    }
+  } else trigger();
 
   _hasWhiteChannel = _isOffRefreshRequired = false;
 
@@ -87,10 +93,10 @@ void WS2812FX::finalizeInit(void)
     const uint16_t defCounts[] = {PIXEL_COUNTS};
     const uint8_t defNumBusses = ((sizeof defDataPins) / (sizeof defDataPins[0]));
     const uint8_t defNumCounts = ((sizeof defCounts)   / (sizeof defCounts[0]));
-    uint16_t prevLen = 0;
+    pixidx_t prevLen = 0;
     for (uint8_t i = 0; i < defNumBusses && i < WLED_MAX_BUSSES; i++) {
       uint8_t defPin[] = {defDataPins[i]};
-      uint16_t start = prevLen;
+      pixidx_t start = prevLen;
       uint16_t count = defCounts[(i < defNumCounts) ? i : defNumCounts -1];
       prevLen += count;
       BusConfig defCfg = BusConfig(DEFAULT_LED_TYPE, defPin, start, count, DEFAULT_LED_COLOR_ORDER);
@@ -107,7 +113,7 @@ void WS2812FX::finalizeInit(void)
     _hasWhiteChannel |= bus->isRgbw();
     //refresh is required to remain off if at least one of the strips requires the refresh.
     _isOffRefreshRequired |= bus->isOffRefreshRequired();
-    uint16_t busEnd = bus->getStart() + bus->getLength();
+    pixidx_t busEnd = bus->getStart() + bus->getLength();
     if (busEnd > _length) _length = busEnd;
     #ifdef ESP8266
     if ((!IS_DIGITAL(bus->getType()) || IS_2PIN(bus->getType()))) continue;
@@ -123,128 +129,1165 @@ void WS2812FX::finalizeInit(void)
   setBrightness(_brightness);
 }
 
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+uint8_t fxWorkerCore = 0xFF;
+uint16_t fxWorkerRandSeed = 1337;
+portMUX_TYPE fxAllocMux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
 void WS2812FX::service() {
-  uint32_t nowUp = millis(); // Be aware, millis() rolls over every 49 days
+  if (_customPalettesDirty) loadCustomPalettes(); // files changed
+  if (!_frameClockInjected) {
+    _frameMs = millis(); // Be aware, millis() rolls over every 49 days
+    _frameUs = micros();
+  }
+  uint32_t nowUp = _frameMs;
   now = nowUp + timebase;
-  if (nowUp - _lastShow < MIN_SHOW_DELAY) return;
+  busses.updateStats();
+  #ifdef WLED_ENABLE_FRAME_TIMER
+  if (_frameReady) return; // the frame rendered ahead was not sent yet
+  bool paced = _frameTimer; // rendered right after the tick, while the previous frame is on the wire
+  #else
+  bool paced = false;
+  #endif
+  // pace frames by the wire time of the slowest bus: start rendering once the rest of
+  // the previous transfer is shorter than rendering takes, so the next frame is ready just in time
+  if (!paced && busses.getBusyTime() > _renderTime) return;
+  _frameClock = true; // effects, transitions and palettes use the frame clock from here
   bool doShow = false;
+  uint32_t serviceStart = micros();
 
-  for(uint8_t i=0; i < MAX_NUM_SEGMENTS; i++)
+  // free the buffers of deleted segments
+  if (_segmentsToRelease) {
+    uint64_t release = _segmentsToRelease;
+    _segmentsToRelease = 0;
+    for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+      if ((release >> i) & 1) releaseSegment(i);
+    }
+  }
+  if (_activeSegmentsDirty) updateActiveSegments();
+
+  #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+  bool late = false; // an effect call is due since more than a millisecond (idle sleep wakes the loop in time)
+  for (uint8_t k = 0; k < _activeSegmentCount && !late; k++) {
+    segment_runtime& env = _segment_runtimes[_activeSegments[k]];
+    late = env.next_time && nowUp > env.next_time + 1;
+  }
+  #endif
+
+  uint64_t workerMask = 0; // segments the worker renders this frame
+  #ifdef WLED_ENABLE_PARALLEL_RENDER
+  if (dispatchWorker(nowUp, workerMask)) doShow = true;
+  #endif
+
+  for (uint8_t k = 0; k < _activeSegmentCount; k++)
   {
+    uint8_t i = _activeSegments[k];
     //if (realtimeMode && useMainSegmentOnly && i == getMainSegmentId()) continue;
+    if ((workerMask >> i) & 1) continue;
 
-    _segment_index = i;
+    RCTX.segIndex = i;
 
-    // reset the segment runtime data if needed, called before isActive to ensure deleted
-    // segment's buffers are cleared
+    // reset the segment runtime data if needed
     SEGENV.resetIfRequired();
 
-    if (!SEGMENT.isActive()) continue;
+    if (!SEGMENT.isActive()) { // deleted by a network callback since the list was built
+      releaseSegment(i);
+      continue;
+    }
+    #ifdef WLED_USE_SEGMENT_MAPS
+    if (isLinkedSegment(i)) { // drawn by the effect of the segment it is linked to
+      if (!SEGENV.mapMatches(SEGMENT, _ledmapVersion)) { // newly linked or its geometry changed
+        SEGENV.markForReset();
+        SEGENV.resetIfRequired();
+        SEGENV.deallocateMap();
+        #ifdef WLED_USE_SEGMENT_BUFFERS
+        SEGENV.deallocatePixels();
+        #endif
+        SEGENV.setMapKey(SEGMENT, _ledmapVersion);
+        _segment_runtimes[SEGMENT.link - 1].invalidateMap();
+      }
+      continue;
+    }
+    if (!SEGENV.mapMatches(SEGMENT, _ledmapVersion)) buildSegmentMap(i);
+    #endif
+    if (isInstanceSegment(i)) { // shows the buffer of its prototype, see composeSegment()
+      if (SEGENV.call) {
+        SEGENV.markForReset();
+        SEGENV.resetIfRequired();
+      }
+      #ifdef WLED_USE_SEGMENT_BUFFERS
+      SEGENV.deallocatePixels();
+      #endif
+      continue;
+    }
 
     // last condition ensures all solid segments are updated at the same time
-    if(nowUp > SEGENV.next_time || _triggered || (doShow && SEGMENT.mode == 0))
+    bool due = nowUp + frameSlack() > SEGENV.next_time;
+    uint16_t segFrametime = SEGMENT.fps ? 1000 / SEGMENT.fps : FRAMETIME;
+    if (due && !_triggered && SEGMENT.mode != 0 && !SEGENV.deferred && micros() - serviceStart > SEGMENT_SERVICE_BUDGET_US) {
+      SEGENV.deferred = true; // spread effect calls over show intervals
+      due = false;
+    }
+    if (due && SEGENV.next_time && nowUp - SEGENV.next_time > segFrametime && SEGENV.missedFrames < UINT16_MAX) SEGENV.missedFrames++;
+    bool runEffect = due || _triggered || (doShow && SEGMENT.mode == 0);
+    bool inTransition = false;
+    #ifdef WLED_USE_EFFECT_TRANSITIONS
+    if (SEGENV.fxTransition && nowUp - SEGENV.fxTransition->start >= SEGENV.fxTransition->duration) SEGENV.endEffectTransition();
+    #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+    if (SEGENV.fxTransition && _qualityNoCrossfade) SEGENV.endEffectTransition();
+    #endif
+    inTransition = SEGENV.fxTransition; // crossfade needs every frame
+    #endif
+    if (runEffect || inTransition)
     {
       if (SEGMENT.grouping == 0) SEGMENT.grouping = 1; //sanity check
       doShow = true;
-      uint16_t delay = FRAMETIME;
-
-      if (!SEGMENT.getOption(SEG_OPTION_FREEZE)) { //only run effect function if not frozen
-        _virtualSegmentLength = SEGMENT.virtualLength();
-        _bri_t = SEGMENT.opacity; _colors_t[0] = SEGMENT.colors[0]; _colors_t[1] = SEGMENT.colors[1]; _colors_t[2] = SEGMENT.colors[2];
-        uint8_t _cct_t = SEGMENT.cct;
-        if (!IS_SEGMENT_ON) _bri_t = 0;
-        for (uint8_t t = 0; t < MAX_NUM_TRANSITIONS; t++) {
-          if ((transitions[t].segment & 0x3F) != i) continue;
-          uint8_t slot = transitions[t].segment >> 6;
-          if (slot == 0) _bri_t = transitions[t].currentBri();
-          if (slot == 1) _cct_t = transitions[t].currentBri(false, 1);
-          _colors_t[slot] = transitions[t].currentColor(SEGMENT.colors[slot]);
-        }
-        if (!cctFromRgb || correctWB) busses.setSegmentCCT(_cct_t, correctWB);
-        for (uint8_t c = 0; c < NUM_COLORS; c++) {
-          _colors_t[c] = gamma32(_colors_t[c]);
-        }
-        handle_palette();
-
-        // if segment is not RGB capable, force None auto white mode
-        // If not RGB capable, also treat palette as if default (0), as palettes set white channel to 0
-        _no_rgb = !(SEGMENT.getLightCapabilities() & 0x01);
-        if (_no_rgb) Bus::setAutoWhiteMode(RGBW_MODE_MANUAL_ONLY);
-        delay = (this->*_mode[SEGMENT.mode])(); //effect function
-        if (SEGMENT.mode != FX_MODE_HALLOWEEN_EYES) SEGENV.call++;
-        Bus::setAutoWhiteMode(strip.autoWhiteMode);
-      }
-
-      SEGENV.next_time = nowUp + delay;
+      renderSegment(i, nowUp, runEffect, inTransition, false);
     }
   }
-  _virtualSegmentLength = 0;
+  RCTX.vLength = 0;
+  RCTX.vWidth = 0;
   busses.setSegmentCCT(-1);
+  #ifdef WLED_ENABLE_PARALLEL_RENDER
+  if (workerMask) ulTaskNotifyTake(pdTRUE, portMAX_DELAY); // join, the worker gives once its segments are done
+  #endif
+  closeIdlePlayback(nowUp);
   if(doShow) {
-    yield();
-    show();
+    #ifdef WLED_USE_SEGMENT_BUFFERS
+    composeSegments();
+    #endif
+    _renderTime = (3 * _renderTime + (micros() - serviceStart)) >> 2;
+    #ifdef WLED_ENABLE_FRAME_TIMER
+    if (_frameTimer) _frameReady = true; // sent by showFrame() on the next tick
+    else
+    #endif
+    {
+      yield();
+      show();
+    }
+    #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+    updateQuality(serviceStart, late);
+    #endif
   }
   _triggered = false;
+  _frameClock = _frameClockInjected;
 }
 
-void IRAM_ATTR WS2812FX::setPixelColor(uint16_t i, byte r, byte g, byte b, byte w)
+#ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+/*
+ * Adaptive quality controller, called after each frame. Only late frames count with their interval,
+ * frames that were on time count as exactly on target, so effects with long delays are no pressure.
+ */
+void WS2812FX::updateQuality(uint32_t frameStart, bool late)
 {
-  uint8_t segIdx;
+  uint32_t budget = FRAMETIME * 1000U;
+  uint32_t interval = frameStart - _qualityLastFrame;
+  _qualityLastFrame = frameStart;
+  if (!late || interval > 1000000U) interval = budget;
+  _qualityFrameUs = _qualityFrameUs ? (7 * _qualityFrameUs + interval) >> 3 : budget;
+
+  uint32_t nowUp = millis();
+  if (nowUp - _qualityLastDecision < QUALITY_INTERVAL_MS) return;
+  _qualityLastDecision = nowUp;
+
+  if (_qualityFrameUs > budget + (budget >> 3)) {
+    // undoing the last step made frames late again, wait longer before the next try
+    if (_qualityRestored && _qualityRestoreAfter < 64) _qualityRestoreAfter <<= 1;
+    _qualityRestored = false;
+    _qualityCalm = 0;
+    lowerQuality();
+    return;
+  }
+  _qualityRestored = false;
+  if (!_qualitySteps || ++_qualityCalm < _qualityRestoreAfter) return;
+  _qualityCalm = 0;
+  restoreQuality();
+  _qualityRestored = true;
+}
 
+// takes the next step down, returns false if there is none left
+bool WS2812FX::lowerQuality()
+{
+  if (_qualitySteps >= QUALITY_MAX_STEPS) return false;
+  uint8_t action = QUALITY_THROTTLE;
+  uint8_t seg = 0;
+  if (!_qualityHousekeeping) {
+    action = QUALITY_HOUSEKEEPING;
+    _qualityHousekeeping = true;
+  } else {
+    // the segment whose effect takes longest and can still slow down
+    uint16_t maxUs = 0;
+    for (uint8_t k = 0; k < _activeSegmentCount; k++) {
+      uint8_t i = _activeSegments[k];
+      segment_runtime& env = _segment_runtimes[i];
+      if (_segments[i].mode == 0 || env.throttle >= QUALITY_MAX_THROTTLE || env.renderUs <= maxUs) continue;
+      maxUs = env.renderUs;
+      seg = i;
+    }
+    if (maxUs) {
+      _segment_runtimes[seg].throttle++;
+    } else if (!_qualityNoCrossfade) {
+      action = QUALITY_CROSSFADE;
+      _qualityNoCrossfade = true;
+    } else return false;
+  }
+  _qualityStack[_qualitySteps++] = action | (seg << 2);
+  logQuality(action, seg, false);
+  return true;
+}
+
+// undoes the last step taken
+void WS2812FX::restoreQuality()
+{
+  uint8_t step = _qualityStack[--_qualitySteps];
+  uint8_t action = step & 0x03;
+  uint8_t seg = step >> 2;
+  switch (action) {
+    case QUALITY_HOUSEKEEPING: _qualityHousekeeping = false; break;
+    case QUALITY_CROSSFADE:    _qualityNoCrossfade = false;  break;
+    default: if (_segment_runtimes[seg].throttle) _segment_runtimes[seg].throttle--; break; // 0 if the segment was deleted
+  }
+  logQuality(action, seg, true);
+  if (!_qualitySteps) _qualityRestoreAfter = 4;
+}
+
+void WS2812FX::logQuality(uint8_t action, uint8_t segment, bool restore)
+{
+  quality_event& ev = _qualityLog[_qualityLogHead];
+  ev.time = millis();
+  ev.frameUs = MIN(_qualityFrameUs, UINT16_MAX);
+  ev.action = action;
+  ev.segment = segment;
+  ev.restore = restore;
+  _qualityLogHead = (_qualityLogHead + 1) % QUALITY_LOG_SIZE;
+  if (_qualityEventCount < QUALITY_LOG_SIZE) _qualityEventCount++;
+}
+
+// true if the main loop should skip housekeeping (file system maintenance, node list refresh) this time
+bool WS2812FX::deferHousekeeping()
+{
+  if (_qualityHousekeeping && millis() - _qualityLastHousekeeping < QUALITY_HOUSEKEEPING_MS) return true;
+  _qualityLastHousekeeping = millis();
+  return false;
+}
+#endif
+
+// calls the effect of segment n (and the outgoing effect of a crossfade) and schedules its next call.
+// onWorker: called from the render worker, which renders into segment buffers only
+void WS2812FX::renderSegment(uint8_t n, uint32_t nowUp, bool runEffect, bool inTransition, bool onWorker)
+{
+  TRACE_START(traceStart);
+  RCTX.segIndex = n;
+  uint16_t segFrametime = SEGMENT.fps ? 1000 / SEGMENT.fps : FRAMETIME;
+  uint16_t delay = FRAMETIME;
+
+  if (!SEGMENT.getOption(SEG_OPTION_FREEZE)) { //only run effect function if not frozen
+    uint16_t fullLength = getLinkedLength(n);
+    bool linked = fullLength > SEGMENT.virtualLength(); // effect sees the linked segments as one strip at full resolution
+    RCTX.vLength = linked ? fullLength : SEGMENT.renderLength();
+    RCTX.vWidth = (SEGMENT.is2D() && !linked) ? SEGMENT.virtualWidth() : RCTX.vLength;
+    RCTX.bri = SEGMENT.opacity; RCTX.colors[0] = SEGMENT.colors[0]; RCTX.colors[1] = SEGMENT.colors[1]; RCTX.colors[2] = SEGMENT.colors[2];
+    uint8_t _cct_t = SEGMENT.cct;
+    if (!IS_SEGMENT_ON) RCTX.bri = 0;
+    if (ColorTransition* ts = _transitions[n]) {
+      bool running = false;
+      for (uint8_t slot = 0; slot < NUM_COLORS; slot++) {
+        if (ts[slot].segment == 0xFF) continue;
+        if (slot == 0) RCTX.bri = ts[slot].currentBri();
+        if (slot == 1) _cct_t = ts[slot].currentBri(false, 1);
+        RCTX.colors[slot] = ts[slot].currentColor(SEGMENT.colors[slot]);
+        running |= (ts[slot].segment != 0xFF);
+      }
+      if (!running) SEGMENT.setOption(SEG_OPTION_TRANSITIONAL, false);
+    }
+    int16_t busCCT = (!cctFromRgb || correctWB) ? _cct_t : -1;
+    if (busCCT >= 0 && !onWorker) busses.setSegmentCCT(busCCT, correctWB);
+    #ifdef WLED_USE_SEGMENT_BUFFERS
+    SEGENV.pixelsCCT = busCCT;
+    #endif
+    for (uint8_t c = 0; c < NUM_COLORS; c++) {
+      RCTX.colors[c] = gamma32(RCTX.colors[c]);
+    }
+    // effects that never touch the palette don't need it loaded (the outgoing effect of a crossfade might)
+    if ((getModeFlags(SEGMENT.mode) & FX_USES_PALETTE) || inTransition) {
+      PROFILE_START(palStart);
+      handle_palette();
+      if (!onWorker) PROFILE_STAGE(PROF_PALETTE, palStart);
+    }
+
+    // if segment is not RGB capable, force None auto white mode
+    // If not RGB capable, also treat palette as if default (0), as palettes set white channel to 0
+    RCTX.noRgb = !(SEGMENT.getLightCapabilities() & 0x01);
+    if (RCTX.noRgb && !onWorker) Bus::setAutoWhiteMode(RGBW_MODE_MANUAL_ONLY);
+    #ifdef WLED_USE_SEGMENT_BUFFERS
+    SEGENV.allocatePixels(RCTX.vLength); //on failure the effect renders directly to the busses
+    if (!SEGENV.pixels && RCTX.vLength != fullLength) RCTX.vLength = RCTX.vWidth = fullLength; //no buffer to upscale from
+    #endif
+    selectPixelWriter();
+    if (runEffect) {
+      // the effect draws from its segment's stream, the rest of WLED keeps the global one
+      uint16_t globalSeed = random16_get_seed();
+      SEGENV.seedRandom(effectSeed, n, now / FRAMETIME);
+      random16_set_seed(SEGENV.rand16);
+      #ifdef WLED_TRACK_RENDER_TIME
+      uint32_t fxStart = micros();
+      #else
+      PROFILE_START(fxStart);
+      #endif
+      RCTX.deltaMs = SEGENV.advanceTime(now);
+      delay = (this->*_mode[SEGMENT.mode])(); //effect function
+      #ifdef WLED_TRACK_RENDER_TIME
+      uint32_t fxUs = MIN(micros() - fxStart, UINT16_MAX);
+      SEGENV.renderUs = (3 * SEGENV.renderUs + fxUs) >> 2;
+      #endif
+      if (!onWorker) PROFILE_EFFECT(SEGMENT.mode, fxStart);
+      SEGENV.rand16 = random16_get_seed();
+      random16_set_seed(globalSeed);
+      if (SEGMENT.mode != FX_MODE_HALLOWEEN_EYES) SEGENV.call++;
+      if (SEGMENT.fps && delay < segFrametime) delay = segFrametime; // segment frame rate target
+      #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+      if (SEGENV.throttle && delay < (segFrametime << SEGENV.throttle)) delay = segFrametime << SEGENV.throttle;
+      #endif
+    }
+    #ifdef WLED_USE_EFFECT_TRANSITIONS
+    if (inTransition) renderOutgoingEffect(nowUp);
+    #endif
+    if (!onWorker) Bus::setAutoWhiteMode(strip.autoWhiteMode);
+  }
+
+  if (runEffect) {
+    SEGENV.next_time = nowUp + delay;
+    // call the effect right after a frame boundary of the effect clock, so synced nodes render the same frame numbers
+    if (delay >= FRAMETIME) SEGENV.next_time -= (now + delay) % FRAMETIME;
+    SEGENV.deferred = false;
+  }
+  TRACE_SPAN(TRACE_SEGMENT, n, traceStart);
+}
+
+#ifdef WLED_ENABLE_PARALLEL_RENDER
+/*
+ * Hands part of the due segments to the render worker on the other core and wakes it.
+ * Only segments that render into an existing buffer of the right size with settled effect state
+ * qualify, so the worker never resets, maps or reallocates. They are split longest effect time first,
+ * each to the core with less work so far. Returns the number of segments handed over.
+ */
+uint8_t WS2812FX::dispatchWorker(uint32_t nowUp, uint64_t &workerMask)
+{
+  if (!_workerTask) {
+    fxWorkerCore = 1 - xPortGetCoreID();
+    _serviceTask = xTaskGetCurrentTaskHandle();
+    if (xTaskCreatePinnedToCore(renderWorker, "fxworker", WLED_PARALLEL_RENDER_STACK, this, uxTaskPriorityGet(nullptr), &_workerTask, fxWorkerCore) != pdPASS) {
+      _workerTask = nullptr;
+      fxWorkerCore = 0xFF;
+      return 0;
+    }
+  }
+  if (_triggered) return 0; // all segments at once, e.g. after a preset, keep it simple
+
+  uint8_t  candidates[MAX_NUM_SEGMENTS];
+  uint8_t  numCandidates = 0;
+  uint32_t mainUs = 0;
+  for (uint8_t k = 0; k < _activeSegmentCount; k++) {
+    uint8_t i = _activeSegments[k];
+    Segment& seg = _segments[i];
+    segment_runtime& env = _segment_runtimes[i];
+    if (env.deferred || !(nowUp + frameSlack() > env.next_time)) continue;
+    bool eligible = seg.isActive() && seg.mode != 0 && seg.grouping && !seg.getOption(SEG_OPTION_FREEZE)
+                    && env.call && !env.resetRequired() && env.pixels && env.pixelsLength() == seg.renderLength();
+    #ifdef WLED_USE_SEGMENT_MAPS
+    eligible = eligible && env.mapMatches(seg, _ledmapVersion) && !isLinkedSegment(i);
+    #endif
+    eligible = eligible && !isInstanceSegment(i);
+    #ifdef WLED_USE_EFFECT_TRANSITIONS
+    eligible = eligible && !env.fxTransition;
+    #endif
+    if (!eligible) { mainUs += env.renderUs; continue; }
+    // insert by descending effect time
+    uint8_t c = numCandidates++;
+    while (c && _segment_runtimes[candidates[c-1]].renderUs < env.renderUs) { candidates[c] = candidates[c-1]; c--; }
+    candidates[c] = i;
+  }
+
+  uint32_t workerUs = 0;
+  _workerSegmentCount = 0;
+  for (uint8_t c = 0; c < numCandidates; c++) {
+    uint8_t i = candidates[c];
+    segment_runtime& env = _segment_runtimes[i];
+    if (workerUs >= mainUs) { mainUs += env.renderUs; continue; }
+    _workerSegments[_workerSegmentCount++] = i;
+    workerUs += env.renderUs;
+    workerMask |= 1ULL << i;
+    uint16_t segFrametime = _segments[i].fps ? 1000 / _segments[i].fps : FRAMETIME;
+    if (env.next_time && nowUp - env.next_time > segFrametime && env.missedFrames < UINT16_MAX) env.missedFrames++;
+  }
+  if (!_workerSegmentCount) return 0;
+  _workerNowUp = nowUp;
+  xTaskNotifyGive(_workerTask);
+  return _workerSegmentCount;
+}
+
+void WS2812FX::renderWorker(void* parameter)
+{
+  WS2812FX* fx = (WS2812FX*)parameter;
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    for (uint8_t k = 0; k < fx->_workerSegmentCount; k++) {
+      fx->renderSegment(fx->_workerSegments[k], fx->_workerNowUp, true, false, true);
+    }
+    fx->RCTX.vLength = 0; // this is the worker's context
+    fx->RCTX.vWidth = 0;
+    xTaskNotifyGive(fx->_serviceTask);
+  }
+}
+#endif
+
+#ifdef WLED_ENABLE_BENCHMARK
+/*
+ * Renders each of the given effects for a number of frames on a scratch segment covering the first length LEDs
+ * (default speed, intensity, colors and palette, no grouping, mirror or 2D), optionally showing each frame.
+ * The scratch segment takes a free segment slot and is not in the active list, so the configured segments stay
+ * untouched and are redrawn afterwards. Effect time advances by one frame time per call.
+ * Must be called from the main loop, between frames. Returns false if there is no free segment slot.
+ */
+bool WS2812FX::benchmark(const uint8_t* modes, uint8_t count, uint16_t frames, uint16_t length, bool output, bench_result* results)
+{
+  uint8_t slot = 0;
+  for (uint8_t i = MAX_NUM_SEGMENTS - 1; i > 0; i--) {
+    if (!_segments[i].isActive() && !((_segmentsToRelease >> i) & 1)) { slot = i; break; }
+  }
+  if (!slot) return false;
+  if (!length || length > _length) length = _length;
+
+  Segment saved = _segments[slot];
+  Segment& seg = _segments[slot];
+  memset(&seg, 0, sizeof(seg));
+  seg.stop = length;
+  seg.grouping = 1;
+  seg.speed = DEFAULT_SPEED;
+  seg.intensity = DEFAULT_INTENSITY;
+  seg.colors[0] = DEFAULT_COLOR;
+  seg.opacity = 255;
+  seg.cct = 127;
+  seg.setOption(SEG_OPTION_ON, true);
+  segment_runtime& env = _segment_runtimes[slot];
+  uint8_t  oldSeg = RCTX.segIndex;
+  uint32_t oldNow = now;
+
+  for (uint8_t n = 0; n < count; n++) {
+    bench_result& r = results[n];
+    r.mode = modes[n];
+    r.fxUs = r.showUs = 0;
+    r.heap = 0;
+    if (r.mode >= MODE_COUNT) continue;
+    RCTX.segIndex = slot;
+    seg.mode = r.mode;
+    env.markForReset();
+    env.resetIfRequired();
+    int32_t heapBefore = ESP.getFreeHeap();
+    RCTX.vLength = seg.virtualLength();
+    RCTX.vWidth = seg.virtualWidth();
+    RCTX.bri = 255;
+    for (uint8_t c = 0; c < NUM_COLORS; c++) RCTX.colors[c] = gamma32(seg.colors[c]);
+    RCTX.noRgb = false;
+    handle_palette();
+    #ifdef WLED_USE_SEGMENT_BUFFERS
+    env.allocatePixels(RCTX.vLength);
+    env.pixelsCCT = -1;
+    #endif
+    selectPixelWriter();
+    uint32_t fxUs = 0, showUs = 0;
+    for (uint16_t f = 0; f < frames; f++) {
+      now += FRAMETIME;
+      RCTX.deltaMs = env.advanceTime(now);
+      uint32_t start = micros();
+      (this->*_mode[r.mode])();
+      fxUs += micros() - start;
+      if (r.mode != FX_MODE_HALLOWEEN_EYES) env.call++;
+      if (output) {
+        while (!busses.canAllShow()) yield(); // the previous frame is still on the wire
+        start = micros();
+        #ifdef WLED_USE_SEGMENT_BUFFERS
+        if (env.pixels) composeSegment(slot);
+        busses.setSegmentCCT(-1);
+        #endif
+        show();
+        showUs += micros() - start;
+      }
+      yield();
+    }
+    r.heap = heapBefore - (int32_t)ESP.getFreeHeap();
+    r.fxUs = frames ? fxUs / frames : 0;
+    r.showUs = frames ? showUs / frames : 0;
+  }
+
+  RCTX.vLength = 0;
+  RCTX.vWidth = 0;
+  RCTX.segIndex = oldSeg;
+  _segments[slot] = saved; // inactive again
+  env.markForReset();
+  releaseSegment(slot);
+  now = oldNow;
+  _triggered = true; // redraw the configured segments
+  return true;
+}
+#endif
+
+#ifdef WLED_ENABLE_BAKE
+void WS2812FX::writePixelBake(uint16_t i, uint32_t col)
+{
+  if (i < RCTX.vLength) _bakeFrame[i] = col;
+  (this->*_bakeWriter)(i, col);
+}
+
+/*
+ * Renders the effect of the main segment with its current settings for a number of frames and writes them
+ * to /anim<file>.wla, to be played by FX_MODE_PLAYBACK on nodes too slow to compute the effect.
+ * Effect time advances by frameMs per frame and the effect is called when its returned delay has passed,
+ * as in service(). The colors are recorded before segment opacity. Nothing is shown during the run and the
+ * effect restarts afterwards. Must be called from the main loop, between frames.
+ * Returns the size of the file written, 0 on failure (no space, file system or memory).
+ */
+uint32_t WS2812FX::bake(uint8_t file, uint16_t frames, uint16_t frameMs)
+{
+  RCTX.segIndex = getMainSegmentId();
+  if (!SEGMENT.isActive() || !frames || !frameMs) return 0;
+  if (SEGMENT.grouping == 0) SEGMENT.grouping = 1; //sanity check
+  uint16_t len = SEGMENT.virtualLength();
+  uint8_t  bpp = _hasWhiteChannel ? 4 : 3;
+  uint32_t size = ANIM_HEADER + (uint32_t)frames * len * bpp;
+  if (!len) return 0;
+
+  char name[16];
+  snprintf_P(name, sizeof(name), PSTR("/anim%u.wla"), file);
+  updateFSInfo();
+  size_t avail = fsBytesTotal - fsBytesUsed;
+  if (WLED_FS.exists(name)) {
+    File old = WLED_FS.open(name, "r");
+    avail += old.size();
+  }
+  if (size + 4096 > avail) return 0; //keep some blocks for cfg.json and presets
+  _bakeFrame = (uint32_t*)malloc(len * (sizeof(uint32_t) + bpp));
+  if (!_bakeFrame) return 0;
+  memset(_bakeFrame, 0, len * sizeof(uint32_t));
+  uint8_t* row = (uint8_t*)(_bakeFrame + len);
+  File f = WLED_FS.open(name, "w");
+  uint8_t h[ANIM_HEADER] = {'W','L','A',1, bpp, 0, uint8_t(len), uint8_t(len >> 8), uint8_t(frames), uint8_t(frames >> 8), 0, 0,
+                            uint8_t(frameMs), uint8_t(frameMs >> 8), 0, 0};
+  bool ok = f && f.write(h, ANIM_HEADER) == ANIM_HEADER;
+
+  uint32_t oldNow = now;
+  #ifdef WLED_USE_SEGMENT_MAPS
+  if (!SEGENV.mapMatches(SEGMENT, _ledmapVersion)) buildSegmentMap(RCTX.segIndex);
+  #endif
+  RCTX.vLength = len;
+  RCTX.vWidth = SEGMENT.virtualWidth();
+  RCTX.bri = SEGMENT.opacity;
+  for (uint8_t c = 0; c < NUM_COLORS; c++) RCTX.colors[c] = gamma32(SEGMENT.colors[c]);
+  SEGENV.markForReset();
+  SEGENV.resetIfRequired();
+  handle_palette();
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  SEGENV.allocatePixels(len);
+  #endif
+  selectPixelWriter();
+  _bakeWriter = RCTX.pixelWriter;
+  RCTX.pixelWriter = &WS2812FX::writePixelBake;
+
+  uint32_t due = now;
+  injectFrameClock(true, millis(), micros()); // effects timed by uptime advance with the frames too
+  for (uint16_t n = 0; n < frames && ok; n++) {
+    if ((int32_t)(now - due) >= 0) {
+      RCTX.deltaMs = SEGENV.advanceTime(now);
+      due = now + (this->*_mode[SEGMENT.mode])();
+      if (SEGMENT.mode != FX_MODE_HALLOWEEN_EYES) SEGENV.call++;
+    }
+    uint8_t* p = row;
+    for (uint16_t i = 0; i < len; i++) {
+      uint32_t c = _bakeFrame[i];
+      *p++ = R(c); *p++ = G(c); *p++ = B(c);
+      if (bpp == 4) *p++ = W(c);
+    }
+    ok = f.write(row, len * bpp) == len * bpp;
+    now += frameMs;
+    _frameMs += frameMs;
+    _frameUs += frameMs * 1000U;
+    yield();
+  }
+  injectFrameClock(false);
+
+  RCTX.pixelWriter = _bakeWriter;
+  RCTX.vLength = 0;
+  RCTX.vWidth = 0;
+  SEGENV.markForReset();
+  now = oldNow;
+  _triggered = true; // redraw the segment
+  free(_bakeFrame);
+  _bakeFrame = nullptr;
+  if (f) f.close();
+  if (!ok) WLED_FS.remove(name);
+  invalidateFSInfo();
+  return ok ? size : 0;
+}
+#endif
+
+void IRAM_ATTR WS2812FX::setPixelColor(pixidx_t i, byte r, byte g, byte b, byte w)
+{
   if (SEGLEN) { // SEGLEN!=0 -> from segment/FX
-    //color_blend(getpixel, col, _bri_t); (pseudocode for future blending of segments)
-    if (_bri_t < 255) {  
-      r = scale8(r, _bri_t);
-      g = scale8(g, _bri_t);
-      b = scale8(b, _bri_t);
-      w = scale8(w, _bri_t);
-    }
-    segIdx = _segment_index;
-  } else // from live/realtime
-    segIdx = _mainSegment;
-
-  if (SEGLEN || (realtimeMode && useMainSegmentOnly)) {
+    //color_blend(getpixel, col, RCTX.bri); (pseudocode for future blending of segments)
+    (this->*RCTX.pixelWriter)(i, RGBW32(r, g, b, w));
+    return;
+  }
+
+  // from live/realtime
+  if (realtimeMode && hasLiveSegments()) {
     uint32_t col = RGBW32(r, g, b, w);
-    uint16_t len = _segments[segIdx].length();
+    writeLiveLayer(i, 1, &col);
+  } else {
+    busses.setPixelColor(mapPixel(i), RGBW32(r, g, b, w));
+  }
+}
+
+extern byte gammaT[]; //see gamma8()
+
+/*
+ * Bulk counterpart of setPixelColor() for live/realtime data. Converts count packed R,G,B(,W) pixels,
+ * stride bytes apart (W is read if stride > 3), and hands contiguous spans to the busses.
+ * n + count must not exceed getLengthTotal().
+ */
+void WS2812FX::setRealtimePixels(pixidx_t n, uint16_t count, const uint8_t* data, uint8_t stride, bool gamma)
+{
+  uint32_t cols[64];
+  while (count) {
+    uint16_t len = count < 64 ? count : 64;
+    if (gamma) {
+      for (uint16_t k = 0; k < len; k++, data += stride)
+        cols[k] = RGBW32(gammaT[data[0]], gammaT[data[1]], gammaT[data[2]], stride > 3 ? gammaT[data[3]] : 0);
+    } else {
+      for (uint16_t k = 0; k < len; k++, data += stride)
+        cols[k] = RGBW32(data[0], data[1], data[2], stride > 3 ? data[3] : 0);
+    }
+    if (realtimeMode && hasLiveSegments()) {
+      writeLiveLayer(n, len, cols);
+    } else {
+      writeMappedPixels(n, len, cols);
+    }
+    n += len; count -= len;
+  }
+}
+
+//writes count colors to the strip pixels from n on, through the ledmap where it covers them
+void WS2812FX::writeMappedPixels(pixidx_t n, uint16_t count, const uint32_t* cols)
+{
+  pixidx_t mapEnd = customMappingStart + customMappingSize;
+  uint16_t k = 0;
+  if (n < customMappingStart) {
+    k = MIN(count, customMappingStart - n);
+    busses.setPixelColors(n, k, cols);
+  }
+  for (; k < count && n + k < mapEnd; k++) busses.setPixelColor(customMappingTable[n + k - customMappingStart], cols[k]);
+  if (k < count) busses.setPixelColors(n + k, count - k, cols + k);
+}
+
+bool WS2812FX::isLiveSegment(uint8_t n)
+{
+  if (n >= MAX_NUM_SEGMENTS || !_segments[n].isActive()) return false;
+  return _segments[n].live || (useMainSegmentOnly && n == _mainSegment);
+}
+
+// realtime data goes to the live segments instead of the whole strip, effects keep running on the others
+bool WS2812FX::hasLiveSegments()
+{
+  if (useMainSegmentOnly) return true;
+  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) if (isLiveSegment(i)) return true;
+  return false;
+}
+
+// freezes the effects of the live segments while realtime data is shown, clear: blank them
+void WS2812FX::freezeLiveSegments(bool freeze, bool clear)
+{
+  for (uint8_t s = 0; s < MAX_NUM_SEGMENTS; s++) {
+    if (!isLiveSegment(s)) continue;
+    _segments[s].setOption(SEG_OPTION_FREEZE, freeze, s);
+    if (!clear) continue;
+    #ifdef WLED_USE_SEGMENT_BUFFERS
+    segment_runtime &env = _segment_runtimes[s];
+    if (env.pixels) {
+      memset(env.pixels, 0, env.pixelsLength() * sizeof(uint32_t));
+      env.pixelsChanged = _liveChanged = true;
+      continue;
+    }
+    #endif
+    for (uint16_t i = 0; i < _segments[s].virtualLength(); i++) setPixelColorInSegment(s, i, 0);
+  }
+}
+
+/*
+ * Realtime data as a layer: the live segments (ID order) take consecutive ranges of the stream, stream pixel n
+ * being virtual pixel n of the first one. Into a segment buffer it is a plain copy, composed (and blended, see
+ * setSegmentLayer()) with the effects of the other segments by show(). Without a buffer it is mapped pixel by pixel.
+ */
+void WS2812FX::writeLiveLayer(pixidx_t n, uint16_t count, const uint32_t* cols)
+{
+  pixidx_t base = 0;
+  for (uint8_t s = 0; s < MAX_NUM_SEGMENTS && count; s++) {
+    if (!isLiveSegment(s)) continue;
+    uint16_t vLen = _segments[s].virtualLength();
+    if (n < base + vLen) {
+      uint16_t i = n - base;
+      uint16_t len = MIN(count, (uint16_t)(vLen - i));
+      #ifdef WLED_USE_SEGMENT_BUFFERS
+      segment_runtime &env = _segment_runtimes[s];
+      if (env.pixels && env.pixelsLength() == vLen) {
+        env.unrotatePixels(); // frozen effect may have scrolled
+        memcpy(env.pixels + i, cols, len * sizeof(uint32_t));
+        env.pixelsChanged = _liveChanged = true;
+        env.pixelsCCT = -1;
+      } else
+      #endif
+      for (uint16_t k = 0; k < len; k++) setPixelColorInSegment(s, i + k, cols[k]);
+      n += len; cols += len; count -= len;
+    }
+    base += vLen;
+  }
+}
+
+// any segment configuration
+template<bool SCALE> void IRAM_ATTR WS2812FX::writePixelSegment(uint16_t i, uint32_t col)
+{
+  if (SCALE) col = scalePacked(col, RCTX.bri);
+  setPixelColorInSegment(RCTX.segIndex, i, col);
+}
+
+// no grouping, spacing, offset, reverse or mirror
+template<bool SCALE> void IRAM_ATTR WS2812FX::writePixelPlain(uint16_t i, uint32_t col)
+{
+  pixidx_t index = SEGMENT.start + i;
+  if (index >= SEGMENT.stop) return;
+  if (SCALE) col = scalePacked(col, RCTX.bri);
+  index = mapPixel(index);
+  busses.setPixelColor(index, col);
+}
+
+// reverse only
+template<bool SCALE> void IRAM_ATTR WS2812FX::writePixelReversed(uint16_t i, uint32_t col)
+{
+  if (i >= SEGMENT.length()) return;
+  pixidx_t index = SEGMENT.stop - 1 - i;
+  if (SCALE) col = scalePacked(col, RCTX.bri);
+  index = mapPixel(index);
+  busses.setPixelColor(index, col);
+}
+
+#ifdef WLED_USE_SEGMENT_MAPS
+// precomputed physical pixels
+template<bool SCALE> void IRAM_ATTR WS2812FX::writePixelMapped(uint16_t i, uint32_t col)
+{
+  if (i >= SEGENV.mapLength()) return;
+  if (SCALE) col = scalePacked(col, RCTX.bri);
+  uint16_t stride = SEGENV.mapStride();
+  const pixidx_t* m = SEGENV.map + i * stride;
+  for (uint16_t k = 0; k < stride; k++) {
+    if (m[k] != PIXIDX_NONE) busses.setPixelColor(m[k], col);
+  }
+}
+#endif
+
+#ifdef WLED_USE_SEGMENT_BUFFERS
+// render into segment buffer, mapped to physical pixels in composeSegments()
+template<bool SCALE> void IRAM_ATTR WS2812FX::writePixelBuffer(uint16_t i, uint32_t col)
+{
+  if (i >= SEGENV.pixelsLength()) return;
+  if (SCALE) col = scalePacked(col, RCTX.bri);
+  SEGENV.pixels[SEGENV.pixelIndex(i)] = col;
+  SEGENV.pixelsChanged = true;
+}
+#endif
+
+/*
+ * Picks the pixel writer for the current segment, so segment options and opacity are evaluated once per effect call.
+ * Must be called again whenever segment options, RCTX.bri, the segment buffer or map change.
+ */
+void WS2812FX::selectPixelWriter(void)
+{
+  bool scale = RCTX.bri < 255;
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  if (SEGENV.pixels) {
+    RCTX.pixelWriter = scale ? &WS2812FX::writePixelBuffer<true> : &WS2812FX::writePixelBuffer<false>;
+    return;
+  }
+  #endif
+  #ifdef WLED_USE_SEGMENT_MAPS
+  if (SEGENV.map) {
+    RCTX.pixelWriter = scale ? &WS2812FX::writePixelMapped<true> : &WS2812FX::writePixelMapped<false>;
+    return;
+  }
+  #endif
+  if (SEGMENT.groupLength() == 1 && !SEGMENT.offset && !(SEGMENT.options & MIRROR) && !SEGMENT.is2D()) {
+    if (SEGMENT.options & REVERSE) RCTX.pixelWriter = scale ? &WS2812FX::writePixelReversed<true> : &WS2812FX::writePixelReversed<false>;
+    else                           RCTX.pixelWriter = scale ? &WS2812FX::writePixelPlain<true>    : &WS2812FX::writePixelPlain<false>;
+    return;
+  }
+  RCTX.pixelWriter = scale ? &WS2812FX::writePixelSegment<true> : &WS2812FX::writePixelSegment<false>;
+}
+
+// sets virtual pixel i of segment segIdx on the busses
+// a physical pixel of a segment, to the busses or, while composeLayers() runs, blended into the layer frame
+inline void WS2812FX::writePhysical(pixidx_t i, uint32_t col)
+{
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  if (_layerTarget) { blendIntoLayers(i, col); return; }
+  #endif
+  busses.setPixelColor(i, col);
+}
+
+void IRAM_ATTR WS2812FX::setPixelColorInSegment(uint8_t segIdx, uint16_t i, uint32_t col)
+{
+  #ifdef WLED_USE_SEGMENT_MAPS
+  segment_runtime &env = _segment_runtimes[segIdx];
+  if (env.map) {
+    if (i >= env.mapLength()) return;
+    uint16_t stride = env.mapStride();
+    const pixidx_t* m = env.map + i * stride;
+    for (uint16_t k = 0; k < stride; k++) {
+      if (m[k] != PIXIDX_NONE) writePhysical(m[k], col);
+    }
+    return;
+  }
+  #endif
+
+  uint16_t len = _segments[segIdx].length();
+
+  // get physical pixel address (taking into account 2D layout, start, grouping, spacing [and offset])
+  pixidx_t p = _segments[segIdx].map2D(i) * _segments[segIdx].groupLength();
+  if (_segments[segIdx].options & REVERSE) { // is segment reversed?
+    if (_segments[segIdx].options & MIRROR) { // is segment mirrored?
+      p = (len - 1) / 2 - p;  //only need to index half the pixels
+    } else {
+      p = (len - 1) - p;
+    }
+  }
+  p += _segments[segIdx].start;
+
+  // set all the pixels in the group
+  for (uint16_t j = 0; j < _segments[segIdx].grouping; j++) {
+    pixidx_t indexSet = p + ((_segments[segIdx].options & REVERSE) ? -j : j);
+    if (indexSet >= _segments[segIdx].start && indexSet < _segments[segIdx].stop) {
+
+      if (_segments[segIdx].options & MIRROR) { //set the corresponding mirrored pixel
+        pixidx_t indexMir = _segments[segIdx].stop - indexSet + _segments[segIdx].start - 1;          
+        indexMir += _segments[segIdx].offset; // offset/phase
+
+        if (indexMir >= _segments[segIdx].stop) indexMir -= len;
+        indexMir = mapPixel(indexMir);
+
+        writePhysical(indexMir, col);
+      }
+      indexSet += _segments[segIdx].offset; // offset/phase
 
-    // get physical pixel address (taking into account start, grouping, spacing [and offset])
-    i = i * _segments[segIdx].groupLength();
-    if (_segments[segIdx].options & REVERSE) { // is segment reversed?
-      if (_segments[segIdx].options & MIRROR) { // is segment mirrored?
-        i = (len - 1) / 2 - i;  //only need to index half the pixels
+      if (indexSet >= _segments[segIdx].stop) indexSet -= len;
+      indexSet = mapPixel(indexSet);
+
+      writePhysical(indexSet, col);
+    }
+  }
+}
+
+#ifdef WLED_USE_SEGMENT_MAPS
+/*
+ * Precomputes the physical pixel indices setPixelColorInSegment() would calculate for segment n,
+ * so 2D segments cost the same per pixel as 1D ones.
+ * The segments linked to n follow its own pixels in ID order, so its effect runs once over all of them.
+ * Called from service() whenever the segment geometry, ledmap or links changed.
+ */
+void WS2812FX::buildSegmentMap(uint8_t n)
+{
+  Segment& seg = _segments[n];
+  segment_runtime& env = _segment_runtimes[n];
+  if (seg.grouping == 0) seg.grouping = 1; //sanity check
+  uint16_t vLen = seg.virtualLength();
+  uint16_t stride = seg.grouping << bool(seg.options & MIRROR);
+  uint8_t followers = 0;
+  for (uint8_t f = 0; f < MAX_NUM_SEGMENTS; f++) {
+    if (_segments[f].link != n + 1 || !isLinkedSegment(f)) continue;
+    if (_segments[f].grouping == 0) _segments[f].grouping = 1;
+    uint16_t fLen = _segments[f].virtualLength();
+    if (vLen + fLen > UINT16_MAX) break;
+    vLen += fLen;
+    stride = MAX(stride, _segments[f].grouping << bool(_segments[f].options & MIRROR));
+    followers++;
+  }
+  uint16_t oldLen = env.map ? env.mapLength() : seg.virtualLength();
+  if (!env.allocateMap(seg, _ledmapVersion, vLen, stride)) return; //calculate on the fly
+  pixidx_t* m = fillSegmentMap(seg, env.map, stride);
+  for (uint8_t f = 0; f < MAX_NUM_SEGMENTS && followers; f++) {
+    if (_segments[f].link != n + 1 || !isLinkedSegment(f)) continue;
+    m = fillSegmentMap(_segments[f], m, stride);
+    followers--;
+  }
+  if (vLen != oldLen) { // the effect length changed with the links, restart it before its data is used
+    env.markForReset();
+    env.resetIfRequired();
+  }
+}
+
+// writes the stride entries of each virtual pixel of seg from m on, returns the entry after its last pixel
+pixidx_t* WS2812FX::fillSegmentMap(Segment& seg, pixidx_t* m, uint16_t stride)
+{
+  bool reverse = seg.options & REVERSE;
+  bool mirror  = seg.options & MIRROR;
+  uint16_t vLen = seg.virtualLength();
+  uint16_t len = seg.length();
+  uint16_t pad = stride - (seg.grouping << mirror);
+
+  for (uint16_t v = 0; v < vLen; v++) {
+    pixidx_t i = seg.map2D(v) * seg.groupLength();
+    if (reverse) i = mirror ? (len - 1) / 2 - i : (len - 1) - i;
+    i += seg.start;
+
+    for (uint16_t j = 0; j < seg.grouping; j++) {
+      pixidx_t indexSet = i + (reverse ? -j : j);
+      pixidx_t indexMir = PIXIDX_NONE;
+      if (indexSet >= seg.start && indexSet < seg.stop) {
+        if (mirror) {
+          indexMir = seg.stop - indexSet + seg.start - 1;
+          indexMir += seg.offset;
+          if (indexMir >= seg.stop) indexMir -= len;
+          indexMir = mapPixel(indexMir);
+        }
+        indexSet += seg.offset;
+        if (indexSet >= seg.stop) indexSet -= len;
+        indexSet = mapPixel(indexSet);
       } else {
-        i = (len - 1) - i;
+        indexSet = PIXIDX_NONE;
       }
+      *m++ = indexSet;
+      if (mirror) *m++ = indexMir;
     }
-    i += _segments[segIdx].start;
+    for (uint16_t k = 0; k < pad; k++) *m++ = PIXIDX_NONE;
+  }
+  return m;
+}
+#endif
 
-    // set all the pixels in the group
-    for (uint16_t j = 0; j < _segments[segIdx].grouping; j++) {
-      uint16_t indexSet = i + ((_segments[segIdx].options & REVERSE) ? -j : j);
-      if (indexSet >= _segments[segIdx].start && indexSet < _segments[segIdx].stop) {
+#ifdef WLED_USE_SEGMENT_BUFFERS
+/*
+ * Maps the render buffers of all segments that changed since the last frame to physical pixels.
+ * Segments are composited in ascending order, so overlapping segments behave as with direct rendering.
+ */
+#ifdef WLED_USE_EFFECT_TRANSITIONS
+// renders the outgoing effect of the current segment into its own buffer if it is due
+void WS2812FX::renderOutgoingEffect(uint32_t nowUp)
+{
+  if (!SEGENV.pixels) { // new effect renders directly, nothing to blend with
+    SEGENV.endEffectTransition();
+    return;
+  }
+  SEGENV.pixelsChanged = true; // blend progresses every frame
+  if (nowUp <= SEGENV.fxTransition->next_time) return;
+
+  uint8_t newMode = SEGMENT.mode;
+  uint8_t oldMode = SEGENV.fxTransition->mode;
+  SEGENV.swapEffectState();
+  if (SEGENV.allocatePixels(RCTX.vLength)) {
+    SEGMENT.mode = oldMode;
+    RCTX.deltaMs = SEGENV.advanceTime(now);
+    uint16_t delay = (this->*_mode[oldMode])();
+    if (oldMode != FX_MODE_HALLOWEEN_EYES) SEGENV.call++;
+    SEGENV.next_time = nowUp + delay;
+    SEGMENT.mode = newMode;
+    SEGENV.unrotatePixels(); // blended in order by composeSegment()
+  }
+  SEGENV.swapEffectState();
+  if (!SEGENV.fxTransition->pixels) SEGENV.endEffectTransition(); // outgoing buffer lost, cut
+}
+#endif
 
-        if (_segments[segIdx].options & MIRROR) { //set the corresponding mirrored pixel
-          uint16_t indexMir = _segments[segIdx].stop - indexSet + _segments[segIdx].start - 1;          
-          indexMir += _segments[segIdx].offset; // offset/phase
+// perFrame per FRAMETIME_FIXED of effect time, summed over the calls it is exact, so there is no drift at any frame rate
+int32_t WS2812FX::frameStep(int32_t perFrame)
+{
+  uint32_t e = SEGENV.elapsed;
+  return (int64_t)perFrame * e / FRAMETIME_FIXED - (int64_t)perFrame * (e - RCTX.deltaMs) / FRAMETIME_FIXED;
+}
 
-          if (indexMir >= _segments[segIdx].stop) indexMir -= len;
-          if (indexMir < customMappingSize) indexMir = customMappingTable[indexMir];
+// virtual pixel i of a segment rendered at 1 of (1 << shift) pixels, linear between the rendered pixels
+static inline uint32_t upscalePixel(const uint32_t* px, uint16_t len, uint16_t i, uint8_t shift)
+{
+  uint16_t j = i >> shift;
+  if (j >= len) return px[len - 1];
+  uint8_t frac = (i << (8 - shift)) & 0xFF;
+  if (!frac || j + 1 >= len) return px[j];
+  return blendPacked(px[j], px[j + 1], frac);
+}
 
-          busses.setPixelColor(indexMir, col);
-        }
-        indexSet += _segments[segIdx].offset; // offset/phase
+void WS2812FX::composeSegments()
+{
+  if (_layered && composeLayers()) return;
+  // an unchanged segment is skipped unless a segment below it (lower ID) was written over its pixels again.
+  // lo..hi spans the strip pixels written so far
+  pixidx_t lo = 0, hi = 0;
+  for (uint8_t k = 0; k < _activeSegmentCount; k++) {
+    uint8_t s = _activeSegments[k];
+    segment_runtime &env = _segment_runtimes[getInstanceSource(s)];
+    if (!env.pixels || !_segments[s].isActive()) continue;
+    pixidx_t start, stop;
+    composeExtent(s, start, stop);
+    if (!env.pixelsChanged && (stop <= lo || start >= hi)) continue;
+    composeSegment(s);
+    if (lo == hi) { lo = start; hi = stop; }
+    else { lo = MIN(lo, start); hi = MAX(hi, stop); }
+  }
+  for (uint8_t k = 0; k < _activeSegmentCount; k++) _segment_runtimes[_activeSegments[k]].pixelsChanged = false; // after all instances
+  busses.setSegmentCCT(-1);
+}
+
+// strip pixels composeSegment(s) writes, the range of s and of the segments linked to it
+void WS2812FX::composeExtent(uint8_t s, pixidx_t &lo, pixidx_t &hi)
+{
+  lo = _segments[s].start;
+  hi = _segments[s].stop;
+  #ifdef WLED_USE_SEGMENT_MAPS
+  if (getLinkedLength(s) <= _segments[s].virtualLength()) return;
+  for (uint8_t f = 0; f < MAX_NUM_SEGMENTS; f++) {
+    if (_segments[f].link != s + 1 || !isLinkedSegment(f)) continue;
+    lo = MIN(lo, _segments[f].start);
+    hi = MAX(hi, _segments[f].stop);
+  }
+  #endif
+}
+
+// channel-wise blend of a pixel of a higher layer (over) onto the layers below (under)
+static uint32_t blendLayer(uint32_t under, uint32_t over, uint8_t mode)
+{
+  if (mode == SEG_BLEND_NORMAL) return over;
+  uint32_t out = 0;
+  for (uint8_t shift = 0; shift < 32; shift += 8) {
+    uint16_t u = (under >> shift) & 0xFF, o = (over >> shift) & 0xFF, c;
+    switch (mode) {
+      case SEG_BLEND_ADD:      c = u + o; if (c > 255) c = 255; break;
+      case SEG_BLEND_MULTIPLY: c = (u * o + 255) >> 8; break;
+      case SEG_BLEND_SCREEN:   c = 255 - (((255 - u) * (255 - o) + 255) >> 8); break;
+      default:                 c = u > o ? u : o; break; // SEG_BLEND_MAX
+    }
+    out |= (uint32_t)c << shift;
+  }
+  return out;
+}
+
+// the first layer covering a pixel is taken as is, the ones above are blended onto it
+void IRAM_ATTR WS2812FX::blendIntoLayers(pixidx_t i, uint32_t col)
+{
+  if (i >= _layerFrameLen) return;
+  uint8_t* covered = (uint8_t*)(_layerFrame + _layerFrameLen);
+  uint8_t bit = 1 << (i & 7);
+  if (covered[i >> 3] & bit) col = blendLayer(_layerFrame[i], col, _layerBlend);
+  covered[i >> 3] |= bit;
+  _layerFrame[i] = col;
+}
+
+// composes all segment buffers by layer into one frame, then writes the pixels they cover to the busses in one pass.
+// false without memory for the frame, the segments are then written in ID order
+bool WS2812FX::composeLayers()
+{
+  bool changed = false;
+  for (uint8_t k = 0; k < _activeSegmentCount; k++) {
+    segment_runtime &env = _segment_runtimes[getInstanceSource(_activeSegments[k])];
+    if (env.pixels && env.pixelsChanged) changed = true;
+  }
+  if (!changed) return true;
+  pixidx_t total = getLengthTotal();
+  if (_layerFrameLen != total) {
+    free(_layerFrame);
+    _layerFrame = (uint32_t*) wledAlloc(total * sizeof(uint32_t) + (total + 7) / 8, ALLOC_HOT);
+    _layerFrameLen = _layerFrame ? total : 0;
+    if (!_layerFrame) { memAllocFailed(MEM_SEGMENTS); return false; }
+  }
+  uint8_t* covered = (uint8_t*)(_layerFrame + total);
+  memset(covered, 0, (total + 7) / 8);
+
+  _layerTarget = true;
+  for (uint8_t k = 0; k < _activeSegmentCount; k++) {
+    uint8_t s = _layerOrder[k];
+    segment_runtime &env = _segment_runtimes[getInstanceSource(s)];
+    if (!env.pixels) continue; // rendered to the busses directly
+    env.pixelsChanged = false;
+    _layerBlend = _segments[s].blendMode;
+    composeSegment(s);
+  }
+  _layerTarget = false;
+  busses.setSegmentCCT(-1);
 
-        if (indexSet >= _segments[segIdx].stop) indexSet -= len;
-        if (indexSet < customMappingSize) indexSet = customMappingTable[indexSet];
+  for (pixidx_t i = 0; i < total;) {
+    if (!(covered[i >> 3] & (1 << (i & 7)))) { i++; continue; }
+    uint16_t n = 1;
+    while (i + n < total && n < UINT16_MAX && (covered[(i + n) >> 3] & (1 << ((i + n) & 7)))) n++;
+    busses.setPixelColors(i, n, _layerFrame + i);
+    i += n;
+  }
+  return true;
+}
 
-        busses.setPixelColor(indexSet, col);
+// writes the buffer of segment s (of its prototype for an instance) to the busses
+void WS2812FX::composeSegment(uint8_t s)
+{
+  uint8_t src = getInstanceSource(s);
+  segment_runtime &env = _segment_runtimes[src];
+  Segment& seg = _segments[s];
+  Segment& proto = _segments[src];
+  uint16_t vLen = MIN(src == s ? getLinkedLength(s) : seg.virtualLength(), env.pixelsLength());
+  bool linked = vLen > seg.virtualLength(); // continues over the segments linked to s
+  uint8_t shift = 0; // rendered at reduced resolution
+  if (proto.renderScale && env.pixelsLength() == proto.renderLength() && vLen < seg.virtualLength()) {
+    shift = proto.renderScale;
+    vLen = MIN(seg.virtualLength(), proto.virtualLength());
+  }
+  busses.setSegmentCCT(env.pixelsCCT, correctWB); // CCT and white balance are applied by the busses on output
+  #ifdef WLED_USE_EFFECT_TRANSITIONS
+  if (env.fxTransition && env.fxTransition->pixels) {
+    env.unrotatePixels();
+    // crossfade from the outgoing to the incoming effect
+    int32_t since = uptimeMs() - env.fxTransition->start;
+    uint32_t elapsed = since > 0 ? since : 0; // started by a network callback during this frame
+    uint16_t progress = elapsed >= env.fxTransition->duration ? 0xFFFF : (elapsed * 0xFFFF) / env.fxTransition->duration;
+    uint16_t pLen = env.pixelsLength();
+    uint16_t oLen = MIN(pLen, env.fxTransition->pixelsLen);
+    for (uint16_t i = 0; i < vLen; i++) {
+      uint32_t c = upscalePixel(env.pixels, pLen, i, shift);
+      if ((i >> shift) < oLen) c = color_blend(upscalePixel(env.fxTransition->pixels, oLen, i, shift), c, progress, true);
+      setPixelColorInSegment(s, i, c);
+    }
+    return;
+  }
+  #endif
+  if (shift) {
+    env.unrotatePixels();
+    uint16_t pLen = env.pixelsLength();
+    if (!_layerTarget && seg.groupLength() == 1 && !seg.offset && !(seg.options & (REVERSE | MIRROR))) {
+      uint32_t span[32];
+      for (uint16_t i = 0; i < vLen;) {
+        uint16_t n = MIN(vLen - i, 32);
+        for (uint16_t k = 0; k < n; k++) span[k] = upscalePixel(env.pixels, pLen, i + k, shift);
+        writeMappedPixels(seg.start + i, n, span);
+        i += n;
       }
+      return;
     }
-  } else {
-    if (i < customMappingSize) i = customMappingTable[i];
-    busses.setPixelColor(i, RGBW32(r, g, b, w));
+    for (uint16_t i = 0; i < vLen; i++) setPixelColorInSegment(s, i, upscalePixel(env.pixels, pLen, i, shift));
+    return;
   }
+  if (!_layerTarget && !linked && seg.groupLength() == 1 && !seg.offset && !(seg.options & (REVERSE | MIRROR)) && !seg.is2D()) {
+    // 1:1 mapping (apart from the ledmap range), hand contiguous spans to the busses
+    for (uint16_t i = 0; i < vLen;) { // two pieces if scrolled, see scroll()
+      uint16_t j = env.pixelIndex(i);
+      uint16_t n = MIN(vLen - i, env.pixelsLength() - j);
+      writeMappedPixels(seg.start + i, n, env.pixels + j);
+      i += n;
+    }
+    return;
+  }
+  for (uint16_t i = 0; i < vLen; i++) setPixelColorInSegment(s, i, env.pixels[env.pixelIndex(i)]);
 }
+#endif
 
 
 //DISCLAIMER
@@ -263,6 +1306,7 @@ void WS2812FX::estimateCurrentAndLimitBri() {
   //each LED can draw up 195075 "power units" (approx. 53mA)
   //one PU is the power it takes to have 1 channel 1 step brighter per brightness step
   //so A=2,R=255,G=0,B=0 would use 510 PU per LED (1mA is about 3700 PU)
+  //busses on a power supply of their own (psu 1..WLED_MAX_PSU) are limited to its budget, independent of the others
   bool useWackyWS2815PowerModel = false;
   byte actualMilliampsPerLed = milliampsPerLed;
 
@@ -271,81 +1315,113 @@ void WS2812FX::estimateCurrentAndLimitBri() {
     actualMilliampsPerLed = 12; // from testing an actual strip
   }
 
-  if (ablMilliampsMax < 150 || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
+  bool limited = ablMilliampsMax >= 150;
+  for (uint8_t g = 0; g < WLED_MAX_PSU; g++) if (psuMilliampsMax[g] >= 150) limited = true;
+
+  if (!limited || actualMilliampsPerLed == 0) { //0 mA per LED and too low numbers turn off calculation
     currentMilliamps = 0;
+    for (uint8_t b = 0; b < busses.getNumBusses(); b++) busses.getBus(b)->setCurrent(0);
     busses.setBrightness(_brightness);
+    busses.setBrightnessFine(_brightnessFine);
     return;
   }
 
-  uint16_t pLen = getLengthPhysical();
   uint32_t puPerMilliamp = 195075 / actualMilliampsPerLed;
-  uint32_t powerBudget = (ablMilliampsMax - MA_FOR_ESP) * puPerMilliamp; //100mA for ESP power
-  if (powerBudget > puPerMilliamp * pLen) { //each LED uses about 1mA in standby, exclude that from power budget
-    powerBudget -= puPerMilliamp * pLen;
-  } else {
-    powerBudget = 0;
-  }
-
-  uint32_t powerSum = 0;
+  uint32_t busPowerSums[WLED_MAX_BUSSES] = {0};
+  uint32_t psuPowerSums[WLED_MAX_PSU +1] = {0}; //at full brightness, index 0 is the main supply
+  uint16_t psuLeds[WLED_MAX_PSU +1] = {0};
+  Bus::setPowerModel(useWackyWS2815PowerModel);
 
   for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
     Bus *bus = busses.getBus(b);
     if (bus->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-physical network busses
-    uint16_t len = bus->getLength();
-    uint32_t busPowerSum = 0;
-    for (uint16_t i = 0; i < len; i++) { //sum up the usage of each LED
-      uint32_t c = bus->getPixelColor(i);
-      byte r = R(c), g = G(c), b = B(c), w = W(c);
-
-      if(useWackyWS2815PowerModel) { //ignore white component on WS2815 power calculation
-        busPowerSum += (MAX(MAX(r,g),b)) * 3;
-      } else {
-        busPowerSum += (r + g + b + w);
-      }
-    }
+    uint32_t busPowerSum = bus->getPowerSum(); //sum up the usage of each LED (kept up to date by the bus if possible)
 
     if (bus->isRgbw()) { //RGBW led total output with white LEDs enabled is still 50mA, so each channel uses less
       busPowerSum *= 3;
       busPowerSum = busPowerSum >> 2; //same as /= 4
     }
-    powerSum += busPowerSum;
+    busPowerSums[b] = busPowerSum;
+    uint8_t g = bus->psu <= WLED_MAX_PSU ? bus->psu : 0;
+    psuPowerSums[g] += busPowerSum;
+    psuLeds[g] += bus->getLength();
   }
 
-  uint32_t powerSum0 = powerSum;
-  powerSum *= _brightness;
-  
-  if (powerSum > powerBudget) //scale brightness down to stay in current limit
-  {
-    float scale = (float)powerBudget / (float)powerSum;
-    uint16_t scaleI = scale * 255;
-    uint8_t scaleB = (scaleI > 255) ? 255 : scaleI;
-    uint8_t newBri = scale8(_brightness, scaleB);
-    busses.setBrightness(newBri); //to keep brightness uniform, sets virtual busses too
-    currentMilliamps = (powerSum0 * newBri) / puPerMilliamp;
-  } else {
-    currentMilliamps = powerSum / puPerMilliamp;
-    busses.setBrightness(_brightness);
+  //highest brightness within each budget, exact integer division instead of a rounded scale factor
+  uint8_t  psuBri[WLED_MAX_PSU +1];
+  uint16_t psuBriFine[WLED_MAX_PSU +1];
+  uint32_t milliamps = MA_FOR_ESP; //add power of ESP to estimate
+  for (uint8_t g = 0; g <= WLED_MAX_PSU; g++) {
+    psuBri[g] = _brightness;
+    psuBriFine[g] = _brightnessFine;
+    uint16_t maxMilliamps = g ? psuMilliampsMax[g-1] : ablMilliampsMax;
+    uint32_t reserved = psuLeds[g] + (g ? 0 : MA_FOR_ESP); //each LED uses about 1mA in standby, the ESP is on the main supply
+    if (maxMilliamps >= 150 && psuPowerSums[g]) {
+      uint64_t powerBudget = maxMilliamps > reserved ? (uint64_t)(maxMilliamps - reserved) * puPerMilliamp : 0;
+      uint64_t maxBri = powerBudget / psuPowerSums[g];
+      if (maxBri < _brightness) psuBri[g] = maxBri;
+      maxBri = powerBudget * 257 / psuPowerSums[g];
+      if (maxBri < _brightnessFine) psuBriFine[g] = maxBri;
+    }
+    milliamps += ((uint64_t)psuPowerSums[g] * psuBriFine[g]) / (257 * puPerMilliamp) + psuLeds[g]; //incl. standby power
+  }
+  currentMilliamps = milliamps > UINT16_MAX ? UINT16_MAX : milliamps;
+
+  busses.setBrightness(psuBri[0]); //virtual busses follow the main supply, to keep brightness uniform
+  busses.setBrightnessFine(psuBriFine[0]);
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
+    Bus *bus = busses.getBus(b);
+    if (bus->getType() >= TYPE_NET_DDP_RGB) { bus->setCurrent(0); continue; }
+    uint8_t g = bus->psu <= WLED_MAX_PSU ? bus->psu : 0;
+    if (g) {
+      bus->setBrightness(psuBri[g]);
+      bus->setBrightnessFine(psuBriFine[g]);
+    }
+    bus->setCurrent(((uint64_t)busPowerSums[b] * psuBriFine[g]) / (257 * puPerMilliamp) + bus->getLength()); //incl. standby power
   }
-  currentMilliamps += MA_FOR_ESP; //add power of ESP back to estimate
-  currentMilliamps += pLen; //add standby power back to estimate
 }
 
 void WS2812FX::show(void) {
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  if (_liveChanged) { // realtime data copied into live segment buffers since the last frame
+    _liveChanged = false;
+    composeSegments();
+  }
+  #endif
+
+  #ifdef WLED_ENABLE_FRAME_TIMER
+  _frameReady = false; // superseded by whatever is sent now
+  #endif
 
   // avoid race condition, caputre _callback value
   show_callback callback = _callback;
   if (callback) callback();
 
-  estimateCurrentAndLimitBri();
+  // power estimate only changes with the pixels or the limiter settings
+  uint64_t ablKey = _brightnessFine | ((uint32_t)milliampsPerLed << 16) | ((uint64_t)ablMilliampsMax << 24);
+  for (uint8_t g = 0; g < WLED_MAX_PSU; g++) ablKey ^= (uint64_t)psuMilliampsMax[g] << (40 + 6*g);
+  if (busses.isFrameChanged() || ablKey != _lastAblKey) {
+    PROFILE_START(ablStart);
+    estimateCurrentAndLimitBri();
+    PROFILE_STAGE(PROF_ABL, ablStart);
+  }
+  _lastAblKey = ablKey;
   
   // some buses send asynchronously and this method will return before
   // all of the data has been sent.
   // See https://github.com/Makuna/NeoPixelBus/wiki/ESP32-NeoMethods#neoesp32rmt-methods
+  PROFILE_START(showStart);
+  TRACE_START(traceStart);
   busses.show();
+  TRACE_SPAN(TRACE_SHOW, 0, traceStart);
+  PROFILE_STAGE(PROF_BUS_SHOW, showStart);
   unsigned long now = millis();
   unsigned long diff = now - _lastShow;
   uint16_t fpsCurr = 200;
   if (diff > 0) fpsCurr = 1000 / diff;
+  #ifdef WLED_ENABLE_METRICS
+  metricsFrame(diff);
+  #endif
   _cumulativeFps = (3 * _cumulativeFps + fpsCurr) >> 2;
   _lastShow = now;
 }
@@ -374,8 +1450,54 @@ uint8_t WS2812FX::getTargetFps() {
 void WS2812FX::setTargetFps(uint8_t fps) {
 	if (fps > 0 && fps <= 120) _targetFps = fps;
 	_frametime = 1000 / _targetFps;
+	#ifdef WLED_ENABLE_FRAME_TIMER
+	if (_frameTimer) {
+		_frameSlack = _frametime >> 1;
+		esp_timer_stop(_frameTimer);
+		esp_timer_start_periodic(_frameTimer, 1000000U / _targetFps);
+	}
+	#endif
+}
+
+#ifdef WLED_ENABLE_FRAME_TIMER
+// esp_timer callback, runs in the esp_timer task. Ticks while the render task is still busy merge into one
+static void frameTimerTick(void* tick) {
+  xSemaphoreGive((SemaphoreHandle_t)tick);
+}
+
+// called by the render task. Without the timer (out of memory) service() sends each frame itself as before
+void WS2812FX::startFrameTimer(void) {
+  if (_frameTimer) return;
+  if (!_frameTick) _frameTick = xSemaphoreCreateBinary();
+  if (!_frameTick) return;
+  esp_timer_create_args_t args = {};
+  args.callback = frameTimerTick;
+  args.arg = _frameTick;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "frame";
+  if (esp_timer_create(&args, &_frameTimer) != ESP_OK) {
+    _frameTimer = nullptr;
+    return;
+  }
+  setTargetFps(_targetFps); // starts it
 }
 
+// blocks until the next tick, at most two frame times
+void WS2812FX::waitFrameTick(void) {
+  if (!_frameTimer) {
+    vTaskDelay(1);
+    return;
+  }
+  xSemaphoreTake(_frameTick, pdMS_TO_TICKS(2 * FRAMETIME) + 1);
+}
+
+// sends the frame service() rendered ahead, if any
+void WS2812FX::showFrame(void) {
+  if (!_frameReady) return;
+  show();
+}
+#endif
+
 /**
  * Forces the next frame to be computed on all active segments.
  */
@@ -387,11 +1509,16 @@ void WS2812FX::setMode(uint8_t segid, uint8_t m) {
   if (segid >= MAX_NUM_SEGMENTS) return;
    
   if (m >= MODE_COUNT) m = MODE_COUNT - 1;
+  if (!fxIncluded(m)) m = FX_MODE_STATIC; // not in WLED_FX_SUBSET
 
   if (_segments[segid].mode != m) 
   {
+    #ifdef WLED_USE_EFFECT_TRANSITIONS
+    if (_segments[segid].isActive()) _segment_runtimes[segid].startEffectTransition(_segments[segid].mode, _transitionDur);
+    #endif
     _segment_runtimes[segid].markForReset();
     _segments[segid].mode = m;
+    _segments[segid].touch(SEG_DIFFERS_FX);
   }
 }
 
@@ -400,9 +1527,21 @@ uint8_t WS2812FX::getModeCount()
   return MODE_COUNT;
 }
 
+uint8_t WS2812FX::getModeFlags(uint8_t mode)
+{
+  if (mode >= MODE_COUNT) return 0;
+  return pgm_read_byte(&JSON_mode_meta[mode].flags);
+}
+
+uint8_t WS2812FX::getModeCost(uint8_t mode)
+{
+  if (mode >= MODE_COUNT) return 0;
+  return pgm_read_byte(&JSON_mode_meta[mode].cost);
+}
+
 uint8_t WS2812FX::getPaletteCount()
 {
-  return 13 + GRADIENT_PALETTE_COUNT;
+  return 13 + GRADIENT_PALETTE_COUNT + _customPaletteCount;
 }
 
 void WS2812FX::setColor(uint8_t slot, uint8_t r, uint8_t g, uint8_t b, uint8_t w) {
@@ -431,9 +1570,19 @@ void WS2812FX::setCCT(uint16_t k) {
 }
 
 void WS2812FX::setBrightness(uint8_t b, bool direct) {
-  if (gammaCorrectBri) b = gamma8(b);
-  if (_brightness == b) return;
+  setBrightnessFine((uint16_t)b * 257, direct);
+}
+
+//brightness 0-65535, 8 bit outputs get the nearest 8 bit value
+void WS2812FX::setBrightnessFine(uint16_t b16, bool direct) {
+  uint8_t b = ((uint32_t)b16 + 128) / 257;
+  if (gammaCorrectBri) {
+    b = gamma8(b);
+    b16 = gamma16(b16);
+  }
+  if (_brightness == b && _brightnessFine == b16) return;
   _brightness = b;
+  _brightnessFine = b16;
   if (_brightness == 0) { //unfreeze all segments on power off
     for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
     {
@@ -443,9 +1592,10 @@ void WS2812FX::setBrightness(uint8_t b, bool direct) {
   if (direct) {
     // would be dangerous if applied immediately (could exceed ABL), but will not output until the next show()
     busses.setBrightness(b);
+    busses.setBrightnessFine(b16);
   } else {
 	  unsigned long t = millis();
-    if (_segment_runtimes[0].next_time > t + 22 && t - _lastShow > MIN_SHOW_DELAY) show(); //apply brightness change immediately if no refresh soon
+    if (_segment_runtimes[0].next_time > t + 22 && !busses.getBusyTime()) show(); //apply brightness change immediately if no refresh soon
   }
 }
 
@@ -453,14 +1603,116 @@ uint8_t WS2812FX::getBrightness(void) {
   return _brightness;
 }
 
+uint16_t WS2812FX::getBrightnessFine(void) {
+  return _brightnessFine;
+}
+
+uint32_t WS2812FX::getUsedSegmentData(void) {
+  return _usedSegmentData;
+}
+
+//render buffers, segment maps and palette tables
+uint32_t WS2812FX::getUsedSegmentBuffers(void) {
+  uint32_t used = 0;
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  used += _usedSegmentPixels;
+  #endif
+  #ifdef WLED_USE_SEGMENT_MAPS
+  used += _usedSegmentMapData;
+  #endif
+  #ifdef WLED_USE_PALETTE_LUT
+  used += _usedPaletteLUTData;
+  #endif
+  return used;
+}
+
+uint32_t WS2812FX::getMaxSegmentData(void) {
+  return _maxSegmentData;
+}
+
+uint16_t WS2812FX::getSegmentMissedFrames(uint8_t n) {
+  if (n >= MAX_NUM_SEGMENTS) return 0;
+  return _segment_runtimes[n].missedFrames;
+}
+
+uint16_t WS2812FX::getSegmentDataSize(uint8_t n) {
+  if (n >= MAX_NUM_SEGMENTS) return 0;
+  return _segment_runtimes[n].dataSize();
+}
+
+// bytes that can currently not be allocated in one piece until the data is compacted
+uint16_t WS2812FX::getSegmentDataFragmentation(void) {
+  #ifdef WLED_USE_SEGMENT_DATA_ARENA
+  return _dataArenaTop - _usedSegmentData;
+  #else
+  return 0;
+  #endif
+}
+
+#ifdef WLED_USE_SEGMENT_DATA_ARENA
+byte* WS2812FX::allocateArenaData(uint16_t len)
+{
+  if (len == 0) return nullptr;
+  if (!_dataArena) {
+    _dataArena = (byte*) wledAlloc(MAX_SEGMENT_DATA, ALLOC_COLD);
+    if (!_dataArena) return nullptr;
+    _dataArenaTop = 0;
+  }
+  if (_dataArenaTop + len > MAX_SEGMENT_DATA) compactArenaData();
+  if (_dataArenaTop + len > MAX_SEGMENT_DATA) return nullptr;
+  byte* p = _dataArena + _dataArenaTop;
+  _dataArenaTop += len;
+  return p;
+}
+
+void WS2812FX::freeArenaData(byte* data, uint16_t len)
+{
+  if (!data) return;
+  if (data + len == _dataArena + _dataArenaTop) _dataArenaTop -= len; // last block, anything else leaves a hole
+  if (_usedSegmentData == len) _dataArenaTop = 0; // arena is empty
+}
+
+/*
+ * Moves the data of all segments to the start of the arena, in address order.
+ * Only called from allocateData() where no other effect is running, effects fetch SEGENV.data on each call.
+ */
+void WS2812FX::compactArenaData(void)
+{
+  // collect all blocks, including data of effects that are being faded out
+  byte**   blocks[MAX_NUM_SEGMENTS *2];
+  uint16_t lengths[MAX_NUM_SEGMENTS *2];
+  uint8_t  n = 0;
+  for (uint8_t s = 0; s < MAX_NUM_SEGMENTS; s++) {
+    segment_runtime &env = _segment_runtimes[s];
+    if (env.data) { blocks[n] = &env.data; lengths[n++] = env.dataSize(); }
+    #ifdef WLED_USE_EFFECT_TRANSITIONS
+    if (env.fxTransition && env.fxTransition->data) { blocks[n] = &env.fxTransition->data; lengths[n++] = env.fxTransition->dataLen; }
+    #endif
+  }
+
+  uint16_t top = 0;
+  for (uint8_t done = 0; done < n; done++) {
+    uint8_t next = done; // selection sort by address, moving the lowest remaining block down
+    for (uint8_t b = done +1; b < n; b++) if (*blocks[b] < *blocks[next]) next = b;
+    std::swap(blocks[done], blocks[next]);
+    std::swap(lengths[done], lengths[next]);
+    if (*blocks[done] != _dataArena + top) memmove(_dataArena + top, *blocks[done], lengths[done]);
+    *blocks[done] = _dataArena + top;
+    top += lengths[done];
+  }
+  _dataArenaTop = top;
+}
+#endif
+
 uint8_t WS2812FX::getMaxSegments(void) {
   return MAX_NUM_SEGMENTS;
 }
 
 uint8_t WS2812FX::getFirstSelectedSegId(void)
 {
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
+  for (uint8_t k = 0; k < getActiveSegmentsNum(); k++)
   {
+    uint8_t i = _activeSegments[k];
     if (_segments[i].isActive() && _segments[i].isSelected()) return i;
   }
   // if none selected, use the main segment
@@ -488,25 +1740,120 @@ uint8_t WS2812FX::getMainSegmentId(void) {
 }
 
 uint8_t WS2812FX::getLastActiveSegmentId(void) {
-  for (uint8_t i = MAX_NUM_SEGMENTS -1; i > 0; i--) {
-    if (_segments[i].isActive()) return i;
-  }
-  return 0;
+  if (_activeSegmentsDirty) updateActiveSegments();
+  return _activeSegmentCount ? _activeSegments[_activeSegmentCount -1] : 0;
 }
 
 uint8_t WS2812FX::getActiveSegmentsNum(void) {
+  if (_activeSegmentsDirty) updateActiveSegments();
+  return _activeSegmentCount;
+}
+
+//id of the n-th active segment, iterate with n < getActiveSegmentsNum()
+uint8_t WS2812FX::getActiveSegmentId(uint8_t n) {
+  if (_activeSegmentsDirty) updateActiveSegments();
+  return n < _activeSegmentCount ? _activeSegments[n] : getMainSegmentId();
+}
+
+//true while a color, brightness or CCT transition of segment n runs
+bool WS2812FX::inColorTransition(uint8_t n) {
+  ColorTransition* ts = _transitions[n];
+  if (!ts) return false;
+  for (uint8_t slot = 0; slot < NUM_COLORS; slot++) if (ts[slot].segment != 0xFF) return true;
+  return false;
+}
+
+//ms until service() has a frame to render, 0 if one is due or a transition is running
+uint32_t WS2812FX::getIdleTime(void) {
+  if (_triggered) return 0;
+  if (_activeSegmentsDirty) updateActiveSegments();
+  uint32_t nowUp = millis();
+  uint32_t idle = UINT32_MAX;
+  for (uint8_t k = 0; k < _activeSegmentCount; k++) {
+    if (inColorTransition(_activeSegments[k])) return 0;
+    segment_runtime &env = _segment_runtimes[_activeSegments[k]];
+    #ifdef WLED_USE_EFFECT_TRANSITIONS
+    if (env.fxTransition) return 0;
+    #endif
+    if (env.deferred || (long)(env.next_time - nowUp) <= 0) return 0;
+    if (env.next_time - nowUp < idle) idle = env.next_time - nowUp;
+  }
+  return idle;
+}
+
+void WS2812FX::updateActiveSegments(void) {
+  _activeSegmentsDirty = false; // first, so a change while rebuilding marks the list again
   uint8_t c = 0;
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++)
-  {
-    if (_segments[i].isActive()) c++;
+  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    if (_segments[i].isActive()) _activeSegments[c++] = i;
   }
-  return c;
+  _activeSegmentCount = c;
+  #ifdef WLED_USE_SEGMENT_MAPS
+  // a linked segment or its leader may have been added or deleted, see buildSegmentMap()
+  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    if (!_segments[i].link || _segments[i].link > MAX_NUM_SEGMENTS) continue;
+    _segment_runtimes[i].invalidateMap();
+    _segment_runtimes[_segments[i].link - 1].invalidateMap();
+  }
+  #endif
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  // by layer, in ID order within a layer (stable insertion sort)
+  _layered = false;
+  for (uint8_t k = 0; k < c; k++) {
+    uint8_t s = _activeSegments[k];
+    if (_segments[s].layer || _segments[s].blendMode) _layered = true;
+    uint8_t j = k;
+    for (; j > 0 && _segments[_layerOrder[j - 1]].layer > _segments[s].layer; j--) _layerOrder[j] = _layerOrder[j - 1];
+    _layerOrder[j] = s;
+  }
+  if (!_layered && _layerFrame) {
+    free(_layerFrame);
+    _layerFrame = nullptr;
+    _layerFrameLen = 0;
+  }
+  #endif
+}
+
+//frees the runtime buffers of a segment that is no longer active
+void WS2812FX::releaseSegment(uint8_t n) {
+  if (_segments[n].isActive()) return; // enabled again in the meantime, reset by setSegment()
+  segment_runtime &env = _segment_runtimes[n];
+  env.resetIfRequired();
+  #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+  env.throttle = 0;
+  #endif
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  env.deallocatePixels();
+  #endif
+  #ifdef WLED_USE_SEGMENT_MAPS
+  env.deallocateMap();
+  #endif
+  #ifdef WLED_USE_PALETTE_LUT
+  env.deallocatePaletteLUT();
+  #endif
+  #ifdef WLED_USE_EFFECT_TRANSITIONS
+  env.endEffectTransition();
+  #endif
+  delete[] _transitions[n];
+  _transitions[n] = nullptr;
 }
 
-uint32_t WS2812FX::getPixelColor(uint16_t i)
+uint32_t WS2812FX::getPixelColor(pixidx_t i)
 {
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  if (SEGLEN && SEGENV.pixels) return (i < SEGENV.pixelsLength()) ? SEGENV.pixels[SEGENV.pixelIndex(i)] : 0;
+  #endif
+  #ifdef WLED_USE_SEGMENT_MAPS
+  if (SEGLEN && SEGENV.map) {
+    if (i >= SEGENV.mapLength()) return 0;
+    i = SEGENV.map[i * SEGENV.mapStride()];
+    return (i < _length) ? busses.getPixelColor(i) : 0;
+  }
+  #endif
+
   // get physical pixel
-  i = i * SEGMENT.groupLength();;
+  if (SEGLEN) i = SEGMENT.map2D(i);
+  i = i * SEGMENT.groupLength();
   if (IS_REVERSE) {
     if (IS_MIRROR) i = (SEGMENT.length() - 1) / 2 - i;  //only need to index half the pixels
     else           i = (SEGMENT.length() - 1) - i;
@@ -519,7 +1866,7 @@ uint32_t WS2812FX::getPixelColor(uint16_t i)
     if (i >= SEGMENT.stop) i -= SEGMENT.length();
   }
   
-  if (i < customMappingSize) i = customMappingTable[i];
+  i = mapPixel(i);
   if (i >= _length) return 0;
   
   return busses.getPixelColor(i);
@@ -546,12 +1893,12 @@ uint32_t WS2812FX::getLastShow(void) {
   return _lastShow;
 }
 
-uint16_t WS2812FX::getLengthTotal(void) {
+pixidx_t WS2812FX::getLengthTotal(void) {
   return _length;
 }
 
-uint16_t WS2812FX::getLengthPhysical(void) {
-  uint16_t len = 0;
+pixidx_t WS2812FX::getLengthPhysical(void) {
+  pixidx_t len = 0;
   for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
     Bus *bus = busses.getBus(b);
     if (bus->getType() >= TYPE_NET_DDP_RGB) continue; //exclude non-physical network busses
@@ -560,28 +1907,12 @@ uint16_t WS2812FX::getLengthPhysical(void) {
   return len;
 }
 
-uint8_t WS2812FX::Segment::differs(Segment& b) {
-  uint8_t d = 0;
-  if (start != b.start)         d |= SEG_DIFFERS_BOUNDS;
-  if (stop != b.stop)           d |= SEG_DIFFERS_BOUNDS;
-  if (offset != b.offset)       d |= SEG_DIFFERS_GSO;
-  if (grouping != b.grouping)   d |= SEG_DIFFERS_GSO;
-  if (spacing != b.spacing)     d |= SEG_DIFFERS_GSO;
-  if (opacity != b.opacity)     d |= SEG_DIFFERS_BRI;
-  if (mode != b.mode)           d |= SEG_DIFFERS_FX;
-  if (speed != b.speed)         d |= SEG_DIFFERS_FX;
-  if (intensity != b.intensity) d |= SEG_DIFFERS_FX;
-  if (palette != b.palette)     d |= SEG_DIFFERS_FX;
-
-  if ((options & 0b00101110) != (b.options & 0b00101110)) d |= SEG_DIFFERS_OPT;
-  if ((options & 0x01) != (b.options & 0x01)) d |= SEG_DIFFERS_SEL;
-  
-  for (uint8_t i = 0; i < NUM_COLORS; i++)
-  {
-    if (colors[i] != b.colors[i]) d |= SEG_DIFFERS_COL;
-  }
+uint16_t WS2812FX::getLedmapWidth(void) {
+  return _ledmapWidth;
+}
 
-  return d;
+pixidx_t WS2812FX::getLedmapLength(void) {
+  return customMappingSize;
 }
 
 void WS2812FX::Segment::refreshLightCapabilities() {
@@ -652,7 +1983,7 @@ bool WS2812FX::hasCCTBus(void) {
 	return false;
 }
 
-void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping, uint8_t spacing, uint16_t offset) {
+void WS2812FX::setSegment(uint8_t n, pixidx_t i1, pixidx_t i2, uint8_t grouping, uint8_t spacing, uint16_t offset) {
   if (n >= MAX_NUM_SEGMENTS) return;
   Segment& seg = _segments[n];
 
@@ -663,8 +1994,14 @@ void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping,
 			&& (offset == UINT16_MAX || offset == seg.offset)) return;
 
   if (seg.stop) setRange(seg.start, seg.stop -1, 0); //turn old segment range off
+  _activeSegmentsDirty = true;
+  seg.touch(boundsUnchanged ? SEG_DIFFERS_GSO : SEG_DIFFERS_BOUNDS);
   if (i2 <= i1) //disable segment
   {
+    if (seg.stop) {
+      _segment_runtimes[n].markForReset(); // frees its effect data too
+      _segmentsToRelease |= 1ULL << n;
+    }
     seg.stop = 0;
     if (seg.name) {
       delete[] seg.name;
@@ -677,6 +2014,7 @@ void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping,
   if (i1 < _length) seg.start = i1;
   seg.stop = i2;
   if (i2 > _length) seg.stop = _length;
+  if (seg.stop - seg.start > UINT16_MAX) seg.stop = seg.start + UINT16_MAX; //effects address segment pixels with 16 bit
   if (grouping) {
     seg.grouping = grouping;
     seg.spacing = spacing;
@@ -686,6 +2024,115 @@ void WS2812FX::setSegment(uint8_t n, uint16_t i1, uint16_t i2, uint8_t grouping,
   if (!boundsUnchanged) seg.refreshLightCapabilities();
 }
 
+/*
+ * Sets the matrix layout of segment n, width 0 makes it a 1D segment again.
+ * The segment map is rebuilt by service() since the geometry changed.
+ */
+void WS2812FX::setSegment2D(uint8_t n, uint16_t width, uint8_t layout) {
+  if (n >= MAX_NUM_SEGMENTS) return;
+  Segment& seg = _segments[n];
+  layout &= (SEG2D_ROTATION | SEG2D_SERPENTINE | SEG2D_VERTICAL);
+  if (seg.width == width && seg.layout2D == layout) return;
+  if (seg.stop) setRange(seg.start, seg.stop -1, 0); //clear pixels a partial last row leaves unused
+  seg.width = width;
+  seg.layout2D = layout;
+  seg.touch(SEG_DIFFERS_GSO);
+  _segment_runtimes[n].markForReset();
+}
+
+/*
+ * Lets the effect of segment n render 1 of (1 << scale) pixels (scale 0-2), see Segment::renderLength().
+ * For spatially smooth effects on long segments, the effect restarts since its length changes.
+ */
+void WS2812FX::setRenderScale(uint8_t n, uint8_t scale) {
+  if (n >= MAX_NUM_SEGMENTS) return;
+  if (scale > 2) scale = 2;
+  if (_segments[n].renderScale == scale) return;
+  _segments[n].renderScale = scale;
+  _segments[n].touch(SEG_DIFFERS_GSO);
+  _segment_runtimes[n].markForReset();
+}
+
+void WS2812FX::setSegmentLayer(uint8_t n, uint8_t layer, uint8_t blendMode) {
+  if (n >= MAX_NUM_SEGMENTS) return;
+  if (blendMode >= SEG_BLEND_COUNT) blendMode = SEG_BLEND_NORMAL;
+  if (_segments[n].layer == layer && _segments[n].blendMode == blendMode) return;
+  _segments[n].layer = layer;
+  _segments[n].blendMode = blendMode;
+  _segments[n].touch(SEG_DIFFERS_OPT);
+  _activeSegmentsDirty = true; // composition order
+  _triggered = true;
+}
+
+/*
+ * Links segment n to segment leader (leader >= MAX_NUM_SEGMENTS or n: unlinks it), whose effect then continues
+ * over the pixels of n after its own, as one strip. Segments linked to the same leader follow in ID order and run
+ * no effect of their own. Needs segment maps, a leader whose map does not fit MAX_SEGMENT_MAP_DATA leaves them dark.
+ */
+void WS2812FX::setSegmentLink(uint8_t n, uint8_t leader) {
+  if (n >= MAX_NUM_SEGMENTS) return;
+  uint8_t link = (leader < MAX_NUM_SEGMENTS && leader != n && !_segments[leader].link) ? leader + 1 : 0; // no chains
+  if (_segments[n].link == link) return;
+  #ifdef WLED_USE_SEGMENT_MAPS
+  if (_segments[n].link && _segments[n].link <= MAX_NUM_SEGMENTS) _segment_runtimes[_segments[n].link - 1].invalidateMap();
+  _segment_runtimes[n].invalidateMap();
+  #endif
+  _segments[n].link = link;
+  _segments[n].touch(SEG_DIFFERS_OPT);
+  _activeSegmentsDirty = true; // invalidates the maps of the new leader and its followers
+  _triggered = true;
+}
+
+/*
+ * Makes segment n an instance of segment prototype (prototype >= MAX_NUM_SEGMENTS or n: a segment of its own again).
+ * An instance runs no effect, composeSegments() copies the rendered buffer of its prototype into it through its own
+ * geometry, so its reverse, mirror and offset settings flip or phase shift the copy. Needs segment buffers.
+ */
+void WS2812FX::setSegmentInstance(uint8_t n, uint8_t prototype) {
+  if (n >= MAX_NUM_SEGMENTS) return;
+  uint8_t instanceOf = (prototype < MAX_NUM_SEGMENTS && prototype != n && !_segments[prototype].instanceOf) ? prototype + 1 : 0;
+  if (_segments[n].instanceOf == instanceOf) return;
+  _segments[n].instanceOf = instanceOf;
+  _segments[n].touch(SEG_DIFFERS_OPT);
+  _segment_runtimes[n].markForReset();
+  _triggered = true;
+}
+
+// true if segment n shows the buffer of its prototype instead of running its own effect
+bool WS2812FX::isInstanceSegment(uint8_t n) {
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint8_t p = _segments[n].instanceOf;
+  return p && p <= MAX_NUM_SEGMENTS && p - 1 != n && !_segments[p - 1].instanceOf && _segments[p - 1].isActive() && !isLinkedSegment(p - 1);
+  #else
+  return false;
+  #endif
+}
+
+// the segment whose buffer segment n shows, n itself unless it is an instance
+uint8_t WS2812FX::getInstanceSource(uint8_t n) {
+  return isInstanceSegment(n) ? _segments[n].instanceOf - 1 : n;
+}
+
+// true if segment n is drawn by the effect of the segment it is linked to
+bool WS2812FX::isLinkedSegment(uint8_t n) {
+  #ifdef WLED_USE_SEGMENT_MAPS
+  uint8_t l = _segments[n].link;
+  return l && l <= MAX_NUM_SEGMENTS && l - 1 != n && !_segments[l - 1].link && _segments[l - 1].isActive();
+  #else
+  return false;
+  #endif
+}
+
+// virtual length the effect of segment n renders, including the segments linked to it
+uint16_t WS2812FX::getLinkedLength(uint8_t n) {
+  uint16_t vLen = _segments[n].virtualLength();
+  #ifdef WLED_USE_SEGMENT_MAPS
+  segment_runtime& env = _segment_runtimes[n];
+  if (env.map && env.mapLength() > vLen) return env.mapLength();
+  #endif
+  return vLen;
+}
+
 void WS2812FX::restartRuntime() {
   for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
     _segment_runtimes[i].markForReset();
@@ -693,11 +2140,20 @@ void WS2812FX::restartRuntime() {
 }
 
 void WS2812FX::resetSegments() {
-  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) if (_segments[i].name) delete[] _segments[i].name;
+  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) {
+    if (_segments[i].name) delete[] _segments[i].name;
+    if (i && _segments[i].isActive()) _segmentsToRelease |= 1ULL << i;
+    #ifdef WLED_USE_SEGMENT_MAPS
+    _segment_runtimes[i].invalidateMap(); // may hold linked segments
+    #endif
+  }
+  _activeSegmentsDirty = true;
   _mainSegment = 0;
   memset(_segments, 0, sizeof(_segments));
+  _segmentsGen++;
+  for (uint8_t i = 0; i < MAX_NUM_SEGMENTS; i++) _segments[i].gen = _segmentsGen; // above any generation seen before
   //memset(_segment_runtimes, 0, sizeof(_segment_runtimes));
-  _segment_index = 0;
+  RCTX.segIndex = 0;
   _segments[0].mode = DEFAULT_MODE;
   _segments[0].colors[0] = DEFAULT_COLOR;
   _segments[0].start = 0;
@@ -726,8 +2182,8 @@ void WS2812FX::resetSegments() {
 
 void WS2812FX::makeAutoSegments(bool forceReset) {
   if (autoSegments) { //make one segment per bus
-    uint16_t segStarts[MAX_NUM_SEGMENTS] = {0};
-    uint16_t segStops [MAX_NUM_SEGMENTS] = {0};
+    pixidx_t segStarts[MAX_NUM_SEGMENTS] = {0};
+    pixidx_t segStops [MAX_NUM_SEGMENTS] = {0};
     uint8_t s = 0;
     for (uint8_t i = 0; i < busses.getNumBusses(); i++) {
       Bus* b = busses.getBus(i);
@@ -796,25 +2252,27 @@ bool WS2812FX::checkSegmentAlignment() {
 
 //After this function is called, setPixelColor() will use that segment (offsets, grouping, ... will apply)
 //Note: If called in an interrupt (e.g. JSON API), original segment must be restored,
-//otherwise it can lead to a crash on ESP32 because _segment_index is modified while in use by the main thread
+//otherwise it can lead to a crash on ESP32 because RCTX.segIndex is modified while in use by the main thread
 uint8_t WS2812FX::setPixelSegment(uint8_t n)
 {
-  uint8_t prevSegId = _segment_index;
+  uint8_t prevSegId = RCTX.segIndex;
   if (n < MAX_NUM_SEGMENTS) {
-    _segment_index = n;
-    _virtualSegmentLength = SEGMENT.virtualLength();
+    RCTX.segIndex = n;
+    RCTX.vLength = SEGMENT.virtualLength();
+    RCTX.vWidth = SEGMENT.virtualWidth();
+    selectPixelWriter();
   }
   return prevSegId;
 }
 
-void WS2812FX::setRange(uint16_t i, uint16_t i2, uint32_t col)
+void WS2812FX::setRange(pixidx_t i, pixidx_t i2, uint32_t col)
 {
   if (i2 >= i)
   {
-    for (uint16_t x = i; x <= i2; x++) setPixelColor(x, col);
+    for (pixidx_t x = i; x <= i2; x++) setPixelColor(x, col);
   } else
   {
-    for (uint16_t x = i2; x <= i; x++) setPixelColor(x, col);
+    for (pixidx_t x = i2; x <= i; x++) setPixelColor(x, col);
   }
 }
 
@@ -847,7 +2305,8 @@ uint32_t IRAM_ATTR WS2812FX::color_blend(uint32_t color1, uint32_t color2, uint1
   if(blend == 0)   return color1;
   uint16_t blendmax = b16 ? 0xFFFF : 0xFF;
   if(blend == blendmax) return color2;
-  uint8_t shift = b16 ? 16 : 8;
+  if (!b16) return blendPacked(color1, color2, blend);
+  uint8_t shift = 16; // 16 bit weights do not fit two channels per multiply
 
   uint32_t w1 = W(color1);
   uint32_t r1 = R(color1);
@@ -867,10 +2326,65 @@ uint32_t IRAM_ATTR WS2812FX::color_blend(uint32_t color1, uint32_t color2, uint1
   return RGBW32(r3, g3, b3, w3);
 }
 
+#ifdef WLED_USE_SEGMENT_BUFFERS
+/*
+ * Span helpers for effects rendering into a segment buffer.
+ * They produce the same result as the per-pixel getPixelColor()/setPixelColor() round trip,
+ * including opacity scaling on write, but skip pixel writer dispatch and read back directly.
+ */
+static inline uint32_t scaleRGBPacked(uint32_t c, uint8_t scale)
+{
+  return scalePacked(c & 0x00FFFFFF, scale);
+}
+
+static inline uint32_t qaddRGBPacked(uint32_t a, uint32_t b)
+{
+  return qaddPacked(a, b) & 0x00FFFFFF;
+}
+
+// returns the segment buffer if the current effect renders into one, nullptr otherwise.
+// Unless ordered, a scrolled buffer is returned as is, for helpers treating all pixels alike or using pixelIndex()
+uint32_t* WS2812FX::segmentSpan(uint16_t &len, bool ordered)
+{
+  if (!SEGLEN || !SEGENV.pixels) return nullptr;
+  len = SEGENV.pixelsLength();
+  if (len > SEGLEN) len = SEGLEN;
+  if (ordered || len < SEGENV.pixelsLength()) SEGENV.unrotatePixels();
+  SEGENV.pixelsChanged = true;
+  return SEGENV.pixels;
+}
+#endif
+
+// fades color one step towards target. recip is ceil(2^24 / divisor10), divisor10 being ten times the rate
+// divisor of fade_out(): for |c2 - c1| * 10 <= 2550 and divisor10 <= 1281 the multiply gives the exact quotient
+static inline uint32_t fadeTowards(uint32_t color, uint32_t target, uint32_t recip)
+{
+  if (color == target) return color;
+  uint32_t out = 0;
+  for (uint8_t s = 0; s < 32; s += 8) {
+    int c1 = (color  >> s) & 0xFF;
+    int c2 = (target >> s) & 0xFF;
+    int delta = (c2 >= c1) ? (int)(((uint32_t)(c2 - c1) * 10 * recip) >> 24) : -(int)(((uint32_t)(c1 - c2) * 10 * recip) >> 24);
+    // if fade isn't complete, make sure delta is at least 1 (fixes rounding issues)
+    delta += (c2 == c1) ? 0 : (c2 > c1) ? 1 : -1;
+    out |= uint32_t(c1 + delta) << s;
+  }
+  return out;
+}
+
 /*
  * Fills segment with color
  */
 void WS2812FX::fill(uint32_t c) {
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len, false);
+  if (px) {
+    if (RCTX.bri < 255) c = scalePacked(c, RCTX.bri);
+    std::fill(px, px + len, c);
+    return;
+  }
+  #endif
   for(uint16_t i = 0; i < SEGLEN; i++) {
     setPixelColor(i, c);
   }
@@ -881,41 +2395,61 @@ void WS2812FX::fill(uint32_t c) {
  */
 void WS2812FX::blendPixelColor(uint16_t n, uint32_t color, uint8_t blend)
 {
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len, false);
+  if (px) {
+    if (n >= len) return;
+    n = SEGENV.pixelIndex(n);
+    uint32_t c = blendPacked(px[n], color, blend);
+    px[n] = (RCTX.bri < 255) ? scalePacked(c, RCTX.bri) : c;
+    return;
+  }
+  #endif
   setPixelColor(n, color_blend(getPixelColor(n), color, blend));
 }
 
+/*
+ * CRGB array of SEGLEN for FastLED-style effects, after dataLen bytes of the effect's own data.
+ * It is kept between frames, so fadeToBlackBy(), nblend(), blur1d()... work on it in place instead of
+ * reading pixels back. nullptr if the allocation failed.
+ */
+CRGB* WS2812FX::segmentLeds(uint16_t dataLen)
+{
+  if (!SEGENV.allocateData(dataLen + SEGLEN * sizeof(CRGB))) return nullptr;
+  return reinterpret_cast<CRGB*>(SEGENV.data + dataLen);
+}
+
+// writes the array to the segment, the only conversion to the pixel format per frame
+void WS2812FX::setPixels(const CRGB* leds)
+{
+  for (uint16_t i = 0; i < SEGLEN; i++) setPixelColor(i, RGBW32(leds[i].r, leds[i].g, leds[i].b, 0));
+}
+
 /*
  * fade out function, higher rate = quicker fade
  */
 void WS2812FX::fade_out(uint8_t rate) {
   rate = (255-rate) >> 1;
-  float mappedRate = float(rate) +1.1;
+  int divisor10 = rate * 10 + 11; // (rate + 1.1) in tenths, avoids float math per channel
+  uint32_t recip = ((1UL << 24) + divisor10 - 1) / divisor10; // and a multiply instead of a division
 
   uint32_t color = SEGCOLOR(1); // target color
-  int w2 = W(color);
-  int r2 = R(color);
-  int g2 = G(color);
-  int b2 = B(color);
-
-  for(uint16_t i = 0; i < SEGLEN; i++) {
-    color = getPixelColor(i);
-    int w1 = W(color);
-    int r1 = R(color);
-    int g1 = G(color);
-    int b1 = B(color);
-
-    int wdelta = (w2 - w1) / mappedRate;
-    int rdelta = (r2 - r1) / mappedRate;
-    int gdelta = (g2 - g1) / mappedRate;
-    int bdelta = (b2 - b1) / mappedRate;
 
-    // if fade isn't complete, make sure delta is at least 1 (fixes rounding issues)
-    wdelta += (w2 == w1) ? 0 : (w2 > w1) ? 1 : -1;
-    rdelta += (r2 == r1) ? 0 : (r2 > r1) ? 1 : -1;
-    gdelta += (g2 == g1) ? 0 : (g2 > g1) ? 1 : -1;
-    bdelta += (b2 == b1) ? 0 : (b2 > b1) ? 1 : -1;
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len, false);
+  if (px) {
+    for (uint16_t i = 0; i < len; i++) {
+      uint32_t c = fadeTowards(px[i], color, recip);
+      px[i] = (RCTX.bri < 255) ? scalePacked(c, RCTX.bri) : c;
+    }
+    return;
+  }
+  #endif
 
-    setPixelColor(i, r1 + rdelta, g1 + gdelta, b1 + bdelta, w1 + wdelta);
+  for(uint16_t i = 0; i < SEGLEN; i++) {
+    setPixelColor(i, fadeTowards(getPixelColor(i), color, recip));
   }
 }
 
@@ -926,6 +2460,28 @@ void WS2812FX::blur(uint8_t blur_amount)
 {
   uint8_t keep = 255 - blur_amount;
   uint8_t seep = blur_amount >> 1;
+
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len);
+  if (px) {
+    // same as below: white is dropped, written pixels are scaled by opacity
+    uint32_t carryover = 0;
+    for (uint16_t i = 0; i < len; i++) {
+      uint32_t cur  = px[i];
+      uint32_t part = scaleRGBPacked(cur, seep);
+      cur = qaddRGBPacked(scaleRGBPacked(cur, keep), carryover);
+      if (i > 0) {
+        uint32_t prev = qaddRGBPacked(px[i-1], part);
+        px[i-1] = (RCTX.bri < 255) ? scalePacked(prev, RCTX.bri) : prev;
+      }
+      px[i] = (RCTX.bri < 255) ? scalePacked(cur, RCTX.bri) : cur;
+      carryover = part;
+    }
+    return;
+  }
+  #endif
+
   CRGB carryover = CRGB::Black;
   for(uint16_t i = 0; i < SEGLEN; i++)
   {
@@ -946,6 +2502,227 @@ void WS2812FX::blur(uint8_t blur_amount)
   }
 }
 
+/*
+ * 2D helpers. Pixel y * virtualWidth() + x of the effect is at (x, y) after rotation, so in the
+ * segment buffer rows are contiguous and columns are virtualWidth() apart. 1D segments are one row.
+ */
+void WS2812FX::fillRow(uint16_t y, uint32_t c)
+{
+  uint16_t w = RCTX.vWidth;
+  if (!w || y >= virtualHeight()) return;
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len);
+  if (px) {
+    if (XY(w, y) > len) return;
+    if (RCTX.bri < 255) c = scalePacked(c, RCTX.bri);
+    std::fill(px + XY(0, y), px + XY(w, y), c);
+    return;
+  }
+  #endif
+  for (uint16_t x = 0; x < w; x++) setPixelColor(XY(x, y), c);
+}
+
+void WS2812FX::fillColumn(uint16_t x, uint32_t c)
+{
+  uint16_t w = RCTX.vWidth;
+  if (x >= w) return;
+  uint16_t h = virtualHeight();
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len);
+  if (px) {
+    if (RCTX.bri < 255) c = scalePacked(c, RCTX.bri);
+    for (uint16_t i = x; i < len; i += w) px[i] = c;
+    return;
+  }
+  #endif
+  for (uint16_t y = 0; y < h; y++) setPixelColor(XY(x, y), c);
+}
+
+/*
+ * Moves the content dx columns to the right and dy rows down (negative: left/up).
+ * Pixels moved out either come back in on the other side (wrap) or are replaced by black.
+ */
+void WS2812FX::shift2D(int16_t dx, int16_t dy, bool wrap)
+{
+  uint16_t w = RCTX.vWidth;
+  uint16_t h = virtualHeight();
+  if (!w || !h) return;
+  dx %= (int16_t)w; dy %= (int16_t)h;
+  if (!dx && !dy) return;
+
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len);
+  if (px && len >= w * h) {
+    uint32_t* end = px + w * h;
+    if (dy) { // rows are contiguous, move them as one block
+      uint32_t n = (uint32_t)abs(dy) * w;
+      if (dy > 0) {
+        if (wrap) std::rotate(px, end - n, end);
+        else { memmove(px + n, px, (w * h - n) * sizeof(uint32_t)); std::fill(px, px + n, 0); }
+      } else {
+        if (wrap) std::rotate(px, px + n, end);
+        else { memmove(px, px + n, (w * h - n) * sizeof(uint32_t)); std::fill(end - n, end, 0); }
+      }
+    }
+    if (dx) {
+      uint16_t n = abs(dx);
+      for (uint32_t* row = px; row < end; row += w) {
+        if (dx > 0) {
+          if (wrap) std::rotate(row, row + w - n, row + w);
+          else { memmove(row + n, row, (w - n) * sizeof(uint32_t)); std::fill(row, row + n, 0); }
+        } else {
+          if (wrap) std::rotate(row, row + n, row + w);
+          else { memmove(row, row + n, (w - n) * sizeof(uint32_t)); std::fill(row + w - n, row + w, 0); }
+        }
+      }
+    }
+    if (RCTX.bri < 255) for (uint32_t* p = px; p < end; p++) *p = scalePacked(*p, RCTX.bri);
+    return;
+  }
+  #endif
+
+  // without a buffer, move line by line through the pixel writer; wrapping moves one step at a time
+  // so only the pixel falling off the edge needs to be kept
+  for (uint8_t axis = 0; axis < 2; axis++) {
+    int16_t d = axis ? dy : dx;
+    if (!d) continue;
+    uint16_t lines  = axis ? w : h;  // lines moved along this axis
+    uint16_t count  = axis ? h : w;  // pixels per line
+    uint16_t stride = axis ? w : 1;
+    uint16_t n = abs(d);
+    uint16_t passes = wrap ? n : 1;
+    uint16_t step   = wrap ? 1 : n;
+    for (uint16_t p = 0; p < passes; p++) {
+      for (uint16_t l = 0; l < lines; l++) {
+        uint16_t first = axis ? l : XY(0, l);
+        if (d > 0) {
+          uint32_t out = getPixelColor(first + (count - 1) * stride);
+          for (int k = count - 1; k >= step; k--) setPixelColor(first + k * stride, getPixelColor(first + (k - step) * stride));
+          for (uint16_t k = 0; k < step; k++) setPixelColor(first + k * stride, wrap ? out : 0);
+        } else {
+          uint32_t out = getPixelColor(first);
+          for (uint16_t k = 0; k + step < count; k++) setPixelColor(first + k * stride, getPixelColor(first + (k + step) * stride));
+          for (uint16_t k = count - step; k < count; k++) setPixelColor(first + k * stride, wrap ? out : 0);
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Moves the content of the current segment by one pixel, up (towards the end) or down, and sets the pixel
+ * coming in to c, or to the one moved out with wrap. With a segment buffer only its start index is rotated
+ * (resolved when compositing), so this costs one pixel write instead of SEGLEN. The buffer already holds
+ * opacity scaled colors, only the pixel coming in is scaled.
+ */
+void WS2812FX::scroll(bool up, uint32_t c, bool wrap)
+{
+  if (SEGLEN < 2) return;
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len, false);
+  if (px && len == SEGENV.pixelsLength()) {
+    uint16_t &start = SEGENV.pixelsStart;
+    if (up) start = start ? start - 1 : len - 1; // the last pixel becomes pixel 0
+    else    start = (start + 1 < len) ? start + 1 : 0; // pixel 0 becomes the last
+    if (!wrap) px[SEGENV.pixelIndex(up ? 0 : len - 1)] = (RCTX.bri < 255) ? scalePacked(c, RCTX.bri) : c;
+    return;
+  }
+  #endif
+  if (up) {
+    uint32_t out = getPixelColor(SEGLEN - 1);
+    for (uint16_t i = SEGLEN - 1; i > 0; i--) setPixelColor(i, getPixelColor(i - 1));
+    setPixelColor(0, wrap ? out : c);
+  } else {
+    uint32_t out = getPixelColor(0);
+    for (uint16_t i = 0; i < SEGLEN - 1; i++) setPixelColor(i, getPixelColor(i + 1));
+    setPixelColor(SEGLEN - 1, wrap ? out : c);
+  }
+}
+
+#ifdef WLED_USE_SEGMENT_BUFFERS
+// one blur() pass over count pixels, stride apart
+static void blurBufferLine(uint32_t* px, uint16_t count, uint16_t stride, uint8_t keep, uint8_t seep, uint8_t bri)
+{
+  uint32_t carryover = 0;
+  for (uint16_t k = 0; k < count; k++, px += stride) {
+    uint32_t cur  = *px;
+    uint32_t part = scaleRGBPacked(cur, seep);
+    cur = qaddRGBPacked(scaleRGBPacked(cur, keep), carryover);
+    if (k > 0) {
+      uint32_t prev = qaddRGBPacked(*(px - stride), part);
+      *(px - stride) = (bri < 255) ? scalePacked(prev, bri) : prev;
+    }
+    *px = (bri < 255) ? scalePacked(cur, bri) : cur;
+    carryover = part;
+  }
+}
+#endif
+
+// one blur() pass over count pixels of the current segment starting at first, stride apart
+void WS2812FX::blurLine(uint16_t first, uint16_t count, uint16_t stride, uint8_t keep, uint8_t seep)
+{
+  uint32_t carryover = 0;
+  for (uint16_t k = 0; k < count; k++) {
+    uint16_t i = first + k * stride;
+    uint32_t cur  = getPixelColor(i) & 0x00FFFFFF;
+    uint32_t part = scalePacked(cur, seep);
+    cur = scalePacked(cur, keep);
+    cur = RGBW32(qadd8(R(cur), R(carryover)), qadd8(G(cur), G(carryover)), qadd8(B(cur), B(carryover)), 0);
+    if (k > 0) {
+      uint32_t c = getPixelColor(i - stride);
+      setPixelColor(i - stride, qadd8(R(c), R(part)), qadd8(G(c), G(part)), qadd8(B(c), B(part)));
+    }
+    setPixelColor(i, cur);
+    carryover = part;
+  }
+}
+
+/*
+ * blurs rows and then columns, source: FastLED blur2d()
+ */
+void WS2812FX::blur2D(uint8_t blur_amount)
+{
+  uint16_t w = RCTX.vWidth;
+  uint16_t h = virtualHeight();
+  if (!w || !h) return;
+  uint8_t keep = 255 - blur_amount;
+  uint8_t seep = blur_amount >> 1;
+
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len);
+  if (px && len >= w * h) {
+    for (uint16_t y = 0; y < h; y++) blurBufferLine(px + XY(0, y), w, 1, keep, seep, RCTX.bri);
+    for (uint16_t x = 0; x < w; x++) blurBufferLine(px + x, h, w, keep, seep, RCTX.bri);
+    return;
+  }
+  #endif
+  for (uint16_t y = 0; y < h; y++) blurLine(XY(0, y), w, 1, keep, seep);
+  for (uint16_t x = 0; x < w; x++) blurLine(x, h, w, keep, seep);
+}
+
+/*
+ * dims all pixels towards black, fadeBy 255 turns them off (unlike fade_out(), which approaches color 2)
+ */
+void WS2812FX::fadeToBlackBy(uint8_t fadeBy)
+{
+  uint8_t scale = 255 - fadeBy;
+  #ifdef WLED_USE_SEGMENT_BUFFERS
+  uint16_t len;
+  uint32_t* px = segmentSpan(len);
+  if (px) {
+    if (RCTX.bri < 255) scale = scale8(scale, RCTX.bri);
+    for (uint16_t i = 0; i < len; i++) px[i] = scalePacked(px[i], scale);
+    return;
+  }
+  #endif
+  for (uint16_t i = 0; i < SEGLEN; i++) setPixelColor(i, scalePacked(getPixelColor(i), scale));
+}
+
 uint16_t IRAM_ATTR WS2812FX::triwave16(uint16_t in)
 {
   if (in < 0x8000) return in *2;
@@ -1033,103 +2810,183 @@ void WS2812FX::load_gradient_palette(uint8_t index)
 {
   byte i = constrain(index, 0, GRADIENT_PALETTE_COUNT -1);
   byte tcp[72]; //support gradient palettes with up to 18 entries
-  memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[i])), 72);
-  targetPalette.loadDynamicGradientPalette(tcp);
+  const byte* gp = (const byte*)pgm_read_dword(&(gGradientPalettes[i]));
+  if (!gp) { RCTX.targetPalette = RainbowColors_p; return; } // not in WLED_PALETTE_SUBSET
+  memcpy_P(tcp, gp, 72);
+  RCTX.targetPalette.loadDynamicGradientPalette(tcp);
 }
 
 
 /*
- * FastLED palette modes helper function. Limitation: Due to memory reasons, multiple active segments with FastLED will disable the Palette transitions
+ * Reads the user palettes /palette0.bin, /palette1.bin ... (up to the first one missing) and expands them.
+ * A file holds 2 to 18 gradient stops of 4 bytes (index, R, G, B) like the gradients in palettes.h,
+ * the indices ascending from 0 to 255. Invalid files are loaded as a black palette to keep the IDs of the next ones.
  */
-void WS2812FX::handle_palette(void)
+void WS2812FX::loadCustomPalettes()
 {
-  bool singleSegmentMode = (_segment_index == _segment_index_palette_last);
-  _segment_index_palette_last = _segment_index;
-
-  byte paletteIndex = SEGMENT.palette;
-  if (paletteIndex == 0) //default palette. Differs depending on effect
-  {
-    switch (SEGMENT.mode)
-    {
-      case FX_MODE_FIRE_2012  : paletteIndex = 35; break; //heat palette
-      case FX_MODE_COLORWAVES : paletteIndex = 26; break; //landscape 33
-      case FX_MODE_FILLNOISE8 : paletteIndex =  9; break; //ocean colors
-      case FX_MODE_NOISE16_1  : paletteIndex = 20; break; //Drywet
-      case FX_MODE_NOISE16_2  : paletteIndex = 43; break; //Blue cyan yellow
-      case FX_MODE_NOISE16_3  : paletteIndex = 35; break; //heat palette
-      case FX_MODE_NOISE16_4  : paletteIndex = 26; break; //landscape 33
-      case FX_MODE_GLITTER    : paletteIndex = 11; break; //rainbow colors
-      case FX_MODE_SUNRISE    : paletteIndex = 35; break; //heat palette
-      case FX_MODE_FLOW       : paletteIndex =  6; break; //party
-    }
+  _customPalettesDirty = false;
+  free(_customPalettes);
+  _customPalettes = nullptr;
+  _customPaletteCount = 0;
+
+  uint8_t count = 0;
+  char name[20];
+  while (count < WLED_MAX_CUSTOM_PALETTES) {
+    sprintf_P(name, PSTR("/palette%d.bin"), count);
+    if (!WLED_FS.exists(name)) break;
+    count++;
   }
-  if (SEGMENT.mode >= FX_MODE_METEOR && paletteIndex == 0) paletteIndex = 4;
-  
+  if (!count) return;
+  _customPalettes = (CRGBPalette16*) calloc(count, sizeof(CRGBPalette16));
+  if (!_customPalettes) return;
+
+  for (uint8_t n = 0; n < count; n++) {
+    sprintf_P(name, PSTR("/palette%d.bin"), n);
+    File f = WLED_FS.open(name, "r");
+    byte tcp[72];
+    size_t len = f ? f.read(tcp, sizeof(tcp)) : 0;
+    bool valid = len >= 8 && !(len & 3) && (!f.available()) && tcp[0] == 0 && tcp[len - 4] == 255;
+    for (size_t i = 4; valid && i < len; i += 4) valid = tcp[i] >= tcp[i - 4] && (tcp[i - 4] < 255);
+    if (f) f.close();
+    if (valid) _customPalettes[n].loadDynamicGradientPalette(tcp);
+    DEBUG_PRINTF("Palette %s: %s\n", name, valid ? "ok" : "invalid");
+  }
+  _customPaletteCount = count;
+}
+
+/*
+ * Expands palette paletteIndex into RCTX.targetPalette.
+ * The random palette (1) is only replaced when due, returns false if RCTX.targetPalette was left unchanged.
+ */
+bool WS2812FX::loadPalette(uint8_t paletteIndex, bool singleSegmentMode, uint32_t &lastChange)
+{
   switch (paletteIndex)
   {
     case 0: //default palette. Exceptions for specific effects above
-      targetPalette = PartyColors_p; break;
+      RCTX.targetPalette = PartyColors_p; break;
     case 1: {//periodically replace palette with a random one. Doesn't work with multiple FastLED segments
       if (!singleSegmentMode)
       {
-        targetPalette = PartyColors_p; break; //fallback
+        RCTX.targetPalette = PartyColors_p; break; //fallback
       }
-      if (millis() - _lastPaletteChange > 1000 + ((uint32_t)(255-SEGMENT.intensity))*100)
+      if (uptimeMs() - lastChange > 1000 + ((uint32_t)(255-SEGMENT.intensity))*100)
       {
-        targetPalette = CRGBPalette16(
+        RCTX.targetPalette = CRGBPalette16(
                         CHSV(random8(), 255, random8(128, 255)),
                         CHSV(random8(), 255, random8(128, 255)),
                         CHSV(random8(), 192, random8(128, 255)),
                         CHSV(random8(), 255, random8(128, 255)));
-        _lastPaletteChange = millis();
-      } break;}
+        lastChange = uptimeMs();
+        break;
+      }
+      return false;}
     case 2: {//primary color only
       CRGB prim = col_to_crgb(SEGCOLOR(0));
-      targetPalette = CRGBPalette16(prim); break;}
+      RCTX.targetPalette = CRGBPalette16(prim); break;}
     case 3: {//primary + secondary
       CRGB prim = col_to_crgb(SEGCOLOR(0));
       CRGB sec  = col_to_crgb(SEGCOLOR(1));
-      targetPalette = CRGBPalette16(prim,prim,sec,sec); break;}
+      RCTX.targetPalette = CRGBPalette16(prim,prim,sec,sec); break;}
     case 4: {//primary + secondary + tertiary
       CRGB prim = col_to_crgb(SEGCOLOR(0));
       CRGB sec  = col_to_crgb(SEGCOLOR(1));
       CRGB ter  = col_to_crgb(SEGCOLOR(2));
-      targetPalette = CRGBPalette16(ter,sec,prim); break;}
+      RCTX.targetPalette = CRGBPalette16(ter,sec,prim); break;}
     case 5: {//primary + secondary (+tert if not off), more distinct
       CRGB prim = col_to_crgb(SEGCOLOR(0));
       CRGB sec  = col_to_crgb(SEGCOLOR(1));
       if (SEGCOLOR(2)) {
         CRGB ter = col_to_crgb(SEGCOLOR(2));
-        targetPalette = CRGBPalette16(prim,prim,prim,prim,prim,sec,sec,sec,sec,sec,ter,ter,ter,ter,ter,prim);
+        RCTX.targetPalette = CRGBPalette16(prim,prim,prim,prim,prim,sec,sec,sec,sec,sec,ter,ter,ter,ter,ter,prim);
       } else {
-        targetPalette = CRGBPalette16(prim,prim,prim,prim,prim,prim,prim,prim,sec,sec,sec,sec,sec,sec,sec,sec);
+        RCTX.targetPalette = CRGBPalette16(prim,prim,prim,prim,prim,prim,prim,prim,sec,sec,sec,sec,sec,sec,sec,sec);
       }
       break;}
     case 6: //Party colors
-      targetPalette = PartyColors_p; break;
+      RCTX.targetPalette = PartyColors_p; break;
     case 7: //Cloud colors
-      targetPalette = CloudColors_p; break;
+      RCTX.targetPalette = CloudColors_p; break;
     case 8: //Lava colors
-      targetPalette = LavaColors_p; break;
+      RCTX.targetPalette = LavaColors_p; break;
     case 9: //Ocean colors
-      targetPalette = OceanColors_p; break;
+      RCTX.targetPalette = OceanColors_p; break;
     case 10: //Forest colors
-      targetPalette = ForestColors_p; break;
+      RCTX.targetPalette = ForestColors_p; break;
     case 11: //Rainbow colors
-      targetPalette = RainbowColors_p; break;
+      RCTX.targetPalette = RainbowColors_p; break;
     case 12: //Rainbow stripe colors
-      targetPalette = RainbowStripeColors_p; break;
-    default: //progmem palettes
+      RCTX.targetPalette = RainbowStripeColors_p; break;
+    default: //progmem palettes, then the user palettes
+      if (paletteIndex >= 13 + GRADIENT_PALETTE_COUNT) {
+        const CRGBPalette16* custom = getCustomPalette(paletteIndex - 13 - GRADIENT_PALETTE_COUNT);
+        RCTX.targetPalette = custom ? *custom : RainbowColors_p; // deleted since
+        break;
+      }
       load_gradient_palette(paletteIndex -13);
   }
-  
+  return true;
+}
+
+
+/*
+ * FastLED palette modes helper function.
+ * Without WLED_USE_SEGMENT_PALETTES, multiple active segments with FastLED will disable the Palette transitions due to memory reasons
+ */
+void WS2812FX::handle_palette(void)
+{
+  byte paletteIndex = SEGMENT.palette;
+  if (paletteIndex == 0) //default palette. Differs depending on effect
+  {
+    switch (SEGMENT.mode)
+    {
+      case FX_MODE_FIRE_2012  : paletteIndex = 35; break; //heat palette
+      case FX_MODE_COLORWAVES : paletteIndex = 26; break; //landscape 33
+      case FX_MODE_FILLNOISE8 : paletteIndex =  9; break; //ocean colors
+      case FX_MODE_NOISE16_1  : paletteIndex = 20; break; //Drywet
+      case FX_MODE_NOISE16_2  : paletteIndex = 43; break; //Blue cyan yellow
+      case FX_MODE_NOISE16_3  : paletteIndex = 35; break; //heat palette
+      case FX_MODE_NOISE16_4  : paletteIndex = 26; break; //landscape 33
+      case FX_MODE_GLITTER    : paletteIndex = 11; break; //rainbow colors
+      case FX_MODE_SUNRISE    : paletteIndex = 35; break; //heat palette
+      case FX_MODE_FLOW       : paletteIndex =  6; break; //party
+    }
+  }
+  if (SEGMENT.mode >= FX_MODE_METEOR && paletteIndex == 0) paletteIndex = 4;
+
+  #ifdef WLED_USE_SEGMENT_PALETTES
+  // RCTX.targetPalette is only used as scratch space here, each segment keeps its own copy
+  bool matches = SEGENV.paletteMatches(paletteIndex, RCTX.colors);
+  if (!matches && paletteIndex == 1) SEGENV.lastPaletteChange = 0; // new random palette right away
+  if ((!matches || paletteIndex == 1) && loadPalette(paletteIndex, true, SEGENV.lastPaletteChange)) {
+    SEGENV.targetPalette = RCTX.targetPalette;
+  }
+  SEGENV.setPaletteKey(paletteIndex, RCTX.colors);
+
+  #ifdef WLED_USE_PALETTE_LUT
+  if (!(SEGENV.palette == SEGENV.targetPalette)) SEGENV.paletteLUTValid = false;
+  #endif
+  if (paletteFade && SEGENV.call > 0)
+  {
+    nblendPaletteTowardPalette(SEGENV.palette, SEGENV.targetPalette, 48);
+  } else
+  {
+    SEGENV.palette = SEGENV.targetPalette;
+  }
+  RCTX.palette = SEGENV.palette;
+  #else
+  bool singleSegmentMode = (RCTX.segIndex == RCTX.paletteLast);
+  RCTX.paletteLast = RCTX.segIndex;
+
+  loadPalette(paletteIndex, singleSegmentMode, _lastPaletteChange);
+
   if (singleSegmentMode && paletteFade && SEGENV.call > 0) //only blend if just one segment uses FastLED mode
   {
-    nblendPaletteTowardPalette(currentPalette, targetPalette, 48);
+    nblendPaletteTowardPalette(RCTX.palette, RCTX.targetPalette, 48);
   } else
   {
-    currentPalette = targetPalette;
+    RCTX.palette = RCTX.targetPalette;
   }
+  #endif
 }
 
 
@@ -1144,71 +3001,274 @@ void WS2812FX::handle_palette(void)
  */
 uint32_t IRAM_ATTR WS2812FX::color_from_palette(uint16_t i, bool mapping, bool wrap, uint8_t mcol, uint8_t pbri)
 {
-  if ((SEGMENT.palette == 0 && mcol < 3) || _no_rgb) {
+  if ((SEGMENT.palette == 0 && mcol < 3) || RCTX.noRgb) {
     uint32_t color = SEGCOLOR(mcol);
     if (pbri == 255) return color;
     return RGBW32(scale8_video(R(color),pbri), scale8_video(G(color),pbri), scale8_video(B(color),pbri), scale8_video(W(color),pbri));
   }
 
   uint8_t paletteIndex = i;
-  if (mapping && SEGLEN > 1) paletteIndex = (i*255)/(SEGLEN -1);
+  if (mapping && SEGLEN > 1) {
+    if (RCTX.paletteMapLen != SEGLEN) { // ceil, so the last pixel maps to 255
+      RCTX.paletteMapScale = ((255UL << 16) + SEGLEN -2) / (SEGLEN -1);
+      RCTX.paletteMapLen = SEGLEN;
+    }
+    paletteIndex = (i * RCTX.paletteMapScale) >> 16; // only the low byte is used, so overflow does not matter
+  }
   if (!wrap) paletteIndex = scale8(paletteIndex, 240); //cut off blend at palette "end"
+
+  #ifdef WLED_USE_PALETTE_LUT
+  if (pbri == 255 && SEGLEN) {
+    bool noBlend = (paletteBlend == 3);
+    segment_runtime &env = SEGENV;
+    if (env.paletteLUTValid && env.paletteLUTNoBlend == noBlend) return env.paletteLUT[paletteIndex];
+    if (env.allocatePaletteLUT()) {
+      for (uint16_t c = 0; c < 256; c++) env.paletteLUT[c] = crgb_to_col(ColorFromPalette(RCTX.palette, c, 255, noBlend ? NOBLEND : LINEARBLEND));
+      env.paletteLUTNoBlend = noBlend;
+      env.paletteLUTValid = true;
+      return env.paletteLUT[paletteIndex];
+    }
+  }
+  #endif
+
   CRGB fastled_col;
-  fastled_col = ColorFromPalette(currentPalette, paletteIndex, pbri, (paletteBlend == 3)? NOBLEND:LINEARBLEND);
+  fastled_col = ColorFromPalette(RCTX.palette, paletteIndex, pbri, (paletteBlend == 3)? NOBLEND:LINEARBLEND);
 
   return crgb_to_col(fastled_col);
 }
 
 
 //load custom mapping table from JSON file (called from finalizeInit() or deserializeState())
-void WS2812FX::deserializeMap(uint8_t n) {
+/*
+ * A ledmap covers the LEDs from its optional "start" on, as many as "map" has entries; its entries count from "start"
+ * as well, so a map for one matrix of a mixed install only costs memory and lookups for the LEDs of that matrix.
+ *
+ * Binary ledmaps: /ledmapN.bin holds a 20 byte header ('L','M', version, bytes per entry, entry count (32 bit),
+ * width (16 bit), 0, 0, size of the JSON it was made from, start (32 bit); little endian) followed by the table
+ * as pixidx_t, relative to start.
+ * A file of a build with another pixel index size is regenerated as well. It is generated from /ledmapN.json
+ * by a streaming scan on first load, so maps larger than the JSON buffer work, and is read directly after that.
+ * A JSON file of another size regenerates it.
+ *
+ * Maps selected at runtime are loaded in the background, LEDMAP_LOAD_CHUNK bytes of the JSON or binary per loop,
+ * while the strip keeps rendering with the old table. The new table replaces it between two frames once complete.
+ */
+#define LEDMAP_BIN_HEADER  20
+#define LEDMAP_BIN_VERSION 3
+#define LEDMAP_LOAD_CHUNK  1024
+
+#define LEDMAP_IDLE        0
+#define LEDMAP_CONVERT     1 //scanning the JSON into the binary
+#define LEDMAP_READ        2 //reading the binary into the new table
+
+static struct LedmapLoad {
+  uint8_t   stage = LEDMAP_IDLE;
+  File      jf, bf;
+  char      binName[16];   //"/ledmap255.bin"
+  uint32_t  jsonSize;
+  pixidx_t* table = nullptr;
+  pixidx_t  count;
+  uint32_t  bytesRead;
+  uint16_t  width;
+  pixidx_t  start;
+  //JSON scan
+  uint8_t   depth, keyLen, lastKey; //1: "map", 2: "width", 3: "start"
+  bool      inString, escape, expectKey, mapNext, inMap, widthNext, startNext, inNum, neg;
+  char      key[8];
+  int32_t   num;
+} ledmapLoad;
+
+static void abortLedmapLoad()
+{
+  LedmapLoad& l = ledmapLoad;
+  if (l.jf) l.jf.close();
+  if (l.bf) l.bf.close();
+  free(l.table);
+  l.table = nullptr;
+  l.stage = LEDMAP_IDLE;
+}
+
+//one character of the JSON, the entries of "map" are appended to the binary
+static void scanLedmapChar(char c)
+{
+  LedmapLoad& l = ledmapLoad;
+  if (l.inString) {
+    if (l.escape) l.escape = false;
+    else if (c == '\\') l.escape = true;
+    else if (c == '"') {
+      l.inString = false;
+      l.key[l.keyLen] = 0;
+      if (l.expectKey) l.lastKey = !strcmp_P(l.key, PSTR("map")) ? 1 : !strcmp_P(l.key, PSTR("width")) ? 2 : !strcmp_P(l.key, PSTR("start")) ? 3 : 0;
+    }
+    else if (l.keyLen < sizeof(l.key) -1) l.key[l.keyLen++] = c;
+    return;
+  }
+  if (isdigit(c) || (c == '-' && !l.inNum)) {
+    if (!l.inNum) { l.inNum = true; l.neg = (c == '-'); l.num = 0; }
+    if (c != '-') l.num = l.num*10 + (c - '0');
+    return;
+  }
+  if (l.inNum) { //number complete
+    l.inNum = false;
+    if (l.neg) l.num = -l.num;
+    if (l.inMap && l.depth == 2 && l.count < PIXIDX_NONE) {
+      pixidx_t e = l.num; //-1 becomes PIXIDX_NONE like the cast in the JSON parser
+      l.bf.write((const uint8_t*)&e, sizeof(e)); //the ESP8266 and ESP32 are little endian
+      l.count++;
+    } else if (l.widthNext && l.depth == 1) l.width = l.num;
+    else if (l.startNext && l.depth == 1 && l.num > 0) l.start = l.num;
+    l.widthNext = l.startNext = false;
+  }
+  switch (c) {
+    case '"': l.inString = true; l.keyLen = 0; if (l.depth != 1) l.expectKey = false; break;
+    case ':': if (l.depth == 1) { l.mapNext = (l.lastKey == 1); l.widthNext = (l.lastKey == 2); l.startNext = (l.lastKey == 3); l.expectKey = false; } break;
+    case ',': if (l.depth == 1) { l.expectKey = true; l.mapNext = l.widthNext = l.startNext = false; } break;
+    case '{': l.depth++; l.expectKey = (l.depth == 1); break;
+    case '}': if (l.depth) l.depth--; break;
+    case '[': l.depth++; if (l.depth == 2 && l.mapNext) l.inMap = true; break;
+    case ']': if (l.depth == 2) l.inMap = l.mapNext = false; if (l.depth) l.depth--; break;
+  }
+}
+
+//writes the header of the converted binary and closes both files
+static void finishLedmapConversion()
+{
+  LedmapLoad& l = ledmapLoad;
+  uint8_t header[LEDMAP_BIN_HEADER] = {0};
+  header[0] = 'L'; header[1] = 'M'; header[2] = LEDMAP_BIN_VERSION; header[3] = sizeof(pixidx_t);
+  for (uint8_t b = 0; b < 4; b++) header[4+b] = ((uint32_t)l.count >> (8*b)) & 0xFF;
+  header[8] = l.width & 0xFF; header[9] = l.width >> 8;
+  for (uint8_t b = 0; b < 4; b++) header[12+b] = (l.jsonSize >> (8*b)) & 0xFF;
+  for (uint8_t b = 0; b < 4; b++) header[16+b] = ((uint32_t)l.start >> (8*b)) & 0xFF;
+  l.jf.close();
+  l.bf.seek(0);
+  l.bf.write(header, LEDMAP_BIN_HEADER);
+  l.bf.close();
+}
+
+//opens the binary ledmap if it exists and was made from a JSON of jsonSize bytes, and allocates its table
+static bool openLedmapBin()
+{
+  LedmapLoad& l = ledmapLoad;
+  l.bf = WLED_FS.open(l.binName, "r");
+  if (!l.bf) return false;
+  uint8_t h[LEDMAP_BIN_HEADER];
+  bool ok = l.bf.read(h, LEDMAP_BIN_HEADER) == LEDMAP_BIN_HEADER && h[0] == 'L' && h[1] == 'M' && h[2] == LEDMAP_BIN_VERSION
+         && h[3] == sizeof(pixidx_t) && (h[12] | (h[13] << 8) | ((uint32_t)h[14] << 16) | ((uint32_t)h[15] << 24)) == l.jsonSize;
+  l.count = h[4] | (h[5] << 8) | ((uint32_t)h[6] << 16) | ((uint32_t)h[7] << 24);
+  l.width = h[8] | (h[9] << 8);
+  l.start = h[16] | (h[17] << 8) | ((uint32_t)h[18] << 16) | ((uint32_t)h[19] << 24);
+  uint32_t bytes = sizeof(pixidx_t) * (uint32_t)l.count;
+  ok = ok && l.bf.size() == LEDMAP_BIN_HEADER + bytes;
+  if (ok && l.count) {
+    ok = memAdmit(bytes, ALLOC_COLD, MEM_LEDMAP);
+    if (ok) l.table = (pixidx_t*) wledAlloc(bytes, ALLOC_COLD); //only read when segment maps are built if they are enabled
+    if (ok && !l.table) memAllocFailed(MEM_LEDMAP);
+    ok = l.table;
+  }
+  if (!ok) { l.bf.close(); free(l.table); l.table = nullptr; }
+  l.bytesRead = 0;
+  return ok;
+}
+
+//starts loading /ledmap<n>.json, the current table stays in use until handleMapLoad() completes the new one
+void WS2812FX::loadMapAsync(uint8_t n) {
+  abortLedmapLoad(); //a newer selection replaces a load in progress
   char fileName[32];
   strcpy_P(fileName, PSTR("/ledmap"));
   if (n) sprintf(fileName +7, "%d", n);
+  LedmapLoad& l = ledmapLoad;
+  strcpy(l.binName, fileName);
   strcat(fileName, ".json");
-  bool isFile = WLED_FS.exists(fileName);
+  strcat(l.binName, ".bin");
+  File jf = WLED_FS.open(fileName, "r");
 
-  if (!isFile) {
+  if (!jf) {
     // erase custom mapping if selecting nonexistent ledmap.json (n==0)
     if (!n && customMappingTable != nullptr) {
       customMappingSize = 0;
-      delete[] customMappingTable;
+      free(customMappingTable);
       customMappingTable = nullptr;
+      customMappingStart = 0;
+      _ledmapWidth = 0;
+      _ledmapVersion++;
     }
     return;
   }
-
-  #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-  #else
-  if (!requestJSONBufferLock(7)) return;
-  #endif
+  l.jsonSize = jf.size();
 
   DEBUG_PRINT(F("Reading LED map from "));
   DEBUG_PRINTLN(fileName);
 
-  if (!readObjectFromFile(fileName, nullptr, &doc)) {
-    releaseJSONBufferLock();
-    return; //if file does not exist just exit
-  }
-
-  // erase old custom ledmap
-  if (customMappingTable != nullptr) {
-    customMappingSize = 0;
-    delete[] customMappingTable;
-    customMappingTable = nullptr;
+  if (openLedmapBin()) {
+    jf.close();
+    l.stage = LEDMAP_READ;
+    return;
   }
-
-  JsonArray map = doc[F("map")];
-  if (!map.isNull() && map.size()) {  // not an empty map
-    customMappingSize  = map.size();
-    customMappingTable = new uint16_t[customMappingSize];
-    for (uint16_t i=0; i<customMappingSize; i++) {
-      customMappingTable[i] = (uint16_t) map[i];
+  DEBUG_PRINTLN(F("Converting LED map"));
+  l.bf = WLED_FS.open(l.binName, "w");
+  if (!l.bf) { jf.close(); return; }
+  uint8_t header[LEDMAP_BIN_HEADER] = {0};
+  l.bf.write(header, LEDMAP_BIN_HEADER); //rewritten when complete
+  l.jf = jf;
+  l.depth = l.keyLen = l.lastKey = 0;
+  l.inString = l.escape = l.expectKey = l.mapNext = l.inMap = l.widthNext = l.startNext = l.inNum = l.neg = false;
+  l.num = 0;
+  l.count = 0;
+  l.width = 0;
+  l.start = 0;
+  l.stage = LEDMAP_CONVERT;
+}
+
+//one step of a ledmap load, swaps the tables when it completes (call between frames), true while loading
+bool WS2812FX::handleMapLoad() {
+  LedmapLoad& l = ledmapLoad;
+  if (l.stage == LEDMAP_CONVERT) {
+    uint8_t buf[256];
+    for (uint16_t total = 0; total < LEDMAP_LOAD_CHUNK; total += sizeof(buf)) {
+      size_t len = l.jf.read(buf, sizeof(buf));
+      for (size_t i = 0; i < len; i++) scanLedmapChar(buf[i]);
+      if (l.jf.available()) continue;
+      scanLedmapChar(' '); //ends a number at the end of the file
+      finishLedmapConversion();
+      l.stage = openLedmapBin() ? LEDMAP_READ : LEDMAP_IDLE;
+      break;
     }
+    return l.stage != LEDMAP_IDLE;
   }
+  if (l.stage != LEDMAP_READ) return false;
+
+  uint32_t bytes = sizeof(pixidx_t) * (uint32_t)l.count;
+  if (l.bytesRead < bytes) {
+    uint32_t len = MIN(bytes - l.bytesRead, LEDMAP_LOAD_CHUNK);
+    pixidx_t* entries = (pixidx_t*)((uint8_t*)l.table + l.bytesRead);
+    if (l.bf.read((uint8_t*)entries, len) != len) { abortLedmapLoad(); return false; }
+    if (l.start) for (uint16_t k = 0; k < len / sizeof(pixidx_t); k++) if (entries[k] != PIXIDX_NONE) entries[k] += l.start;
+    l.bytesRead += len;
+    if (l.bytesRead < bytes) return true;
+  }
+  l.bf.close();
+
+  // replace old custom ledmap
+  free(customMappingTable);
+  customMappingTable = l.table;
+  customMappingSize  = l.table ? l.count : 0;
+  customMappingStart = l.start;
+  _ledmapWidth = l.width;
+  _ledmapVersion++;
+  l.table = nullptr;
+  l.stage = LEDMAP_IDLE;
+  return false;
+}
+
+bool WS2812FX::isMapLoading() {
+  return ledmapLoad.stage != LEDMAP_IDLE;
+}
 
-  releaseJSONBufferLock();
+//loads at once, at boot
+void WS2812FX::deserializeMap(uint8_t n) {
+  loadMapAsync(n);
+  while (handleMapLoad()) yield();
 }
 
 //gamma 2.8 lookup table used for color correction
@@ -1234,11 +3294,30 @@ uint8_t WS2812FX::gamma8_cal(uint8_t b, float gamma) {
   return (int)(pow((float)b / 255.0, gamma) * 255 + 0.5);
 }
 
+//the same curve in 64 steps of 16 bit, interpolated for brightness with more than 8 bit resolution
+uint16_t gammaT16[65] = {
+      0,     1,     4,    12,    28,    52,    87,   133,   194,   270,   362,   473,   604,   755,   930,  1128,
+   1351,  1601,  1879,  2186,  2524,  2893,  3296,  3733,  4205,  4714,  5261,  5848,  6475,  7143,  7854,  8610,
+   9410, 10257, 11151, 12094, 13086, 14130, 15225, 16374, 17577, 18835, 20150, 21522, 22953, 24444, 25995, 27609,
+  29285, 31025, 32831, 34703, 36642, 38649, 40726, 42873, 45092, 47383, 49747, 52186, 54701, 57292, 59961, 62708,
+  65535 };
+
 void WS2812FX::calcGammaTable(float gamma)
 {
   for (uint16_t i = 0; i < 256; i++) {
     gammaT[i] = gamma8_cal(i, gamma);
   }
+  for (uint8_t i = 0; i < 65; i++) {
+    gammaT16[i] = pow((float)i / 64.0, gamma) * 65535 + 0.5;
+  }
+}
+
+uint16_t WS2812FX::gamma16(uint16_t b)
+{
+  if (b == 65535) return 65535;
+  uint8_t i = b >> 10;
+  uint16_t f = b & 0x3FF;
+  return gammaT16[i] + (((uint32_t)(gammaT16[i+1] - gammaT16[i]) * f) >> 10);
 }
 
 uint8_t WS2812FX::gamma8(uint8_t b)
@@ -1266,3 +3345,36 @@ WS2812FX* WS2812FX::instance = nullptr;
 int16_t Bus::_cct = -1;
 uint8_t Bus::_cctBlend = 0;
 uint8_t Bus::_autoWhiteMode = RGBW_MODE_DUAL;
+bool    Bus::_powerModelWS2815 = false;
+uint8_t Bus::_powerModelVersion = 0;
+#ifdef WLED_WHITE_BALANCE_LUT
+Bus::BalanceLUT  Bus::_balanceLUTs[WLED_WB_LUT_ENTRIES] = {};
+Bus::BalanceLUT* Bus::_balanceLUT = &Bus::_balanceLUTs[0];
+uint8_t          Bus::_balanceClock = 0;
+
+//same result as colorBalanceFromKelvin(), one table lookup per channel instead of a multiply and divide
+//reuses the tables of a recently used CCT, otherwise rebuilds the least recently used entry
+void Bus::selectBalanceLUT() {
+  _balanceClock++;
+  BalanceLUT* oldest = &_balanceLUTs[0];
+  for (uint8_t i = 0; i < WLED_WB_LUT_ENTRIES; i++) {
+    BalanceLUT* e = &_balanceLUTs[i];
+    if (e->kelvin == _cct) {
+      e->lastUse = _balanceClock;
+      _balanceLUT = e;
+      return;
+    }
+    if (e->kelvin == 0) { oldest = e; break; } //unused entry
+    //age relative to the clock, so wrap-around doesn't matter
+    if ((uint8_t)(_balanceClock - e->lastUse) > (uint8_t)(_balanceClock - oldest->lastUse)) oldest = e;
+  }
+  byte rgb[4];
+  colorKtoRGB(_cct, rgb);
+  for (uint8_t c = 0; c < 3; c++) {
+    for (uint16_t v = 0; v < 256; v++) oldest->ch[c][v] = ((uint16_t)rgb[c] * v) / 255;
+  }
+  oldest->kelvin = _cct;
+  oldest->lastUse = _balanceClock;
+  _balanceLUT = oldest;
+}
+#endif
@@ -5,30 +5,140 @@
 * NodeStruct from the ESP Easy project (https://github.com/letscontrolit/ESPEasy)
 \*********************************************************************************************/
 
-#include <map>
+#include <new>
 #include <IPAddress.h>
 
 #define NODE_TYPE_ID_UNDEFINED        0
 #define NODE_TYPE_ID_ESP8266         82
 #define NODE_TYPE_ID_ESP32           32
 
+#define NODE_NAME_LEN                32
+
+#define NODE_STREAM_FOLLOWER       0x01  // takes pixels from a stream master
+#define NODE_STREAM_RGBW           0x02  // follower has white channels
+
+#define FLEET_SOURCE               0x01  // serves its image for a firmware rollout
+#define FLEET_FULL                 0x02  // all download slots taken
+#define FLEET_NO_PROGRESS           255  // not downloading an image
+
 /*********************************************************************************************\
 * NodeStruct
 \*********************************************************************************************/
 struct NodeStruct
 {
-  String    nodeName;
+  char      nodeName[NODE_NAME_LEN +1];
   IPAddress ip;
   uint8_t   unit;
   uint8_t   age;
   uint8_t   nodeType;
   uint32_t  build;
+  uint16_t  leds;         // stream follower: LEDs it shows
+  uint8_t   streamOrder;  // stream follower: position in the master's virtual strip
+  uint8_t   streamFlags;  // NODE_STREAM_...
+  uint8_t   groups;       // sync receive groups
+#ifdef WLED_ENABLE_FLEET_OTA
+  uint32_t  fleetVariant; // release, chip and flash size the image is for, 0 if not announced
+  uint32_t  fleetImage;   // first bytes of the MD5 of the running image
+  uint8_t   fleetFlags;   // FLEET_...
+  uint8_t   fleetProgress;// percent of an image downloaded, FLEET_NO_PROGRESS if none
+  uint8_t   fleetMinutes; // rollout time left on the source
+#endif
 
-  NodeStruct() : age(0), nodeType(0), build(0)
+  NodeStruct() : unit(0), age(0), nodeType(0), build(0), leds(0), streamOrder(0), streamFlags(0), groups(0)
+#ifdef WLED_ENABLE_FLEET_OTA
+    , fleetVariant(0), fleetImage(0), fleetFlags(0), fleetProgress(FLEET_NO_PROGRESS), fleetMinutes(0)
+#endif
   {
+    nodeName[0] = 0;
     for (uint8_t i = 0; i < 4; ++i) { ip[i] = 0; }
   }
 };
-typedef std::map<uint8_t, NodeStruct> NodesMap;
+
+/*********************************************************************************************\
+* NodeTable: fixed capacity, open addressed (linear probing) by the full IP address.
+* Slots are allocated with the first node, a slot with IP 0.0.0.0 is free.
+\*********************************************************************************************/
+class NodeTable
+{
+  public:
+  NodeTable(uint16_t maxNodes) : _nodes(nullptr), _maxNodes(maxNodes), _slots(maxNodes + maxNodes/3 +1), _count(0) {}
+  ~NodeTable() { delete[] _nodes; }
+
+  inline uint16_t size() const     { return _count; }
+  inline uint16_t capacity() const { return _slots; } //for iterating with at()
+
+  //node in slot i, nullptr if the slot is free
+  NodeStruct* at(uint16_t i) {
+    if (!_nodes || i >= _slots || !uint32_t(_nodes[i].ip)) return nullptr;
+    return &_nodes[i];
+  }
+
+  NodeStruct* find(IPAddress ip) {
+    if (!_nodes || !uint32_t(ip)) return nullptr;
+    for (uint16_t i = home(ip), n = 0; n < _slots; i = next(i), n++) {
+      if (!uint32_t(_nodes[i].ip)) return nullptr;
+      if (_nodes[i].ip == ip) return &_nodes[i];
+    }
+    return nullptr;
+  }
+
+  //existing or new node with this IP, nullptr if the table is full
+  NodeStruct* add(IPAddress ip) {
+    NodeStruct* node = find(ip);
+    if (node || !uint32_t(ip) || _count >= _maxNodes) return node;
+    if (!_nodes) _nodes = new (std::nothrow) NodeStruct[_slots];
+    if (!_nodes) return nullptr;
+    uint16_t i = home(ip);
+    while (uint32_t(_nodes[i].ip)) i = next(i); //there is always a free slot, _slots > _maxNodes
+    _nodes[i] = NodeStruct();
+    _nodes[i].ip = ip;
+    _count++;
+    return &_nodes[i];
+  }
+
+  //frees slot i, nodes after it in the probe sequence move up so find() still reaches them
+  void erase(uint16_t i) {
+    if (!at(i)) return;
+    _nodes[i].ip = (uint32_t)0;
+    _count--;
+    for (uint16_t j = next(i); uint32_t(_nodes[j].ip); j = next(j)) {
+      uint16_t h = home(_nodes[j].ip);
+      //node j stays if its home slot is cyclically in (i, j]
+      if (i <= j ? (i < h && h <= j) : (i < h || h <= j)) continue;
+      _nodes[i] = _nodes[j];
+      _nodes[j].ip = (uint32_t)0;
+      i = j;
+    }
+  }
+
+  //ages all nodes, drops those not heard of for maxAge calls. Erasing moves nodes (also from the start of
+  //the table to its end), so they are aged before any is dropped and slot i is checked again
+  void age(uint8_t maxAge) {
+    for (uint16_t i = 0; i < _slots; i++) {
+      NodeStruct* node = at(i);
+      if (node) node->age++;
+    }
+    for (uint16_t i = 0; i < _slots;) {
+      NodeStruct* node = at(i);
+      if (node && node->age > maxAge) { erase(i); continue; }
+      i++;
+    }
+  }
+
+  void clear() {
+    delete[] _nodes;
+    _nodes = nullptr;
+    _count = 0;
+  }
+
+  private:
+  NodeStruct* _nodes;
+  uint16_t    _maxNodes;
+  uint16_t    _slots;
+  uint16_t    _count;
+
+  inline uint16_t home(IPAddress ip) const { return (uint32_t(ip) * 2654435761UL) % _slots; } //Knuth multiplicative hash
+  inline uint16_t next(uint16_t i) const { return (i +1 < _slots) ? i +1 : 0; }
+};
 
 #endif // WLED_NODESTRUCT_H
@@ -0,0 +1,304 @@
+#include "wled.h"
+
+/*
+ * Audio analysis on its own core (WLED_ENABLE_AUDIO), see audio.h
+ * Samples are DC filtered and Hann windowed, then transformed by a 512 point radix-2 FFT in 32 bit fixed point
+ * (Q15 twiddles, 64 bit products), which takes well below a millisecond on the second core.
+ * Band and volume levels are log2 in 1/256 steps, scaled to 0-255 over the AUDIO_RANGE below a peak that follows
+ * the loudest band with a slow decay, so quiet and loud rooms use the full range. The beat flag is set when the
+ * bass energy exceeds its running average by half, at most every AUDIO_BEAT_HOLDOFF ms.
+ * The snapshot is published with a sequence counter that is odd while it is written (seqlock), so readers
+ * on the other core never see half a snapshot and the analysis never waits for them.
+ */
+#ifdef WLED_ENABLE_AUDIO
+#include "driver/i2s.h"
+
+#ifndef WLED_AUDIO_I2S_PORT
+  #define WLED_AUDIO_I2S_PORT I2S_NUM_0   // the 9th digital bus uses I2S0 as well
+#endif
+#ifndef WLED_AUDIO_SAMPLE_RATE
+  #define WLED_AUDIO_SAMPLE_RATE 22050
+#endif
+#ifndef WLED_AUDIO_SD_PIN
+  #define WLED_AUDIO_SD_PIN 32            // data of the I2S microphone (INMP441, SPH0645...)
+#endif
+#ifndef WLED_AUDIO_WS_PIN
+  #define WLED_AUDIO_WS_PIN 15
+#endif
+#ifndef WLED_AUDIO_SCK_PIN
+  #define WLED_AUDIO_SCK_PIN 14
+#endif
+//#define WLED_AUDIO_ADC_CHANNEL ADC1_CHANNEL_6 // ESP32 only: sample an analog microphone on GPIO34 through I2S0 instead
+#ifndef WLED_AUDIO_TASK_CORE
+  #define WLED_AUDIO_TASK_CORE 0
+#endif
+#ifndef WLED_AUDIO_SYNC_GROUP
+  #define WLED_AUDIO_SYNC_GROUP 239, 0, 0, 1
+#endif
+
+#define AUDIO_RANGE         (8 * 256)  // 48 dB below the peak tracker map to 0-255
+#define AUDIO_PEAK_DECAY    2          // log2/256 per block, 12 dB in ~3 s
+#define AUDIO_BEAT_HOLDOFF  100        // ms
+#define AUDIO_SYNC_MAGIC    "WLAS"
+#define AUDIO_SYNC_VERSION  1
+#define AUDIO_SYNC_SIZE     (4 + 1 + 4 + 3 + AUDIO_BANDS + 2)
+
+static int32_t  audioSamples[AUDIO_FFT_SIZE];
+static int32_t  fftRe[AUDIO_FFT_SIZE], fftIm[AUDIO_FFT_SIZE];
+static int16_t  fftSin[AUDIO_FFT_SIZE * 3 / 4];  // sin(2 pi i / N), cos from a quarter period later
+static int16_t  fftWindow[AUDIO_FFT_SIZE / 2];   // Hann, symmetric
+static uint16_t bandEdge[AUDIO_BANDS + 1];       // first bin of each band, then the bin after the last one
+static TaskHandle_t audioTask = nullptr;
+
+static AudioSnapshot audioShared;
+static volatile uint32_t audioSeq = 0;           // odd while audioShared is written
+static volatile uint32_t audioPublishedMs = 0;
+
+static void publishAudio(const AudioSnapshot& s)
+{
+  audioSeq++;
+  __sync_synchronize();
+  memcpy(&audioShared, &s, sizeof(s));
+  __sync_synchronize();
+  audioSeq++;
+  audioPublishedMs = millis();
+}
+
+bool getAudioSnapshot(AudioSnapshot& out)
+{
+  for (uint8_t tries = 0; tries < 4; tries++) {
+    uint32_t seq = audioSeq;
+    if (seq & 1) continue;
+    __sync_synchronize();
+    memcpy(&out, &audioShared, sizeof(out));
+    __sync_synchronize();
+    if (seq == audioSeq) return seq && millis() - audioPublishedMs < 1000;
+  }
+  return false;
+}
+
+// log2(x) in 1/256 steps, linear between powers of 2
+static uint16_t log2Q8(uint32_t x)
+{
+  if (!x) return 0;
+  uint8_t b = 31 - __builtin_clz(x);
+  uint32_t frac = b >= 8 ? (x >> (b - 8)) & 0xFF : (x << (8 - b)) & 0xFF;
+  return (b << 8) | frac;
+}
+
+static uint8_t scaleLevel(uint16_t logv, uint16_t peak)
+{
+  int32_t v = (int32_t)logv - (peak - AUDIO_RANGE);
+  if (v <= 0) return 0;
+  return v >= AUDIO_RANGE ? 255 : (v * 255) / AUDIO_RANGE;
+}
+
+// in place complex FFT of fftRe/fftIm, input at most 16 bit, output grows by up to AUDIO_FFT_SIZE
+static void fft()
+{
+  const uint16_t n = AUDIO_FFT_SIZE;
+  for (uint16_t i = 1, j = 0; i < n; i++) { // bit reversal
+    uint16_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) { int32_t t = fftRe[i]; fftRe[i] = fftRe[j]; fftRe[j] = t; t = fftIm[i]; fftIm[i] = fftIm[j]; fftIm[j] = t; }
+  }
+  for (uint16_t len = 2; len <= n; len <<= 1) {
+    uint16_t half = len >> 1, step = n / len;
+    for (uint16_t k = 0; k < half; k++) {
+      int32_t wr = fftSin[k * step + n / 4], wi = -fftSin[k * step]; // e^(-2 pi i k / len)
+      for (uint16_t i = k; i < n; i += len) {
+        uint16_t j = i + half;
+        int32_t tr = ((int64_t)fftRe[j] * wr - (int64_t)fftIm[j] * wi) >> 15;
+        int32_t ti = ((int64_t)fftRe[j] * wi + (int64_t)fftIm[j] * wr) >> 15;
+        fftRe[j] = fftRe[i] - tr; fftIm[j] = fftIm[i] - ti;
+        fftRe[i] += tr;           fftIm[i] += ti;
+      }
+    }
+  }
+}
+
+static void analyzeBlock(AudioSnapshot& s)
+{
+  static int32_t  dc = 0;                 // running mean, 8 fractional bits
+  static uint16_t bandPeak = AUDIO_RANGE, volPeak = AUDIO_RANGE;
+  static uint32_t bassAvg = 0;
+  static uint32_t lastBeat = 0;
+  static uint16_t volSmooth = 0;          // 8 fractional bits
+
+  uint64_t energy = 0;
+  for (uint16_t i = 0; i < AUDIO_FFT_SIZE; i++) {
+    int32_t v = audioSamples[i];
+    dc += v - (dc >> 8);
+    v -= dc >> 8;
+    if (v > INT16_MAX) v = INT16_MAX; else if (v < INT16_MIN) v = INT16_MIN;
+    energy += (int64_t)v * v;
+    int16_t w = fftWindow[i < AUDIO_FFT_SIZE / 2 ? i : AUDIO_FFT_SIZE - 1 - i];
+    fftRe[i] = (v * w) >> 15;
+    fftIm[i] = 0;
+  }
+  fft();
+
+  uint16_t squelch = audioSquelch << 4;
+  uint32_t bestMag = 0; uint16_t bestBin = 0;
+  uint16_t bandLog[AUDIO_BANDS];
+  uint16_t maxLog = 0;
+  uint32_t bass = 0;
+  for (uint8_t b = 0; b < AUDIO_BANDS; b++) {
+    uint32_t sum = 0;
+    for (uint16_t k = bandEdge[b]; k < bandEdge[b + 1]; k++) {
+      uint32_t re = abs(fftRe[k]), im = abs(fftIm[k]);
+      uint32_t mag = re > im ? re + (im * 3 >> 3) : im + (re * 3 >> 3); // alpha max plus beta min
+      sum += mag;
+      if (mag > bestMag) { bestMag = mag; bestBin = k; }
+    }
+    if (b < 3) bass += sum;
+    bandLog[b] = log2Q8(sum / (bandEdge[b + 1] - bandEdge[b]));
+    if (bandLog[b] < squelch) bandLog[b] = 0;
+    if (bandLog[b] > maxLog) maxLog = bandLog[b];
+  }
+  bandPeak = (maxLog > bandPeak) ? maxLog : MAX(bandPeak - AUDIO_PEAK_DECAY, squelch + AUDIO_RANGE);
+  for (uint8_t b = 0; b < AUDIO_BANDS; b++) s.bands[b] = scaleLevel(bandLog[b], bandPeak);
+
+  uint16_t volLog = log2Q8(energy / AUDIO_FFT_SIZE) >> 1; // of the RMS
+  if (volLog < squelch) volLog = 0;
+  volPeak = (volLog > volPeak) ? volLog : MAX(volPeak - AUDIO_PEAK_DECAY, squelch + AUDIO_RANGE);
+  s.peak = scaleLevel(volLog, volPeak);
+  volSmooth += ((s.peak << 8) - volSmooth) >> 2;
+  s.volume = volSmooth >> 8;
+  s.majorPeakHz = bestMag ? (uint32_t)bestBin * WLED_AUDIO_SAMPLE_RATE / AUDIO_FFT_SIZE : 0;
+
+  uint32_t now = millis();
+  s.beat = bassAvg && bass > bassAvg + (bassAvg >> 1) && s.bands[0] + s.bands[1] > 64 && now - lastBeat > AUDIO_BEAT_HOLDOFF;
+  if (s.beat) lastBeat = now;
+  bassAvg += ((int32_t)bass - (int32_t)bassAvg) >> 4;
+  s.frame++;
+}
+
+static void audioCapture(void*)
+{
+  AudioSnapshot s = {};
+  for (;;) {
+    if (audioSyncMode == AUDIO_SYNC_RECEIVE) { // snapshots come from the network
+      vTaskDelay(100 / portTICK_PERIOD_MS);
+      continue;
+    }
+    size_t bytes = 0;
+    #ifdef WLED_AUDIO_ADC_CHANNEL
+    uint16_t* raw = (uint16_t*)audioSamples; // 16 bit samples in the first half
+    i2s_read(WLED_AUDIO_I2S_PORT, raw, AUDIO_FFT_SIZE * sizeof(uint16_t), &bytes, portMAX_DELAY);
+    for (int16_t i = AUDIO_FFT_SIZE - 1; i >= 0; i--) audioSamples[i] = ((raw[i] & 0x0FFF) - 2048) * 16; // from the end, in place
+    #else
+    i2s_read(WLED_AUDIO_I2S_PORT, audioSamples, sizeof(audioSamples), &bytes, portMAX_DELAY);
+    for (uint16_t i = 0; i < AUDIO_FFT_SIZE; i++) audioSamples[i] >>= 14; // 24 bit left aligned, keep headroom
+    #endif
+    analyzeBlock(s);
+    publishAudio(s);
+  }
+}
+
+void initAudio()
+{
+  if (audioTask) return;
+  for (uint16_t i = 0; i < AUDIO_FFT_SIZE * 3 / 4; i++) fftSin[i] = lrintf(32767.0f * sinf(2.0f * PI * i / AUDIO_FFT_SIZE));
+  for (uint16_t i = 0; i < AUDIO_FFT_SIZE / 2; i++) fftWindow[i] = lrintf(32767.0f * 0.5f * (1.0f - cosf(2.0f * PI * i / (AUDIO_FFT_SIZE - 1))));
+  // log spaced from bin 1 to the Nyquist frequency, at least one bin per band
+  for (uint8_t b = 0; b <= AUDIO_BANDS; b++) {
+    uint16_t edge = lrintf(powf(AUDIO_FFT_SIZE / 2, (float)b / AUDIO_BANDS));
+    bandEdge[b] = (b && edge <= bandEdge[b - 1]) ? bandEdge[b - 1] + 1 : (b ? edge : 1);
+  }
+  bandEdge[AUDIO_BANDS] = AUDIO_FFT_SIZE / 2;
+
+  i2s_config_t config = {};
+  config.sample_rate = WLED_AUDIO_SAMPLE_RATE;
+  config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+  config.dma_buf_count = 4;
+  config.dma_buf_len = AUDIO_FFT_SIZE / 2;
+  #ifdef WLED_AUDIO_ADC_CHANNEL
+  config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+  config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+  config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+  if (i2s_driver_install(WLED_AUDIO_I2S_PORT, &config, 0, nullptr) != ESP_OK) return;
+  i2s_set_adc_mode(ADC_UNIT_1, WLED_AUDIO_ADC_CHANNEL);
+  i2s_adc_enable(WLED_AUDIO_I2S_PORT);
+  #else
+  if (!pinManager.allocatePin(WLED_AUDIO_SD_PIN, false, PinOwner::Audio)
+   || !pinManager.allocatePin(WLED_AUDIO_WS_PIN, true, PinOwner::Audio)
+   || !pinManager.allocatePin(WLED_AUDIO_SCK_PIN, true, PinOwner::Audio)) {
+    pinManager.deallocatePin(WLED_AUDIO_SD_PIN, PinOwner::Audio);
+    pinManager.deallocatePin(WLED_AUDIO_WS_PIN, PinOwner::Audio);
+    pinManager.deallocatePin(WLED_AUDIO_SCK_PIN, PinOwner::Audio);
+    DEBUG_PRINTLN(F("Audio pins unavailable."));
+    return;
+  }
+  config.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
+  config.bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT;
+  config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+  config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+  if (i2s_driver_install(WLED_AUDIO_I2S_PORT, &config, 0, nullptr) != ESP_OK) return;
+  i2s_pin_config_t pins = {};
+  pins.bck_io_num = WLED_AUDIO_SCK_PIN;
+  pins.ws_io_num = WLED_AUDIO_WS_PIN;
+  pins.data_out_num = I2S_PIN_NO_CHANGE;
+  pins.data_in_num = WLED_AUDIO_SD_PIN;
+  i2s_set_pin(WLED_AUDIO_I2S_PORT, &pins);
+  #endif
+  xTaskCreatePinnedToCore(audioCapture, "audio", 3072, nullptr, 1, &audioTask, WLED_AUDIO_TASK_CORE);
+}
+
+/*
+ * Audio sync over multicast UDP, called from loop(): the sender forwards each new snapshot,
+ * a receiver publishes the snapshots of the sender as its own.
+ * Packet: "WLAS", version, frame (LE), volume, peak, beat, bands, major peak Hz (LE)
+ */
+void handleAudio()
+{
+  static WiFiUDP  audioUdp;
+  static uint8_t  openMode = AUDIO_SYNC_OFF;
+  static uint16_t openPort = 0;
+  static uint32_t sentFrame = 0;
+
+  bool connected = WLED_CONNECTED;
+  if (openMode != AUDIO_SYNC_OFF && (!connected || openMode != audioSyncMode || openPort != audioSyncPort)) {
+    audioUdp.stop();
+    openMode = AUDIO_SYNC_OFF;
+  }
+  if (audioSyncMode == AUDIO_SYNC_OFF || !connected) return;
+  if (openMode == AUDIO_SYNC_OFF) {
+    if (!audioUdp.beginMulticast(IPAddress(WLED_AUDIO_SYNC_GROUP), audioSyncPort)) return;
+    openMode = audioSyncMode;
+    openPort = audioSyncPort;
+  }
+
+  uint8_t buf[AUDIO_SYNC_SIZE];
+  AudioSnapshot s;
+  if (audioSyncMode == AUDIO_SYNC_SEND) {
+    if (!getAudioSnapshot(s) || s.frame == sentFrame) return;
+    sentFrame = s.frame;
+    memcpy(buf, AUDIO_SYNC_MAGIC, 4);
+    buf[4] = AUDIO_SYNC_VERSION;
+    for (uint8_t i = 0; i < 4; i++) buf[5 + i] = s.frame >> (8 * i);
+    buf[9] = s.volume; buf[10] = s.peak; buf[11] = s.beat;
+    memcpy(buf + 12, s.bands, AUDIO_BANDS);
+    buf[12 + AUDIO_BANDS] = s.majorPeakHz; buf[13 + AUDIO_BANDS] = s.majorPeakHz >> 8;
+    audioUdp.beginPacket(IPAddress(WLED_AUDIO_SYNC_GROUP), audioSyncPort);
+    audioUdp.write(buf, sizeof(buf));
+    audioUdp.endPacket();
+    return;
+  }
+
+  while (int len = audioUdp.parsePacket()) {
+    if (len != AUDIO_SYNC_SIZE || audioUdp.read(buf, sizeof(buf)) != AUDIO_SYNC_SIZE) continue;
+    if (memcmp(buf, AUDIO_SYNC_MAGIC, 4) || buf[4] != AUDIO_SYNC_VERSION) continue;
+    s.frame = buf[5] | (buf[6] << 8) | (buf[7] << 16) | ((uint32_t)buf[8] << 24);
+    s.volume = buf[9]; s.peak = buf[10]; s.beat = buf[11];
+    memcpy(s.bands, buf + 12, AUDIO_BANDS);
+    s.majorPeakHz = buf[12 + AUDIO_BANDS] | (buf[13 + AUDIO_BANDS] << 8);
+    publishAudio(s);
+  }
+}
+
+#else
+void initAudio() {}
+void handleAudio() {}
+#endif
@@ -0,0 +1,31 @@
+#ifndef WLED_AUDIO_H
+#define WLED_AUDIO_H
+/*
+ * Build-time optional audio analysis (WLED_ENABLE_AUDIO, ESP32 only)
+ * A task on WLED_AUDIO_TASK_CORE reads blocks of AUDIO_FFT_SIZE samples from an I2S microphone (or the built-in ADC
+ * through I2S DMA), runs a fixed-point FFT and aggregates the bins into AUDIO_BANDS log spaced bands.
+ * The result is published as a snapshot without locking, effects and usermods copy it with getAudioSnapshot().
+ * With audio sync, one node sends its snapshots by multicast UDP and others use them instead of a microphone, see audio.cpp
+ */
+#include <Arduino.h>
+
+#define AUDIO_FFT_SIZE 512  // samples per analyzed block, 23 ms at 22050 Hz
+#define AUDIO_BANDS    16
+
+typedef struct AudioSnapshot {
+  uint32_t frame;              // counts the analyzed (or received) blocks, changes with each new snapshot
+  uint8_t  volume;             // smoothed level 0-255, relative to the loudest recent level (AGC)
+  uint8_t  peak;               // level of the latest block 0-255
+  uint8_t  bands[AUDIO_BANDS]; // 0-255 each, 43 Hz to 11 kHz
+  uint16_t majorPeakHz;        // frequency of the strongest bin
+  bool     beat;               // bass onset in the latest block
+} audio_snapshot;
+
+#ifdef WLED_ENABLE_AUDIO
+// copies the latest snapshot, false (and out unchanged or partial) if there was none within the last second
+bool getAudioSnapshot(AudioSnapshot& out);
+#else
+inline bool getAudioSnapshot(AudioSnapshot& out) { return false; }
+#endif
+
+#endif
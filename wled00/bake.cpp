@@ -0,0 +1,92 @@
+#include "wled.h"
+
+/*
+ * Effect baking via /json/bake (WLED_ENABLE_BAKE).
+ * GET /json/bake?file=3&frames=600&ms=25&ps=12 queues a run, which is done by the main loop between frames
+ * with WS2812FX::bake(): the effect of the main segment is rendered with its current settings and written to
+ * /anim3.wla, which FX_MODE_PLAYBACK plays with intensity 3. Copied to a slower node, the file shows the
+ * effect there without computing it. It blocks the loop (and so the web server's replies) for its duration.
+ * With ps the run also saves preset 12, which switches the main segment to playing the file; the preset only
+ * holds that segment change, so it can be applied on any node that has the file.
+ * GET /json/bake without parameters returns the result of the last run.
+ * Without frames 10 seconds are baked, without ms frames are as far apart as at the target frame rate.
+ */
+#ifdef WLED_ENABLE_BAKE
+
+#ifndef WLED_BAKE_MAX_FRAMES
+  #define WLED_BAKE_MAX_FRAMES 6000
+#endif
+
+static uint8_t  bakeFile = 0;
+static uint16_t bakeFrames = 0;
+static uint16_t bakeMs = 0;
+static uint8_t  bakePreset = 0;
+static volatile bool bakeQueued = false;
+static bool     bakeDone = false;
+static uint32_t bakeSize = 0; // of the file written by the last run, 0 if it failed
+
+// parses the request parameters, returns false if a run is still queued
+static bool requestBake(AsyncWebServerRequest* request)
+{
+  if (bakeQueued) return false;
+  bakeFile = request->hasParam(F("file")) ? request->getParam(F("file"))->value().toInt() : 0;
+  uint16_t ms = request->hasParam(F("ms")) ? request->getParam(F("ms"))->value().toInt() : 0;
+  bakeMs = ms ? ms : 1000 / strip.getTargetFps();
+  uint16_t frames = request->hasParam(F("frames")) ? request->getParam(F("frames"))->value().toInt() : 0;
+  bakeFrames = constrain(frames ? frames : 10000 / bakeMs, 1, WLED_BAKE_MAX_FRAMES);
+  bakePreset = request->hasParam(F("ps")) ? request->getParam(F("ps"))->value().toInt() : 0;
+  if (bakePreset > 250) bakePreset = 0;
+  bakeQueued = true;
+  return true;
+}
+
+// a preset holding only the main segment switched to playing the file
+static void saveBakePreset()
+{
+  if (!requestJSONBufferLock(21)) return;
+  JsonObject root = doc.to<JsonObject>();
+  char name[24];
+  snprintf_P(name, sizeof(name), PSTR("Baked %u"), bakeFile);
+  root["n"] = name;
+  JsonObject seg = root.createNestedArray("seg").createNestedObject();
+  seg["id"] = strip.getMainSegmentId();
+  seg["fx"] = FX_MODE_PLAYBACK;
+  seg["sx"] = 128; // as recorded
+  seg["ix"] = bakeFile;
+  char filename[16];
+  getPresetBankFile(filename, PRESET_BANK_ACTIVE);
+  writeObjectToFileUsingId(filename, bakePreset, &doc);
+  releaseJSONBufferLock();
+  presetsModifiedTime = toki.second(); //unix time
+  dropCachedPreset(bakePreset);
+  invalidateFSInfo();
+}
+
+void handleBake()
+{
+  if (!bakeQueued) return;
+  DEBUG_PRINT(F("Baking ")); DEBUG_PRINT(bakeFrames); DEBUG_PRINTLN(F(" frames"));
+  bakeSize = strip.bake(bakeFile, bakeFrames, bakeMs);
+  if (bakeSize && bakePreset) saveBakePreset();
+  bakeDone = true;
+  bakeQueued = false;
+}
+
+void serveBake(AsyncWebServerRequest* request)
+{
+  if (request->params()) {
+    bool queued = requestBake(request);
+    request->send(queued ? 200 : 409, "application/json", queued ? F("{\"queued\":true}") : F("{\"queued\":false}"));
+    return;
+  }
+  char buf[112];
+  if (bakeDone && !bakeQueued) {
+    snprintf_P(buf, sizeof(buf), PSTR("{\"running\":false,\"file\":\"/anim%u.wla\",\"frames\":%u,\"ms\":%u,\"ps\":%u,\"size\":%u,\"ok\":%s}"),
+      bakeFile, bakeFrames, bakeMs, bakePreset, (unsigned)bakeSize, bakeSize ? "true" : "false");
+  } else {
+    snprintf_P(buf, sizeof(buf), PSTR("{\"running\":%s}"), bakeQueued ? "true" : "false");
+  }
+  request->send(200, "application/json", buf);
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "wled.h"
+
+/*
+ * On-device effect benchmark via /json/bench (WLED_ENABLE_BENCHMARK).
+ * GET /json/bench?frames=50&fx=1,5,9&len=300&out=0 queues a run, which is done by the main loop between frames
+ * with WS2812FX::benchmark(). It blocks the loop (and so the web server's replies) for its duration.
+ * GET /json/bench without parameters returns the results of the last run.
+ * Without fx all effects are run, without len the whole strip is used, out=1 also sends every frame to the LEDs.
+ */
+#ifdef WLED_ENABLE_BENCHMARK
+
+#ifndef WLED_BENCH_MAX_FRAMES
+  #define WLED_BENCH_MAX_FRAMES 1000
+#endif
+
+static uint16_t benchFrames = 20;
+static uint16_t benchLength = 0;
+static bool     benchOutput = false;
+static uint8_t  benchModes[MODE_COUNT];
+static uint8_t  benchCount = 0;
+static volatile bool benchQueued = false;
+static bool     benchValid = false;
+static WS2812FX::bench_result* benchResults = nullptr; // allocated on first run, kept for reporting
+
+// parses the request parameters, returns false if a run is still queued
+static bool requestBenchmark(AsyncWebServerRequest* request)
+{
+  if (benchQueued) return false;
+  uint16_t frames = 20;
+  if (request->hasParam(F("frames"))) frames = request->getParam(F("frames"))->value().toInt();
+  benchFrames = constrain(frames, 1, WLED_BENCH_MAX_FRAMES);
+  benchLength = request->hasParam(F("len")) ? request->getParam(F("len"))->value().toInt() : 0;
+  benchOutput = request->hasParam(F("out")) && request->getParam(F("out"))->value().toInt();
+
+  benchCount = 0;
+  if (request->hasParam(F("fx"))) {
+    const String& list = request->getParam(F("fx"))->value();
+    int pos = 0;
+    while (pos < (int)list.length() && benchCount < MODE_COUNT) {
+      int comma = list.indexOf(',', pos);
+      if (comma < 0) comma = list.length();
+      int id = list.substring(pos, comma).toInt();
+      if (id >= 0 && id < MODE_COUNT) benchModes[benchCount++] = id;
+      pos = comma + 1;
+    }
+  } else {
+    for (uint8_t m = 0; m < MODE_COUNT; m++) benchModes[m] = m;
+    benchCount = MODE_COUNT;
+  }
+  if (!benchCount) return false;
+  benchQueued = true;
+  return true;
+}
+
+void handleBenchmark()
+{
+  if (!benchQueued) return;
+  if (!benchResults) benchResults = (WS2812FX::bench_result*)malloc(MODE_COUNT * sizeof(WS2812FX::bench_result));
+  if (benchResults) {
+    DEBUG_PRINT(F("Benchmark of ")); DEBUG_PRINT(benchCount); DEBUG_PRINTLN(F(" effects"));
+    benchValid = strip.benchmark(benchModes, benchCount, benchFrames, benchLength, benchOutput, benchResults);
+  }
+  benchQueued = false;
+}
+
+// results are written by hand, a document holding all effects would not fit the JSON buffer of small boards
+void serveBenchmark(AsyncWebServerRequest* request)
+{
+  if (request->params()) {
+    bool queued = requestBenchmark(request);
+    request->send(queued ? 200 : 409, "application/json", queued ? F("{\"queued\":true}") : F("{\"queued\":false}"));
+    return;
+  }
+  String json;
+  json.reserve(64 + (benchValid ? benchCount * 40 : 0));
+  json = F("{\"running\":");
+  json += benchQueued ? F("true") : F("false");
+  if (benchValid && !benchQueued) {
+    pixidx_t len = (benchLength && benchLength < strip.getLengthTotal()) ? benchLength : strip.getLengthTotal();
+    char buf[64];
+    snprintf_P(buf, sizeof(buf), PSTR(",\"frames\":%u,\"len\":%u,\"out\":%s,\"fx\":["), benchFrames, (unsigned)len, benchOutput ? "true" : "false");
+    json += buf;
+    for (uint8_t n = 0; n < benchCount; n++) {
+      // per frame effect and show time in us, heap taken by the effect in bytes
+      snprintf_P(buf, sizeof(buf), PSTR("%s{\"id\":%u,\"us\":%u,\"show\":%u,\"heap\":%d}"), n ? "," : "",
+        benchResults[n].mode, (unsigned)benchResults[n].fxUs, (unsigned)benchResults[n].showUs, (int)benchResults[n].heap);
+      json += buf;
+    }
+    json += ']';
+  }
+  json += '}';
+  request->send(200, "application/json", json);
+}
+
+#endif
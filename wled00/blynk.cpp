@@ -1,97 +1,298 @@
 #include "wled.h"
-#include "src/dependencies/blynk/Blynk/BlynkHandlers.h"
 
 /*
  * Remote light control with the free Blynk app
+ *
+ * The Blynk protocol is spoken over an AsyncClient, so a slow or unreachable server never blocks the loop:
+ * connecting, login and heartbeat are a state machine advanced by handleBlynk(), the TCP callbacks only
+ * parse messages. Virtual pin writes of the app are kept as the latest value per pin and applied together
+ * once per loop pass, so a dragged slider causes one state update per frame.
  */
 
+#ifndef WLED_DISABLE_BLYNK
+#define BLYNK_CMD_RESPONSE  0
+#define BLYNK_CMD_LOGIN     2
+#define BLYNK_CMD_PING      6
+#define BLYNK_CMD_INTERNAL 17
+#define BLYNK_CMD_HARDWARE 20
+#define BLYNK_CMD_REDIRECT 41
+
+#define BLYNK_SUCCESS            200
+#define BLYNK_ALREADY_REGISTERED   4
+
+#define BLYNK_HEADER_LEN      5     // command, message ID and length (or status of a response), big endian
+#define BLYNK_MAX_MSG       256     // longer messages are skipped
+#define BLYNK_HEARTBEAT_MS 10000    // ping after this long without traffic
+#define BLYNK_TIMEOUT_MS   2000     // for connect and login, the server is dropped after a heartbeat + 3 timeouts
+#define BLYNK_RETRY_MS     5000     // between connection attempts
+#define BLYNK_PINS            9     // V0..V8
+
+enum : uint8_t { BLYNK_IDLE, BLYNK_CONNECTING, BLYNK_LOGIN, BLYNK_CONNECTED };
+
+static AsyncClient*  blClient = nullptr;
+static volatile uint8_t blState = BLYNK_IDLE;
+static unsigned long blStateTime = 0;   // of the last state change
+static unsigned long blLastIn = 0, blLastOut = 0;
+static uint16_t      blMsgId = 1;
+static uint8_t       blRx[BLYNK_HEADER_LEN + BLYNK_MAX_MSG]; // message being received
+static uint16_t      blRxLen = 0;
+static uint16_t      blRxBody = 0;      // body length of the message being received
+static uint16_t      blRxSkip = 0;      // bytes of an oversized message still to skip
+static char          blAuth[36] = "";
+static char          blHost[33] = "";
+static uint16_t      blPort = 80;
+static bool          blRedirect = false; // connect to blHost/blPort at once
+static volatile bool blSendState = false; // logged in, the app gets the current state
+
+// latest value written by the app to each virtual pin, applied by handleBlynk()
+static volatile int32_t blPinValue[BLYNK_PINS];
+static volatile bool    blPinPending[BLYNK_PINS];
+
 uint16_t blHue = 0;
 byte blSat = 255;
 
-void initBlynk(const char *auth, const char *host, uint16_t port)
+static void blynkSetState(uint8_t state)
 {
-  #ifndef WLED_DISABLE_BLYNK
-  if (!WLED_CONNECTED) return;
-  blynkEnabled = (auth[0] != 0);
-  if (blynkEnabled) Blynk.config(auth, host, port);
-  #endif
+  blState = state;
+  blStateTime = millis();
 }
 
-void handleBlynk()
+//len is the status of a response, which has no body
+static void blynkSend(uint8_t cmd, uint16_t id, const char* body, uint16_t len)
 {
-  #ifndef WLED_DISABLE_BLYNK
-  if (WLED_CONNECTED && blynkEnabled)
-  Blynk.run();
-  #endif
+  uint16_t bodyLen = (cmd == BLYNK_CMD_RESPONSE) ? 0 : len;
+  if (!blClient || !blClient->connected() || blClient->space() < (size_t)BLYNK_HEADER_LEN + bodyLen) return;
+  uint8_t hdr[BLYNK_HEADER_LEN] = {cmd, (uint8_t)(id >> 8), (uint8_t)id, (uint8_t)(len >> 8), (uint8_t)len};
+  blClient->add((const char*)hdr, sizeof(hdr));
+  if (bodyLen) blClient->add(body, bodyLen);
+  blClient->send();
+  blLastOut = millis();
 }
 
-void updateBlynk()
+static inline uint16_t blynkNextId()
 {
-  #ifndef WLED_DISABLE_BLYNK
-  if (!WLED_CONNECTED) return;
-  Blynk.virtualWrite(V0, bri);
-  //we need a RGB -> HSB convert here
-  Blynk.virtualWrite(V3, bri? 1:0);
-  Blynk.virtualWrite(V4, effectCurrent);
-  Blynk.virtualWrite(V5, effectSpeed);
-  Blynk.virtualWrite(V6, effectIntensity);
-  Blynk.virtualWrite(V7, nightlightActive);
-  Blynk.virtualWrite(V8, notifyDirect);
-  #endif
+  if (++blMsgId == 0) blMsgId = 1; // 0 is invalid
+  return blMsgId;
 }
 
-#ifndef WLED_DISABLE_BLYNK
-BLYNK_WRITE(V0)
+//virtual pin write, "vw\0<pin>\0<value>"
+static void blynkVirtualWrite(uint8_t pin, int32_t value)
 {
-  bri = param.asInt();//bri
-  stateUpdated(CALL_MODE_BLYNK);
+  char body[24];
+  int len = snprintf_P(body, sizeof(body), PSTR("vw%c%u%c%d"), 0, pin, 0, value);
+  if (len <= 0 || len >= (int)sizeof(body)) return;
+  blynkSend(BLYNK_CMD_HARDWARE, blynkNextId(), body, len);
 }
 
-BLYNK_WRITE(V1)
+//parameters are 0-separated, returns the n-th or nullptr
+static const char* blynkParam(const char* body, uint16_t len, uint8_t n)
 {
-  blHue = param.asInt();//hue
-  colorHStoRGB(blHue*10,blSat,col);
-  colorUpdated(CALL_MODE_BLYNK);
+  const char* p = body;
+  const char* end = body + len;
+  while (n--) {
+    p = (const char*)memchr(p, 0, end - p);
+    if (!p) return nullptr;
+    p++;
+  }
+  return p < end ? p : nullptr;
 }
 
-BLYNK_WRITE(V2)
+//TCP callback, one complete message
+static void blynkMessage(uint8_t cmd, uint16_t id, uint16_t len, char* body)
 {
-  blSat = param.asInt();//sat
-  colorHStoRGB(blHue*10,blSat,col);
-  colorUpdated(CALL_MODE_BLYNK);
+  blLastIn = millis();
+  switch (cmd) {
+    case BLYNK_CMD_RESPONSE: // len is the status
+      if (blState != BLYNK_LOGIN || id != 1) break;
+      if (len == BLYNK_SUCCESS || len == BLYNK_ALREADY_REGISTERED) {
+        DEBUG_PRINTLN(F("Blynk ready"));
+        static const char info[] PROGMEM = "ver\0" "0.6.1\0" "h-beat\0" "10\0" "buff-in\0" "256\0" "dev\0" "WLED";
+        char buf[sizeof(info)];
+        memcpy_P(buf, info, sizeof(info));
+        blynkSend(BLYNK_CMD_INTERNAL, blynkNextId(), buf, sizeof(info) - 1);
+        blynkSetState(BLYNK_CONNECTED);
+        blSendState = true;
+      } else {
+        DEBUG_PRINTF("Blynk login failed: %u\n", len);
+        blClient->close(true); // invalid token, retried after BLYNK_RETRY_MS
+      }
+      break;
+    case BLYNK_CMD_PING:
+      blynkSend(BLYNK_CMD_RESPONSE, id, nullptr, BLYNK_SUCCESS);
+      break;
+    case BLYNK_CMD_LOGIN:
+      blynkSend(BLYNK_CMD_RESPONSE, id, nullptr, BLYNK_SUCCESS);
+      break;
+    case BLYNK_CMD_REDIRECT: { // "<host>\0<port>"
+      const char* port = blynkParam(body, len, 1);
+      strlcpy(blHost, body, sizeof(blHost));
+      blPort = port ? atoi(port) : 80;
+      blRedirect = true;
+      blClient->close(true);
+      break;
+    }
+    case BLYNK_CMD_HARDWARE: {
+      if (len < 3 || body[0] != 'v' || body[1] != 'w') break;
+      const char* pin = blynkParam(body, len, 1);
+      const char* val = blynkParam(body, len, 2);
+      if (!pin || !val) break;
+      uint8_t p = atoi(pin);
+      if (p >= BLYNK_PINS) break;
+      blPinValue[p] = atoi(val);
+      __sync_synchronize(); // value before the flag
+      blPinPending[p] = true;
+      break;
+    }
+  }
 }
 
-BLYNK_WRITE(V3)
+static void onBlynkData(void* arg, AsyncClient* client, void* data, size_t len)
 {
-  bool on = (param.asInt()>0);
-  if (!on != !bri) {toggleOnOff(); stateUpdated(CALL_MODE_BLYNK);}
+  const uint8_t* in = (const uint8_t*)data;
+  while (len) {
+    if (blRxSkip) {
+      size_t n = MIN(len, (size_t)blRxSkip);
+      blRxSkip -= n; in += n; len -= n;
+      continue;
+    }
+    if (blRxLen < BLYNK_HEADER_LEN) {
+      blRx[blRxLen++] = *in++; len--;
+      if (blRxLen < BLYNK_HEADER_LEN) continue;
+      blRxBody = (blRx[0] == BLYNK_CMD_RESPONSE) ? 0 : (blRx[3] << 8) | blRx[4];
+      if (blRxBody > BLYNK_MAX_MSG - 1) { // keep a byte to 0-terminate
+        blRxSkip = blRxBody;
+        blRxLen = 0;
+        continue;
+      }
+    } else {
+      size_t n = MIN(len, (size_t)(BLYNK_HEADER_LEN + blRxBody - blRxLen));
+      memcpy(blRx + blRxLen, in, n);
+      blRxLen += n; in += n; len -= n;
+    }
+    if (blRxLen < BLYNK_HEADER_LEN + blRxBody) continue;
+    blRx[blRxLen] = 0;
+    blRxLen = 0;
+    blynkMessage(blRx[0], (blRx[1] << 8) | blRx[2], (blRx[3] << 8) | blRx[4], (char*)blRx + BLYNK_HEADER_LEN);
+  }
 }
 
-BLYNK_WRITE(V4)
+static void onBlynkConnect(void* arg, AsyncClient* client)
 {
-  effectCurrent = param.asInt()-1;//fx
-  colorUpdated(CALL_MODE_BLYNK);
+  DEBUG_PRINTLN(F("Blynk connected"));
+  blRxLen = blRxSkip = 0;
+  blMsgId = 1;
+  blynkSend(BLYNK_CMD_LOGIN, 1, blAuth, strlen(blAuth));
+  blynkSetState(BLYNK_LOGIN);
 }
 
-BLYNK_WRITE(V5)
+static void onBlynkDisconnect(void* arg, AsyncClient* client)
+{
+  DEBUG_PRINTLN(F("Blynk disconnected"));
+  blynkSetState(BLYNK_IDLE);
+}
+#endif
+
+void initBlynk(const char *auth, const char *host, uint16_t port)
 {
-  effectSpeed = param.asInt();//sx
-  colorUpdated(CALL_MODE_BLYNK);
+  #ifndef WLED_DISABLE_BLYNK
+  if (!WLED_CONNECTED) return;
+  blynkEnabled = (auth[0] != 0);
+  strlcpy(blAuth, auth, sizeof(blAuth));
+  strlcpy(blHost, host, sizeof(blHost));
+  blPort = port;
+  if (blClient && blClient->connected()) blClient->close(true); // connects with the new settings
+  blynkSetState(BLYNK_IDLE);
+  blStateTime -= BLYNK_RETRY_MS;
+  #endif
 }
 
-BLYNK_WRITE(V6)
+#ifndef WLED_DISABLE_BLYNK
+//the virtual pins written since the last pass, one state update for all of them
+static void applyBlynkPins()
 {
-  effectIntensity = param.asInt();//ix
-  colorUpdated(CALL_MODE_BLYNK);
+  bool colorChanged = false, stateChanged = false;
+  for (uint8_t p = 0; p < BLYNK_PINS; p++) {
+    if (!blPinPending[p]) continue;
+    blPinPending[p] = false;
+    __sync_synchronize();
+    int32_t v = blPinValue[p];
+    switch (p) {
+      case 0: bri = v; stateChanged = true; break;
+      case 1: blHue = v; colorHStoRGB(blHue*10, blSat, col); colorChanged = true; break;
+      case 2: blSat = v; colorHStoRGB(blHue*10, blSat, col); colorChanged = true; break;
+      case 3: if (!(v > 0) != !bri) { toggleOnOff(); stateChanged = true; } break;
+      case 4: effectCurrent = v - 1; colorChanged = true; break;
+      case 5: effectSpeed = v;       colorChanged = true; break;
+      case 6: effectIntensity = v;   colorChanged = true; break;
+      case 7: nightlightActive = (v > 0); break;
+      case 8: notifyDirect = (v > 0); break; //send notifications
+    }
+  }
+  if (colorChanged) colorUpdated(CALL_MODE_BLYNK);
+  else if (stateChanged) stateUpdated(CALL_MODE_BLYNK);
 }
+#endif
 
-BLYNK_WRITE(V7)
+void handleBlynk()
 {
-  nightlightActive = (param.asInt()>0);
+  #ifndef WLED_DISABLE_BLYNK
+  if (!blynkEnabled || !WLED_CONNECTED) {
+    if (blClient && blClient->connected()) blClient->close(true);
+    return;
+  }
+  unsigned long now = millis();
+  switch (blState) {
+    case BLYNK_IDLE:
+      if (!blRedirect && now - blStateTime < BLYNK_RETRY_MS) break;
+      blRedirect = false;
+      if (!blClient) {
+        blClient = new AsyncClient();
+        if (!blClient) break;
+        blClient->onConnect(&onBlynkConnect, blClient);
+        blClient->onData(&onBlynkData, blClient);
+        blClient->onDisconnect(&onBlynkDisconnect, blClient);
+      }
+      blynkSetState(BLYNK_CONNECTING); // before connect(), which may call back at once
+      if (!blClient->connect(blHost, blPort)) blynkSetState(BLYNK_IDLE); // name resolution or connection continue in the background
+      break;
+    case BLYNK_CONNECTING:
+    case BLYNK_LOGIN:
+      if (now - blStateTime > BLYNK_TIMEOUT_MS * (blState == BLYNK_CONNECTING ? 3 : 1)) {
+        DEBUG_PRINTLN(F("Blynk timeout"));
+        blClient->close(true);
+        blynkSetState(BLYNK_IDLE);
+      }
+      break;
+    case BLYNK_CONNECTED:
+      if (now - blLastIn > BLYNK_HEARTBEAT_MS + 3 * BLYNK_TIMEOUT_MS) {
+        DEBUG_PRINTLN(F("Blynk heartbeat timeout"));
+        blClient->close(true);
+        blynkSetState(BLYNK_IDLE);
+        break;
+      }
+      if ((now - blLastIn > BLYNK_HEARTBEAT_MS || now - blLastOut > BLYNK_HEARTBEAT_MS) && now - blLastOut > BLYNK_TIMEOUT_MS)
+        blynkSend(BLYNK_CMD_PING, blynkNextId(), nullptr, 0);
+      if (blSendState) {
+        blSendState = false;
+        updateBlynk();
+      }
+      applyBlynkPins();
+      break;
+  }
+  #endif
 }
 
-BLYNK_WRITE(V8)
+void updateBlynk()
 {
-  notifyDirect = (param.asInt()>0); //send notifications
+  #ifndef WLED_DISABLE_BLYNK
+  if (!WLED_CONNECTED || blState != BLYNK_CONNECTED) return;
+  blynkVirtualWrite(0, bri);
+  //we need a RGB -> HSB convert here
+  blynkVirtualWrite(3, bri? 1:0);
+  blynkVirtualWrite(4, effectCurrent);
+  blynkVirtualWrite(5, effectSpeed);
+  blynkVirtualWrite(6, effectIntensity);
+  blynkVirtualWrite(7, nightlightActive);
+  blynkVirtualWrite(8, notifyDirect);
+  #endif
 }
-#endif
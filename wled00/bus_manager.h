@@ -6,6 +6,7 @@
  */
 
 #include "const.h"
+#include "wled_alloc.h"
 #include "pin_manager.h"
 #include "bus_wrapper.h"
 #include <Arduino.h>
@@ -39,17 +40,65 @@ void colorRGBtoRGBW(byte* rgb);
 #define B(c) (byte(c))
 #define W(c) (byte((c) >> 24))
 
+//packed color math: R,B and W,G are processed as pairs, two channels per 32 bit multiply or add
+//scales all four channels by f/256 (f 0-256)
+inline uint32_t scalePackedBy(uint32_t c, uint16_t f)
+{
+  return (((c & 0x00FF00FF) * f >> 8) & 0x00FF00FF) | ((((c >> 8) & 0x00FF00FF) * f) & 0xFF00FF00);
+}
+
+//scale8() on all four channels
+inline uint32_t scalePacked(uint32_t c, uint8_t scale)
+{
+  return scalePackedBy(c, (uint16_t)scale + 1);
+}
+
+//(c1 * (255-blend) + c2 * blend) >> 8 on all four channels, the products of a pair stay below 2^16
+inline uint32_t blendPacked(uint32_t c1, uint32_t c2, uint8_t blend)
+{
+  uint32_t inv = 255 - blend;
+  uint32_t rb = ((c1 & 0x00FF00FF) * inv + (c2 & 0x00FF00FF) * blend) >> 8;
+  uint32_t wg = ((c1 >> 8) & 0x00FF00FF) * inv + ((c2 >> 8) & 0x00FF00FF) * blend;
+  return (rb & 0x00FF00FF) | (wg & 0xFF00FF00);
+}
+
+//qadd8() on all four channels
+inline uint32_t qaddPacked(uint32_t a, uint32_t b)
+{
+  uint32_t lo  = (a & 0x7F7F7F7F) + (b & 0x7F7F7F7F);            //carries stop at bit 7 of each channel
+  uint32_t sum = lo ^ ((a ^ b) & 0x80808080);                     //sum modulo 256
+  uint32_t ovf = ((a & b) | ((a | b) & lo)) & 0x80808080;         //carry out of bit 7
+  return sum | ((ovf >> 7) * 0xFF);
+}
+
+//part of the data realtimeBroadcast() sends to one destination, one per network bus
+struct NetOutput {
+  const uint8_t* data;  //3 or 4 channels per LED
+  uint16_t leds;
+  uint8_t  bri;
+  bool     rgbw;
+  uint16_t universe;    //E1.31 / Art-Net
+  uint32_t channel;     //in universe (E1.31 / Art-Net) or DDP data offset
+};
+
 //temporary struct for passing bus configuration to bus
 struct BusConfig {
   uint8_t type = TYPE_WS2812_RGB;
   uint16_t count;
-  uint16_t start;
+  pixidx_t start;
   uint8_t colorOrder;
   bool reversed;
   uint8_t skipAmount;
   bool refreshReq;
   uint8_t pins[5] = {LEDPIN, 255, 255, 255, 255};
-  BusConfig(uint8_t busType, uint8_t* ppins, uint16_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0) {
+  bool mirrorSections = false; //every second section is fed from its far end
+  uint16_t clockKHz = 0;       //hardware SPI clock, 0 for the default of the type
+  bool     netRgbw = false;     //network bus sends 4 channels per LED
+  uint16_t netUniverse = 0;    //E1.31 / Art-Net universe of the first LED
+  uint32_t netChannel = 0;     //first channel, of that universe (E1.31 / Art-Net) or of the DDP data
+  bool     follower = false;    //network bus added for a stream follower, not part of the LED settings
+  uint8_t  psu = 0;             //power supply, 0: the main one (ablMilliampsMax), else index+1 of WS2812FX::psuMilliampsMax
+  BusConfig(uint8_t busType, uint8_t* ppins, pixidx_t pstart, uint16_t len = 1, uint8_t pcolorOrder = COL_ORDER_GRB, bool rev = false, uint8_t skip = 0) {
     refreshReq = (bool) GET_BIT(busType,7);
     type = busType & 0x7F;  // bit 7 may be/is hacked to include refresh info (1=refresh in off state, 0=no refresh)
     count = len; start = pstart; colorOrder = pcolorOrder; reversed = rev; skipAmount = skip;
@@ -58,10 +107,39 @@ struct BusConfig {
     else if (type > 47) nPins = 2;
     else if (type > 40 && type < 46) nPins = NUM_PWM_PINS(type);
     for (uint8_t i = 0; i < nPins; i++) pins[i] = ppins[i];
+    if (type == TYPE_NET_E131_RGB) netUniverse = 1; // E1.31 has no universe 0
+  }
+
+  //start and channel layout of a network bus, E1.31 / Art-Net channels past a universe (512) continue in the next ones
+  void setNetOutput(bool rgbw, uint16_t universe, uint32_t channel) {
+    netRgbw = rgbw; netUniverse = universe; netChannel = channel;
+    if (type == TYPE_NET_E131_RGB || type == TYPE_NET_ARTNET_RGB) {
+      netUniverse += channel / 512;
+      netChannel   = channel % 512;
+    }
+  }
+
+  //a one-wire digital bus given more than one data pin is split into equally long sections,
+  //one per pin, that are sent out in parallel (ESP32 only)
+  void setSectionPins(const uint8_t* ppins, bool mirror) {
+    if (!IS_DIGITAL(type) || IS_2PIN(type)) return;
+    for (uint8_t i = 1; i < 5; i++) pins[i] = ppins[i];
+    mirrorSections = mirror;
+  }
+
+  uint8_t sections() const {
+    #ifdef ARDUINO_ARCH_ESP32
+    if (!IS_DIGITAL(type) || IS_2PIN(type)) return 1;
+    uint8_t n = 1;
+    while (n < 5 && pins[n] != 255) n++;
+    return n;
+    #else
+    return 1;
+    #endif
   }
 
   //validates start and length and extends total if needed
-  bool adjustBounds(uint16_t& total) {
+  bool adjustBounds(pixidx_t& total) {
     if (!count) count = 1;
     if (count > MAX_LEDS_PER_BUS) count = MAX_LEDS_PER_BUS;
     if (start >= MAX_LEDS) return false;
@@ -75,13 +153,19 @@ struct BusConfig {
 
 // Defines an LED Strip and its color ordering.
 struct ColorOrderMapEntry {
-  uint16_t start;
+  pixidx_t start;
   uint16_t len;
   uint8_t colorOrder;
 };
 
+//pixels [previous end, end) of a bus use colorOrder, see BusDigital::updateColorOrderRuns()
+struct ColorOrderRun {
+  uint16_t end;
+  uint8_t colorOrder;
+};
+
 struct ColorOrderMap {
-  void add(uint16_t start, uint16_t len, uint8_t colorOrder) {
+  void add(pixidx_t start, uint16_t len, uint8_t colorOrder) {
     if (_count >= WLED_MAX_COLOR_ORDER_MAPPINGS) {
       return;
     }
@@ -113,7 +197,7 @@ struct ColorOrderMap {
     return &(_mappings[n]);
   }
 
-  inline uint8_t IRAM_ATTR getPixelColorOrder(uint16_t pix, uint8_t defaultColorOrder) const {
+  inline uint8_t IRAM_ATTR getPixelColorOrder(pixidx_t pix, uint8_t defaultColorOrder) const {
     if (_count == 0) return defaultColorOrder;
 
     for (uint8_t i = 0; i < _count; i++) {
@@ -124,15 +208,80 @@ struct ColorOrderMap {
     return defaultColorOrder;
   }
 
+  //true if any mapping covers a pixel in [start, start+len)
+  bool overlaps(pixidx_t start, uint16_t len) const {
+    for (uint8_t i = 0; i < _count; i++) {
+      if (_mappings[i].start < start + len && start < _mappings[i].start + _mappings[i].len) return true;
+    }
+    return false;
+  }
+
   private:
   uint8_t _count;
   ColorOrderMapEntry _mappings[WLED_MAX_COLOR_ORDER_MAPPINGS];
 };
 
+#define BUS_FRAME_HASH_SEED 2166136261UL
+#define BUS_NETWORK_KEEPALIVE 1000 //ms after which an unchanged frame is sent again to network busses
+#define BUS_LATCH_TIME_US 300      //reset pause of WS2813 and newer chips, older ones latch after 50µs
+#define BUS_MIN_SHOW_INTERVAL_US 8000 //PWM and network busses have no wire time to pace them, at most 125 frames/s
+
+//ESP32: network busses are sent from a background task, so show() does not wait for WiFi
+#if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_NET_OUTPUT_TASK)
+  #define BUS_NETWORK_TASK
+  #ifndef BUS_NETWORK_TASK_STACK
+    #define BUS_NETWORK_TASK_STACK 4096
+  #endif
+  #ifndef BUS_NETWORK_TASK_CORE
+    #define BUS_NETWORK_TASK_CORE 0 //same core as the WiFi and lwIP tasks
+  #endif
+#endif
+
+//encoded output buffer of a bus, handed out by Bus::getPixelBuffer()
+struct BusPixelBuffer {
+  uint8_t* data;  //first byte of logical pixel 0
+  int8_t   step;  //bytes from one logical pixel to the next, negative on reversed busses
+  uint8_t  offR, offG, offB, offW; //channel positions within a pixel, offW is 255 on RGB busses
+  uint16_t len;   //logical pixels
+  uint16_t scale; //bus brightness + 1, applied like NeoPixelBrightnessBus does
+
+  inline void setPixelColor(uint16_t pix, uint32_t c) {
+    uint8_t* p = data + (int32_t)pix * step;
+    c = scalePackedBy(c, scale);
+    p[offR] = R(c);
+    p[offG] = G(c);
+    p[offB] = B(c);
+    if (offW != 255) p[offW] = W(c);
+  }
+
+  //the color as written, with the brightness taken out again (up to rounding)
+  inline uint32_t getPixelColor(uint16_t pix) const {
+    const uint8_t* p = data + (int32_t)pix * step;
+    return RGBW32(restore(p[offR]), restore(p[offG]), restore(p[offB]), offW != 255 ? restore(p[offW]) : 0);
+  }
+
+  inline uint8_t restore(uint8_t v) const {
+    uint16_t r = ((uint16_t)v << 8) / scale;
+    return r > 255 ? 255 : r;
+  }
+};
+
+//output statistics of a bus, kept by BusManager
+struct BusStats {
+  uint32_t frames   = 0; //frames sent
+  uint32_t skipped  = 0; //unchanged frames that were not sent
+  uint32_t stalls   = 0; //frames sent while the bus was still busy with the previous one
+  uint16_t showTime = 0; //µs the last show() call took
+  uint16_t wireTime = 0; //µs from the last show() until the bus was ready again, with main loop resolution
+  uint32_t sentAt   = 0; //micros() of the last show()
+  bool     pending  = false; //wire time of the last frame not measured yet
+  bool     deferred = false; //a changed frame waits for the minimum interval of the bus
+};
+
 //parent class of BusDigital, BusPwm, and BusNetwork
 class Bus {
   public:
-    Bus(uint8_t type, uint16_t start) {
+    Bus(uint8_t type, pixidx_t start) {
       _type = type;
       _start = start;
     };
@@ -143,20 +292,44 @@ class Bus {
     virtual bool     canShow() { return true; }
 		virtual void     setStatusPixel(uint32_t c) {}
     virtual void     setPixelColor(uint16_t pix, uint32_t c) {}
+    //sets count consecutive pixels starting at pix, no index check
+    virtual void     setPixelColors(uint16_t pix, uint16_t count, const uint32_t* c) {
+      for (uint16_t i = 0; i < count; i++) setPixelColor(pix + i, c[i]);
+    }
     virtual uint32_t getPixelColor(uint16_t pix) { return 0; }
+    //reads count consecutive pixels starting at pix, no index check
+    virtual void     getPixelColors(uint16_t pix, uint16_t count, uint32_t* c) {
+      for (uint16_t i = 0; i < count; i++) c[i] = getPixelColor(pix + i);
+    }
+    //direct access to the output buffer for writers that handle color order and brightness themselves.
+    //Only granted while no per-pixel processing (auto white, CCT correction, color order map) applies;
+    //writes bypass frame tracking, so the bus is sent out on the next show()
+    virtual bool     getPixelBuffer(BusPixelBuffer &buf) { return false; }
     virtual void     setBrightness(uint8_t b) {}
+    //16 bit brightness (0-65535) for outputs that resolve more than 8 bit, call after setBrightness(), which resets it to b * 257
+    virtual void     setBrightnessFine(uint16_t b) {}
     virtual void     cleanup() {}
     virtual uint8_t  getPins(uint8_t* pinArray) { return 0; }
     virtual uint16_t getLength() { return _len; }
-    virtual void     setColorOrder() {}
+    virtual void     setColorOrder(uint8_t colorOrder) {}
+    virtual void     updateColorOrderRuns() {} //the color order map changed
     virtual uint8_t  getColorOrder() { return COL_ORDER_RGB; }
     virtual uint8_t  skippedLeds() { return 0; }
-    inline  uint16_t getStart() { return _start; }
-    inline  void     setStart(uint16_t start) { _start = start; }
+    virtual uint8_t  getSections() { return 1; } //driver channels used, see BusSplit
+    virtual bool     sectionsMirrored() { return false; }
+    virtual uint16_t getClockKHz() { return 0; }
+    //µs the transfer of a frame continues after show() returned, 0 if show() blocks until the data is out
+    virtual uint32_t getWireTime() { return 0; }
+    //least µs between two frames, for busses whose output is not paced by a transfer
+    virtual uint32_t getMinInterval() { return 0; }
+    inline  pixidx_t getStart() { return _start; }
+    inline  void     setStart(pixidx_t start) { _start = start; }
     inline  uint8_t  getType() { return _type; }
     inline  bool     isOk() { return _valid; }
     inline  bool     isOffRefreshRequired() { return _needsRefresh; }
-            bool     containsPixel(uint16_t pix) { return pix >= _start && pix < _start+_len; }
+    inline  void     forceShow() { _forceShow = true; }
+    inline  BusStats& getStats() { return _stats; }
+            bool     containsPixel(pixidx_t pix) { return pix >= _start && pix < _start+_len; }
 
     virtual bool isRgbw() { return Bus::isRgbw(_type); }
     static  bool isRgbw(uint8_t type) {
@@ -166,6 +339,9 @@ class Bus {
     }
     static void setCCT(uint16_t cct) {
       _cct = cct;
+      #ifdef WLED_WHITE_BALANCE_LUT
+      if (_cct >= 1900 && _cct != _balanceLUT->kelvin) selectBalanceLUT();
+      #endif
     }
 		static void setCCTBlend(uint8_t b) {
 			if (b > 100) b = 100;
@@ -178,31 +354,110 @@ class Bus {
 		inline static void    setAutoWhiteMode(uint8_t m) { if (m < 4) _autoWhiteMode = m; }
 		inline static uint8_t getAutoWhiteMode() { return _autoWhiteMode; }
 
+    //sum of the channel values of all pixels, the "power units" used by WS2812FX::estimateCurrentAndLimitBri()
+    virtual uint32_t getPowerSum() {
+      uint32_t sum = 0;
+      for (uint16_t i = 0; i < getLength(); i++) sum += pixelPower(getPixelColor(i));
+      return sum;
+    }
+    static uint16_t pixelPower(uint32_t c) {
+      if (_powerModelWS2815) { //ignore white component on WS2815 power calculation
+        uint8_t m = R(c) > G(c) ? R(c) : G(c);
+        if (B(c) > m) m = B(c);
+        return m * 3;
+      }
+      return R(c) + G(c) + B(c) + W(c);
+    }
+    static void setPowerModel(bool ws2815) {
+      if (ws2815 == _powerModelWS2815) return;
+      _powerModelWS2815 = ws2815;
+      _powerModelVersion++;
+    }
+    inline uint16_t getCurrent() { return _milliamps; }
+    inline void     setCurrent(uint16_t mA) { _milliamps = mA; }
+
+    //true if the pixels written since the last frame would change the bus output. Resets tracking for the next frame
+    virtual bool frameChanged() {
+      bool changed = hasFrameChanged();
+      if (_frameWritten) _shownHash = _frameHash;
+      _frameHash = BUS_FRAME_HASH_SEED;
+      _frameWritten = _forceShow = false;
+      return changed;
+    }
+    //same as frameChanged(), without resetting the tracking
+    inline bool hasFrameChanged() {
+      return !_trackFrames || _needsRefresh || _forceShow || (_frameWritten && _frameHash != _shownHash);
+    }
+
     bool reversed = false;
+    uint8_t psu = 0; //power supply the current is limited by, see BusConfig
+    uint32_t memUsed = 0; //estimated heap held by the driver, set by BusManager
 
   protected:
     uint8_t  _type = TYPE_NONE;
     uint8_t  _bri = 255;
-    uint16_t _start = 0;
+    pixidx_t _start = 0; //first strip pixel, pixel indices of the bus methods are relative to it
     uint16_t _len = 1;
     bool     _valid = false;
     bool     _needsRefresh = false;
+    bool     _hasWhite = false;    //auto-white applies to this bus
+    bool     _trackFrames = false; //skip show() of unchanged frames, requires hashPixel() on each write
+    bool     _forceShow = true;
+    bool     _frameWritten = false;
+    uint32_t _frameHash = BUS_FRAME_HASH_SEED;
+    uint32_t _shownHash = 0;
+    uint16_t _milliamps = 0; //estimated current, updated by WS2812FX::estimateCurrentAndLimitBri()
+    BusStats _stats;
+    static bool    _powerModelWS2815;
+    static uint8_t _powerModelVersion;
     static uint8_t _autoWhiteMode;
     static int16_t _cct;
 		static uint8_t _cctBlend;
-  
-    uint32_t autoWhiteCalc(uint32_t c) {
-      if (_autoWhiteMode == RGBW_MODE_MANUAL_ONLY) return c;
+    #ifdef WLED_WHITE_BALANCE_LUT
+    //segments with differing CCT switch tables several times per frame, so recently used ones are kept
+    struct BalanceLUT {
+      int16_t kelvin;                  //color temperature the tables were built for, 0: unused
+      uint8_t lastUse;
+      uint8_t ch[3][256];
+    };
+    static BalanceLUT  _balanceLUTs[WLED_WB_LUT_ENTRIES];
+    static BalanceLUT* _balanceLUT;    //tables for the current CCT
+    static uint8_t     _balanceClock;
+    static void        selectBalanceLUT();
+    #endif
+
+    //white balance correction for the current CCT, only valid if _cct >= 1900
+    static inline uint32_t colorBalance(uint32_t c) {
+      #ifdef WLED_WHITE_BALANCE_LUT
+      return RGBW32(_balanceLUT->ch[0][R(c)], _balanceLUT->ch[1][G(c)], _balanceLUT->ch[2][B(c)], W(c));
+      #else
+      return colorBalanceFromKelvin(_cct, c);
+      #endif
+    }
+
+    //auto-white mode this bus applies, fetch once per span of pixels
+    inline uint8_t whiteMode() {
+      return _hasWhite ? _autoWhiteMode : RGBW_MODE_MANUAL_ONLY;
+    }
+
+    static uint32_t autoWhiteCalc(uint32_t c, uint8_t mode) {
+      if (mode == RGBW_MODE_MANUAL_ONLY) return c;
       uint8_t w = W(c);
       //ignore auto-white calculation if w>0 and mode DUAL (DUAL behaves as BRIGHTER if w==0)
-      if (w > 0 && _autoWhiteMode == RGBW_MODE_DUAL) return c;
+      if (w > 0 && mode == RGBW_MODE_DUAL) return c;
       uint8_t r = R(c);
       uint8_t g = G(c);
       uint8_t b = B(c);
       w = r < g ? (r < b ? r : b) : (g < b ? g : b);
-      if (_autoWhiteMode == RGBW_MODE_AUTO_ACCURATE) { r -= w; g -= w; b -= w; } //subtract w in ACCURATE mode
+      if (mode == RGBW_MODE_AUTO_ACCURATE) { r -= w; g -= w; b -= w; } //subtract w in ACCURATE mode
       return RGBW32(r, g, b, w);
     }
+
+    //a frame writing the same colors to the same pixels as the previous one produces the same hash (FNV-1a)
+    inline void hashPixel(uint16_t pix, uint32_t c) {
+      _frameHash = ((_frameHash ^ pix) * 16777619UL ^ c) * 16777619UL;
+      _frameWritten = true;
+    }
 };
 
 
@@ -224,54 +479,176 @@ class BusDigital : public Bus {
     _len = bc.count + _skip;
     _iType = PolyBus::getI(bc.type, _pins, nr);
     if (_iType == I_NONE) return;
-    _busPtr = PolyBus::create(_iType, _pins, _len, nr);
+    if (IS_2PIN(bc.type)) _clockKHz = bc.clockKHz;
+    _busPtr = PolyBus::create(_iType, _pins, _len, nr, _clockKHz);
     _valid = (_busPtr != nullptr);
+    _trackFrames = !_needsRefresh;
+    #ifdef WLED_USE_PARALLEL_I2S
+    if (_iType >= I_32_PX_NEO_3 && _iType <= I_32_PX_400_3) _trackFrames = false; //shared DMA buffer is only sent once every parallel bus called show()
+    #endif
+    #ifdef WLED_INCREMENTAL_ABL
+    if (_valid) _power = (uint16_t*) calloc(_len, sizeof(uint16_t)); //if this fails, power is calculated by reading back pixels
+    _powerVersion = _powerModelVersion;
+    #endif
     _colorOrder = bc.colorOrder;
+    updateColorOrderRuns();
+    _hasWhite = (bc.type == TYPE_SK6812_RGBW || bc.type == TYPE_TM1814);
+    #ifdef WLED_APA102_GBC
+    _gbc = (bc.type == TYPE_APA102);
+    #endif
+    if (!IS_2PIN(bc.type)) { //one-wire protocols at 1.25µs (400kHz: 2.5µs) per bit, plus the latch pause
+      uint32_t bits = (uint32_t)_len * (Bus::isRgbw(bc.type) ? 32 : 24);
+      _wireTime = (bc.type == TYPE_WS2811_400KHZ ? bits * 5 / 2 : bits * 5 / 4) + BUS_LATCH_TIME_US;
+    }
     DEBUG_PRINTF("Successfully inited strip %u (len %u) with type %u and pins %u,%u (itype %u)\n",nr, _len, bc.type, _pins[0],_pins[1],_iType);
   };
 
   inline void show() {
-    PolyBus::show(_busPtr, _iType);
+    if (_valid) _busPtr->show();
   }
 
   inline bool canShow() {
-    return PolyBus::canShow(_busPtr, _iType);
+    return _valid ? _busPtr->canShow() : true;
+  }
+
+  inline uint32_t getWireTime() {
+    return _wireTime;
   }
 
   void setBrightness(uint8_t b) {
     //Fix for turning off onboard LED breaking bus
     #ifdef LED_BUILTIN
     if (_bri == 0 && b > 0) {
-      if (_pins[0] == LED_BUILTIN || _pins[1] == LED_BUILTIN) PolyBus::begin(_busPtr, _iType, _pins); 
+      if (_valid && (_pins[0] == LED_BUILTIN || _pins[1] == LED_BUILTIN)) _busPtr->begin(_pins, _clockKHz);
     }
     #endif
+    if (_bri != b) _forceShow = true;
+    #ifdef WLED_SOFTWARE_BRIGHTNESS
+    #ifdef WLED_APA102_GBC
+    if (_gbc) BusDigital::setBrightnessFine((uint16_t)b * 257); else
+    #endif
+    if (_bri != b && _valid) rescalePixels(b);
+    #endif
     _bri = b;
-    PolyBus::setBrightness(_busPtr, _iType, b);
+    if (_valid) _busPtr->setBrightness(b);
   }
 
+  #ifdef WLED_APA102_GBC
+  //the global brightness and scale split keeps about 13 bit of the brightness
+  void setBrightnessFine(uint16_t b) {
+    if (!_gbc || !_valid) return;
+    uint8_t lum = ((uint32_t)b * 31 + 65534) / 65535;
+    uint16_t bri = lum ? ((uint32_t)b * 31) / (257 * lum) : 0;
+    if (bri > 255) bri = 255;
+    if (lum == _gbcLum && bri == _gbcBri) return;
+    rescaleGbc(lum, bri);
+    _forceShow = true;
+  }
+  #endif
+
 	//If LEDs are skipped, it is possible to use the first as a status LED.
 	//TODO only show if no new show due in the next 50ms
 	void setStatusPixel(uint32_t c) {
-    if (_skip && canShow()) {
-      PolyBus::setPixelColor(_busPtr, _iType, 0, c, _colorOrderMap.getPixelColorOrder(_start, _colorOrder));
-      PolyBus::show(_busPtr, _iType);
+    if (_skip && _valid && canShow()) {
+      #ifdef WLED_SOFTWARE_BRIGHTNESS
+      c = applyBrightness(c);
+      #endif
+      _busPtr->setPixelColor(0, c, colorOrderAt(0));
+      _busPtr->show();
     }
   }
 
   void setPixelColor(uint16_t pix, uint32_t c) {
-    if (_type == TYPE_SK6812_RGBW || _type == TYPE_TM1814) c = autoWhiteCalc(c);
-    if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
+    if (!_valid) return;
+    c = autoWhiteCalc(c, whiteMode());
+    if (_cct >= 1900) c = colorBalance(c); //color correction from CCT
     if (reversed) pix = _len - pix -1;
     else pix += _skip;
-    PolyBus::setPixelColor(_busPtr, _iType, pix, c, _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder));
+    hashPixel(pix, c);
+    #ifdef WLED_INCREMENTAL_ABL
+    if (_power && pix < _len) {
+      uint16_t p = pixelPower(c);
+      _powerSum += p - _power[pix];
+      _power[pix] = p;
+    }
+    #endif
+    #ifdef WLED_SOFTWARE_BRIGHTNESS
+    c = applyBrightness(c);
+    #endif
+    _busPtr->setPixelColor(pix, c, colorOrderAt(pix));
+  }
+
+  void setPixelColors(uint16_t pix, uint16_t count, const uint32_t* c) {
+    BusPixelBuffer buf;
+    if (!mapPixelBuffer(buf) || pix + count > buf.len) {
+      for (uint16_t i = 0; i < count; i++) BusDigital::setPixelColor(pix + i, c[i]);
+      return;
+    }
+    uint8_t aw = whiteMode();
+    bool    wb = _cct >= 1900;
+    for (uint16_t i = 0; i < count; i++) { //same as setPixelColor(), with the color pipeline selected once
+      uint32_t col = c[i];
+      if (aw != RGBW_MODE_MANUAL_ONLY) col = autoWhiteCalc(col, aw);
+      if (wb) col = colorBalance(col);
+      uint16_t p = reversed ? _len - (pix + i) - 1 : pix + i + _skip;
+      hashPixel(p, col);
+      #ifdef WLED_INCREMENTAL_ABL
+      if (_power) {
+        uint16_t pw = pixelPower(col);
+        _powerSum += pw - _power[p];
+        _power[p] = pw;
+      }
+      #endif
+      buf.setPixelColor(pix + i, col);
+    }
+  }
+
+  bool getPixelBuffer(BusPixelBuffer &buf) {
+    if (_cct >= 1900 || whiteMode() != RGBW_MODE_MANUAL_ONLY || !mapPixelBuffer(buf)) return false;
+    _forceShow = true;
+    #ifdef WLED_INCREMENTAL_ABL
+    _powerVersion = _powerModelVersion + 1; //recalculate from the pixel data
+    #endif
+    return true;
   }
 
   uint32_t getPixelColor(uint16_t pix) {
+    if (!_valid) return 0;
     if (reversed) pix = _len - pix -1;
     else pix += _skip;
-    return PolyBus::getPixelColor(_busPtr, _iType, pix, _colorOrderMap.getPixelColorOrder(pix+_start, _colorOrder));
+    uint32_t c = _busPtr->getPixelColor(pix, colorOrderAt(pix));
+    #ifdef WLED_SOFTWARE_BRIGHTNESS
+    c = restoreBrightness(c);
+    #endif
+    return c;
   }
 
+  //straight from the output buffer, without a driver call per pixel
+  void getPixelColors(uint16_t pix, uint16_t count, uint32_t* c) {
+    BusPixelBuffer buf;
+    #ifdef WLED_APA102_GBC
+    if (_gbc) { Bus::getPixelColors(pix, count, c); return; }
+    #endif
+    if (!mapPixelBuffer(buf) || pix + count > buf.len) { Bus::getPixelColors(pix, count, c); return; }
+    for (uint16_t i = 0; i < count; i++) c[i] = buf.getPixelColor(pix + i);
+  }
+
+  #ifdef WLED_INCREMENTAL_ABL
+  uint32_t getPowerSum() {
+    if (!_power) return Bus::getPowerSum();
+    if (_powerVersion != _powerModelVersion) { //power model changed, recalculate from pixel data once
+      _powerSum = 0;
+      for (uint16_t i = 0; i < getLength(); i++) {
+        uint16_t pix = reversed ? _len - i -1 : i + _skip;
+        _power[pix] = pixelPower(BusDigital::getPixelColor(i));
+        _powerSum += _power[pix];
+      }
+      _powerVersion = _powerModelVersion;
+    }
+    return _powerSum;
+  }
+  #endif
+
   inline uint8_t getColorOrder() {
     return _colorOrder;
   }
@@ -289,24 +666,62 @@ class BusDigital : public Bus {
   void setColorOrder(uint8_t colorOrder) {
     if (colorOrder > 5) return;
     _colorOrder = colorOrder;
+    updateColorOrderRuns();
+  }
+
+  //resolves the color order map for this bus into runs of pixels with the same order, so writes
+  //do not scan the map. A bus with a single order keeps no table
+  void updateColorOrderRuns() {
+    free(_orderRuns);
+    _orderRuns = nullptr;
+    _orderRun = 0;
+    _singleOrder = _colorOrderMap.getPixelColorOrder(_start, _colorOrder);
+    if (!_colorOrderMap.overlaps(_start, _len)) return;
+    uint8_t runs = 1;
+    for (uint16_t i = 1; i < _len; i++) {
+      if (_colorOrderMap.getPixelColorOrder(i + _start, _colorOrder) != _colorOrderMap.getPixelColorOrder(i - 1 + _start, _colorOrder)) runs++;
+    }
+    if (runs == 1) return;
+    _orderRuns = (ColorOrderRun*) malloc(runs * sizeof(ColorOrderRun));
+    if (!_orderRuns) return; //map is ignored, pixels use the order of the first one
+    uint8_t r = 0;
+    for (uint16_t i = 1; i <= _len; i++) {
+      uint8_t co = _colorOrderMap.getPixelColorOrder(i - 1 + _start, _colorOrder);
+      if (i < _len && _colorOrderMap.getPixelColorOrder(i + _start, _colorOrder) == co) continue;
+      _orderRuns[r].end = i;
+      _orderRuns[r].colorOrder = co;
+      r++;
+    }
   }
 
   inline uint8_t skippedLeds() {
     return _skip;
   }
 
+  inline uint16_t getClockKHz() {
+    return _clockKHz;
+  }
+
   inline void reinit() {
-    PolyBus::begin(_busPtr, _iType, _pins);
+    if (_valid) _busPtr->begin(_pins, _clockKHz);
+    _forceShow = true;
   }
 
   void cleanup() {
     DEBUG_PRINTLN(F("Digital Cleanup."));
-    PolyBus::cleanup(_busPtr, _iType);
+    free(_orderRuns);
+    _orderRuns = nullptr;
+    delete _busPtr;
     _iType = I_NONE;
     _valid = false;
     _busPtr = nullptr;
     pinManager.deallocatePin(_pins[1], PinOwner::BusDigital);
     pinManager.deallocatePin(_pins[0], PinOwner::BusDigital);
+    #ifdef WLED_INCREMENTAL_ABL
+    free(_power);
+    _power = nullptr;
+    _powerSum = 0;
+    #endif
   }
 
   ~BusDigital() {
@@ -318,11 +733,262 @@ class BusDigital : public Bus {
   uint8_t _pins[2] = {255, 255};
   uint8_t _iType = I_NONE;
   uint8_t _skip = 0;
-  void * _busPtr = nullptr;
+  uint16_t _clockKHz = 0;
+  uint32_t _wireTime = 0;
+  NeoDriver* _busPtr = nullptr;
   const ColorOrderMap &_colorOrderMap;
+  ColorOrderRun* _orderRuns = nullptr; //nullptr: all pixels use _singleOrder
+  uint8_t _orderRun = 0;               //run of the last lookup, consecutive pixels are usually in the same one
+  uint8_t _singleOrder = COL_ORDER_GRB;
+
+  //color order of pixel pix as sent (after reversal and skip)
+  inline uint8_t colorOrderAt(uint16_t pix) {
+    if (!_orderRuns) return _singleOrder;
+    uint8_t r = _orderRun;
+    if (pix >= _orderRuns[r].end || (r && pix < _orderRuns[r-1].end)) {
+      r = 0;
+      while (pix >= _orderRuns[r].end && _orderRuns[r].end < _len) r++;
+      _orderRun = r;
+    }
+    return _orderRuns[r].colorOrder;
+  }
+  #ifdef WLED_INCREMENTAL_ABL
+  uint16_t* _power = nullptr; //power units of each pixel as last written
+  uint32_t  _powerSum = 0;
+  uint8_t   _powerVersion = 0;
+  #endif
+
+  #ifdef WLED_APA102_GBC
+  //APA102 brightness is split into the 5-bit global brightness of each pixel, as coarse as possible,
+  //and an 8-bit scale for the rest, keeping more color resolution in dim scenes than 8-bit scaling alone
+  bool    _gbc = false;
+  uint8_t _gbcLum = 31;
+  uint8_t _gbcBri = 255;
+  #endif
+
+  #ifdef WLED_SOFTWARE_BRIGHTNESS
+  //the same scaling NeoPixelBrightnessBus applies in SetPixelColor() and reverts in GetPixelColor()
+  inline uint32_t applyBrightness(uint32_t c) {
+    #ifdef WLED_APA102_GBC
+    if (_gbc) { //W of an APA102 pixel is its global brightness
+      return (scalePacked(c, _gbcBri) & 0x00FFFFFF) | ((uint32_t)_gbcLum << 24);
+    }
+    #endif
+    return scalePacked(c, _bri);
+  }
+  static inline uint8_t restoreChannel(uint8_t v, uint16_t s) {
+    uint16_t r = ((uint16_t)v << 8) / s;
+    return r > 255 ? 255 : r;
+  }
+  inline uint32_t restoreBrightness(uint32_t c) {
+    #ifdef WLED_APA102_GBC
+    if (_gbc) {
+      uint16_t s = (uint16_t)_gbcBri + 1;
+      return RGBW32(restoreChannel(R(c), s), restoreChannel(G(c), s), restoreChannel(B(c), s), 0);
+    }
+    #endif
+    uint16_t s = (uint16_t)_bri + 1;
+    return RGBW32(restoreChannel(R(c), s), restoreChannel(G(c), s), restoreChannel(B(c), s), restoreChannel(W(c), s));
+  }
+
+  //pixels hold the brightness they were written with, bring them to the new one in place
+  //(what NeoPixelBrightnessBus::SetBrightness() does; pixels written afterwards get it directly)
+  #ifdef WLED_APA102_GBC
+  void rescaleGbc(uint8_t lum, uint8_t bri) {
+    uint16_t scale = (((uint16_t)bri + 1) << 8) / ((uint16_t)_gbcBri + 1);
+    for (uint16_t i = 0; i < _len; i++) {
+      uint32_t c = _busPtr->getPixelColor(i, _colorOrder);
+      uint32_t v[3] = {R(c), G(c), B(c)};
+      for (uint8_t ch = 0; ch < 3; ch++) { v[ch] = (v[ch] * scale) >> 8; if (v[ch] > 255) v[ch] = 255; }
+      _busPtr->setPixelColor(i, RGBW32(v[0], v[1], v[2], lum), _colorOrder);
+    }
+    _gbcLum = lum;
+    _gbcBri = bri;
+  }
+  #endif
+
+  void rescalePixels(uint8_t b) {
+    uint16_t scale = (((uint16_t)b + 1) << 8) / ((uint16_t)_bri + 1);
+    uint8_t* px = _busPtr->getPixels();
+    if (px) {
+      uint16_t bytes = _len * ((_type == TYPE_SK6812_RGBW) ? 4 : 3);
+      uint16_t i = 0;
+      if (scale <= 256) for (; i + 4 <= bytes; i += 4) { //dimming cannot saturate, four bytes at a time
+        uint32_t v;
+        memcpy(&v, px + i, 4);
+        v = scalePackedBy(v, scale);
+        memcpy(px + i, &v, 4);
+      }
+      for (; i < bytes; i++) {
+        uint16_t v = (px[i] * scale) >> 8;
+        px[i] = v > 255 ? 255 : v;
+      }
+      return;
+    }
+    for (uint16_t i = 0; i < _len; i++) { //color order is irrelevant as long as the same one is used both ways
+      uint32_t c = _busPtr->getPixelColor(i, _colorOrder);
+      uint32_t v[4] = {R(c), G(c), B(c), W(c)};
+      for (uint8_t ch = 0; ch < 4; ch++) { v[ch] = (v[ch] * scale) >> 8; if (v[ch] > 255) v[ch] = 255; }
+      _busPtr->setPixelColor(i, RGBW32(v[0], v[1], v[2], v[3]), _colorOrder);
+    }
+  }
+  #endif
+
+  bool mapPixelBuffer(BusPixelBuffer &buf) {
+    #ifdef COLOR_ORDER_OVERRIDE
+    return false;
+    #endif
+    if (!_valid || _colorOrderMap.overlaps(_start, getLength())) return false;
+    uint8_t* px = _busPtr->getPixels();
+    if (!px) return false;
+    //byte position of R, G and B for each color order, the buffer itself is always G,R,B(,W)
+    static const uint8_t order[6][3] = {{1,0,2}, {0,1,2}, {1,2,0}, {0,2,1}, {2,1,0}, {2,0,1}};
+    uint8_t co = _colorOrder > 5 ? 5 : _colorOrder;
+    uint8_t stride = (_type == TYPE_SK6812_RGBW) ? 4 : 3;
+    buf.data  = px + (reversed ? (_len - 1) * stride : _skip * stride);
+    buf.step  = reversed ? -stride : stride;
+    buf.offR  = order[co][0];
+    buf.offG  = order[co][1];
+    buf.offB  = order[co][2];
+    buf.offW  = (stride == 4) ? 3 : 255;
+    buf.len   = getLength();
+    buf.scale = (uint16_t)_bri + 1;
+    return true;
+  }
 };
 
 
+#ifdef ARDUINO_ARCH_ESP32
+//one logical digital bus driven in sections from several pins. As each section has its own
+//RMT/I2S channel they are sent in parallel, dividing the wire time by the number of sections.
+//Pixel indices stay contiguous, so segments and ledmaps are unaffected
+class BusSplit : public Bus {
+  public:
+  BusSplit(BusConfig &bc, uint8_t nr, const ColorOrderMap &com) : Bus(bc.type, bc.start) {
+    _count = bc.sections();
+    _len = bc.count;
+    _secLen = (_len + _count - 1) / _count;
+    _mirror = bc.mirrorSections;
+    reversed = bc.reversed;
+    _needsRefresh = bc.refreshReq || bc.type == TYPE_TM1814;
+    _hasWhite = (bc.type == TYPE_SK6812_RGBW || bc.type == TYPE_TM1814);
+    _valid = true;
+    for (uint8_t k = 0; k < _count; k++) {
+      uint16_t start = k * _secLen;
+      uint16_t len = (_len - start < _secLen) ? _len - start : _secLen;
+      //sacrificial pixels only at the start of the first section
+      BusConfig sc(bc.type | (bc.refreshReq << 7), &bc.pins[k], bc.start + start, len, bc.colorOrder, _mirror && (k & 1), k ? 0 : bc.skipAmount);
+      _sections[k] = new BusDigital(sc, nr + k, com);
+      if (!_sections[k]->isOk()) _valid = false;
+    }
+  }
+
+  ~BusSplit() {
+    cleanup();
+  }
+
+  void show() {
+    for (uint8_t k = 0; k < _count; k++) if (_changed & (1 << k)) _sections[k]->show();
+  }
+
+  bool canShow() {
+    for (uint8_t k = 0; k < _count; k++) if (!_sections[k]->canShow()) return false;
+    return true;
+  }
+
+  //tracks frames per section, show() only sends the sections that changed
+  bool frameChanged() {
+    _changed = 0;
+    for (uint8_t k = 0; k < _count; k++) {
+      if (_forceShow) _sections[k]->forceShow();
+      if (_sections[k]->frameChanged()) _changed |= 1 << k;
+    }
+    _forceShow = false;
+    return _changed;
+  }
+
+  void setPixelColor(uint16_t pix, uint32_t c) {
+    if (pix >= _len) return;
+    if (reversed) pix = _len - pix -1;
+    _sections[pix / _secLen]->setPixelColor(pix % _secLen, c);
+  }
+
+  void setPixelColors(uint16_t pix, uint16_t count, const uint32_t* c) {
+    if (reversed) {
+      for (uint16_t i = 0; i < count; i++) BusSplit::setPixelColor(pix + i, c[i]);
+      return;
+    }
+    while (count && pix < _len) { //hand each section its part of the span
+      uint16_t local = pix % _secLen;
+      uint16_t n = _secLen - local;
+      if (n > count) n = count;
+      _sections[pix / _secLen]->setPixelColors(local, n, c);
+      pix += n; c += n; count -= n;
+    }
+  }
+
+  uint32_t getPixelColor(uint16_t pix) {
+    if (pix >= _len) return 0;
+    if (reversed) pix = _len - pix -1;
+    return _sections[pix / _secLen]->getPixelColor(pix % _secLen);
+  }
+
+  uint32_t getPowerSum() {
+    uint32_t sum = 0;
+    for (uint8_t k = 0; k < _count; k++) sum += _sections[k]->getPowerSum();
+    return sum;
+  }
+
+  void setBrightness(uint8_t b) {
+    _bri = b;
+    for (uint8_t k = 0; k < _count; k++) _sections[k]->setBrightness(b);
+  }
+
+  void setBrightnessFine(uint16_t b) {
+    for (uint8_t k = 0; k < _count; k++) _sections[k]->setBrightnessFine(b);
+  }
+
+  void setStatusPixel(uint32_t c) {
+    _sections[0]->setStatusPixel(c);
+  }
+
+  uint8_t getPins(uint8_t* pinArray) {
+    for (uint8_t k = 0; k < _count; k++) _sections[k]->getPins(pinArray + k);
+    return _count;
+  }
+
+  void setColorOrder(uint8_t colorOrder) {
+    for (uint8_t k = 0; k < _count; k++) _sections[k]->setColorOrder(colorOrder);
+  }
+
+  void updateColorOrderRuns() {
+    for (uint8_t k = 0; k < _count; k++) _sections[k]->updateColorOrderRuns();
+  }
+
+  uint8_t  getColorOrder()    { return _sections[0]->getColorOrder(); }
+  uint8_t  skippedLeds()      { return _sections[0]->skippedLeds(); }
+  uint32_t getWireTime()      { return _sections[0]->getWireTime(); } //the first section is the longest
+  uint8_t  getSections()      { return _count; }
+  bool     sectionsMirrored() { return _mirror; }
+
+  void cleanup() {
+    for (uint8_t k = 0; k < _count; k++) {
+      delete _sections[k];
+      _sections[k] = nullptr;
+    }
+    _count = 0;
+    _valid = false;
+  }
+
+  private:
+  BusDigital* _sections[5] = {nullptr};
+  uint8_t  _count = 0;
+  uint8_t  _changed = 0;  //sections to send on show()
+  uint16_t _secLen = 1;
+  bool     _mirror = false;
+};
+#endif
+
 class BusPwm : public Bus {
   public:
   BusPwm(BusConfig &bc) : Bus(bc.type, bc.start) {
@@ -331,7 +997,7 @@ class BusPwm : public Bus {
     uint8_t numPins = NUM_PWM_PINS(bc.type);
 
     #ifdef ESP8266
-    analogWriteRange(255);  //same range as one RGB channel
+    analogWriteRange(WLED_PWM_MAX_DUTY);
     analogWriteFreq(WLED_PWM_FREQ);
     #else
     _ledcStart = pinManager.allocateLedc(numPins);
@@ -349,19 +1015,20 @@ class BusPwm : public Bus {
       #ifdef ESP8266
       pinMode(_pins[i], OUTPUT);
       #else
-      ledcSetup(_ledcStart + i, WLED_PWM_FREQ, 8);
+      ledcSetup(_ledcStart + i, WLED_PWM_FREQ, WLED_PWM_BITS);
       ledcAttachPin(_pins[i], _ledcStart + i);
       #endif
     }
     reversed = bc.reversed;
+    _hasWhite = (bc.type != TYPE_ANALOG_3CH);
     _valid = true;
   };
 
   void setPixelColor(uint16_t pix, uint32_t c) {
     if (pix != 0 || !_valid) return; //only react to first pixel
-		if (_type != TYPE_ANALOG_3CH) c = autoWhiteCalc(c);
+		c = autoWhiteCalc(c, whiteMode());
     if (_cct >= 1900 && (_type == TYPE_ANALOG_3CH || _type == TYPE_ANALOG_4CH)) {
-      c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
+      c = colorBalance(c); //color correction from CCT
     }
     uint8_t r = R(c);
     uint8_t g = G(c);
@@ -421,8 +1088,10 @@ class BusPwm : public Bus {
     if (!_valid) return;
     uint8_t numPins = NUM_PWM_PINS(_type);
     for (uint8_t i = 0; i < numPins; i++) {
-      uint8_t scaled = (_data[i] * _bri) / 255;
-      if (reversed) scaled = 255 - scaled;
+      //scale the product of color and 16 bit brightness to the duty range, so dim levels and fades keep their steps
+      uint32_t level = ((uint32_t)_data[i] * _briFine + 127) / 255; //0-65535
+      uint32_t scaled = (level * WLED_PWM_MAX_DUTY + 32767) / 65535;
+      if (reversed) scaled = WLED_PWM_MAX_DUTY - scaled;
       #ifdef ESP8266
       analogWrite(_pins[i], scaled);
       #else
@@ -433,6 +1102,11 @@ class BusPwm : public Bus {
 
   inline void setBrightness(uint8_t b) {
     _bri = b;
+    _briFine = (uint16_t)b * 257;
+  }
+
+  inline void setBrightnessFine(uint16_t b) {
+    _briFine = b;
   }
 
   uint8_t getPins(uint8_t* pinArray) {
@@ -448,6 +1122,8 @@ class BusPwm : public Bus {
     deallocatePins();
   }
 
+  uint32_t getMinInterval() { return BUS_MIN_SHOW_INTERVAL_US; }
+
   ~BusPwm() {
     cleanup();
   }
@@ -455,6 +1131,7 @@ class BusPwm : public Bus {
   private: 
   uint8_t _pins[5] = {255, 255, 255, 255, 255};
   uint8_t _data[5] = {0};
+  uint16_t _briFine = 0;
   #ifdef ARDUINO_ARCH_ESP32
   uint8_t _ledcStart = 255;
   #endif
@@ -481,64 +1158,137 @@ class BusNetwork : public Bus {
   public:
     BusNetwork(BusConfig &bc) : Bus(bc.type, bc.start) {
       _valid = false;
-//      switch (bc.type) {
-//        case TYPE_NET_ARTNET_RGB:
-//          _rgbw = false;
-//          _UDPtype = 2;
-//          break;
-//        case TYPE_NET_E131_RGB:
-//          _rgbw = false;
-//          _UDPtype = 1;
-//          break;
-//        case TYPE_NET_DDP_RGB:
-//          _rgbw = false;
-//          _UDPtype = 0;
-//          break;
-//        default:
-          _rgbw = false;
-          _UDPtype = bc.type - TYPE_NET_DDP_RGB;
-//          break;
-//      }
+      _rgbw = bc.netRgbw;
+      _UDPtype = bc.type - TYPE_NET_DDP_RGB;
+      _universe = bc.netUniverse;
+      _channel = bc.netChannel;
       _UDPchannels = _rgbw ? 4 : 3;
-      _data = (byte *)malloc(bc.count * _UDPchannels);
+      _hasWhite = _rgbw;
+      _data = (byte *)wledAlloc(bc.count * _UDPchannels, ALLOC_COLD);
       if (_data == nullptr) return;
       memset(_data, 0, bc.count * _UDPchannels);
+      #ifdef BUS_NETWORK_TASK
+      _sendData = (byte *)wledAlloc(bc.count * _UDPchannels, ALLOC_COLD); //snapshot being sent while the next frame is rendered
+      if (_sendData == nullptr) return;
+      #else
+      _sendData = _data;
+      #endif
       _len = bc.count;
       _client = IPAddress(bc.pins[0],bc.pins[1],bc.pins[2],bc.pins[3]);
       _broadcastLock = false;
+      _follower = bc.follower;
+      _trackFrames = true;
       _valid = true;
     };
 
   void setPixelColor(uint16_t pix, uint32_t c) {
     if (!_valid || pix >= _len) return;
-		if (isRgbw()) c = autoWhiteCalc(c);
-    if (_cct >= 1900) c = colorBalanceFromKelvin(_cct, c); //color correction from CCT
-    uint16_t offset = pix * _UDPchannels;
+		c = autoWhiteCalc(c, whiteMode());
+    if (_cct >= 1900) c = colorBalance(c); //color correction from CCT
+    hashPixel(pix, c);
+    uint32_t offset = (uint32_t)pix * _UDPchannels;
     _data[offset]   = R(c);
     _data[offset+1] = G(c);
     _data[offset+2] = B(c);
     if (_rgbw) _data[offset+3] = W(c);
   }
 
+  void setPixelColors(uint16_t pix, uint16_t count, const uint32_t* c) {
+    if (!_valid || pix >= _len) return;
+    if (count > _len - pix) count = _len - pix;
+    uint8_t aw = whiteMode();
+    bool    wb = _cct >= 1900;
+    uint8_t* d = _data + pix * _UDPchannels;
+    for (uint16_t i = 0; i < count; i++, d += _UDPchannels) {
+      uint32_t col = c[i];
+      if (aw != RGBW_MODE_MANUAL_ONLY) col = autoWhiteCalc(col, aw);
+      if (wb) col = colorBalance(col);
+      hashPixel(pix + i, col);
+      d[0] = R(col);
+      d[1] = G(col);
+      d[2] = B(col);
+      if (_rgbw) d[3] = W(col);
+    }
+  }
+
   uint32_t getPixelColor(uint16_t pix) {
     if (!_valid || pix >= _len) return 0;
-    uint16_t offset = pix * _UDPchannels;
-    return RGBW32(_data[offset], _data[offset+1], _data[offset+2], _rgbw ? (_data[offset+3] << 24) : 0);
+    uint32_t offset = (uint32_t)pix * _UDPchannels;
+    return RGBW32(_data[offset], _data[offset+1], _data[offset+2], _rgbw ? _data[offset+3] : 0);
   }
 
+  //sends the frames of all busses to the same destination, shared universes and the DDP push once
+  //with BUS_NETWORK_TASK this only takes a snapshot, the sender task does the sending
   void show() {
-    if (!_valid || !canShow()) return;
-    _broadcastLock = true;
-    realtimeBroadcast(_UDPtype, _client, _len, _data, _bri, _rgbw);
-    _broadcastLock = false;
+    if (!_valid || _shared) return;
+    if (!canShow()) { //previous frame still in flight, send the current one with the next show()
+      _forceShow = true;
+      return;
+    }
+    for (BusNetwork* b = this; b; b = b->_nextShared) {
+      if (!b->_valid) continue;
+      b->_broadcastLock = true;
+      b->_sendBri = b->_bri;
+      #ifdef BUS_NETWORK_TASK
+      memcpy(b->_sendData, b->_data, b->_len * b->_UDPchannels);
+      #endif
+    }
+    #ifdef BUS_NETWORK_TASK
+    QueueHandle_t queue = senderQueue();
+    BusNetwork* self = this;
+    if (queue && xQueueSend(queue, &self, 0) == pdTRUE) return;
+    #endif
+    send(); //no sender task
   }
 
+  //resend unchanged frames periodically so receivers do not time out of realtime mode
+  //a bus sharing its destination reports no change, it is sent by the first bus to that destination
+  bool frameChanged() {
+    if (_shared) return false;
+    bool changed = Bus::frameChanged();
+    for (BusNetwork* b = _nextShared; b; b = b->_nextShared) changed |= b->Bus::frameChanged();
+    return changed || millis() - _lastSend > BUS_NETWORK_KEEPALIVE;
+  }
+
+  //chains busses sending to the same destination with the same protocol, called whenever the busses change
+  static void linkShared(Bus* busses[], uint8_t numBusses) {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (!isNetwork(busses[i]->getType())) continue;
+      BusNetwork* b = static_cast<BusNetwork*>(busses[i]);
+      b->_nextShared = nullptr;
+      b->_shared = false;
+    }
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (!isNetwork(busses[i]->getType())) continue;
+      BusNetwork* b = static_cast<BusNetwork*>(busses[i]);
+      if (b->_shared) continue;
+      BusNetwork* tail = b;
+      for (uint8_t j = i +1; j < numBusses; j++) {
+        if (busses[j]->getType() != b->getType()) continue;
+        BusNetwork* o = static_cast<BusNetwork*>(busses[j]);
+        if (o->_client != b->_client) continue;
+        o->_shared = true;
+        tail->_nextShared = o;
+        tail = o;
+      }
+    }
+  }
+
+  static inline bool isNetwork(uint8_t type) { return type >= TYPE_NET_DDP_RGB && type < 96; }
+
+  inline bool     isFollower()  { return _follower; }
+  inline uint16_t getUniverse() { return _universe; }
+  inline uint32_t getChannel()  { return _channel; }
+
+  //false while the last frame is still being sent by the sender task
   inline bool canShow() {
-    // this should be a return value from UDP routine if it is still sending data out
     return !_broadcastLock;
   }
 
+  uint32_t getMinInterval() { return BUS_MIN_SHOW_INTERVAL_US; }
+
   inline void setBrightness(uint8_t b) {
+    if (_bri != b) _forceShow = true;
     _bri = b;
   }
 
@@ -558,10 +1308,12 @@ class BusNetwork : public Bus {
   }
 
   void cleanup() {
+    while (_broadcastLock) delay(1); //sender task still reads the snapshot
     _type = I_NONE;
     _valid = false;
+    if (_sendData != nullptr && _sendData != _data) free(_sendData);
     if (_data != nullptr) free(_data);
-    _data = nullptr;
+    _data = _sendData = nullptr;
   }
 
   ~BusNetwork() {
@@ -573,12 +1325,140 @@ class BusNetwork : public Bus {
     uint8_t   _bri = 255;
     uint8_t   _UDPtype;
     uint8_t   _UDPchannels;
+    uint8_t   _sendBri = 255;
     bool      _rgbw;
-    bool      _broadcastLock;
+    volatile bool _broadcastLock = false;
+    uint16_t  _universe;
+    uint32_t  _channel;
+    BusNetwork* _nextShared = nullptr; //next bus to the same destination
+    bool      _shared = false;         //sent by an earlier bus to the same destination
+    bool      _follower = false;       //added for a stream follower
     byte     *_data;
+    byte     *_sendData = nullptr; //frame as of the last show(), same as _data without BUS_NETWORK_TASK
+    volatile uint32_t _lastSend = 0;
+
+  //sends the snapshot of this bus and the busses sharing its destination
+  void send() {
+    NetOutput outs[WLED_MAX_BUSSES];
+    uint8_t n = 0;
+    for (BusNetwork* b = this; b; b = b->_nextShared) {
+      if (b->_valid) outs[n++] = {b->_sendData, b->_len, b->_sendBri, b->_rgbw, b->_universe, b->_channel};
+    }
+    realtimeBroadcast(_UDPtype, _client, outs, n);
+    uint32_t now = millis();
+    for (BusNetwork* b = this; b; b = b->_nextShared) {
+      b->_lastSend = now;
+      b->_broadcastLock = false;
+    }
+  }
+
+  #ifdef BUS_NETWORK_TASK
+  //one task sends all network busses in the order they were shown, created with the first frame
+  static QueueHandle_t senderQueue() {
+    static QueueHandle_t queue = nullptr;
+    static bool failed = false;
+    if (queue || failed) return queue;
+    queue = xQueueCreate(WLED_MAX_BUSSES, sizeof(BusNetwork*)); //at most one frame in flight per destination
+    if (queue && xTaskCreatePinnedToCore(senderTask, "netout", BUS_NETWORK_TASK_STACK, queue, 2, nullptr, BUS_NETWORK_TASK_CORE) != pdPASS) {
+      vQueueDelete(queue);
+      queue = nullptr;
+    }
+    failed = !queue;
+    DEBUG_PRINTF("Network bus sender task %s\n", failed ? "failed" : "started");
+    return queue;
+  }
+
+  static void senderTask(void* queue) {
+    BusNetwork* b;
+    for (;;) {
+      if (xQueueReceive((QueueHandle_t)queue, &b, portMAX_DELAY) == pdTRUE) b->send();
+    }
+  }
+  #endif
 };
 
 
+#ifdef WLED_ENABLE_DMX
+#define DMX_UNIVERSE_SIZE 512
+#define DMX_KEEPALIVE 1000 //ms after which an unchanged universe is sent again, fixtures may treat a silent line as signal loss
+
+bool dmxSendUniverse(const uint8_t* data, uint16_t len); //dmx.cpp, data[0] is channel 1, false if the UART is still busy
+
+//DMX fixtures mirroring LEDs [startLed, end of the strip): fixture n starts at channel first + n * gap.
+//Not part of the pixel address space, BusManager encodes it from the pixel data of the other busses
+//when a frame changed, through a channel map resolved once per configuration
+class BusDMX : public Bus {
+  public:
+  BusDMX() : Bus(TYPE_NONE, 0) {
+    _valid = true;
+    memUsed = sizeof(BusDMX);
+  }
+
+  //fixtureMap per channel of a fixture: 0: off, 1-4: red, green, blue, white, 5: shutter (brightness), 6: full on
+  void setMap(pixidx_t startLed, uint16_t first, uint16_t gap, uint8_t channels, const uint8_t* fixtureMap) {
+    _startLed = startLed;
+    _first = first ? first : 1;
+    _gap = gap ? gap : 1;
+    _channels = channels > 15 ? 15 : channels;
+    _scaleColors = true;
+    for (uint8_t c = 0; c < _channels; c++) if (fixtureMap[c] == 5) _scaleColors = false; //the shutter dims instead
+    for (uint8_t c = 0; c < _channels; c++) {
+      static const uint8_t shifts[4] = {16, 8, 0, 24}; //R, G, B, W of a packed color
+      _shift[c] = (fixtureMap[c] >= 1 && fixtureMap[c] <= 4) ? shifts[fixtureMap[c] - 1] : 0xFF;
+      _constant[c] = (fixtureMap[c] == 6) ? 255 : 0;
+      _shutter[c] = (fixtureMap[c] == 5);
+    }
+    memset(_universe, 0, sizeof(_universe));
+    _changed = true;
+  }
+
+  inline void setEnabled(bool enabled) { _enabled = enabled; } //off while the E1.31 DMX proxy drives the line
+  inline bool isEnabled() { return _enabled; }
+  inline pixidx_t getStartLed() { return _startLed; }
+
+  void setBrightness(uint8_t b) {
+    if (_bri != b) _changed = true;
+    _bri = b;
+  }
+
+  //led is the strip index, c its color without brightness
+  void setPixelColor(pixidx_t led, uint32_t c) {
+    if (led < _startLed) return;
+    uint32_t addr = _first + (uint32_t)_gap * (led - _startLed); //channel numbers start at 1
+    if (addr > DMX_UNIVERSE_SIZE) return;
+    if (_scaleColors) c = scalePacked(c, _bri);
+    uint8_t* p = _universe + addr - 1;
+    uint8_t n = (DMX_UNIVERSE_SIZE + 1 - addr < _channels) ? DMX_UNIVERSE_SIZE + 1 - addr : _channels;
+    for (uint8_t ch = 0; ch < n; ch++) {
+      uint8_t v = (_shift[ch] != 0xFF) ? uint8_t(c >> _shift[ch]) : _shutter[ch] ? _bri : _constant[ch];
+      if (p[ch] != v) { p[ch] = v; _changed = true; }
+    }
+  }
+
+  //sends the universe if a channel changed or the keepalive is due
+  void show() {
+    if (!_enabled || (!_changed && millis() - _sentAt < DMX_KEEPALIVE)) return;
+    if (!dmxSendUniverse(_universe, DMX_UNIVERSE_SIZE)) return; //still sending, try again on the next show()
+    _changed = false;
+    _sentAt = millis();
+  }
+
+  private:
+  uint8_t  _universe[DMX_UNIVERSE_SIZE] = {0};
+  pixidx_t _startLed = 0;
+  uint16_t _first = 1, _gap = 1;
+  uint8_t  _channels = 0;
+  uint8_t  _shift[15];    //bit position of the color channel a DMX channel takes, 0xFF: none
+  uint8_t  _constant[15]; //value of channels without a color
+  bool     _shutter[15];
+  bool     _scaleColors = true;
+  bool     _enabled = true;
+  bool     _changed = true;
+  uint32_t _sentAt = 0;
+};
+#endif
+
+
 class BusManager {
   public:
   BusManager() {
@@ -597,26 +1477,134 @@ class BusManager {
         }
         if (type > 29) return len*4; //RGBW
         return len*3;
-      #else //ESP32 RMT uses double buffer?
+      #elif defined(WLED_USE_RMT_SINGLE_BUFFER) //ESP32 RMT sends from the pixel buffer, TM1814 keeps both
+        if (type == TYPE_TM1814) return len*8;
+        if (type > 29) return len*4; //RGBW
+        return len*3;
+      #else //ESP32 RMT keeps an editing and a sending buffer
         if (type > 29) return len*8; //RGBW
         return len*6;
       #endif
     }
     if (type > 31 && type < 48)   return 5;
     if (type == 44 || type == 45) return len*4; //RGBW
+    if (BusNetwork::isNetwork(type) && hasPSRAM()) return 0; //buffers are placed in PSRAM, no limit on internal RAM
+    #ifdef BUS_NETWORK_TASK
+    if (BusNetwork::isNetwork(type)) return len * (bc.netRgbw ? 8 : 6); //double buffered
+    #else
+    if (BusNetwork::isNetwork(type) && bc.netRgbw) return len*4;
+    #endif
     return len*3; //RGB
   }
   
   int add(BusConfig &bc) {
     if (numBusses >= WLED_MAX_BUSSES) return -1;
-    if (bc.type >= TYPE_NET_DDP_RGB && bc.type < 96) {
-      busses[numBusses] = new BusNetwork(bc);
-    } else if (IS_DIGITAL(bc.type)) {
-      busses[numBusses] = new BusDigital(bc, numBusses, colorOrderMap);
-    } else {
-      busses[numBusses] = new BusPwm(bc);
+    #ifdef ARDUINO_ARCH_ESP32
+    appendRmt(bc, channelOf(numBusses));
+    #endif
+    busses[numBusses] = createBus(bc, channelOf(numBusses));
+    if (!busses[numBusses]) return -1;
+    numBusses++;
+    updateLookup();
+    return numBusses -1;
+  }
+
+  //replaces the current busses by the ones in cfgs (nullptr terminated, deleted afterwards).
+  //Busses with unchanged type, pins and length are kept with their driver and only get start,
+  //color order, reverse and power supply updated, the others are recreated. Returns true if the pixel layout changed
+  //do not call this method from system context (network callback)
+  bool reconfigure(BusConfig* cfgs[]) {
+    while (!canAllShow()) yield();
+    uint8_t count = 0;
+    uint32_t mem = 0;
+    for (; count < WLED_MAX_BUSSES && cfgs[count] != nullptr; count++) {
+      mem += memUsage(*cfgs[count]);
+      if (mem > MAX_LED_MEMORY) break; //this and the following busses don't fit
+    }
+    bool layoutChanged = (count != numBusses);
+    bool keep[WLED_MAX_BUSSES] = {false};
+    #ifdef ARDUINO_ARCH_ESP32
+    RmtPlan plan = planRmt(cfgs, count);
+    if (!PolyBus::rmtRxFree(plan)) PolyBus::rmtRxRelease(); //before a bus is created on the IR channel
+    #endif
+    uint8_t channel = 0, newChannel = 0; //a bus is only kept on the same driver channel
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (i < count && (busses[i]->getStart() != cfgs[i]->start || busses[i]->getLength() != cfgs[i]->count)) layoutChanged = true;
+      keep[i] = i < count && channel == newChannel && busses[i]->isOk() && hasSameOutput(busses[i], *cfgs[i]);
+      #ifdef ARDUINO_ARCH_ESP32
+      if (keep[i]) keep[i] = !rmtMoved(*cfgs[i], newChannel, plan);
+      #endif
+      channel += busses[i]->getSections();
+      if (i < count) newChannel += cfgs[i]->sections();
+      if (keep[i]) continue;
+      delete busses[i]; //first, so the new busses can take over pins and channels
+      busses[i] = nullptr;
+    }
+    #ifdef ARDUINO_ARCH_ESP32
+    //kept RMT busses stay on their channel and only get their memory resized, before the new busses take blocks
+    for (uint8_t i = 0; i < WLED_RMT_BLOCKS; i++) {
+      if (plan.blocks[i] && plan.blocks[i] != PolyBus::rmtPlan().blocks[i]) rmt_set_mem_block_num((rmt_channel_t)plan.channel[i], plan.blocks[i]);
+    }
+    PolyBus::rmtPlan() = plan;
+    #endif
+    newChannel = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      BusConfig &bc = *cfgs[i];
+      uint8_t nr = newChannel;
+      newChannel += bc.sections();
+      if (!keep[i]) {
+        busses[i] = createBus(bc, nr);
+        if (busses[i]) continue;
+        //not enough heap, drop this and the following busses
+        for (uint8_t j = i + 1; j < count; j++) if (keep[j]) delete busses[j];
+        count = i;
+        layoutChanged = true;
+        break;
+      }
+      busses[i]->setStart(bc.start);
+      busses[i]->setColorOrder(bc.colorOrder);
+      busses[i]->reversed = bc.reversed;
+      busses[i]->psu = bc.psu;
+      busses[i]->forceShow();
+    }
+    for (uint8_t i = 0; i < WLED_MAX_BUSSES; i++) {
+      delete cfgs[i];
+      cfgs[i] = nullptr;
+    }
+    numBusses = count;
+    updateLookup();
+    return layoutChanged;
+  }
+
+  //replaces the busses of stream followers, which always come after the configured busses, by the ones in cfgs
+  //(nullptr terminated, deleted afterwards). Do not call this method from system context (network callback)
+  void setFollowers(BusConfig* cfgs[]) {
+    while (!canAllShow()) yield();
+    uint8_t count = getNumConfiguredBusses();
+    uint32_t mem = 0;
+    for (uint8_t i = count; i < numBusses; i++) delete busses[i];
+    for (uint8_t i = 0; i < count; i++) mem += busses[i]->getLength() * 3; //estimate, the configured busses fit
+    numBusses = count;
+    for (uint8_t i = 0; i < WLED_MAX_BUSSES && cfgs[i] != nullptr; i++) {
+      mem += memUsage(*cfgs[i]);
+      if (numBusses < WLED_MAX_BUSSES && mem <= MAX_LED_MEMORY) {
+        #ifdef ARDUINO_ARCH_ESP32
+        appendRmt(*cfgs[i], channelOf(numBusses));
+        #endif
+        busses[numBusses] = createBus(*cfgs[i], channelOf(numBusses));
+        if (busses[numBusses]) numBusses++;
+      }
+      delete cfgs[i];
+      cfgs[i] = nullptr;
     }
-    return numBusses++;
+    updateLookup();
+  }
+
+  //busses of the LED settings, without those added for stream followers
+  uint8_t getNumConfiguredBusses() {
+    uint8_t n = numBusses;
+    while (n && BusNetwork::isNetwork(busses[n-1]->getType()) && static_cast<BusNetwork*>(busses[n-1])->isFollower()) n--;
+    return n;
   }
 
   //do not call this method from system context (network callback)
@@ -626,12 +1614,81 @@ class BusManager {
     while (!canAllShow()) yield();
     for (uint8_t i = 0; i < numBusses; i++) delete busses[i];
     numBusses = 0;
+    #ifdef ARDUINO_ARCH_ESP32
+    PolyBus::rmtPlan() = RmtPlan();
+    #endif
+    updateLookup();
   }
 
+  //only sends out busses whose frame changed
   void show() {
+    if (_colorOrderChanged) {
+      _colorOrderChanged = false;
+      for (uint8_t i = 0; i < numBusses; i++) busses[i]->updateColorOrderRuns();
+    }
+    uint32_t wireTime = getBusyTime(); //a bus not shown this time may still be sending the last frame
+    bool shown = false;
     for (uint8_t i = 0; i < numBusses; i++) {
-      busses[i]->show();
+      Bus* b = busses[i];
+      BusStats &st = b->getStats();
+      if (micros() - st.sentAt < b->getMinInterval()) { //too soon, updateStats() sends a changed frame later
+        if (b->hasFrameChanged()) st.deferred = true;
+        continue;
+      }
+      if (!b->frameChanged()) { st.skipped++; continue; }
+      uint32_t t = showBus(b);
+      if (t > wireTime) wireTime = t;
+      shown = true;
+    }
+    #ifdef WLED_ENABLE_DMX
+    if (_dmx && _dmx->isEnabled()) {
+      if (shown) { //fixtures only change with the LEDs they mirror
+        uint32_t px[32];
+        pixidx_t len = getTotalLength();
+        for (pixidx_t i = _dmx->getStartLed(); i < len; i += 32) {
+          uint16_t n = (len - i < 32) ? len - i : 32;
+          getPixelColors(i, n, px);
+          for (uint16_t k = 0; k < n; k++) _dmx->setPixelColor(i + k, px[k]);
+        }
+      }
+      _dmx->show();
     }
+    #endif
+    if (!shown) return;
+    _showTime = micros();
+    _wireTime = wireTime;
+  }
+
+  //measures the wire time of frames still being sent and sends deferred frames, call regularly from the main loop
+  void updateStats() {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      BusStats &st = busses[i]->getStats();
+      if (st.deferred && micros() - st.sentAt >= busses[i]->getMinInterval()) {
+        busses[i]->frameChanged();
+        uint32_t t = showBus(busses[i]);
+        uint32_t busy = getBusyTime();
+        _showTime = micros();
+        _wireTime = t > busy ? t : busy;
+      }
+      if (!st.pending || !busses[i]->canShow()) continue;
+      uint32_t t = micros() - st.sentAt;
+      st.wireTime = t > UINT16_MAX ? UINT16_MAX : t;
+      st.pending = false;
+    }
+  }
+
+  //estimated µs until the frame sent by the last show() has left the slowest bus
+  uint32_t getBusyTime() {
+    uint32_t elapsed = micros() - _showTime;
+    return elapsed < _wireTime ? _wireTime - elapsed : 0;
+  }
+
+  //true if show() would send out at least one bus
+  bool isFrameChanged() {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      if (busses[i]->hasFrameChanged()) return true;
+    }
+    return false;
   }
 
 	void setStatusPixel(uint32_t c) {
@@ -640,12 +1697,48 @@ class BusManager {
 		}
 	}
 
-  void IRAM_ATTR setPixelColor(uint16_t pix, uint32_t c, int16_t cct=-1) {
-    for (uint8_t i = 0; i < numBusses; i++) {
-      Bus* b = busses[i];
-      uint16_t bstart = b->getStart();
-      if (pix < bstart || pix >= bstart + b->getLength()) continue;
-      busses[i]->setPixelColor(pix - bstart, c);
+  void IRAM_ATTR setPixelColor(pixidx_t pix, uint32_t c, int16_t cct=-1) {
+    if (_overlapping) { //pixel may belong to several busses
+      for (uint8_t i = 0; i < numBusses; i++) {
+        Bus* b = busses[i];
+        pixidx_t bstart = b->getStart();
+        if (pix < bstart || pix >= bstart + b->getLength()) continue;
+        busses[i]->setPixelColor(pix - bstart, c);
+      }
+      return;
+    }
+    int8_t n = findBus(pix);
+    if (n < 0) return;
+    busses[_lkBus[n]]->setPixelColor(pix - _lkStart[n], c);
+  }
+
+  //sets count consecutive pixels starting at pix with a single call per bus
+  void IRAM_ATTR setPixelColors(pixidx_t pix, uint16_t count, const uint32_t* c) {
+    while (count) {
+      int8_t n = _overlapping ? -1 : findBus(pix);
+      if (n < 0) { //no bus or overlapping busses, set pixel by pixel
+        setPixelColor(pix++, *c++); count--;
+        continue;
+      }
+      pixidx_t len = _lkEnd[n] - pix;
+      if (len > count) len = count;
+      busses[_lkBus[n]]->setPixelColors(pix - _lkStart[n], len, c);
+      pix += len; c += len; count -= len;
+    }
+  }
+
+  //reads count consecutive pixels starting at pix with a single call per bus
+  void getPixelColors(pixidx_t pix, uint16_t count, uint32_t* c) {
+    while (count) {
+      int8_t n = _overlapping ? -1 : findBus(pix);
+      if (n < 0) { //no bus or overlapping busses, read pixel by pixel
+        *c++ = getPixelColor(pix++); count--;
+        continue;
+      }
+      pixidx_t len = _lkEnd[n] - pix;
+      if (len > count) len = count;
+      busses[_lkBus[n]]->getPixelColors(pix - _lkStart[n], len, c);
+      pix += len; c += len; count -= len;
     }
   }
 
@@ -653,6 +1746,15 @@ class BusManager {
     for (uint8_t i = 0; i < numBusses; i++) {
       busses[i]->setBrightness(b);
     }
+    #ifdef WLED_ENABLE_DMX
+    if (_dmx) _dmx->setBrightness(b);
+    #endif
+  }
+
+  void setBrightnessFine(uint16_t b) {
+    for (uint8_t i = 0; i < numBusses; i++) {
+      busses[i]->setBrightnessFine(b);
+    }
   }
 
   void setSegmentCCT(int16_t cct, bool allowWBCorrection = false) {
@@ -664,14 +1766,19 @@ class BusManager {
     Bus::setCCT(cct);
   }
 
-  uint32_t getPixelColor(uint16_t pix) {
-    for (uint8_t i = 0; i < numBusses; i++) {
-      Bus* b = busses[i];
-      uint16_t bstart = b->getStart();
-      if (pix < bstart || pix >= bstart + b->getLength()) continue;
-      return b->getPixelColor(pix - bstart);
+  uint32_t getPixelColor(pixidx_t pix) {
+    if (_overlapping) {
+      for (uint8_t i = 0; i < numBusses; i++) {
+        Bus* b = busses[i];
+        pixidx_t bstart = b->getStart();
+        if (pix < bstart || pix >= bstart + b->getLength()) continue;
+        return b->getPixelColor(pix - bstart);
+      }
+      return 0;
     }
-    return 0;
+    int8_t n = findBus(pix);
+    if (n < 0) return 0;
+    return busses[_lkBus[n]]->getPixelColor(pix - _lkStart[n]);
   }
 
   bool canAllShow() {
@@ -690,24 +1797,189 @@ class BusManager {
     return numBusses;
   }
 
+  //estimated heap held by the bus drivers
+  uint32_t getMemUsage() {
+    uint32_t mem = 0;
+    for (uint8_t i=0; i<numBusses; i++) mem += busses[i]->memUsed;
+    return mem;
+  }
+
   //semi-duplicate of strip.getLengthTotal() (though that just returns strip._length, calculated in finalizeInit())
-  uint16_t getTotalLength() {
-    uint16_t len = 0;
+  pixidx_t getTotalLength() {
+    pixidx_t len = 0;
     for (uint8_t i=0; i<numBusses; i++) len += busses[i]->getLength();
     return len;
   }
 
+  //may be called from a network callback, the busses resolve the new map on the next show()
   void updateColorOrderMap(const ColorOrderMap &com) {
     memcpy(&colorOrderMap, &com, sizeof(ColorOrderMap));
+    _colorOrderChanged = true;
   }
 
   const ColorOrderMap& getColorOrderMap() const {
     return colorOrderMap;
   }
 
+  #ifdef WLED_ENABLE_DMX
+  //the DMX output, created on first use. It is kept when the LED busses are reconfigured
+  BusDMX* getDMX() {
+    if (!_dmx) _dmx = new BusDMX();
+    return _dmx;
+  }
+  #endif
+
   private:
   uint8_t numBusses = 0;
   Bus* busses[WLED_MAX_BUSSES];
+  uint32_t _showTime = 0; //micros() of the last show() that sent out a bus
+  uint32_t _wireTime = 0; //transfer time of that frame on the slowest bus
   ColorOrderMap colorOrderMap;
+  volatile bool _colorOrderChanged = false;
+  #ifdef WLED_ENABLE_DMX
+  BusDMX* _dmx = nullptr;
+  #endif
+
+  //pixel to bus lookup, entries sorted by start address
+  pixidx_t _lkStart[WLED_MAX_BUSSES];
+  pixidx_t _lkEnd[WLED_MAX_BUSSES];
+  uint8_t  _lkBus[WLED_MAX_BUSSES];
+  uint8_t  _lkLast = 0;         //last hit, consecutive pixels are usually on the same bus
+  bool     _overlapping = false; //at least two busses share pixels, lookup unusable
+
+  //sends the frame of bus b and records it, returns µs until the bus is free again
+  uint32_t showBus(Bus* b) {
+    BusStats &st = b->getStats();
+    if (!b->canShow()) st.stalls++; //show() is going to wait, network busses defer the frame
+    uint32_t start = micros();
+    b->show();
+    uint32_t took = micros() - start;
+    st.showTime = took > UINT16_MAX ? UINT16_MAX : took;
+    st.sentAt = start;
+    st.frames++;
+    st.deferred = false;
+    st.pending = !b->canShow();
+    if (!st.pending) st.wireTime = st.showTime; //synchronous bus, done when show() returns
+    uint32_t t = b->getWireTime();
+    uint32_t m = b->getMinInterval(); //busy until the next frame may be sent, so service() does not render in vain
+    return t > m ? t : m;
+  }
+
+  //nr is the driver channel, one per bus and section
+  //nullptr if the bus would not leave enough heap
+  Bus* createBus(BusConfig &bc, uint8_t nr) {
+    uint32_t mem = memUsage(bc);
+    bool net = bc.type >= TYPE_NET_DDP_RGB && bc.type < 96;
+    if (!memAdmit(mem, net ? ALLOC_COLD : ALLOC_HOT, MEM_BUSSES)) return nullptr;
+    Bus* bus;
+    if (net) bus = new BusNetwork(bc);
+    #ifdef ARDUINO_ARCH_ESP32
+    else if (bc.sections() > 1) bus = new BusSplit(bc, nr, colorOrderMap);
+    #endif
+    else if (IS_DIGITAL(bc.type)) bus = new BusDigital(bc, nr, colorOrderMap);
+    else bus = new BusPwm(bc);
+    bus->psu = bc.psu;
+    if (bus->isOk()) bus->memUsed = mem;
+    else memAllocFailed(MEM_BUSSES);
+    return bus;
+  }
+
+  #ifdef ARDUINO_ARCH_ESP32
+  //RMT index of driver channel nr of a bus of the type, WLED_RMT_BLOCKS if the channel is not sent by RMT
+  static uint8_t rmtIndex(uint8_t type, uint8_t* pins, uint8_t nr) {
+    if (!IS_DIGITAL(type) || IS_2PIN(type) || !PolyBus::isRmt(PolyBus::getI(type, pins, nr))) return WLED_RMT_BLOCKS;
+    #ifdef WLED_USE_PARALLEL_I2S
+    nr -= WLED_PARALLEL_I2S_CHANNELS;
+    #endif
+    return nr < WLED_RMT_BLOCKS ? nr : WLED_RMT_BLOCKS;
+  }
+
+  //RMT memory for the busses in cfgs, each section of a split bus is a strip of its own
+  static RmtPlan planRmt(BusConfig* cfgs[], uint8_t count) {
+    uint16_t lens[WLED_RMT_BLOCKS] = {0};
+    uint8_t nr = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      BusConfig &bc = *cfgs[i];
+      uint8_t n = bc.sections();
+      for (uint8_t k = 0; k < n; k++) {
+        uint8_t r = rmtIndex(bc.type, &bc.pins[k], nr + k);
+        if (r < WLED_RMT_BLOCKS) lens[r] = (bc.count + n - 1) / n + (k ? 0 : bc.skipAmount);
+      }
+      nr += n;
+    }
+    return PolyBus::planRmt(lens);
+  }
+
+  //true if a section of the bus for bc at driver channel nr would be sent by another RMT channel under plan
+  static bool rmtMoved(BusConfig &bc, uint8_t nr, const RmtPlan &plan) {
+    for (uint8_t k = 0; k < bc.sections(); k++) {
+      uint8_t r = rmtIndex(bc.type, &bc.pins[k], nr + k);
+      if (r < WLED_RMT_BLOCKS && plan.channel[r] != PolyBus::rmtChannel(r)) return true;
+    }
+    return false;
+  }
+
+  //a bus added after the others gets RMT memory without moving theirs
+  static void appendRmt(BusConfig &bc, uint8_t nr) {
+    for (uint8_t k = 0; k < bc.sections(); k++) PolyBus::rmtAppend(rmtIndex(bc.type, &bc.pins[k], nr + k));
+  }
+  #endif
+
+  //driver channel of the bus at index n: the bus index, shifted by the extra sections of the busses before it
+  uint8_t channelOf(uint8_t n) {
+    uint8_t ch = 0;
+    for (uint8_t i = 0; i < n && i < numBusses; i++) ch += busses[i]->getSections();
+    return ch;
+  }
+
+  //true if bus can keep its driver for bc, start, color order, reverse and power supply are updated in place
+  static bool hasSameOutput(Bus* bus, BusConfig &bc) {
+    if (bus->getType() != bc.type || bus->getSections() != bc.sections() || bus->sectionsMirrored() != bc.mirrorSections) return false;
+    uint8_t pins[5] = {255, 255, 255, 255, 255};
+    uint8_t numPins = bus->getPins(pins);
+    for (uint8_t i = 0; i < numPins; i++) if (pins[i] != bc.pins[i]) return false;
+    if (IS_PWM(bc.type)) return true; //no other driver settings
+    if (bus->getLength() != bc.count) return false;
+    if (BusNetwork::isNetwork(bc.type)) {
+      BusNetwork* nb = static_cast<BusNetwork*>(bus);
+      return nb->isRgbw() == bc.netRgbw && nb->getUniverse() == bc.netUniverse && nb->getChannel() == bc.netChannel;
+    }
+    if (IS_2PIN(bc.type) && bus->getClockKHz() != bc.clockKHz) return false;
+    return bus->skippedLeds() == bc.skipAmount && bus->isOffRefreshRequired() == (bc.refreshReq || bc.type == TYPE_TM1814);
+  }
+
+  void updateLookup() {
+    _lkLast = 0;
+    _overlapping = false;
+    for (uint8_t i = 0; i < numBusses; i++) { //insertion sort by start
+      pixidx_t start = busses[i]->getStart();
+      uint8_t j = i;
+      for (; j > 0 && _lkStart[j-1] > start; j--) {
+        _lkStart[j] = _lkStart[j-1]; _lkEnd[j] = _lkEnd[j-1]; _lkBus[j] = _lkBus[j-1];
+      }
+      _lkStart[j] = start;
+      _lkEnd[j]   = start + busses[i]->getLength();
+      _lkBus[j]   = i;
+    }
+    for (uint8_t i = 1; i < numBusses; i++) {
+      if (_lkStart[i] < _lkEnd[i-1]) _overlapping = true;
+    }
+    BusNetwork::linkShared(busses, numBusses);
+  }
+
+  //returns lookup entry of the bus containing pix, or -1
+  int8_t IRAM_ATTR findBus(pixidx_t pix) {
+    if (!numBusses) return -1;
+    if (pix >= _lkStart[_lkLast] && pix < _lkEnd[_lkLast]) return _lkLast;
+    uint8_t lo = 0, hi = numBusses; //binary search for the first entry starting after pix
+    while (lo < hi) {
+      uint8_t mid = (lo + hi) >> 1;
+      if (_lkStart[mid] <= pix) lo = mid +1;
+      else hi = mid;
+    }
+    if (lo == 0 || pix >= _lkEnd[lo-1]) return -1;
+    _lkLast = lo -1;
+    return _lkLast;
+  }
 };
 #endif
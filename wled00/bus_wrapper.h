@@ -1,7 +1,51 @@
 #ifndef BusWrapper_h
 #define BusWrapper_h
 
-#include "NeoPixelBrightnessBus.h"
+//APA102 global brightness is set per pixel by BusDigital, so the bus brightness must not be applied on top
+#if defined(WLED_APA102_GBC) && !defined(WLED_SOFTWARE_BRIGHTNESS)
+  #define WLED_SOFTWARE_BRIGHTNESS
+#endif
+
+#ifdef WLED_SOFTWARE_BRIGHTNESS
+  #include "NeoPixelBus.h"
+  #define NEOBUS NeoPixelBus //brightness is applied by BusDigital while writing pixels
+#else
+  #include "NeoPixelBrightnessBus.h"
+  #define NEOBUS NeoPixelBrightnessBus
+#endif
+#ifdef WLED_USE_RMT_SINGLE_BUFFER
+  #include "rmt_single.h"
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+  #include "driver/rmt.h"
+  //RMT memory blocks of 64 pulses the transmit channels can use, one per channel
+  #if defined(CONFIG_IDF_TARGET_ESP32C3)
+    #define WLED_RMT_BLOCKS 2
+  #elif defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32S3)
+    #define WLED_RMT_BLOCKS 4
+  #else
+    #define WLED_RMT_BLOCKS 8
+  #endif
+
+  //RMT channel of the IR receiver (ir.cpp). The ESP32 and S2 receive on a transmit channel, the last one is kept
+  //for it while the LEDs do not need it. The S3 and C3 have channels that only receive
+  #if defined(CONFIG_IDF_TARGET_ESP32C3)
+    #define WLED_RMT_RX_CHANNEL 2
+  #elif defined(CONFIG_IDF_TARGET_ESP32S3)
+    #define WLED_RMT_RX_CHANNEL 4
+  #else
+    #define WLED_RMT_RX_CHANNEL (WLED_RMT_BLOCKS -1)
+    #define WLED_RMT_RX_SHARED
+  #endif
+
+  //RMT channel and memory blocks of each RMT bus, by its RMT index (driver channel without the parallel I2S ones).
+  //A channel with more than one block uses the memory of the channels after it, so the channels are packed
+  struct RmtPlan {
+    uint8_t channel[WLED_RMT_BLOCKS];
+    uint8_t blocks[WLED_RMT_BLOCKS];  //0 if the index is unused
+  };
+#endif
 
 //Hardware SPI Pins
 #define P_8266_HS_MOSI 13
@@ -69,358 +113,152 @@
 #define I_HS_P98_3 35
 #define I_SS_P98_3 36
 
+/*** ESP32 parallel I2S/LCD (WLED_USE_PARALLEL_I2S) ***/
+#define I_32_PX_NEO_3 37
+#define I_32_PX_NEO_4 38
+#define I_32_PX_400_3 39
+
 
 /*** ESP8266 Neopixel methods ***/
 #ifdef ESP8266
 //RGB
-#define B_8266_U0_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart0Ws2813Method> //3 chan, esp8266, gpio1
-#define B_8266_U1_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart1Ws2813Method> //3 chan, esp8266, gpio2
-#define B_8266_DM_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Dma800KbpsMethod>  //3 chan, esp8266, gpio3
-#define B_8266_BB_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266BitBang800KbpsMethod> //3 chan, esp8266, bb (any pin but 16)
+#define B_8266_U0_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp8266Uart0Ws2813Method> //3 chan, esp8266, gpio1
+#define B_8266_U1_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp8266Uart1Ws2813Method> //3 chan, esp8266, gpio2
+#define B_8266_DM_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp8266Dma800KbpsMethod>  //3 chan, esp8266, gpio3
+#define B_8266_BB_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp8266BitBang800KbpsMethod> //3 chan, esp8266, bb (any pin but 16)
 //RGBW
-#define B_8266_U0_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266Uart0Ws2813Method>   //4 chan, esp8266, gpio1
-#define B_8266_U1_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266Uart1Ws2813Method>   //4 chan, esp8266, gpio2
-#define B_8266_DM_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266Dma800KbpsMethod>    //4 chan, esp8266, gpio3
-#define B_8266_BB_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp8266BitBang800KbpsMethod> //4 chan, esp8266, bb (any pin)
+#define B_8266_U0_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp8266Uart0Ws2813Method>   //4 chan, esp8266, gpio1
+#define B_8266_U1_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp8266Uart1Ws2813Method>   //4 chan, esp8266, gpio2
+#define B_8266_DM_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp8266Dma800KbpsMethod>    //4 chan, esp8266, gpio3
+#define B_8266_BB_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp8266BitBang800KbpsMethod> //4 chan, esp8266, bb (any pin)
 //400Kbps
-#define B_8266_U0_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart0400KbpsMethod>   //3 chan, esp8266, gpio1
-#define B_8266_U1_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Uart1400KbpsMethod>   //3 chan, esp8266, gpio2
-#define B_8266_DM_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266Dma400KbpsMethod>     //3 chan, esp8266, gpio3
-#define B_8266_BB_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp8266BitBang400KbpsMethod> //3 chan, esp8266, bb (any pin)
+#define B_8266_U0_400_3 NEOBUS<NeoGrbFeature, NeoEsp8266Uart0400KbpsMethod>   //3 chan, esp8266, gpio1
+#define B_8266_U1_400_3 NEOBUS<NeoGrbFeature, NeoEsp8266Uart1400KbpsMethod>   //3 chan, esp8266, gpio2
+#define B_8266_DM_400_3 NEOBUS<NeoGrbFeature, NeoEsp8266Dma400KbpsMethod>     //3 chan, esp8266, gpio3
+#define B_8266_BB_400_3 NEOBUS<NeoGrbFeature, NeoEsp8266BitBang400KbpsMethod> //3 chan, esp8266, bb (any pin)
 //TM1814 (RGBW)
-#define B_8266_U0_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266Uart0Tm1814Method>
-#define B_8266_U1_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266Uart1Tm1814Method>
-#define B_8266_DM_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266DmaTm1814Method>
-#define B_8266_BB_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp8266BitBangTm1814Method>
+#define B_8266_U0_TM1_4 NEOBUS<NeoWrgbTm1814Feature, NeoEsp8266Uart0Tm1814Method>
+#define B_8266_U1_TM1_4 NEOBUS<NeoWrgbTm1814Feature, NeoEsp8266Uart1Tm1814Method>
+#define B_8266_DM_TM1_4 NEOBUS<NeoWrgbTm1814Feature, NeoEsp8266DmaTm1814Method>
+#define B_8266_BB_TM1_4 NEOBUS<NeoWrgbTm1814Feature, NeoEsp8266BitBangTm1814Method>
 #endif
 
 /*** ESP32 Neopixel methods ***/
 #ifdef ARDUINO_ARCH_ESP32
 //RGB
-#define B_32_RN_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod>
+#ifdef WLED_USE_RMT_SINGLE_BUFFER
+#define B_32_RN_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp32RmtSingleWs2812xMethod> //sends from the pixel buffer, see rmt_single.h
+#else
+#define B_32_RN_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp32RmtNWs2812xMethod>
+#endif
 #ifndef CONFIG_IDF_TARGET_ESP32C3
-#define B_32_I0_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s0800KbpsMethod>
+#define B_32_I0_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s0800KbpsMethod>
 #endif
 #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-#define B_32_I1_NEO_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s1800KbpsMethod>
+#define B_32_I1_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s1800KbpsMethod>
 #endif
 //RGBW
-#define B_32_RN_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp32RmtNWs2812xMethod>
+#ifdef WLED_USE_RMT_SINGLE_BUFFER
+#define B_32_RN_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp32RmtSingleWs2812xMethod>
+#else
+#define B_32_RN_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp32RmtNWs2812xMethod>
+#endif
 #ifndef CONFIG_IDF_TARGET_ESP32C3
-#define B_32_I0_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp32I2s0800KbpsMethod>
+#define B_32_I0_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp32I2s0800KbpsMethod>
 #endif
 #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-#define B_32_I1_NEO_4 NeoPixelBrightnessBus<NeoGrbwFeature, NeoEsp32I2s1800KbpsMethod>
+#define B_32_I1_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp32I2s1800KbpsMethod>
 #endif
 //400Kbps
-#define B_32_RN_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32RmtN400KbpsMethod>
+#ifdef WLED_USE_RMT_SINGLE_BUFFER
+#define B_32_RN_400_3 NEOBUS<NeoGrbFeature, NeoEsp32RmtSingle400KbpsMethod>
+#else
+#define B_32_RN_400_3 NEOBUS<NeoGrbFeature, NeoEsp32RmtN400KbpsMethod>
+#endif
 #ifndef CONFIG_IDF_TARGET_ESP32C3
-#define B_32_I0_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s0400KbpsMethod>
+#define B_32_I0_400_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s0400KbpsMethod>
 #endif
 #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-#define B_32_I1_400_3 NeoPixelBrightnessBus<NeoGrbFeature, NeoEsp32I2s1400KbpsMethod>
+#define B_32_I1_400_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s1400KbpsMethod>
 #endif
 //TM1814 (RGBW)
-#define B_32_RN_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp32RmtNTm1814Method>
+#define B_32_RN_TM1_4 NEOBUS<NeoWrgbTm1814Feature, NeoEsp32RmtNTm1814Method>
 #ifndef CONFIG_IDF_TARGET_ESP32C3
-#define B_32_I0_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp32I2s0Tm1814Method>
+#define B_32_I0_TM1_4 NEOBUS<NeoWrgbTm1814Feature, NeoEsp32I2s0Tm1814Method>
 #endif
 #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-#define B_32_I1_TM1_4 NeoPixelBrightnessBus<NeoWrgbTm1814Feature, NeoEsp32I2s1Tm1814Method>
+#define B_32_I1_TM1_4 NEOBUS<NeoWrgbTm1814Feature, NeoEsp32I2s1Tm1814Method>
 #endif
 //Bit Bang theoratically possible, but very undesirable and not needed (no pin restrictions on RMT and I2S)
 
+#ifdef WLED_USE_PARALLEL_I2S
+//one bus object per strip, all of them share a single DMA buffer that is sent once every strip called Show()
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define B_32_PX_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp32LcdX16Ws2812xMethod>
+#define B_32_PX_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp32LcdX16Ws2812xMethod>
+#define B_32_PX_400_3 NEOBUS<NeoGrbFeature, NeoEsp32LcdX16400KbpsMethod>
+#elif defined(CONFIG_IDF_TARGET_ESP32S2)
+#define B_32_PX_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s0X16Ws2812xMethod>
+#define B_32_PX_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp32I2s0X16Ws2812xMethod>
+#define B_32_PX_400_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s0X16400KbpsMethod>
+#else
+#define B_32_PX_NEO_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s1X8Ws2812xMethod>
+#define B_32_PX_NEO_4 NEOBUS<NeoGrbwFeature, NeoEsp32I2s1X8Ws2812xMethod>
+#define B_32_PX_400_3 NEOBUS<NeoGrbFeature, NeoEsp32I2s1X8400KbpsMethod>
+#endif
+#endif
+
 #endif
 
 //APA102
-#define B_HS_DOT_3 NeoPixelBrightnessBus<DotStarBgrFeature, DotStarSpi5MhzMethod> //hardware SPI
-#define B_SS_DOT_3 NeoPixelBrightnessBus<DotStarBgrFeature, DotStarMethod>    //soft SPI
+#ifdef WLED_APA102_GBC
+#define B_HS_DOT_3 NEOBUS<DotStarLbgrFeature, DotStarSpiHzMethod> //hardware SPI, W carries the 5-bit global brightness
+#define B_SS_DOT_3 NEOBUS<DotStarLbgrFeature, DotStarMethod>    //soft SPI
+#else
+#define B_HS_DOT_3 NEOBUS<DotStarBgrFeature, DotStarSpiHzMethod> //hardware SPI
+#define B_SS_DOT_3 NEOBUS<DotStarBgrFeature, DotStarMethod>    //soft SPI
+#endif
 
 //LPD8806
-#define B_HS_LPD_3 NeoPixelBrightnessBus<Lpd8806GrbFeature, Lpd8806SpiMethod>
-#define B_SS_LPD_3 NeoPixelBrightnessBus<Lpd8806GrbFeature, Lpd8806Method>
+#define B_HS_LPD_3 NEOBUS<Lpd8806GrbFeature, Lpd8806SpiHzMethod>
+#define B_SS_LPD_3 NEOBUS<Lpd8806GrbFeature, Lpd8806Method>
 
 //WS2801
-//#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Spi40MhzMethod>
-//#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Spi20MhzMethod>
-//#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801SpiMethod>     // 10MHz
-#define B_HS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Spi2MhzMethod> //slower, more compatible
-#define B_SS_WS1_3 NeoPixelBrightnessBus<NeoRbgFeature, NeoWs2801Method>
+#define B_HS_WS1_3 NEOBUS<NeoRbgFeature, NeoWs2801SpiHzMethod>
+#define B_SS_WS1_3 NEOBUS<NeoRbgFeature, NeoWs2801Method>
 
 //P9813
-#define B_HS_P98_3 NeoPixelBrightnessBus<P9813BgrFeature, P9813SpiMethod>
-#define B_SS_P98_3 NeoPixelBrightnessBus<P9813BgrFeature, P9813Method>
+#define B_HS_P98_3 NEOBUS<P9813BgrFeature, P9813SpiHzMethod>
+#define B_SS_P98_3 NEOBUS<P9813BgrFeature, P9813Method>
 
-//handles pointer type conversion for all possible bus types
-class PolyBus {
+//hardware SPI clock used if a bus does not set one (kHz), the rates of the former fixed-speed methods
+#define SPI_KHZ_DOT  5000
+#define SPI_KHZ_LPD 10000
+#define SPI_KHZ_WS1  2000 //slower, more compatible
+#define SPI_KHZ_P98 10000
+
+//NeoPixelBus object of one bus type (I_XX_XXX_X) with its calls, created by PolyBus::create().
+//Each type is its own template instance, so BusDigital reaches the bus with a single virtual call
+//and the feature conversion is compiled into it. The color order stays a runtime argument, as the
+//color order map can give each pixel of a bus its own order
+class NeoDriver {
   public:
-  // Begin & initialize the PixelSettings for TM1814 strips.
-  template <class T>
-  static void beginTM1814(void* busPtr) {
-    T tm1814_strip = static_cast<T>(busPtr);
-    tm1814_strip->Begin();
-    // Max current for each LED (22.5 mA).
-    tm1814_strip->SetPixelSettings(NeoTm1814Settings(/*R*/225, /*G*/225, /*B*/225, /*W*/225));
-  }
-  static void begin(void* busPtr, uint8_t busType, uint8_t* pins) {
-    switch (busType) {
-      case I_NONE: break;
-    #ifdef ESP8266
-      case I_8266_U0_NEO_3: (static_cast<B_8266_U0_NEO_3*>(busPtr))->Begin(); break;
-      case I_8266_U1_NEO_3: (static_cast<B_8266_U1_NEO_3*>(busPtr))->Begin(); break;
-      case I_8266_DM_NEO_3: (static_cast<B_8266_DM_NEO_3*>(busPtr))->Begin(); break;
-      case I_8266_BB_NEO_3: (static_cast<B_8266_BB_NEO_3*>(busPtr))->Begin(); break;
-      case I_8266_U0_NEO_4: (static_cast<B_8266_U0_NEO_4*>(busPtr))->Begin(); break;
-      case I_8266_U1_NEO_4: (static_cast<B_8266_U1_NEO_4*>(busPtr))->Begin(); break;
-      case I_8266_DM_NEO_4: (static_cast<B_8266_DM_NEO_4*>(busPtr))->Begin(); break;
-      case I_8266_BB_NEO_4: (static_cast<B_8266_BB_NEO_4*>(busPtr))->Begin(); break;
-      case I_8266_U0_400_3: (static_cast<B_8266_U0_400_3*>(busPtr))->Begin(); break;
-      case I_8266_U1_400_3: (static_cast<B_8266_U1_400_3*>(busPtr))->Begin(); break;
-      case I_8266_DM_400_3: (static_cast<B_8266_DM_400_3*>(busPtr))->Begin(); break;
-      case I_8266_BB_400_3: (static_cast<B_8266_BB_400_3*>(busPtr))->Begin(); break;
-      case I_8266_U0_TM1_4: beginTM1814<B_8266_U0_TM1_4*>(busPtr); break;
-      case I_8266_U1_TM1_4: beginTM1814<B_8266_U1_TM1_4*>(busPtr); break;
-      case I_8266_DM_TM1_4: beginTM1814<B_8266_DM_TM1_4*>(busPtr); break;
-      case I_8266_BB_TM1_4: beginTM1814<B_8266_BB_TM1_4*>(busPtr); break;
-      case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->Begin(); break;
-      case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->Begin(); break;
-      case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->Begin(); break;
-      case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->Begin(); break;
-    #endif
-    #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->Begin(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->Begin(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->Begin(); break;
-      #endif
-      case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->Begin(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->Begin(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->Begin(); break;
-      #endif
-      case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->Begin(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->Begin(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->Begin(); break;
-      #endif
-      case I_32_RN_TM1_4: beginTM1814<B_32_RN_TM1_4*>(busPtr); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: beginTM1814<B_32_I0_TM1_4*>(busPtr); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: beginTM1814<B_32_I1_TM1_4*>(busPtr); break;
-      #endif
-      // ESP32 can (and should, to avoid inadvertantly driving the chip select signal) specify the pins used for SPI, but only in begin()
-      case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
-      case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
-      case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
-      case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->Begin(pins[1], -1, pins[0], -1); break;
-    #endif
-      case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->Begin(); break;
-      case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->Begin(); break;
-      case I_SS_WS1_3: (static_cast<B_SS_WS1_3*>(busPtr))->Begin(); break;
-      case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->Begin(); break;
-    }
-  };
-  static void* create(uint8_t busType, uint8_t* pins, uint16_t len, uint8_t channel) {
-    void* busPtr = nullptr;
-    switch (busType) {
-      case I_NONE: break;
-    #ifdef ESP8266
-      case I_8266_U0_NEO_3: busPtr = new B_8266_U0_NEO_3(len, pins[0]); break;
-      case I_8266_U1_NEO_3: busPtr = new B_8266_U1_NEO_3(len, pins[0]); break;
-      case I_8266_DM_NEO_3: busPtr = new B_8266_DM_NEO_3(len, pins[0]); break;
-      case I_8266_BB_NEO_3: busPtr = new B_8266_BB_NEO_3(len, pins[0]); break;
-      case I_8266_U0_NEO_4: busPtr = new B_8266_U0_NEO_4(len, pins[0]); break;
-      case I_8266_U1_NEO_4: busPtr = new B_8266_U1_NEO_4(len, pins[0]); break;
-      case I_8266_DM_NEO_4: busPtr = new B_8266_DM_NEO_4(len, pins[0]); break;
-      case I_8266_BB_NEO_4: busPtr = new B_8266_BB_NEO_4(len, pins[0]); break;
-      case I_8266_U0_400_3: busPtr = new B_8266_U0_400_3(len, pins[0]); break;
-      case I_8266_U1_400_3: busPtr = new B_8266_U1_400_3(len, pins[0]); break;
-      case I_8266_DM_400_3: busPtr = new B_8266_DM_400_3(len, pins[0]); break;
-      case I_8266_BB_400_3: busPtr = new B_8266_BB_400_3(len, pins[0]); break;
-      case I_8266_U0_TM1_4: busPtr = new B_8266_U0_TM1_4(len, pins[0]); break;
-      case I_8266_U1_TM1_4: busPtr = new B_8266_U1_TM1_4(len, pins[0]); break;
-      case I_8266_DM_TM1_4: busPtr = new B_8266_DM_TM1_4(len, pins[0]); break;
-      case I_8266_BB_TM1_4: busPtr = new B_8266_BB_TM1_4(len, pins[0]); break;
-    #endif
-    #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: busPtr = new B_32_RN_NEO_3(len, pins[0], (NeoBusChannel)channel); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: busPtr = new B_32_I0_NEO_3(len, pins[0]); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: busPtr = new B_32_I1_NEO_3(len, pins[0]); break;
-      #endif
-      case I_32_RN_NEO_4: busPtr = new B_32_RN_NEO_4(len, pins[0], (NeoBusChannel)channel); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: busPtr = new B_32_I0_NEO_4(len, pins[0]); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: busPtr = new B_32_I1_NEO_4(len, pins[0]); break;
-      #endif
-      case I_32_RN_400_3: busPtr = new B_32_RN_400_3(len, pins[0], (NeoBusChannel)channel); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: busPtr = new B_32_I0_400_3(len, pins[0]); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: busPtr = new B_32_I1_400_3(len, pins[0]); break;
-      #endif
-      case I_32_RN_TM1_4: busPtr = new B_32_RN_TM1_4(len, pins[0], (NeoBusChannel)channel); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: busPtr = new B_32_I0_TM1_4(len, pins[0]); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: busPtr = new B_32_I1_TM1_4(len, pins[0]); break;
-      #endif
-    #endif
-      // for 2-wire: pins[1] is clk, pins[0] is dat.  begin expects (len, clk, dat)
-      case I_HS_DOT_3: busPtr = new B_HS_DOT_3(len, pins[1], pins[0]); break;
-      case I_SS_DOT_3: busPtr = new B_SS_DOT_3(len, pins[1], pins[0]); break;
-      case I_HS_LPD_3: busPtr = new B_HS_LPD_3(len, pins[1], pins[0]); break;
-      case I_SS_LPD_3: busPtr = new B_SS_LPD_3(len, pins[1], pins[0]); break;
-      case I_HS_WS1_3: busPtr = new B_HS_WS1_3(len, pins[1], pins[0]); break;
-      case I_SS_WS1_3: busPtr = new B_SS_WS1_3(len, pins[1], pins[0]); break;
-      case I_HS_P98_3: busPtr = new B_HS_P98_3(len, pins[1], pins[0]); break;
-      case I_SS_P98_3: busPtr = new B_SS_P98_3(len, pins[1], pins[0]); break;
-    }
-    begin(busPtr, busType, pins);
-    return busPtr;
-  };
-  static void show(void* busPtr, uint8_t busType) {
-    switch (busType) {
-      case I_NONE: break;
-    #ifdef ESP8266
-      case I_8266_U0_NEO_3: (static_cast<B_8266_U0_NEO_3*>(busPtr))->Show(); break;
-      case I_8266_U1_NEO_3: (static_cast<B_8266_U1_NEO_3*>(busPtr))->Show(); break;
-      case I_8266_DM_NEO_3: (static_cast<B_8266_DM_NEO_3*>(busPtr))->Show(); break;
-      case I_8266_BB_NEO_3: (static_cast<B_8266_BB_NEO_3*>(busPtr))->Show(); break;
-      case I_8266_U0_NEO_4: (static_cast<B_8266_U0_NEO_4*>(busPtr))->Show(); break;
-      case I_8266_U1_NEO_4: (static_cast<B_8266_U1_NEO_4*>(busPtr))->Show(); break;
-      case I_8266_DM_NEO_4: (static_cast<B_8266_DM_NEO_4*>(busPtr))->Show(); break;
-      case I_8266_BB_NEO_4: (static_cast<B_8266_BB_NEO_4*>(busPtr))->Show(); break;
-      case I_8266_U0_400_3: (static_cast<B_8266_U0_400_3*>(busPtr))->Show(); break;
-      case I_8266_U1_400_3: (static_cast<B_8266_U1_400_3*>(busPtr))->Show(); break;
-      case I_8266_DM_400_3: (static_cast<B_8266_DM_400_3*>(busPtr))->Show(); break;
-      case I_8266_BB_400_3: (static_cast<B_8266_BB_400_3*>(busPtr))->Show(); break;
-      case I_8266_U0_TM1_4: (static_cast<B_8266_U0_TM1_4*>(busPtr))->Show(); break;
-      case I_8266_U1_TM1_4: (static_cast<B_8266_U1_TM1_4*>(busPtr))->Show(); break;
-      case I_8266_DM_TM1_4: (static_cast<B_8266_DM_TM1_4*>(busPtr))->Show(); break;
-      case I_8266_BB_TM1_4: (static_cast<B_8266_BB_TM1_4*>(busPtr))->Show(); break;
-    #endif
-    #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->Show(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->Show(); break;
-      #endif
-      case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->Show(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->Show(); break;
-      #endif
-      case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->Show(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->Show(); break;
-      #endif
-      case I_32_RN_TM1_4: (static_cast<B_32_RN_TM1_4*>(busPtr))->Show(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: (static_cast<B_32_I0_TM1_4*>(busPtr))->Show(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: (static_cast<B_32_I1_TM1_4*>(busPtr))->Show(); break;
-      #endif
-    #endif
-      case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->Show(); break;
-      case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->Show(); break;
-      case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->Show(); break;
-      case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->Show(); break;
-      case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->Show(); break;
-      case I_SS_WS1_3: (static_cast<B_SS_WS1_3*>(busPtr))->Show(); break;
-      case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->Show(); break;
-      case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->Show(); break;
-    }
-  };
-  static bool canShow(void* busPtr, uint8_t busType) {
-    switch (busType) {
-      case I_NONE: return true;
-    #ifdef ESP8266
-      case I_8266_U0_NEO_3: return (static_cast<B_8266_U0_NEO_3*>(busPtr))->CanShow(); break;
-      case I_8266_U1_NEO_3: return (static_cast<B_8266_U1_NEO_3*>(busPtr))->CanShow(); break;
-      case I_8266_DM_NEO_3: return (static_cast<B_8266_DM_NEO_3*>(busPtr))->CanShow(); break;
-      case I_8266_BB_NEO_3: return (static_cast<B_8266_BB_NEO_3*>(busPtr))->CanShow(); break;
-      case I_8266_U0_NEO_4: return (static_cast<B_8266_U0_NEO_4*>(busPtr))->CanShow(); break;
-      case I_8266_U1_NEO_4: return (static_cast<B_8266_U1_NEO_4*>(busPtr))->CanShow(); break;
-      case I_8266_DM_NEO_4: return (static_cast<B_8266_DM_NEO_4*>(busPtr))->CanShow(); break;
-      case I_8266_BB_NEO_4: return (static_cast<B_8266_BB_NEO_4*>(busPtr))->CanShow(); break;
-      case I_8266_U0_400_3: return (static_cast<B_8266_U0_400_3*>(busPtr))->CanShow(); break;
-      case I_8266_U1_400_3: return (static_cast<B_8266_U1_400_3*>(busPtr))->CanShow(); break;
-      case I_8266_DM_400_3: return (static_cast<B_8266_DM_400_3*>(busPtr))->CanShow(); break;
-      case I_8266_BB_400_3: return (static_cast<B_8266_BB_400_3*>(busPtr))->CanShow(); break;
-      case I_8266_U0_TM1_4: return (static_cast<B_8266_U0_TM1_4*>(busPtr))->CanShow(); break;
-      case I_8266_U1_TM1_4: return (static_cast<B_8266_U1_TM1_4*>(busPtr))->CanShow(); break;
-      case I_8266_DM_TM1_4: return (static_cast<B_8266_DM_TM1_4*>(busPtr))->CanShow(); break;
-      case I_8266_BB_TM1_4: return (static_cast<B_8266_BB_TM1_4*>(busPtr))->CanShow(); break;
-    #endif
-    #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: return (static_cast<B_32_RN_NEO_3*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: return (static_cast<B_32_I0_NEO_3*>(busPtr))->CanShow(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: return (static_cast<B_32_I1_NEO_3*>(busPtr))->CanShow(); break;
-      #endif
-      case I_32_RN_NEO_4: return (static_cast<B_32_RN_NEO_4*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: return (static_cast<B_32_I0_NEO_4*>(busPtr))->CanShow(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: return (static_cast<B_32_I1_NEO_4*>(busPtr))->CanShow(); break;
-      #endif
-      case I_32_RN_400_3: return (static_cast<B_32_RN_400_3*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: return (static_cast<B_32_I0_400_3*>(busPtr))->CanShow(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: return (static_cast<B_32_I1_400_3*>(busPtr))->CanShow(); break;
-      #endif
-      case I_32_RN_TM1_4: return (static_cast<B_32_RN_TM1_4*>(busPtr))->CanShow(); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: return (static_cast<B_32_I0_TM1_4*>(busPtr))->CanShow(); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: return (static_cast<B_32_I1_TM1_4*>(busPtr))->CanShow(); break;
-      #endif
-    #endif
-      case I_HS_DOT_3: return (static_cast<B_HS_DOT_3*>(busPtr))->CanShow(); break;
-      case I_SS_DOT_3: return (static_cast<B_SS_DOT_3*>(busPtr))->CanShow(); break;
-      case I_HS_LPD_3: return (static_cast<B_HS_LPD_3*>(busPtr))->CanShow(); break;
-      case I_SS_LPD_3: return (static_cast<B_SS_LPD_3*>(busPtr))->CanShow(); break;
-      case I_HS_WS1_3: return (static_cast<B_HS_WS1_3*>(busPtr))->CanShow(); break;
-      case I_SS_WS1_3: return (static_cast<B_SS_WS1_3*>(busPtr))->CanShow(); break;
-      case I_HS_P98_3: return (static_cast<B_HS_P98_3*>(busPtr))->CanShow(); break;
-      case I_SS_P98_3: return (static_cast<B_SS_P98_3*>(busPtr))->CanShow(); break;
-    }
-    return true;
-  };
-  static void setPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint32_t c, uint8_t co) {
+  virtual ~NeoDriver() {}
+  virtual void begin(uint8_t* pins, uint16_t clockKHz) = 0;
+  virtual void show() = 0;
+  virtual bool canShow() = 0;
+  virtual void setBrightness(uint8_t b) = 0;
+  virtual void setPixelColor(uint16_t pix, uint32_t c, uint8_t co) = 0;
+  virtual uint32_t getPixelColor(uint16_t pix, uint8_t co) = 0;
+  //encoded pixel buffer of the one-wire GRB(W) busses, marked dirty as the caller is about to write it
+  //nullptr for busses whose feature adds per-pixel framing (TM1814, DotStar, LPD8806, P9813)
+  virtual uint8_t* getPixels() { return nullptr; }
+
+  //WLED color (WRGB) to the G,R,B(,W) order of the bus
+  static inline RgbwColor orderColor(uint16_t pix, uint32_t c, uint8_t co) {
     uint8_t r = c >> 16;
     uint8_t g = c >> 8;
     uint8_t b = c >> 0;
-    uint8_t w = c >> 24;
     RgbwColor col;
 
     //TODO make color order override possible on a per-strip basis
@@ -438,191 +276,12 @@ class PolyBus {
       case  4: col.G = b; col.R = g; col.B = r; break; //4 = BGR
       default: col.G = g; col.R = b; col.B = r; break; //5 = GBR
     }
-    col.W = w;
+    col.W = c >> 24;
+    return col;
+  }
 
-    switch (busType) {
-      case I_NONE: break;
-    #ifdef ESP8266
-      case I_8266_U0_NEO_3: (static_cast<B_8266_U0_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_U1_NEO_3: (static_cast<B_8266_U1_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_DM_NEO_3: (static_cast<B_8266_DM_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_BB_NEO_3: (static_cast<B_8266_BB_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_U0_NEO_4: (static_cast<B_8266_U0_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      case I_8266_U1_NEO_4: (static_cast<B_8266_U1_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      case I_8266_DM_NEO_4: (static_cast<B_8266_DM_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      case I_8266_BB_NEO_4: (static_cast<B_8266_BB_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      case I_8266_U0_400_3: (static_cast<B_8266_U0_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_U1_400_3: (static_cast<B_8266_U1_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_DM_400_3: (static_cast<B_8266_DM_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_BB_400_3: (static_cast<B_8266_BB_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_8266_U0_TM1_4: (static_cast<B_8266_U0_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-      case I_8266_U1_TM1_4: (static_cast<B_8266_U1_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-      case I_8266_DM_TM1_4: (static_cast<B_8266_DM_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-      case I_8266_BB_TM1_4: (static_cast<B_8266_BB_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-    #endif
-    #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #endif
-      case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #endif
-      case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      #endif
-      case I_32_RN_TM1_4: (static_cast<B_32_RN_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: (static_cast<B_32_I0_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: (static_cast<B_32_I1_TM1_4*>(busPtr))->SetPixelColor(pix, col); break;
-      #endif
-    #endif
-      case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_SS_WS1_3: (static_cast<B_SS_WS1_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-      case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->SetPixelColor(pix, RgbColor(col.R,col.G,col.B)); break;
-    }
-  };
-  static void setBrightness(void* busPtr, uint8_t busType, uint8_t b) {
-    switch (busType) {
-      case I_NONE: break;
-    #ifdef ESP8266
-      case I_8266_U0_NEO_3: (static_cast<B_8266_U0_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_NEO_3: (static_cast<B_8266_U1_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_NEO_3: (static_cast<B_8266_DM_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_NEO_3: (static_cast<B_8266_BB_NEO_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U0_NEO_4: (static_cast<B_8266_U0_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_NEO_4: (static_cast<B_8266_U1_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_NEO_4: (static_cast<B_8266_DM_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_NEO_4: (static_cast<B_8266_BB_NEO_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U0_400_3: (static_cast<B_8266_U0_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_400_3: (static_cast<B_8266_U1_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_400_3: (static_cast<B_8266_DM_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_400_3: (static_cast<B_8266_BB_400_3*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U0_TM1_4: (static_cast<B_8266_U0_TM1_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_U1_TM1_4: (static_cast<B_8266_U1_TM1_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_DM_TM1_4: (static_cast<B_8266_DM_TM1_4*>(busPtr))->SetBrightness(b); break;
-      case I_8266_BB_TM1_4: (static_cast<B_8266_BB_TM1_4*>(busPtr))->SetBrightness(b); break;
-    #endif
-    #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: (static_cast<B_32_RN_NEO_3*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: (static_cast<B_32_I0_NEO_3*>(busPtr))->SetBrightness(b); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: (static_cast<B_32_I1_NEO_3*>(busPtr))->SetBrightness(b); break;
-      #endif
-      case I_32_RN_NEO_4: (static_cast<B_32_RN_NEO_4*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: (static_cast<B_32_I0_NEO_4*>(busPtr))->SetBrightness(b); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: (static_cast<B_32_I1_NEO_4*>(busPtr))->SetBrightness(b); break;
-      #endif
-      case I_32_RN_400_3: (static_cast<B_32_RN_400_3*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: (static_cast<B_32_I0_400_3*>(busPtr))->SetBrightness(b); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: (static_cast<B_32_I1_400_3*>(busPtr))->SetBrightness(b); break;
-      #endif
-      case I_32_RN_TM1_4: (static_cast<B_32_RN_TM1_4*>(busPtr))->SetBrightness(b); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: (static_cast<B_32_I0_TM1_4*>(busPtr))->SetBrightness(b); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: (static_cast<B_32_I1_TM1_4*>(busPtr))->SetBrightness(b); break;
-      #endif
-    #endif
-      case I_HS_DOT_3: (static_cast<B_HS_DOT_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_DOT_3: (static_cast<B_SS_DOT_3*>(busPtr))->SetBrightness(b); break;
-      case I_HS_LPD_3: (static_cast<B_HS_LPD_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_LPD_3: (static_cast<B_SS_LPD_3*>(busPtr))->SetBrightness(b); break;
-      case I_HS_WS1_3: (static_cast<B_HS_WS1_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_WS1_3: (static_cast<B_SS_WS1_3*>(busPtr))->SetBrightness(b); break;
-      case I_HS_P98_3: (static_cast<B_HS_P98_3*>(busPtr))->SetBrightness(b); break;
-      case I_SS_P98_3: (static_cast<B_SS_P98_3*>(busPtr))->SetBrightness(b); break;
-    }
-  };
-  static uint32_t getPixelColor(void* busPtr, uint8_t busType, uint16_t pix, uint8_t co) {
-    RgbwColor col(0,0,0,0); 
-    switch (busType) {
-      case I_NONE: break;
-    #ifdef ESP8266
-      case I_8266_U0_NEO_3: col = (static_cast<B_8266_U0_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_U1_NEO_3: col = (static_cast<B_8266_U1_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_DM_NEO_3: col = (static_cast<B_8266_DM_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_BB_NEO_3: col = (static_cast<B_8266_BB_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_U0_NEO_4: col = (static_cast<B_8266_U0_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_U1_NEO_4: col = (static_cast<B_8266_U1_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_DM_NEO_4: col = (static_cast<B_8266_DM_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_BB_NEO_4: col = (static_cast<B_8266_BB_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_U0_400_3: col = (static_cast<B_8266_U0_400_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_U1_400_3: col = (static_cast<B_8266_U1_400_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_DM_400_3: col = (static_cast<B_8266_DM_400_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_BB_400_3: col = (static_cast<B_8266_BB_400_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_U0_TM1_4: col = (static_cast<B_8266_U0_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_U1_TM1_4: col = (static_cast<B_8266_U1_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_DM_TM1_4: col = (static_cast<B_8266_DM_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-      case I_8266_BB_TM1_4: col = (static_cast<B_8266_BB_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-    #endif
-    #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: col = (static_cast<B_32_RN_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: col = (static_cast<B_32_I0_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: col = (static_cast<B_32_I1_NEO_3*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-      case I_32_RN_NEO_4: col = (static_cast<B_32_RN_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: col = (static_cast<B_32_I0_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: col = (static_cast<B_32_I1_NEO_4*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-      case I_32_RN_400_3: col = (static_cast<B_32_RN_400_3*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: col = (static_cast<B_32_I0_400_3*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: col = (static_cast<B_32_I1_400_3*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-      case I_32_RN_TM1_4: col = (static_cast<B_32_RN_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: col = (static_cast<B_32_I0_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: col = (static_cast<B_32_I1_TM1_4*>(busPtr))->GetPixelColor(pix); break;
-      #endif
-    #endif
-      case I_HS_DOT_3: col = (static_cast<B_HS_DOT_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_SS_DOT_3: col = (static_cast<B_SS_DOT_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_HS_LPD_3: col = (static_cast<B_HS_LPD_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_SS_LPD_3: col = (static_cast<B_SS_LPD_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_HS_WS1_3: col = (static_cast<B_HS_WS1_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_SS_WS1_3: col = (static_cast<B_SS_WS1_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_HS_P98_3: col = (static_cast<B_HS_P98_3*>(busPtr))->GetPixelColor(pix); break;
-      case I_SS_P98_3: col = (static_cast<B_SS_P98_3*>(busPtr))->GetPixelColor(pix); break;
-    }
-    
+  //the reverse of orderColor()
+  static inline uint32_t unorderColor(uint16_t pix, const RgbwColor& col, uint8_t co) {
     #ifdef COLOR_ORDER_OVERRIDE
     if (pix >= COO_MIN && pix < COO_MAX) co = COO_ORDER;
     #endif
@@ -639,69 +298,290 @@ class PolyBus {
     }
     return 0;
   }
+};
+
+//color object of the bus feature
+template <class C> inline C neoColor(const RgbwColor& col);
+template <> inline RgbColor  neoColor<RgbColor>(const RgbwColor& col)  { return RgbColor(col.R, col.G, col.B); }
+template <> inline RgbwColor neoColor<RgbwColor>(const RgbwColor& col) { return col; }
+
+template <class T> void neoBegin(T& bus, uint8_t* pins, uint16_t clockKHz) {
+  bus.Begin();
+}
+//Begin & initialize the PixelSettings for TM1814 strips.
+template <class T> void neoBeginTM1814(T& bus, uint8_t* pins, uint16_t clockKHz) {
+  bus.Begin();
+  // Max current for each LED (22.5 mA).
+  bus.SetPixelSettings(NeoTm1814Settings(/*R*/225, /*G*/225, /*B*/225, /*W*/225));
+}
+//ESP32 can (and should, to avoid inadvertantly driving the chip select signal) specify the pins used for SPI, but only in begin()
+template <class T, uint16_t KHZ> void neoBeginSpi(T& bus, uint8_t* pins, uint16_t clockKHz) {
+  bus.SetMethodSettings(NeoSpiSettings((uint32_t)(clockKHz ? clockKHz : KHZ) * 1000));
+  #ifdef ESP8266
+  bus.Begin();
+  #else
+  bus.Begin(pins[1], -1, pins[0], -1);
+  #endif
+}
+
+//T: NeoPixelBus type (B_XX_XXX_X), C: its color object, BEGIN: its initialization, RAW: exposes its pixel buffer
+template <class T, class C, void (*BEGIN)(T&, uint8_t*, uint16_t), bool RAW>
+class NeoDriverT : public NeoDriver {
+  public:
+  template <typename... A> NeoDriverT(A... args) : _bus(args...) {}
+
+  void begin(uint8_t* pins, uint16_t clockKHz) { BEGIN(_bus, pins, clockKHz); }
+  void show() { _bus.Show(); }
+  bool canShow() { return _bus.CanShow(); }
+
+  void setBrightness(uint8_t b) {
+    #ifndef WLED_SOFTWARE_BRIGHTNESS
+    _bus.SetBrightness(b);
+    #endif
+  }
 
-  static void cleanup(void* busPtr, uint8_t busType) {
-    if (busPtr == nullptr) return;
-    switch (busType) {
-      case I_NONE: break;
+  void setPixelColor(uint16_t pix, uint32_t c, uint8_t co) {
+    _bus.SetPixelColor(pix, neoColor<C>(orderColor(pix, c, co)));
+  }
+
+  uint32_t getPixelColor(uint16_t pix, uint8_t co) {
+    RgbwColor col = _bus.GetPixelColor(pix);
+    return unorderColor(pix, col, co);
+  }
+
+  uint8_t* getPixels() {
+    if (!RAW) return nullptr;
+    _bus.Dirty();
+    return _bus.Pixels();
+  }
+
+  private:
+  T _bus;
+};
+
+//one-wire GRB(W)
+template <class T, class C> using NeoWireDriver  = NeoDriverT<T, C, neoBegin<T>, true>;
+template <class T>          using NeoTm1814Driver = NeoDriverT<T, RgbwColor, neoBeginTM1814<T>, false>;
+//two-wire, hardware (with the default clock) and software SPI
+template <class T, uint16_t KHZ, class C = RgbColor> using NeoHspiDriver = NeoDriverT<T, C, neoBeginSpi<T, KHZ>, false>;
+template <class T, class C = RgbColor>               using NeoSspiDriver = NeoDriverT<T, C, neoBegin<T>, false>;
+
+#ifdef WLED_APA102_GBC
+  #define DOT_COLOR RgbwColor //W is the global brightness (0-31)
+#else
+  #define DOT_COLOR RgbColor
+#endif
+
+#define I_COUNT 40 //I_NONE and the types above
+typedef NeoDriver* (*NeoFactory)(uint16_t len, uint8_t* pins, uint8_t channel);
+
+//creates the bus drivers and plans the RMT channels
+class PolyBus {
+  public:
+  #ifdef ARDUINO_ARCH_ESP32
+  //the RMT channels and memory blocks in use, see planRmt()
+  static RmtPlan& rmtPlan() {
+    static RmtPlan plan = {};
+    return plan;
+  }
+
+  static bool isRmt(uint8_t busType) {
+    return busType == I_32_RN_NEO_3 || busType == I_32_RN_NEO_4 || busType == I_32_RN_400_3 || busType == I_32_RN_TM1_4;
+  }
+
+  //RMT channel of RMT index i, the index itself if it is not planned
+  static uint8_t rmtChannel(uint8_t i) {
+    RmtPlan& p = rmtPlan();
+    return (i < WLED_RMT_BLOCKS && p.blocks[i]) ? p.channel[i] : i;
+  }
+
+  //the IR receiver wants WLED_RMT_RX_CHANNEL, set before the busses are planned
+  static bool& rmtRxWanted() {
+    static bool wanted = false;
+    return wanted;
+  }
+
+  //the IR receiver has the RMT driver of WLED_RMT_RX_CHANNEL installed
+  static bool& rmtRxActive() {
+    static bool active = false;
+    return active;
+  }
+
+  //true if the LEDs leave the receive channel free under plan p
+  static bool rmtRxFree(const RmtPlan& p) {
+    #ifdef WLED_RMT_RX_SHARED
+    for (uint8_t i = 0; i < WLED_RMT_BLOCKS; i++) {
+      if (p.blocks[i] && p.channel[i] + p.blocks[i] > WLED_RMT_RX_CHANNEL) return false;
+    }
+    #endif
+    return true;
+  }
+
+  //the LEDs take the receive channel, IR falls back to interrupt capture (see handleIR())
+  static void rmtRxRelease() {
+    if (!rmtRxActive()) return;
+    rmt_rx_stop((rmt_channel_t)WLED_RMT_RX_CHANNEL);
+    rmt_driver_uninstall((rmt_channel_t)WLED_RMT_RX_CHANNEL);
+    rmtRxActive() = false;
+  }
+
+  //plan for the LEDs per RMT index (0 if unused): one block each, the spare blocks go to the strips with the
+  //most LEDs per block. More memory leaves the refill interrupt more time before the channel runs dry,
+  //so long strips do not glitch when WiFi or flash access delay it
+  static RmtPlan planRmt(const uint16_t* lens) {
+    RmtPlan p = {};
+    uint8_t spare = WLED_RMT_BLOCKS;
+    for (uint8_t i = 0; i < WLED_RMT_BLOCKS; i++) if (lens[i]) { p.blocks[i] = 1; spare--; }
+    #ifdef WLED_RMT_RX_SHARED
+    if (rmtRxWanted() && spare) spare--; //the channels are packed, so the last block stays free for IR
+    #endif
+    for (; spare; spare--) {
+      uint8_t best = WLED_RMT_BLOCKS;
+      for (uint8_t i = 0; i < WLED_RMT_BLOCKS; i++) {
+        if (lens[i] && (best == WLED_RMT_BLOCKS || (uint32_t)lens[i] * p.blocks[best] > (uint32_t)lens[best] * p.blocks[i])) best = i;
+      }
+      if (best == WLED_RMT_BLOCKS) break;
+      p.blocks[best]++;
+    }
+    uint8_t ch = 0;
+    for (uint8_t i = 0; i < WLED_RMT_BLOCKS; i++) if (p.blocks[i]) { p.channel[i] = ch; ch += p.blocks[i]; }
+    return p;
+  }
+
+  //gives RMT index i a free block without moving the channels in use (busses added one at a time).
+  //If none is free, the last block of the channel with the most is taken while the busses are not sending
+  static void rmtAppend(uint8_t i) {
+    RmtPlan& p = rmtPlan();
+    if (i >= WLED_RMT_BLOCKS || p.blocks[i]) return;
+    bool used[WLED_RMT_BLOCKS] = {false};
+    uint8_t widest = WLED_RMT_BLOCKS;
+    for (uint8_t j = 0; j < WLED_RMT_BLOCKS; j++) {
+      for (uint8_t b = 0; b < p.blocks[j]; b++) used[p.channel[j] + b] = true;
+      if (p.blocks[j] > 1 && (widest == WLED_RMT_BLOCKS || p.blocks[j] > p.blocks[widest])) widest = j;
+    }
+    #ifdef WLED_RMT_RX_SHARED
+    bool keepRx = rmtRxWanted();
+    #else
+    bool keepRx = false;
+    #endif
+    for (uint8_t b = 0; b < WLED_RMT_BLOCKS; b++) {
+      if (!used[b] && !(keepRx && b == WLED_RMT_RX_CHANNEL)) { p.channel[i] = b; p.blocks[i] = 1; return; }
+    }
+    if (widest == WLED_RMT_BLOCKS) { //only the block kept for IR is left, the LEDs come first
+      if (!keepRx || used[WLED_RMT_RX_CHANNEL]) return; //not reached, there are as many blocks as indices
+      rmtRxRelease();
+      p.channel[i] = WLED_RMT_RX_CHANNEL;
+      p.blocks[i] = 1;
+      return;
+    }
+    p.blocks[widest]--;
+    rmt_set_mem_block_num((rmt_channel_t)p.channel[widest], p.blocks[widest]);
+    p.channel[i] = p.channel[widest] + p.blocks[widest];
+    p.blocks[i] = 1;
+  }
+  #endif
+
+  template <class D> static NeoDriver* newWire(uint16_t len, uint8_t* pins, uint8_t channel) {
+    return new D(len, pins[0]);
+  }
+  #ifdef ARDUINO_ARCH_ESP32
+  template <class D> static NeoDriver* newRmt(uint16_t len, uint8_t* pins, uint8_t channel) {
+    return new D(len, pins[0], (NeoBusChannel)rmtChannel(channel));
+  }
+  #endif
+  // for 2-wire: pins[1] is clk, pins[0] is dat.  begin expects (len, clk, dat)
+  template <class D> static NeoDriver* newSpi(uint16_t len, uint8_t* pins, uint8_t channel) {
+    return new D(len, pins[1], pins[0]);
+  }
+
+  //the driver of a bus type, initialized; delete it to release the bus
+  static NeoDriver* create(uint8_t busType, uint8_t* pins, uint16_t len, uint8_t channel, uint16_t clockKHz = 0) {
+    #ifndef CONFIG_IDF_TARGET_ESP32C3
+      #define NEO_I0(...) newWire<__VA_ARGS__>
+    #else
+      #define NEO_I0(...) nullptr
+    #endif
+    #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
+      #define NEO_I1(...) newWire<__VA_ARGS__>
+    #else
+      #define NEO_I1(...) nullptr
+    #endif
+    //by type (I_XX_XXX_X), nullptr for the ones this chip does not have
+    static constexpr NeoFactory factories[I_COUNT] PROGMEM = {
+      nullptr,
     #ifdef ESP8266
-      case I_8266_U0_NEO_3: delete (static_cast<B_8266_U0_NEO_3*>(busPtr)); break;
-      case I_8266_U1_NEO_3: delete (static_cast<B_8266_U1_NEO_3*>(busPtr)); break;
-      case I_8266_DM_NEO_3: delete (static_cast<B_8266_DM_NEO_3*>(busPtr)); break;
-      case I_8266_BB_NEO_3: delete (static_cast<B_8266_BB_NEO_3*>(busPtr)); break;
-      case I_8266_U0_NEO_4: delete (static_cast<B_8266_U0_NEO_4*>(busPtr)); break;
-      case I_8266_U1_NEO_4: delete (static_cast<B_8266_U1_NEO_4*>(busPtr)); break;
-      case I_8266_DM_NEO_4: delete (static_cast<B_8266_DM_NEO_4*>(busPtr)); break;
-      case I_8266_BB_NEO_4: delete (static_cast<B_8266_BB_NEO_4*>(busPtr)); break;
-      case I_8266_U0_400_3: delete (static_cast<B_8266_U0_400_3*>(busPtr)); break;
-      case I_8266_U1_400_3: delete (static_cast<B_8266_U1_400_3*>(busPtr)); break;
-      case I_8266_DM_400_3: delete (static_cast<B_8266_DM_400_3*>(busPtr)); break;
-      case I_8266_BB_400_3: delete (static_cast<B_8266_BB_400_3*>(busPtr)); break;
-      case I_8266_U0_TM1_4: delete (static_cast<B_8266_U0_TM1_4*>(busPtr)); break;
-      case I_8266_U1_TM1_4: delete (static_cast<B_8266_U1_TM1_4*>(busPtr)); break;
-      case I_8266_DM_TM1_4: delete (static_cast<B_8266_DM_TM1_4*>(busPtr)); break;
-      case I_8266_BB_TM1_4: delete (static_cast<B_8266_BB_TM1_4*>(busPtr)); break;
+      newWire<NeoWireDriver<B_8266_U0_NEO_3, RgbColor>>,
+      newWire<NeoWireDriver<B_8266_U1_NEO_3, RgbColor>>,
+      newWire<NeoWireDriver<B_8266_DM_NEO_3, RgbColor>>,
+      newWire<NeoWireDriver<B_8266_BB_NEO_3, RgbColor>>,
+      newWire<NeoWireDriver<B_8266_U0_NEO_4, RgbwColor>>,
+      newWire<NeoWireDriver<B_8266_U1_NEO_4, RgbwColor>>,
+      newWire<NeoWireDriver<B_8266_DM_NEO_4, RgbwColor>>,
+      newWire<NeoWireDriver<B_8266_BB_NEO_4, RgbwColor>>,
+      newWire<NeoWireDriver<B_8266_U0_400_3, RgbColor>>,
+      newWire<NeoWireDriver<B_8266_U1_400_3, RgbColor>>,
+      newWire<NeoWireDriver<B_8266_DM_400_3, RgbColor>>,
+      newWire<NeoWireDriver<B_8266_BB_400_3, RgbColor>>,
+      newWire<NeoTm1814Driver<B_8266_U0_TM1_4>>,
+      newWire<NeoTm1814Driver<B_8266_U1_TM1_4>>,
+      newWire<NeoTm1814Driver<B_8266_DM_TM1_4>>,
+      newWire<NeoTm1814Driver<B_8266_BB_TM1_4>>,
+    #else
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
     #endif
     #ifdef ARDUINO_ARCH_ESP32
-      case I_32_RN_NEO_3: delete (static_cast<B_32_RN_NEO_3*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_3: delete (static_cast<B_32_I0_NEO_3*>(busPtr)); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_3: delete (static_cast<B_32_I1_NEO_3*>(busPtr)); break;
-      #endif
-      case I_32_RN_NEO_4: delete (static_cast<B_32_RN_NEO_4*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_NEO_4: delete (static_cast<B_32_I0_NEO_4*>(busPtr)); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_NEO_4: delete (static_cast<B_32_I1_NEO_4*>(busPtr)); break;
-      #endif
-      case I_32_RN_400_3: delete (static_cast<B_32_RN_400_3*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_400_3: delete (static_cast<B_32_I0_400_3*>(busPtr)); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_400_3: delete (static_cast<B_32_I1_400_3*>(busPtr)); break;
-      #endif
-      case I_32_RN_TM1_4: delete (static_cast<B_32_RN_TM1_4*>(busPtr)); break;
-      #ifndef CONFIG_IDF_TARGET_ESP32C3
-      case I_32_I0_TM1_4: delete (static_cast<B_32_I0_TM1_4*>(busPtr)); break;
-      #endif
-      #if !defined(CONFIG_IDF_TARGET_ESP32S2) && !defined(CONFIG_IDF_TARGET_ESP32C3)
-      case I_32_I1_TM1_4: delete (static_cast<B_32_I1_TM1_4*>(busPtr)); break;
-      #endif
+      newRmt<NeoWireDriver<B_32_RN_NEO_3, RgbColor>>,
+      NEO_I0(NeoWireDriver<B_32_I0_NEO_3, RgbColor>),
+      NEO_I1(NeoWireDriver<B_32_I1_NEO_3, RgbColor>),
+      newRmt<NeoWireDriver<B_32_RN_NEO_4, RgbwColor>>,
+      NEO_I0(NeoWireDriver<B_32_I0_NEO_4, RgbwColor>),
+      NEO_I1(NeoWireDriver<B_32_I1_NEO_4, RgbwColor>),
+      newRmt<NeoWireDriver<B_32_RN_400_3, RgbColor>>,
+      NEO_I0(NeoWireDriver<B_32_I0_400_3, RgbColor>),
+      NEO_I1(NeoWireDriver<B_32_I1_400_3, RgbColor>),
+      newRmt<NeoTm1814Driver<B_32_RN_TM1_4>>,
+      NEO_I0(NeoTm1814Driver<B_32_I0_TM1_4>),
+      NEO_I1(NeoTm1814Driver<B_32_I1_TM1_4>),
+    #else
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
     #endif
-      case I_HS_DOT_3: delete (static_cast<B_HS_DOT_3*>(busPtr)); break;
-      case I_SS_DOT_3: delete (static_cast<B_SS_DOT_3*>(busPtr)); break;
-      case I_HS_LPD_3: delete (static_cast<B_HS_LPD_3*>(busPtr)); break;
-      case I_SS_LPD_3: delete (static_cast<B_SS_LPD_3*>(busPtr)); break;
-      case I_HS_WS1_3: delete (static_cast<B_HS_WS1_3*>(busPtr)); break;
-      case I_SS_WS1_3: delete (static_cast<B_SS_WS1_3*>(busPtr)); break;
-      case I_HS_P98_3: delete (static_cast<B_HS_P98_3*>(busPtr)); break;
-      case I_SS_P98_3: delete (static_cast<B_SS_P98_3*>(busPtr)); break;
+      newSpi<NeoHspiDriver<B_HS_DOT_3, SPI_KHZ_DOT, DOT_COLOR>>,
+      newSpi<NeoSspiDriver<B_SS_DOT_3, DOT_COLOR>>,
+      newSpi<NeoHspiDriver<B_HS_LPD_3, SPI_KHZ_LPD>>,
+      newSpi<NeoSspiDriver<B_SS_LPD_3>>,
+      newSpi<NeoHspiDriver<B_HS_WS1_3, SPI_KHZ_WS1>>,
+      newSpi<NeoSspiDriver<B_SS_WS1_3>>,
+      newSpi<NeoHspiDriver<B_HS_P98_3, SPI_KHZ_P98>>,
+      newSpi<NeoSspiDriver<B_SS_P98_3>>,
+    #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PARALLEL_I2S)
+      newWire<NeoWireDriver<B_32_PX_NEO_3, RgbColor>>,
+      newWire<NeoWireDriver<B_32_PX_NEO_4, RgbwColor>>,
+      newWire<NeoWireDriver<B_32_PX_400_3, RgbColor>>
+    #else
+      nullptr, nullptr, nullptr
+    #endif
+    };
+    #undef NEO_I0
+    #undef NEO_I1
+
+    if (busType >= I_COUNT) return nullptr;
+    NeoFactory factory = (NeoFactory)pgm_read_ptr(&factories[busType]);
+    if (!factory) return nullptr;
+    #ifdef WLED_USE_PARALLEL_I2S
+    if (channel >= WLED_PARALLEL_I2S_CHANNELS) channel -= WLED_PARALLEL_I2S_CHANNELS; //RMT channels follow the parallel busses
+    #endif
+    NeoDriver* driver = factory(len, pins, channel);
+    driver->begin(pins, clockKHz);
+    #ifdef ARDUINO_ARCH_ESP32
+    //NeoPixelBus installs the channel with one block, the driver refills half of the memory at a time from the next write
+    if (isRmt(busType) && channel < WLED_RMT_BLOCKS && rmtPlan().blocks[channel] > 1) {
+      rmt_set_mem_block_num((rmt_channel_t)rmtChannel(channel), rmtPlan().blocks[channel]);
     }
-  }
+    #endif
+    return driver;
+  };
 
   //gives back the internal type index (I_XX_XXX_X above) for the input 
   static uint8_t getI(uint8_t busType, uint8_t* pins, uint8_t num = 0) {
@@ -739,6 +619,27 @@ class PolyBus {
           return I_8266_U0_TM1_4 + offset;
       }
       #else //ESP32
+      #ifdef WLED_USE_PARALLEL_I2S
+      //num 0 to WLED_PARALLEL_I2S_CHANNELS-1 are sent in parallel, the following busses use RMT (no single channel I2S)
+      if (num < WLED_PARALLEL_I2S_CHANNELS) {
+        switch (busType) {
+          case TYPE_WS2812_RGB:
+          case TYPE_WS2812_WWA:
+            return I_32_PX_NEO_3;
+          case TYPE_SK6812_RGBW:
+            return I_32_PX_NEO_4;
+          case TYPE_WS2811_400KHZ:
+            return I_32_PX_400_3;
+        }
+        return I_NONE; //TM1814 needs per strip pixel settings, not available in parallel mode
+      }
+      num -= WLED_PARALLEL_I2S_CHANNELS;
+      #ifndef CONFIG_IDF_TARGET_ESP32S2
+      if (num > 7) return I_NONE;
+      #else
+      if (num > 3) return I_NONE;
+      #endif
+      #endif
       uint8_t offset = 0; //0 = RMT (num 0-7) 8 = I2S0 9 = I2S1
       #ifndef CONFIG_IDF_TARGET_ESP32S2
       if (num > 9) return I_NONE;
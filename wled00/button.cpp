@@ -96,14 +96,9 @@ bool isButtonPressed(uint8_t i)
   return false;
 }
 
+//fires the switch action once the switch kept its position for WLED_DEBOUNCE_THRESHOLD, edges come from buttonEdge()
 void handleSwitch(uint8_t b)
 {
-  // isButtonPressed() handles inverted/noninverted logic
-  if (buttonPressedBefore[b] != isButtonPressed(b)) {
-    buttonPressedTime[b] = millis();
-    buttonPressedBefore[b] = !buttonPressedBefore[b];
-  }
-
   if (buttonLongPressed[b] == buttonPressedBefore[b]) return;
     
   if (millis() - buttonPressedTime[b] > WLED_DEBOUNCE_THRESHOLD) { //fire edge event only after 50ms without change (debounce)
@@ -131,19 +126,70 @@ void handleSwitch(uint8_t b)
   }
 }
 
-void handleAnalog(uint8_t b)
+/*
+ * Analog buttons and potentiometers are sampled every WLED_ANALOG_SAMPLE_MS into a running average by a task on ESP32.
+ * On ESP8266 the loop takes a sample every four intervals, A0 must not be read much more often with WiFi on.
+ * handleAnalog() only takes the filtered value, once per frame, so the knob is followed at frame rate.
+ * The continuous ADC DMA mode of newer IDF versions is not available with this core, and its I2S ADC mode
+ * would take I2S0 from the LED busses, so the task reads single samples.
+ */
+#ifndef WLED_ANALOG_SAMPLE_MS
+  #define WLED_ANALOG_SAMPLE_MS 5
+#endif
+#ifdef ESP8266
+  #define ANALOG_FILTER_SHIFT 2 // weight of a new sample 1/4 (time constant about 4 samples)
+#else
+  #define ANALOG_FILTER_SHIFT 3 // 1/8
+#endif
+
+static volatile uint16_t analogFilter[WLED_MAX_BUTTONS]; // 8 bit value with 4 fractional bits, i.e. 12 bit ADC scale
+static bool analogSeen[WLED_MAX_BUTTONS] = {false};
+
+static inline bool isAnalog(uint8_t b)
+{
+  return buttonType[b] == BTN_TYPE_ANALOG || buttonType[b] == BTN_TYPE_ANALOG_INVERTED;
+}
+
+static void sampleAnalog(uint8_t b)
 {
-  static uint8_t oldRead[WLED_MAX_BUTTONS];
   #ifdef ESP8266
-  uint16_t aRead = analogRead(A0) >> 2; // convert 10bit read to 8bit
+  uint16_t raw = analogRead(A0) << 2; // 10 bit
   #else
-  uint16_t aRead = analogRead(btnPin[b]) >> 4; // convert 12bit read to 8bit
+  if (btnPin[b] < 0) return;
+  uint16_t raw = analogRead(btnPin[b]);
   #endif
+  if (!analogSeen[b]) { analogFilter[b] = raw; analogSeen[b] = true; return; }
+  int32_t f = analogFilter[b];
+  analogFilter[b] = f + (((int32_t)raw - f) >> ANALOG_FILTER_SHIFT);
+}
 
-  if (buttonType[b] == BTN_TYPE_ANALOG_INVERTED) aRead = 255 - aRead;
+#ifdef ARDUINO_ARCH_ESP32
+static TaskHandle_t analogTask = nullptr;
 
-  // remove noise & reduce frequency of UI updates
-  aRead &= 0xFC;
+static void analogSampler(void*)
+{
+  TickType_t wake = xTaskGetTickCount();
+  for (;;) {
+    for (uint8_t b = 0; b < WLED_MAX_BUTTONS; b++) if (isAnalog(b)) sampleAnalog(b);
+    vTaskDelayUntil(&wake, max(pdMS_TO_TICKS(WLED_ANALOG_SAMPLE_MS), (TickType_t)1));
+  }
+}
+#endif
+
+void handleAnalog(uint8_t b)
+{
+  static uint8_t oldRead[WLED_MAX_BUTTONS];
+  static uint8_t level[WLED_MAX_BUTTONS];
+  if (!analogSeen[b]) return;
+
+  // hysteresis of 1.25 steps against noise, the ends are always reached
+  uint16_t f = analogFilter[b];
+  if (f < 16) level[b] = 0;
+  else if (f > 4080) level[b] = 255;
+  else if (f > level[b] * 16 + 20 || f + 20 < level[b] * 16) level[b] = min((f + 8) >> 4, 255);
+  uint8_t aRead = level[b];
+
+  if (buttonType[b] == BTN_TYPE_ANALOG_INVERTED) aRead = 255 - aRead;
 
   if (oldRead[b] == aRead) return;  // no change in reading
   oldRead[b] = aRead;
@@ -167,7 +213,7 @@ void handleAnalog(uint8_t b)
       effectIntensity = aRead;
     } else if (macroDoublePress[b] == 247) {
       // selected palette
-      effectPalette = map(aRead, 0, 252, 0, strip.getPaletteCount()-1);
+      effectPalette = map(aRead, 0, 255, 0, strip.getPaletteCount()-1);
     } else if (macroDoublePress[b] == 200) {
       // primary color, hue, full saturation
       colorHStoRGB(aRead*256,255,col);
@@ -191,80 +237,221 @@ void handleAnalog(uint8_t b)
   colorUpdated(CALL_MODE_BUTTON);
 }
 
+static inline bool isSwitch(uint8_t b)
+{
+  return buttonType[b] == BTN_TYPE_SWITCH || buttonType[b] == BTN_TYPE_PIR_SENSOR;
+}
+
+//a press or release at time t (ms), t is when the edge was captured and may lie before the current loop pass
+static void buttonEdge(uint8_t b, bool pressed, unsigned long t)
+{
+  if (pressed == buttonPressedBefore[b]) return;
+  if (isSwitch(b)) { //debounced and fired by handleSwitch()
+    buttonPressedTime[b] = t;
+    buttonPressedBefore[b] = pressed;
+    return;
+  }
+
+  //momentary button logic
+  if (pressed) {
+    buttonPressedTime[b] = t;
+    buttonPressedBefore[b] = true;
+    return;
+  }
+
+  //released
+  long dur = t - buttonPressedTime[b];
+  if (dur < WLED_DEBOUNCE_THRESHOLD) {buttonPressedBefore[b] = false; return;} //too short "press", debounce
+  bool doublePress = buttonWaitTime[b]; //did we have a short press before?
+  buttonWaitTime[b] = 0;
+
+  if (b == 0 && dur > WLED_LONG_AP) { // long press on button 0 (when released)
+    if (dur > WLED_LONG_FACTORY_RESET) { // factory reset if pressed > 10 seconds
+      WLED_FS.format();
+      clearEEPROM();
+      doReboot = true;
+    } else {
+      WLED::instance().initAP(true);
+    }
+  } else if (!buttonLongPressed[b]) { //short press
+    if (b != 1 && !macroDoublePress[b]) { //don't wait for double press on buttons without a default action if no double press macro set
+      shortPressAction(b);
+    } else { //double press if less than 350 ms between current press and previous short press release (buttonWaitTime!=0)
+      if (doublePress) {
+        doublePressAction(b);
+      } else {
+        buttonWaitTime[b] = t ? t : 1;
+      }
+    }
+  }
+  buttonPressedBefore[b] = false;
+  buttonLongPressed[b] = false;
+}
+
+//long press and double press timeouts of a momentary button
+static void buttonTimers(uint8_t b)
+{
+  if (buttonPressedBefore[b] && millis() - buttonPressedTime[b] > WLED_LONG_PRESS) { //long press
+    if (!buttonLongPressed[b]) longPressAction(b);
+    else if (b) { //repeatable action (~3 times per s) on button > 0
+      longPressAction(b);
+      buttonPressedTime[b] = millis() - WLED_LONG_REPEATED_ACTION; //300ms
+    }
+    buttonLongPressed[b] = true;
+  }
+
+  //if 350ms elapsed since last short press release it is a short press
+  if (buttonWaitTime[b] && millis() - buttonWaitTime[b] > WLED_DOUBLE_PRESS && !buttonPressedBefore[b]) {
+    buttonWaitTime[b] = 0;
+    shortPressAction(b);
+  }
+}
+
+#ifndef WLED_DISABLE_BUTTON_INTERRUPTS
+/*
+ * Digital buttons, switches and PIR sensors are read by GPIO interrupts. Every change of the debounced level is
+ * queued with the time it happened and evaluated by the main loop, so presses are timed correctly however long
+ * a frame takes, and idle buttons are not read at all. Touch and analog inputs are still polled.
+ */
+#define BTN_EVENT_QUEUE 16
+
+struct ButtonEvent {
+  uint32_t ms;
+  uint8_t  b;
+  bool     pressed;
+};
+
+static volatile ButtonEvent btnEvents[BTN_EVENT_QUEUE];
+static volatile uint8_t btnEventHead = 0, btnEventTail = 0; //written by the interrupt / the loop only
+static volatile bool btnEventOverflow = false;
+static volatile bool btnIrqLevel[WLED_MAX_BUTTONS];        //last queued state
+static bool    btnIrqAttached[WLED_MAX_BUTTONS] = {false};
+static int8_t  btnIrqPin[WLED_MAX_BUTTONS];
+static uint8_t btnIrqType[WLED_MAX_BUTTONS];
+
+static void IRAM_ATTR buttonISR(void* arg)
+{
+  uint8_t b = (uintptr_t)arg;
+  bool level = digitalRead(btnIrqPin[b]);
+  bool pressed = (btnIrqType[b] == BTN_TYPE_PUSH_ACT_HIGH || btnIrqType[b] == BTN_TYPE_PIR_SENSOR) ? level : !level;
+  if (pressed == btnIrqLevel[b]) return;
+  uint8_t next = (btnEventHead + 1) % BTN_EVENT_QUEUE;
+  if (next == btnEventTail) { btnEventOverflow = true; return; }
+  btnEvents[btnEventHead].ms = millis();
+  btnEvents[btnEventHead].b = b;
+  btnEvents[btnEventHead].pressed = pressed;
+  btnEventHead = next;
+  btnIrqLevel[b] = pressed;
+  wakeLoopFromISR();
+}
+
+static bool canUseInterrupt(uint8_t b)
+{
+  switch (buttonType[b]) {
+    case BTN_TYPE_PUSH: case BTN_TYPE_PUSH_ACT_HIGH: case BTN_TYPE_SWITCH: case BTN_TYPE_PIR_SENSOR: break;
+    default: return false;
+  }
+  #ifdef ESP8266
+  if (btnPin[b] == 16) return false; //no interrupt on GPIO16
+  #endif
+  return btnPin[b] >= 0 && digitalPinToInterrupt(btnPin[b]) != NOT_AN_INTERRUPT;
+}
+
+//follows button setting changes, returns whether the button is interrupt driven
+static bool updateButtonInterrupt(uint8_t b)
+{
+  bool use = canUseInterrupt(b);
+  if (use && btnIrqAttached[b] && btnIrqPin[b] == btnPin[b] && btnIrqType[b] == buttonType[b]) return true;
+  if (btnIrqAttached[b]) detachInterrupt(btnIrqPin[b]);
+  btnIrqAttached[b] = false;
+  if (!use) return false;
+  btnIrqType[b] = buttonType[b];
+  btnIrqPin[b] = btnPin[b];
+  btnIrqLevel[b] = isButtonPressed(b);
+  buttonEdge(b, btnIrqLevel[b], millis());
+  attachInterruptArg(btnPin[b], buttonISR, (void*)(uintptr_t)b, CHANGE);
+  btnIrqAttached[b] = true;
+  return true;
+}
+
+//evaluates the queued edges, buttons handled by a usermod are skipped
+static void handleButtonEvents(const bool* skip)
+{
+  while (btnEventTail != btnEventHead) {
+    uint8_t i = btnEventTail;
+    uint8_t b = btnEvents[i].b;
+    bool pressed = btnEvents[i].pressed;
+    uint32_t ms = btnEvents[i].ms;
+    btnEventTail = (i + 1) % BTN_EVENT_QUEUE;
+    if (b < WLED_MAX_BUTTONS && !skip[b] && btnIrqAttached[b]) buttonEdge(b, pressed, ms);
+  }
+  if (btnEventOverflow) { //edges were lost, take the current levels
+    btnEventOverflow = false;
+    for (uint8_t b = 0; b < WLED_MAX_BUTTONS; b++) {
+      if (!btnIrqAttached[b] || skip[b]) continue;
+      btnIrqLevel[b] = isButtonPressed(b);
+      buttonEdge(b, btnIrqLevel[b], millis());
+    }
+  }
+}
+#endif
+
 void handleButton()
 {
   static unsigned long lastRead = 0UL;
+  #ifdef ESP8266
+  static unsigned long lastSample = 0UL;
+  #endif
   bool analog = false;
+  bool skip[WLED_MAX_BUTTONS] = {false};
+  bool irq[WLED_MAX_BUTTONS] = {false};
 
   for (uint8_t b=0; b<WLED_MAX_BUTTONS; b++) {
+    #ifndef WLED_DISABLE_BUTTON_INTERRUPTS
+    irq[b] = updateButtonInterrupt(b);
+    #endif
     #ifdef ESP8266
-    if ((btnPin[b]<0 && !(buttonType[b] == BTN_TYPE_ANALOG || buttonType[b] == BTN_TYPE_ANALOG_INVERTED)) || buttonType[b] == BTN_TYPE_NONE) continue;
+    if ((btnPin[b]<0 && !(buttonType[b] == BTN_TYPE_ANALOG || buttonType[b] == BTN_TYPE_ANALOG_INVERTED)) || buttonType[b] == BTN_TYPE_NONE) { skip[b] = true; continue; }
     #else
-    if (btnPin[b]<0 || buttonType[b] == BTN_TYPE_NONE) continue;
+    if (btnPin[b]<0 || buttonType[b] == BTN_TYPE_NONE) { skip[b] = true; continue; }
     #endif
 
-    if (usermods.handleButton(b)) continue; // did usermod handle buttons
+    if (usermods.handleButton(b)) { skip[b] = true; continue; } // did usermod handle buttons
+  }
 
-    if ((buttonType[b] == BTN_TYPE_ANALOG || buttonType[b] == BTN_TYPE_ANALOG_INVERTED) && millis() - lastRead > 250) {   // button is not a button but a potentiometer
-      analog = true;
-      handleAnalog(b); continue;
-    }
+  #ifndef WLED_DISABLE_BUTTON_INTERRUPTS
+  handleButtonEvents(skip);
+  #endif
 
-    //button is not momentary, but switch. This is only suitable on pins whose on-boot state does not matter (NOT gpio0)
-    if (buttonType[b] == BTN_TYPE_SWITCH || buttonType[b] == BTN_TYPE_PIR_SENSOR) {
-      handleSwitch(b); continue;
+  #ifdef ARDUINO_ARCH_ESP32
+  if (!analogTask) {
+    for (uint8_t b=0; b<WLED_MAX_BUTTONS; b++) {
+      if (!skip[b] && isAnalog(b)) { xTaskCreatePinnedToCore(analogSampler, "analog", 2048, nullptr, 1, &analogTask, 0); break; }
     }
+  }
+  #else
+  if (millis() - lastSample >= WLED_ANALOG_SAMPLE_MS * 4) { // 20ms, see above
+    lastSample = millis();
+    for (uint8_t b=0; b<WLED_MAX_BUTTONS; b++) if (!skip[b] && isAnalog(b)) sampleAnalog(b);
+  }
+  #endif
 
-    //momentary button logic
-    if (isButtonPressed(b)) { //pressed
-
-      if (!buttonPressedBefore[b]) buttonPressedTime[b] = millis();
-      buttonPressedBefore[b] = true;
-
-      if (millis() - buttonPressedTime[b] > WLED_LONG_PRESS) { //long press
-        if (!buttonLongPressed[b]) longPressAction(b);
-        else if (b) { //repeatable action (~3 times per s) on button > 0
-          longPressAction(b);
-          buttonPressedTime[b] = millis() - WLED_LONG_REPEATED_ACTION; //300ms
-        }
-        buttonLongPressed[b] = true;
-      }
+  for (uint8_t b=0; b<WLED_MAX_BUTTONS; b++) {
+    if (skip[b]) continue;
 
-    } else if (!isButtonPressed(b) && buttonPressedBefore[b]) { //released
-
-      long dur = millis() - buttonPressedTime[b];
-      if (dur < WLED_DEBOUNCE_THRESHOLD) {buttonPressedBefore[b] = false; continue;} //too short "press", debounce
-      bool doublePress = buttonWaitTime[b]; //did we have a short press before?
-      buttonWaitTime[b] = 0;
-
-      if (b == 0 && dur > WLED_LONG_AP) { // long press on button 0 (when released)
-        if (dur > WLED_LONG_FACTORY_RESET) { // factory reset if pressed > 10 seconds
-          WLED_FS.format();
-          clearEEPROM();
-          doReboot = true;
-        } else {
-          WLED::instance().initAP(true);
-        }
-      } else if (!buttonLongPressed[b]) { //short press
-        if (b != 1 && !macroDoublePress[b]) { //don't wait for double press on buttons without a default action if no double press macro set
-          shortPressAction(b);
-        } else { //double press if less than 350 ms between current press and previous short press release (buttonWaitTime!=0)
-          if (doublePress) {
-            doublePressAction(b);
-          } else {
-            buttonWaitTime[b] = millis();
-          }
-        }
+    if (isAnalog(b)) {   // button is not a button but a potentiometer
+      if (millis() - lastRead >= 1000U / strip.getTargetFps()) {
+        analog = true;
+        handleAnalog(b);
       }
-      buttonPressedBefore[b] = false;
-      buttonLongPressed[b] = false;
+      continue;
     }
 
-    //if 350ms elapsed since last short press release it is a short press
-    if (buttonWaitTime[b] && millis() - buttonWaitTime[b] > WLED_DOUBLE_PRESS && !buttonPressedBefore[b]) {
-      buttonWaitTime[b] = 0;
-      shortPressAction(b);
-    }
+    if (!irq[b]) buttonEdge(b, isButtonPressed(b), millis());
+
+    //button is not momentary, but switch. This is only suitable on pins whose on-boot state does not matter (NOT gpio0)
+    if (isSwitch(b)) handleSwitch(b);
+    else buttonTimers(b);
   }
   if (analog) lastRead = millis();
 }
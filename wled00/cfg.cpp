@@ -9,10 +9,436 @@
 //simple macro for ArduinoJSON's or syntax
 #define CJSON(a,b) a = b | a
 
+/*
+ * Schema of the plain scalar settings. Each row ties a cfg.json key path to its global, the valid range and
+ * the field on a settings page. deserializeConfig(), writeConfig(), handleSettingsSet() and getSettingsJS()
+ * all walk this table, so such a setting needs one row instead of four hand-written lines in three files.
+ * Settings with side effects, strings, arrays or scaled units stay hand-written next to their section.
+ */
+#define CFG_BOOL 0
+#define CFG_U8   1
+#define CFG_U16  2
+#define CFG_INT  3
+
+typedef struct CfgSetting {
+  char    path[20]; // keys below the cfg.json root, separated by '/'
+  char    form[4];  // settings page field, empty if not on a page
+  uint8_t page;     // settings subpage of the field
+  uint8_t type;     // CFG_...
+  int32_t min, max; // values outside are ignored
+  void*   ptr;      // the global, its width given by type
+} cfg_setting;
+
+// rows stay in flash and are copied out one at a time
+static const cfg_setting cfgSchema[] PROGMEM = {
+  {"if/sync/port0",       "UP", 4, CFG_U16,  1, 65535, &udpPort},
+  {"if/sync/port1",       "U2", 4, CFG_U16,  1, 65535, &udpPort2},
+  {"if/sync/recv/bri",    "RB", 4, CFG_BOOL, 0, 1,     &receiveNotificationBrightness},
+  {"if/sync/recv/col",    "RC", 4, CFG_BOOL, 0, 1,     &receiveNotificationColor},
+  {"if/sync/recv/fx",     "RX", 4, CFG_BOOL, 0, 1,     &receiveNotificationEffects},
+  {"if/sync/recv/grp",    "GR", 4, CFG_U8,   0, 255,   &receiveGroups},
+  {"if/sync/recv/seg",    "SO", 4, CFG_BOOL, 0, 1,     &receiveSegmentOptions},
+  {"if/sync/recv/sb",     "SG", 4, CFG_BOOL, 0, 1,     &receiveSegmentBounds},
+  {"if/sync/recv/clk",    "",   0, CFG_BOOL, 0, 1,     &syncClock},
+  {"if/sync/send/btn",    "SB", 4, CFG_BOOL, 0, 1,     &notifyButton},
+  {"if/sync/send/va",     "SA", 4, CFG_BOOL, 0, 1,     &notifyAlexa},
+  {"if/sync/send/hue",    "SH", 4, CFG_BOOL, 0, 1,     &notifyHue},
+  {"if/sync/send/macro",  "SM", 4, CFG_BOOL, 0, 1,     &notifyMacro},
+  {"if/sync/send/twice",  "S2", 4, CFG_BOOL, 0, 1,     &notifyTwice},
+  {"if/sync/send/win",    "",   0, CFG_U16,  0, 65535, &notifyCoalesceMs},
+  {"if/sync/send/grp",    "GS", 4, CFG_U8,   0, 255,   &syncGroups},
+  {"if/nodes/list",       "NL", 4, CFG_BOOL, 0, 1,     &nodeListEnabled},
+  {"if/nodes/bcast",      "NB", 4, CFG_BOOL, 0, 1,     &nodeBroadcastEnabled},
+  {"if/live/en",          "RD", 4, CFG_BOOL, 0, 1,     &receiveDirect},
+  {"if/live/mso",         "MO", 4, CFG_BOOL, 0, 1,     &useMainSegmentOnly},
+  {"if/live/port",        "EP", 4, CFG_U16,  1, 65535, &e131Port},
+  {"if/live/mc",          "EM", 4, CFG_BOOL, 0, 1,     &e131Multicast},
+  {"if/live/dmx/uni",     "EU", 4, CFG_U16,  0, 63999, &e131Universe},
+  {"if/live/dmx/seqskip", "ES", 4, CFG_BOOL, 0, 1,     &e131SkipOutOfSequence},
+  {"if/live/dmx/usepri",  "",   0, CFG_BOOL, 0, 1,     &e131UsePriority},
+  {"if/live/dmx/addr",    "DA", 4, CFG_U16,  0, 510,   &DMXAddress},
+  {"if/live/dmx/mode",    "DM", 4, CFG_U8,   DMX_MODE_DISABLED, DMX_MODE_MULTIPLE_RGBW, &DMXMode},
+  {"if/live/maxbri",      "FB", 4, CFG_BOOL, 0, 1,     &arlsForceMaxBri},
+  {"if/live/no-gc",       "RG", 4, CFG_BOOL, 0, 1,     &arlsDisableGammaCorrection},
+  {"if/live/offset",      "WO", 4, CFG_INT,  -255, 255, &arlsOffset},
+};
+
+static int32_t getCfgValue(const cfg_setting& s) {
+  switch (s.type) {
+    case CFG_BOOL: return *(bool*)s.ptr;
+    case CFG_U8:   return *(uint8_t*)s.ptr;
+    case CFG_U16:  return *(uint16_t*)s.ptr;
+    default:       return *(int*)s.ptr;
+  }
+}
+
+static void setCfgValue(const cfg_setting& s, int32_t val) {
+  if (val < s.min || val > s.max) return;
+  switch (s.type) {
+    case CFG_BOOL: *(bool*)s.ptr     = val; break;
+    case CFG_U8:   *(uint8_t*)s.ptr  = val; break;
+    case CFG_U16:  *(uint16_t*)s.ptr = val; break;
+    default:       *(int*)s.ptr      = val; break;
+  }
+}
+
+//walks the path of s (split in place), key is left at the last segment. Returns a null object if a level is missing
+static JsonObject getCfgParent(JsonObject root, cfg_setting& s, char*& key, bool create) {
+  JsonObject obj = root;
+  key = s.path;
+  for (char* sep = strchr(key, '/'); sep != nullptr; sep = strchr(key, '/')) {
+    *sep = 0;
+    JsonObject next = obj[key];
+    if (next.isNull() && create) next = obj.createNestedObject(key); // char* keys are copied into the document
+    if (next.isNull()) return next;
+    obj = next;
+    key = sep + 1;
+  }
+  return obj;
+}
+
+static void deserializeCfgSchema(JsonObject doc) {
+  cfg_setting s;
+  char* key;
+  for (size_t i = 0; i < sizeof(cfgSchema)/sizeof(cfg_setting); i++) {
+    memcpy_P(&s, &cfgSchema[i], sizeof(cfg_setting));
+    JsonVariant val = getCfgParent(doc, s, key, false)[key];
+    if (val.isNull()) continue;
+    setCfgValue(s, (s.type == CFG_BOOL) ? (int32_t)val.as<bool>() : val.as<int32_t>());
+  }
+}
+
+static void serializeCfgSchema(JsonObject doc) {
+  cfg_setting s;
+  char* key;
+  for (size_t i = 0; i < sizeof(cfgSchema)/sizeof(cfg_setting); i++) {
+    memcpy_P(&s, &cfgSchema[i], sizeof(cfg_setting));
+    JsonObject parent = getCfgParent(doc, s, key, true);
+    if (s.type == CFG_BOOL) parent[key] = (bool)getCfgValue(s);
+    else                    parent[key] = getCfgValue(s);
+  }
+}
+
+//applies the schema fields of a submitted settings page, unchecked boxes are not sent and read as false
+void setCfgSchemaFromForm(AsyncWebServerRequest *request, byte subPage) {
+  cfg_setting s;
+  for (size_t i = 0; i < sizeof(cfgSchema)/sizeof(cfg_setting); i++) {
+    memcpy_P(&s, &cfgSchema[i], sizeof(cfg_setting));
+    if (s.page != subPage || !s.form[0]) continue;
+    if (s.type == CFG_BOOL) setCfgValue(s, request->hasArg(s.form));
+    else if (request->hasArg(s.form)) setCfgValue(s, request->arg(s.form).toInt());
+  }
+}
+
+//appends the values of the schema fields of a settings page to the settings script
+void getCfgSchemaJS(byte subPage) {
+  cfg_setting s;
+  for (size_t i = 0; i < sizeof(cfgSchema)/sizeof(cfg_setting); i++) {
+    memcpy_P(&s, &cfgSchema[i], sizeof(cfg_setting));
+    if (s.page != subPage || !s.form[0]) continue;
+    sappend((s.type == CFG_BOOL) ? 'c' : 'v', s.form, getCfgValue(s));
+  }
+}
+
+#ifndef WLED_CFG_SAVE_DELAY
+#define WLED_CFG_SAVE_DELAY 1500 // ms without further changes before the settings are written
+#endif
+
+#define CFG_SAVE_MAIN 0x01
+#define CFG_SAVE_SEC  0x02
+
+static byte          cfgSavePending = 0; // CFG_SAVE_... files still to be written
+static unsigned long cfgSaveRequested = 0;
+
+static bool writeConfig();
+static bool writeConfigSec();
+
+//writes to a temporary file that replaces the old one, a power loss keeps either the old or the new settings.
+//Returns the size written, 0 on failure
+static size_t writeJsonAtomic(const char* path, const char* tmpPath, JsonDocument& doc) {
+  uint32_t start = micros();
+  File f = WLED_FS.open(tmpPath, "w");
+  if (!f) return false;
+  size_t len = serializeJson(doc, f);
+  bool ok = (len > 0 && f.size() == len);
+  f.close();
+  if (ok && !WLED_FS.rename(tmpPath, path)) { //not every FS replaces an existing file on rename
+    WLED_FS.remove(path);
+    ok = WLED_FS.rename(tmpPath, path);
+  }
+  if (!ok) WLED_FS.remove(tmpPath);
+  fsCacheDrop(path);
+  fsStatsWrite(path, len, start);
+  invalidateFSInfo();
+  return ok ? len : 0;
+}
+
+//a temporary file left by a power loss is only complete if the old file was already removed
+static void recoverConfigFile(const char* path, const char* tmpPath) {
+  if (!WLED_FS.exists(tmpPath)) return;
+  if (WLED_FS.exists(path)) WLED_FS.remove(tmpPath);
+  else WLED_FS.rename(tmpPath, path);
+}
+
 void getStringFromJson(char* dest, const char* src, size_t len) {
   if (src != nullptr) strlcpy(dest, src, len);
 }
 
+//bus of one hw.led.ins entry, nullptr if it has no pins, zero length or does not fit into MAX_LEDS
+static BusConfig* busConfigFromJson(JsonObject elm) {
+  uint8_t pins[5] = {255, 255, 255, 255, 255};
+  JsonArray pinArr = elm["pin"];
+  if (pinArr.size() == 0) return nullptr;
+  pins[0] = pinArr[0];
+  uint8_t i = 0;
+  for (int p : pinArr) {
+    pins[i++] = p;
+    if (i>4) break;
+  }
+
+  uint16_t length = elm["len"] | 1;
+  uint8_t colorOrder = (int)elm[F("order")];
+  uint8_t skipFirst = elm[F("skip")];
+  pixidx_t start = elm["start"] | 0;
+  if (length==0 || start + length > MAX_LEDS) return nullptr;
+  uint8_t ledType = elm["type"] | TYPE_WS2812_RGB;
+  bool reversed = elm["rev"];
+  bool refresh = elm["ref"] | false;
+  ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
+  bool mirror = elm[F("mir")]; // every second section of a bus split over several pins is fed from its end
+  uint16_t freq = elm[F("freq")] | 0; // SPI clock in kHz, 0 for the default of the LED type
+  bool netRgbw = elm[F("rgbw")] | false;  // network busses: 4 channels per LED
+  int netUniverse = elm[F("uni")] | -1;   // E1.31 / Art-Net universe of the first LED
+  uint32_t netChannel = elm["ch"] | 0;    // first channel in that universe, DDP data offset
+  uint8_t psu = elm[F("psu")] | 0;        // power supply with a limit of its own (hw.led.psu), 0: the main one
+
+  BusConfig* bc = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst);
+  bc->setSectionPins(pins, mirror);
+  bc->clockKHz = freq;
+  bc->setNetOutput(netRgbw, netUniverse < 0 ? bc->netUniverse : netUniverse, netChannel);
+  bc->psu = psu <= WLED_MAX_PSU ? psu : 0;
+  return bc;
+}
+
+/*
+ * Boot snapshot: the settings needed to light the LEDs (busses, power limit, boot brightness, relay) and the
+ * boot preset as MessagePack, in /boot.bin. It is written with cfg.json and lets WLED::setup() start the strip
+ * before cfg.json is parsed. A snapshot is only used if cfg.json still has the size it was made from.
+ */
+#ifdef WLED_ENABLE_BOOT_SNAPSHOT
+#define BOOT_SNAPSHOT_FILE    "/boot.bin"
+#define BOOT_SNAPSHOT_VERSION 3
+#define BOOT_SNAPSHOT_PRESET_MAX 2048 // larger boot presets are read from presets.json as before
+
+#define BOOT_FLAG_CORRECT_WB  0x01
+#define BOOT_FLAG_CCT_FROM_RGB 0x02
+#define BOOT_FLAG_GAMMA_BRI   0x04
+#define BOOT_FLAG_GAMMA_COL   0x08
+#define BOOT_FLAG_FADE        0x10
+#define BOOT_FLAG_TURN_ON     0x20
+#define BOOT_FLAG_AUTO_SEG    0x40
+#define BOOT_FLAG_RELAY_MODE  0x80
+
+#define BOOT_BUS_REVERSED 0x01
+#define BOOT_BUS_MIRROR   0x02
+#define BOOT_BUS_NET_RGBW 0x04
+
+struct BootSnapshot {
+  char     magic[2];       // 'W','B'
+  uint8_t  version;
+  uint8_t  busCount;
+  uint32_t build;          // VERSION, the bus layout may differ between builds
+  uint32_t cfgSize;        // cfg.json the snapshot was made from
+  uint16_t ablMilliampsMax;
+  uint16_t psuMilliampsMax[WLED_MAX_PSU];
+  uint8_t  milliampsPerLed;
+  uint8_t  autoWhiteMode;
+  uint8_t  cctBlending;
+  uint8_t  targetFps;
+  uint8_t  flags;          // BOOT_FLAG_...
+  uint8_t  briS;
+  uint8_t  bootPreset;
+  uint8_t  presetBank;
+  int8_t   rlyPin;
+  int8_t   ethernetType;
+  uint16_t transitionDelayDefault;
+  uint16_t presetLen;      // MessagePack after the busses, 0: none
+  uint16_t presetDocSize;
+} __attribute__((packed));
+
+struct BootSnapshotBus {
+  uint8_t  type;           // bit 7: off refresh
+  uint8_t  pins[5];
+  uint16_t start;
+  uint16_t count;
+  uint8_t  colorOrder;
+  uint8_t  skipAmount;
+  uint8_t  flags;          // BOOT_BUS_...
+  uint16_t clockKHz;
+  uint16_t netUniverse;
+  uint32_t netChannel;
+  uint8_t  psu;
+} __attribute__((packed));
+
+static bool bootSnapshotBusses = false; // busses were created from the snapshot, cfg.json must not add them again
+
+void dropBootSnapshot() {
+  WLED_FS.remove(BOOT_SNAPSHOT_FILE);
+}
+
+//doc holds the cfg.json content (of cfgSize bytes) and is reused to read the boot preset
+static void writeBootSnapshot(JsonDocument* doc, uint32_t cfgSize) {
+  BootSnapshot h = {};
+  BootSnapshotBus b[WLED_MAX_BUSSES] = {};
+  h.magic[0] = 'W'; h.magic[1] = 'B';
+  h.version = BOOT_SNAPSHOT_VERSION;
+  h.build = VERSION;
+  h.cfgSize = cfgSize;
+
+  uint32_t mem = 0;
+  for (JsonObject elm : (*doc)["hw"]["led"]["ins"].as<JsonArray>()) {
+    if (h.busCount >= WLED_MAX_BUSSES) break;
+    BusConfig* bc = busConfigFromJson(elm);
+    if (bc == nullptr) continue;
+    mem += BusManager::memUsage(*bc);
+    if (mem <= MAX_LED_MEMORY) {
+      BootSnapshotBus& r = b[h.busCount++];
+      r.type = bc->type | (bc->refreshReq << 7);
+      memcpy(r.pins, bc->pins, 5);
+      r.start = bc->start;
+      r.count = bc->count;
+      r.colorOrder = bc->colorOrder;
+      r.skipAmount = bc->skipAmount;
+      r.flags = (bc->reversed ? BOOT_BUS_REVERSED : 0) | (bc->mirrorSections ? BOOT_BUS_MIRROR : 0) | (bc->netRgbw ? BOOT_BUS_NET_RGBW : 0);
+      r.clockKHz = bc->clockKHz;
+      r.netUniverse = bc->netUniverse;
+      r.netChannel = bc->netChannel;
+      r.psu = bc->psu;
+    }
+    delete bc;
+  }
+
+  h.ablMilliampsMax = strip.ablMilliampsMax;
+  memcpy(h.psuMilliampsMax, strip.psuMilliampsMax, sizeof(h.psuMilliampsMax));
+  h.milliampsPerLed = strip.milliampsPerLed;
+  h.autoWhiteMode = strip.autoWhiteMode;
+  h.cctBlending = strip.cctBlending;
+  h.targetFps = strip.getTargetFps();
+  h.flags = (correctWB ? BOOT_FLAG_CORRECT_WB : 0) | (cctFromRgb ? BOOT_FLAG_CCT_FROM_RGB : 0)
+          | (strip.gammaCorrectBri ? BOOT_FLAG_GAMMA_BRI : 0) | (strip.gammaCorrectCol ? BOOT_FLAG_GAMMA_COL : 0)
+          | (fadeTransition ? BOOT_FLAG_FADE : 0) | (turnOnAtBoot ? BOOT_FLAG_TURN_ON : 0)
+          | (autoSegments ? BOOT_FLAG_AUTO_SEG : 0) | (rlyMde ? BOOT_FLAG_RELAY_MODE : 0);
+  h.briS = briS;
+  h.bootPreset = bootPreset;
+  h.presetBank = presetBank;
+  h.rlyPin = rlyPin;
+  #ifdef WLED_USE_ETHERNET
+  h.ethernetType = ethernetType;
+  #endif
+  h.transitionDelayDefault = transitionDelayDefault;
+
+  doc->clear();
+  char presetFile[16];
+  getPresetBankFile(presetFile, presetBank);
+  if (bootPreset > 0 && readObjectFromFileUsingId(presetFile, bootPreset, doc) && !doc->overflowed()) {
+    JsonObject fdo = doc->as<JsonObject>();
+    if (fdo["ps"] == bootPreset) fdo.remove("ps");
+    size_t len = measureMsgPack(*doc);
+    if (len <= BOOT_SNAPSHOT_PRESET_MAX && doc->memoryUsage() <= UINT16_MAX) {
+      h.presetLen = len;
+      h.presetDocSize = doc->memoryUsage();
+    }
+  }
+
+  DEBUG_PRINTLN(F("Writing boot snapshot..."));
+  File f = WLED_FS.open(BOOT_SNAPSHOT_FILE, "w");
+  if (!f) return;
+  f.write((const uint8_t*)&h, sizeof(h));
+  f.write((const uint8_t*)b, h.busCount * sizeof(BootSnapshotBus));
+  if (h.presetLen) serializeMsgPack(*doc, f);
+  f.close();
+}
+
+//creates the busses and sets what beginStrip() needs, false if there is no snapshot matching cfg.json
+bool loadBootSnapshot() {
+  File cfg = WLED_FS.open("/cfg.json", "r");
+  if (!cfg) return false;
+  uint32_t cfgSize = cfg.size();
+  cfg.close();
+
+  File f = WLED_FS.open(BOOT_SNAPSHOT_FILE, "r");
+  if (!f) return false;
+  BootSnapshot h;
+  BootSnapshotBus b[WLED_MAX_BUSSES];
+  bool ok = f.read((uint8_t*)&h, sizeof(h)) == sizeof(h)
+         && h.magic[0] == 'W' && h.magic[1] == 'B' && h.version == BOOT_SNAPSHOT_VERSION && h.build == VERSION
+         && h.cfgSize == cfgSize && h.busCount <= WLED_MAX_BUSSES
+         && f.size() == sizeof(h) + h.busCount * sizeof(BootSnapshotBus) + h.presetLen
+         && f.read((uint8_t*)b, h.busCount * sizeof(BootSnapshotBus)) == h.busCount * sizeof(BootSnapshotBus);
+  if (ok && h.presetLen) {
+    uint8_t* data = (uint8_t*)malloc(h.presetLen);
+    if (data && f.read(data, h.presetLen) == h.presetLen) cachePresetMsgPack(h.presetBank, h.bootPreset, data, h.presetLen, h.presetDocSize);
+    free(data);
+  }
+  f.close();
+  if (!ok) {
+    DEBUG_PRINTLN(F("Boot snapshot outdated"));
+    dropBootSnapshot();
+    return false;
+  }
+  DEBUG_PRINTLN(F("Starting from boot snapshot"));
+
+  #ifdef WLED_USE_ETHERNET
+  ethernetType = h.ethernetType;
+  WLED::instance().initEthernet(); // ethernet pins take priority, as when reading cfg.json
+  #endif
+
+  strip.ablMilliampsMax = h.ablMilliampsMax;
+  memcpy(strip.psuMilliampsMax, h.psuMilliampsMax, sizeof(h.psuMilliampsMax));
+  strip.milliampsPerLed = h.milliampsPerLed;
+  strip.autoWhiteMode = h.autoWhiteMode;
+  Bus::setAutoWhiteMode(strip.autoWhiteMode);
+  correctWB = h.flags & BOOT_FLAG_CORRECT_WB;
+  cctFromRgb = h.flags & BOOT_FLAG_CCT_FROM_RGB;
+  strip.cctBlending = h.cctBlending;
+  Bus::setCCTBlend(strip.cctBlending);
+  strip.setTargetFps(h.targetFps);
+  strip.gammaCorrectBri = h.flags & BOOT_FLAG_GAMMA_BRI;
+  strip.gammaCorrectCol = h.flags & BOOT_FLAG_GAMMA_COL;
+  fadeTransition = h.flags & BOOT_FLAG_FADE;
+  transitionDelayDefault = h.transitionDelayDefault;
+  turnOnAtBoot = h.flags & BOOT_FLAG_TURN_ON;
+  autoSegments = h.flags & BOOT_FLAG_AUTO_SEG;
+  briS = h.briS;
+  bootPreset = h.bootPreset;
+  presetBank = h.presetBank;
+  //the relay is switched by beginStrip(), the pin is allocated when cfg.json is read
+  rlyPin = h.rlyPin;
+  rlyMde = h.flags & BOOT_FLAG_RELAY_MODE;
+  if (rlyPin >= 0) pinMode(rlyPin, OUTPUT);
+
+  busses.removeAll();
+  BusConfig* cfgs[WLED_MAX_BUSSES] = {nullptr}; // created together, so the RMT memory is planned for all of them
+  for (uint8_t i = 0; i < h.busCount && i < WLED_MAX_BUSSES; i++) {
+    BootSnapshotBus& r = b[i];
+    BusConfig* bc = new BusConfig(r.type, r.pins, r.start, r.count, r.colorOrder, r.flags & BOOT_BUS_REVERSED, r.skipAmount);
+    bc->setSectionPins(r.pins, r.flags & BOOT_BUS_MIRROR);
+    bc->clockKHz = r.clockKHz;
+    bc->setNetOutput(r.flags & BOOT_BUS_NET_RGBW, r.netUniverse, r.netChannel);
+    bc->psu = r.psu;
+    cfgs[i] = bc;
+  }
+  busses.reconfigure(cfgs);
+  bootSnapshotBusses = true;
+  return true;
+}
+#else
+static bool bootSnapshotBusses = false;
+void dropBootSnapshot() {}
+static void writeBootSnapshot(JsonDocument* doc, uint32_t cfgSize) {}
+bool loadBootSnapshot() { return false; }
+#endif
+
 bool deserializeConfig(JsonObject doc, bool fromFS) {
   bool needsSave = false;
   //int rev_major = doc["rev"][0]; // 1
@@ -48,6 +474,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     CJSON(staticGateway[i], nw_ins_0_gw[i]);
     CJSON(staticSubnet[i], nw_ins_0_sn[i]);
   }
+  #ifdef WLED_ENABLE_FAST_RECONNECT
+  CJSON(wifiFastIP, doc["nw"][F("fastip")]);
+  #endif
 
   JsonObject ap = doc["ap"];
   getStringFromJson(apSSID, ap[F("ssid")], 33);
@@ -80,54 +509,41 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
 
   CJSON(strip.ablMilliampsMax, hw_led[F("maxpwr")]);
   CJSON(strip.milliampsPerLed, hw_led[F("ledma")]);
+  JsonArray hw_led_psu = hw_led[F("psu")]; // limits of the power supplies 1.. busses can be assigned to
+  if (!hw_led_psu.isNull()) for (uint8_t i = 0; i < WLED_MAX_PSU; i++) strip.psuMilliampsMax[i] = hw_led_psu[i] | 0;
   CJSON(strip.autoWhiteMode,   hw_led[F("rgbwm")]);
   Bus::setAutoWhiteMode(strip.autoWhiteMode);
   strip.fixInvalidSegments(); // refreshes segment light capabilities (in case auto white mode changed)
   CJSON(correctWB, hw_led["cct"]);
   CJSON(cctFromRgb, hw_led[F("cr")]);
   CJSON(strip.cctBlending, hw_led[F("cb")]);
+  CJSON(netOutSync, hw_led[F("nsync")]);
   Bus::setCCTBlend(strip.cctBlending);
   strip.setTargetFps(hw_led["fps"]); //NOP if 0, default 42 FPS
 
   JsonArray ins = hw_led["ins"];
   
-  if (fromFS || !ins.isNull()) {
+  if (fromFS ? !bootSnapshotBusses : !ins.isNull()) { // busses of a boot snapshot are already running
     uint8_t s = 0;  // bus iterator
     if (fromFS) busses.removeAll(); // can't safely manipulate busses directly in network callback
-    uint32_t mem = 0;
+    BusConfig* fsConfigs[WLED_MAX_BUSSES] = {nullptr}; // created together, so the RMT memory is planned for all of them
     for (JsonObject elm : ins) {
       if (s >= WLED_MAX_BUSSES) break;
-      uint8_t pins[5] = {255, 255, 255, 255, 255};
-      JsonArray pinArr = elm["pin"];
-      if (pinArr.size() == 0) continue;
-      pins[0] = pinArr[0];
-      uint8_t i = 0;
-      for (int p : pinArr) {
-        pins[i++] = p;
-        if (i>4) break;
-      }
-
-      uint16_t length = elm["len"] | 1;
-      uint8_t colorOrder = (int)elm[F("order")];
-      uint8_t skipFirst = elm[F("skip")];
-      uint16_t start = elm["start"] | 0;
-      if (length==0 || start + length > MAX_LEDS) continue; // zero length or we reached max. number of LEDs, just stop
-      uint8_t ledType = elm["type"] | TYPE_WS2812_RGB;
-      bool reversed = elm["rev"];
-      bool refresh = elm["ref"] | false;
-      ledType |= refresh << 7; // hack bit 7 to indicate strip requires off refresh
+      BusConfig* bc = busConfigFromJson(elm);
+      if (bc == nullptr) continue; // no pins, zero length or we reached max. number of LEDs
       if (fromFS) {
-        BusConfig bc = BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst);
-        mem += BusManager::memUsage(bc);
-        if (mem <= MAX_LED_MEMORY && busses.getNumBusses() <= WLED_MAX_BUSSES) busses.add(bc);  // finalization will be done in WLED::beginStrip()
+        fsConfigs[s] = bc;
       } else {
         if (busConfigs[s] != nullptr) delete busConfigs[s];
-        busConfigs[s] = new BusConfig(ledType, pins, start, length, colorOrder, reversed, skipFirst);
+        busConfigs[s] = bc;
         doInitBusses = true;
       }
       s++;
     }
-    // finalization done in beginStrip()
+    #ifdef ARDUINO_ARCH_ESP32
+    PolyBus::rmtRxWanted() = irWantsRmt(hw["ir"]["pin"] | irPin, hw["ir"]["type"] | irEnabled); // read below, but planned with the busses
+    #endif
+    if (fromFS) busses.reconfigure(fsConfigs); // up to MAX_LED_MEMORY, finalization done in beginStrip()
   }
   if (hw_led["rev"]) busses.getBus(0)->reversed = true; //set 0.11 global reversed setting for first bus
 
@@ -138,7 +554,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     uint8_t s = 0;
     for (JsonObject entry : hw_com) {
       if (s > WLED_MAX_COLOR_ORDER_MAPPINGS) break;
-      uint16_t start = entry["start"] | 0;
+      pixidx_t start = entry["start"] | 0;
       uint16_t len = entry["len"] | 0;
       uint8_t colorOrder = (int)entry[F("order")];
       com.add(start, len, colorOrder);
@@ -257,20 +673,14 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   CJSON(bootPreset, def["ps"]);
   CJSON(turnOnAtBoot, def["on"]); // true
   CJSON(briS, def["bri"]); // 128
+  CJSON(presetBank, def[F("bank")]);
+  if (presetBank >= WLED_PRESET_BANKS) presetBank = 0;
 
   JsonObject interfaces = doc["if"];
 
+  deserializeCfgSchema(doc); // sync, nodes and realtime flags and ports, see cfgSchema
+
   JsonObject if_sync = interfaces["sync"];
-  CJSON(udpPort, if_sync[F("port0")]); // 21324
-  CJSON(udpPort2, if_sync[F("port1")]); // 65506
-
-  JsonObject if_sync_recv = if_sync["recv"];
-  CJSON(receiveNotificationBrightness, if_sync_recv["bri"]);
-  CJSON(receiveNotificationColor, if_sync_recv["col"]);
-  CJSON(receiveNotificationEffects, if_sync_recv["fx"]);
-  CJSON(receiveGroups, if_sync_recv["grp"]);
-  CJSON(receiveSegmentOptions, if_sync_recv["seg"]);
-  CJSON(receiveSegmentBounds, if_sync_recv["sb"]);
   //! following line might be a problem if called after boot
   receiveNotifications = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects || receiveSegmentOptions);
 
@@ -278,35 +688,88 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   prev = notifyDirectDefault;
   CJSON(notifyDirectDefault, if_sync_send[F("dir")]);
   if (notifyDirectDefault != prev) notifyDirect = notifyDirectDefault;
-  CJSON(notifyButton, if_sync_send["btn"]);
-  CJSON(notifyAlexa, if_sync_send["va"]);
-  CJSON(notifyHue, if_sync_send["hue"]);
-  CJSON(notifyMacro, if_sync_send["macro"]);
-  CJSON(notifyTwice, if_sync_send[F("twice")]);
-  CJSON(syncGroups, if_sync_send["grp"]);
+  #ifdef WLED_ENABLE_ESPNOW
+  CJSON(espNowSync, if_sync[F("espnow")]);
+  #endif
 
   JsonObject if_nodes = interfaces["nodes"];
-  CJSON(nodeListEnabled, if_nodes[F("list")]);
-  CJSON(nodeBroadcastEnabled, if_nodes[F("bcast")]);
+  prev = streamRole;
+  CJSON(streamRole, if_nodes[F("strm")]);
+  CJSON(streamOrder, if_nodes[F("ord")]);
+  if (streamRole != prev) invalidateStreamFollowers();
+
+  #ifdef WLED_ENABLE_METRICS
+  JsonObject if_metrics = interfaces[F("metrics")];
+  CJSON(metricsFormat, if_metrics[F("fmt")]);
+  if (if_metrics["ip"].is<const char*>()) metricsIP.fromString(if_metrics["ip"].as<const char*>());
+  CJSON(metricsPort, if_metrics["port"]);
+  CJSON(metricsInterval, if_metrics[F("int")]);
+  if (!metricsInterval) metricsInterval = 1;
+  #endif
+
+  #ifdef WLED_ENABLE_LOG
+  JsonObject if_log = interfaces[F("log")];
+  CJSON(logger.level, if_log[F("lvl")]);
+  CJSON(logSerial, if_log[F("ser")]);
+  if (if_log["ip"].is<const char*>()) logSyslogIP.fromString(if_log["ip"].as<const char*>());
+  CJSON(logSyslogPort, if_log["port"]);
+  #endif
+
+  #ifdef WLED_ENABLE_AUDIO
+  JsonObject if_audio = interfaces[F("audio")];
+  CJSON(audioSyncMode, if_audio[F("sync")]);
+  CJSON(audioSyncPort, if_audio["port"]);
+  CJSON(audioSquelch, if_audio[F("sq")]);
+  #endif
 
   JsonObject if_live = interfaces["live"];
-  CJSON(receiveDirect, if_live["en"]);
-  CJSON(useMainSegmentOnly, if_live[F("mso")]);
-  CJSON(e131Port, if_live["port"]); // 5568
   if (e131Port == DDP_DEFAULT_PORT) e131Port = E131_DEFAULT_PORT; // prevent double DDP port allocation
-  CJSON(e131Multicast, if_live[F("mc")]);
-
-  JsonObject if_live_dmx = if_live[F("dmx")];
-  CJSON(e131Universe, if_live_dmx[F("uni")]);
-  CJSON(e131SkipOutOfSequence, if_live_dmx[F("seqskip")]);
-  CJSON(DMXAddress, if_live_dmx[F("addr")]);
-  CJSON(DMXMode, if_live_dmx["mode"]);
 
   tdd = if_live[F("timeout")] | -1;
   if (tdd >= 0) realtimeTimeoutMs = tdd * 100;
-  CJSON(arlsForceMaxBri, if_live[F("maxbri")]);
-  CJSON(arlsDisableGammaCorrection, if_live[F("no-gc")]); // false
-  CJSON(arlsOffset, if_live[F("offset")]); // 0
+  JsonArray if_live_prio = if_live[F("prio")]; // by realtime mode
+  for (uint8_t i = 0; i < REALTIME_MODE_COUNT; i++) {
+    CJSON(realtimePriority[i], if_live_prio[i]);
+    if (realtimePriority[i] > 200) realtimePriority[i] = 200;
+  }
+
+  JsonArray if_live_map = if_live[F("map")];
+  if (!if_live_map.isNull()) {
+    realtimeRegionCount = 0;
+    for (JsonObject rg : if_live_map) {
+      if (realtimeRegionCount >= WLED_MAX_REALTIME_REGIONS) break;
+      realtime_region &r = realtimeRegions[realtimeRegionCount];
+      r.start  = rg["s"] | 0;
+      r.len    = rg["n"] | 0;
+      r.seg    = rg.containsKey("seg");
+      r.dst    = r.seg ? (rg["seg"] | 0) : (rg["d"] | 0);
+      r.dstLen = rg[F("dn")] | 0;
+      r.rev    = rg["r"] | false;
+      if (r.len) realtimeRegionCount++;
+    }
+  }
+  JsonObject if_live_rpt = if_live[F("rpt")];
+  CJSON(repeaterLocal, if_live_rpt[F("loc")]);
+  JsonArray if_live_rpt_tgt = if_live_rpt[F("tgt")];
+  if (!if_live_rpt_tgt.isNull()) {
+    repeatTargetCount = 0;
+    for (JsonObject tg : if_live_rpt_tgt) {
+      if (repeatTargetCount >= WLED_MAX_REPEAT_TARGETS) break;
+      repeat_target &r = repeatTargets[repeatTargetCount];
+      if (!tg["ip"].is<const char*>() || !r.ip.fromString(tg["ip"].as<const char*>())) continue;
+      r.uni      = tg[F("uni")] | 1;
+      r.uniCount = tg["n"] | 0;
+      r.uniShift = tg[F("ush")] | 0;
+      r.ddpStart = tg[F("ddp")] | 0;
+      r.ddpLen   = tg[F("dn")] | 0;
+      r.ddpShift = tg[F("dsh")] | 0;
+      if (r.uniCount || r.ddpLen) repeatTargetCount++;
+    }
+  }
+  if (!fromFS) { // at boot done once the busses exist
+    initE131Universes();
+    if (realtimeMode || !realtimeRegionCount) initRealtimeMap(); // else built on entering realtime mode, without regions freed now
+  }
 
   CJSON(alexaEnabled, interfaces["va"][F("alexa")]); // false
 
@@ -332,6 +795,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
   getStringFromJson(mqttUser, if_mqtt[F("user")], 41);
   getStringFromJson(mqttPass, if_mqtt["psk"], 65); //normally not present due to security
   getStringFromJson(mqttClientID, if_mqtt[F("cid")], 41);
+  CJSON(mqttStateJson, if_mqtt[F("json")]);
 
   getStringFromJson(mqttDeviceTopic, if_mqtt[F("topics")][F("device")], 33); // "wled/test"
   getStringFromJson(mqttGroupTopic, if_mqtt[F("topics")][F("group")], 33); // ""
@@ -419,6 +883,7 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     }
     it++;
   }
+  invalidateTimers();
 
   JsonObject ota = doc["ota"];
   const char* pwd = ota["psk"]; //normally not present due to security
@@ -430,6 +895,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
     CJSON(otaLock, ota[F("lock")]);
     CJSON(wifiLock, ota[F("lock-wifi")]);
     CJSON(aOtaEnabled, ota[F("aota")]);
+    #ifdef WLED_ENABLE_FLEET_OTA
+    CJSON(fleetOTA, ota[F("fleet")]);
+    #endif
     getStringFromJson(otaPass, pwd, 33); //normally not present due to security
   }
 
@@ -463,6 +931,9 @@ bool deserializeConfig(JsonObject doc, bool fromFS) {
 }
 
 void deserializeConfigFromFS() {
+  recoverConfigFile("/cfg.json", "/cfg.tmp");
+  recoverConfigFile("/wsec.json", "/wsec.tmp");
+
   bool success = deserializeConfigSec();
   if (!success) { //if file does not exist, try reading from EEPROM
     deEEPSettings();
@@ -470,7 +941,7 @@ void deserializeConfigFromFS() {
   }
 
   #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
   #else
   if (!requestJSONBufferLock(1)) return;
   #endif
@@ -487,20 +958,54 @@ void deserializeConfigFromFS() {
   // NOTE: This routine deserializes *and* applies the configuration
   //       Therefore, must also initialize ethernet from this function
   bool needsSave = deserializeConfig(doc.as<JsonObject>(), true);
+  if (!bootSnapshotBusses) { // missing or outdated
+    File f = WLED_FS.open("/cfg.json", "r");
+    uint32_t cfgSize = f ? f.size() : 0;
+    f.close();
+    if (cfgSize) writeBootSnapshot(&doc, cfgSize);
+  }
+  bootSnapshotBusses = false;
   releaseJSONBufferLock();
 
   if (needsSave) serializeConfig(); // usermods required new prameters
 }
 
+/*
+ * Settings are not written right away: repeated saves within WLED_CFG_SAVE_DELAY are coalesced
+ * and handleConfigSave() writes them from the main loop once the LED output is idle.
+ */
 void serializeConfig() {
-  serializeConfigSec();
+  configVersion++; //name, UDP port and settings may have changed
+  cfgSavePending |= CFG_SAVE_MAIN | CFG_SAVE_SEC;
+  cfgSaveRequested = millis();
+  doSerializeConfig = true;
+}
+
+void serializeConfigSec() {
+  cfgSavePending |= CFG_SAVE_SEC;
+  cfgSaveRequested = millis();
+  doSerializeConfig = true;
+}
+
+//called from the main loop, outside the render lock. Writes at once if a reboot is waiting for the settings
+void handleConfigSave() {
+  if (!cfgSavePending) { doSerializeConfig = false; return; }
+  if (!doReboot) {
+    if (millis() - cfgSaveRequested < WLED_CFG_SAVE_DELAY) return;
+    if (strip.isUpdating()) return; //frame still being sent, try on the next pass
+  }
+  if ((cfgSavePending & CFG_SAVE_SEC) && writeConfigSec()) cfgSavePending &= ~CFG_SAVE_SEC;
+  if ((cfgSavePending & CFG_SAVE_MAIN) && writeConfig()) cfgSavePending &= ~CFG_SAVE_MAIN;
+  doSerializeConfig = cfgSavePending;
+}
 
+static bool writeConfig() {
   DEBUG_PRINTLN(F("Writing settings to /cfg.json..."));
 
   #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
   #else
-  if (!requestJSONBufferLock(2)) return;
+  if (!tryRequestJSONBufferLock(2)) return false; //buffer in use, retried on the next pass
   #endif
 
   JsonArray rev = doc.createNestedArray("rev");
@@ -531,6 +1036,9 @@ void serializeConfig() {
     nw_ins_0_gw.add(staticGateway[i]);
     nw_ins_0_sn.add(staticSubnet[i]);
   }
+  #ifdef WLED_ENABLE_FAST_RECONNECT
+  nw[F("fastip")] = wifiFastIP;
+  #endif
 
   JsonObject ap = doc.createNestedObject("ap");
   ap[F("ssid")] = apSSID;
@@ -579,15 +1087,18 @@ void serializeConfig() {
   hw_led[F("total")] = strip.getLengthTotal(); //no longer read, but provided for compatibility on downgrade
   hw_led[F("maxpwr")] = strip.ablMilliampsMax;
   hw_led[F("ledma")] = strip.milliampsPerLed;
+  JsonArray hw_led_psu = hw_led.createNestedArray(F("psu"));
+  for (uint8_t i = 0; i < WLED_MAX_PSU; i++) hw_led_psu.add(strip.psuMilliampsMax[i]);
   hw_led["cct"] = correctWB;
   hw_led[F("cr")] = cctFromRgb;
   hw_led[F("cb")] = strip.cctBlending;
+  hw_led[F("nsync")] = netOutSync;
   hw_led["fps"] = strip.getTargetFps();
   hw_led[F("rgbwm")] = strip.autoWhiteMode;
 
   JsonArray hw_led_ins = hw_led.createNestedArray("ins");
 
-  for (uint8_t s = 0; s < busses.getNumBusses(); s++) {
+  for (uint8_t s = 0; s < busses.getNumConfiguredBusses(); s++) { // without the busses of stream followers
     Bus *bus = busses.getBus(s);
     if (!bus || bus->getLength()==0) break;
     JsonObject ins = hw_led_ins.createNestedObject();
@@ -602,7 +1113,15 @@ void serializeConfig() {
     ins[F("skip")] = bus->skippedLeds();
     ins["type"] = bus->getType() & 0x7F;
     ins["ref"] = bus->isOffRefreshRequired();
-    //ins[F("rgbw")] = bus->isRgbw();
+    if (bus->getSections() > 1) ins[F("mir")] = bus->sectionsMirrored();
+    if (bus->getClockKHz()) ins[F("freq")] = bus->getClockKHz();
+    if (bus->psu) ins[F("psu")] = bus->psu;
+    if (BusNetwork::isNetwork(bus->getType())) {
+      BusNetwork* nb = static_cast<BusNetwork*>(bus);
+      ins[F("rgbw")] = nb->isRgbw();
+      ins[F("uni")] = nb->getUniverse();
+      ins["ch"] = nb->getChannel();
+    }
   }
 
   JsonArray hw_com = hw.createNestedArray(F("com"));
@@ -675,50 +1194,73 @@ void serializeConfig() {
   def["ps"] = bootPreset;
   def["on"] = turnOnAtBoot;
   def["bri"] = briS;
+  def[F("bank")] = presetBank;
 
   JsonObject interfaces = doc.createNestedObject("if");
 
   JsonObject if_sync = interfaces.createNestedObject("sync");
-  if_sync[F("port0")] = udpPort;
-  if_sync[F("port1")] = udpPort2;
-
-  JsonObject if_sync_recv = if_sync.createNestedObject("recv");
-  if_sync_recv["bri"] = receiveNotificationBrightness;
-  if_sync_recv["col"] = receiveNotificationColor;
-  if_sync_recv["fx"]  = receiveNotificationEffects;
-  if_sync_recv["grp"] = receiveGroups;
-  if_sync_recv["seg"] = receiveSegmentOptions;
-  if_sync_recv["sb"]  = receiveSegmentBounds;
-
   JsonObject if_sync_send = if_sync.createNestedObject("send");
   if_sync_send[F("dir")] = notifyDirect;
-  if_sync_send["btn"] = notifyButton;
-  if_sync_send["va"] = notifyAlexa;
-  if_sync_send["hue"] = notifyHue;
-  if_sync_send["macro"] = notifyMacro;
-  if_sync_send[F("twice")] = notifyTwice;
-  if_sync_send["grp"] = syncGroups;
+  #ifdef WLED_ENABLE_ESPNOW
+  if_sync[F("espnow")] = espNowSync;
+  #endif
 
   JsonObject if_nodes = interfaces.createNestedObject("nodes");
-  if_nodes[F("list")] = nodeListEnabled;
-  if_nodes[F("bcast")] = nodeBroadcastEnabled;
+  if_nodes[F("strm")] = streamRole;
+  if_nodes[F("ord")] = streamOrder;
+
+  #ifdef WLED_ENABLE_METRICS
+  JsonObject if_metrics = interfaces.createNestedObject(F("metrics"));
+  if_metrics[F("fmt")] = metricsFormat;
+  if_metrics["ip"] = metricsIP.toString();
+  if_metrics["port"] = metricsPort;
+  if_metrics[F("int")] = metricsInterval;
+  #endif
 
-  JsonObject if_live = interfaces.createNestedObject("live");
-  if_live["en"] = receiveDirect;
-  if_live[F("mso")] = useMainSegmentOnly;
-  if_live["port"] = e131Port;
-  if_live[F("mc")] = e131Multicast;
+  #ifdef WLED_ENABLE_LOG
+  JsonObject if_log = interfaces.createNestedObject(F("log"));
+  if_log[F("lvl")] = logger.level;
+  if_log[F("ser")] = logSerial;
+  if_log["ip"] = logSyslogIP.toString();
+  if_log["port"] = logSyslogPort;
+  #endif
 
-  JsonObject if_live_dmx = if_live.createNestedObject("dmx");
-  if_live_dmx[F("uni")] = e131Universe;
-  if_live_dmx[F("seqskip")] = e131SkipOutOfSequence;
-  if_live_dmx[F("addr")] = DMXAddress;
-  if_live_dmx["mode"] = DMXMode;
+  #ifdef WLED_ENABLE_AUDIO
+  JsonObject if_audio = interfaces.createNestedObject(F("audio"));
+  if_audio[F("sync")] = audioSyncMode;
+  if_audio["port"] = audioSyncPort;
+  if_audio[F("sq")] = audioSquelch;
+  #endif
 
+  JsonObject if_live = interfaces.createNestedObject("live");
   if_live[F("timeout")] = realtimeTimeoutMs / 100;
-  if_live[F("maxbri")] = arlsForceMaxBri;
-  if_live[F("no-gc")] = arlsDisableGammaCorrection;
-  if_live[F("offset")] = arlsOffset;
+  JsonArray if_live_prio = if_live.createNestedArray(F("prio"));
+  for (uint8_t i = 0; i < REALTIME_MODE_COUNT; i++) if_live_prio.add(realtimePriority[i]);
+  JsonArray if_live_map = if_live.createNestedArray(F("map"));
+  for (uint8_t i = 0; i < realtimeRegionCount; i++) {
+    const realtime_region &r = realtimeRegions[i];
+    JsonObject rg = if_live_map.createNestedObject();
+    rg["s"] = r.start;
+    rg["n"] = r.len;
+    if (r.seg) rg["seg"] = r.dst;
+    else       rg["d"]   = r.dst;
+    if (r.dstLen) rg[F("dn")] = r.dstLen;
+    if (r.rev) rg["r"] = true;
+  }
+  JsonObject if_live_rpt = if_live.createNestedObject(F("rpt"));
+  if_live_rpt[F("loc")] = repeaterLocal;
+  JsonArray if_live_rpt_tgt = if_live_rpt.createNestedArray(F("tgt"));
+  for (uint8_t i = 0; i < repeatTargetCount; i++) {
+    const repeat_target &r = repeatTargets[i];
+    JsonObject tg = if_live_rpt_tgt.createNestedObject();
+    tg["ip"] = r.ip.toString();
+    tg[F("uni")] = r.uni;
+    tg["n"]      = r.uniCount;
+    if (r.uniShift) tg[F("ush")] = r.uniShift;
+    tg[F("ddp")] = r.ddpStart;
+    tg[F("dn")]  = r.ddpLen;
+    if (r.ddpShift) tg[F("dsh")] = r.ddpShift;
+  }
 
   JsonObject if_va = interfaces.createNestedObject("va");
   if_va[F("alexa")] = alexaEnabled;
@@ -742,6 +1284,7 @@ void serializeConfig() {
   if_mqtt[F("user")] = mqttUser;
   if_mqtt[F("pskl")] = strlen(mqttPass);
   if_mqtt[F("cid")] = mqttClientID;
+  if_mqtt[F("json")] = mqttStateJson;
 
   JsonObject if_mqtt_topics = if_mqtt.createNestedObject(F("topics"));
   if_mqtt_topics[F("device")] = mqttDeviceTopic;
@@ -817,6 +1360,9 @@ void serializeConfig() {
   ota[F("lock-wifi")] = wifiLock;
   ota[F("pskl")] = strlen(otaPass);
   ota[F("aota")] = aOtaEnabled;
+  #ifdef WLED_ENABLE_FLEET_OTA
+  ota[F("fleet")] = fleetOTA;
+  #endif
 
   #ifdef WLED_ENABLE_DMX
   JsonObject dmx = doc.createNestedObject("dmx");
@@ -833,13 +1379,15 @@ void serializeConfig() {
   dmx[F("e131proxy")] = e131ProxyUniverse;
   #endif
 
+  serializeCfgSchema(doc.as<JsonObject>()); // fills in the objects created above, see cfgSchema
+
   JsonObject usermods_settings = doc.createNestedObject("um");
   usermods.addToConfig(usermods_settings);
 
-  File f = WLED_FS.open("/cfg.json", "w");
-  if (f) serializeJson(doc, f);
-  f.close();
+  size_t len = writeJsonAtomic("/cfg.json", "/cfg.tmp", doc);
+  if (len) writeBootSnapshot(&doc, len);
   releaseJSONBufferLock();
+  return len > 0;
 }
 
 //settings in /wsec.json, not accessible via webserver, for passwords and tokens
@@ -847,7 +1395,7 @@ bool deserializeConfigSec() {
   DEBUG_PRINTLN(F("Reading settings from /wsec.json..."));
 
   #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
   #else
   if (!requestJSONBufferLock(3)) return false;
   #endif
@@ -892,13 +1440,13 @@ bool deserializeConfigSec() {
   return true;
 }
 
-void serializeConfigSec() {
+static bool writeConfigSec() {
   DEBUG_PRINTLN(F("Writing settings to /wsec.json..."));
 
   #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
   #else
-  if (!requestJSONBufferLock(4)) return;
+  if (!tryRequestJSONBufferLock(4)) return false;
   #endif
 
   JsonObject nw = doc.createNestedObject("nw");
@@ -931,8 +1479,7 @@ void serializeConfigSec() {
   ota[F("lock-wifi")] = wifiLock;
   ota[F("aota")] = aOtaEnabled;
 
-  File f = WLED_FS.open("/wsec.json", "w");
-  if (f) serializeJson(doc, f);
-  f.close();
+  bool success = writeJsonAtomic("/wsec.json", "/wsec.tmp", doc) > 0;
   releaseJSONBufferLock();
+  return success;
 }
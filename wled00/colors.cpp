@@ -12,13 +12,13 @@ void setRandomColor(byte* rgb)
 
 void colorHStoRGB(uint16_t hue, byte sat, byte* rgb) //hue, sat to rgb
 {
-  float h = ((float)hue)/65535.0;
-  float s = ((float)sat)/255.0;
-  byte i = floor(h*6);
-  float f = h * 6-i;
-  float p = 255 * (1-s);
-  float q = 255 * (1-f*s);
-  float t = 255 * (1-(1-f)*s);
+  uint32_t h6 = (uint32_t)hue * 6;
+  h6 += h6 >> 16;          // hue * 6 / 65535 in 16.16, so hue 65535 is sector 6 (red) like 0
+  uint8_t  i = h6 >> 16;   // sector
+  uint32_t f = h6 & 0xFFFF; // position within the sector
+  byte p = 255 - sat;
+  byte q = 255 - ((f * sat + 0xFFFF) >> 16);           // 255 * (1 - f*s), truncated
+  byte t = 255 - (((0x10000 - f) * sat + 0xFFFF) >> 16); // 255 * (1 - (1-f)*s)
   switch (i%6) {
     case 0: rgb[0]=255,rgb[1]=t,rgb[2]=p;break;
     case 1: rgb[0]=q,rgb[1]=255,rgb[2]=p;break;
@@ -29,28 +29,53 @@ void colorHStoRGB(uint16_t hue, byte sat, byte* rgb) //hue, sat to rgb
   }
 }
 
-//get RGB values from color temperature in K (https://tannerhelland.com/2012/09/18/convert-temperature-rgb-algorithm-code.html)
-void colorKtoRGB(uint16_t kelvin, byte* rgb) //white spectrum to rgb, calc
+/*
+ * Tables of the approximation by Tanner Helland (https://tannerhelland.com/2012/09/18/convert-temperature-rgb-algorithm-code.html),
+ * indexed by kelvin / 100 like the original formulas. Up to 6600K red is 255 and the table holds green and blue,
+ * above blue is 255 and it holds red and green. Past 12700K red and green change slowly and are interpolated
+ * between 16x values every 3200K. Within 1 of the float formulas.
+ */
+static const byte kelvinLow[128][2] PROGMEM = {
+  {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {0,0}, {17,0}, {32,0},
+  {46,0}, {57,0}, {68,0}, {77,0}, {86,0}, {94,0}, {101,0}, {108,0},
+  {115,0}, {121,0}, {126,0}, {132,0}, {137,14}, {142,27}, {146,39}, {151,50},
+  {155,61}, {159,70}, {163,79}, {167,87}, {170,95}, {174,103}, {177,110}, {180,117},
+  {184,123}, {187,129}, {190,135}, {193,141}, {195,146}, {198,151}, {201,157}, {203,161},
+  {206,166}, {208,171}, {211,175}, {213,179}, {215,183}, {218,187}, {220,191}, {222,195},
+  {224,199}, {226,202}, {228,206}, {230,209}, {232,213}, {234,216}, {236,219}, {237,222},
+  {239,225}, {241,228}, {243,231}, {244,234}, {246,237}, {248,240}, {249,242}, {251,245},
+  {253,248}, {254,250}, {255,253}, {254,249}, {250,246}, {246,244}, {243,242}, {240,240},
+  {237,239}, {234,237}, {232,236}, {230,235}, {228,234}, {226,233}, {224,232}, {223,231},
+  {221,230}, {220,229}, {218,228}, {217,227}, {216,227}, {215,226}, {214,225}, {213,225},
+  {212,224}, {211,223}, {210,223}, {209,222}, {208,222}, {207,221}, {206,221}, {205,220},
+  {205,220}, {204,219}, {203,219}, {202,218}, {202,218}, {201,218}, {200,217}, {200,217},
+  {199,217}, {199,216}, {198,216}, {197,215}, {197,215}, {196,215}, {196,214}, {195,214},
+  {195,214}, {194,213}, {194,213}, {193,213}, {193,213}, {192,212}, {192,212}, {192,212},
+  {191,211}, {191,211}, {190,211}, {190,211}, {189,210}, {189,210}, {189,210}, {188,210},
+};
+static const uint16_t kelvinHigh[18][2] PROGMEM = {
+  {3007,3352}, {2856,3256}, {2753,3188}, {2674,3136}, {2612,3095}, {2559,3059},
+  {2515,3029}, {2476,3003}, {2442,2979}, {2412,2958}, {2384,2939}, {2359,2921},
+  {2336,2905}, {2315,2890}, {2296,2876}, {2277,2863}, {2260,2851}, {2244,2840},
+};
+
+void colorKtoRGB(uint16_t kelvin, byte* rgb) //white spectrum to rgb
 {
-  float r = 0, g = 0, b = 0;
-  float temp = kelvin / 100;
-  if (temp <= 66) {
-    r = 255;
-    g = round(99.4708025861 * log(temp) - 161.1195681661);
-    if (temp <= 19) {
-      b = 0;
-    } else {
-      b = round(138.5177312231 * log((temp - 10)) - 305.0447927307);
-    }
+  uint16_t temp = kelvin / 100;
+  if (temp < 128) {
+    byte a = pgm_read_byte(&kelvinLow[temp][0]), b = pgm_read_byte(&kelvinLow[temp][1]);
+    if (temp <= 66) { rgb[0] = 255; rgb[1] = a; rgb[2] = b; }
+    else            { rgb[0] = a; rgb[1] = b; rgb[2] = 255; }
   } else {
-    r = round(329.698727446 * pow((temp - 60), -0.1332047592));
-    g = round(288.1221695283 * pow((temp - 60), -0.0755148492));
-    b = 255;
-  } 
+    uint8_t j = (temp - 128) >> 5, frac = (temp - 128) & 31;
+    for (uint8_t c = 0; c < 2; c++) {
+      int32_t v0 = pgm_read_word(&kelvinHigh[j][c]), v1 = pgm_read_word(&kelvinHigh[j+1][c]);
+      int32_t v = (v0 * 32 + (v1 - v0) * frac + 256) >> 9; // 16x values, 32 steps
+      rgb[c] = (v > 255) ? 255 : v;
+    }
+    rgb[2] = 255;
+  }
   //g += 12; //mod by Aircoookie, a bit less accurate but visibly less pinkish
-  rgb[0] = (uint8_t) constrain(r, 0, 255);
-  rgb[1] = (uint8_t) constrain(g, 0, 255);
-  rgb[2] = (uint8_t) constrain(b, 0, 255);
   rgb[3] = 0;
 }
 
@@ -77,69 +102,74 @@ void colorCTtoRGB(uint16_t mired, byte* rgb) //white spectrum to rgb, bins
 }
 
 #ifndef WLED_DISABLE_HUESYNC
-void colorXYtoRGB(float x, float y, byte* rgb) //coordinates to rgb (https://www.developers.meethue.com/documentation/color-conversions-rgb-xy)
+// linear light (16 bit) at which the sRGB encoded value reaches 1..255, so the output is the count of entries below
+static const uint16_t srgbThreshold[255] PROGMEM = {
+  20, 40, 60, 80, 100, 120, 140, 160, 180, 199, 220, 241, 264, 288, 314,
+  340, 368, 397, 427, 459, 492, 526, 562, 599, 638, 677, 719, 762, 806, 851,
+  898, 947, 997, 1049, 1102, 1157, 1213, 1271, 1330, 1391, 1454, 1518, 1584, 1651, 1720,
+  1791, 1863, 1938, 2013, 2091, 2170, 2251, 2334, 2418, 2504, 2592, 2682, 2773, 2867, 2962,
+  3059, 3157, 3258, 3360, 3465, 3571, 3679, 3789, 3901, 4014, 4130, 4247, 4367, 4488, 4612,
+  4737, 4864, 4993, 5125, 5258, 5393, 5530, 5669, 5811, 5954, 6099, 6246, 6396, 6547, 6701,
+  6857, 7014, 7174, 7336, 7500, 7666, 7834, 8005, 8177, 8352, 8529, 8708, 8889, 9073, 9258,
+  9446, 9636, 9828, 10023, 10219, 10418, 10619, 10822, 11028, 11236, 11446, 11658, 11873, 12090, 12309,
+  12531, 12755, 12981, 13209, 13440, 13674, 13909, 14147, 14387, 14630, 14875, 15122, 15372, 15624, 15878,
+  16135, 16395, 16656, 16921, 17187, 17456, 17728, 18001, 18278, 18557, 18838, 19122, 19408, 19697, 19988,
+  20282, 20578, 20876, 21178, 21481, 21788, 22097, 22408, 22722, 23038, 23357, 23679, 24003, 24330, 24659,
+  24991, 25325, 25662, 26002, 26344, 26689, 27036, 27387, 27739, 28095, 28453, 28813, 29177, 29543, 29911,
+  30283, 30657, 31033, 31413, 31795, 32180, 32567, 32957, 33350, 33746, 34144, 34545, 34949, 35355, 35765,
+  36177, 36591, 37009, 37429, 37852, 38278, 38707, 39138, 39572, 40009, 40449, 40892, 41337, 41785, 42236,
+  42690, 43147, 43607, 44069, 44534, 45002, 45473, 45947, 46424, 46903, 47386, 47871, 48359, 48851, 49345,
+  49841, 50341, 50844, 51350, 51858, 52370, 52884, 53401, 53922, 54445, 54971, 55500, 56032, 56568, 57106,
+  57647, 58191, 58738, 59287, 59840, 60396, 60955, 61517, 62082, 62650, 63221, 63795, 64372, 64952, 65535,
+};
+
+// 8 bit sRGB of a linear value 0-65535, same as 255 * (1.055 * l^(1/2.4) - 0.055) (12.92 * l near 0) truncated
+static byte linearToSRGB(uint16_t l)
 {
-  float z = 1.0f - x - y;
-  float X = (1.0f / y) * x;
-  float Z = (1.0f / y) * z;
-  float r = (int)255*(X * 1.656492f - 0.354851f - Z * 0.255038f);
-  float g = (int)255*(-X * 0.707196f + 1.655397f + Z * 0.036152f);
-  float b = (int)255*(X * 0.051713f - 0.121364f + Z * 1.011530f);
-  if (r > b && r > g && r > 1.0f) {
-    // red is too big
-    g = g / r;
-    b = b / r;
-    r = 1.0f;
-  } else if (g > b && g > r && g > 1.0f) {
-    // green is too big
-    r = r / g;
-    b = b / g;
-    g = 1.0f;
-  } else if (b > r && b > g && b > 1.0f) {
-    // blue is too big
-    r = r / b;
-    g = g / b;
-    b = 1.0f;
+  uint8_t lo = 0, hi = 255;
+  while (lo < hi) {
+    uint8_t mid = (lo + hi) >> 1;
+    if (pgm_read_word(&srgbThreshold[mid]) <= l) lo = mid + 1;
+    else hi = mid;
   }
-  // Apply gamma correction
-  r = r <= 0.0031308f ? 12.92f * r : (1.0f + 0.055f) * pow(r, (1.0f / 2.4f)) - 0.055f;
-  g = g <= 0.0031308f ? 12.92f * g : (1.0f + 0.055f) * pow(g, (1.0f / 2.4f)) - 0.055f;
-  b = b <= 0.0031308f ? 12.92f * b : (1.0f + 0.055f) * pow(b, (1.0f / 2.4f)) - 0.055f;
+  return lo;
+}
 
-  if (r > b && r > g) {
-    // red is biggest
-    if (r > 1.0f) {
-      g = g / r;
-      b = b / r;
-      r = 1.0f;
-    }
-  } else if (g > b && g > r) {
-    // green is biggest
-    if (g > 1.0f) {
-      r = r / g;
-      b = b / g;
-      g = 1.0f;
-    }
-  } else if (b > r && b > g) {
-    // blue is biggest
-    if (b > 1.0f) {
-      r = r / b;
-      g = g / b;
-      b = 1.0f;
-    }
+//coordinates in 1/10000 to rgb (https://www.developers.meethue.com/documentation/color-conversions-rgb-xy)
+//fixed point, the brightest channel ends up at 255 like in the float version
+void colorXYtoRGB(uint16_t x, uint16_t y, byte* rgb)
+{
+  if (y == 0) y = 1;
+  int32_t X = ((uint32_t)x << 16) / y;  // x / y, 16.16
+  int32_t zn = 10000 - x - y;
+  int32_t Z = (zn >= 0) ? ((uint32_t)zn << 16) / y : -(int32_t)(((uint32_t)-zn << 16) / y); // (1 - x - y) / y
+  // wide gamut D65 matrix, 16.16
+  int64_t lin[3] = {
+    (int64_t)X *  108560 - (int64_t)23256 * 65536 - (int64_t)Z * 16714,
+    (int64_t)X * -46347  + (int64_t)108488 * 65536 + (int64_t)Z * 2369,
+    (int64_t)X *  3389   - (int64_t)7954 * 65536  + (int64_t)Z * 66292
+  };
+  int64_t m = 0;
+  for (uint8_t c = 0; c < 3; c++) {
+    if (lin[c] < 0) lin[c] = 0;
+    if (lin[c] > m) m = lin[c];
   }
-  rgb[0] = 255.0*r;
-  rgb[1] = 255.0*g;
-  rgb[2] = 255.0*b;
+  if (m == 0) { rgb[0] = rgb[1] = rgb[2] = 0; return; }
+  while (m > 0xFFFF) { m >>= 1; for (uint8_t c = 0; c < 3; c++) lin[c] >>= 1; } // scaled so the largest is 1.0
+  for (uint8_t c = 0; c < 3; c++) rgb[c] = linearToSRGB(((uint32_t)lin[c] * 65535) / (uint32_t)m);
 }
 
-void colorRGBtoXY(byte* rgb, float* xy) //rgb to coordinates (https://www.developers.meethue.com/documentation/color-conversions-rgb-xy)
+//rgb to coordinates in 1/10000 (https://www.developers.meethue.com/documentation/color-conversions-rgb-xy)
+void colorRGBtoXY(byte* rgb, uint16_t* xy)
 {
-  float X = rgb[0] * 0.664511f + rgb[1] * 0.154324f + rgb[2] * 0.162028f;
-  float Y = rgb[0] * 0.283881f + rgb[1] * 0.668433f + rgb[2] * 0.047685f;
-  float Z = rgb[0] * 0.000088f + rgb[1] * 0.072310f + rgb[2] * 0.986039f;
-  xy[0] = X / (X + Y + Z);
-  xy[1] = Y / (X + Y + Z);
+  // matrix in 16.16, the sums fit in 24 bit and are reduced to 16 bit before scaling to 1/10000
+  uint32_t X = (rgb[0] * 43549UL + rgb[1] * 10114UL + rgb[2] * 10619UL) >> 8;
+  uint32_t Y = (rgb[0] * 18604UL + rgb[1] * 43806UL + rgb[2] *  3125UL) >> 8;
+  uint32_t Z = (rgb[0] *     6UL + rgb[1] *  4739UL + rgb[2] * 64621UL) >> 8;
+  uint32_t sum = X + Y + Z;
+  if (!sum) { xy[0] = xy[1] = 0; return; }
+  xy[0] = X * 10000 / sum;
+  xy[1] = Y * 10000 / sum;
 }
 #endif // WLED_DISABLE_HUESYNC
 
@@ -219,19 +249,32 @@ void colorRGBtoRGBW(byte* rgb) //rgb to rgbw (http://codewelt.com/rgbw). (RGBW_M
 }
 */
 
-byte correctionRGB[4] = {0,0,0,0};
-uint16_t lastKelvin = 0;
+#define KELVIN_CACHE_ENTRIES 4
+byte correctionRGB[KELVIN_CACHE_ENTRIES][4];
+uint16_t cachedKelvin[KELVIN_CACHE_ENTRIES] = {0};
+uint8_t lastKelvinIdx = 0, nextKelvinIdx = 0;
 
 // adjust RGB values based on color temperature in K (range [2800-10200]) (https://en.wikipedia.org/wiki/Color_balance)
 uint32_t colorBalanceFromKelvin(uint16_t kelvin, uint32_t rgb)
 {
-  //remember so that slow colorKtoRGB() doesn't have to run for every setPixelColor()
-  if (lastKelvin != kelvin) colorKtoRGB(kelvin, correctionRGB);  // convert Kelvin to RGB
-  lastKelvin = kelvin;
+  //remember so that colorKtoRGB() doesn't have to run for every setPixelColor(),
+  //a few entries so that segments with differing CCT don't recompute it every frame
+  if (cachedKelvin[lastKelvinIdx] != kelvin) {
+    uint8_t i = 0;
+    while (i < KELVIN_CACHE_ENTRIES && cachedKelvin[i] != kelvin) i++;
+    if (i == KELVIN_CACHE_ENTRIES) {
+      i = nextKelvinIdx;
+      nextKelvinIdx = (nextKelvinIdx + 1) % KELVIN_CACHE_ENTRIES;
+      colorKtoRGB(kelvin, correctionRGB[i]);  // convert Kelvin to RGB
+      cachedKelvin[i] = kelvin;
+    }
+    lastKelvinIdx = i;
+  }
+  const byte* correction = correctionRGB[lastKelvinIdx];
   byte rgbw[4];
-  rgbw[0] = ((uint16_t) correctionRGB[0] * R(rgb)) /255; // correct R
-  rgbw[1] = ((uint16_t) correctionRGB[1] * G(rgb)) /255; // correct G
-  rgbw[2] = ((uint16_t) correctionRGB[2] * B(rgb)) /255; // correct B
+  rgbw[0] = ((uint16_t) correction[0] * R(rgb)) /255; // correct R
+  rgbw[1] = ((uint16_t) correction[1] * G(rgb)) /255; // correct G
+  rgbw[2] = ((uint16_t) correction[2] * B(rgb)) /255; // correct B
   rgbw[3] =                                W(rgb);
   return RGBW32(rgbw[0],rgbw[1],rgbw[2],rgbw[3]);
 }
@@ -19,14 +19,35 @@
   #endif
 #endif
 
+// parallel I2S output (opt-in, needs NeoPixelBus 2.7+): the first digital busses share one DMA buffer
+// and are clocked out simultaneously, 8 on ESP32 (I2S1), 16 on ESP32-S2 (I2S0) and ESP32-S3 (LCD peripheral)
+#if defined(WLED_USE_PARALLEL_I2S) && (defined(ESP8266) || defined(CONFIG_IDF_TARGET_ESP32C3))
+  #undef WLED_USE_PARALLEL_I2S
+#endif
+#ifdef WLED_USE_PARALLEL_I2S
+  #if defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32S3)
+    #define WLED_PARALLEL_I2S_CHANNELS 16
+  #else
+    #define WLED_PARALLEL_I2S_CHANNELS 8
+  #endif
+#endif
+
 #ifndef WLED_MAX_BUSSES
   #ifdef ESP8266
     #define WLED_MAX_BUSSES 3
   #else
     #ifdef CONFIG_IDF_TARGET_ESP32S2
-      #define WLED_MAX_BUSSES 5
+      #ifdef WLED_USE_PARALLEL_I2S
+        #define WLED_MAX_BUSSES 20 // 16 parallel + 4 RMT
+      #else
+        #define WLED_MAX_BUSSES 5
+      #endif
     #else
-      #define WLED_MAX_BUSSES 10
+      #ifdef WLED_USE_PARALLEL_I2S
+        #define WLED_MAX_BUSSES (WLED_PARALLEL_I2S_CHANNELS + 8) // parallel + 8 RMT
+      #else
+        #define WLED_MAX_BUSSES 10
+      #endif
     #endif
   #endif
 #endif
@@ -39,6 +60,30 @@
   #endif
 #endif
 
+//number of state requests from network callbacks buffered until the next frame boundary
+#ifndef WLED_STATE_QUEUE_SIZE
+  #ifdef ESP8266
+    #define WLED_STATE_QUEUE_SIZE 4
+  #else
+    #define WLED_STATE_QUEUE_SIZE 8
+  #endif
+#endif
+
+//user palettes: /palette0.bin .. /palette<n-1>.bin, gradient stops (index, R, G, B), listed after the built-in ones
+#ifndef WLED_MAX_CUSTOM_PALETTES
+  #ifdef ESP8266
+    #define WLED_MAX_CUSTOM_PALETTES 10
+  #else
+    #define WLED_MAX_CUSTOM_PALETTES 20
+  #endif
+#endif
+
+//preset banks: bank 0 is /presets.json, bank n is /presets<n>.json
+#ifndef WLED_PRESET_BANKS
+  #define WLED_PRESET_BANKS 8
+#endif
+#define PRESET_BANK_ACTIVE 255 //the bank selected in the state ("bank")
+
 #ifdef ESP8266
 #define WLED_MAX_COLOR_ORDER_MAPPINGS 5
 #else
@@ -77,6 +122,40 @@
 #define USERMOD_ID_MY9291                28     //Usermod "usermod_MY9291.h"
 #define USERMOD_ID_SI7021_MQTT_HA        29     //Usermod "usermod_si7021_mqtt_ha.h"
 
+//Usermod loop scheduling (Usermod::getLoopPriority())
+#define USERMOD_PRIORITY_HIGH             0     //runs whenever due, even if the loop budget is spent
+#define USERMOD_PRIORITY_NORMAL           1     //deferred to the next pass once the budget is spent
+#define USERMOD_PRIORITY_LOW              2     //only runs while less than half of the budget is spent
+
+#ifndef WLED_MAX_USERMOD_TASKS
+  #define WLED_MAX_USERMOD_TASKS          4     //usermod tasks queued or running at once
+#endif
+
+// longest loop() sleeps when nothing is due (strip static or off, no transition), it bounds the latency of polled
+// inputs (UDP, DNS, analog buttons). ESP32 wakes early on state changes from the web server and button interrupts
+#ifndef WLED_IDLE_MAX_MS
+  #define WLED_IDLE_MAX_MS 20
+#endif
+
+#ifndef WLED_USERMOD_BUDGET_US
+  #define WLED_USERMOD_BUDGET_US       4000     //usermod loop time per main loop pass
+#endif
+
+//Usermod events (Usermod::getEventMask(), onEvent())
+#define UM_EVENT_STATE                 0x01     //state changed (stateUpdated()), arg: call mode
+#define UM_EVENT_COLOR                 0x02     //color changed (colorUpdated()), arg: call mode
+#define UM_EVENT_PRESET                0x04     //preset applied, arg: preset ID
+#define UM_EVENT_CONNECTED             0x08     //network connected, arg: 0
+#define UM_EVENT_DISCONNECTED          0x10     //network lost, arg: 0
+#define UM_EVENT_MQTT_CONNECTED        0x20     //arg: session present
+#define UM_EVENT_MQTT_DISCONNECTED     0x40     //arg: AsyncMqttClientDisconnectReason
+
+//Overlay layer (overlay.cpp), usermods own their runs by their ID
+#define OVERLAY_OWNER_CLOCK               0     //built-in analog clock/countdown
+#ifndef WLED_MAX_OVERLAY_RUNS
+  #define WLED_MAX_OVERLAY_RUNS          48
+#endif
+
 //Access point behavior
 #define AP_BEHAVIOR_BOOT_NO_CONN          0     //Open AP when no connection after boot
 #define AP_BEHAVIOR_NO_CONN               1     //Open when no connection (either after boot or if connection is lost)
@@ -115,6 +194,10 @@
 #define REALTIME_MODE_ARTNET      6
 #define REALTIME_MODE_TPM2NET     7
 #define REALTIME_MODE_DDP         8
+#define REALTIME_MODE_DMX         9
+#define REALTIME_MODE_COUNT      10
+
+#define REALTIME_PRIORITY_DEFAULT 100          //E1.31 default, higher wins (0-200)
 
 //realtime override modes
 #define REALTIME_OVERRIDE_NONE    0
@@ -224,7 +307,15 @@
 #define SEG_OPTION_FREEZE         5            //Segment contents will not be refreshed
 #define SEG_OPTION_TRANSITIONAL   7
 
-//Segment differs return byte
+//Segment::blendMode, how a segment is composed onto the ones in lower layers (with segment buffers)
+#define SEG_BLEND_NORMAL          0            //replaces
+#define SEG_BLEND_ADD             1
+#define SEG_BLEND_MULTIPLY        2
+#define SEG_BLEND_SCREEN          3
+#define SEG_BLEND_MAX             4            //brighter channel
+#define SEG_BLEND_COUNT           5
+
+//Segment::changed bits, what the segment setters changed
 #define SEG_DIFFERS_BRI        0x01
 #define SEG_DIFFERS_OPT        0x02
 #define SEG_DIFFERS_COL        0x04
@@ -239,6 +330,8 @@
 // WLED Error modes
 #define ERR_NONE         0  // All good :)
 #define ERR_EEP_COMMIT   2  // Could not commit to EEPROM (wrong flash layout?)
+#define ERR_NOBUF        3  // JSON buffer or heap not available in time, the request can be retried
+#define ERR_PARAM        4  // Malformed bulk API parameter
 #define ERR_JSON         9  // JSON parsing failed (input too large?)
 #define ERR_FS_BEGIN    10  // Could not init filesystem (no partition?)
 #define ERR_FS_QUOTA    11  // The FS is full or the maximum file size is reached
@@ -267,6 +360,22 @@
 #endif
 #endif
 
+//index of a strip pixel. 16 bit caps a controller at 65535 LEDs, WLED_PIXEL_INDEX_32 (ESP32 only) lifts that,
+//e.g. for a master feeding many network busses. Pixels within a segment or bus stay 16 bit
+#if defined(WLED_PIXEL_INDEX_32) && defined(ESP8266)
+  #undef WLED_PIXEL_INDEX_32
+#endif
+#ifdef WLED_PIXEL_INDEX_32
+  typedef uint32_t pixidx_t;
+  #define PIXIDX_NONE UINT32_MAX
+#else
+  typedef uint16_t pixidx_t;
+  #define PIXIDX_NONE UINT16_MAX
+  #if MAX_LEDS > 65535
+    #error "MAX_LEDS above 65535 requires WLED_PIXEL_INDEX_32"
+  #endif
+#endif
+
 #ifndef MAX_LED_MEMORY
 #ifdef ESP8266
 #define MAX_LED_MEMORY 4000
@@ -286,6 +395,7 @@
 #define SETTINGS_STACK_BUF_SIZE 3096 
 #endif
 
+// multicast groups joined at most, unicast receives all universes the LED count needs
 #ifdef WLED_USE_ETHERNET
   #define E131_MAX_UNIVERSE_COUNT 20
 #else
@@ -296,6 +406,39 @@
   #endif
 #endif
 
+// while streaming realtime data the main loop only polls the realtime sources, everything else runs this often
+#ifndef WLED_RT_HOUSEKEEPING_MS
+  #define WLED_RT_HOUSEKEEPING_MS 20
+#endif
+
+// realtime mapping regions (stream range onto LED range or segment)
+#ifndef WLED_MAX_REALTIME_REGIONS
+  #define WLED_MAX_REALTIME_REGIONS 8
+#endif
+
+// destinations of the E1.31 / Art-Net / DDP repeater
+#ifndef WLED_MAX_REPEAT_TARGETS
+  #define WLED_MAX_REPEAT_TARGETS 4
+#endif
+
+// boards with native USB (ESP32-S2/S3/C3 built with ARDUINO_USB_CDC_ON_BOOT): Serial is the USB CDC port,
+// which has no RX/TX pins and no baud rate, data arrives as fast as the host sends it
+#if defined(ARDUINO_USB_CDC_ON_BOOT) && ARDUINO_USB_CDC_ON_BOOT
+  #define WLED_SERIAL_USB
+#endif
+
+// serial receive buffer, one Adalight/TPM2 frame of ~300 LEDs so pixel data is not lost while show() runs
+// (over USB ~1400 LEDs, a 60 FPS ambilight of 1000+ LEDs then fits one cable)
+#ifndef WLED_SERIAL_RX_BUFFER
+  #if defined(WLED_SERIAL_USB)
+    #define WLED_SERIAL_RX_BUFFER 4096
+  #elif defined(ESP8266)
+    #define WLED_SERIAL_RX_BUFFER 1024
+  #else
+    #define WLED_SERIAL_RX_BUFFER 2048
+  #endif
+#endif
+
 #ifndef ABL_MILLIAMPS_DEFAULT
   #define ABL_MILLIAMPS_DEFAULT 850  // auto lower brightness to stay close to milliampere limit
 #else
@@ -304,6 +447,24 @@
   #endif
 #endif
 
+#ifndef WLED_MAX_PSU
+  #define WLED_MAX_PSU 4  // separate LED power supplies with a current limit of their own, besides the main one
+#endif
+
+// track power usage of digital busses as pixels are written (2 bytes per LED) instead of reading back all pixels on each show()
+#if !defined(ESP8266) && !defined(WLED_DISABLE_INCREMENTAL_ABL) && !defined(WLED_INCREMENTAL_ABL)
+  #define WLED_INCREMENTAL_ABL
+#endif
+
+// white balance correction through per-channel lookup tables (768 bytes per color temperature), rebuilt when the color temperature changes
+#if !defined(ESP8266) && !defined(WLED_DISABLE_WHITE_BALANCE_LUT) && !defined(WLED_WHITE_BALANCE_LUT)
+  #define WLED_WHITE_BALANCE_LUT
+#endif
+// number of color temperatures whose tables are kept, so segments with differing CCT don't rebuild them every frame
+#ifndef WLED_WB_LUT_ENTRIES
+  #define WLED_WB_LUT_ENTRIES 4
+#endif
+
 // PWM settings
 #ifndef WLED_PWM_FREQ
 #ifdef ESP8266
@@ -312,6 +473,15 @@
   #define WLED_PWM_FREQ  19531
 #endif
 #endif
+// PWM duty resolution. Color and brightness are combined to 16 bit before being reduced to it
+#ifndef WLED_PWM_BITS
+#ifdef ESP8266
+  #define WLED_PWM_BITS   10 //analogWriteRange() of 1023
+#else
+  #define WLED_PWM_BITS   12 //highest resolution of the 80MHz LEDC clock at 19.5kHz
+#endif
+#endif
+#define WLED_PWM_MAX_DUTY ((1UL << WLED_PWM_BITS) - 1)
 
 #define TOUCH_THRESHOLD 32 // limit to recognize a touch, higher value means more sensitive
 
@@ -322,17 +492,57 @@
   #define JSON_BUFFER_SIZE 20480
 #endif
 
+// additional pre-allocated JSON documents for serializing responses (not counting the global doc)
+#ifndef WLED_JSON_POOL_SIZE
+  #ifdef ESP8266
+    #define WLED_JSON_POOL_SIZE 0
+  #elif defined(WLED_USE_PSRAM)
+    #define WLED_JSON_POOL_SIZE 3
+  #else
+    #define WLED_JSON_POOL_SIZE 1
+  #endif
+#endif
+#define WLED_JSON_LOCK_MODULES 20 // highest JSON buffer lock module ID + 1
+
 #ifdef WLED_USE_DYNAMIC_JSON
   #define MIN_HEAP_SIZE JSON_BUFFER_SIZE+512
 #else
   #define MIN_HEAP_SIZE 4096
 #endif
 
-// Maximum size of node map (list of other WLED instances)
-#ifdef ESP8266
-  #define WLED_MAX_NODES 24
-#else
-  #define WLED_MAX_NODES 150
+//pixel streaming between nodes, a master renders the LEDs of its followers and sends them over DDP
+#define STREAM_ROLE_NONE          0
+#define STREAM_ROLE_MASTER        1
+#define STREAM_ROLE_FOLLOWER      2
+#define STREAM_FOLLOWER_MAX_AGE   2  //node list refreshes (30 s) without an announcement until a follower is dropped
+#define NODE_AGE_INTERVAL     29000  //min. ms between node list refreshes, run every 30 s by the housekeeping
+
+//sockets of the notifier, Hyperion and second notifier port, see beginUdpSocket()
+#define UDP_SOCKET_NOTIFIER       0
+#define UDP_SOCKET_RGB            1
+#define UDP_SOCKET_NOTIFIER2      2
+//packets received by the UDP receive task (WLED_ENABLE_UDP_RX_TASK) that can wait for the loop, 1.5kB each
+#ifndef WLED_UDP_RX_SLOTS
+  #define WLED_UDP_RX_SLOTS       6
+#endif
+
+//metrics export over UDP (WLED_ENABLE_METRICS)
+#define METRICS_OFF               0
+#define METRICS_STATSD            1  //one gauge per line, wled.<mDNS name>.<metric>:<value>|g
+#define METRICS_INFLUX            2  //Influx line protocol, wled,host=<mDNS name> <metric>=<value>i,...
+
+//audio sync over multicast UDP (WLED_ENABLE_AUDIO)
+#define AUDIO_SYNC_OFF            0
+#define AUDIO_SYNC_SEND           1  //sends the snapshots of the local microphone
+#define AUDIO_SYNC_RECEIVE        2  //uses the snapshots of a sender instead of the microphone
+
+// Maximum size of node list (other WLED instances), a third more slots are allocated with the first node
+#ifndef WLED_MAX_NODES
+  #ifdef ESP8266
+    #define WLED_MAX_NODES 24
+  #else
+    #define WLED_MAX_NODES 150
+  #endif
 #endif
 
 //this is merely a default now and can be changed at runtime
@@ -357,5 +567,11 @@
 #endif
 
 #define INTERFACE_UPDATE_COOLDOWN 2000 //time in ms to wait between websockets, alexa, and MQTT updates
+#ifndef MQTT_PUBLISH_INTERVAL
+  #define MQTT_PUBLISH_INTERVAL 500    //changes within this time are published together
+#endif
+#ifndef MQTT_PUBLISH_BUFFER
+  #define MQTT_PUBLISH_BUFFER 1024     //state payload (/v XML or /state JSON), allocated with the first publish
+#endif
 
 #endif
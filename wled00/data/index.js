@@ -680,6 +680,7 @@ function populateEffects(effects)
 	});
 
 	for (let i = 0; i < effects.length; i++) {
+		if (effects[i].name == "RSVD") continue; //not in this build
 		html += generateListItemHtml(
 			'fx',
 			effects[i].id,
@@ -713,6 +714,7 @@ function populatePalettes(palettes)
 	var html = `<div class="searchbar"><input type="text" class="search" placeholder="Search" oninput="search(this)" />
 <i class="icons search-icon">&#xe0a1;</i><i class="icons search-cancel-icon" onclick="cancelSearch(this)">&#xe38f;</i></div>`;
 	for (let i = 0; i < palettes.length; i++) {
+		if (palettes[i].name == "RSVD") continue; //not in this build
 		html += generateListItemHtml(
 			'palette',
 			palettes[i].id,
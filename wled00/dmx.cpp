@@ -12,60 +12,25 @@
 
 #ifdef WLED_ENABLE_DMX
 
-void handleDMX()
+// output happens in BusManager::show() through BusDMX, which encodes the fixtures from the pixel data
+bool dmxSendUniverse(const uint8_t* data, uint16_t len)
 {
-  // don't act, when in DMX Proxy mode
-  if (e131ProxyUniverse != 0) return;
-
-  uint8_t brightness = strip.getBrightness();
-
-  bool calc_brightness = true;
-
-   // check if no shutter channel is set
-   for (byte i = 0; i < DMXChannels; i++)
-   {
-     if (DMXFixtureMap[i] == 5) calc_brightness = false;
-   }
-
-  uint16_t len = strip.getLengthTotal();
-  for (int i = DMXStartLED; i < len; i++) {        // uses the amount of LEDs as fixture count
-
-    uint32_t in = strip.getPixelColor(i);     // get the colors for the individual fixtures as suggested by Aircoookie in issue #462
-    byte w = W(in);
-    byte r = R(in);
-    byte g = G(in);
-    byte b = B(in);
-
-    int DMXFixtureStart = DMXStart + (DMXGap * (i - DMXStartLED));
-    for (int j = 0; j < DMXChannels; j++) {
-      int DMXAddr = DMXFixtureStart + j;
-      switch (DMXFixtureMap[j]) {
-        case 0:        // Set this channel to 0. Good way to tell strobe- and fade-functions to fuck right off.
-          dmx.write(DMXAddr, 0);
-          break;
-        case 1:        // Red
-          dmx.write(DMXAddr, calc_brightness ? (r * brightness) / 255 : r);
-          break;
-        case 2:        // Green
-          dmx.write(DMXAddr, calc_brightness ? (g * brightness) / 255 : g);
-          break;
-        case 3:        // Blue
-          dmx.write(DMXAddr, calc_brightness ? (b * brightness) / 255 : b);
-          break;
-        case 4:        // White
-          dmx.write(DMXAddr, calc_brightness ? (w * brightness) / 255 : w);
-          break;
-        case 5:        // Shutter channel. Controls the brightness.
-          dmx.write(DMXAddr, brightness);
-          break;
-        case 6:        // Sets this channel to 255. Like 0, but more wholesome.
-          dmx.write(DMXAddr, 255);
-          break;
-      }
-    }
-  }
+  for (uint16_t i = 0; i < len; i++) dmx.write(i + 1, data[i]);
+ #ifdef ESP8266
+  dmx.update();        // blocking, the frame is on the wire when it returns
+  return true;
+ #else
+  return dmx.update(); // false while the previous frame is still being sent
+ #endif
+}
 
-  dmx.update();        // update the DMX bus
+// (re)builds the channel map of the DMX output from the DMX settings
+void updateDMXMap()
+{
+  BusDMX* out = busses.getDMX();
+  out->setMap(DMXStartLED, DMXStart, DMXGap, DMXChannels, DMXFixtureMap);
+  out->setEnabled(e131ProxyUniverse == 0); // don't act, when in DMX Proxy mode
+  out->setBrightness(strip.getBrightness());
 }
 
 void initDMX() {
@@ -73,10 +38,11 @@ void initDMX() {
   dmx.init(512);        // initialize with bus length
  #else
   dmx.initWrite(512);  // initialize with bus length
- #endif  
+ #endif
+  updateDMXMap();
 }
 
 #else
-void handleDMX() {}
+void updateDMXMap() {}
 void initDMX() {}
 #endif
@@ -0,0 +1,100 @@
+#include "wled.h"
+
+/*
+ * Wired DMX512 input via MAX485 (ESP32 only).
+ * Frames are received by the IDF UART driver, which detects the break in hardware and reports it as an event,
+ * so a frame is complete when the break that follows it arrives. It is then handed to the E1.31 DMX mode handling
+ * (handleDMXInputFrame() in e131.cpp) as the first universe.
+ * Only frames with the null start code carry levels, RDM (0xCC) and other alternate start code packets are ignored.
+ */
+
+#if defined(WLED_ENABLE_DMX_INPUT) && defined(ARDUINO_ARCH_ESP32)
+#include "driver/uart.h"
+
+#ifndef WLED_DMX_INPUT_UART
+  #define WLED_DMX_INPUT_UART UART_NUM_1   // UART2 is used by DMX output
+#endif
+#ifndef WLED_DMX_INPUT_PIN
+  #define WLED_DMX_INPUT_PIN 16            // RO of the MAX485
+#endif
+#ifndef WLED_DMX_INPUT_ENABLE_PIN
+  #define WLED_DMX_INPUT_ENABLE_PIN -1     // DE/RE of the MAX485, held low for receiving (-1: wired to GND)
+#endif
+
+#define DMX_INPUT_FRAME_SIZE 513           // start code + 512 channels
+
+static QueueHandle_t dmxInQueue = nullptr;
+static uint8_t  dmxInFrame[DMX_INPUT_FRAME_SIZE + 1]; // + the null byte of the closing break
+static uint16_t dmxInLen = 0;
+static bool     dmxInSynced = false;       // a break was seen, the bytes since belong to one frame
+
+static void dmxInputTask(void*)
+{
+  uart_event_t ev;
+  for (;;) {
+    if (!xQueueReceive(dmxInQueue, &ev, portMAX_DELAY)) continue;
+    switch (ev.type) {
+      case UART_DATA:
+        if (!dmxInSynced || ev.size > sizeof(dmxInFrame) - dmxInLen) { // no break yet or a frame longer than DMX allows
+          uart_flush_input(WLED_DMX_INPUT_UART);
+          dmxInSynced = false;
+          break;
+        }
+        dmxInLen += uart_read_bytes(WLED_DMX_INPUT_UART, dmxInFrame + dmxInLen, ev.size, 0);
+        break;
+      case UART_BREAK: {
+        // the rest of the frame was moved to the ring buffer by the RX timeout before the break completed,
+        // the following flush drops the break's null byte before the start code of the next frame arrives (>= 96us)
+        size_t n = 0;
+        uart_get_buffered_data_len(WLED_DMX_INPUT_UART, &n);
+        if (dmxInSynced && n && n <= sizeof(dmxInFrame) - dmxInLen) dmxInLen += uart_read_bytes(WLED_DMX_INPUT_UART, dmxInFrame + dmxInLen, n, 0);
+        uart_flush_input(WLED_DMX_INPUT_UART);
+        uint16_t len = (dmxInLen > DMX_INPUT_FRAME_SIZE) ? DMX_INPUT_FRAME_SIZE : dmxInLen; // beyond channel 512 only the break
+        if (dmxInSynced && len > 1 && dmxInFrame[0] == 0) handleDMXInputFrame(dmxInFrame, len - 1);
+        dmxInLen = 0;
+        dmxInSynced = true;
+        break;
+      }
+      case UART_FIFO_OVF:
+      case UART_BUFFER_FULL:
+        uart_flush_input(WLED_DMX_INPUT_UART);
+        xQueueReset(dmxInQueue);
+        dmxInSynced = false;
+        break;
+      default: // framing errors accompany every break
+        break;
+    }
+  }
+}
+
+void initDMXInput()
+{
+  if (dmxInQueue) return;
+  if (!pinManager.allocatePin(WLED_DMX_INPUT_PIN, false, PinOwner::DMX)) {
+    DEBUG_PRINTLN(F("DMX input pin unavailable."));
+    return;
+  }
+  if (WLED_DMX_INPUT_ENABLE_PIN >= 0 && pinManager.allocatePin(WLED_DMX_INPUT_ENABLE_PIN, true, PinOwner::DMX)) {
+    pinMode(WLED_DMX_INPUT_ENABLE_PIN, OUTPUT);
+    digitalWrite(WLED_DMX_INPUT_ENABLE_PIN, LOW);
+  }
+
+  uart_config_t config = {};
+  config.baud_rate = 250000;
+  config.data_bits = UART_DATA_8_BITS;
+  config.parity    = UART_PARITY_DISABLE;
+  config.stop_bits = UART_STOP_BITS_2;
+  config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  uart_param_config(WLED_DMX_INPUT_UART, &config);
+  uart_set_pin(WLED_DMX_INPUT_UART, UART_PIN_NO_CHANGE, WLED_DMX_INPUT_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+  if (uart_driver_install(WLED_DMX_INPUT_UART, 1024, 0, 20, &dmxInQueue, 0) != ESP_OK) {
+    dmxInQueue = nullptr;
+    return;
+  }
+  uart_set_rx_timeout(WLED_DMX_INPUT_UART, 1); // hand bytes over one character time after they stop
+  xTaskCreatePinnedToCore(dmxInputTask, "dmxIn", 3072, nullptr, configMAX_PRIORITIES - 4, nullptr, 0);
+}
+
+#else
+void initDMXInput() {}
+#endif
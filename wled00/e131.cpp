@@ -4,53 +4,365 @@
 #define MAX_4_CH_LEDS_PER_UNIVERSE 128
 #define MAX_CHANNELS_PER_UNIVERSE 512
 
+#ifndef E131_FRAME_TIMEOUT
+  #define E131_FRAME_TIMEOUT 50     // ms an incomplete frame is held back before it is shown anyway
+#endif
+#define ARTNET_SYNC_TIMEOUT 4000    // Art-Net sources are synchronous for 4s after an ArtSync
+
 /*
  * E1.31 handler
  */
 
+#ifndef DDP_MAX_SCHEDULE_MS
+  #define DDP_MAX_SCHEDULE_MS 1000  // timecodes further ahead are treated as unsynchronized clocks, shown at once
+#endif
+
+static byte ddpLastSequenceNumber = 0;  // of the last push, 0: none
+static byte ddpNewestSequenceNumber = 0; // of the newest packet
+static unsigned long ddpPushAt = 0;     // millis() a frame with timecode is shown at
+static bool ddpPushPending = false;
+static IPAddress ddpReplyIP;
+static uint8_t ddpReplyId = 0;          // destination ID of a pending query, 0 if none
+static byte ddpReplySeq = 0;
+
+//ms until the time given by a DDP timecode (the middle 32 bits of NTP time, in 1/65536 s)
+static int32_t ddpTimeUntil(uint32_t timecode) {
+  if (toki.getTimeSource() < TOKI_TS_UDP_NTP) return 0; // clock not synced closely enough, show at once
+  Toki::Time t = toki.getTime();
+  uint32_t now = ((t.sec + 2208988800UL) << 16) | (((uint32_t)t.ms << 16) / 1000); // NTP epoch is 1900
+  return ((int64_t)(int32_t)(timecode - now) * 1000) >> 16;
+}
+
 //DDP protocol support, called by handleE131Packet
-//handles RGB data only
-void handleDDPPacket(e131_packet_t* p) {
-  int lastPushSeq = e131LastSequenceNumber[0];
-  
-  //reject late packets belonging to previous frame (assuming 4 packets max. before push)
-  if (e131SkipOutOfSequence && lastPushSeq) {
-    int sn = p->sequenceNum & 0xF;
-    if (sn) {
-      if (lastPushSeq > 5) {
-        if (sn > (lastPushSeq -5) && sn < lastPushSeq) return;
-      } else {
-        if (sn > (10 + lastPushSeq) || sn < lastPushSeq) return;
-      }
-    }
+//handles RGB and RGBW data, pushes at the timecode if one is given and answers status/config queries
+void handleDDPPacket(e131_packet_t* p, IPAddress clientIP) {
+  if (p->flags & DDP_QUERY_FLAG) { // the reply is sent from the main loop
+    ddpReplyIP = clientIP;
+    ddpReplySeq = p->sequenceNum;
+    ddpReplyId = p->destination;
+    return;
+  }
+  if (p->flags & DDP_REPLY_FLAG) return;
+  if (p->destination >= DDP_ID_CONTROL && p->destination < DDP_ID_ALL) return; // JSON writes are not supported
+  if (!realtimeAccept(REALTIME_MODE_DDP, clientIP)) return;
+
+  //reject late packets of frames already pushed. Sequence numbers (4 bit, 0: unused) are compared modulo 16 by their
+  //age behind the newest packet, up to 7 back: a packet not newer than the last push belongs to a previous frame,
+  //packets of the current frame may arrive in any order
+  byte sn = p->sequenceNum & 0xF;
+  if (sn) {
+    uint8_t age = (ddpNewestSequenceNumber - sn) & 0xF;
+    if (!ddpNewestSequenceNumber || age >= 8) { ddpNewestSequenceNumber = sn; age = 0; }
+    uint8_t pushAge = (ddpNewestSequenceNumber - ddpLastSequenceNumber) & 0xF;
+    if (e131SkipOutOfSequence && ddpLastSequenceNumber && pushAge < 8 && age >= pushAge) { rtStats.seq++; return; }
   }
 
-  uint32_t start = htonl(p->channelOffset) /3;
-  start += DMXAddress /3;
-  uint16_t stop = start + htons(p->dataLen) /3;
+  uint8_t ddpChannelsPerLed = (((p->dataType >> 3) & 0x07) == DDP_TYPE_RGBW) ? 4 : 3;
+  uint32_t start = htonl(p->channelOffset) / ddpChannelsPerLed;
+  start += DMXAddress / ddpChannelsPerLed;
+  uint16_t leds = htons(p->dataLen) / ddpChannelsPerLed;
   uint8_t* data = p->data;
-  uint16_t c = 0;
-  if (p->flags & DDP_TIMECODE_FLAG) c = 4; //packet has timecode flag, we do not support it, but data starts 4 bytes later
+  uint32_t timecode = 0;
+  if (p->flags & DDP_TIMECODE_FLAG) { // timecode precedes the data, unaligned
+    timecode = ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+    data += 4;
+  }
 
+  realtimeIP = clientIP;
   realtimeLock(realtimeTimeoutMs, REALTIME_MODE_DDP);
   
-  if (!realtimeOverride) {
-    for (uint16_t i = start; i < stop; i++) {
-      setRealtimePixel(i, data[c], data[c+1], data[c+2], 0);
-      c+=3;
-    }
-  }
+  if (!realtimeOverride && leds && start < UINT16_MAX) setRealtimePixels(start, leds, data, ddpChannelsPerLed);
 
   bool push = p->flags & DDP_PUSH_FLAG;
   if (push) {
+    if (sn) ddpLastSequenceNumber = sn;
+    int32_t wait = timecode ? ddpTimeUntil(timecode) : 0;
+    if (queueRealtimeFrame()) {
+      ddpPushPending = false; // paced by the jitter buffer instead
+    } else if (wait > 0 && wait < DDP_MAX_SCHEDULE_MS) {
+      ddpPushAt = millis() + wait;
+      ddpPushPending = true;
+    } else {
+      ddpPushPending = false;
+      e131NewData = true;
+    }
+  }
+}
+
+//copies src as the content of a JSON string, control characters become spaces
+static void jsonEscape(char* dest, size_t len, const char* src) {
+  size_t n = 0;
+  for (; *src && n + 2 < len; src++) {
+    if (*src == '"' || *src == '\\') dest[n++] = '\\';
+    dest[n++] = (uint8_t)*src < 0x20 ? ' ' : *src;
+  }
+  dest[n] = 0;
+}
+
+static void sendDDPReply() {
+  uint8_t id = ddpReplyId;
+  ddpReplyId = 0;
+  if (!udpConnected) return;
+  char json[224];
+  int len;
+  if (id == DDP_ID_STATUS) {
+    char mod[2 * sizeof(serverDescription)];
+    jsonEscape(mod, sizeof(mod), serverDescription);
+    len = snprintf_P(json, sizeof(json), PSTR("{\"status\":{\"man\":\"WLED\",\"mod\":\"%s\",\"ver\":\"%s\",\"mac\":\"%s\"}}"),
+                     mod, versionString, escapedMac.c_str());
+  } else if (id == DDP_ID_CONFIG) {
+    IPAddress ip = Network.localIP(), nm = Network.subnetMask(), gw = Network.gatewayIP();
+    len = snprintf_P(json, sizeof(json), PSTR("{\"config\":{\"ip\":\"%u.%u.%u.%u\",\"nm\":\"%u.%u.%u.%u\",\"gw\":\"%u.%u.%u.%u\",\"ports\":[{\"port\":0,\"ts\":0,\"l\":%u,\"ss\":0}]}}"),
+                     ip[0], ip[1], ip[2], ip[3], nm[0], nm[1], nm[2], nm[3], gw[0], gw[1], gw[2], gw[3], getRealtimeLedCount());
+  } else return; // control queries are not supported
+  if (len <= 0 || len >= (int)sizeof(json)) return;
+  uint8_t header[10] = {DDP_FLAGS_VER1 | DDP_REPLY_FLAG | DDP_PUSH_FLAG, ddpReplySeq, 0, id, 0, 0, 0, 0, (uint8_t)(len >> 8), (uint8_t)len};
+  notifierUdp.beginPacket(ddpReplyIP, DDP_DEFAULT_PORT);
+  notifierUdp.write(header, sizeof(header));
+  notifierUdp.write((uint8_t*)json, len);
+  notifierUdp.endPacket();
+}
+
+/*
+ * Universe table, one entry per universe starting at e131Universe. Sized from the LED count and DMX mode
+ * by initE131Universes(), so the LED offsets of a packet are looked up instead of recomputed.
+ */
+struct E131Universe {
+  uint16_t firstLed; // strip index of the first LED
+  uint16_t channel;  // DMX channel (1-based) of the first LED
+  uint8_t  lastSeq;  // to detect packet loss
+  bool     arrived;  // received for the frame being assembled
+  uint16_t packets;  // received in the current second
+  uint16_t rate;     // packets per second
+};
+static E131Universe* e131Universes = nullptr;
+
+/*
+ * Art-Net discovery: a controller broadcasts ArtPoll, each node answers with an ArtPollReply per 4 universes
+ * (ports) it consumes, unicast to the controller. Controllers then unicast each universe to the nodes that
+ * listed it instead of broadcasting all of them to every node. Replies are sent from the main loop.
+ */
+#define ARTNET_POLL_REPLY_LEN 239
+#define ARTNET_PORTS_PER_REPLY 4
+
+static IPAddress artPollIP;
+static bool artPollPending = false;
+static uint16_t artPollReplies = 0; // NodeReport counter
+
+static void handleArtPoll(e131_packet_t* p, IPAddress clientIP) {
+  if (DMXMode == DMX_MODE_DISABLED || !e131UniverseCount) return;
+  if (p->poll_flags & ARTNET_POLL_TARGETED) { // only answer if one of our universes is in the range
+    uint16_t top = htons(p->poll_target_top), bottom = htons(p->poll_target_bottom);
+    if (e131Universe > top || e131Universe + e131UniverseCount - 1 < bottom) return;
+  }
+  artPollIP = clientIP;
+  artPollPending = true;
+}
+
+static void sendArtPollReplies() {
+  artPollPending = false;
+  if (!udpConnected) return;
+  uint8_t r[ARTNET_POLL_REPLY_LEN];
+  IPAddress ip = Network.localIP();
+  uint8_t mac[6];
+  for (uint8_t i = 0; i < 6; i++) mac[i] = strtoul(escapedMac.substring(i*2, i*2 +2).c_str(), nullptr, 16);
+  artPollReplies++;
+
+  uint32_t last = (uint32_t)e131Universe + e131UniverseCount - 1;
+  uint8_t bindIndex = 1;
+  for (uint32_t u = e131Universe; u <= last; bindIndex++) {
+    // the ports of a reply share Net and SubNet (the upper 11 bits of the universe)
+    uint8_t ports = 0;
+    while (ports < ARTNET_PORTS_PER_REPLY && u + ports <= last && ((u + ports) >> 4) == (u >> 4)) ports++;
+
+    memset(r, 0, sizeof(r));
+    memcpy_P(r, PSTR("Art-Net"), 8);
+    r[8]  = ARTNET_OPCODE_OPPOLLREPLY & 0xFF; // opcode and port are little endian
+    r[9]  = ARTNET_OPCODE_OPPOLLREPLY >> 8;
+    for (uint8_t i = 0; i < 4; i++) r[10 + i] = ip[i];
+    r[14] = ARTNET_DEFAULT_PORT & 0xFF;
+    r[15] = ARTNET_DEFAULT_PORT >> 8;
+    r[18] = (u >> 8) & 0x7F;                  // NetSwitch
+    r[19] = (u >> 4) & 0x0F;                  // SubSwitch
+    r[20] = 0xFF; r[21] = 0xFF;               // OEM unknown
+    r[23] = 0xD0;                             // indicators normal, universes set from the web UI
+    strlcpy((char*)r + 26, serverDescription, 18);
+    snprintf_P((char*)r + 44, 64, PSTR("%s (WLED %s)"), serverDescription, versionString);
+    snprintf_P((char*)r + 108, 64, PSTR("#0001 [%04u] %u LEDs, universes %u-%u"),
+               artPollReplies % 10000, getRealtimeLedCount(), e131Universe, (unsigned)last);
+    r[173] = ports;
+    for (uint8_t k = 0; k < ports; k++) {
+      r[174 + k] = 0x80;                      // output from Art-Net, DMX512
+      r[182 + k] = (e131Universes && e131Universes[u - e131Universe + k].rate) ? 0x80 : 0x00; // data is received
+      r[190 + k] = (u + k) & 0x0F;            // SwOut
+    }
+    memcpy(r + 201, mac, 6);
+    for (uint8_t i = 0; i < 4; i++) r[207 + i] = ip[i]; // BindIp, all replies belong to this node
+    r[211] = bindIndex;
+    r[212] = 0x08;                            // 15 bit port-addresses
+    notifierUdp.beginPacket(artPollIP, ARTNET_DEFAULT_PORT);
+    notifierUdp.write(r, sizeof(r));
+    notifierUdp.endPacket();
+    u += ports;
+  }
+}
+
+/*
+ * Frame assembly: universes are collected until the frame is complete, so it is shown once and not
+ * mixed with the next one. A frame is pushed when
+ *  - all universes covering the strip arrived, unless the source synchronizes its universes, or
+ *  - the E1.31 synchronization packet / ArtSync arrives, or
+ *  - a universe at or below one already received arrives, i.e. the next frame started, or
+ *  - E131_FRAME_TIMEOUT passed after packet loss
+ */
+static uint8_t  e131Arrived = 0;         // universes received for the frame being assembled
+static uint8_t  e131LastIndex = 0;       // last universe received for it
+static unsigned long e131FrameStart = 0; // arrival of its first universe
+static uint16_t e131SyncAddress = 0;     // E1.31 synchronization universe of the frame, 0 if unsynchronized
+static unsigned long artSyncTime = 0;
+static bool artSynced = false;
+
+static void pushE131Frame() {
+  for (uint8_t i = 0; i < e131UniverseCount; i++) e131Universes[i].arrived = false;
+  e131Arrived = 0;
+  if (!queueRealtimeFrame()) e131NewData = true;
+}
+
+//must be called whenever the LED count, DMX mode, DMX address or realtime offset change
+void initE131Universes() {
+  bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
+  bool multi = (DMXMode == DMX_MODE_MULTIPLE_RGB || DMXMode == DMX_MODE_MULTIPLE_DRGB || is4Chan);
+  const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
+  const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
+  // First DMX address is dimmer in DMX_MODE_MULTIPLE_DRGB mode.
+  uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
+  uint16_t ledsInFirstUniverse = ((MAX_CHANNELS_PER_UNIVERSE - DMXAddress + 1) - dimmerOffset) / dmxChannelsPerLed;
+
+  uint16_t count = 1; // single universe modes
+  int32_t ledsNeeded = realtimeRegionCount ? getRealtimeStreamLength() : (int32_t)getRealtimeLedCount() - arlsOffset;
+  if (multi && ledsNeeded > ledsInFirstUniverse) {
+    count = 1 + (ledsNeeded - ledsInFirstUniverse + ledsPerUniverse - 1) / ledsPerUniverse;
+    if (count > 255) count = 255;
+  }
+
+  RENDER_LOCK(); // the table is used from the async UDP task
+  free(e131Universes);
+  e131Universes = (E131Universe*) calloc(count, sizeof(E131Universe));
+  e131UniverseCount = e131Universes ? count : 0;
+  for (uint8_t i = 0; i < e131UniverseCount; i++) {
+    e131Universes[i].firstLed = i ? ledsInFirstUniverse + (i - 1) * ledsPerUniverse : 0;
+    e131Universes[i].channel  = i ? 1 : DMXAddress + dimmerOffset; // all subsequent universes start at the first channel
+  }
+  e131Arrived = 0;
+  RENDER_UNLOCK();
+  DEBUG_PRINTF("E1.31 universes: %u\n", e131UniverseCount);
+  //join only the groups of universes that are rendered, sources stop sending the others once no node listens
+  if (interfacesInited) e131.setMulticastUniverses(e131Universe, MIN(e131UniverseCount, E131_MAX_UNIVERSE_COUNT));
+}
+
+static void addE131Universe(uint8_t index, uint16_t syncAddress, byte protocol) {
+  E131Universe &u = e131Universes[index];
+  if (e131Arrived && index <= e131LastIndex) pushE131Frame(); // next frame started, send what we have
+  if (!e131Arrived) e131FrameStart = millis();
+  if (!u.arrived) e131Arrived++;
+  u.arrived = true;
+  e131LastIndex = index;
+  e131SyncAddress = syncAddress;
+  if (syncAddress) return; // shown on the synchronization packet
+  if (protocol == P_ARTNET && artSynced && millis() - artSyncTime < ARTNET_SYNC_TIMEOUT) return;
+  artSynced = false;
+  if (e131Arrived == e131UniverseCount) pushE131Frame();
+}
+
+static void handleSyncPacket(e131_packet_t* p, IPAddress clientIP, byte protocol) {
+  if (clientIP != realtimeIP) return; // sync of another source
+  if (protocol == P_ARTNET_SYNC) {
+    artSynced = true;
+    artSyncTime = millis();
+  } else if (!e131SyncAddress || htons(p->sync_packet_address) != e131SyncAddress) return;
+  if (e131Arrived) pushE131Frame();
+}
+
+//called from handleNotifications(): shows frames that stay incomplete or are due at their DDP timecode,
+//and answers DDP queries and ArtPolls
+void handleE131() {
+  static unsigned long rateTime = 0;
+  if (millis() - rateTime >= 1000) {
+    rateTime = millis();
+    for (uint8_t i = 0; i < e131UniverseCount; i++) {
+      e131Universes[i].rate = e131Universes[i].packets;
+      e131Universes[i].packets = 0;
+    }
+  }
+  if (e131Arrived && millis() - e131FrameStart >= E131_FRAME_TIMEOUT) pushE131Frame();
+  if (ddpPushPending && (long)(millis() - ddpPushAt) >= 0) {
+    ddpPushPending = false;
     e131NewData = true;
-    byte sn = p->sequenceNum & 0xF;
-    if (sn) e131LastSequenceNumber[0] = sn;
   }
+  if (ddpReplyId) sendDDPReply();
+  if (artPollPending) sendArtPollReplies();
 }
 
-//E1.31 and Art-Net protocol support
+/*
+ * Repeater, called by ESPAsyncE131 from the async UDP task with the receive buffer before the packet is processed:
+ * E1.31 / Art-Net universes and DDP packets overlapping the range of a repeat target are sent on to it as they are,
+ * to the port they arrived on, without waiting for a frame to be rendered. Only the universe or DDP channel offset is
+ * patched for targets that re-address, and restored for the next one. Sync packets go to all universe targets.
+ * DDP packets are sent whole, queries are answered locally. Returns true if the packet was repeated and is not to be
+ * shown locally (loc off).
+ */
+bool repeatRealtimePacket(uint8_t* data, size_t len, byte protocol, uint16_t port, ESPAsyncE131& via)
+{
+  if (!repeatTargetCount || protocol == P_ARTNET_POLL) return false;
+  e131_packet_t* p = reinterpret_cast<e131_packet_t*>(data);
+  if (protocol == P_DDP && (len < 10 || (p->flags & (DDP_QUERY_FLAG | DDP_REPLY_FLAG)))) return false;
+
+  bool forwarded = false;
+  for (uint8_t t = 0; t < repeatTargetCount; t++) {
+    const repeat_target& r = repeatTargets[t];
+    bool ok = false;
+    if (protocol == P_DDP) {
+      if (!r.ddpLen) continue;
+      uint32_t offset = ntohl(p->channelOffset);
+      uint16_t dataLen = ntohs(p->dataLen);
+      if (dataLen && (offset + dataLen <= r.ddpStart || offset >= r.ddpStart + r.ddpLen)) continue; // push only packets go to all
+      p->channelOffset = htonl(offset + r.ddpShift);
+      ok = via.send(data, len, r.ip, port);
+      p->channelOffset = htonl(offset);
+    } else if (protocol == P_E131 || protocol == P_ARTNET) {
+      if (!r.uniCount) continue;
+      uint16_t uni = (protocol == P_E131) ? ntohs(p->universe) : p->art_universe;
+      if (uni < r.uni || uni - r.uni >= r.uniCount) continue;
+      uint16_t out = uni + r.uniShift;
+      if (protocol == P_E131) p->universe = htons(out);
+      else                    p->art_universe = out;
+      ok = via.send(data, len, r.ip, port);
+      if (protocol == P_E131) p->universe = htons(uni);
+      else                    p->art_universe = uni;
+    } else { // E1.31 synchronization or ArtSync
+      if (!r.uniCount) continue;
+      ok = via.send(data, len, r.ip, port);
+    }
+    if (ok) rtStats.fwd++;
+    forwarded |= ok;
+  }
+  return forwarded && !repeaterLocal; // packets not repeated anywhere are shown here
+}
+
+static void processE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+static bool applyDMXData(uint8_t index, uint8_t* e131_data, uint16_t dmxChannels, bool zeroBased, uint8_t mde);
+
+//called from the async UDP task, do not write pixels while a frame is rendered
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
+  RENDER_LOCK();
+  uint32_t start = micros();
+  processE131Packet(p, clientIP, protocol);
+  countRealtimePacket(start);
+  RENDER_UNLOCK();
+}
+
+//E1.31 and Art-Net protocol support
+static void processE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
 
   uint16_t uni = 0, dmxChannels = 0;
   uint8_t* e131_data = nullptr;
@@ -68,9 +380,14 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     dmxChannels = htons(p->property_value_count) -1;
     e131_data = p->property_values;
     seq = p->sequence_number;
-  } else { //DDP
-    realtimeIP = clientIP;
-    handleDDPPacket(p);
+  } else if (protocol == P_DDP) {
+    handleDDPPacket(p, clientIP);
+    return;
+  } else if (protocol == P_ARTNET_POLL) {
+    handleArtPoll(p, clientIP);
+    return;
+  } else { //E1.31 synchronization or ArtSync
+    handleSyncPacket(p, clientIP, protocol);
     return;
   }
 
@@ -84,55 +401,70 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
   #endif
 
   // only listen for universes we're handling & allocated memory
-  if (uni >= (e131Universe + E131_MAX_UNIVERSE_COUNT)) return;
+  if (uni < e131Universe || uni - e131Universe >= e131UniverseCount) return;
+
+  int16_t prio = (protocol == P_E131 && e131UsePriority) ? MIN(p->priority, 200) : -1;
+  if (!realtimeAccept(mde, clientIP, prio)) return;
 
-  uint8_t previousUniverses = uni - e131Universe;
+  uint8_t index = uni - e131Universe;
+  E131Universe &u = e131Universes[index];
+  u.packets++;
 
   if (e131SkipOutOfSequence)
-    if (seq < e131LastSequenceNumber[uni-e131Universe] && seq > 20 && e131LastSequenceNumber[uni-e131Universe] < 250){
+    if (seq < u.lastSeq && seq > 20 && u.lastSeq < 250){
       DEBUG_PRINT("skipping E1.31 frame (last seq=");
-      DEBUG_PRINT(e131LastSequenceNumber[uni-e131Universe]);
+      DEBUG_PRINT(u.lastSeq);
       DEBUG_PRINT(", current seq=");
       DEBUG_PRINT(seq);
       DEBUG_PRINT(", universe=");
       DEBUG_PRINT(uni);
       DEBUG_PRINTLN(")");
+      rtStats.seq++;
       return;
     }
-  e131LastSequenceNumber[uni-e131Universe] = seq;
+  u.lastSeq = seq;
 
   // update status info
   realtimeIP = clientIP;
+  if (!applyDMXData(index, e131_data, dmxChannels, protocol == P_ARTNET, mde)) return;
+
+  addE131Universe(index, (protocol == P_E131) ? htons(p->sync_address) : 0, protocol);
+}
+
+//applies universe index of the DMX data according to DMXMode, returns true if it belongs to the realtime frame
+//DMX data in Art-Net packets starts at index 0 (zeroBased), for E1.31 and wired DMX at index 1 after the start code
+static bool applyDMXData(uint8_t index, uint8_t* e131_data, uint16_t dmxChannels, bool zeroBased, uint8_t mde)
+{
+  E131Universe &u = e131Universes[index];
   byte wChannel = 0;
-  uint16_t totalLen = strip.getLengthTotal();
+  uint16_t totalLen = getRealtimeLedCount();
   uint16_t availDMXLen = dmxChannels - DMXAddress + 1;
   uint16_t dataOffset = DMXAddress;
 
-  // DMX data in Art-Net packet starts at index 0, for E1.31 at index 1
-  if (protocol == P_ARTNET && dataOffset > 0) {
+  if (zeroBased && dataOffset > 0) {
     dataOffset--;
   }
 
   switch (DMXMode) {
     case DMX_MODE_DISABLED:
-      return;  // nothing to do
+      return false;  // nothing to do
       break;
 
     case DMX_MODE_SINGLE_RGB: // RGB only
-      if (uni != e131Universe) return;
-      if (availDMXLen < 3) return;
+      if (index != 0) return false;
+      if (availDMXLen < 3) return false;
       realtimeLock(realtimeTimeoutMs, mde);
-      if (realtimeOverride) return;
+      if (realtimeOverride) return false;
       wChannel = (availDMXLen > 3) ? e131_data[dataOffset+3] : 0;
       for (uint16_t i = 0; i < totalLen; i++)
         setRealtimePixel(i, e131_data[dataOffset+0], e131_data[dataOffset+1], e131_data[dataOffset+2], wChannel);
       break;
 
     case DMX_MODE_SINGLE_DRGB: // Dimmer + RGB
-      if (uni != e131Universe) return;
-      if (availDMXLen < 4) return;
+      if (index != 0) return false;
+      if (availDMXLen < 4) return false;
       realtimeLock(realtimeTimeoutMs, mde);
-      if (realtimeOverride) return;
+      if (realtimeOverride) return false;
       wChannel = (availDMXLen > 4) ? e131_data[dataOffset+4] : 0;
       if (DMXOldDimmer != e131_data[dataOffset+0]) {
         DMXOldDimmer = e131_data[dataOffset+0];
@@ -144,11 +476,11 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       break;
 
     case DMX_MODE_EFFECT: // Length 1: Apply Preset ID, length 11-13: apply effect config
-      if (uni != e131Universe) return;
+      if (index != 0) return false;
       if (availDMXLen < 11) {
-        if (availDMXLen > 1) return;
+        if (availDMXLen > 1) return false;
         applyPreset(e131_data[dataOffset+0], CALL_MODE_NOTIFICATION);
-        return;
+        return false;
       }
       if (DMXOldDimmer != e131_data[dataOffset+0]) {
         DMXOldDimmer = e131_data[dataOffset+0];
@@ -172,7 +504,7 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
       }
       transitionDelayTemp = 0;               // act fast
       colorUpdated(CALL_MODE_NOTIFICATION);  // don't send UDP
-      return;                                // don't activate realtime live mode
+      return false;                          // don't activate realtime live mode
       break;
 
     case DMX_MODE_MULTIPLE_DRGB:
@@ -180,48 +512,49 @@ void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol){
     case DMX_MODE_MULTIPLE_RGBW:
       {
         realtimeLock(realtimeTimeoutMs, mde);
-        bool is4Chan = (DMXMode == DMX_MODE_MULTIPLE_RGBW);
-        const uint16_t dmxChannelsPerLed = is4Chan ? 4 : 3;
-        const uint16_t ledsPerUniverse = is4Chan ? MAX_4_CH_LEDS_PER_UNIVERSE : MAX_3_CH_LEDS_PER_UNIVERSE;
-        if (realtimeOverride) return;
-        uint16_t previousLeds, dmxOffset, ledsTotal;
-        if (previousUniverses == 0) {
-          if (availDMXLen < 1) return;
-          dmxOffset = dataOffset;
-          previousLeds = 0;
-          // First DMX address is dimmer in DMX_MODE_MULTIPLE_DRGB mode.
-          if (DMXMode == DMX_MODE_MULTIPLE_DRGB) {
-            strip.setBrightness(e131_data[dmxOffset++], true);
-            ledsTotal = (availDMXLen - 1) / dmxChannelsPerLed;
-          } else {
-            ledsTotal = availDMXLen / dmxChannelsPerLed;
-          }
-        } else {
-          // All subsequent universes start at the first channel.
-          dmxOffset = (protocol == P_ARTNET) ? 0 : 1;
-          uint16_t dimmerOffset = (DMXMode == DMX_MODE_MULTIPLE_DRGB) ? 1 : 0;
-          uint16_t ledsInFirstUniverse = ((MAX_CHANNELS_PER_UNIVERSE - DMXAddress + 1) - dimmerOffset) / dmxChannelsPerLed;
-          previousLeds = ledsInFirstUniverse + (previousUniverses - 1) * ledsPerUniverse;
-          ledsTotal = previousLeds + (dmxChannels / dmxChannelsPerLed);
-        }
-        if (!is4Chan) {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], 0);
-            dmxOffset+=3;
-          }
-        } else {
-          for (uint16_t i = previousLeds; i < ledsTotal; i++) {
-            setRealtimePixel(i, e131_data[dmxOffset], e131_data[dmxOffset+1], e131_data[dmxOffset+2], e131_data[dmxOffset+3]);
-            dmxOffset+=4;
-          }
+        const uint16_t dmxChannelsPerLed = (DMXMode == DMX_MODE_MULTIPLE_RGBW) ? 4 : 3;
+        if (realtimeOverride) return false;
+        if (index == 0 && DMXMode == DMX_MODE_MULTIPLE_DRGB) {
+          if (availDMXLen < 1) return false;
+          strip.setBrightness(e131_data[dataOffset], true);
         }
+        uint16_t dmxOffset = (zeroBased && u.channel > 0) ? u.channel - 1 : u.channel;
+        uint16_t leds = (dmxChannels >= u.channel) ? (dmxChannels - u.channel + 1) / dmxChannelsPerLed : 0;
+        if (leds) setRealtimePixels(u.firstLed, leds, e131_data + dmxOffset, dmxChannelsPerLed);
         break;
       }
     default:
       DEBUG_PRINTLN(F("unknown E1.31 DMX mode"));
-      return;  // nothing to do
+      return false;  // nothing to do
       break;
   }
+  return true;
+}
+
+#ifdef WLED_ENABLE_DMX_INPUT
+//called from the DMX receiver task with a complete frame after its closing break, data[0] is the start code.
+//The wired line carries the first universe, frames are shown at once since there is nothing to assemble
+void handleDMXInputFrame(uint8_t* data, uint16_t dmxChannels)
+{
+  RENDER_LOCK();
+  if (e131Universes && realtimeAccept(REALTIME_MODE_DMX, IPAddress(0,0,0,0))) {
+    e131Universes[0].packets++;
+    realtimeIP = IPAddress(0,0,0,0);
+    if (applyDMXData(0, data, dmxChannels, false, REALTIME_MODE_DMX)) pushE131Frame();
+  }
+  RENDER_UNLOCK();
+  wakeLoop();
+}
+#endif
 
-  e131NewData = true;
+//universe statistics for the info object
+void serializeE131Info(JsonObject root)
+{
+  JsonObject e = root.createNestedObject(F("e131"));
+  e[F("uni")] = e131Universe;
+  e["mc"] = e131.getMulticastGroups(); // groups joined
+  JsonArray rate = e.createNestedArray(F("pps")); // packets per second of each universe
+  RENDER_LOCK();
+  for (uint8_t i = 0; i < e131UniverseCount; i++) rate.add(e131Universes[i].rate);
+  RENDER_UNLOCK();
 }
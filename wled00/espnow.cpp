@@ -0,0 +1,226 @@
+#include "wled.h"
+
+/*
+ * ESP-NOW transport for sync notifications (WLED_ENABLE_ESPNOW)
+ * Notifications are sent as ESP-NOW frames next to the UDP broadcast, so they reach nodes on the same
+ * channel directly instead of through the access point. Nodes announce their receive groups with a hello
+ * frame every ESPNOW_HELLO_MS, and a notification is sent by unicast (acknowledged and retried by the MAC)
+ * to the peers in one of its sync groups, or broadcast once more peers are around than can be registered.
+ * The UDP notification still follows, the state version of sync version 12 drops the copy that arrives second,
+ * as does the resync of a receiver that missed one. Notifications over 240 bytes are only sent by UDP.
+ *
+ * Frame: 0-1 "WN", 2 type (ESPNOW_...), 3 receive groups, 4-7 IPv4 of the sender, 8-9 its notifier port, 10.. payload
+ */
+#ifdef WLED_ENABLE_ESPNOW
+
+#ifdef ESP8266
+  extern "C" {
+  #include <espnow.h>
+  }
+#else
+  #include <esp_now.h>
+#endif
+
+#ifndef WLED_ESPNOW_PEERS
+  #define WLED_ESPNOW_PEERS 16      // unicast peers, ESP-NOW registers at most 20
+#endif
+#define ESPNOW_HELLO       1
+#define ESPNOW_SYNC        2
+#define ESPNOW_HEADER      10
+#define ESPNOW_MAX_FRAME   250
+#define ESPNOW_HELLO_MS    10000
+#define ESPNOW_PEER_AGE_MS 35000    // peer dropped after missing three hellos
+#define ESPNOW_QUEUE       4        // received frames waiting for the main loop
+
+struct EspNowPeer {
+  uint8_t  mac[6];
+  uint8_t  groups;
+  unsigned long seen;               // 0 if the slot is free
+};
+
+struct EspNowFrame {
+  uint8_t  mac[6];
+  uint8_t  len;
+  uint8_t  data[ESPNOW_MAX_FRAME];
+};
+
+static const uint8_t broadcastMac[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+static EspNowPeer peers[WLED_ESPNOW_PEERS];
+static EspNowFrame* rxQueue = nullptr;
+static volatile uint8_t rxHead = 0, rxTail = 0; // written by the receive callback and the main loop respectively
+static bool     espNowOn = false;
+static bool     espNowWanted = false;   // enabled and connected when last checked
+static bool     peersOverflow = false;  // more nodes than slots, notifications are broadcast
+static unsigned long lastHello = 0;
+static uint32_t txFrames = 0, rxFrames = 0, txFails = 0, rxDropped = 0;
+
+//WiFi task (ESP32) or system context (ESP8266), only copies the frame
+#ifdef ESP8266
+static void espNowReceived(uint8_t* mac, uint8_t* data, uint8_t len)
+#else
+static void espNowReceived(const uint8_t* mac, const uint8_t* data, int len)
+#endif
+{
+  if (len < ESPNOW_HEADER || len > ESPNOW_MAX_FRAME || data[0] != 'W' || data[1] != 'N') return;
+  uint8_t next = (rxHead + 1) % ESPNOW_QUEUE;
+  if (next == rxTail) { rxDropped++; return; }
+  EspNowFrame& f = rxQueue[rxHead];
+  memcpy(f.mac, mac, 6);
+  memcpy(f.data, data, len);
+  f.len = len;
+  rxHead = next;
+}
+
+static bool registerPeer(const uint8_t* mac)
+{
+  #ifdef ESP8266
+  if (esp_now_is_peer_exist((uint8_t*)mac) > 0) return true;
+  return esp_now_add_peer((uint8_t*)mac, ESP_NOW_ROLE_COMBO, 0, nullptr, 0) == 0;
+  #else
+  if (esp_now_is_peer_exist(mac)) return true;
+  esp_now_peer_info_t info = {};
+  memcpy(info.peer_addr, mac, 6);
+  info.channel = 0;                 // the channel of the station connection
+  info.ifidx = ESP_IF_WIFI_STA;
+  return esp_now_add_peer(&info) == ESP_OK;
+  #endif
+}
+
+static void unregisterPeer(const uint8_t* mac)
+{
+  #ifdef ESP8266
+  esp_now_del_peer((uint8_t*)mac);
+  #else
+  esp_now_del_peer(mac);
+  #endif
+}
+
+static void sendFrame(const uint8_t* mac, uint8_t type, const uint8_t* payload, uint8_t len)
+{
+  uint8_t frame[ESPNOW_MAX_FRAME];
+  IPAddress ip = Network.localIP();
+  frame[0] = 'W'; frame[1] = 'N';
+  frame[2] = type;
+  frame[3] = receiveGroups;
+  for (uint8_t i = 0; i < 4; i++) frame[4+i] = ip[i];
+  frame[8] = udpPort >> 8;
+  frame[9] = udpPort & 0xFF;
+  if (len) memcpy(frame + ESPNOW_HEADER, payload, len);
+  #ifdef ESP8266
+  bool ok = esp_now_send((uint8_t*)mac, frame, ESPNOW_HEADER + len) == 0;
+  #else
+  bool ok = esp_now_send(mac, frame, ESPNOW_HEADER + len) == ESP_OK;
+  #endif
+  if (ok) txFrames++;
+  else    txFails++;
+}
+
+static void updatePeer(const uint8_t* mac, uint8_t groups)
+{
+  EspNowPeer* slot = nullptr;
+  for (uint8_t i = 0; i < WLED_ESPNOW_PEERS; i++) {
+    if (peers[i].seen && memcmp(peers[i].mac, mac, 6) == 0) { slot = &peers[i]; break; }
+    if (!slot && !peers[i].seen) slot = &peers[i];
+  }
+  if (!slot) { peersOverflow = true; return; }
+  if (!slot->seen) {
+    if (!registerPeer(mac)) { peersOverflow = true; return; }
+    memcpy(slot->mac, mac, 6);
+  }
+  slot->groups = groups;
+  slot->seen = millis() | 1;
+}
+
+void espNowBegin()
+{
+  if (espNowOn) {
+    esp_now_deinit();
+    espNowOn = false;
+  }
+  memset(peers, 0, sizeof(peers));
+  peersOverflow = false;
+  espNowWanted = espNowSync && WLED_CONNECTED;
+  if (!espNowSync || Network.isEthernet() || !WLED_CONNECTED) return;
+  if (!rxQueue) rxQueue = (EspNowFrame*)malloc(ESPNOW_QUEUE * sizeof(EspNowFrame));
+  if (!rxQueue || esp_now_init() != 0) {
+    DEBUG_PRINTLN(F("ESP-NOW init failed"));
+    return;
+  }
+  #ifdef ESP8266
+  esp_now_set_self_role(ESP_NOW_ROLE_COMBO);
+  #endif
+  esp_now_register_recv_cb(espNowReceived);
+  registerPeer(broadcastMac);
+  rxHead = rxTail = 0;
+  espNowOn = true;
+  lastHello = 0;
+  DEBUG_PRINTLN(F("ESP-NOW on"));
+}
+
+//sends a notification (the UDP payload) to the peers of its sync groups
+void espNowSendSync(const uint8_t* data, uint16_t len)
+{
+  if (!espNowOn || len > ESPNOW_MAX_FRAME - ESPNOW_HEADER) return;
+  if (peersOverflow) {
+    sendFrame(broadcastMac, ESPNOW_SYNC, data, len);
+    return;
+  }
+  for (uint8_t i = 0; i < WLED_ESPNOW_PEERS; i++) {
+    if (peers[i].seen && (peers[i].groups & syncGroups)) sendFrame(peers[i].mac, ESPNOW_SYNC, data, len);
+  }
+}
+
+//takes the next notification received, hellos are handled here
+bool espNowReceive(uint8_t* buf, uint16_t& len, IPAddress& sender, uint16_t& port)
+{
+  bool wanted = espNowSync && WLED_CONNECTED;
+  if (wanted != espNowWanted) { // setting changed or connection lost
+    espNowWanted = wanted;
+    espNowBegin();
+  }
+  if (!espNowOn) return false;
+
+  unsigned long now = millis();
+  if (now - lastHello > ESPNOW_HELLO_MS || !lastHello) {
+    lastHello = now;
+    sendFrame(broadcastMac, ESPNOW_HELLO, nullptr, 0);
+    for (uint8_t i = 0; i < WLED_ESPNOW_PEERS; i++) {
+      if (peers[i].seen && now - peers[i].seen > ESPNOW_PEER_AGE_MS) {
+        unregisterPeer(peers[i].mac);
+        peers[i].seen = 0;
+      }
+    }
+  }
+
+  while (rxTail != rxHead) {
+    EspNowFrame& f = rxQueue[rxTail];
+    rxFrames++;
+    updatePeer(f.mac, f.data[3]);
+    bool sync = f.data[2] == ESPNOW_SYNC && f.len > ESPNOW_HEADER;
+    if (sync) {
+      len = f.len - ESPNOW_HEADER;
+      memcpy(buf, f.data + ESPNOW_HEADER, len);
+      sender = IPAddress(f.data[4], f.data[5], f.data[6], f.data[7]);
+      port = (f.data[8] << 8) | f.data[9];
+    }
+    rxTail = (rxTail + 1) % ESPNOW_QUEUE;
+    if (sync) return true;
+  }
+  return false;
+}
+
+void serializeEspNow(JsonObject root)
+{
+  JsonObject en = root.createNestedObject(F("espnow"));
+  en[F("on")] = espNowOn;
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < WLED_ESPNOW_PEERS; i++) if (peers[i].seen) n++;
+  en[F("peers")] = n;
+  en[F("bc")]    = peersOverflow; // notifications broadcast
+  en[F("tx")]    = txFrames;
+  en[F("fail")]  = txFails;
+  en[F("rx")]    = rxFrames;
+  en[F("drop")]  = rxDropped;
+}
+
+#endif
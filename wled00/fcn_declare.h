@@ -21,6 +21,10 @@ void handleBlynk();
 void updateBlynk();
 #endif
 
+//wled.cpp
+void wakeLoop();
+void wakeLoopFromISR();
+
 //button.cpp
 void shortPressAction(uint8_t b=0);
 void longPressAction(uint8_t b=0);
@@ -35,6 +39,11 @@ void deserializeConfigFromFS();
 bool deserializeConfigSec();
 void serializeConfig();
 void serializeConfigSec();
+void handleConfigSave();
+void setCfgSchemaFromForm(AsyncWebServerRequest *request, byte subPage);
+void getCfgSchemaJS(byte subPage);
+bool loadBootSnapshot();
+void dropBootSnapshot();
 
 template<typename DestType>
 bool getJsonValue(const JsonVariant& element, DestType& destination) {
@@ -63,8 +72,8 @@ void colorHStoRGB(uint16_t hue, byte sat, byte* rgb); //hue, sat to rgb
 void colorKtoRGB(uint16_t kelvin, byte* rgb);
 void colorCTtoRGB(uint16_t mired, byte* rgb); //white spectrum to rgb
 
-void colorXYtoRGB(float x, float y, byte* rgb); // only defined if huesync disabled TODO
-void colorRGBtoXY(byte* rgb, float* xy); // only defined if huesync disabled TODO
+void colorXYtoRGB(uint16_t x, uint16_t y, byte* rgb); // x, y in 1/10000, only defined if huesync enabled
+void colorRGBtoXY(byte* rgb, uint16_t* xy); // only defined if huesync enabled
 
 void colorFromDecOrHexString(byte* rgb, char* in);
 bool colorFromHexString(byte* rgb, const char* in);
@@ -74,12 +83,58 @@ uint16_t approximateKelvinFromRGB(uint32_t rgb);
 
 void setRandomColor(byte* rgb);
 
+//metrics.cpp
+void metricsFrame(uint32_t ms);
+void handleMetrics();
+
+//log.cpp
+void initLog();
+void handleLog();
+void serveLog(AsyncWebServerRequest* request);
+
+//trace.cpp
+void serveTrace(AsyncWebServerRequest* request);
+
 //dmx.cpp
 void initDMX();
-void handleDMX();
+void updateDMXMap();
+
+//bench.cpp
+void handleBenchmark();
+void serveBenchmark(AsyncWebServerRequest* request);
+
+//bake.cpp
+void handleBake();
+void serveBake(AsyncWebServerRequest* request);
+
+//dmx_input.cpp
+void initDMXInput();
+
+//audio.cpp
+void initAudio();
+void handleAudio();
 
 //e131.cpp
 void handleE131Packet(e131_packet_t* p, IPAddress clientIP, byte protocol);
+bool repeatRealtimePacket(uint8_t* data, size_t len, byte protocol, uint16_t port, ESPAsyncE131& via);
+void handleDMXInputFrame(uint8_t* data, uint16_t dmxChannels);
+void handleE131();
+void serializeE131Info(JsonObject root);
+void initE131Universes();
+
+//fleet.cpp
+struct NodeStruct;
+void fleetAnnounce(uint8_t* data);
+void fleetPeer(const NodeStruct* n);
+void handleFleet();
+void serveFleet(AsyncWebServerRequest* request);
+void serveFleetImage(AsyncWebServerRequest* request);
+
+//espnow.cpp
+void espNowBegin();
+void espNowSendSync(const uint8_t* data, uint16_t len);
+bool espNowReceive(uint8_t* buf, uint16_t& len, IPAddress& sender, uint16_t& port);
+void serializeEspNow(JsonObject root);
 
 //file.cpp
 bool handleFileRead(AsyncWebServerRequest*, String path);
@@ -87,8 +142,18 @@ bool writeObjectToFileUsingId(const char* file, uint16_t id, JsonDocument* conte
 bool writeObjectToFile(const char* file, const char* key, JsonDocument* content);
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest);
 bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest);
+bool applyObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* doc, byte callMode);
+void dropPresetIndex();
+void initPresetLog();
+void handlePresetLog();
 void updateFSInfo();
+void invalidateFSInfo();
+void handleFSInfo();
+void fsStatsRead(const char* file, size_t bytes, uint32_t startMicros);
+void fsStatsWrite(const char* file, size_t bytes, uint32_t startMicros);
+void serializeFSStats(JsonObject fs);
 void closeFile();
+void fsCacheDrop(const char* path);
 
 //hue.cpp
 void handleHue();
@@ -118,9 +183,11 @@ void decodeIR21(uint32_t code);
 void decodeIR6(uint32_t code);
 void decodeIR9(uint32_t code);
 void decodeIRJson(uint32_t code);
+void dropIRTable();
 
 void initIR();
 void handleIR();
+bool irWantsRmt(int8_t pin, byte type);
 
 //json.cpp
 #include "ESPAsyncWebServer.h"
@@ -130,10 +197,17 @@ void handleIR();
 
 void deserializeSegment(JsonObject elem, byte it, byte presetId = 0);
 bool deserializeState(JsonObject root, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
+bool deserializeStateStream(File& in, JsonDocument* doc, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
+bool deserializeStateStream(const uint8_t* json, size_t len, JsonDocument* doc, byte callMode = CALL_MODE_DIRECT_CHANGE, byte presetId = 0);
 void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool forPreset = false, bool segmentBounds = true);
-void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true);
+void serializeState(JsonObject root, bool forPreset = false, bool includeBri = true, bool segmentBounds = true, bool includeSegments = true);
 void serializeInfo(JsonObject root);
 void serveJson(AsyncWebServerRequest* request);
+void serveJsonOverload(AsyncWebServerRequest* request);
+uint16_t getBinaryStateSize();
+uint16_t serializeStateBinary(uint8_t* buf);
+bool queueStateRequest(const uint8_t* json, size_t len, uint32_t clientId = 0);
+void handleStateQueue();
 #ifdef WLED_ENABLE_JSONLIVE
 bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient = 0);
 #endif
@@ -145,6 +219,7 @@ void setValuesFromFirstSelectedSeg();
 void resetTimebase();
 void toggleOnOff();
 void applyBri();
+void applyBriFine(uint16_t b16);
 void applyFinalBri();
 void applyValuesToSelectedSegs();
 void colorUpdated(byte callMode);
@@ -161,22 +236,35 @@ void parseLxJson(int lxValue, byte segId, bool secondary);
 //mqtt.cpp
 bool initMqtt();
 void publishMqtt();
+void handleMqtt();
 
 //ntp.cpp
 void handleTime();
 void handleNetworkTime();
 void sendNTPPacket();
 bool checkNTPResponse();    
+void restoreTime();
 void updateLocalTime();
 void getTimeString(char* out);
 bool checkCountdown();
 void setCountdown();
 byte weekdayMondayFirst();
 void checkTimers();
+void invalidateTimers();
+void serializeTimers(JsonArray arr);
 void calculateSunriseAndSunset();
 void setTimeFromAPI(uint32_t timein);
 
+//ota_gzip.cpp
+void otaBegin(const uint8_t* data, size_t len);
+void otaWrite(const uint8_t* data, size_t len);
+bool otaEnd();
+void otaAbort();
+
 //overlay.cpp
+void overlayClear(uint16_t owner);
+bool overlaySetRange(uint16_t owner, uint16_t start, uint16_t stop, uint32_t color);
+inline bool overlaySetPixel(uint16_t owner, uint16_t i, uint32_t color) { return overlaySetRange(owner, i, i, color); }
 void handleOverlayDraw();
 void _overlayAnalogCountdown();
 void _overlayAnalogClock();
@@ -186,31 +274,62 @@ void shufflePlaylist();
 void unloadPlaylist();
 int16_t loadPlaylist(JsonObject playlistObject, byte presetId = 0);
 void handlePlaylist();
+int16_t getPlaylistIndex();
+void resumePlaylist(int16_t index);
 
 //presets.cpp
-bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE);
+bool applyPreset(byte index, byte callMode = CALL_MODE_DIRECT_CHANGE, byte bank = PRESET_BANK_ACTIVE);
 inline bool applyTemporaryPreset() {return applyPreset(255);};
 void savePreset(byte index, const char* pname = nullptr, JsonObject saveobj = JsonObject());
 inline void saveTemporaryPreset() {savePreset(255);};
 void deletePreset(byte index);
+void dropCachedPreset(byte index, byte bank = PRESET_BANK_ACTIVE);
+void prefetchPreset(byte index, byte bank = PRESET_BANK_ACTIVE);
+void cachePresetMsgPack(byte bank, byte index, const uint8_t* msgPack, size_t len, size_t docSize);
+void getPresetBankFile(char* filename, byte bank);
+bool parsePresetRef(JsonVariant ref, byte* bank, byte* index);
+void setPresetBank(byte bank);
+void setPresetBankName(byte bank, const char* name);
+void deletePresetBank(byte bank);
+
+//resume.cpp
+#ifdef WLED_ENABLE_WARM_RESUME
+void markResumeState();
+void handleResume();
+bool restoreResumeState();
+#endif
 
 //set.cpp
 bool isAsterisksOnly(const char* str, byte maxLen);
 void handleSettingsSet(AsyncWebServerRequest *request, byte subPage);
 bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply=true);
+void handleBulkSet(AsyncWebServerRequest *request);
 int getNumVal(const String* req, uint16_t pos);
 void parseNumber(const char* str, byte* val, byte minv=0, byte maxv=255);
 bool updateVal(const String* req, const char* key, byte* val, byte minv=0, byte maxv=255);
 
 //udp.cpp
 void notify(byte callMode, bool followUp=false);
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, byte *buffer, uint8_t bri=255, bool isRGBW=false);
+struct NetOutput;
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, const NetOutput* outs, uint8_t count);
+bool realtimeAccept(byte md, IPAddress ip, int16_t prio = -1);
 void realtimeLock(uint32_t timeoutMs, byte md = REALTIME_MODE_GENERIC);
 void exitRealtime();
+bool beginUdpSocket(uint8_t socket, uint16_t port);
 void handleNotifications();
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w);
+void setRealtimePixels(uint16_t start, uint16_t count, const uint8_t* data, uint8_t stride);
+bool queueRealtimeFrame();
+void countRealtimePacket(uint32_t startUs);
+uint16_t getRealtimeLedCount();
+uint16_t getRealtimeStreamLength();
+void initRealtimeMap();
 void refreshNodeList();
 void sendSysInfoUDP();
+void invalidateStreamFollowers();
+void handleStreamFollowers();
+void serializeClockSync(JsonObject root);
+void serializeRealtimeSources(JsonObject root);
 
 //util.cpp
 //bool oappend(const char* txt); // append new c string to temp buffer efficiently
@@ -220,8 +339,16 @@ void sendSysInfoUDP();
 //void prepareHostname(char* hostname);
 //bool isAsterisksOnly(const char* str, byte maxLen);
 bool requestJSONBufferLock(uint8_t module=255);
+bool tryRequestJSONBufferLock(uint8_t module=255);
 void releaseJSONBufferLock();
+void initJSONBufferPool();
+void serializeMemStats(JsonObject root);
+JsonDocument* requestJSONBuffer(uint8_t module=255, bool wait=true);
+void releaseJSONBuffer(JsonDocument* buffer);
 uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLen);
+uint8_t extractFxName(uint8_t mode, char *dest, uint8_t maxLen);
+uint8_t extractPaletteName(uint8_t palette, char *dest, uint8_t maxLen);
+void setBusFieldIndex(char* name, uint8_t s);
 
 //um_manager.cpp
 class Usermod {
@@ -239,6 +366,15 @@ class Usermod {
     virtual void onMqttConnect(bool sessionPresent) {}
     virtual bool onMqttMessage(char* topic, char* payload) { return false; }
     virtual uint16_t getId() {return USERMOD_ID_UNSPECIFIED;}
+    virtual uint16_t getLoopInterval() { return 0; } //ms between loop() calls, 0: every pass
+    virtual uint8_t getLoopPriority() { return USERMOD_PRIORITY_NORMAL; }
+    //work started with usermods.startTask(): runTask() is called until it returns true, on a worker task (ESP32)
+    //or one step per loop pass (ESP8266), so it must not touch strip or state; onTaskDone() is called from loop()
+    virtual uint16_t getEventMask() { return 0; } //UM_EVENT_... onEvent() is called for, instead of polling state
+    virtual void onEvent(uint16_t event, uint8_t arg) {}
+    virtual bool runTask(uint8_t taskId, void* arg) { return true; }
+    virtual void onTaskDone(uint8_t taskId, void* arg) {}
+    virtual uint32_t getMemUsage() { return 0; } //heap allocated by the usermod, for /json/info "mem"
 };
 
 class UsermodManager {
@@ -246,6 +382,25 @@ class UsermodManager {
     Usermod* ums[WLED_MAX_USERMODS];
     byte numMods = 0;
 
+    struct LoopStats {
+      uint32_t lastRun;  //millis() of the last loop() call
+      uint32_t holdOff;  //ms after an overrun before loop() is called again
+      uint32_t runs, maxUs;
+      uint64_t totalUs;
+      uint32_t overruns, deferrals;
+    } stats[WLED_MAX_USERMODS] = {};
+    byte nextMod = 0;  //first usermod of the next pass, the one deferred first
+
+    struct Task {
+      Usermod* um;   //nullptr: free slot
+      void*    arg;
+      uint8_t  id;
+    } tasks[WLED_MAX_USERMOD_TASKS] = {};
+    void handleTasks();
+    #ifdef WLED_USERMOD_TASK
+    static void workerTask(void* param);
+    #endif
+
   public:
     void loop();
     void handleOverlayDraw();
@@ -262,6 +417,13 @@ class UsermodManager {
     bool add(Usermod* um);
     Usermod* lookup(uint16_t mod_id);
     byte getModCount();
+    void serializeLoopStats(JsonArray arr);
+    bool getLoopStats(byte i, uint16_t& id, uint32_t& runs, uint32_t& avgUs, uint32_t& maxUs);
+    uint32_t getMemUsage();
+    uint32_t getIdleTime();
+    void publish(uint16_t event, uint8_t arg = 0);
+    bool startTask(Usermod* um, uint8_t taskId, void* arg = nullptr);
+    bool isTaskPending(Usermod* um, uint8_t taskId);
 };
 
 //usermods_list.cpp
@@ -282,22 +444,48 @@ void clearEEPROM();
 void handleSerial();
 void updateBaudRate(uint32_t rate);
 
+//wifi_cache.cpp
+bool wifiFastBegin();
+bool wifiFastFailed(unsigned long elapsed);
+void wifiFastConnected();
+void serializeWifiTiming(JsonObject wifi);
+
 //wled_server.cpp
 bool isIp(String str);
 bool captivePortal(AsyncWebServerRequest *request);
+bool mayRequestVerbose(const uint8_t* body, size_t len);
+void handleFileUpload();
 void initServer();
 void serveIndexOrWelcome(AsyncWebServerRequest *request);
+bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request, const String& eTag = String(VERSION));
+void setStaticContentCacheHeaders(AsyncWebServerResponse *response, const String& eTag = String(VERSION));
+bool acceptsGzip(AsyncWebServerRequest* request);
+AsyncWebServerResponse* beginGzipResponse(AsyncWebServerRequest* request, const String& contentType, GzipSource source);
+AsyncWebServerResponse* beginGzipResponse(AsyncWebServerRequest* request, const String& contentType, std::shared_ptr<std::vector<uint8_t>> gz);
 void serveIndex(AsyncWebServerRequest* request);
 String msgProcessor(const String& var);
 void serveMessage(AsyncWebServerRequest* request, uint16_t code, const String& headl, const String& subl="", byte optionT=255);
 String settingsProcessor(const String& var);
 String dmxProcessor(const String& var);
 void serveSettings(AsyncWebServerRequest* request, bool post = false);
+void httpOnDisconnect(AsyncWebServerRequest* request, ArDisconnectHandler fn);
+void serializeHttpStats(JsonObject root);
+#ifdef ESP8266
+void handleTimeWait();
+#endif
+
+//sse.cpp
+void initSse();
+void sendDataSse();
+void handleSse();
 
 //ws.cpp
 void handleWs();
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len);
 void sendDataWs(AsyncWebSocketClient * client = nullptr);
+bool applyWsState(JsonObject root, uint32_t clientId);
+uint32_t wsMemUsage();
+void serializeWsQueues(JsonObject root);
 
 //xml.cpp
 void XML_response(AsyncWebServerRequest *request, char* dest = nullptr);
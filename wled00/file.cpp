@@ -1,4 +1,5 @@
 #include "wled.h"
+#include <memory>
 
 /*
  * Utility for SPIFFS filesystem
@@ -29,7 +30,158 @@
 // Actual space may be lower
 uint16_t knownLargestSpace = UINT16_MAX;
 
-File f;
+/*
+ * Block cache shared by the handles of the object files (presets, config, banks...): the least recently used of
+ * WLED_FS_CACHE_BLOCKS blocks of FS_BUFSIZE bytes, keyed by path and block number, so looking up, reading and
+ * applying a preset, or loading it again, reads its blocks from flash once. A block also records the file size,
+ * a file written by other means thus misses even if it was not dropped. Writes through a CachedFile drop the
+ * blocks of the file, other writers call fsCacheDrop(). Without memory for the cache the file is read directly.
+ */
+#ifndef WLED_FS_CACHE_BLOCKS
+  #ifdef ESP8266
+    #define WLED_FS_CACHE_BLOCKS 4
+  #else
+    #define WLED_FS_CACHE_BLOCKS 8
+  #endif
+#endif
+
+struct FSCacheBlock {
+  uint32_t key;   //hash of the path, 0: unused
+  uint32_t block; //position / FS_BUFSIZE
+  uint32_t size;  //of the file when read
+  uint32_t used;  //fsCacheTick of the last hit
+  uint16_t len;
+  byte data[FS_BUFSIZE];
+};
+
+static FSCacheBlock* fsCache = nullptr; //allocated on first use
+static uint32_t fsCacheTick = 0;
+static uint32_t fsCacheHits = 0, fsCacheMisses = 0;
+
+static uint32_t fsCacheKey(const char* path)
+{
+  uint32_t h = 2166136261UL; //FNV-1a
+  while (*path) h = (h ^ (uint8_t)*path++) * 16777619UL;
+  return h ? h : 1;
+}
+
+static void fsCacheDropKey(uint32_t key)
+{
+  if (!fsCache) return;
+  for (uint8_t i = 0; i < WLED_FS_CACHE_BLOCKS; i++) if (!key || fsCache[i].key == key) fsCache[i].key = 0;
+}
+
+//after a file was written, replaced or removed, nullptr drops all blocks
+void fsCacheDrop(const char* path)
+{
+  fsCacheDropKey(path ? fsCacheKey(path) : 0);
+}
+
+//a file of WLED_FS read through the block cache, each handle has its own position so several can be open at once
+class CachedFile : public Stream {
+  public:
+  bool open(const char* path, const char* mode) {
+    _file.close();
+    _key = fsCacheKey(path);
+    if (mode[0] != 'r') fsCacheDropKey(_key); //truncated or appended to
+    _file = WLED_FS.open(path, mode);
+    _pos = 0;
+    _size = _file ? _file.size() : 0;
+    return (bool)_file;
+  }
+  void close() { _file.close(); }
+  explicit operator bool() { return (bool)_file; }
+
+  size_t size() const { return _size; }
+  size_t position() const { return _pos; }
+  bool seek(uint32_t pos) {
+    _pos = (pos < _size) ? pos : _size;
+    return pos <= _size;
+  }
+
+  int available() override { return _size - _pos; }
+  int peek() override {
+    uint16_t len;
+    const byte* b = block(_pos / FS_BUFSIZE, len);
+    uint16_t ofs = _pos % FS_BUFSIZE;
+    if (b) return (ofs < len) ? b[ofs] : -1;
+    if (_pos >= _size) return -1;
+    _file.seek(_pos, SeekSet); //no cache memory
+    return _file.peek();
+  }
+  int read() override {
+    int c = peek();
+    if (c >= 0) _pos++;
+    return c;
+  }
+  int read(uint8_t* buf, size_t len) {
+    size_t n = 0;
+    while (n < len && _pos < _size) {
+      uint16_t blockLen;
+      const byte* b = block(_pos / FS_BUFSIZE, blockLen);
+      uint16_t ofs = _pos % FS_BUFSIZE;
+      if (!b) { //no cache memory
+        _file.seek(_pos, SeekSet);
+        int r = _file.read(buf + n, len - n);
+        if (r > 0) { n += r; _pos += r; }
+        break;
+      }
+      if (ofs >= blockLen) break;
+      size_t c = (len - n < blockLen - ofs) ? len - n : blockLen - ofs;
+      memcpy(buf + n, b + ofs, c);
+      n += c;
+      _pos += c;
+    }
+    return n;
+  }
+  size_t readBytes(char* buf, size_t len) { return read((uint8_t*)buf, len); } //used by deserializeJson()
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t len) override {
+    fsCacheDropKey(_key);
+    if (_file.position() != _pos) _file.seek(_pos, SeekSet);
+    size_t n = _file.write(buf, len);
+    _pos += n;
+    if (_pos > _size) _size = _pos;
+    return n;
+  }
+  void flush() override { _file.flush(); }
+
+  private:
+  File     _file;
+  uint32_t _key = 0;
+  uint32_t _pos = 0, _size = 0;
+
+  //block n of the file, read on a miss into the least recently used one; nullptr without cache memory or data
+  const byte* block(uint32_t n, uint16_t& len) {
+    if (!fsCache) fsCache = (FSCacheBlock*)calloc(WLED_FS_CACHE_BLOCKS, sizeof(FSCacheBlock));
+    if (!fsCache || !_file) return nullptr;
+    FSCacheBlock* lru = fsCache;
+    for (uint8_t i = 0; i < WLED_FS_CACHE_BLOCKS; i++) {
+      FSCacheBlock& c = fsCache[i];
+      if (c.key == _key && c.block == n && c.size == _size) {
+        c.used = ++fsCacheTick;
+        fsCacheHits++;
+        len = c.len;
+        return c.data;
+      }
+      if (lru->key && (!c.key || c.used < lru->used)) lru = &c;
+    }
+    fsCacheMisses++;
+    _file.seek(n * FS_BUFSIZE, SeekSet);
+    int r = _file.read(lru->data, FS_BUFSIZE);
+    if (r <= 0) { lru->key = 0; return nullptr; }
+    lru->key = _key;
+    lru->block = n;
+    lru->size = _size;
+    lru->len = r;
+    lru->used = ++fsCacheTick;
+    len = r;
+    return lru->data;
+  }
+};
+
+CachedFile f;
 
 //wrapper to find out how long closing takes
 void closeFile() {
@@ -42,6 +194,100 @@ void closeFile() {
   doCloseFile = false;
 }
 
+/*
+ * I/O statistics of the preset and config files for /json/info: operations, bytes and the latency distribution
+ * of reads and writes in power of two buckets from 64us, so percentiles cost no more than a few counters.
+ */
+#define FS_STATS_PRESETS 0
+#define FS_STATS_CONFIG  1
+#define FS_STATS_FILES   2
+#define FS_LAT_BUCKETS  16 //bucket b: below 2^(b+6) us, the last one takes the rest
+
+struct FSStats {
+  uint32_t reads, writes, seeks;
+  uint32_t bytesRead, bytesWritten;
+  uint32_t readLat[FS_LAT_BUCKETS], writeLat[FS_LAT_BUCKETS];
+};
+
+static FSStats fsStats[FS_STATS_FILES] = {};
+static int8_t  fsStatsFile = -1; //category of the object operation using f, for its seeks
+
+static int8_t fsStatsCategory(const char* file)
+{
+  if (!strncmp_P(file, PSTR("/presets"), 8)) return FS_STATS_PRESETS; //all preset banks
+  if (!strcmp_P(file, PSTR("/cfg.json")) || !strcmp_P(file, PSTR("/wsec.json"))) return FS_STATS_CONFIG;
+  return -1;
+}
+
+static void fsStatsLatency(uint32_t* buckets, uint32_t us)
+{
+  uint8_t b = 0;
+  for (us >>= 6; us && b < FS_LAT_BUCKETS -1; us >>= 1) b++;
+  buckets[b]++;
+}
+
+void fsStatsRead(const char* file, size_t bytes, uint32_t startMicros)
+{
+  int8_t c = fsStatsCategory(file);
+  if (c < 0) return;
+  fsStats[c].reads++;
+  fsStats[c].bytesRead += bytes;
+  fsStatsLatency(fsStats[c].readLat, micros() - startMicros);
+}
+
+void fsStatsWrite(const char* file, size_t bytes, uint32_t startMicros)
+{
+  int8_t c = fsStatsCategory(file);
+  if (c < 0) return;
+  fsStats[c].writes++;
+  fsStats[c].bytesWritten += bytes;
+  fsStatsLatency(fsStats[c].writeLat, micros() - startMicros);
+}
+
+static void seekFile(uint32_t pos)
+{
+  f.seek(pos);
+  if (fsStatsFile >= 0) fsStats[fsStatsFile].seeks++;
+}
+
+//upper bound in us below which p percent of the operations completed, 0 if there were none
+static uint32_t fsStatsPercentile(const uint32_t* buckets, uint32_t count, uint8_t p)
+{
+  if (!count) return 0;
+  uint32_t target = (count * p + 99) / 100, sum = 0;
+  uint8_t b = 0;
+  for (; b < FS_LAT_BUCKETS -1; b++) {
+    sum += buckets[b];
+    if (sum >= target) break;
+  }
+  return 64UL << b;
+}
+
+static void serializeFSStatsFile(JsonObject o, const FSStats& st)
+{
+  o["r"]  = st.reads;
+  o["w"]  = st.writes;
+  o["s"]  = st.seeks;
+  o[F("rb")] = st.bytesRead;
+  o[F("wb")] = st.bytesWritten;
+  JsonArray lr = o.createNestedArray(F("lr")); //p50, p90, p99 read latency in us
+  JsonArray lw = o.createNestedArray(F("lw"));
+  const uint8_t pct[3] = {50, 90, 99};
+  for (uint8_t i = 0; i < 3; i++) {
+    lr.add(fsStatsPercentile(st.readLat, st.reads, pct[i]));
+    lw.add(fsStatsPercentile(st.writeLat, st.writes, pct[i]));
+  }
+}
+
+void serializeFSStats(JsonObject fs)
+{
+  serializeFSStatsFile(fs.createNestedObject(F("pre")), fsStats[FS_STATS_PRESETS]);
+  serializeFSStatsFile(fs.createNestedObject(F("cfg")), fsStats[FS_STATS_CONFIG]);
+  JsonArray c = fs.createNestedArray(F("c")); //block cache hits, misses
+  c.add(fsCacheHits);
+  c.add(fsCacheMisses);
+}
+
 //find() that reads and buffers data from file stream in 256-byte blocks.
 //Significantly faster, f.find(key) can take SECONDS for multi-kB files
 bool bufferedFind(const char *target, bool fromStart = true) {
@@ -56,7 +302,7 @@ bool bufferedFind(const char *target, bool fromStart = true) {
 
   size_t index = 0;
   byte buf[FS_BUFSIZE];
-  if (fromStart) f.seek(0);
+  if (fromStart) seekFile(0);
 
   while (f.position() < f.size() -1) {
     uint16_t bufsize = f.read(buf, FS_BUFSIZE);
@@ -67,7 +313,7 @@ bool bufferedFind(const char *target, bool fromStart = true) {
 
       if(buf[count] == target[index]) {
         if(++index >= targetLen) { // return true if all chars in the target match
-          f.seek((f.position() - bufsize) + count +1);
+          seekFile((f.position() - bufsize) + count +1);
           DEBUGFS_PRINTF("Found at pos %d, took %d ms", f.position(), millis() - s);
           return true;
         }
@@ -97,7 +343,7 @@ bool bufferedFindSpace(uint16_t targetLen, bool fromStart = true) {
 
   uint16_t index = 0;
   byte buf[FS_BUFSIZE];
-  if (fromStart) f.seek(0);
+  if (fromStart) seekFile(0);
 
   while (f.position() < f.size() -1) {
     uint16_t bufsize = f.read(buf, FS_BUFSIZE);
@@ -107,7 +353,7 @@ bool bufferedFindSpace(uint16_t targetLen, bool fromStart = true) {
       if(buf[count] == ' ') {
         if(++index >= targetLen) { // return true if space long enough
           if (fromStart) {
-            f.seek((f.position() - bufsize) + count +1 - targetLen);
+            seekFile((f.position() - bufsize) + count +1 - targetLen);
             knownLargestSpace = UINT16_MAX; //there may be larger spaces after, so we don't know
           }
           DEBUGFS_PRINTF("Found at pos %d, took %d ms", f.position(), millis() - s);
@@ -149,7 +395,7 @@ bool bufferedFindObjectEnd() {
       if (buf[count] == '{') objDepth++;
       if (buf[count] == '}') objDepth--;
       if (objDepth == 0) {
-        f.seek((f.position() - bufsize) + count +1);
+        seekFile((f.position() - bufsize) + count +1);
         DEBUGFS_PRINTF("} at pos %d, took %d ms", f.position(), millis() - s);
         return true;
       }
@@ -220,13 +466,13 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
   
   //check if last character in file is '}' (typical)
   uint32_t eof = f.size() -1;
-  f.seek(eof, SeekSet);
+  seekFile(eof);
   if (f.read() == '}') pos = eof;
   
   if (pos == 0) //not found
   {
     DEBUGFS_PRINTLN("not }");
-    f.seek(0);
+    seekFile(0);
     while (bufferedFind("}",false)) //find last closing bracket in JSON if not last char
     {
       pos = f.position();
@@ -236,10 +482,10 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
   DEBUGFS_PRINT("pos "); DEBUGFS_PRINTLN(pos);
   if (pos > 2)
   {
-    f.seek(pos, SeekSet);
+    seekFile(pos);
     f.write(',');
   } else { //file content is not valid JSON object
-    f.seek(0, SeekSet);
+    seekFile(0);
     f.print('{'); //start JSON
   }
 
@@ -254,14 +500,441 @@ bool appendObjectToFile(const char* key, JsonDocument* content, uint32_t s, uint
   return true;
 }
 
+/*
+ * Positions of the objects in /presets.json by ID, collected in a single pass over the file when a preset is
+ * first looked up, so loading a preset is one seek. Dropped when the file is written, and rebuilt if the file
+ * size changed or the position does not start an object (edited by other means).
+ * Only the active preset bank is indexed, the files of other banks are searched.
+ */
+#define FS_INDEX_IDS 251 //preset IDs 0-250
+
+static uint32_t* presetIndex = nullptr; //position of the value of each key, 0: not in the file
+static size_t presetIndexSize = 0;      //file size the index was built for
+
+static bool isPresetFile(const char* file)
+{
+  #ifdef WLED_ENABLE_PRESET_LOG
+  return !strcmp_P(file, PSTR("/presets.json")); //the log holds bank 0
+  #else
+  char active[16];
+  getPresetBankFile(active, PRESET_BANK_ACTIVE);
+  return !strcmp(file, active);
+  #endif
+}
+
+void dropPresetIndex()
+{
+  free(presetIndex);
+  presetIndex = nullptr;
+}
+
+static bool allocPresetIndex()
+{
+  if (!presetIndex) presetIndex = (uint32_t*)malloc(FS_INDEX_IDS * sizeof(uint32_t));
+  if (!presetIndex) return false;
+  memset(presetIndex, 0, FS_INDEX_IDS * sizeof(uint32_t));
+  presetIndexSize = f.size();
+  return true;
+}
+
+//scans the open file f for root level keys, strings are skipped so their content cannot match
+static bool indexPresetJson()
+{
+  #ifdef WLED_DEBUG_FS
+    DEBUGFS_PRINTLN(F("Build preset index"));
+    uint32_t s = millis();
+  #endif
+  if (!allocPresetIndex()) return false;
+
+  byte buf[FS_BUFSIZE];
+  uint16_t depth = 0;
+  bool inString = false, escape = false, inKey = false, keyEnd = false, inValue = false;
+  uint16_t keyId = 0;
+  uint8_t keyDigits = 0; //1 + digits read, 0: key is not a number
+  uint32_t pos = 0;
+  seekFile(0);
+  while (f.position() < f.size()) {
+    uint16_t bufsize = f.read(buf, FS_BUFSIZE);
+    if (!bufsize) break;
+    for (uint16_t i = 0; i < bufsize; i++, pos++) {
+      char c = buf[i];
+      if (inString) {
+        if (escape) escape = false;
+        else if (c == '\\') escape = true;
+        else if (c == '"') { inString = false; keyEnd = inKey && keyDigits > 1; }
+        else if (inKey) {
+          if (isdigit(c) && keyDigits && keyDigits < 4) { keyId = keyId*10 + c - '0'; keyDigits++; }
+          else keyDigits = 0;
+        }
+        continue;
+      }
+      if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+      if (keyEnd && c == ':') {
+        keyEnd = false;
+        inValue = true;
+        continue;
+      }
+      if (inValue) { //index the value itself, so findObjectUsingId() sees its '{' for "1": {
+        if (keyId < FS_INDEX_IDS && !presetIndex[keyId]) presetIndex[keyId] = pos; //first one wins, like bufferedFind()
+        inValue = false;
+      }
+      keyEnd = false;
+      switch (c) {
+        case '"': inString = true; inKey = (depth == 1); keyId = 0; keyDigits = 1; break;
+        case '{': case '[': depth++; break;
+        case '}': case ']': if (depth) depth--; break;
+      }
+    }
+  }
+  DEBUGFS_PRINTF("Indexed, took %d ms\n", millis() - s);
+  return true;
+}
+
+#ifdef WLED_ENABLE_PRESET_LOG
+/*
+ * Log structured preset store, replaces patching /presets.json in place.
+ * /presets.log is a sequence of records: 'P', preset ID, payload length (16 bit little endian), the preset object.
+ * A record with length 0 deletes the preset. Saving appends one record and points the index to it.
+ * Once superseded records take more than half of the log, handlePresetLog() copies the live records
+ * into a new log, one per loop pass, and swaps it in.
+ * /presets.json is generated from the log when requested and imported into it when uploaded or found on boot.
+ */
+#define PRESET_LOG_FILE   "/presets.log"
+#define PRESET_LOG_TMP    "/presets.tmp"
+#define PRESET_LOG_HEADER 4
+#ifndef PRESET_LOG_SLACK
+  #define PRESET_LOG_SLACK 8192 // superseded bytes always tolerated
+#endif
+
+static uint16_t  presetLen[FS_INDEX_IDS];  //payload length of the latest record
+static uint32_t  presetLogLive = 0;        //bytes of the latest records, headers included
+static bool      presetLogTorn = false;    //the log ends with an incomplete record, compact it away
+static uint8_t   presetLogReaders = 0;     //responses sending /presets.json, the log is not swapped while >0
+static File      compactSrc, compactDst;
+static uint32_t* compactIndex = nullptr;   //positions in the new log
+static uint16_t  compactId = 0;
+
+static void setPresetLogEntry(uint8_t id, uint32_t pos, uint16_t len)
+{
+  if (presetIndex[id]) presetLogLive -= PRESET_LOG_HEADER + presetLen[id];
+  presetIndex[id] = len ? pos : 0;
+  presetLen[id] = len;
+  if (len) presetLogLive += PRESET_LOG_HEADER + len;
+}
+
+//reads the record headers of the log opened as f, payloads are skipped
+static bool indexPresetLog()
+{
+  if (!allocPresetIndex()) return false;
+  presetLogLive = 0;
+  uint32_t pos = 0, size = f.size();
+  uint8_t h[PRESET_LOG_HEADER];
+  while (pos + PRESET_LOG_HEADER <= size) {
+    seekFile(pos);
+    if (f.read(h, PRESET_LOG_HEADER) != PRESET_LOG_HEADER || h[0] != 'P' || h[1] >= FS_INDEX_IDS) break;
+    uint16_t len = h[2] | (h[3] << 8);
+    if (pos + PRESET_LOG_HEADER + len > size) break;
+    setPresetLogEntry(h[1], pos + PRESET_LOG_HEADER, len);
+    pos += PRESET_LOG_HEADER + len;
+  }
+  presetLogTorn = (pos != size); //power lost while saving
+  return true;
+}
+
+static void abortPresetLogCompaction()
+{
+  if (!compactIndex) return;
+  compactSrc.close();
+  compactDst.close();
+  WLED_FS.remove(PRESET_LOG_TMP);
+  free(compactIndex);
+  compactIndex = nullptr;
+}
+
+static bool appendPresetLog(uint16_t id, JsonDocument* content)
+{
+  if (id >= FS_INDEX_IDS) return false;
+  uint32_t len = content->isNull() ? 0 : measureJson(*content);
+  if (len > UINT16_MAX) return false;
+
+  if (doCloseFile) closeFile();
+  f.open(PRESET_LOG_FILE, "r");
+  bool indexed = (presetIndex && f && presetIndexSize == f.size()) || indexPresetLog();
+  f.close();
+  if (!indexed) return false;
+
+  updateFSInfo();
+  if (presetLogLive + len + PRESET_LOG_HEADER > (fsBytesTotal - fsBytesUsed)) { //room to compact at least once
+    errorFlag = ERR_FS_QUOTA;
+    return false;
+  }
+
+  File lf = WLED_FS.open(PRESET_LOG_FILE, "a");
+  if (!lf) return false;
+  uint32_t pos = lf.size();
+  uint8_t h[PRESET_LOG_HEADER] = {'P', (uint8_t)id, (uint8_t)(len & 0xFF), (uint8_t)(len >> 8)};
+  lf.write(h, PRESET_LOG_HEADER);
+  if (len) serializeJson(*content, lf);
+  lf.close();
+  fsCacheDrop(PRESET_LOG_FILE);
+
+  setPresetLogEntry(id, pos + PRESET_LOG_HEADER, len);
+  presetIndexSize = pos + PRESET_LOG_HEADER + len;
+  if (id < compactId) abortPresetLogCompaction(); //already copied
+  return true;
+}
+
+//converts /presets.json into a new log
+static void importPresetJson()
+{
+  if (doCloseFile) closeFile();
+  if (!f.open("/presets.json", "r")) return;
+  DEBUGFS_PRINTLN(F("Importing presets.json"));
+  abortPresetLogCompaction();
+  File lf = WLED_FS.open(PRESET_LOG_TMP, "w");
+  if (!lf || !indexPresetJson()) {
+    f.close();
+    dropPresetIndex();
+    return;
+  }
+
+  byte buf[FS_BUFSIZE];
+  for (uint16_t id = 1; id < FS_INDEX_IDS; id++) {
+    if (!presetIndex[id]) continue;
+    seekFile(presetIndex[id]);
+    if (!bufferedFindObjectEnd()) continue;
+    uint32_t len = f.position() - presetIndex[id];
+    if (len > UINT16_MAX) continue;
+    uint8_t h[PRESET_LOG_HEADER] = {'P', (uint8_t)id, (uint8_t)(len & 0xFF), (uint8_t)(len >> 8)};
+    lf.write(h, PRESET_LOG_HEADER);
+    seekFile(presetIndex[id]);
+    while (len) {
+      uint16_t block = (len > FS_BUFSIZE) ? FS_BUFSIZE : len;
+      f.read(buf, block);
+      lf.write(buf, block);
+      len -= block;
+    }
+  }
+  f.close();
+  lf.close();
+  dropPresetIndex();
+  WLED_FS.remove(PRESET_LOG_FILE);
+  WLED_FS.rename(PRESET_LOG_TMP, PRESET_LOG_FILE);
+  WLED_FS.remove("/presets.json");
+  fsCacheDrop(PRESET_LOG_FILE);
+  fsCacheDrop("/presets.json");
+}
+
+void initPresetLog()
+{
+  if (WLED_FS.exists(PRESET_LOG_TMP)) {
+    if (WLED_FS.exists(PRESET_LOG_FILE)) WLED_FS.remove(PRESET_LOG_TMP); //unfinished compaction
+    else WLED_FS.rename(PRESET_LOG_TMP, PRESET_LOG_FILE);                 //power lost while swapping
+  }
+  if (WLED_FS.exists("/presets.json")) importPresetJson();
+}
+
+//imports an uploaded presets.json, or copies one live record towards a compacted log
+void handlePresetLog()
+{
+  if (doImportPresets && !presetLogReaders) {
+    doImportPresets = false;
+    importPresetJson();
+    return;
+  }
+
+  if (!compactIndex) {
+    if (!presetIndex || presetLogReaders) return;
+    if (!presetLogTorn && presetIndexSize < 2 * presetLogLive + PRESET_LOG_SLACK) return;
+    compactIndex = (uint32_t*)calloc(FS_INDEX_IDS, sizeof(uint32_t));
+    if (!compactIndex) return;
+    compactSrc = WLED_FS.open(PRESET_LOG_FILE, "r");
+    compactDst = WLED_FS.open(PRESET_LOG_TMP, "w");
+    compactId = 0;
+    if (!compactSrc || !compactDst) { abortPresetLogCompaction(); return; }
+    DEBUGFS_PRINTLN(F("Compacting preset log"));
+  } else if (!presetIndex) { //dropped meanwhile
+    abortPresetLogCompaction();
+    return;
+  }
+
+  while (compactId < FS_INDEX_IDS && !presetIndex[compactId]) compactId++;
+  if (compactId < FS_INDEX_IDS) {
+    uint16_t len = presetLen[compactId];
+    uint8_t h[PRESET_LOG_HEADER] = {'P', (uint8_t)compactId, (uint8_t)(len & 0xFF), (uint8_t)(len >> 8)};
+    compactDst.write(h, PRESET_LOG_HEADER);
+    compactIndex[compactId] = compactDst.position();
+    compactSrc.seek(presetIndex[compactId]);
+    byte buf[FS_BUFSIZE];
+    while (len) {
+      uint16_t block = (len > FS_BUFSIZE) ? FS_BUFSIZE : len;
+      if (compactSrc.read(buf, block) != block) { abortPresetLogCompaction(); return; }
+      compactDst.write(buf, block);
+      len -= block;
+    }
+    compactId++;
+    return;
+  }
+
+  if (presetLogReaders) return; //swap once /presets.json was sent
+  if (doCloseFile) closeFile();
+  compactSrc.close();
+  presetIndexSize = compactDst.size();
+  compactDst.close();
+  WLED_FS.remove(PRESET_LOG_FILE);
+  WLED_FS.rename(PRESET_LOG_TMP, PRESET_LOG_FILE);
+  fsCacheDrop(PRESET_LOG_FILE);
+  free(presetIndex);
+  presetIndex = compactIndex;
+  compactIndex = nullptr;
+  compactId = 0;
+  presetLogTorn = false;
+  DEBUGFS_PRINTLN(F("Preset log compacted"));
+}
+
+//generates {"0":{},"<id>":{..},..} from the latest records
+class PresetLogJson {
+  public:
+  PresetLogJson() : _id(1), _left(0), _partPos(0) {
+    _file = WLED_FS.open(PRESET_LOG_FILE, "r");
+    _part = F("{\"0\":{}");
+    presetLogReaders++;
+  }
+  ~PresetLogJson() {
+    _file.close();
+    presetLogReaders--;
+  }
+
+  size_t fill(uint8_t* buf, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+      if (_partPos < _part.length()) {
+        size_t n = _part.length() - _partPos;
+        if (n > maxLen - len) n = maxLen - len;
+        memcpy(buf + len, _part.c_str() + _partPos, n);
+        _partPos += n;
+        len += n;
+      } else if (_left) {
+        size_t n = (_left > maxLen - len) ? maxLen - len : _left;
+        n = _file.read(buf + len, n);
+        if (!n) { _left = 0; continue; } //truncated, the JSON will be invalid
+        _left -= n;
+        len += n;
+      } else if (_id < FS_INDEX_IDS) {
+        uint16_t id = _id++;
+        if (!presetIndex || !presetIndex[id]) continue;
+        _file.seek(presetIndex[id]);
+        _left = presetLen[id];
+        _part = ",\""; _part += id; _part += "\":";
+        _partPos = 0;
+      } else if (_id == FS_INDEX_IDS) {
+        _part = "}";
+        _partPos = 0;
+        _id++;
+      } else break;
+    }
+    return len;
+  }
+
+  private:
+  File     _file;
+  uint16_t _id;
+  uint16_t _left;
+  size_t   _partPos;
+  String   _part;
+};
+
+static bool servePresetLog(AsyncWebServerRequest* request)
+{
+  if (doCloseFile) closeFile();
+  bool indexed = f.open(PRESET_LOG_FILE, "r") && ((presetIndex && presetIndexSize == f.size()) || indexPresetLog());
+  f.close();
+  if (!indexed) return false;
+  std::shared_ptr<PresetLogJson> json = std::make_shared<PresetLogJson>(); //freed with the response
+  AsyncWebServerResponse* response = beginGzipResponse(request, "application/json", [json](uint8_t* buf, size_t maxLen) -> size_t {
+    return json->fill(buf, maxLen);
+  });
+  if (!response) response = request->beginChunkedResponse("application/json", [json](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+    return json->fill(buf, maxLen);
+  });
+  request->send(response);
+  return true;
+}
+#else
+void initPresetLog() {}
+void handlePresetLog() {}
+#endif
+
+static bool indexPresets()
+{
+  #ifdef WLED_ENABLE_PRESET_LOG
+  return indexPresetLog();
+  #else
+  return indexPresetJson();
+  #endif
+}
+
+//the file presets are read from
+static const char* objectFilePath(const char* file)
+{
+  #ifdef WLED_ENABLE_PRESET_LOG
+  if (isPresetFile(file)) return PRESET_LOG_FILE;
+  #endif
+  return file;
+}
+
+//positions f at the object with the id, using the preset index for /presets.json
+static bool findObjectUsingId(const char* file, uint16_t id)
+{
+  if (isPresetFile(file) && id < FS_INDEX_IDS) {
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+      if ((!presetIndex || presetIndexSize != f.size()) && !indexPresets()) break; //no memory, search the file
+      if (!presetIndex[id]) return false;
+      seekFile(presetIndex[id]);
+      if (f.peek() == '{') return true;
+      dropPresetIndex(); //stale
+    }
+  }
+  #ifdef WLED_ENABLE_PRESET_LOG
+  if (isPresetFile(file)) return false; //the log cannot be searched
+  #endif
+  char objKey[10];
+  sprintf(objKey, "\"%d\":", id);
+  return bufferedFind(objKey);
+}
+
 bool writeObjectToFileUsingId(const char* file, uint16_t id, JsonDocument* content)
 {
+  #ifdef WLED_ENABLE_PRESET_LOG
+  if (isPresetFile(file)) {
+    uint32_t start = micros();
+    fsStatsFile = FS_STATS_PRESETS;
+    bool success = appendPresetLog(id, content);
+    fsStatsFile = -1;
+    fsStatsWrite(file, content->isNull() ? 0 : measureJson(*content), start);
+    TRACE_SPAN(TRACE_FILE, 1, start);
+    return success;
+  }
+  #endif
   char objKey[10];
   sprintf(objKey, "\"%d\":", id);
   return writeObjectToFile(file, objKey, content);
 }
 
+static bool patchObjectInFile(const char* file, const char* key, JsonDocument* content);
+
 bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
+{
+  uint32_t start = micros();
+  fsStatsFile = fsStatsCategory(file);
+  bool success = patchObjectInFile(file, key, content);
+  fsStatsFile = -1;
+  fsStatsWrite(file, content->isNull() ? 0 : measureJson(*content), start);
+  TRACE_SPAN(TRACE_FILE, 1, start);
+  return success;
+}
+
+static bool patchObjectInFile(const char* file, const char* key, JsonDocument* content)
 {
   uint32_t s = 0; //timing
   #ifdef WLED_DEBUG_FS
@@ -271,8 +944,8 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
   #endif
 
   uint32_t pos = 0;
-  f = WLED_FS.open(file, "r+");
-  if (!f && !WLED_FS.exists(file)) f = WLED_FS.open(file, "w+");
+  if (isPresetFile(file)) dropPresetIndex(); //objects may move
+  if (!f.open(file, "r+") && !WLED_FS.exists(file)) f.open(file, "w+");
   if (!f) {
     DEBUGFS_PRINTLN(F("Failed to open!"));
     return false;
@@ -303,18 +976,18 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
 
   if (contentLen && contentLen <= oldLen) { //replace and fill diff with spaces
     DEBUGFS_PRINTLN(F("replace"));
-    f.seek(pos);
+    seekFile(pos);
     serializeJson(*content, f);
     writeSpace(pos2 - f.position());
   } else if (contentLen && bufferedFindSpace(contentLen - oldLen, false)) { //enough leading spaces to replace
     DEBUGFS_PRINTLN(F("replace (trailing)"));
-    f.seek(pos);
+    seekFile(pos);
     serializeJson(*content, f);
   } else {
     DEBUGFS_PRINTLN(F("delete"));
     pos -= strlen(key);
     if (pos > 3) pos--; //also delete leading comma if not first object
-    f.seek(pos);
+    seekFile(pos);
     writeSpace(pos2 - pos);
     if (contentLen) return appendObjectToFile(key, content, s, contentLen);
   }
@@ -326,9 +999,24 @@ bool writeObjectToFile(const char* file, const char* key, JsonDocument* content)
 
 bool readObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* dest)
 {
-  char objKey[10];
-  sprintf(objKey, "\"%d\":", id);
-  return readObjectFromFile(file, objKey, dest);
+  if (doCloseFile) closeFile();
+  uint32_t start = micros();
+  if (!f.open(objectFilePath(file), "r")) return false;
+  fsStatsFile = fsStatsCategory(file);
+  bool found = findObjectUsingId(file, id);
+  fsStatsFile = -1;
+  if (!found) {
+    f.close();
+    dest->clear();
+    DEBUGFS_PRINTLN(F("Obj not found."));
+    return false;
+  }
+  size_t pos = f.position();
+  deserializeJson(*dest, f);
+  fsStatsRead(file, f.position() - pos, start);
+  f.close();
+  TRACE_SPAN(TRACE_FILE, 0, start);
+  return true;
 }
 
 //if the key is a nullptr, deserialize entire object
@@ -339,8 +1027,8 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest)
     DEBUGFS_PRINTF("Read from %s with key %s >>>\n", file, (key==nullptr)?"nullptr":key);
     uint32_t s = millis();
   #endif
-  f = WLED_FS.open(file, "r");
-  if (!f) return false;
+  uint32_t start = micros();
+  if (!f.open(file, "r")) return false;
 
   if (key != nullptr && !bufferedFind(key)) //key does not exist in file
   {
@@ -350,14 +1038,57 @@ bool readObjectFromFile(const char* file, const char* key, JsonDocument* dest)
     return false;
   }
 
+  size_t pos = f.position();
   deserializeJson(*dest, f);
+  fsStatsRead(file, f.position() - pos, start);
 
   f.close();
+  TRACE_SPAN(TRACE_FILE, 0, start);
   DEBUGFS_PRINTF("Read, took %d ms\n", millis() - s);
   return true;
 }
 
+//applies the state object with the id through deserializeStateStream(), for presets too large for doc
+bool applyObjectFromFileUsingId(const char* file, uint16_t id, JsonDocument* doc, byte callMode)
+{
+  if (doCloseFile) closeFile();
+  uint32_t start = micros();
+  if (!f.open(objectFilePath(file), "r")) return false;
+  fsStatsFile = fsStatsCategory(file);
+  bool found = findObjectUsingId(file, id);
+  fsStatsFile = -1;
+  size_t pos = f.position();
+  f.close();
+  if (!found) return false;
+
+  CachedFile pf; //own handle, a preset applied from this one uses f, the blocks just found are cached
+  if (!pf.open(objectFilePath(file), "r")) return false;
+  pf.seek(pos);
+  deserializeStateStream(pf, doc, callMode, id);
+  fsStatsRead(file, pf.position() - pos, start); //includes applying the state
+  pf.close();
+  return true;
+}
+
+/*
+ * FS usage walks the file system metadata, which takes long on large partitions. After presets and settings
+ * are saved it is only marked stale and recomputed by handleFSInfo() once FS_INFO_DELAY passed without writes.
+ * Quota checks before writing call updateFSInfo() directly.
+ */
+#define FS_INFO_DELAY 2000
+
+static unsigned long fsInfoStale = 0; //millis() of the last write, 0: up to date
+
+void invalidateFSInfo() {
+  fsInfoStale = millis() | 1;
+}
+
+void handleFSInfo() {
+  if (fsInfoStale && millis() - fsInfoStale > FS_INFO_DELAY) updateFSInfo();
+}
+
 void updateFSInfo() {
+  fsInfoStale = 0;
   #ifdef ARDUINO_ARCH_ESP32
     #if WLED_FS == LITTLEFS || ESP_IDF_VERSION_MAJOR >= 4
     fsBytesTotal = WLED_FS.totalBytes();
@@ -393,18 +1124,92 @@ String getContentType(AsyncWebServerRequest* request, String filename){
   return "text/plain";
 }
 
+//serves a single "bytes=first-last" range (206), false to send the whole file instead
+static bool serveFileRange(AsyncWebServerRequest* request, const String& path, const String& contentType)
+{
+  String range = request->getHeader("Range")->value();
+  if (!range.startsWith("bytes=") || range.indexOf(',') >= 0) return false;
+  int dash = range.indexOf('-');
+  if (dash < 0) return false;
+  struct RangeFile { File file; size_t left; };
+  std::shared_ptr<RangeFile> rf = std::make_shared<RangeFile>(); //closed with the response
+  rf->file = WLED_FS.open(path, "r");
+  if (!rf->file) return false;
+  size_t size = rf->file.size();
+  String first = range.substring(6, dash), last = range.substring(dash +1);
+  size_t from, to;
+  if (first.length()) { //"a-b" or "a-"
+    from = first.toInt();
+    to = last.length() ? (size_t)last.toInt() : size -1;
+  } else {              //"-n": the last n bytes
+    size_t n = last.toInt();
+    from = n < size ? size - n : 0;
+    to = size -1;
+  }
+  if (to >= size) to = size -1;
+  if (!size || from > to) {
+    AsyncWebServerResponse *response = request->beginResponse(416);
+    response->addHeader(F("Content-Range"), String(F("bytes */")) + String(size));
+    request->send(response);
+    return true;
+  }
+
+  rf->file.seek(from, SeekSet);
+  rf->left = to - from +1;
+  AsyncWebServerResponse *response = request->beginResponse(contentType, rf->left, [rf](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+    if (maxLen > rf->left) maxLen = rf->left;
+    size_t n = rf->file.read(buf, maxLen);
+    rf->left -= n;
+    return n;
+  });
+  response->setCode(206);
+  response->addHeader(F("Accept-Ranges"), "bytes");
+  response->addHeader(F("Content-Range"), String(F("bytes ")) + String(from) + "-" + String(to) + "/" + String(size));
+  request->send(response);
+  return true;
+}
+
+//JSON files are compressed while they are sent to clients accepting gzip, false to send the file as it is
+static bool serveFileGzipped(AsyncWebServerRequest* request, const String& path, const String& contentType)
+{
+  std::shared_ptr<File> file = std::make_shared<File>(WLED_FS.open(path, "r")); //closed with the response
+  if (!*file) return false;
+  AsyncWebServerResponse *response = beginGzipResponse(request, contentType, [file](uint8_t* buf, size_t maxLen) -> size_t {
+    int n = file->read(buf, maxLen);
+    return n > 0 ? n : 0;
+  });
+  if (!response) return false;
+  request->send(response);
+  return true;
+}
+
 bool handleFileRead(AsyncWebServerRequest* request, String path){
   DEBUG_PRINTLN("FileRead: " + path);
   if(path.endsWith("/")) path += "index.htm";
   if(path.indexOf("sec") > -1) return false;
+  if(path == "/presets.json" && presetBank) { //the active bank
+    char bankFile[16];
+    getPresetBankFile(bankFile, presetBank);
+    path = bankFile;
+  }
+  #ifdef WLED_ENABLE_PRESET_LOG
+  if(path == "/presets.json") return servePresetLog(request);
+  #endif
   String contentType = getContentType(request, path);
-  /*String pathWithGz = path + ".gz";
-  if(WLED_FS.exists(pathWithGz)){
-    request->send(WLED_FS, pathWithGz, contentType);
-    return true;
-  }*/
   if(WLED_FS.exists(path)) {
-    request->send(WLED_FS, path, contentType);
+    if (request->hasHeader("Range") && serveFileRange(request, path, contentType)) return true;
+    if (contentType == "application/json" && serveFileGzipped(request, path, contentType)) return true;
+    AsyncWebServerResponse *response = request->beginResponse(WLED_FS, path, contentType);
+    response->addHeader(F("Accept-Ranges"), "bytes");
+    request->send(response);
+    return true;
+  }
+  //files may be stored gzipped (uploaded as e.g. /ledmap.json.gz), they are only served to clients accepting that
+  String pathWithGz = path + ".gz";
+  if(WLED_FS.exists(pathWithGz) && request->hasHeader("Accept-Encoding") && request->getHeader("Accept-Encoding")->value().indexOf("gzip") >= 0) {
+    AsyncWebServerResponse *response = request->beginResponse(WLED_FS, pathWithGz, contentType);
+    response->addHeader(F("Content-Encoding"), "gzip");
+    request->send(response);
     return true;
   }
   return false;
@@ -0,0 +1,262 @@
+#include "wled.h"
+
+/*
+ * Peer-to-peer firmware rollout via the node list (WLED_ENABLE_FLEET_OTA)
+ * GET /json/fleet?go[=minutes] on a node that was just updated starts a rollout of its running image.
+ * While a rollout is active the node serves its image at /fleet.bin to at most WLED_FLEET_FANOUT peers
+ * at once and says so in its node announcements (variant, image ID, free slots, minutes left).
+ * Nodes with fleet updates enabled (ota.fleet in cfg.json, never while OTA is locked) pick a random source
+ * of the same variant with a newer image, write it with the MD5 from the source verified, and reboot.
+ * Once updated they join the rollout as sources, so the number of sources grows with every round.
+ * GET /json/fleet?stop ends the rollout on this node, without parameters its status is returned
+ * together with a summary of the peers of the same variant.
+ */
+#ifdef WLED_ENABLE_FLEET_OTA
+
+#ifdef ESP8266
+  #include <ESP8266HTTPClient.h>
+#else
+  #include <HTTPClient.h>
+  #include "esp_ota_ops.h"
+#endif
+
+#ifndef WLED_FLEET_FANOUT
+  #define WLED_FLEET_FANOUT 2      // concurrent downloads served by one node
+#endif
+#define FLEET_ANNOUNCE_MS  5000    // node announcements while a rollout is active
+#define FLEET_DEFAULT_MIN  60      // rollout duration if none is given
+#define FLEET_TIMEOUT_MS   10000   // abort a download stalled this long
+
+static uint32_t fleetVariant = 0;
+static uint32_t fleetImage = 0;
+static char     fleetMD5[33] = "";
+static uint32_t fleetImageSize = 0;
+static unsigned long fleetUntil = 0;  // millis() at which serving ends, 0 if not a source
+static bool     fleetStopped = false; // stopped here, do not rejoin from peers until reboot
+static unsigned long lastAnnounce = 0;
+static unsigned long nextPull = 0;
+static volatile uint8_t fleetServing = 0;
+static uint8_t  fleetProgress = FLEET_NO_PROGRESS;
+
+//identifies the image on flash (first bytes of its MD5) and which images may replace it
+static void fleetIdentify()
+{
+  if (fleetImage) return;
+  String md5 = ESP.getSketchMD5(); // reads the whole image once
+  strlcpy(fleetMD5, md5.c_str(), sizeof(fleetMD5));
+  char head[9];
+  strlcpy(head, fleetMD5, sizeof(head));
+  fleetImage = strtoul(head, nullptr, 16);
+  fleetImageSize = ESP.getSketchSize();
+
+  #ifdef WLED_RELEASE_NAME
+  const char* variant = TOSTRING(WLED_RELEASE_NAME);
+  #else
+  const char* variant = "custom";
+  #endif
+  uint32_t h = 2166136261UL; // FNV-1a over release name, chip and flash size
+  for (const char* c = variant; *c; c++) h = (h ^ (uint8_t)*c) * 16777619UL;
+  #if defined(ARDUINO_ARCH_ESP32) && defined(CONFIG_IDF_TARGET)
+  for (const char* c = CONFIG_IDF_TARGET; *c; c++) h = (h ^ (uint8_t)*c) * 16777619UL;
+  #endif
+  uint32_t flash = ESP.getFlashChipSize();
+  for (uint8_t i = 0; i < 4; i++) h = (h ^ ((flash >> (8*i)) & 0xFF)) * 16777619UL;
+  fleetVariant = h ? h : 1;
+}
+
+static uint8_t fleetMinutesLeft()
+{
+  if (!fleetUntil) return 0;
+  long left = (long)(fleetUntil - millis());
+  if (left <= 0) { fleetUntil = 0; return 0; }
+  return min(255L, (left + 59999) / 60000);
+}
+
+//bytes 49..59 of the node announcement, see sendSysInfoUDP()
+void fleetAnnounce(uint8_t* data)
+{
+  fleetIdentify();
+  for (uint8_t i = 0; i < 4; i++) {
+    data[49+i] = (fleetVariant >> (8*i)) & 0xFF;
+    data[53+i] = (fleetImage >> (8*i)) & 0xFF;
+  }
+  uint8_t left = fleetMinutesLeft();
+  data[57] = (left ? FLEET_SOURCE : 0) | (fleetServing >= WLED_FLEET_FANOUT ? FLEET_FULL : 0);
+  data[58] = fleetProgress;
+  data[59] = left;
+}
+
+//a newer image orders after ours, equal builds by image ID so concurrent rollouts converge
+static bool fleetIsNewer(const NodeStruct* n)
+{
+  if (n->build != (uint32_t)VERSION) return n->build > (uint32_t)VERSION;
+  return n->fleetImage > fleetImage;
+}
+
+//node announcement received, peers running our image share their rollout with us
+void fleetPeer(const NodeStruct* n)
+{
+  if (!fleetOTA || otaLock || fleetStopped || !n->fleetMinutes) return;
+  fleetIdentify();
+  if (n->fleetVariant != fleetVariant || n->fleetImage != fleetImage) return;
+  uint32_t theirs = n->fleetMinutes * 60000UL;
+  if (!fleetUntil || (long)(millis() + theirs - fleetUntil) > 60000) fleetUntil = millis() + theirs;
+}
+
+void serveFleetImage(AsyncWebServerRequest* request)
+{
+  if (!fleetMinutesLeft() || fleetServing >= WLED_FLEET_FANOUT) {
+    request->send(503, "text/plain", F("busy"));
+    return;
+  }
+  fleetIdentify();
+  fleetServing++;
+  httpOnDisconnect(request, [](){ if (fleetServing) fleetServing--; });
+  AsyncWebServerResponse* response = request->beginResponse("application/octet-stream", fleetImageSize, [](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+    size_t len = min((size_t)(fleetImageSize - index), maxLen);
+    #ifdef ESP8266
+    uint32_t word[64]; // flashRead wants aligned words, the image starts at flash address 0
+    size_t done = 0;
+    while (done < len) {
+      size_t n = min(len - done, sizeof(word));
+      if (!ESP.flashRead((index + done) & ~3UL, word, sizeof(word))) return 0;
+      size_t skew = (index + done) & 3;
+      n = min(n, sizeof(word) - skew);
+      memcpy(buf + done, (uint8_t*)word + skew, n);
+      done += n;
+    }
+    #else
+    if (esp_partition_read(esp_ota_get_running_partition(), index, buf, len) != ESP_OK) return 0;
+    #endif
+    return len;
+  });
+  response->addHeader(F("x-MD5"), fleetMD5);
+  request->send(response);
+}
+
+//downloads and writes the image of a source, blocks the main loop until done
+static bool fleetPull(const NodeStruct* src)
+{
+  char url[40];
+  snprintf_P(url, sizeof(url), PSTR("http://%s/fleet.bin"), src->ip.toString().c_str());
+  DEBUG_PRINTF("Fleet: pulling %s\n", url);
+
+  WiFiClient client;
+  HTTPClient http;
+  const char* headers[] = {"x-MD5"};
+  http.begin(client, url);
+  http.collectHeaders(headers, 1);
+  http.setTimeout(FLEET_TIMEOUT_MS);
+  int code = http.GET();
+  int size = http.getSize();
+  String md5 = http.header("x-MD5");
+  char head[9];
+  strlcpy(head, md5.c_str(), sizeof(head));
+  if (code != HTTP_CODE_OK || size <= 0 || md5.length() != 32 || strtoul(head, nullptr, 16) != src->fleetImage) {
+    DEBUG_PRINTF("Fleet: source refused (%d)\n", code);
+    http.end();
+    return false;
+  }
+
+  WiFiClient* stream = http.getStreamPtr();
+  uint8_t buf[1024];
+  int got = 0;
+  unsigned long lastData = millis();
+  fleetProgress = 0;
+  while (got < size && http.connected() && millis() - lastData < FLEET_TIMEOUT_MS) {
+    size_t avail = stream->available();
+    if (!avail) { delay(1); continue; }
+    int n = stream->readBytes(buf, min(avail, sizeof(buf)));
+    if (n <= 0) continue;
+    if (!got) {
+      otaBegin(buf, n);
+      Update.setMD5(md5.c_str());
+    }
+    otaWrite(buf, n);
+    if (Update.hasError()) break;
+    got += n;
+    lastData = millis();
+    uint8_t pct = ((uint64_t)got * 100) / size;
+    if (pct != fleetProgress && millis() - lastAnnounce > 1000) { // peers see the progress in their node list
+      fleetProgress = pct;
+      lastAnnounce = millis();
+      sendSysInfoUDP();
+    }
+    yield();
+  }
+  http.end();
+
+  if (got && got < size) otaAbort();
+  if (got < size || !otaEnd()) {
+    fleetProgress = FLEET_NO_PROGRESS;
+    DEBUG_PRINTLN(F("Fleet: download failed"));
+    return false;
+  }
+  fleetProgress = 100;
+  sendSysInfoUDP();
+  DEBUG_PRINTLN(F("Fleet: updated, rebooting"));
+  doReboot = true;
+  return true;
+}
+
+void handleFleet()
+{
+  if (!Network.isConnected() || doReboot) return;
+  if (fleetMinutesLeft() && nodeBroadcastEnabled && millis() - lastAnnounce > FLEET_ANNOUNCE_MS) {
+    lastAnnounce = millis();
+    sendSysInfoUDP();
+  }
+  if (!fleetOTA || otaLock || !nodeListEnabled || millis() < nextPull) return;
+  nextPull = millis() + random16(5000, 15000); // spread the pulls of nodes that heard the same announcement
+
+  fleetIdentify();
+  NodeStruct* pick = nullptr;
+  uint16_t eligible = 0;
+  #ifdef ESP8266
+  const uint8_t myType = NODE_TYPE_ID_ESP8266;
+  #else
+  const uint8_t myType = NODE_TYPE_ID_ESP32;
+  #endif
+  for (uint16_t i = 0; i < Nodes.capacity(); i++) {
+    NodeStruct* n = Nodes.at(i);
+    if (!n || n->age > 1 || n->nodeType != myType || n->fleetVariant != fleetVariant) continue;
+    if (!n->fleetMinutes || (n->fleetFlags & FLEET_FULL) || !fleetIsNewer(n)) continue;
+    if (random16(++eligible) == 0) pick = n; // uniformly random among the sources, spreads the load
+  }
+  if (pick) fleetPull(pick);
+}
+
+void serveFleet(AsyncWebServerRequest* request)
+{
+  fleetIdentify();
+  if (request->hasParam(F("go"))) {
+    if (otaLock) {
+      request->send(401, "application/json", F("{\"error\":\"OTA locked\"}"));
+      return;
+    }
+    uint16_t minutes = request->getParam(F("go"))->value().toInt();
+    if (!minutes) minutes = FLEET_DEFAULT_MIN;
+    fleetUntil = millis() + min(minutes, (uint16_t)255) * 60000UL;
+    fleetStopped = false;
+    lastAnnounce = 0;
+  } else if (request->hasParam(F("stop"))) {
+    fleetUntil = 0;
+    fleetStopped = true;
+  }
+
+  uint16_t done = 0, pulling = 0, pending = 0;
+  for (uint16_t i = 0; i < Nodes.capacity(); i++) {
+    NodeStruct* n = Nodes.at(i);
+    if (!n || n->fleetVariant != fleetVariant) continue;
+    if (n->fleetImage == fleetImage) done++;
+    else if (n->fleetProgress != FLEET_NO_PROGRESS) pulling++;
+    else pending++;
+  }
+  char json[200];
+  snprintf_P(json, sizeof(json), PSTR("{\"on\":%s,\"min\":%u,\"img\":\"%08x\",\"var\":\"%08x\",\"srv\":%u,\"fan\":%u,\"en\":%s,\"peers\":{\"done\":%u,\"pull\":%u,\"pend\":%u}}"),
+             fleetUntil ? "true" : "false", fleetMinutesLeft(), (unsigned)fleetImage, (unsigned)fleetVariant, fleetServing, WLED_FLEET_FANOUT,
+             fleetOTA && !otaLock ? "true" : "false", done, pulling, pending);
+  request->send(200, "application/json", json);
+}
+
+#endif
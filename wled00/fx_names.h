@@ -0,0 +1,59 @@
+//generated from JSON_mode_names and JSON_palette_names in FX.h by pio-scripts/name_index.py, do not edit
+#ifndef WLED_FX_NAMES_H
+#define WLED_FX_NAMES_H
+
+#define FX_NAME_COUNT  119
+#define PAL_NAME_COUNT 71
+#define PAL_NAME_FIXED 6 //Default and the color palettes, not sorted
+
+//offset of each effect name in JSON_mode_names
+const uint16_t JSON_mode_name_pos[] PROGMEM = {
+  3,11,19,29,36,50,66,74,84,96,107,114,126,133,143,161,171,177,187,198,
+  214,224,239,250,259,276,290,306,316,324,340,356,370,388,405,416,432,447,457,466,
+  476,486,499,511,518,527,542,553,563,572,581,592,607,622,634,644,655,666,678,684,
+  699,714,725,737,750,759,769,781,794,800,814,824,834,844,854,870,877,886,902,912,
+  922,935,948,965,981,1001,1009,1022,1032,1041,1064,1079,1096,1106,1121,1139,1149,1156,1165,1175,
+  1193,1205,1216,1232,1248,1258,1267,1279,1292,1299,1315,1322,1333,1351,1369,1382,1391,1406,1423,
+};
+//its length, without a settings extension
+const uint8_t JSON_mode_name_len[] PROGMEM = {
+  5,5,7,4,11,13,5,7,9,7,4,9,4,7,15,7,3,7,8,12,
+  7,12,8,6,14,11,13,7,5,12,13,11,15,14,8,13,12,7,6,6,
+  7,10,9,4,6,12,8,7,6,5,8,12,12,9,7,8,8,9,3,11,
+  12,8,9,10,6,7,9,10,3,10,7,7,7,7,13,4,6,13,7,6,
+  10,10,14,13,17,5,10,7,6,19,12,14,7,12,15,7,4,6,7,14,
+  9,8,12,13,7,6,9,9,4,12,4,8,15,15,10,6,12,14,8,
+};
+//effects in alphabetical order, Solid first
+const uint8_t JSON_mode_alpha[] PROGMEM = {
+  0,27,38,115,1,26,91,68,2,88,102,114,28,37,54,31,32,30,29,111,
+  34,8,74,67,112,18,19,96,7,117,12,49,51,69,66,45,42,90,89,110,
+  87,46,53,82,100,58,64,75,41,57,47,76,77,59,70,71,72,73,107,62,
+  101,65,98,105,109,97,118,48,95,63,78,43,9,33,5,79,99,15,52,16,
+  10,11,40,60,108,92,93,94,103,83,84,20,21,22,85,86,39,61,23,25,
+  24,104,6,36,44,13,14,35,56,55,116,17,81,80,106,50,113,3,4,
+};
+
+//offset of each palette name in JSON_palette_names
+const uint16_t JSON_palette_name_pos[] PROGMEM = {
+  3,13,30,42,57,76,92,100,108,115,124,133,143,159,168,180,189,202,214,226,
+  236,245,256,264,274,286,298,306,316,323,334,343,349,360,368,379,386,396,404,417,
+  427,437,446,455,464,480,489,503,514,519,529,538,550,557,566,580,591,605,613,625,
+  639,651,664,675,688,701,714,726,738,750,762,
+};
+//its length
+const uint8_t JSON_palette_name_len[] PROGMEM = {
+  7,14,9,12,16,13,5,5,4,5,6,7,13,6,9,6,10,9,9,6,
+  6,8,5,7,9,9,5,7,4,7,6,3,8,5,8,4,7,5,10,6,
+  7,6,6,6,13,6,11,8,2,6,6,9,4,6,11,8,11,5,9,10,
+  9,10,8,10,10,10,9,9,9,8,6,
+};
+//palettes in alphabetical order after the fixed ones
+const uint8_t JSON_palette_alpha[] PROGMEM = {
+  0,1,2,3,4,5,18,46,63,51,50,55,39,26,22,67,15,48,52,53,
+  57,70,7,37,24,30,59,35,10,32,28,29,36,31,25,8,38,65,40,41,
+  9,44,47,6,20,61,11,12,16,66,62,68,69,56,33,14,49,60,27,19,
+  13,21,54,34,45,58,23,43,64,17,42,
+};
+
+#endif
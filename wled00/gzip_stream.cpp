@@ -0,0 +1,185 @@
+#include "wled.h"
+
+/*
+ * Deflate (RFC 1951) with fixed Huffman codes as a single block in a gzip (RFC 1952) member, see gzip_stream.h
+ */
+
+#define GZ_MIN_MATCH 3
+#define GZ_MAX_MATCH 258
+
+static const uint16_t gzLenBase[29] PROGMEM = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint16_t gzDistBase[30] PROGMEM = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+  1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static uint32_t gzCrc32(uint32_t crc, const uint8_t* data, size_t len)
+{
+  static const uint32_t nibble[16] PROGMEM = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  while (len--) {
+    crc ^= *data++;
+    crc = (crc >> 4) ^ pgm_read_dword(&nibble[crc & 0x0F]);
+    crc = (crc >> 4) ^ pgm_read_dword(&nibble[crc & 0x0F]);
+  }
+  return crc;
+}
+
+static inline uint16_t gzHash(const uint8_t* p)
+{
+  return ((p[0] << 6) ^ (p[1] << 3) ^ p[2]) & ((1 << WLED_GZIP_HASH_BITS) -1);
+}
+
+//bits are packed starting with the least significant one
+void GzipStream::putBits(uint32_t value, uint8_t count)
+{
+  _bits |= value << _bitCount;
+  _bitCount += count;
+  while (_bitCount >= 8) {
+    _out[_outLen++] = _bits;
+    _bits >>= 8;
+    _bitCount -= 8;
+  }
+}
+
+//Huffman codes are packed starting with the most significant bit
+void GzipStream::putCode(uint16_t code, uint8_t len)
+{
+  uint16_t reversed = 0;
+  for (uint8_t i = 0; i < len; i++, code >>= 1) reversed = (reversed << 1) | (code & 1);
+  putBits(reversed, len);
+}
+
+//literal/length symbol in the fixed code
+void GzipStream::putSymbol(uint16_t sym)
+{
+  if      (sym < 144) putCode(0x30 + sym, 8);
+  else if (sym < 256) putCode(0x190 + sym - 144, 9);
+  else if (sym < 280) putCode(sym - 256, 7);
+  else                putCode(0xC0 + sym - 280, 8);
+}
+
+void GzipStream::putMatch(uint16_t len, uint16_t dist)
+{
+  uint8_t l = 28;
+  while (pgm_read_word(&gzLenBase[l]) > len) l--;
+  putSymbol(257 + l);
+  if (l >= 8 && l < 28) putBits(len - pgm_read_word(&gzLenBase[l]), (l - 4) >> 2);
+  uint8_t d = 29;
+  while (pgm_read_word(&gzDistBase[d]) > dist) d--;
+  putCode(d, 5);
+  if (d >= 4) putBits(dist - pgm_read_word(&gzDistBase[d]), (d - 2) >> 1);
+}
+
+//moves the window once the position passed its first half and reads from the source up to the end of the buffer
+void GzipStream::refill()
+{
+  if (_pos >= WLED_GZIP_WINDOW) {
+    memmove(_in, _in + WLED_GZIP_WINDOW, _inLen - WLED_GZIP_WINDOW);
+    _inLen -= WLED_GZIP_WINDOW;
+    _pos -= WLED_GZIP_WINDOW;
+    for (uint16_t i = 0; i < (1 << WLED_GZIP_HASH_BITS); i++) _head[i] = (_head[i] > WLED_GZIP_WINDOW) ? _head[i] - WLED_GZIP_WINDOW : 0;
+  }
+  while (_inLen < sizeof(_in) && !_srcDone) {
+    size_t n = _source(_in + _inLen, sizeof(_in) - _inLen);
+    if (!n) { _srcDone = true; break; }
+    _crc = gzCrc32(_crc, _in + _inLen, n);
+    _size += n;
+    _inLen += n;
+  }
+}
+
+//compresses until _out is nearly full or the source is exhausted
+void GzipStream::encode()
+{
+  while (_outLen < sizeof(_out) - 8) { // a symbol takes at most 31 bits
+    if (_inLen - _pos < GZ_MAX_MATCH && !_srcDone) refill();
+    uint16_t avail = _inLen - _pos;
+    if (!avail) return;
+    uint16_t len = 0, dist = 0;
+    if (avail >= GZ_MIN_MATCH) {
+      uint16_t h = gzHash(_in + _pos);
+      if (_head[h]) {
+        uint16_t cand = _head[h] -1;
+        uint16_t max = (avail < GZ_MAX_MATCH) ? avail : GZ_MAX_MATCH;
+        while (len < max && _in[cand + len] == _in[_pos + len]) len++;
+        dist = _pos - cand;
+      }
+      _head[h] = _pos +1;
+    }
+    if (len >= GZ_MIN_MATCH) {
+      putMatch(len, dist);
+      for (uint16_t k = 1; k < len && _pos + k + GZ_MIN_MATCH <= _inLen; k++) _head[gzHash(_in + _pos + k)] = _pos + k +1;
+      _pos += len;
+    } else {
+      putSymbol(_in[_pos]);
+      _pos++;
+    }
+  }
+}
+
+size_t GzipStream::fill(uint8_t* buf, size_t maxLen)
+{
+  size_t len = 0;
+  while (len < maxLen) {
+    if (_outPos < _outLen) {
+      size_t n = min(maxLen - len, (size_t)(_outLen - _outPos));
+      memcpy(buf + len, _out + _outPos, n);
+      len += n; _outPos += n;
+      continue;
+    }
+    _outLen = _outPos = 0;
+    switch (_step) {
+      case GZ_HEADER: {
+        const uint8_t header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF}; // deflate, no mtime, unknown OS
+        memcpy(_out, header, sizeof(header));
+        _outLen = sizeof(header);
+        putBits(1, 1); // last block
+        putBits(1, 2); // fixed Huffman codes
+        _step = GZ_DATA;
+        break;
+      }
+      case GZ_DATA:
+        encode();
+        if (_inLen == _pos && _srcDone) {
+          putSymbol(256); // end of block
+          if (_bitCount) putBits(0, 8 - _bitCount);
+          _step = GZ_TRAILER;
+        }
+        break;
+      case GZ_TRAILER:
+        _crc ^= 0xFFFFFFFF;
+        for (uint8_t i = 0; i < 4; i++) _out[_outLen++] = _crc >> (8 * i);
+        for (uint8_t i = 0; i < 4; i++) _out[_outLen++] = _size >> (8 * i);
+        _step = GZ_DONE;
+        break;
+      default:
+        return len;
+    }
+  }
+  return len;
+}
+
+std::shared_ptr<std::vector<uint8_t>> gzipBuffer(const uint8_t* data, size_t len, bool progmem)
+{
+  if (ESP.getFreeHeap() < sizeof(GzipStream) + len / 2 + WLED_GZIP_MIN_HEAP) return nullptr;
+  size_t pos = 0;
+  std::unique_ptr<GzipStream> gz(new (std::nothrow) GzipStream([data, len, progmem, &pos](uint8_t* buf, size_t maxLen) -> size_t {
+    size_t n = min(maxLen, len - pos);
+    if (progmem) memcpy_P(buf, data + pos, n);
+    else         memcpy(buf, data + pos, n);
+    pos += n;
+    return n;
+  }));
+  if (!gz) return nullptr;
+  std::shared_ptr<std::vector<uint8_t>> out = std::make_shared<std::vector<uint8_t>>();
+  out->reserve(len / 3 + 32);
+  uint8_t buf[128];
+  for (size_t n; (n = gz->fill(buf, sizeof(buf))); ) out->insert(out->end(), buf, buf + n);
+  out->shrink_to_fit();
+  return out;
+}
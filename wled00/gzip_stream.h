@@ -0,0 +1,64 @@
+#ifndef WLED_GZIP_STREAM_H
+#define WLED_GZIP_STREAM_H
+
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/*
+ * Streaming gzip compression of dynamic responses (JSON, presets, live view) for clients sending
+ * "Accept-Encoding: gzip". Deflate with the fixed Huffman codes and an LZ77 window of 2*WLED_GZIP_WINDOW bytes,
+ * matched through a single hash head per 3 byte sequence: the JSON keys repeat within a few hundred bytes,
+ * so this takes most of the gain for a few kB of RAM and little CPU.
+ */
+#ifndef WLED_GZIP_WINDOW
+  #ifdef ESP8266
+    #define WLED_GZIP_WINDOW 1024
+  #else
+    #define WLED_GZIP_WINDOW 2048
+  #endif
+#endif
+#define WLED_GZIP_HASH_BITS 9
+#ifndef WLED_GZIP_MIN_HEAP
+  #define WLED_GZIP_MIN_HEAP 12288 // heap left to the rest after allocating a compressor
+#endif
+
+//fills up to maxLen bytes of the uncompressed content, 0 at its end (as an AwsResponseFiller)
+typedef std::function<size_t(uint8_t*, size_t)> GzipSource;
+
+class GzipStream
+{
+  public:
+  GzipStream(GzipSource source) : _source(source) {}
+
+  //AwsResponseFiller, 0 ends the response
+  size_t fill(uint8_t* buf, size_t maxLen);
+
+  private:
+  enum : uint8_t { GZ_HEADER, GZ_DATA, GZ_TRAILER, GZ_DONE };
+
+  GzipSource _source;
+  uint8_t  _in[2 * WLED_GZIP_WINDOW];           // history, then the bytes to compress
+  uint16_t _head[1 << WLED_GZIP_HASH_BITS] = {0}; // last position +1 of each hash, 0: none
+  uint16_t _inLen = 0, _pos = 0;
+  uint32_t _crc = 0xFFFFFFFF, _size = 0;
+  uint32_t _bits = 0;
+  uint8_t  _bitCount = 0;
+  uint8_t  _out[48];                            // compressed bytes not yet filled
+  uint8_t  _outLen = 0, _outPos = 0;
+  uint8_t  _step = GZ_HEADER;
+  bool     _srcDone = false;
+
+  void putBits(uint32_t value, uint8_t count);
+  void putCode(uint16_t code, uint8_t len);
+  void putSymbol(uint16_t sym);
+  void putMatch(uint16_t len, uint16_t dist);
+  void refill();
+  void encode();
+};
+
+//the gzip of data (in PROGMEM if progmem), nullptr without memory
+std::shared_ptr<std::vector<uint8_t>> gzipBuffer(const uint8_t* data, size_t len, bool progmem = false);
+
+#endif
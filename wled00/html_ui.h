@@ -8,6 +8,7 @@
  
 // Autogenerated from wled00/data/index.htm, do not edit!!
 const uint16_t PAGE_index_L = 35625;
+const char PAGE_index_hash[] PROGMEM = "6e9a0b08"; // content hash, used as ETag
 const uint8_t PAGE_index[] PROGMEM = {
   0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x0a, 0xcc, 0xbd, 0x77, 0x7f, 0xe3, 0xb8,
   0xae, 0x30, 0xfc, 0x7f, 0x3e, 0x85, 0xc7, 0xb3, 0x3b, 0x6b, 0x8d, 0x65, 0x59, 0xee, 0x6d, 0x34,
@@ -6,6 +6,30 @@
 
 #ifndef WLED_DISABLE_HUESYNC
 
+#define HUE_SCAN_DEPTH 4  //containers deeper than this are skipped
+#define HUE_SCAN_KEY  12  //longest key of interest ("colormode") + 1
+
+static char    hueRequest[128];
+static uint8_t hueRequestLen = 0; //0: build again
+
+static struct {
+  bool     inBody, inString, escape, expectKey, done, isArray;
+  uint8_t  crlf;                  //characters of the header end seen
+  uint8_t  depth;
+  char     open[HUE_SCAN_DEPTH];  //'{' or '['
+  char     key[HUE_SCAN_DEPTH][HUE_SCAN_KEY]; //current key of each object
+  uint8_t  index[HUE_SCAN_DEPTH]; //current element of each array
+  char     tok[48];
+  uint8_t  tokLen;
+  //extracted values
+  bool     on, hasBri;
+  uint8_t  bri, sat, colormode;
+  uint16_t ct, hue;
+  uint16_t x, y;                  //1/10000
+  int      errorType;
+  char     username[sizeof(hueApiKey)];
+} hueScan;
+
 void handleHue()
 {
   if (hueReceived)
@@ -24,7 +48,8 @@ void handleHue()
   hueLastRequestSent = millis();
   if (huePollingEnabled)
   {
-    reconnectHue();
+    if (hueClient->connected()) sendHuePoll(); //keep-alive, no new connection per poll
+    else hueClient->connect(hueIP, 80);
   } else {
     hueClient->close();
     if (hueError == HUE_ERROR_ACTIVE) hueError = HUE_ERROR_INACTIVE;
@@ -42,6 +67,8 @@ void reconnectHue()
     hueClient->onError(&onHueError, hueClient);
     hueAuthRequired = (strlen(hueApiKey)<20);
   }
+  hueRequestLen = 0; //settings may have changed
+  if (hueClient->connected()) hueClient->close(true);
   hueClient->connect(hueIP, 80);
 }
 
@@ -57,51 +84,138 @@ void onHueConnect(void* arg, AsyncClient* client)
   sendHuePoll();
 }
 
+//the request is built once and sent as is until the bridge, light, key or authorization changes
+static void buildHueRequest()
+{
+  char ip[16];
+  sprintf_P(ip, PSTR("%d.%d.%d.%d"), hueIP[0], hueIP[1], hueIP[2], hueIP[3]);
+  int len;
+  if (hueAuthRequired) {
+    len = snprintf_P(hueRequest, sizeof(hueRequest), PSTR("POST /api HTTP/1.1\r\nHost: %s\r\nContent-Length: 25\r\n\r\n{\"devicetype\":\"wled#esp\"}"), ip);
+  } else {
+    len = snprintf_P(hueRequest, sizeof(hueRequest), PSTR("GET /api/%s/lights/%d HTTP/1.1\r\nHost: %s\r\n\r\n"), hueApiKey, huePollLightId, ip);
+  }
+  hueRequestLen = (len > 0 && len < (int)sizeof(hueRequest)) ? len : 0;
+}
+
 void sendHuePoll()
 {
   if (hueClient == nullptr || !hueClient->connected()) return;
-  String req = "";
-  if (hueAuthRequired)
-  {
-    req += F("POST /api HTTP/1.1\r\nHost: ");
-    req += hueIP.toString();
-    req += F("\r\nContent-Length: 25\r\n\r\n{\"devicetype\":\"wled#esp\"}");
-  } else
-  {
-    req += F("GET /api/");
-    req += hueApiKey;
-    req += F("/lights/");
-    req += String(huePollLightId);
-    req += F(" HTTP/1.1\r\nHost: ");
-    req += hueIP.toString();
-    req += "\r\n\r\n";
-  }
-  hueClient->add(req.c_str(), req.length());
+  if (!hueRequestLen) buildHueRequest();
+  if (!hueRequestLen) return;
+  memset(&hueScan, 0, sizeof(hueScan)); //the response to this request
+  hueClient->add(hueRequest, hueRequestLen);
   hueClient->send();
   hueLastRequestSent = millis();
 }
 
-void onHueData(void* arg, AsyncClient* client, void *data, size_t len)
+//"0.5051" as 5051, the bridge sends xy coordinates (0-1) with up to 4 decimals
+static uint16_t hueParseCoordinate(const char* v)
 {
-  if (!len) return;
-  char* str = (char*)data;
-  DEBUG_PRINTLN(hueApiKey);
-  DEBUG_PRINTLN(str);
-  //only get response body
-  str = strstr(str,"\r\n\r\n");
-  if (str == nullptr) return;
-  str += 4;
-
-  StaticJsonDocument<1024> root;
-  if (str[0] == '[') //is JSON array
-  {
-    auto error = deserializeJson(root, str);
-    if (error)
-    {
-      hueError = HUE_ERROR_JSON_PARSING; return;
+  uint16_t val = (*v >= '1' && *v <= '9') ? 10000 : 0;
+  while (*v >= '0' && *v <= '9') v++;
+  if (*v == '.' && val == 0) {
+    v++;
+    for (uint16_t unit = 1000; unit && *v >= '0' && *v <= '9'; unit /= 10) val += (*v++ - '0') * unit;
+  }
+  return val;
+}
+
+/*
+ * The response is scanned as it arrives, in as many packets as it takes, without being stored.
+ * Only the scalar values at the paths WLED uses are kept: state.on/bri/colormode/ct/hue/sat/xy of a light,
+ * or [0].error.type and [0].success.username when authorizing.
+ */
+static void hueValue(const char* v)
+{
+  const uint8_t d = hueScan.depth;
+  if (hueScan.open[0] == '{' && d == 2 && !strcmp_P(hueScan.key[0], PSTR("state"))) {
+    const char* k = hueScan.key[1];
+    if      (!strcmp_P(k, PSTR("on")))  hueScan.on = (v[0] == 't');
+    else if (!strcmp_P(k, PSTR("bri"))) { hueScan.bri = atoi(v); hueScan.hasBri = true; }
+    else if (!strcmp_P(k, PSTR("ct")))  hueScan.ct = atoi(v);
+    else if (!strcmp_P(k, PSTR("hue"))) hueScan.hue = atoi(v);
+    else if (!strcmp_P(k, PSTR("sat"))) hueScan.sat = atoi(v);
+    else if (!strcmp_P(k, PSTR("colormode"))) hueScan.colormode = (v[0] == 'c') ? 3 : (v[0] == 'x') ? 1 : 2;
+  } else if (hueScan.open[0] == '{' && d == 3 && hueScan.open[2] == '[' && !strcmp_P(hueScan.key[0], PSTR("state"))
+          && !strcmp_P(hueScan.key[1], PSTR("xy"))) {
+    if (hueScan.index[2] == 0) hueScan.x = hueParseCoordinate(v);
+    if (hueScan.index[2] == 1) hueScan.y = hueParseCoordinate(v);
+  } else if (hueScan.open[0] == '[' && d == 3 && hueScan.index[0] == 0) {
+    hueScan.isArray = true;
+    if (!strcmp_P(hueScan.key[1], PSTR("error")) && !strcmp_P(hueScan.key[2], PSTR("type"))) hueScan.errorType = atoi(v);
+    if (!strcmp_P(hueScan.key[1], PSTR("success")) && !strcmp_P(hueScan.key[2], PSTR("username"))) strlcpy(hueScan.username, v, sizeof(hueScan.username));
+  }
+}
+
+static void hueFlushToken()
+{
+  if (!hueScan.tokLen) return;
+  hueScan.tok[hueScan.tokLen] = 0;
+  hueValue(hueScan.tok);
+  hueScan.tokLen = 0;
+}
+
+//false once the response is complete
+static bool hueScanChar(char c)
+{
+  if (!hueScan.inBody) { //skip the headers
+    hueScan.crlf = (c == (hueScan.crlf & 1 ? '\n' : '\r')) ? hueScan.crlf +1 : (c == '\r');
+    hueScan.inBody = (hueScan.crlf == 4);
+    return true;
+  }
+  uint8_t top = hueScan.depth -1;
+  if (hueScan.inString) {
+    if (hueScan.escape) hueScan.escape = false;
+    else if (c == '\\') { hueScan.escape = true; return true; }
+    else if (c == '"') {
+      hueScan.inString = false;
+      hueScan.tok[hueScan.tokLen] = 0;
+      if (hueScan.expectKey && top < HUE_SCAN_DEPTH) strlcpy(hueScan.key[top], hueScan.tok, HUE_SCAN_KEY); //longer keys are of no interest
+      else if (!hueScan.expectKey) hueValue(hueScan.tok);
+      hueScan.tokLen = 0;
+      return true;
     }
-    
-    int hueErrorCode = root[0][F("error")][F("type")];
+    if (hueScan.tokLen < sizeof(hueScan.tok) -1) hueScan.tok[hueScan.tokLen++] = c;
+    return true;
+  }
+  switch (c) {
+    case '"': hueScan.inString = true; hueScan.tokLen = 0; break;
+    case '{': case '[':
+      if (hueScan.depth < HUE_SCAN_DEPTH) {
+        hueScan.open[hueScan.depth] = c;
+        hueScan.key[hueScan.depth][0] = 0;
+        hueScan.index[hueScan.depth] = 0;
+      }
+      hueScan.depth++;
+      hueScan.expectKey = (c == '{');
+      break;
+    case '}': case ']':
+      hueFlushToken();
+      if (!hueScan.depth) return false;
+      hueScan.depth--;
+      if (!hueScan.depth) return false;
+      hueScan.expectKey = false;
+      break;
+    case ',':
+      hueFlushToken();
+      if (top < HUE_SCAN_DEPTH) {
+        if (hueScan.open[top] == '{') hueScan.expectKey = true;
+        else hueScan.index[top]++;
+      }
+      break;
+    case ':': hueScan.expectKey = false; break;
+    case ' ': case '\t': case '\r': case '\n': break;
+    default:
+      if (hueScan.depth && hueScan.tokLen < sizeof(hueScan.tok) -1) hueScan.tok[hueScan.tokLen++] = c;
+  }
+  return true;
+}
+
+static void applyHueResponse()
+{
+  if (hueScan.isArray) {
+    int hueErrorCode = hueScan.errorType;
     if (hueErrorCode)//hue bridge returned error
     {
       hueError = hueErrorCode;
@@ -111,61 +225,35 @@ void onHueData(void* arg, AsyncClient* client, void *data, size_t len)
         case 3:   huePollingEnabled = false; break; //Invalid light ID
         case 101: hueAuthRequired = true;    break; //link button not presset
       }
+      hueRequestLen = 0;
       return;
     }
-    
-    if (hueAuthRequired)
+
+    if (hueAuthRequired && hueScan.username[0])
     {
-      const char* apikey = root[0][F("success")][F("username")];
-      if (apikey != nullptr && strlen(apikey) < sizeof(hueApiKey))
-      {
-        strlcpy(hueApiKey, apikey, sizeof(hueApiKey));
-        hueAuthRequired = false;
-        hueNewKey = true;
-      }
+      strlcpy(hueApiKey, hueScan.username, sizeof(hueApiKey));
+      hueAuthRequired = false;
+      hueNewKey = true;
+      hueRequestLen = 0;
     }
     return;
   }
 
-  //else, assume it is JSON object, look for state and only parse that
-  str = strstr(str,"state");
-  if (str == nullptr) return;
-  str = strstr(str,"{");
-  
-  auto error = deserializeJson(root, str);
-  if (error)
-  {
-    hueError = HUE_ERROR_JSON_PARSING; return;
-  }
-
-  float hueX=0, hueY=0;
+  uint16_t hueX=0, hueY=0;
   uint16_t hueHue=0, hueCt=0;
   byte hueBri=0, hueSat=0, hueColormode=0;
 
-  if (root["on"]) {
-    if (root.containsKey("bri")) //Dimmable device
+  if (hueScan.on) {
+    if (hueScan.hasBri) //Dimmable device
     {
-      hueBri = root["bri"];
+      hueBri = hueScan.bri;
       hueBri++;
-      const char* cm =root[F("colormode")];
-      if (cm != nullptr) //Color device
-      {
-        if (strstr(cm,("ct")) != nullptr) //ct mode
-        {
-          hueCt = root["ct"];
-          hueColormode = 3;
-        } else if (strstr(cm,"xy") != nullptr) //xy mode
-        {
-          hueX = root["xy"][0]; // 0.5051
-          hueY = root["xy"][1]; // 0.4151
-          hueColormode = 1;
-        } else //hs mode
-        {
-          hueHue = root["hue"];
-          hueSat = root[F("sat")];
-          hueColormode = 2;
-        }
-      }
+      hueColormode = hueScan.colormode; //0: no color device
+      hueCt = hueScan.ct;
+      hueX = hueScan.x; // 5051
+      hueY = hueScan.y; // 4151
+      hueHue = hueScan.hue;
+      hueSat = hueScan.sat;
     } else //On/Off device
     {
       hueBri = briLast;
@@ -202,6 +290,17 @@ void onHueData(void* arg, AsyncClient* client, void *data, size_t len)
   }
   hueReceived = true;
 }
+
+void onHueData(void* arg, AsyncClient* client, void *data, size_t len)
+{
+  const char* str = (const char*)data;
+  for (size_t i = 0; i < len && !hueScan.done; i++) {
+    if (!hueScanChar(str[i])) {
+      hueScan.done = true;
+      applyHueResponse();
+    }
+  }
+}
 #else
 void handleHue(){}
 void reconnectHue(){}
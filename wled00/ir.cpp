@@ -6,8 +6,20 @@
 
 #if defined(WLED_DISABLE_INFRARED)
 void handleIR(){}
+void dropIRTable(){}
+bool irWantsRmt(int8_t pin, byte type) { return false; }
 #else
 
+/*
+ * On ESP32 the built-in remotes (all NEC) are received by an RMT channel: the pulses are timed by the hardware
+ * and handleIR() only decodes complete frames, instead of an interrupt on every edge that delays LED output.
+ * The ESP32 and S2 receive on the last transmit channel, which is only taken while the LEDs leave it free
+ * (see PolyBus::rmtRxWanted()). Otherwise, and for other protocols (ir.json), IRremoteESP8266 is used.
+ */
+#if defined(ARDUINO_ARCH_ESP32) && !defined(WLED_DISABLE_IR_RMT)
+  #define WLED_IR_RMT
+#endif
+
 IRrecv* irrecv;
 //change pin in NpbWrapper.h
 
@@ -110,11 +122,11 @@ void changePalette(uint8_t pal)
     for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
       WS2812FX::Segment& seg = strip.getSegment(i);
       if (!seg.isActive() || !seg.isSelected()) continue;
-      seg.palette = pal;
+      seg.setPalette(pal);
     }
     setValuesFromFirstSelectedSeg();
   } else {
-    strip.getMainSegment().palette = pal;
+    strip.getMainSegment().setPalette(pal);
     setValuesFromMainSeg();
   }
   stateChanged = true;
@@ -129,11 +141,11 @@ void changeEffectSpeed(int8_t amount)
       for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isActive() || !seg.isSelected()) continue;
-        seg.speed = effectSpeed;
+        seg.setSpeed(effectSpeed);
       }
       setValuesFromFirstSelectedSeg();
     } else {
-      strip.getMainSegment().speed = effectSpeed;
+      strip.getMainSegment().setSpeed(effectSpeed);
       setValuesFromMainSeg();
     }
   } else { // if Effect == "solid Color", change the hue of the primary color
@@ -153,10 +165,12 @@ void changeEffectSpeed(int8_t amount)
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isActive() || !seg.isSelected()) continue;
         seg.colors[0] = RGBW32(fastled_col.red, fastled_col.green, fastled_col.blue, W(sseg.colors[0]));
+        seg.touch(SEG_DIFFERS_COL);
       }
       setValuesFromFirstSelectedSeg();
     } else {
       strip.getMainSegment().colors[0] = RGBW32(fastled_col.red, fastled_col.green, fastled_col.blue, W(sseg.colors[0]));
+      strip.getMainSegment().touch(SEG_DIFFERS_COL);
       setValuesFromMainSeg();
     }
   }
@@ -176,11 +190,11 @@ void changeEffectIntensity(int8_t amount)
       for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isActive() || !seg.isSelected()) continue;
-        seg.intensity = effectIntensity;
+        seg.setIntensity(effectIntensity);
       }
       setValuesFromFirstSelectedSeg();
     } else {
-      strip.getMainSegment().speed = effectIntensity;
+      strip.getMainSegment().setSpeed(effectIntensity);
       setValuesFromMainSeg();
     }
   } else { // if Effect == "solid Color", change the saturation of the primary color
@@ -198,10 +212,12 @@ void changeEffectIntensity(int8_t amount)
         WS2812FX::Segment& seg = strip.getSegment(i);
         if (!seg.isActive() || !seg.isSelected()) continue;
         seg.colors[0] = RGBW32(fastled_col.red, fastled_col.green, fastled_col.blue, W(sseg.colors[0]));
+        seg.touch(SEG_DIFFERS_COL);
       }
       setValuesFromFirstSelectedSeg();
     } else {
       strip.getMainSegment().colors[0] = RGBW32(fastled_col.red, fastled_col.green, fastled_col.blue, W(sseg.colors[0]));
+      strip.getMainSegment().touch(SEG_DIFFERS_COL);
       setValuesFromMainSeg();
     }
   }
@@ -630,32 +646,195 @@ Sample:
                "label": "Preset 1, fallback to Saw - Party if not found"},
 }
 */
-void decodeIRJson(uint32_t code) 
+/*
+ * ir.json is read once into a hash table of codes, so a key press is a lookup instead of a file search and a
+ * JSON parse. HTTP commands are kept as strings with the "win&" prefix, JSON commands as MessagePack.
+ * The table is dropped when ir.json is uploaded. If ir.json does not fit into the JSON buffer, codes are
+ * looked up in the file as before.
+ */
+#define IR_CMD_NONE     0
+#define IR_CMD_HTTP     1
+#define IR_CMD_JSON     2
+#define IR_CMD_INCBRI   3
+#define IR_CMD_DECBRI   4
+#define IR_CMD_PRESETFB 5
+
+#define IR_TABLE_UNLOADED 0
+#define IR_TABLE_LOADED   1
+#define IR_TABLE_NOFILE   2
+#define IR_TABLE_TOOLARGE 3
+
+struct IRCommand {
+  uint32_t code;
+  uint16_t off, len; //command in irPool
+  uint8_t  type;     //IR_CMD_..., IR_CMD_NONE: free slot
+  bool     rpt;
+  uint8_t  pl, fp;   //!presetFallback arguments
+  int16_t  fx;       //-1: random
+};
+
+static IRCommand* irTable = nullptr;
+static uint16_t   irTableMask = 0;  //capacity -1, a power of 2
+static char*      irPool = nullptr;
+static uint8_t    irTableState = IR_TABLE_UNLOADED;
+
+void dropIRTable()
+{
+  free(irTable); irTable = nullptr;
+  free(irPool);  irPool = nullptr;
+  irTableState = IR_TABLE_UNLOADED;
+}
+
+static inline uint16_t irHash(uint32_t code)
+{
+  return (code * 2654435761UL) >> 16;
+}
+
+static IRCommand* findIRCommand(uint32_t code)
+{
+  if (!irTable) return nullptr;
+  for (uint16_t i = irHash(code) & irTableMask;; i = (i + 1) & irTableMask) { //never full
+    if (irTable[i].type == IR_CMD_NONE) return nullptr;
+    if (irTable[i].code == code) return &irTable[i];
+  }
+}
+
+//size of the command in the pool, 0 if it has none
+static size_t irCommandSize(JsonObject entry, uint8_t& type)
+{
+  JsonVariant cmd = entry["cmd"];
+  if (cmd.is<JsonObject>()) { type = IR_CMD_JSON; return measureMsgPack(cmd); }
+  const char* str = cmd | "";
+  if (str[0] == '!') {
+    if      (!strncmp_P(str, PSTR("!incBri"), 7))  type = IR_CMD_INCBRI;
+    else if (!strncmp_P(str, PSTR("!decBri"), 7))  type = IR_CMD_DECBRI;
+    else if (!strncmp_P(str, PSTR("!presetF"), 8)) type = IR_CMD_PRESETFB;
+    else type = IR_CMD_NONE;
+    return 0;
+  }
+  type = IR_CMD_HTTP;
+  return strlen(str) + (strncmp_P(str, PSTR("win&"), 4) ? 4 : 0) + 1;
+}
+
+//uses the JSON buffer, which the caller holds
+static void loadIRTable(JsonDocument* doc)
+{
+  File irFile = WLED_FS.open("/ir.json", "r");
+  if (!irFile) { irTableState = IR_TABLE_NOFILE; return; }
+  doc->clear();
+  DeserializationError err = deserializeJson(*doc, irFile);
+  irFile.close();
+  if (err || doc->overflowed()) { irTableState = IR_TABLE_TOOLARGE; return; }
+
+  JsonObject root = doc->as<JsonObject>();
+  size_t count = 0, poolSize = 0;
+  for (JsonPair kv : root) {
+    uint8_t type;
+    poolSize += irCommandSize(kv.value(), type);
+    if (type != IR_CMD_NONE) count++;
+  }
+  uint16_t cap = 4;
+  while (cap < 2 * count) cap <<= 1;
+  irTable = (IRCommand*)calloc(cap, sizeof(IRCommand));
+  irPool = poolSize ? (char*)malloc(poolSize) : nullptr;
+  if (!irTable || (poolSize && !irPool) || poolSize > UINT16_MAX) { dropIRTable(); irTableState = IR_TABLE_TOOLARGE; return; }
+  irTableMask = cap - 1;
+
+  size_t off = 0;
+  for (JsonPair kv : root) {
+    JsonObject entry = kv.value();
+    uint8_t type;
+    size_t len = irCommandSize(entry, type);
+    if (type == IR_CMD_NONE) continue;
+    uint32_t code = strtoul(kv.key().c_str(), nullptr, 16);
+    if (findIRCommand(code)) continue; //the first entry for a code wins, like the search in the file
+    uint16_t i = irHash(code) & irTableMask;
+    while (irTable[i].type != IR_CMD_NONE) i = (i + 1) & irTableMask;
+    IRCommand* c = &irTable[i];
+
+    c->code = code;
+    c->type = type;
+    c->off = off;
+    c->len = len;
+    c->rpt = entry["rpt"];
+    c->pl = entry["PL"] | 1;
+    c->fx = entry["FX"] | -1;
+    c->fp = entry["FP"] | 0;
+    if (type == IR_CMD_JSON) serializeMsgPack(entry["cmd"], irPool + off, len);
+    if (type == IR_CMD_HTTP) {
+      const char* str = entry["cmd"];
+      if (strncmp_P(str, PSTR("win&"), 4)) { strcpy_P(irPool + off, PSTR("win&")); strcpy(irPool + off + 4, str); }
+      else strcpy(irPool + off, str);
+      if (str[0] != '~') c->rpt = true; //as String::indexOf("~") was used as a condition
+    }
+    off += len;
+  }
+  irTableState = IR_TABLE_LOADED;
+  DEBUG_PRINTF("IR table: %u codes\n", count);
+}
+
+//runs an HTTP API command, adding the main segment unless the command applies to all selected ones
+static void applyIRHttp(String cmdStr)
+{
+  if (!irApplyToAllSelected && cmdStr.indexOf(F("SS="))<0) {
+    char tmp[10];
+    sprintf_P(tmp, PSTR("&SS=%d"), strip.getMainSegmentId());
+    cmdStr += tmp;
+  }
+  handleSet(nullptr, cmdStr, false);                             // no stateUpdated() call here
+}
+
+//a JSON command: applied as state, or saving a preset with the IR preset name
+static void applyIRJson(JsonObject jsonCmdObj, JsonObject fdo)
+{
+  // command is JSON object (TODO: currently will not handle irApplyToAllSelected correctly)
+  if (jsonCmdObj[F("psave")].isNull()) deserializeState(jsonCmdObj, CALL_MODE_BUTTON_PRESET);
+  else {
+    uint8_t psave = jsonCmdObj[F("psave")].as<int>();
+    char pname[33];
+    sprintf_P(pname, PSTR("IR Preset %d"), psave);
+    fdo.clear();
+    if (psave > 0 && psave < 251) savePreset(psave, pname, fdo);
+  }
+}
+
+static void applyIRCommand(uint32_t code, const IRCommand& c, JsonDocument* doc)
+{
+  switch (c.type) {
+    case IR_CMD_INCBRI: lastValidCode = code; incBrightness(); break;
+    case IR_CMD_DECBRI: lastValidCode = code; decBrightness(); break;
+    case IR_CMD_PRESETFB: presetFallback(c.pl, c.fx < 0 ? random8(MODE_COUNT -1) : c.fx, c.fp); break;
+    case IR_CMD_HTTP:
+      if (c.rpt) lastValidCode = code;                           // repeatable action
+      applyIRHttp(String(irPool + c.off));
+      break;
+    case IR_CMD_JSON:
+      doc->clear();
+      if (deserializeMsgPack(*doc, (const uint8_t*)irPool + c.off, c.len)) break;
+      applyIRJson(doc->as<JsonObject>(), doc->as<JsonObject>());
+      break;
+  }
+}
+
+//looks the code up in ir.json itself, if it is too large for the table
+static void decodeIRJsonFile(uint32_t code, JsonDocument* doc)
 {
   char objKey[10];
   String cmdStr;
   JsonObject fdo;
   JsonObject jsonCmdObj;
 
-  #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-  #else
-  if (!requestJSONBufferLock(13)) return;
-  #endif
-
   sprintf_P(objKey, PSTR("\"0x%lX\":"), (unsigned long)code);
 
   // attempt to read command from ir.json
   // this may fail for two reasons: ir.json does not exist or IR code not found
   // if the IR code is not found readObjectFromFile() will clean() doc JSON document
   // so we can differentiate between the two
-  readObjectFromFile("/ir.json", objKey, &doc);
-  fdo = doc.as<JsonObject>();
-  lastValidCode = 0;
+  readObjectFromFile("/ir.json", objKey, doc);
+  fdo = doc->as<JsonObject>();
   if (fdo.isNull()) {
     //the received code does not exist
     if (!WLED_FS.exists("/ir.json")) errorFlag = ERR_FS_IRLOAD; //warn if IR file itself doesn't exist
-    releaseJSONBufferLock();
     return;
   }
 
@@ -683,32 +862,123 @@ void decodeIRJson(uint32_t code)
       String apireq = "win"; apireq += '&';                        // reduce flash string usage
       if (cmdStr.indexOf("~") || fdo["rpt"]) lastValidCode = code; // repeatable action
       if (!cmdStr.startsWith(apireq)) cmdStr = apireq + cmdStr;    // if no "win&" prefix
-      if (!irApplyToAllSelected && cmdStr.indexOf(F("SS="))<0) {
-        char tmp[10];
-        sprintf_P(tmp, PSTR("&SS=%d"), strip.getMainSegmentId());
-        cmdStr += tmp;
-      }
       fdo.clear();                                                 // clear JSON buffer (it is no longer needed)
-      handleSet(nullptr, cmdStr, false);                           // no stateUpdated() call here
+      applyIRHttp(cmdStr);
     }
   } else {
-    // command is JSON object (TODO: currently will not handle irApplyToAllSelected correctly)
-    if (jsonCmdObj[F("psave")].isNull()) deserializeState(jsonCmdObj, CALL_MODE_BUTTON_PRESET);
-    else {
-      uint8_t psave = jsonCmdObj[F("psave")].as<int>();
-      char pname[33];
-      sprintf_P(pname, PSTR("IR Preset %d"), psave);
-      fdo.clear();
-      if (psave > 0 && psave < 251) savePreset(psave, pname, fdo);
-    }
+    applyIRJson(jsonCmdObj, fdo);
+  }
+}
+
+void decodeIRJson(uint32_t code) 
+{
+  lastValidCode = 0;
+  if (irTableState == IR_TABLE_LOADED) { //no JSON buffer needed for most commands
+    IRCommand* c = findIRCommand(code);
+    if (!c) return;
+    if (c->type != IR_CMD_JSON) { applyIRCommand(code, *c, nullptr); return; }
+  } else if (irTableState == IR_TABLE_NOFILE) {
+    errorFlag = ERR_FS_IRLOAD;
+    return;
+  }
+
+  #ifdef WLED_USE_DYNAMIC_JSON
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  #else
+  if (!requestJSONBufferLock(13)) return;
+  #endif
+
+  if (irTableState == IR_TABLE_UNLOADED) loadIRTable(&doc);
+  if (irTableState == IR_TABLE_LOADED) {
+    IRCommand* c = findIRCommand(code);
+    if (c) applyIRCommand(code, *c, &doc);
+  } else if (irTableState == IR_TABLE_NOFILE) {
+    errorFlag = ERR_FS_IRLOAD;
+  } else {
+    decodeIRJsonFile(code, &doc);
   }
   releaseJSONBufferLock();
 }
 
+bool irWantsRmt(int8_t pin, byte type)
+{
+  #ifdef WLED_IR_RMT
+  return pin >= 0 && type > 0 && type < 8;
+  #else
+  return false;
+  #endif
+}
+
+#ifdef WLED_IR_RMT
+#define IR_RMT_IDLE_US 12000 // silence ending a frame, NEC frames are 108 ms apart
+
+static RingbufHandle_t irRing = nullptr;
+
+static bool initIRRmt()
+{
+  if (!irWantsRmt(irPin, irEnabled) || !PolyBus::rmtRxFree(PolyBus::rmtPlan())) return false;
+  rmt_config_t config = RMT_DEFAULT_CONFIG_RX((gpio_num_t)irPin, (rmt_channel_t)WLED_RMT_RX_CHANNEL);
+  config.clk_div = 80; // 1 us ticks
+  config.mem_block_num = 1; // 64 items, a NEC frame has 34
+  config.rx_config.filter_en = true;
+  config.rx_config.filter_ticks_thresh = 200; // glitches below 2.5 us (APB clock ticks)
+  config.rx_config.idle_threshold = IR_RMT_IDLE_US;
+  if (rmt_config(&config) != ESP_OK) return false;
+  if (rmt_driver_install(config.channel, 1024, 0) != ESP_OK) return false;
+  rmt_get_ringbuf_handle(config.channel, &irRing);
+  rmt_rx_start(config.channel, true);
+  PolyBus::rmtRxActive() = true;
+  DEBUG_PRINTLN(F("IR: RMT receive"));
+  return true;
+}
+
+static bool irPulse(uint16_t us, uint16_t expected)
+{
+  return us > expected * 7 / 10 && us < expected * 13 / 10;
+}
+
+//NEC frame (marks are the low level of the receiver), 0xFFFFFFFF for a repeat, 0 if not NEC
+static uint32_t decodeIRFrame(const rmt_item32_t* items, size_t count)
+{
+  if (count < 2 || !irPulse(items[0].duration0, 9000)) return 0;
+  if (irPulse(items[0].duration1, 2250)) return 0xFFFFFFFF;
+  if (count < 33 || !irPulse(items[0].duration1, 4500)) return 0;
+  uint32_t code = 0;
+  for (uint8_t i = 1; i <= 32; i++) {
+    if (!irPulse(items[i].duration0, 560)) return 0;
+    if      (irPulse(items[i].duration1, 1690)) code = (code << 1) | 1; // first bit received is the MSB, as IRremoteESP8266
+    else if (irPulse(items[i].duration1, 560))  code = code << 1;
+    else return 0;
+  }
+  return code;
+}
+
+//decodes the frames received since the last check in order, false if IR is not received by RMT
+static bool handleIRRmt()
+{
+  if (!irRing) return false;
+  if (!PolyBus::rmtRxActive()) { irRing = nullptr; return false; } // channel taken by the LEDs
+  size_t len;
+  rmt_item32_t* items;
+  while ((items = (rmt_item32_t*)xRingbufferReceive(irRing, &len, 0)) != nullptr) {
+    uint32_t code = decodeIRFrame(items, len / sizeof(rmt_item32_t));
+    vRingbufferReturnItem(irRing, items);
+    if (!code) continue;
+    if (!pinManager.isPinAllocated(1) || pinManager.getPinOwner(1) == PinOwner::DebugOut) //GPIO 1 - Serial TX pin
+      Serial.printf_P(PSTR("IR recv: 0x%lX\n"), (unsigned long)code);
+    decodeIR(code);
+  }
+  return true;
+}
+#endif
+
 void initIR()
 {
   if (irEnabled > 0)
   {
+    #ifdef WLED_IR_RMT
+    if (initIRRmt()) return;
+    #endif
     irrecv = new IRrecv(irPin);
     irrecv->enableIRIn();
   }
@@ -721,6 +991,9 @@ void handleIR()
     irCheckedTime = millis();
     if (irEnabled > 0)
     {
+      #ifdef WLED_IR_RMT
+      if (handleIRRmt()) return;
+      #endif
       if (irrecv == NULL)
       { 
         initIR(); return;
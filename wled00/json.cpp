@@ -1,6 +1,7 @@
 #include "wled.h"
 
 #include "palettes.h"
+#include <memory>
 
 /*
  * JSON API (De)serialization
@@ -27,9 +28,9 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
   if (id >= strip.getMaxSegments()) return;
 
   WS2812FX::Segment& seg = strip.getSegment(id);
-  WS2812FX::Segment prev = seg; //make a backup so we can tell if something changed
+  seg.changed = 0; //the setters tell what changed
 
-  uint16_t start = elem["start"] | seg.start;
+  pixidx_t start = elem["start"] | seg.start;
   int stop = elem["stop"] | -1;
   if (stop < 0) {
     uint16_t len = elem["len"];
@@ -56,6 +57,7 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
 
   if (elem["n"]) {
     // name field exists
+    seg.touch(0);
     if (seg.name) { //clear old name
       delete[] seg.name;
       seg.name = nullptr;
@@ -95,6 +97,25 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
   if (stop > start && of > len -1) of = len -1;
   strip.setSegment(id, start, stop, grp, spc, of);
 
+  // matrix: columns as wired, rotation in quarter turns, serpentine and column-first wiring
+  uint16_t w = elem["w"] | seg.width;
+  uint8_t rot = elem[F("rot")] | (seg.layout2D & SEG2D_ROTATION);
+  bool srp  = elem[F("srp")]  | bool(seg.layout2D & SEG2D_SERPENTINE);
+  bool vert = elem[F("vert")] | bool(seg.layout2D & SEG2D_VERTICAL);
+  strip.setSegment2D(id, w, (rot & SEG2D_ROTATION) | (srp ? SEG2D_SERPENTINE : 0) | (vert ? SEG2D_VERTICAL : 0));
+  strip.setRenderScale(id, elem["rs"] | seg.renderScale); // effect resolution 1/1, 1/2 or 1/4
+  strip.setSegmentLayer(id, elem["z"] | seg.layer, elem["bm"] | seg.blendMode); // compositing order and blend mode
+  int link = elem["lk"] | (seg.link ? seg.link - 1 : -1); // segment whose effect continues over this one, -1: none
+  strip.setSegmentLink(id, link < 0 ? 255 : link);
+  int proto = elem["in"] | (seg.instanceOf ? seg.instanceOf - 1 : -1); // segment whose rendered pixels this one copies, -1: none
+  strip.setSegmentInstance(id, proto < 0 ? 255 : proto);
+  bool live = elem["lv"] | (bool)seg.live; // realtime input layer
+  if (live != (bool)seg.live) {
+    seg.live = live;
+    seg.touch(SEG_DIFFERS_OPT);
+    if (realtimeMode && !realtimeOverride) seg.setOption(SEG_OPTION_FREEZE, live, id);
+  }
+
   byte segbri = seg.opacity;
   if (getVal(elem["bri"], &segbri)) {
     if (segbri > 0) seg.setOpacity(segbri, id);
@@ -169,9 +190,12 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
   }
 
   //getVal also supports inc/decrementing and random
-  getVal(elem[F("sx")], &seg.speed, 0, 255);
-  getVal(elem[F("ix")], &seg.intensity, 0, 255);
-  getVal(elem["pal"], &seg.palette, 1, strip.getPaletteCount());
+  byte sx = seg.speed, ix = seg.intensity, pal = seg.palette;
+  if (getVal(elem[F("sx")], &sx, 0, 255)) seg.setSpeed(sx);
+  if (getVal(elem[F("ix")], &ix, 0, 255)) seg.setIntensity(ix);
+  uint8_t fps = elem[F("fps")] | seg.fps;
+  if (fps != seg.fps) { seg.fps = fps; seg.touch(SEG_DIFFERS_FX); }
+  if (getVal(elem["pal"], &pal, 1, strip.getPaletteCount())) seg.setPalette(pal);
 
   JsonArray iarr = elem[F("i")]; //set individual LEDs
   if (!iarr.isNull()) {
@@ -231,16 +255,154 @@ void deserializeSegment(JsonObject elem, byte it, byte presetId)
 //  } else if (!elem["frz"] && iarr.isNull()) { //return to regular effect
 //    seg.setOption(SEG_OPTION_FREEZE, false);
   }
-  // send UDP if not in preset and something changed that is not just selection
-  //if (!presetId && (seg.differs(prev) & 0x7F)) stateChanged = true;
   // send UDP if something changed that is not just selection
-  if (seg.differs(prev) & 0x7F) stateChanged = true;
+  if (seg.changed & ~SEG_DIFFERS_SEL) stateChanged = true;
   return;
 }
 
+/*
+ * Streamed state for payloads too large for a JsonDocument (presets with many segments, large POSTs).
+ * The state is read twice: once into the document without "seg", then the segments are read from the
+ * stream one at a time, so memory is bounded by one segment instead of the whole request.
+ */
+#ifndef JSON_SEGMENT_DOC_SIZE
+  #ifdef ESP8266
+  #define JSON_SEGMENT_DOC_SIZE 2048
+  #else
+  #define JSON_SEGMENT_DOC_SIZE 4096
+  #endif
+#endif
+
+static Stream* segmentStream = nullptr; // set by deserializeStateStream(), "seg" is read from it instead of from root
+
+//Stream over a buffer with the File position()/seek() calls, for deserializeStateStream()
+class JsonBufferStream : public Stream {
+  public:
+  JsonBufferStream(const uint8_t* data, size_t len) : _data(data), _len(len), _pos(0) {}
+  int    available() { return _len - _pos; }
+  int    read()      { return _pos < _len ? _data[_pos++] : -1; }
+  int    peek()      { return _pos < _len ? _data[_pos] : -1; }
+  size_t write(uint8_t) { return 0; }
+  size_t readBytes(char* buf, size_t n) { n = min(n, _len - _pos); memcpy(buf, _data + _pos, n); _pos += n; return n; }
+  size_t position()  { return _pos; }
+  bool   seek(size_t pos) { if (pos > _len) return false; _pos = pos; return true; }
+  private:
+  const uint8_t* _data;
+  size_t _len, _pos;
+};
+
+//moves the stream to the value of the top level "seg" key, the stream is at the opening brace of the state
+static bool findSegmentValue(Stream& in)
+{
+  uint8_t depth = 0;
+  bool inString = false, escaped = false, expectKey = false, isKey = false, segKey = false;
+  char key[4]; uint8_t keyLen = 0;
+  for (int c = in.read(); c >= 0; c = in.read()) {
+    if (inString) {
+      if (escaped) escaped = false;
+      else if (c == '\\') escaped = true;
+      else if (c == '"') { inString = false; if (isKey) segKey = (keyLen == 3 && !strncmp_P(key, PSTR("seg"), 3)); }
+      else if (isKey && keyLen < sizeof(key)) key[keyLen++] = c;
+      continue;
+    }
+    switch (c) {
+      case '"': inString = true; isKey = (depth == 1 && expectKey); keyLen = 0; break;
+      case '{': case '[': depth++; expectKey = (depth == 1); break;
+      case '}': case ']': if (--depth == 0) return false; break;
+      case ':': if (depth == 1) { if (segKey) return true; expectKey = false; } break;
+      case ',': if (depth == 1) expectKey = true; break;
+    }
+  }
+  return false;
+}
+
+static void skipSpaces(Stream& in)
+{
+  while (in.peek() == ' ' || in.peek() == '\n' || in.peek() == '\r' || in.peek() == '\t') in.read();
+}
+
+//a segment object without array position, applies to the segment with its id or to all selected ones
+static void deserializeSegmentObject(JsonObject segVar, byte presetId)
+{
+  int id = segVar["id"] | -1;
+  //if "seg" is not an array and ID not specified, apply to all selected/checked segments
+  if (id < 0) {
+    //apply all selected segments
+    bool didSet = false;
+    for (byte s = 0; s < strip.getMaxSegments(); s++) {
+      WS2812FX::Segment &sg = strip.getSegment(s);
+      if (sg.isActive()) {
+        if (sg.isSelected()) {
+          deserializeSegment(segVar, s, presetId);
+          didSet = true;
+        }
+      }
+    }
+    //if none selected, apply to the main segment
+    if (!didSet) deserializeSegment(segVar, strip.getMainSegmentId(), presetId);
+  } else {
+    deserializeSegment(segVar, id, presetId); //apply only the segment with the specified ID
+  }
+}
+
+//"seg" from segmentStream, one object at a time
+static void deserializeSegmentStream(Stream& in, byte presetId)
+{
+  if (!findSegmentValue(in)) return;
+  skipSpaces(in);
+  DynamicJsonDocument segDoc(JSON_SEGMENT_DOC_SIZE);
+  if (in.peek() == '{') {
+    if (deserializeJson(segDoc, in) != DeserializationError::Ok) return;
+    deserializeSegmentObject(segDoc.as<JsonObject>(), presetId);
+    return;
+  }
+  if (in.read() != '[') return;
+  for (int it = 0; ; it++) {
+    skipSpaces(in);
+    if (in.peek() == ']') return;
+    DeserializationError error = deserializeJson(segDoc, in);
+    if (error && error != DeserializationError::NoMemory) return; //a segment too large is applied as far as it was read
+    deserializeSegment(segDoc.as<JsonObject>(), it, presetId);
+    skipSpaces(in);
+    if (in.read() != ',') return; //']' or broken
+  }
+}
+
+//doc is used for the state without segments (it is cleared), the stream is at the opening brace of the state
+template<class S> static bool deserializeStateStreamed(S& in, JsonDocument* doc, byte callMode, byte presetId)
+{
+  StaticJsonDocument<64> filter;
+  filter["*"] = true;
+  filter["seg"] = false;
+
+  size_t start = in.position();
+  DeserializationError error = deserializeJson(*doc, in, DeserializationOption::Filter(filter));
+  JsonObject root = doc->as<JsonObject>();
+  if (error || root.isNull()) return false;
+  if (presetId && root["ps"] == presetId) root.remove("ps"); //remove load request for same presets to prevent recursive crash
+
+  in.seek(start);
+  segmentStream = &in;
+  bool stateResponse = deserializeState(root, callMode, presetId);
+  segmentStream = nullptr;
+  return stateResponse;
+}
+
+bool deserializeStateStream(File& in, JsonDocument* doc, byte callMode, byte presetId)
+{
+  return deserializeStateStreamed(in, doc, callMode, presetId);
+}
+
+bool deserializeStateStream(const uint8_t* json, size_t len, JsonDocument* doc, byte callMode, byte presetId)
+{
+  JsonBufferStream in(json, len);
+  return deserializeStateStreamed(in, doc, callMode, presetId);
+}
+
 // deserializes WLED state (fileDoc points to doc object if called from web server)
 bool deserializeState(JsonObject root, byte callMode, byte presetId)
 {
+  RENDER_LOCK(); // may be called from network callbacks, do not change segments mid-frame
   bool stateResponse = root[F("v")] | false;
 
   bool onBefore = bri;
@@ -255,9 +417,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
     for (uint8_t s=0; s < strip.getMaxSegments(); s++) {
       strip.getSegment(s).setOption(SEG_OPTION_FREEZE, false, s);
     }
-    if (realtimeMode && !realtimeOverride && useMainSegmentOnly) { // keep live segment frozen if live
-      strip.getMainSegment().setOption(SEG_OPTION_FREEZE, true, strip.getMainSegmentId());
-    }
+    if (realtimeMode && !realtimeOverride) strip.freezeLiveSegments(true); // keep live segments frozen if live
   }
 
   int tr = -1;
@@ -282,6 +442,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
 
   tr = root[F("tb")] | -1;
   if (tr >= 0) strip.timebase = ((uint32_t)tr) - millis();
+  strip.effectSeed = root[F("seed")] | strip.effectSeed; // seeds the random numbers of effects, same on synced nodes
 
   JsonObject nl       = root["nl"];
   nightlightActive    = nl["on"]      | nightlightActive;
@@ -306,8 +467,8 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
 
   realtimeOverride = root[F("lor")] | realtimeOverride;
   if (realtimeOverride > 2) realtimeOverride = REALTIME_OVERRIDE_ALWAYS;
-  if (realtimeMode && useMainSegmentOnly) {
-    strip.getMainSegment().setOption(SEG_OPTION_FREEZE, !realtimeOverride, strip.getMainSegmentId());
+  if (realtimeMode) {
+    strip.freezeLiveSegments(!realtimeOverride);
   }
 
   if (root.containsKey("live")) {
@@ -322,27 +483,13 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
 
   int it = 0;
   JsonVariant segVar = root["seg"];
-  if (segVar.is<JsonObject>())
+  if (segmentStream) {
+    Stream* in = segmentStream;
+    segmentStream = nullptr; //a preset applied from here reads its own
+    deserializeSegmentStream(*in, presetId);
+  } else if (segVar.is<JsonObject>())
   {
-    int id = segVar["id"] | -1;
-    //if "seg" is not an array and ID not specified, apply to all selected/checked segments
-    if (id < 0) {
-      //apply all selected segments
-      bool didSet = false;
-      for (byte s = 0; s < strip.getMaxSegments(); s++) {
-        WS2812FX::Segment &sg = strip.getSegment(s);
-        if (sg.isActive()) {
-          if (sg.isSelected()) {
-            deserializeSegment(segVar, s, presetId);
-            didSet = true;
-          }
-        }
-      }
-      //if none selected, apply to the main segment
-      if (!didSet) deserializeSegment(segVar, strip.getMainSegmentId(), presetId);
-    } else {
-      deserializeSegment(segVar, id, presetId); //apply only the segment with the specified ID
-    }
+    deserializeSegmentObject(segVar, presetId);
   } else {
     JsonArray segs = segVar.as<JsonArray>();
     for (JsonObject elem : segs)
@@ -356,6 +503,12 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
 
   loadLedmap = root[F("ledmap")] | loadLedmap;
 
+  //preset banks, selected before saving so {"bank":2,"psave":5} saves to bank 2
+  if (root[F("bank")].is<int>()) setPresetBank(root[F("bank")]);
+  const char* bankName = root[F("bname")];
+  if (bankName) setPresetBankName(presetBank, bankName);
+  if (root[F("bdel")].is<int>()) deletePresetBank(root[F("bdel")]);
+
   byte ps = root[F("psave")];
   if (ps > 0) {
     savePreset(ps, nullptr, root);
@@ -365,11 +518,23 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
       deletePreset(ps);
     }
 
+    byte bank;
+    const char* psRef = root["ps"];
+    if (psRef && strchr(psRef, ':')) { //"bank:id"
+      if (parsePresetRef(root["ps"], &bank, &ps)) {
+        if (!presetId) unloadPlaylist();
+        applyPreset(ps, callMode, bank);
+      }
+      RENDER_UNLOCK();
+      return stateResponse;
+    }
+
     ps = presetCycCurr;
     if (getVal(root["ps"], &ps, presetCycMin, presetCycMax)) { //load preset (clears state request!)
       if (!presetId) unloadPlaylist(); //stop playlist if preset changed manually
       if (ps >= presetCycMin && ps <= presetCycMax) presetCycCurr = ps;
       applyPreset(ps, callMode);
+      RENDER_UNLOCK();
       return stateResponse;
     }
 
@@ -392,6 +557,7 @@ bool deserializeState(JsonObject root, byte callMode, byte presetId)
   }
 
   stateUpdated(callMode);
+  RENDER_UNLOCK();
 
   return stateResponse;
 }
@@ -407,11 +573,24 @@ void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool fo
   root["grp"] = seg.grouping;
   root[F("spc")] = seg.spacing;
   root[F("of")] = seg.offset;
+  root["w"] = seg.width;
+  if (seg.renderScale) root["rs"] = seg.renderScale;
+  if (seg.layer) root["z"] = seg.layer;
+  if (seg.blendMode) root["bm"] = seg.blendMode;
+  if (seg.live) root["lv"] = true;
+  if (seg.link) root["lk"] = seg.link - 1;
+  if (seg.instanceOf) root["in"] = seg.instanceOf - 1;
+  if (seg.width) {
+    root[F("rot")]  = seg.layout2D & SEG2D_ROTATION;
+    root[F("srp")]  = bool(seg.layout2D & SEG2D_SERPENTINE);
+    root[F("vert")] = bool(seg.layout2D & SEG2D_VERTICAL);
+  }
   root["on"] = seg.getOption(SEG_OPTION_ON);
   root["frz"] = seg.getOption(SEG_OPTION_FREEZE);
   byte segbri = seg.opacity;
   root["bri"] = (segbri) ? segbri : 255;
   root["cct"] = seg.cct;
+  root[F("fps")] = seg.fps;
 
   if (segmentBounds && seg.name != nullptr) root["n"] = reinterpret_cast<const char *>(seg.name); //not good practice, but decreases required JSON buffer
 
@@ -442,7 +621,7 @@ void serializeSegment(JsonObject& root, WS2812FX::Segment& seg, byte id, bool fo
   root[F("mi")]  = seg.getOption(SEG_OPTION_MIRROR);
 }
 
-void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds)
+void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segmentBounds, bool includeSegments)
 {
   if (includeBri) {
     root["on"] = (bri > 0);
@@ -455,6 +634,7 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
 
     root["ps"] = (currentPreset > 0) ? currentPreset : -1;
     root[F("pl")] = currentPlaylist;
+    root[F("bank")] = presetBank;
 
     usermods.addToJsonState(root);
 
@@ -477,6 +657,7 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 
   root[F("mainseg")] = strip.getMainSegmentId();
+  if (!includeSegments) return;
 
   JsonArray seg = root.createNestedArray("seg");
   for (byte s = 0; s < strip.getMaxSegments(); s++) {
@@ -491,6 +672,76 @@ void serializeState(JsonObject root, bool forPreset, bool includeBri, bool segme
   }
 }
 
+/*
+ * Binary state, the same content as /json/state without usermod and UDP fields, written without a JsonDocument.
+ * Multi-byte values are little endian. Header (BIN_STATE_HEADER_SIZE bytes):
+ *  0: 'S'  1: version  2: on  3: bri  4-5: transition (100 ms)  6: preset (255 none)  7: playlist (255 none)
+ *  8: nightlight on  9: nightlight duration (min)  10: nightlight mode  11: nightlight target bri  12: lor
+ * 13: main segment  14: number of segments  15: size of a segment record, followed by one record per active segment:
+ *  0: id  1-2: start  3-4: stop  5-6: offset  7: grouping  8: spacing  9: options (SEG_OPTION_ bits: sel, rev, on, mi, frz)
+ * 10: opacity  11: cct  12: fx  13: sx  14: ix  15: pal  16-27: colors, 3 x R G B W
+ * Fields are only ever appended, clients skip the rest of the header and records by the sizes given.
+ */
+#define BIN_STATE_VERSION     1
+#define BIN_STATE_HEADER_SIZE 16
+#define BIN_STATE_SEG_SIZE    28
+
+uint16_t getBinaryStateSize()
+{
+  return BIN_STATE_HEADER_SIZE + strip.getActiveSegmentsNum() * BIN_STATE_SEG_SIZE;
+}
+
+//buf needs getBinaryStateSize() bytes, returns the bytes written
+uint16_t serializeStateBinary(uint8_t* buf)
+{
+  buf[0]  = 'S';
+  buf[1]  = BIN_STATE_VERSION;
+  buf[2]  = (bri > 0);
+  buf[3]  = briLast;
+  buf[4]  = (transitionDelay/100) & 0xFF;
+  buf[5]  = (transitionDelay/100) >> 8;
+  buf[6]  = (currentPreset > 0) ? currentPreset : 255;
+  buf[7]  = (currentPlaylist > 0) ? currentPlaylist : 255;
+  buf[8]  = nightlightActive;
+  buf[9]  = nightlightDelayMins;
+  buf[10] = nightlightMode;
+  buf[11] = nightlightTargetBri;
+  buf[12] = realtimeOverride;
+  buf[13] = strip.getMainSegmentId();
+  buf[15] = BIN_STATE_SEG_SIZE;
+
+  uint8_t segs = 0;
+  uint8_t* p = buf + BIN_STATE_HEADER_SIZE;
+  for (uint8_t k = 0; k < strip.getActiveSegmentsNum(); k++) {
+    uint8_t s = strip.getActiveSegmentId(k);
+    WS2812FX::Segment &sg = strip.getSegment(s);
+    if (!sg.isActive()) continue;
+    p[0]  = s;
+    p[1]  = sg.start & 0xFF;  p[2] = sg.start >> 8;
+    p[3]  = sg.stop & 0xFF;   p[4] = sg.stop >> 8;
+    p[5]  = sg.offset & 0xFF; p[6] = sg.offset >> 8;
+    p[7]  = sg.grouping;
+    p[8]  = sg.spacing;
+    p[9]  = sg.options & 0x2F; // selected, reversed, on, mirror, freeze
+    p[10] = sg.opacity;
+    p[11] = sg.cct;
+    p[12] = sg.mode;
+    p[13] = sg.speed;
+    p[14] = sg.intensity;
+    p[15] = sg.palette;
+    for (uint8_t c = 0; c < 3; c++) {
+      p[16 + c*4] = R(sg.colors[c]);
+      p[17 + c*4] = G(sg.colors[c]);
+      p[18 + c*4] = B(sg.colors[c]);
+      p[19 + c*4] = W(sg.colors[c]);
+    }
+    p += BIN_STATE_SEG_SIZE;
+    segs++;
+  }
+  buf[14] = segs;
+  return p - buf;
+}
+
 //by https://github.com/tzapu/WiFiManager/blob/master/WiFiManager.cpp
 int getSignalQuality(int rssi)
 {
@@ -511,28 +762,97 @@ int getSignalQuality(int rssi)
     return quality;
 }
 
-void serializeInfo(JsonObject root)
+//info fields that only change with the build or the configuration (configVersion)
+static void serializeInfoStatic(JsonObject root)
 {
   root[F("ver")] = versionString;
   root[F("vid")] = VERSION;
   //root[F("cn")] = WLED_CODENAME;
+  root[F("name")] = serverDescription;
+  root[F("udpport")] = udpPort;
+  root[F("fxcount")] = strip.getModeCount();
+  root[F("palcount")] = strip.getPaletteCount();
+
+  #ifdef ARDUINO_ARCH_ESP32
+  root[F("arch")] = "esp32";
+  root[F("core")] = ESP.getSdkVersion();
+  root[F("lwip")] = 0; //deprecated
+  #else
+  root[F("arch")] = "esp8266";
+  root[F("core")] = ESP.getCoreVersion();
+  root[F("lwip")] = LWIP_VERSION_MAJOR;
+  #endif
+
+  byte os = 0;
+  #ifdef WLED_DEBUG
+  os  = 0x80;
+  #endif
+  #ifndef WLED_DISABLE_ALEXA
+  os += 0x40;
+  #endif
+  #ifndef WLED_DISABLE_BLYNK
+  os += 0x20;
+  #endif
+  #ifdef USERMOD_CRONIXIE
+  os += 0x10;
+  #endif
+  #ifndef WLED_DISABLE_FILESYSTEM
+  os += 0x08;
+  #endif
+  #ifndef WLED_DISABLE_HUESYNC
+  os += 0x04;
+  #endif
+  #ifdef WLED_ENABLE_ADALIGHT
+  os += 0x02;
+  #endif
+  #ifndef WLED_DISABLE_OTA
+  os += 0x01;
+  #endif
+  root[F("opt")] = os;
 
+  root[F("brand")] = "WLED";
+  root[F("product")] = F("FOSS");
+  root["mac"] = escapedMac;
+}
+
+static void serializeInfoDynamic(JsonObject root)
+{
   JsonObject leds = root.createNestedObject("leds");
   leds[F("count")] = strip.getLengthTotal();
 
   leds[F("pwr")] = strip.currentMilliamps;
   leds["fps"] = strip.getFps();
   leds[F("maxpwr")] = (strip.currentMilliamps)? strip.ablMilliampsMax : 0;
+  JsonArray bpwr = leds.createNestedArray(F("bpwr")); // estimated current per bus
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) bpwr.add(busses.getBus(b)->getCurrent());
+  JsonArray bstat = leds.createNestedArray(F("bstat")); // output statistics per bus, same order as bpwr
+  for (uint8_t b = 0; b < busses.getNumBusses(); b++) {
+    BusStats &st = busses.getBus(b)->getStats();
+    JsonObject bs = bstat.createNestedObject();
+    bs[F("show")]  = st.showTime; // µs spent in show()
+    bs[F("wire")]  = st.wireTime; // µs until the bus was ready for the next frame
+    bs[F("n")]     = st.frames;
+    bs[F("skip")]  = st.skipped;
+    bs[F("stall")] = st.stalls;
+  }
   leds[F("maxseg")] = strip.getMaxSegments();
+  JsonObject fxdata = leds.createNestedObject(F("fxdata")); // effect data memory in bytes
+  fxdata[F("used")] = strip.getUsedSegmentData();
+  fxdata[F("max")]  = strip.getMaxSegmentData();
+  fxdata[F("frag")] = strip.getSegmentDataFragmentation();
   //leds[F("seglock")] = false; //might be used in the future to prevent modifications to segment config
   
   uint8_t totalLC = 0;
   JsonArray lcarr = leds.createNestedArray(F("seglc"));
+  JsonArray segdata = fxdata.createNestedArray(F("seg"));
+  JsonArray segmiss = leds.createNestedArray(F("segmiss")); // effect calls more than one frame late, per segment
   uint8_t nSegs = strip.getLastActiveSegmentId();
   for (byte s = 0; s <= nSegs; s++) {
     uint8_t lc = strip.getSegment(s).getLightCapabilities();
     totalLC |= lc;
     lcarr.add(lc);
+    segdata.add(strip.getSegmentDataSize(s));
+    segmiss.add(strip.getSegmentMissedFrames(s));
   }
 
   leds["lc"] = totalLC;
@@ -543,8 +863,6 @@ void serializeInfo(JsonObject root)
 
   root[F("str")] = syncToggleReceive;
 
-  root[F("name")] = serverDescription;
-  root[F("udpport")] = udpPort;
   root["live"] = (bool)realtimeMode;
   root[F("liveseg")] = useMainSegmentOnly ? strip.getMainSegmentId() : -1;  // if using main segment only for live
   //root[F("mso")] = useMainSegmentOnly;  // using main segment only for live
@@ -559,6 +877,7 @@ void serializeInfo(JsonObject root)
     case REALTIME_MODE_ARTNET:   root["lm"] = F("Art-Net"); break;
     case REALTIME_MODE_TPM2NET:  root["lm"] = F("tpm2.net"); break;
     case REALTIME_MODE_DDP:      root["lm"] = F("DDP"); break;
+    case REALTIME_MODE_DMX:      root["lm"] = F("DMX"); break;
   }
 
   if (realtimeIP[0] == 0)
@@ -568,26 +887,76 @@ void serializeInfo(JsonObject root)
     root[F("lip")] = realtimeIP.toString();
   }
 
+  if (realtimeMode == REALTIME_MODE_E131 || realtimeMode == REALTIME_MODE_ARTNET) serializeE131Info(root);
+  if (realtimeMode) {
+    JsonObject rtl = root.createNestedObject(F("rtloop")); // us between polls of the realtime sources
+    rtl[F("avg")] = realtimeLoopAvg;
+    rtl[F("max")] = realtimeLoopMax;
+    realtimeLoopMax = 0;
+  }
+  JsonObject rts = root.createNestedObject(F("rts")); // realtime ingest since boot
+  rts["rx"]   = rtStats.rx;
+  rts[F("seq")]  = rtStats.seq;
+  rts[F("drop")] = rtStats.drop;
+  rts[F("push")] = rtStats.push;
+  if (repeatTargetCount) rts[F("fwd")] = rtStats.fwd;
+  rts[F("avg")]  = rtStats.procAvg; // us per packet
+  rts[F("max")]  = rtStats.procMax;
+  rtStats.procMax = 0;
+
+  serializeClockSync(root);
+  serializeRealtimeSources(root);
+
+  #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+  JsonObject aq = root.createNestedObject(F("aq")); // adaptive quality
+  aq[F("steps")] = strip.getQualitySteps();
+  aq["ft"]  = strip.getQualityFrameTime(); // µs between frames, smoothed, late frames only
+  aq[F("tgt")] = (1000U / strip.getTargetFps()) * 1000U; // frame time of the target FPS
+  JsonArray aqlog = aq.createNestedArray(F("log")); // latest decision first
+  for (uint8_t i = 0; i < strip.getQualityEventCount(); i++) {
+    const WS2812FX::quality_event& ev = strip.getQualityEvent(i);
+    static const char* const actions[] = {"hk", "thr", "xf"};
+    JsonObject e = aqlog.createNestedObject();
+    e["t"] = ev.time;
+    e["a"] = actions[ev.action];
+    if (ev.action == QUALITY_THROTTLE) e["s"] = ev.segment;
+    e["r"] = ev.restore;
+    e["ft"] = ev.frameUs;
+  }
+  #endif
+
+  #ifdef WLED_ENABLE_JITTER_BUFFER
+  JsonObject jb = root.createNestedObject(F("jb"));
+  jb["q"] = jbQueueDepth;
+  jb[F("late")] = jbLateFrames;
+  jb[F("drop")] = jbDroppedFrames;
+  #endif
+
   #ifdef WLED_ENABLE_WEBSOCKETS
   root[F("ws")] = ws.count();
+  serializeWsQueues(root);
   #else
   root[F("ws")] = -1;
   #endif
 
-  root[F("fxcount")] = strip.getModeCount();
-  root[F("palcount")] = strip.getPaletteCount();
-
   JsonObject wifi_info = root.createNestedObject("wifi");
   wifi_info[F("bssid")] = WiFi.BSSIDstr();
   int qrssi = WiFi.RSSI();
   wifi_info[F("rssi")] = qrssi;
   wifi_info[F("signal")] = getSignalQuality(qrssi);
   wifi_info[F("channel")] = WiFi.channel();
+  #ifdef WLED_ENABLE_FAST_RECONNECT
+  serializeWifiTiming(wifi_info);
+  #endif
+  #ifdef WLED_ENABLE_ESPNOW
+  serializeEspNow(root);
+  #endif
 
   JsonObject fs_info = root.createNestedObject("fs");
   fs_info["u"] = fsBytesUsed / 1000;
   fs_info["t"] = fsBytesTotal / 1000;
   fs_info[F("pmt")] = presetsModifiedTime;
+  serializeFSStats(fs_info);
 
   root[F("ndc")] = nodeListEnabled ? (int)Nodes.size() : -1;
   
@@ -596,62 +965,33 @@ void serializeInfo(JsonObject root)
     wifi_info[F("txPower")] = (int) WiFi.getTxPower();
     wifi_info[F("sleep")] = (bool) WiFi.getSleep();
   #endif
-  root[F("arch")] = "esp32";
-  root[F("core")] = ESP.getSdkVersion();
   //root[F("maxalloc")] = ESP.getMaxAllocHeap();
   #ifdef WLED_DEBUG
     root[F("resetReason0")] = (int)rtc_get_reset_reason(0);
     root[F("resetReason1")] = (int)rtc_get_reset_reason(1);
   #endif
-  root[F("lwip")] = 0; //deprecated
   #else
-  root[F("arch")] = "esp8266";
-  root[F("core")] = ESP.getCoreVersion();
   //root[F("maxalloc")] = ESP.getMaxFreeBlockSize();
   #ifdef WLED_DEBUG
     root[F("resetReason")] = (int)ESP.getResetInfoPtr()->reason;
   #endif
-  root[F("lwip")] = LWIP_VERSION_MAJOR;
   #endif
 
   root[F("freeheap")] = ESP.getFreeHeap();
+  serializeMemStats(root.createNestedObject(F("mem")));
   #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
   if (psramFound()) root[F("psram")] = ESP.getFreePsram();
   #endif
   root[F("uptime")] = millis()/1000 + rolloverMillis*4294967;
 
-  usermods.addToJsonInfo(root);
+  JsonArray jlock = root.createNestedArray(F("jlock")); // JSON buffer contention per lock module ID
+  for (uint8_t i = 0; i < WLED_JSON_LOCK_MODULES; i++) jlock.add(jsonBufferContention[i]);
 
-  byte os = 0;
-  #ifdef WLED_DEBUG
-  os  = 0x80;
-  #endif
-  #ifndef WLED_DISABLE_ALEXA
-  os += 0x40;
-  #endif
-  #ifndef WLED_DISABLE_BLYNK
-  os += 0x20;
-  #endif
-  #ifdef USERMOD_CRONIXIE
-  os += 0x10;
-  #endif
-  #ifndef WLED_DISABLE_FILESYSTEM
-  os += 0x08;
-  #endif
-  #ifndef WLED_DISABLE_HUESYNC
-  os += 0x04;
-  #endif
-  #ifdef WLED_ENABLE_ADALIGHT
-  os += 0x02;
-  #endif
-  #ifndef WLED_DISABLE_OTA
-  os += 0x01;
-  #endif
-  root[F("opt")] = os;
+  usermods.addToJsonInfo(root);
+  usermods.serializeLoopStats(root.createNestedArray(F("umloop")));
+  serializeTimers(root.createNestedArray(F("timers")));
+  serializeHttpStats(root.createNestedObject(F("http")));
 
-  root[F("brand")] = "WLED";
-  root[F("product")] = F("FOSS");
-  root["mac"] = escapedMac;
   char s[16] = "";
   if (Network.isConnected())
   {
@@ -661,6 +1001,12 @@ void serializeInfo(JsonObject root)
   root["ip"] = s;
 }
 
+void serializeInfo(JsonObject root)
+{
+  serializeInfoStatic(root);
+  serializeInfoDynamic(root);
+}
+
 void setPaletteColors(JsonArray json, CRGBPalette16 palette)
 {
     for (int i = 0; i < 16; i++) {
@@ -701,126 +1047,555 @@ void setPaletteColors(JsonArray json, byte* tcp)
     }
 }
 
-void serializePalettes(JsonObject root, AsyncWebServerRequest* request)
+void serializePalette(JsonArray curPalette, int i)
+{
+  switch (i) {
+    case 0: //default palette
+      setPaletteColors(curPalette, PartyColors_p); 
+      break;
+    case 1: //random
+        curPalette.add("r");
+        curPalette.add("r");
+        curPalette.add("r");
+        curPalette.add("r");
+      break;
+    case 2: //primary color only
+      curPalette.add("c1");
+      break;
+    case 3: //primary + secondary
+      curPalette.add("c1");
+      curPalette.add("c1");
+      curPalette.add("c2");
+      curPalette.add("c2");
+      break;
+    case 4: //primary + secondary + tertiary
+      curPalette.add("c3");
+      curPalette.add("c2");
+      curPalette.add("c1");
+      break;
+    case 5: {//primary + secondary (+tert if not off), more distinct
+    
+      curPalette.add("c1");
+      curPalette.add("c1");
+      curPalette.add("c1");
+      curPalette.add("c1");
+      curPalette.add("c1");
+      curPalette.add("c2");
+      curPalette.add("c2");
+      curPalette.add("c2");
+      curPalette.add("c2");
+      curPalette.add("c2");
+      curPalette.add("c3");
+      curPalette.add("c3");
+      curPalette.add("c3");
+      curPalette.add("c3");
+      curPalette.add("c3");
+      curPalette.add("c1");
+      break;}
+    case 6: //Party colors
+      setPaletteColors(curPalette, PartyColors_p);
+      break;
+    case 7: //Cloud colors
+      setPaletteColors(curPalette, CloudColors_p);
+      break;
+    case 8: //Lava colors
+      setPaletteColors(curPalette, LavaColors_p);
+      break;
+    case 9: //Ocean colors
+      setPaletteColors(curPalette, OceanColors_p);
+      break;
+    case 10: //Forest colors
+      setPaletteColors(curPalette, ForestColors_p);
+      break;
+    case 11: //Rainbow colors
+      setPaletteColors(curPalette, RainbowColors_p);
+      break;
+    case 12: //Rainbow stripe colors
+      setPaletteColors(curPalette, RainbowStripeColors_p);
+      break;
+
+    default:
+      if (i < 13) {
+        break;
+      }
+      if (i >= 13 + GRADIENT_PALETTE_COUNT) { // user palette
+        const CRGBPalette16* custom = strip.getCustomPalette(i - 13 - GRADIENT_PALETTE_COUNT);
+        if (custom) setPaletteColors(curPalette, *custom);
+        break;
+      }
+      const byte* gp = (const byte*)pgm_read_dword(&(gGradientPalettes[i - 13]));
+      if (!gp) break; // not in WLED_PALETTE_SUBSET
+      byte tcp[72];
+      memcpy_P(tcp, gp, 72);
+      setPaletteColors(curPalette, tcp);
+      break;
+  }
+}
+
+void serializeNode(JsonObject node, NodeStruct* n)
 {
+  node[F("name")] = n->nodeName;
+  node["type"]    = n->nodeType;
+  node["ip"]      = n->ip.toString();
+  node[F("age")]  = n->age;
+  node[F("vid")]  = n->build;
+  #ifdef WLED_ENABLE_FLEET_OTA
+  if (n->fleetVariant) {
+    char img[9];
+    sprintf_P(img, PSTR("%08x"), (unsigned)n->fleetImage);
+    JsonObject fleet = node.createNestedObject(F("fleet"));
+    fleet[F("img")] = img;
+    fleet[F("min")] = n->fleetMinutes; // rollout time left, 0 if not serving
+    fleet[F("full")] = bool(n->fleetFlags & FLEET_FULL);
+    if (n->fleetProgress != FLEET_NO_PROGRESS) fleet[F("ota")] = n->fleetProgress; // percent downloaded
+  }
+  #endif
+}
+
+// effect capabilities and cost hints, same order as /json/eff
+void serializeModeMeta(JsonObject root)
+{
+  JsonArray effects = root.createNestedArray("meta");
+
+  for (uint8_t m = 0; m < strip.getModeCount(); m++) {
+    if (!fxIncluded(m)) { effects.add(nullptr); continue; } // not in this build, the ID stays reserved
+    uint8_t flags = strip.getModeFlags(m);
+    JsonObject fx = effects.createNestedObject();
+    fx["pal"]    = bool(flags & FX_USES_PALETTE);
+    fx["rb"]     = bool(flags & FX_NEEDS_READBACK);
+    fx["static"] = bool(flags & FX_IS_STATIC);
+    fx["data"]   = (flags & FX_DATA_PER_PIXEL) ? 2 : (flags & FX_DATA_FIXED) ? 1 : 0; // 0: none, 1: fixed, 2: per pixel
+    fx["cost"]   = strip.getModeCost(m);
+  }
+}
+
+#if defined(WLED_FX_SUBSET) || defined(WLED_PALETTE_SUBSET)
+static bool fxInBuild(uint8_t m)  { return fxIncluded(m); }
+static bool palInBuild(uint8_t p) { return palIncluded(p); }
+
+//effect or palette names with the ones left out of the build replaced by "RSVD", so the IDs of the others stay the same
+static String namesWithGaps(const char* list, bool (*included)(uint8_t))
+{
+  String names;
+  names.reserve(strlen_P(list));
+  names = '[';
+  uint8_t m = 0;
+  bool inName = false;
+  uint16_t start = 0;
+  for (uint16_t i = 0; ; i++) {
+    char c = pgm_read_byte(list + i);
+    if (!c) break;
+    if (c != '"') continue;
+    if (!inName) { start = i; inName = true; continue; }
+    inName = false;
+    if (m) names += ',';
+    if (included(m)) {
+      for (uint16_t j = start; j <= i; j++) names += (char)pgm_read_byte(list + j);
+    } else {
+      names += F("\"RSVD\"");
+    }
+    m++;
+  }
+  names += ']';
+  return names;
+}
+#endif
+
+/*
+ * Streamed /json responses. The body is produced part by part (state without segments, one segment, info,
+ * one node, one palette, flash strings) while the TCP stack asks for data, each part serialized into its own
+ * small document. No shared JSON buffer is held while sending and the size is not limited by JSON_BUFFER_SIZE.
+ * Parts are read when they are sent, changes made during a response can show up in its later parts.
+ */
+#ifndef JSON_CHUNK_DOC_SIZE
+  #define JSON_CHUNK_DOC_SIZE 1536 // one segment, node, palette or the state without segments
+#endif
+#ifndef JSON_CHUNK_INFO_SIZE
   #ifdef ESP8266
-  int itemPerPage = 5;
+  #define JSON_CHUNK_INFO_SIZE 3072
   #else
-  int itemPerPage = 8;
+  #define JSON_CHUNK_INFO_SIZE 4096
   #endif
+#endif
 
-  int page = 0;
-  if (request->hasParam("page")) {
-    page = request->getParam("page")->value().toInt();
+/*
+ * Response filter of /json/state and /json/info: f=on,bri,ps lists the top level fields, seg=2 or seg=1-4 the
+ * segment ids and sf=id,fx,col the segment fields. Fields are dropped while the response is written, segments
+ * outside the range and (without "seg" in f) all segments are not serialized at all.
+ */
+typedef struct JsonFilter {
+  String  fields;         // empty: all
+  String  segFields;      // empty: all
+  uint8_t segFirst = 0;
+  uint8_t segLast = 255;
+  bool    active = false;
+} json_filter_t;
+
+//whether key is in the comma separated list, an empty list holds all keys
+static bool inFieldList(const String& list, const char* key)
+{
+  if (!list.length()) return true;
+  size_t len = strlen(key);
+  int pos = 0;
+  while (pos >= 0 && pos < (int)list.length()) {
+    int comma = list.indexOf(',', pos);
+    size_t end = comma < 0 ? list.length() : comma;
+    if (end - pos == len && strncmp(list.c_str() + pos, key, len) == 0) return true;
+    pos = comma < 0 ? -1 : comma + 1;
   }
+  return false;
+}
 
-  int palettesCount = strip.getPaletteCount();
+//appends the fields of obj in list as "key":value pairs, returns how many
+static uint8_t appendFields(JsonObject obj, const String& list, String& out, uint8_t count = 0)
+{
+  for (JsonPair kv : obj) {
+    if (!inFieldList(list, kv.key().c_str())) continue;
+    if (count++) out += ',';
+    out += '"'; out += kv.key().c_str(); out += F("\":");
+    serializeJson(kv.value(), out);
+  }
+  return count;
+}
 
-  int maxPage = (palettesCount -1) / itemPerPage;
-  if (page > maxPage) page = maxPage;
+class JsonChunkedStream
+{
+  public:
+  //a stream shared by several responses is not counted itself, its readers are
+  JsonChunkedStream(byte subJson, int page, const json_filter_t* filter = nullptr, bool counted = true) : _subJson(subJson), _page(page), _step(JP_BEGIN), _item(0), _count(0), _pos(0), _pgm(nullptr), _pgmLen(0), _counted(counted) {
+    if (filter) _filter = *filter;
+    if (_counted) active++;
+  }
+  ~JsonChunkedStream() { if (_counted) active--; }
+
+  static uint8_t active; // responses being sent, reads are turned away above JSON_MAX_STREAMS
+
+  //AwsResponseFiller, 0 ends the response
+  size_t fill(uint8_t* buf, size_t maxLen) {
+    size_t len = 0;
+    while (len < maxLen) {
+      if (_pgm) {
+        size_t n = min(maxLen - len, _pgmLen - _pos);
+        memcpy_P(buf + len, _pgm + _pos, n);
+        len += n; _pos += n;
+        if (_pos < _pgmLen) break;
+        _pgm = nullptr; _pos = 0;
+      } else if (_pos < _part.length()) {
+        size_t n = min(maxLen - len, _part.length() - _pos);
+        memcpy(buf + len, _part.c_str() + _pos, n);
+        len += n; _pos += n;
+      } else {
+        _part = ""; _pos = 0;
+        if (!nextPart()) break;
+      }
+    }
+    return len;
+  }
 
-  int start = itemPerPage * page;
-  int end = start + itemPerPage;
-  if (end >= palettesCount) end = palettesCount;
+  private:
+  enum : byte { JP_BEGIN, JP_SEG, JP_FX, JP_FX_NAMES, JP_PAL, JP_PAL_NAMES, JP_CLOSE, JP_NODE, JP_PALX, JP_END };
+
+  byte        _subJson;
+  int         _page;
+  byte        _step;
+  uint16_t    _item;  // next segment, node slot or palette
+  uint16_t    _count; // items already written, for the separators
+  size_t      _pos;   // position in _part or _pgm
+  String      _part;
+  PGM_P       _pgm;
+  size_t      _pgmLen;
+  bool        _counted;
+  json_filter_t _filter;
 
-  root[F("m")] = maxPage;
-  JsonObject palettes  = root.createNestedObject("p");
+  #ifdef ESP8266
+  static const int palettesPerPage = 5;
+  static const int nodesPerPage = 8;
+  #else
+  static const int palettesPerPage = 8;
+  static const int nodesPerPage = 25;
+  #endif
 
-  for (int i = start; i < end; i++) {
-    JsonArray curPalette = palettes.createNestedArray(String(i));
-    switch (i) {
-      case 0: //default palette
-        setPaletteColors(curPalette, PartyColors_p); 
-        break;
-      case 1: //random
-          curPalette.add("r");
-          curPalette.add("r");
-          curPalette.add("r");
-          curPalette.add("r");
-        break;
-      case 2: //primary color only
-        curPalette.add("c1");
-        break;
-      case 3: //primary + secondary
-        curPalette.add("c1");
-        curPalette.add("c1");
-        curPalette.add("c2");
-        curPalette.add("c2");
-        break;
-      case 4: //primary + secondary + tertiary
-        curPalette.add("c3");
-        curPalette.add("c2");
-        curPalette.add("c1");
-        break;
-      case 5: {//primary + secondary (+tert if not off), more distinct
-      
-        curPalette.add("c1");
-        curPalette.add("c1");
-        curPalette.add("c1");
-        curPalette.add("c1");
-        curPalette.add("c1");
-        curPalette.add("c2");
-        curPalette.add("c2");
-        curPalette.add("c2");
-        curPalette.add("c2");
-        curPalette.add("c2");
-        curPalette.add("c3");
-        curPalette.add("c3");
-        curPalette.add("c3");
-        curPalette.add("c3");
-        curPalette.add("c3");
-        curPalette.add("c1");
-        break;}
-      case 6: //Party colors
-        setPaletteColors(curPalette, PartyColors_p);
-        break;
-      case 7: //Cloud colors
-        setPaletteColors(curPalette, CloudColors_p);
-        break;
-      case 8: //Lava colors
-        setPaletteColors(curPalette, LavaColors_p);
-        break;
-      case 9: //Ocean colors
-        setPaletteColors(curPalette, OceanColors_p);
-        break;
-      case 10: //Forest colors
-        setPaletteColors(curPalette, ForestColors_p);
-        break;
-      case 11: //Rainbow colors
-        setPaletteColors(curPalette, RainbowColors_p);
-        break;
-      case 12: //Rainbow stripe colors
-        setPaletteColors(curPalette, RainbowStripeColors_p);
-        break;
+  //returns false if the segments are filtered out, the object is closed then
+  bool appendState() {
+    DynamicJsonDocument doc(JSON_CHUNK_DOC_SIZE);
+    serializeState(doc.to<JsonObject>(), false, true, true, false);
+    if (_filter.active) {
+      _part += '{';
+      uint8_t n = appendFields(doc.as<JsonObject>(), _filter.fields, _part);
+      if (!inFieldList(_filter.fields, "seg")) { _part += '}'; return false; }
+      if (n) _part += ',';
+      _part += F("\"seg\":[");
+      return true;
+    }
+    String head;
+    serializeJson(doc, head);
+    head.remove(head.length() -1); //reopen the object for the segments
+    _part += head;
+    _part += F(",\"seg\":[");
+    return true;
+  }
 
-      default:
-        if (i < 13) {
-          break;
+  //the static info is serialized once per configVersion and spliced in front of the changing fields
+  void appendInfo() {
+    if (_filter.active) { //not cached, only the listed fields are written
+      DynamicJsonDocument doc(JSON_CHUNK_DOC_SIZE);
+      serializeInfoStatic(doc.to<JsonObject>());
+      _part += '{';
+      uint8_t n = appendFields(doc.as<JsonObject>(), _filter.fields, _part);
+      DynamicJsonDocument dynDoc(JSON_CHUNK_INFO_SIZE);
+      serializeInfoDynamic(dynDoc.to<JsonObject>());
+      appendFields(dynDoc.as<JsonObject>(), _filter.fields, _part, n);
+      _part += '}';
+      return;
+    }
+    static String staticInfo;
+    static uint16_t staticInfoVersion = 0;
+    if (!staticInfo.length() || staticInfoVersion != configVersion) {
+      DynamicJsonDocument doc(JSON_CHUNK_DOC_SIZE);
+      serializeInfoStatic(doc.to<JsonObject>());
+      staticInfo = "";
+      serializeJson(doc, staticInfo);
+      staticInfo.remove(staticInfo.length() -1); //reopen the object for the dynamic fields
+      staticInfoVersion = configVersion;
+    }
+    DynamicJsonDocument doc(JSON_CHUNK_INFO_SIZE);
+    serializeInfoDynamic(doc.to<JsonObject>());
+    String dyn;
+    serializeJson(doc, dyn);
+    _part += staticInfo;
+    _part += ",";
+    _part += dyn.c_str() +1; //without the opening brace
+  }
+
+  void setPgm(PGM_P str) {
+    _pgm = str;
+    _pgmLen = strlen_P(str);
+    _pos = 0;
+  }
+
+  bool nextPart() {
+    switch (_step) {
+      case JP_BEGIN:
+        if (_subJson == 2) { //info
+          appendInfo();
+          _step = JP_END;
+        } else if (_subJson == 4) { //node list, all nodes unless a page is requested
+          _part = "{";
+          if (_page >= 0) {
+            int maxPage = Nodes.size() ? (Nodes.size() -1) / nodesPerPage : 0;
+            _page = constrain(_page, 0, maxPage);
+            _part += F("\"m\":"); _part += maxPage; _part += ",";
+          }
+          _part += F("\"nodes\":[");
+          _step = JP_NODE;
+        } else if (_subJson == 5) { //palettes page
+          int maxPage = (strip.getPaletteCount() -1) / palettesPerPage;
+          _page = constrain(_page, 0, maxPage);
+          _item = _page * palettesPerPage;
+          _part = F("{\"m\":"); _part += maxPage; _part += F(",\"p\":{");
+          _step = JP_PALX;
+        } else { //state, or state and info
+          if (_subJson != 1) _part = F("{\"state\":");
+          _step = appendState() ? JP_SEG : JP_END;
         }
-        byte tcp[72];
-        memcpy_P(tcp, (byte*)pgm_read_dword(&(gGradientPalettes[i - 13])), 72);
-        setPaletteColors(curPalette, tcp);
-        break;
+        return true;
+
+      case JP_SEG: //one active segment per part
+        while (_item < strip.getMaxSegments()) {
+          WS2812FX::Segment &sg = strip.getSegment(_item);
+          if (sg.isActive() && _item >= _filter.segFirst && _item <= _filter.segLast) {
+            DynamicJsonDocument doc(JSON_CHUNK_DOC_SIZE);
+            JsonObject seg0 = doc.to<JsonObject>();
+            serializeSegment(seg0, sg, _item++);
+            if (_count++) _part = ",";
+            if (_filter.segFields.length()) {
+              _part += '{';
+              appendFields(seg0, _filter.segFields, _part);
+              _part += '}';
+            } else serializeJson(doc, _part);
+            return true;
+          }
+          _item++;
+        }
+        _part = F("]}");
+        if (_subJson == 1) { _step = JP_END; return true; }
+        _part += F(",\"info\":");
+        appendInfo();
+        if (_subJson == 3) { _part += "}"; _step = JP_END; }
+        else _step = JP_FX;
+        return true;
+
+      case JP_FX:        _part = F(",\"effects\":");  _step = JP_FX_NAMES;  return true;
+      #if defined(WLED_FX_SUBSET) || defined(WLED_PALETTE_SUBSET)
+      case JP_FX_NAMES:  _part = namesWithGaps(JSON_mode_names, fxInBuild);     _step = JP_PAL;   return true;
+      #else
+      case JP_FX_NAMES:  setPgm(JSON_mode_names);     _step = JP_PAL;       return true;
+      #endif
+      case JP_PAL:       _part = F(",\"palettes\":"); _step = JP_PAL_NAMES; return true;
+      #if defined(WLED_FX_SUBSET) || defined(WLED_PALETTE_SUBSET)
+      case JP_PAL_NAMES: _part = namesWithGaps(JSON_palette_names, palInBuild); _step = JP_CLOSE; return true;
+      #else
+      case JP_PAL_NAMES: setPgm(JSON_palette_names);  _step = JP_CLOSE;     return true;
+      #endif
+      case JP_CLOSE:     _part = "}";                 _step = JP_END;       return true;
+
+      case JP_NODE: { //one node per part, erased nodes move in the table so a node can be missed while sending
+        int left = (_page < 0) ? Nodes.size() : (_page +1) * nodesPerPage; //_count: nodes seen, including the skipped pages
+        while (_item < Nodes.capacity() && _count < left) {
+          NodeStruct* n = Nodes.at(_item++);
+          if (!n) continue;
+          int written = _count++ - (_page < 0 ? 0 : _page * nodesPerPage);
+          if (written < 0) continue; //skipped to the page
+          DynamicJsonDocument doc(JSON_CHUNK_DOC_SIZE);
+          serializeNode(doc.to<JsonObject>(), n);
+          if (written) _part = ",";
+          serializeJson(doc, _part);
+          return true;
+        }
+        _part = F("]}");
+        _step = JP_END;
+        return true;
+      }
+
+      case JP_PALX: //one palette per part
+        if (_item < (_page +1) * palettesPerPage && _item < strip.getPaletteCount()) {
+          DynamicJsonDocument doc(JSON_CHUNK_DOC_SIZE);
+          serializePalette(doc.to<JsonArray>(), _item);
+          if (_item > _page * palettesPerPage) _part = ",";
+          _part += "\""; _part += _item++; _part += F("\":");
+          serializeJson(doc, _part);
+        } else {
+          _part = F("}}");
+          _step = JP_END;
+        }
+        return true;
+
+      default:
+        return false;
     }
   }
+};
+
+uint8_t JsonChunkedStream::active = 0;
+
+/*
+ * Load handling of the JSON API. Reads are refused with a fast 503 (Retry-After) when too many responses are
+ * in flight or the heap runs low, so state changes, which do not take that path, still get through.
+ * Concurrent /json/state and /json/info GETs within the same frame share one serialization.
+ */
+#ifndef JSON_MAX_STREAMS
+  #ifdef ESP8266
+  #define JSON_MAX_STREAMS   2
+  #else
+  #define JSON_MAX_STREAMS   4
+  #endif
+#endif
+#ifndef JSON_READ_MIN_HEAP
+  #define JSON_READ_MIN_HEAP 8192 // heap kept for state changes
+#endif
+
+void serveJsonOverload(AsyncWebServerRequest* request)
+{
+  AsyncWebServerResponse *response = request->beginResponse(503, "application/json", F("{\"error\":3}"));
+  response->addHeader(F("Retry-After"), "1");
+  request->send(response);
 }
 
-void serializeNodes(JsonObject root)
+/*
+ * State or info of the current frame, streamed once for all responses polling it.
+ * Every reader has its own position, the stream only keeps the bytes between the slowest and the fastest reader.
+ * A request can join while nothing was dropped yet, otherwise it starts a new stream.
+ */
+class CoalescedJsonStream
 {
-  JsonArray nodes = root.createNestedArray("nodes");
+  public:
+  CoalescedJsonStream(byte subJson) : _src(subJson, -1, nullptr, false), _base(0), _readers(0), _done(false) {}
+
+  //returns the reader slot, -1 if the stream can not be joined
+  int8_t join() {
+    if (_base) return -1;
+    for (uint8_t r = 0; r < JSON_MAX_READERS; r++) {
+      if (_readers & (1 << r)) continue;
+      _readers |= 1 << r;
+      _at[r] = 0;
+      JsonChunkedStream::active++;
+      return r;
+    }
+    return -1;
+  }
 
-  for (NodesMap::iterator it = Nodes.begin(); it != Nodes.end(); ++it)
-  {
-    if (it->second.ip[0] != 0)
-    {
-      JsonObject node = nodes.createNestedObject();
-      node[F("name")] = it->second.nodeName;
-      node["type"]    = it->second.nodeType;
-      node["ip"]      = it->second.ip.toString();
-      node[F("age")]  = it->second.age;
-      node[F("vid")]  = it->second.build;
+  void leave(uint8_t r) {
+    _readers &= ~(1 << r);
+    JsonChunkedStream::active--;
+    trim();
+  }
+
+  //AwsResponseFiller of reader r
+  size_t fill(uint8_t r, uint8_t* buf, size_t maxLen) {
+    while (!_done && _base + _buf.length() < _at[r] + maxLen) {
+      char part[257];
+      size_t len = _src.fill((uint8_t*)part, sizeof(part) -1);
+      if (!len) { _done = true; break; }
+      part[len] = '\0';
+      _buf += part;
     }
+    size_t len = min(maxLen, _base + _buf.length() - _at[r]);
+    memcpy(buf, _buf.c_str() + (_at[r] - _base), len);
+    _at[r] += len;
+    trim();
+    return len;
+  }
+
+  private:
+  static const uint8_t JSON_MAX_READERS = 8;
+
+  JsonChunkedStream _src;
+  String            _buf;  // bytes not yet sent to every reader
+  size_t            _base; // offset of _buf in the response
+  size_t            _at[JSON_MAX_READERS];
+  uint8_t           _readers;
+  bool              _done;
+
+  //drops what all readers have sent
+  void trim() {
+    if (!_readers) return;
+    size_t low = SIZE_MAX;
+    for (uint8_t r = 0; r < JSON_MAX_READERS; r++) if (_readers & (1 << r)) low = min(low, _at[r]);
+    if (low - _base < 256) return; //not worth moving the buffer
+    _buf.remove(0, low - _base);
+    _base = low;
+  }
+};
+
+//a reader of the coalesced stream, freed with its response
+struct CoalescedJsonReader
+{
+  std::shared_ptr<CoalescedJsonStream> stream;
+  uint8_t slot;
+  CoalescedJsonReader(const std::shared_ptr<CoalescedJsonStream>& s, uint8_t r) : stream(s), slot(r) {}
+  ~CoalescedJsonReader() { stream->leave(slot); }
+  size_t fill(uint8_t* buf, size_t maxLen) { return stream->fill(slot, buf, maxLen); }
+};
+
+static std::shared_ptr<CoalescedJsonReader> coalescedJson(byte subJson)
+{
+  static std::weak_ptr<CoalescedJsonStream> cache[2];
+  static unsigned long cachedShow[2] = {0};
+  static unsigned long cachedAt[2] = {0};
+  uint8_t c = (subJson == 1) ? 0 : 1;
+  uint8_t fps = strip.getTargetFps();
+
+  std::shared_ptr<CoalescedJsonStream> stream = cache[c].lock();
+  if (stream && cachedShow[c] == strip.getLastShow() && millis() - cachedAt[c] < (fps ? 1000/fps : 50)) {
+    int8_t r = stream->join();
+    if (r >= 0) return std::make_shared<CoalescedJsonReader>(stream, r);
   }
+
+  stream = std::make_shared<CoalescedJsonStream>(subJson);
+  cache[c] = stream;
+  cachedShow[c] = strip.getLastShow();
+  cachedAt[c] = millis();
+  return std::make_shared<CoalescedJsonReader>(stream, stream->join());
 }
 
 void serveJson(AsyncWebServerRequest* request)
@@ -832,18 +1607,72 @@ void serveJson(AsyncWebServerRequest* request)
   else if (url.indexOf("si")    > 0) subJson = 3;
   else if (url.indexOf("nodes") > 0) subJson = 4;
   else if (url.indexOf("palx")  > 0) subJson = 5;
+  #ifdef WLED_ENABLE_PROFILER
+  else if (url.indexOf("perf")  > 0) subJson = 6;
+  #endif
+  #ifdef WLED_ENABLE_LOG
+  else if (url.indexOf("log") > 0) {
+    serveLog(request);
+    return;
+  }
+  #endif
+  #ifdef WLED_ENABLE_TRACE
+  else if (url.indexOf("trace") > 0) {
+    serveTrace(request);
+    return;
+  }
+  #endif
+  #ifdef WLED_ENABLE_FLEET_OTA
+  else if (url.indexOf("fleet") > 0) {
+    serveFleet(request);
+    return;
+  }
+  #endif
+  #ifdef WLED_ENABLE_BENCHMARK
+  else if (url.indexOf("bench") > 0) {
+    serveBenchmark(request);
+    return;
+  }
+  #endif
+  #ifdef WLED_ENABLE_BAKE
+  else if (url.indexOf("bake") > 0) {
+    serveBake(request);
+    return;
+  }
+  #endif
   #ifdef WLED_ENABLE_JSONLIVE
   else if (url.indexOf("live")  > 0) {
     serveLiveLeds(request);
     return;
   }
   #endif
-  else if (url.indexOf(F("eff")) > 0) {
-    request->send_P(200, "application/json", JSON_mode_names);
-    return;
-  }
-  else if (url.indexOf("pal") > 0) {
-    request->send_P(200, "application/json", JSON_palette_names);
+  else if (url.indexOf(F("eff")) > 0 && request->hasParam(F("meta"))) subJson = 7;
+  else if (url.indexOf(F("eff")) > 0 || url.indexOf("pal") > 0) { //constant per build, revalidated by version
+    if (handleIfNoneMatchCacheHeader(request)) return;
+    bool fx = url.indexOf(F("eff")) > 0;
+    #if defined(WLED_FX_SUBSET) || defined(WLED_PALETTE_SUBSET)
+    String names = fx ? namesWithGaps(JSON_mode_names, fxInBuild) : namesWithGaps(JSON_palette_names, palInBuild);
+    #endif
+    AsyncWebServerResponse *response = nullptr;
+    if (acceptsGzip(request)) {
+      static std::shared_ptr<std::vector<uint8_t>> gzNames[2]; //compressed once and kept
+      if (!gzNames[fx]) {
+        #if defined(WLED_FX_SUBSET) || defined(WLED_PALETTE_SUBSET)
+        gzNames[fx] = gzipBuffer((const uint8_t*)names.c_str(), names.length());
+        #else
+        PGM_P names = fx ? JSON_mode_names : JSON_palette_names;
+        gzNames[fx] = gzipBuffer((const uint8_t*)names, strlen_P(names), true);
+        #endif
+      }
+      if (gzNames[fx]) response = beginGzipResponse(request, "application/json", gzNames[fx]);
+    }
+    #if defined(WLED_FX_SUBSET) || defined(WLED_PALETTE_SUBSET)
+    if (!response) response = request->beginResponse(200, "application/json", names);
+    #else
+    if (!response) response = request->beginResponse_P(200, "application/json", fx ? JSON_mode_names : JSON_palette_names);
+    #endif
+    setStaticContentCacheHeaders(response);
+    request->send(response);
     return;
   }
   else if (url.indexOf("cfg") > 0 && handleFileRead(request, "/cfg.json")) {
@@ -854,43 +1683,394 @@ void serveJson(AsyncWebServerRequest* request)
     return;
   }
 
+  if (subJson == 1 && request->hasParam(F("fmt")) && request->getParam(F("fmt"))->value() == "bin") {
+    uint8_t buf[BIN_STATE_HEADER_SIZE + MAX_NUM_SEGMENTS * BIN_STATE_SEG_SIZE];
+    uint16_t len = serializeStateBinary(buf);
+    AsyncResponseStream *response = request->beginResponseStream("application/octet-stream");
+    response->write(buf, len);
+    request->send(response);
+    return;
+  }
+
+  json_filter_t filter;
+  if (subJson == 1 || subJson == 2) {
+    if (request->hasParam("f"))  { filter.fields    = request->getParam("f")->value();  filter.active = true; }
+    if (request->hasParam("sf")) { filter.segFields = request->getParam("sf")->value(); filter.active = true; }
+    if (subJson == 1 && request->hasParam("seg")) {
+      const String& range = request->getParam("seg")->value();
+      int dash = range.indexOf('-');
+      filter.segFirst = constrain(range.toInt(), 0, 255);
+      filter.segLast  = dash < 0 ? filter.segFirst : constrain(range.substring(dash + 1).toInt(), 0, 255);
+      filter.active = true;
+    }
+  }
+  char stateVersion[12];
+  snprintf_P(stateVersion, sizeof(stateVersion), PSTR("%u"), (unsigned)stateChangeCount);
+  if (subJson == 1 && request->hasParam(F("since")) && request->getParam(F("since"))->value() == stateVersion) {
+    AsyncWebServerResponse *response = request->beginResponse(304);
+    response->addHeader(F("X-State-Version"), stateVersion);
+    request->send(response);
+    return;
+  }
+
+  if (JsonChunkedStream::active >= JSON_MAX_STREAMS || ESP.getFreeHeap() < JSON_READ_MIN_HEAP) {
+    serveJsonOverload(request);
+    return;
+  }
+
+  if ((subJson == 1 || subJson == 2) && !filter.active) {
+    std::shared_ptr<CoalescedJsonReader> reader = coalescedJson(subJson);
+    AsyncWebServerResponse *response = beginGzipResponse(request, "application/json", [reader](uint8_t* buf, size_t maxLen) -> size_t {
+      return reader->fill(buf, maxLen);
+    });
+    if (!response) response = request->beginChunkedResponse("application/json", [reader](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+      return reader->fill(buf, maxLen);
+    });
+    if (subJson == 1) response->addHeader(F("X-State-Version"), stateVersion);
+    request->send(response);
+    return;
+  }
+
+  if (subJson != 6 && subJson != 7) {
+    int page = -1;
+    if (request->hasParam("page")) page = request->getParam("page")->value().toInt();
+    std::shared_ptr<JsonChunkedStream> stream = std::make_shared<JsonChunkedStream>(subJson, page, &filter); //freed with the response
+    AsyncWebServerResponse *response = beginGzipResponse(request, "application/json", [stream](uint8_t* buf, size_t maxLen) -> size_t {
+      return stream->fill(buf, maxLen);
+    });
+    if (!response) response = request->beginChunkedResponse("application/json", [stream](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+      return stream->fill(buf, maxLen);
+    });
+    if (subJson == 1) response->addHeader(F("X-State-Version"), stateVersion);
+    request->send(response);
+    return;
+  }
+
   #ifdef WLED_USE_DYNAMIC_JSON
   AsyncJsonResponse* response = new AsyncJsonResponse(JSON_BUFFER_SIZE);
   #else
-  if (!requestJSONBufferLock(17)) return;
+  JsonDocument* pDoc = requestJSONBuffer(17, false);
+  if (!pDoc) { serveJsonOverload(request); return; }
+  JsonDocument& doc = *pDoc;
   AsyncJsonResponse *response = new AsyncJsonResponse(&doc);
   #endif
 
   JsonObject lDoc = response->getRoot();
 
-  switch (subJson)
-  {
-    case 1: //state
-      serializeState(lDoc); break;
-    case 2: //info
-      serializeInfo(lDoc); break;
-    case 4: //node list
-      serializeNodes(lDoc); break;
-    case 5: //palettes
-      serializePalettes(lDoc, request); break;
-    default: //all
-      JsonObject state = lDoc.createNestedObject("state");
-      serializeState(state);
-      JsonObject info = lDoc.createNestedObject("info");
-      serializeInfo(info);
-      if (subJson != 3)
-      {
-        doc[F("effects")]  = serialized((const __FlashStringHelper*)JSON_mode_names);
-        doc[F("palettes")] = serialized((const __FlashStringHelper*)JSON_palette_names);
-      }
-  }
+  #ifdef WLED_ENABLE_PROFILER
+  if (subJson == 6) { //frame profiler
+    profiler.serialize(lDoc);
+    if (request->hasParam(F("reset"))) profiler.reset();
+  } else
+  #endif
+  serializeModeMeta(lDoc); //effect capabilities
 
   DEBUG_PRINT("JSON buffer size: ");
   DEBUG_PRINTLN(lDoc.memoryUsage());
 
   response->setLength();
   request->send(response);
-  releaseJSONBufferLock();
+  #ifndef WLED_USE_DYNAMIC_JSON
+  releaseJSONBuffer(pDoc);
+  #endif
+}
+
+/*
+ * State requests received by network callbacks (async web server, websockets) are copied
+ * into a single producer/single consumer ring and applied from loop() between frames.
+ * This keeps the strip from being modified while an effect is rendering and
+ * the network task never has to wait for the JSON buffer.
+ */
+typedef struct StateRequest {
+  char*    json;
+  size_t   len;
+  uint32_t clientId; // websocket client that sent the request, 0 for HTTP
+} state_request_t;
+
+static state_request_t stateQueue[WLED_STATE_QUEUE_SIZE];
+static volatile uint8_t stateQueueHead = 0; // next slot written by the producer
+static volatile uint8_t stateQueueTail = 0; // next slot read by the consumer
+
+/*
+ * Slider and color picker requests ({"bri":..}, {"seg":{"col":..}}, {"seg":{"fx":..}}, with "on", "v", "time" and
+ * "transition") are recognized without a JsonDocument and merged into one pending request, the latest value per
+ * field and color slot wins. It is applied once per frame before the queue, so dragging a slider costs one state
+ * update per frame instead of one per message. Only used while the queue is empty, which keeps the order of
+ * requests, and for one target segment at a time (selected segments or one id), anything else is queued.
+ */
+#define FAST_STATE_MAX_LEN 256
+
+typedef struct FastState {
+  int16_t  bri;         // -1: not set
+  int8_t   on;          // -1: not set
+  int16_t  fx;          // -1: not set
+  int8_t   seg;         // -1: selected segments
+  bool     segSet;      // seg object present
+  uint8_t  colSet;      // bit per color slot
+  uint8_t  colLen[3];
+  uint8_t  col[3][4];
+  int32_t  transition;  // -1: not set
+  uint32_t time;        // 0: not set
+  bool     verbose;
+  uint32_t clientId;    // last websocket client, 0 for HTTP
+} fast_state_t;
+
+static fast_state_t fastState;
+static volatile bool fastStatePending = false;
+
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE fastStateMux = portMUX_INITIALIZER_UNLOCKED;
+#define FAST_STATE_ENTER() portENTER_CRITICAL(&fastStateMux)
+#define FAST_STATE_EXIT()  portEXIT_CRITICAL(&fastStateMux)
+#else
+#define FAST_STATE_ENTER()
+#define FAST_STATE_EXIT()
+#endif
+
+//just enough JSON for the requests above: objects, arrays, integers and booleans, no strings as values
+class FastJson {
+  public:
+  const uint8_t* p;
+  const uint8_t* end;
+  FastJson(const uint8_t* json, size_t len) : p(json), end(json + len) {}
+  void skip() { while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++; }
+  bool lit(char c) { skip(); if (p < end && *p == c) { p++; return true; } return false; }
+  bool atEnd() { skip(); return p == end; }
+  bool key(char* k, uint8_t size) {
+    if (!lit('"')) return false;
+    uint8_t i = 0;
+    while (p < end && *p != '"') {
+      if (*p == '\\' || i + 1 >= size) return false;
+      k[i++] = *p++;
+    }
+    k[i] = 0;
+    if (p >= end) return false;
+    p++;
+    return lit(':');
+  }
+  bool num(int32_t& v, int32_t lo, int32_t hi) {
+    skip();
+    bool neg = (p < end && *p == '-');
+    if (neg) p++;
+    if (p >= end || *p < '0' || *p > '9') return false;
+    int64_t n = 0;
+    while (p < end && *p >= '0' && *p <= '9') { n = n * 10 + (*p++ - '0'); if (n > INT32_MAX) return false; }
+    if (p < end && (*p == '.' || *p == 'e' || *p == 'E')) return false;
+    v = neg ? -n : n;
+    return v >= lo && v <= hi;
+  }
+  bool boolean(bool& b) {
+    skip();
+    if (end - p >= 4 && !memcmp(p, "true", 4))  { p += 4; b = true;  return true; }
+    if (end - p >= 5 && !memcmp(p, "false", 5)) { p += 5; b = false; return true; }
+    return false;
+  }
+};
+
+static bool parseFastSegment(FastJson& j, fast_state_t& f)
+{
+  char k[8];
+  int32_t n;
+  f.segSet = true;
+  if (!j.lit('{') || j.lit('}')) return false;
+  do {
+    if (!j.key(k, sizeof(k))) return false;
+    if (!strcmp_P(k, PSTR("id"))) {
+      if (!j.num(n, 0, MAX_NUM_SEGMENTS -1)) return false;
+      f.seg = n;
+    } else if (!strcmp_P(k, PSTR("fx"))) {
+      if (!j.num(n, 0, 255)) return false;
+      f.fx = n;
+    } else if (!strcmp_P(k, PSTR("col"))) {
+      if (!j.lit('[')) return false;
+      for (uint8_t i = 0; !j.lit(']'); i++) {
+        if (i >= 3 || (i && !j.lit(',')) || !j.lit('[')) return false;
+        uint8_t c = 0;
+        while (!j.lit(']')) {
+          if (c >= 4 || (c && !j.lit(',')) || !j.num(n, 0, 255)) return false;
+          f.col[i][c++] = n;
+        }
+        if (!c) continue; //empty, slot unchanged
+        if (c < 3) return false;
+        f.colSet |= 1 << i;
+        f.colLen[i] = c;
+      }
+    } else return false;
+  } while (j.lit(','));
+  return j.lit('}');
+}
+
+static bool parseFastState(const uint8_t* json, size_t len, fast_state_t& f)
+{
+  FastJson j(json, len);
+  char k[12];
+  int32_t n;
+  bool b;
+  if (!j.lit('{') || j.lit('}')) return false;
+  do {
+    if (!j.key(k, sizeof(k))) return false;
+    if      (!strcmp_P(k, PSTR("bri")))        { if (!j.num(n, 0, 255)) return false; f.bri = n; }
+    else if (!strcmp_P(k, PSTR("on")))         { if (!j.boolean(b)) return false; f.on = b; }
+    else if (!strcmp_P(k, PSTR("v")))          { if (!j.boolean(b)) return false; f.verbose |= b; }
+    else if (!strcmp_P(k, PSTR("time")))       { if (!j.num(n, 1, INT32_MAX)) return false; f.time = n; }
+    else if (!strcmp_P(k, PSTR("transition"))) { if (!j.num(n, 0, 65535)) return false; f.transition = n; }
+    else if (!strcmp_P(k, PSTR("seg")))        { if (f.segSet || !parseFastSegment(j, f)) return false; }
+    else return false;
+  } while (j.lit(','));
+  return j.lit('}') && j.atEnd();
+}
+
+static void clearFastState(fast_state_t& f)
+{
+  memset(&f, 0, sizeof(f));
+  f.bri = f.fx = -1;
+  f.on = f.seg = -1;
+  f.transition = -1;
+}
+
+// network task, false if the request is not a simple one or cannot be merged with the pending one
+static bool mergeFastState(const uint8_t* json, size_t len, uint32_t clientId)
+{
+  if (len > FAST_STATE_MAX_LEN) return false;
+  fast_state_t f;
+  clearFastState(f);
+  if (!parseFastState(json, len, f)) return false;
+  bool merged = false;
+  FAST_STATE_ENTER();
+  fast_state_t& m = fastState;
+  if (!fastStatePending) {
+    m = f;
+    fastStatePending = merged = true;
+  } else if (!f.segSet || !m.segSet || f.seg == m.seg) {
+    if (f.bri >= 0) { m.bri = f.bri; m.on = -1; } // "on" is applied after "bri", an older one must not override it
+    if (f.on  >= 0) m.on  = f.on;
+    if (f.transition >= 0) m.transition = f.transition;
+    if (f.time) m.time = f.time;
+    m.verbose |= f.verbose;
+    if (f.segSet) {
+      m.segSet = true;
+      m.seg = f.seg;
+      if (f.fx >= 0) m.fx = f.fx;
+      for (uint8_t i = 0; i < 3; i++) {
+        if (!(f.colSet & (1 << i))) continue;
+        memcpy(m.col[i], f.col[i], sizeof(m.col[i]));
+        m.colLen[i] = f.colLen[i];
+        m.colSet |= 1 << i;
+      }
+    }
+    merged = true;
+  }
+  if (merged && clientId) m.clientId = clientId;
+  FAST_STATE_EXIT();
+  return merged;
+}
+
+// main loop, applies the merged requests through the regular state handling
+static void applyFastState()
+{
+  if (!fastStatePending) return;
+  fast_state_t f;
+  FAST_STATE_ENTER();
+  f = fastState;
+  fastStatePending = false;
+  FAST_STATE_EXIT();
+
+  StaticJsonDocument<384> doc;
+  JsonObject root = doc.to<JsonObject>();
+  if (f.bri >= 0) root["bri"] = f.bri;
+  if (f.on  >= 0) root["on"]  = (bool)f.on;
+  if (f.transition >= 0) root[F("transition")] = f.transition;
+  if (f.time) root[F("time")] = f.time;
+  if (f.verbose) root["v"] = true;
+  if (f.segSet) {
+    JsonObject seg = root.createNestedObject("seg");
+    if (f.seg >= 0) seg["id"] = f.seg;
+    if (f.fx  >= 0) seg["fx"] = f.fx;
+    if (f.colSet) {
+      JsonArray col = seg.createNestedArray("col");
+      for (uint8_t i = 0; i < 3; i++) {
+        JsonArray c = col.createNestedArray(); //empty leaves the slot unchanged
+        if (f.colSet & (1 << i)) for (uint8_t k = 0; k < f.colLen[i]; k++) c.add(f.col[i][k]);
+      }
+    }
+  }
+
+  #ifdef WLED_ENABLE_WEBSOCKETS
+  if (f.clientId) {
+    if (applyWsState(root, f.clientId)) {
+      AsyncWebSocketClient* client = ws.client(f.clientId);
+      if (client) sendDataWs(client);
+    }
+    return;
+  }
+  #endif
+  deserializeState(root);
+}
+
+// called from the network task only, returns false if the request has to be handled directly
+bool queueStateRequest(const uint8_t* json, size_t len, uint32_t clientId)
+{
+  if (!len) return false;
+  if (stateQueueTail == stateQueueHead && mergeFastState(json, len, clientId)) {
+    wakeLoop();
+    return true;
+  }
+  uint8_t head = stateQueueHead;
+  uint8_t next = (head + 1) % WLED_STATE_QUEUE_SIZE;
+  if (next == stateQueueTail) return false; // queue full
+  char* copy = (char*)malloc(len);
+  if (!copy) return false;
+  memcpy(copy, json, len);
+  stateQueue[head].json = copy;
+  stateQueue[head].len = len;
+  stateQueue[head].clientId = clientId;
+  __sync_synchronize(); // entry must be complete before it is published
+  stateQueueHead = next;
+  wakeLoop();
+  return true;
+}
+
+// called from loop() at the frame boundary
+void handleStateQueue()
+{
+  applyFastState();
+  while (stateQueueTail != stateQueueHead) {
+    __sync_synchronize();
+    state_request_t& req = stateQueue[stateQueueTail];
+    bool verboseResponse = false;
+    { //scope JsonDocument so it releases its buffer
+      #ifdef WLED_USE_DYNAMIC_JSON
+      PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
+      #else
+      if (!tryRequestJSONBufferLock(18)) return; // buffer in use, retry on next loop
+      #endif
+
+      DeserializationError error = deserializeJson(doc, req.json, req.len);
+      JsonObject root = doc.as<JsonObject>();
+      if (error == DeserializationError::NoMemory && !req.clientId) {
+        deserializeStateStream(req.json, req.len, &doc); //too large for the document, one segment at a time
+      } else if (!error && !root.isNull()) {
+        #ifdef WLED_ENABLE_WEBSOCKETS
+        if (req.clientId) verboseResponse = applyWsState(root, req.clientId);
+        else
+        #endif
+        deserializeState(root);
+      }
+      releaseJSONBufferLock();
+    }
+    uint32_t clientId = req.clientId;
+    free(req.json);
+    req.json = nullptr;
+    __sync_synchronize(); // slot may only be reused once it is released
+    stateQueueTail = (stateQueueTail + 1) % WLED_STATE_QUEUE_SIZE;
+
+    #ifdef WLED_ENABLE_WEBSOCKETS
+    if (verboseResponse) {
+      AsyncWebSocketClient* client = ws.client(clientId);
+      if (client) sendDataWs(client); // client may have disconnected in the meantime
+    }
+    #endif
+  }
 }
 
 #ifdef WLED_ENABLE_JSONLIVE
@@ -906,14 +2086,14 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
   }
   #endif
 
-  uint16_t used = strip.getLengthTotal();
-  uint16_t n = (used -1) /MAX_LIVE_LEDS +1; //only serve every n'th LED if count over MAX_LIVE_LEDS
+  pixidx_t used = strip.getLengthTotal();
+  pixidx_t n = (used -1) /MAX_LIVE_LEDS +1; //only serve every n'th LED if count over MAX_LIVE_LEDS
   char buffer[2000];
   strcpy_P(buffer, PSTR("{\"leds\":["));
   obuf = buffer;
   olen = 9;
 
-  for (uint16_t i= 0; i < used; i += n)
+  for (pixidx_t i= 0; i < used; i += n)
   {
     uint32_t c = strip.getPixelColor(i);
     uint8_t r = qadd8(W(c), R(c)); //add white channel to RGB channels as a simple RGBW -> RGB map
@@ -926,7 +2106,9 @@ bool serveLiveLeds(AsyncWebServerRequest* request, uint32_t wsClient)
   oappendi(n);
   oappend("}");
   if (request) {
-    request->send(200, "application/json", buffer);
+    std::shared_ptr<std::vector<uint8_t>> gz = acceptsGzip(request) ? gzipBuffer((const uint8_t*)buffer, olen) : nullptr;
+    if (gz) request->send(beginGzipResponse(request, "application/json", gz));
+    else    request->send(200, "application/json", buffer);
   }
   #ifdef WLED_ENABLE_WEBSOCKETS
   else {
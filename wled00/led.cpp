@@ -28,21 +28,30 @@ void setValuesFromSegment(uint8_t s)
 // problem: if the first selected segment already has the value to be set, other selected segments are not updated
 void applyValuesToSelectedSegs()
 {
-  // copy of first selected segment to tell if value was updated
+  // what the first selected segment had, to tell which value was updated
   uint8_t firstSel = strip.getFirstSelectedSegId();
-  WS2812FX::Segment selsegPrev = strip.getSegment(firstSel);
+  WS2812FX::Segment& selseg = strip.getSegment(firstSel);
+  bool speed     = effectSpeed     != selseg.speed;
+  bool intensity = effectIntensity != selseg.intensity;
+  bool palette   = effectPalette   != selseg.palette;
+  bool mode      = effectCurrent   != selseg.mode;
+  uint32_t col0 = RGBW32(   col[0],    col[1],    col[2],    col[3]);
+  uint32_t col1 = RGBW32(colSec[0], colSec[1], colSec[2], colSec[3]);
+  bool color0    = col0 != selseg.colors[0];
+  bool color1    = col1 != selseg.colors[1];
+  if (!(speed || intensity || palette || mode || color0 || color1)) return;
+
   for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
     WS2812FX::Segment& seg = strip.getSegment(i);
     if (i != firstSel && (!seg.isActive() || !seg.isSelected())) continue;
-
-    if (effectSpeed     != selsegPrev.speed)     {seg.speed     = effectSpeed;     stateChanged = true;}
-    if (effectIntensity != selsegPrev.intensity) {seg.intensity = effectIntensity; stateChanged = true;}
-    if (effectPalette   != selsegPrev.palette)   {seg.palette   = effectPalette;   stateChanged = true;}
-    if (effectCurrent   != selsegPrev.mode)      {strip.setMode(i, effectCurrent); stateChanged = true;}
-    uint32_t col0 = RGBW32(   col[0],    col[1],    col[2],    col[3]);
-    uint32_t col1 = RGBW32(colSec[0], colSec[1], colSec[2], colSec[3]);
-    if (col0 != selsegPrev.colors[0])            {seg.setColor(0, col0, i);        stateChanged = true;}
-    if (col1 != selsegPrev.colors[1])            {seg.setColor(1, col1, i);        stateChanged = true;}
+    uint16_t gen = seg.gen;
+    if (speed)     seg.setSpeed(effectSpeed);
+    if (intensity) seg.setIntensity(effectIntensity);
+    if (palette)   seg.setPalette(effectPalette);
+    if (mode)      strip.setMode(i, effectCurrent);
+    if (color0)    seg.setColor(0, col0, i);
+    if (color1)    seg.setColor(1, col1, i);
+    if (seg.gen != gen) stateChanged = true;
   }
 }
 
@@ -77,9 +86,16 @@ byte scaledBri(byte in)
 
 //applies global brightness
 void applyBri() {
+  applyBriFine((uint16_t)briT * 257);
+}
+
+
+//applies global brightness with 16 bit resolution (0-65535), used while fading
+void applyBriFine(uint16_t b16) {
   if (!realtimeMode || !arlsForceMaxBri)
   {
-    strip.setBrightness(scaledBri(briT));
+    uint32_t val = ((uint32_t)b16*briMultiplier)/100;
+    strip.setBrightnessFine(val > 65535 ? 65535 : val);
   }
 }
 
@@ -97,6 +113,11 @@ void applyFinalBri() {
 void stateUpdated(byte callMode) {
   //call for notifier -> 0: init 1: direct change 2: button 3: notification 4: nightlight 5: other (No notification)
   //                     6: fx changed 7: hue 8: preset cycle 9: blynk 10: alexa 11: ws send only 12: button preset
+  wakeLoop(); // may be called from a network callback while loop() sleeps
+  stateChangeCount++;
+  #ifdef WLED_ENABLE_WARM_RESUME
+  markResumeState();
+  #endif
   setValuesFromFirstSelectedSeg();
 
   if (bri != briOld || stateChanged) {
@@ -107,6 +128,7 @@ void stateUpdated(byte callMode) {
     //set flag to update blynk, ws and mqtt
     interfaceUpdateCallMode = callMode;
     stateChanged = false;
+    usermods.publish(UM_EVENT_STATE, callMode);
   } else {
     if (nightlightActive && !nightlightActiveOld && callMode != CALL_MODE_NOTIFICATION && callMode != CALL_MODE_NO_NOTIFY) {
       notify(CALL_MODE_NIGHTLIGHT); 
@@ -141,7 +163,7 @@ void stateUpdated(byte callMode) {
 
     if (transitionActive) {
       briOld = briT;
-      tperLast = 0;
+      transitionProgress = 0;
     }
     strip.setTransitionMode(true);
     transitionActive = true;
@@ -157,6 +179,7 @@ void stateUpdated(byte callMode) {
 void updateInterfaces(uint8_t callMode)
 {
   sendDataWs();
+  sendDataSse();
   lastInterfaceUpdate = millis();
   if (callMode == CALL_MODE_WS_SEND) return;
   
@@ -186,20 +209,24 @@ void handleTransitions()
   
   if (transitionActive && transitionDelayTemp > 0)
   {
-    float tper = (millis() - transitionStartTime)/(float)transitionDelayTemp;
-    if (tper >= 1.0)
+    uint32_t elapsed = millis() - transitionStartTime;
+    if (elapsed >= transitionDelayTemp)
     {
       strip.setTransitionMode(false);
       transitionActive = false;
-      tperLast = 0;
+      transitionProgress = 0;
       applyFinalBri();
       return;
     }
-    if (tper - tperLast < 0.004) return;
-    tperLast = tper;
-    briT    = briOld   +((bri    - briOld   )*tper);
-    
-    applyBri();
+    uint16_t prog = (elapsed << 16) / transitionDelayTemp; //fixed point 0-65535
+    if (prog - transitionProgress < 0x100) return; //at most 256 steps per transition
+    transitionProgress = prog;
+    //interpolate in 16 bit, so slow fades at low brightness step on outputs that resolve more than 8 bit
+    int32_t delta = ((int32_t)bri - briOld) * 257;
+    int32_t b16 = (int32_t)briOld * 257 + ((delta * (prog >> 1)) >> 15);
+    briT = (b16 + 128) / 257;
+
+    applyBriFine(b16);
   }
 }
 
@@ -207,6 +234,7 @@ void handleTransitions()
 //legacy method, applies values from col, effectCurrent, ... to selected segments
 void colorUpdated(byte callMode){
   applyValuesToSelectedSegs();
+  usermods.publish(UM_EVENT_COLOR, callMode);
   stateUpdated(callMode);
 }
 
@@ -0,0 +1,157 @@
+#include "wled.h"
+
+/*
+ * Leveled log, see log.h
+ * Entries are drained in order to Serial (logSerial) and to a syslog server (logSyslogIP:logSyslogPort, RFC 3164 lines)
+ * by a task at idle + 1 priority on ESP32, a few per loop on ESP8266. Entries overwritten before they were drained are counted.
+ * GET /json/log[?since=n][&lvl=0-4] returns the entries from number n on that are still in the buffer as
+ * [ms, level, "text"] and sets the verbosity, so a browser can follow the log by polling with the returned "next".
+ */
+#ifdef WLED_ENABLE_LOG
+
+#define LOG_LINE_LEN 128
+#define LOG_DRAIN_MS 50   // ESP32: interval of the drain task
+
+static const char logLevelChars[] = "-EWID";
+static const uint8_t syslogSeverity[] = {7, 3, 4, 6, 7}; // by level: err, warning, info, debug
+
+static uint32_t logTail = 0;     // next entry to drain
+static uint32_t logDropped = 0;  // entries overwritten before they were drained
+static WiFiUDP  logUdp;          // only used by the drain
+#ifdef ARDUINO_ARCH_ESP32
+static TaskHandle_t logTask = nullptr;
+#endif
+
+bool LoggerClass::begin()
+{
+  if (!_entries) _entries = (log_entry*)calloc(WLED_LOG_ENTRIES, sizeof(log_entry));
+  return _entries;
+}
+
+void LoggerClass::record(uint8_t lvl, const char* fmt, const uint32_t* args)
+{
+  if (!_entries) return;
+  #ifdef ARDUINO_ARCH_ESP32
+  uint32_t n = __atomic_fetch_add(&_head, 1, __ATOMIC_RELAXED); // the render worker and network tasks log too
+  #else
+  uint32_t n = _head++;
+  #endif
+  log_entry& e = _entries[n & (WLED_LOG_ENTRIES - 1)];
+  e.seq = 0;
+  e.ms = millis();
+  e.fmt = fmt;
+  memcpy(e.args, args, sizeof(e.args));
+  e.level = lvl;
+  #ifdef ARDUINO_ARCH_ESP32
+  __atomic_store_n(&e.seq, n + 1, __ATOMIC_RELEASE);
+  #else
+  e.seq = n + 1;
+  #endif
+}
+
+bool LoggerClass::format(uint32_t n, char* buf, size_t len, uint8_t* lvl, uint32_t* ms) const
+{
+  if (!_entries) return false;
+  const log_entry& e = _entries[n & (WLED_LOG_ENTRIES - 1)];
+  if (e.seq != n + 1) return false;
+  const char* fmt = e.fmt;
+  uint32_t a[4];
+  memcpy(a, e.args, sizeof(a));
+  uint8_t l = e.level;
+  uint32_t t = e.ms;
+  if (e.seq != n + 1) return false; // overwritten while copying
+  snprintf_P(buf, len, fmt, a[0], a[1], a[2], a[3]);
+  if (lvl) *lvl = l;
+  if (ms) *ms = t;
+  return true;
+}
+
+// sends up to max entries to the log targets
+static void drainLog(uint8_t max)
+{
+  uint32_t head = logger.recorded();
+  if (head - logTail > WLED_LOG_ENTRIES) { // overrun, skip to the oldest entry still in the buffer
+    logDropped += head - logTail - WLED_LOG_ENTRIES;
+    logTail = head - WLED_LOG_ENTRIES;
+  }
+  bool syslog = logSyslogIP[0] && WLED_CONNECTED;
+  if (!logSerial && !syslog) { logTail = head; return; }
+
+  char msg[LOG_LINE_LEN];
+  uint8_t lvl;
+  uint32_t ms;
+  while (logTail != head && max--) {
+    if (!logger.format(logTail, msg, sizeof(msg), &lvl, &ms)) break; // still being written
+    logTail++;
+    if (lvl > LOG_DEBUG) continue;
+    if (logSerial) Serial.printf_P(PSTR("%u.%03u %c %s\n"), (unsigned)(ms / 1000), (unsigned)(ms % 1000), logLevelChars[lvl], msg);
+    if (syslog) {
+      char line[LOG_LINE_LEN + 48];
+      int n = snprintf_P(line, sizeof(line), PSTR("<%u>%s wled: %s"), 8 + syslogSeverity[lvl], cmDNS, msg); // facility user
+      if (n <= 0) continue;
+      logUdp.beginPacket(logSyslogIP, logSyslogPort);
+      logUdp.write((uint8_t*)line, MIN(n, (int)sizeof(line) - 1));
+      logUdp.endPacket();
+    }
+  }
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static void logDrainTask(void*)
+{
+  for (;;) {
+    drainLog(16);
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+  }
+}
+#endif
+
+void initLog()
+{
+  if (!logger.begin()) return;
+  #ifdef ARDUINO_ARCH_ESP32
+  if (!logTask) xTaskCreate(logDrainTask, "log", 3072, nullptr, tskIDLE_PRIORITY + 1, &logTask);
+  #endif
+}
+
+void handleLog()
+{
+  #ifndef ARDUINO_ARCH_ESP32
+  drainLog(4);
+  #endif
+}
+
+void serveLog(AsyncWebServerRequest* request)
+{
+  if (request->hasParam(F("lvl"))) logger.level = constrain(request->getParam(F("lvl"))->value().toInt(), LOG_OFF, LOG_DEBUG);
+  uint32_t head = logger.recorded();
+  uint32_t first = head > WLED_LOG_ENTRIES ? head - WLED_LOG_ENTRIES : 0;
+  uint32_t n = request->hasParam(F("since")) ? request->getParam(F("since"))->value().toInt() : first;
+  if (n < first || n > head) n = first;
+
+  AsyncResponseStream* response = request->beginResponseStream("application/json");
+  response->printf_P(PSTR("{\"lvl\":%u,\"drop\":%u,\"log\":["), logger.level, (unsigned)logDropped);
+  char msg[LOG_LINE_LEN];
+  uint8_t lvl;
+  uint32_t ms;
+  bool firstEntry = true;
+  for (; n != head; n++) {
+    if (!logger.format(n, msg, sizeof(msg), &lvl, &ms)) {
+      if (head - n <= WLED_LOG_ENTRIES) break; // still being written, the next request gets it
+      continue;                                // overwritten meanwhile
+    }
+    response->printf_P(PSTR("%s[%u,%u,\""), firstEntry ? "" : ",", (unsigned)ms, lvl);
+    for (const char* c = msg; *c; c++) {
+      if (*c == '"' || *c == '\\') response->write('\\');
+      response->write((uint8_t)*c < 0x20 ? ' ' : *c);
+    }
+    response->print("\"]");
+    firstEntry = false;
+  }
+  response->printf_P(PSTR("],\"next\":%u}"), (unsigned)n);
+  request->send(response);
+}
+
+LoggerClass logger = LoggerClass();
+
+#endif
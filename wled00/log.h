@@ -0,0 +1,73 @@
+#ifndef WLED_LOG_H
+#define WLED_LOG_H
+/*
+ * Build-time optional leveled log (WLED_ENABLE_LOG)
+ * LOG_E/W/I/D store the format string (in flash) and up to 4 integer arguments with a timestamp in a RAM ring buffer,
+ * without locking and without formatting, so logging costs a few stores and can stay enabled in production.
+ * Entries are formatted when they are drained to Serial and / or a syslog server (UDP), by a low priority task on ESP32
+ * and from the loop on ESP8266, and when the web viewer reads them via /json/log, see log.cpp.
+ * Messages above logger.level (more verbose) are not recorded. %s arguments must point to strings that outlive the entry (flash or static).
+ */
+#ifdef WLED_ENABLE_LOG
+#include <Arduino.h>
+
+#ifndef WLED_LOG_ENTRIES
+  #ifdef ESP8266
+    #define WLED_LOG_ENTRIES 64    // 1.5kB
+  #else
+    #define WLED_LOG_ENTRIES 256   // 6kB
+  #endif
+#endif
+static_assert((WLED_LOG_ENTRIES & (WLED_LOG_ENTRIES - 1)) == 0, "WLED_LOG_ENTRIES must be a power of 2");
+
+#define LOG_OFF   0
+#define LOG_ERROR 1
+#define LOG_WARN  2
+#define LOG_INFO  3
+#define LOG_DEBUG 4
+
+typedef struct LogEntry {
+  volatile uint32_t seq;  // number of the entry + 1, written last, 0 while the entry is being written
+  uint32_t    ms;
+  const char* fmt;        // PSTR
+  uint32_t    args[4];
+  uint8_t     level;
+} log_entry;
+
+class LoggerClass {
+  private:
+    log_entry* _entries = nullptr;
+    volatile uint32_t _head = 0;  // entries recorded since boot, the next one goes to _head % WLED_LOG_ENTRIES
+
+    void record(uint8_t level, const char* fmt, const uint32_t* args);
+
+  public:
+    uint8_t level = LOG_WARN;     // verbosity, messages of higher levels are not recorded
+
+    template<typename... A> inline void add(uint8_t lvl, const char* fmt, A... a) {
+      static_assert(sizeof...(A) <= 4, "at most 4 log arguments");
+      if (lvl > level) return;
+      const uint32_t args[4] = {(uint32_t)a...};
+      record(lvl, fmt, args);
+    }
+
+    bool begin();
+    inline uint32_t recorded() const { return _head; }
+    // formats entry number n into buf, false if it was overwritten or is still being written
+    bool format(uint32_t n, char* buf, size_t len, uint8_t* lvl = nullptr, uint32_t* ms = nullptr) const;
+};
+
+extern LoggerClass logger;
+
+#define LOG_E(fmt, ...) logger.add(LOG_ERROR, PSTR(fmt), ##__VA_ARGS__)
+#define LOG_W(fmt, ...) logger.add(LOG_WARN,  PSTR(fmt), ##__VA_ARGS__)
+#define LOG_I(fmt, ...) logger.add(LOG_INFO,  PSTR(fmt), ##__VA_ARGS__)
+#define LOG_D(fmt, ...) logger.add(LOG_DEBUG, PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_E(fmt, ...)
+#define LOG_W(fmt, ...)
+#define LOG_I(fmt, ...)
+#define LOG_D(fmt, ...)
+#endif
+
+#endif
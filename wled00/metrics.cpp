@@ -0,0 +1,136 @@
+#include "wled.h"
+
+/*
+ * Metrics export over UDP (WLED_ENABLE_METRICS)
+ * Every metricsInterval seconds a few counters are pushed to metricsIP:metricsPort as StatsD gauges or
+ * Influx line protocol (METRICS_...), so monitoring does not have to poll /json/info on each node.
+ * Lines are formatted into a static buffer and sent in packets of up to WLED_METRICS_PACKET bytes.
+ * Frame time percentiles are taken from a histogram of the intervals between shown frames (1 ms buckets),
+ * realtime rates from the differences of the realtime ingest counters over the interval.
+ */
+#ifdef WLED_ENABLE_METRICS
+
+#ifndef WLED_METRICS_PACKET
+  #define WLED_METRICS_PACKET 512
+#endif
+#define METRICS_FRAME_BUCKETS 65 // 0..63 ms, the last one counts longer frames
+
+static uint16_t frameHist[METRICS_FRAME_BUCKETS];
+static char     metricsBuf[WLED_METRICS_PACKET];
+static uint16_t metricsLen = 0;
+static char     metricsHost[33];  // mDNS name, escaped for the line protocol
+static realtime_stats lastRt;
+static unsigned long lastSent = 0;
+
+//called by WS2812FX::show() with the ms since the previous frame
+void metricsFrame(uint32_t ms)
+{
+  uint16_t& b = frameHist[ms < METRICS_FRAME_BUCKETS - 1 ? ms : METRICS_FRAME_BUCKETS - 1];
+  if (b < UINT16_MAX) b++;
+}
+
+static uint8_t framePercentile(uint32_t total, uint8_t pct)
+{
+  uint32_t rank = (total * pct + 99) / 100, sum = 0;
+  for (uint8_t i = 0; i < METRICS_FRAME_BUCKETS; i++) {
+    sum += frameHist[i];
+    if (sum >= rank) return i;
+  }
+  return METRICS_FRAME_BUCKETS - 1;
+}
+
+static void flushMetrics()
+{
+  if (!metricsLen) return;
+  notifierUdp.beginPacket(metricsIP, metricsPort);
+  notifierUdp.write((uint8_t*)metricsBuf, metricsLen);
+  notifierUdp.endPacket();
+  metricsLen = 0;
+}
+
+//appends one value, in Influx format as a field of the current line (started by addLine())
+static void addMetric(const char* name, int32_t value)
+{
+  char line[72];
+  int n;
+  if (metricsFormat == METRICS_STATSD) n = snprintf_P(line, sizeof(line), PSTR("wled.%s.%s:%d|g\n"), metricsHost, name, (int)value);
+  else n = snprintf_P(line, sizeof(line), PSTR("%s%s=%di"), metricsBuf[metricsLen - 1] == ' ' ? "" : ",", name, (int)value);
+  if (n <= 0 || n >= (int)sizeof(line)) return;
+  if (metricsLen + n >= WLED_METRICS_PACKET - 1) {
+    if (metricsFormat != METRICS_STATSD) return; // a line cannot be split
+    flushMetrics();
+  }
+  memcpy(metricsBuf + metricsLen, line, n);
+  metricsLen += n;
+}
+
+//starts a line (Influx only) and makes room for it and a few fields
+static void addLine(const char* measurement, const char* tags)
+{
+  if (metricsFormat == METRICS_INFLUX && metricsLen) metricsBuf[metricsLen++] = '\n';
+  if (metricsLen > WLED_METRICS_PACKET - 256) flushMetrics();
+  if (metricsFormat != METRICS_INFLUX) return;
+  metricsLen += snprintf_P(metricsBuf + metricsLen, WLED_METRICS_PACKET - metricsLen, PSTR("%s,host=%s%s "), measurement, metricsHost, tags);
+}
+
+void handleMetrics()
+{
+  if (metricsFormat == METRICS_OFF || !udpConnected || !metricsIP[0]) return;
+  if (millis() - lastSent < metricsInterval * 1000UL) return;
+  uint32_t elapsed = lastSent ? millis() - lastSent : metricsInterval * 1000UL;
+  lastSent = millis();
+
+  uint8_t n = 0; // the line protocol escapes spaces and commas in tags, StatsD names use dots
+  for (const char* c = cmDNS; *c && n < sizeof(metricsHost) - 2; c++) {
+    if (*c == ' ' || *c == ',' || *c == '.') metricsHost[n++] = '_';
+    else metricsHost[n++] = *c;
+  }
+  metricsHost[n] = 0;
+
+  uint32_t frames = 0;
+  for (uint8_t i = 0; i < METRICS_FRAME_BUCKETS; i++) frames += frameHist[i];
+  uint32_t heap = ESP.getFreeHeap();
+  uint32_t block = maxAllocatable(ALLOC_HOT);
+  realtime_stats rt = rtStats;
+
+  metricsLen = 0;
+  addLine("wled", "");
+  addMetric("fps", strip.getFps());
+  if (frames) {
+    addMetric("ft50", framePercentile(frames, 50)); // ms
+    addMetric("ft95", framePercentile(frames, 95));
+    addMetric("ft99", framePercentile(frames, 99));
+  }
+  addMetric("heap", heap);
+  addMetric("frag", heap ? 100 - (block * 100) / heap : 0);
+  addMetric("rssi", Network.isEthernet() ? 0 : WiFi.RSSI());
+  addMetric("ma", strip.currentMilliamps);
+  addMetric("uptime", millis() / 1000);
+  addMetric("rtpps", ((rt.rx - lastRt.rx) * 1000UL) / elapsed);
+  addMetric("rtfps", ((rt.push - lastRt.push) * 1000UL) / elapsed);
+  addMetric("rtdrop", rt.drop - lastRt.drop);
+  addMetric("rtseq", rt.seq - lastRt.seq);
+  addMetric("rtus", rt.procAvg);
+  memset(frameHist, 0, sizeof(frameHist));
+  lastRt = rt;
+
+  uint16_t id;
+  uint32_t runs, avgUs, maxUs;
+  for (byte i = 0; usermods.getLoopStats(i, id, runs, avgUs, maxUs); i++) {
+    char tags[12], name[20];
+    snprintf_P(tags, sizeof(tags), PSTR(",um=%u"), id);
+    addLine("wled_um", tags);
+    if (metricsFormat == METRICS_STATSD) {
+      snprintf_P(name, sizeof(name), PSTR("um.%u.avg"), id); addMetric(name, avgUs);
+      snprintf_P(name, sizeof(name), PSTR("um.%u.max"), id); addMetric(name, maxUs);
+    } else {
+      addMetric("avg", avgUs);
+      addMetric("max", maxUs);
+      addMetric("runs", runs);
+    }
+  }
+  if (metricsFormat == METRICS_INFLUX) metricsBuf[metricsLen++] = '\n';
+  flushMetrics();
+}
+
+#endif
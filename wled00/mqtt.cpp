@@ -7,6 +7,12 @@
 #ifdef WLED_ENABLE_MQTT
 #define MQTT_KEEP_ALIVE_TIME 60    // contact the MQTT broker every 60 seconds
 
+static char*         mqttPublishBuf = nullptr; //state payload, kept once allocated
+static unsigned long lastMqttPublish = 0;
+static bool          mqttRepublish = true;     //(re)connected, publish all retained topics
+static uint8_t       mqttSentBri = 0;
+static uint32_t      mqttSentCol = 0;
+
 void parseMQTTBriPayload(char* payload)
 {
   if      (strstr(payload, "ON") || strstr(payload, "on") || strstr(payload, "true")) {bri = briLast; stateUpdated(1);}
@@ -20,38 +26,94 @@ void parseMQTTBriPayload(char* payload)
 }
 
 
-void onMqttConnect(bool sessionPresent)
+/*
+ * Subscribed topics are dispatched through a table of topic hashes built on connect, instead of comparing
+ * every message against the device and group topic. Messages are copied by the MQTT client callback into
+ * a single producer/single consumer ring and applied by handleMqtt() from loop() between frames, like the
+ * state requests of the web server (JSON API payloads go straight into that queue, see queueStateRequest()).
+ */
+enum : uint8_t { MQTT_ROUTE_BRI, MQTT_ROUTE_COL, MQTT_ROUTE_API, MQTT_ROUTE_USERMOD };
+#define MQTT_ROUTES 6 // topic, /col and /api of the device and group topic
+
+typedef struct MqttRoute {
+  uint32_t hash;
+  uint8_t  handler;
+  uint8_t  prefixLen; // of the device or group topic, stripped for usermods
+  const char* prefix;
+} mqtt_route_t;
+
+typedef struct MqttMessage {
+  char*   payload;  // 0-terminated, followed by the topic for MQTT_ROUTE_USERMOD
+  char*   topic;
+  uint8_t handler;
+} mqtt_message_t;
+
+static mqtt_route_t   mqttRoutes[MQTT_ROUTES];
+static uint8_t        mqttRouteCount = 0;
+static mqtt_message_t mqttQueue[WLED_STATE_QUEUE_SIZE];
+static volatile uint8_t mqttQueueHead = 0; // next slot written by the MQTT client
+static volatile uint8_t mqttQueueTail = 0; // next slot read by handleMqtt()
+
+static uint32_t mqttTopicHash(const char* topic, uint32_t h = 2166136261UL)
 {
-  //(re)subscribe to required topics
-  char subuf[38];
+  while (*topic) h = (h ^ (uint8_t)*topic++) * 16777619UL; // FNV-1a
+  return h;
+}
 
-  if (mqttDeviceTopic[0] != 0) {
-    strlcpy(subuf, mqttDeviceTopic, 33);
-    mqtt->subscribe(subuf, 0);
-    strcat_P(subuf, PSTR("/col"));
-    mqtt->subscribe(subuf, 0);
-    strlcpy(subuf, mqttDeviceTopic, 33);
-    strcat_P(subuf, PSTR("/api"));
+static void subscribeMqttTopics(const char* prefix)
+{
+  static const char suffixes[3][5] PROGMEM = {"", "/col", "/api"};
+  char subuf[38];
+  for (uint8_t i = 0; i < 3; i++) {
+    strlcpy(subuf, prefix, 33);
+    strcat_P(subuf, suffixes[i]);
     mqtt->subscribe(subuf, 0);
+    if (mqttRouteCount < MQTT_ROUTES) {
+      mqtt_route_t& r = mqttRoutes[mqttRouteCount++];
+      r.hash = mqttTopicHash(subuf);
+      r.handler = MQTT_ROUTE_BRI + i;
+      r.prefix = prefix;
+      r.prefixLen = strlen(prefix);
+    }
   }
+}
 
-  if (mqttGroupTopic[0] != 0) {
-    strlcpy(subuf, mqttGroupTopic, 33);
-    mqtt->subscribe(subuf, 0);
-    strcat_P(subuf, PSTR("/col"));
-    mqtt->subscribe(subuf, 0);
-    strlcpy(subuf, mqttGroupTopic, 33);
-    strcat_P(subuf, PSTR("/api"));
-    mqtt->subscribe(subuf, 0);
-  }
+void onMqttConnect(bool sessionPresent)
+{
+  //(re)subscribe to required topics
+  mqttRouteCount = 0;
+  if (mqttDeviceTopic[0] != 0) subscribeMqttTopics(mqttDeviceTopic);
+  if (mqttGroupTopic[0] != 0)  subscribeMqttTopics(mqttGroupTopic);
 
   usermods.onMqttConnect(sessionPresent);
+  usermods.publish(UM_EVENT_MQTT_CONNECTED, sessionPresent);
 
+  mqttRepublish = true;
   doPublishMqtt = true;
   DEBUG_PRINTLN(F("MQTT ready"));
 }
 
+//the route of a topic, MQTT_ROUTE_USERMOD with the topic to pass on (without the WLED prefix) if none
+static uint8_t routeMqttTopic(const char*& topic)
+{
+  uint32_t h = mqttTopicHash(topic);
+  for (uint8_t i = 0; i < mqttRouteCount; i++) {
+    const mqtt_route_t& r = mqttRoutes[i];
+    if (r.hash != h || strncmp(topic, r.prefix, r.prefixLen)) continue;
+    const char* rest = topic + r.prefixLen;
+    if (r.handler == MQTT_ROUTE_BRI ? *rest == 0 : strcmp_P(rest, r.handler == MQTT_ROUTE_COL ? PSTR("/col") : PSTR("/api")) == 0) return r.handler;
+  }
+  // non standard subtopic of a WLED topic or a topic a usermod subscribed to
+  size_t len = strlen(mqttDeviceTopic);
+  if (len && strncmp(topic, mqttDeviceTopic, len) == 0) topic += len;
+  else {
+    len = strlen(mqttGroupTopic);
+    if (len && strncmp(topic, mqttGroupTopic, len) == 0) topic += len;
+  }
+  return MQTT_ROUTE_USERMOD;
+}
 
+//MQTT client callback (network task), queues the message for handleMqtt()
 void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties properties, size_t len, size_t index, size_t total) {
 
   DEBUG_PRINT(F("MQTT msg: "));
@@ -62,87 +124,126 @@ void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties
     DEBUG_PRINTLN(F("no payload -> leave"));
     return;
   }
-  //make a copy of the payload to 0-terminate it
-  char* payloadStr = new char[len+1];
-  if (payloadStr == nullptr) return; //no mem
-  strncpy(payloadStr, payload, len);
-  payloadStr[len] = '\0';
-  DEBUG_PRINTLN(payloadStr);
-
-  size_t topicPrefixLen = strlen(mqttDeviceTopic);
-  if (strncmp(topic, mqttDeviceTopic, topicPrefixLen) == 0) {
-    topic += topicPrefixLen;
-  } else {
-    topicPrefixLen = strlen(mqttGroupTopic);
-    if (strncmp(topic, mqttGroupTopic, topicPrefixLen) == 0) {
-      topic += topicPrefixLen;
-    } else {
-      // Non-Wled Topic used here. Probably a usermod subscribed to this topic.
-      usermods.onMqttMessage(topic, payloadStr);
-      delete[] payloadStr;
-      return;
-    }
+  if (index != 0 || len != total) return; // payload split over several packets, not supported
+
+  const char* subTopic = topic;
+  uint8_t handler = routeMqttTopic(subTopic);
+  if (handler == MQTT_ROUTE_API && payload[0] == '{') { // JSON API
+    if (!queueStateRequest((const uint8_t*)payload, len)) DEBUG_PRINTLN(F("MQTT: state queue full"));
+    return;
   }
 
-  //Prefix is stripped from the topic at this point
-
-  if (strcmp_P(topic, PSTR("/col")) == 0) {
-    colorFromDecOrHexString(col, (char*)payloadStr);
-    colorUpdated(CALL_MODE_DIRECT_CHANGE);
-  } else if (strcmp_P(topic, PSTR("/api")) == 0) {
-    if (payload[0] == '{') { //JSON API
-      #ifdef WLED_USE_DYNAMIC_JSON
-      DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-      #else
-      if (!requestJSONBufferLock(15)) return;
-      #endif
-      deserializeJson(doc, payloadStr);
-      deserializeState(doc.as<JsonObject>());
-      releaseJSONBufferLock();
-    } else { //HTTP API
-      String apireq = "win&";
-      apireq += (char*)payloadStr;
-      handleSet(nullptr, apireq);
+  uint8_t head = mqttQueueHead;
+  uint8_t next = (head + 1) % WLED_STATE_QUEUE_SIZE;
+  if (next == mqttQueueTail) { DEBUG_PRINTLN(F("MQTT: queue full")); return; }
+  size_t topicLen = (handler == MQTT_ROUTE_USERMOD) ? strlen(subTopic) + 1 : 0;
+  char* copy = (char*)malloc(len + 1 + topicLen); //0-terminated payload
+  if (!copy) return; //no mem
+  memcpy(copy, payload, len);
+  copy[len] = '\0';
+  if (topicLen) memcpy(copy + len + 1, subTopic, topicLen);
+  mqttQueue[head].payload = copy;
+  mqttQueue[head].topic = topicLen ? copy + len + 1 : nullptr;
+  mqttQueue[head].handler = handler;
+  __sync_synchronize(); // entry must be complete before it is published
+  mqttQueueHead = next;
+  wakeLoop();
+}
+
+// called from loop() at the frame boundary
+void handleMqtt()
+{
+  while (mqttQueueTail != mqttQueueHead) {
+    __sync_synchronize();
+    mqtt_message_t& msg = mqttQueue[mqttQueueTail];
+    DEBUG_PRINTLN(msg.payload);
+
+    // of several brightness or color messages queued (slider bursts) only the last one is applied
+    bool superseded = false;
+    if (msg.handler == MQTT_ROUTE_BRI || msg.handler == MQTT_ROUTE_COL) {
+      for (uint8_t i = (mqttQueueTail + 1) % WLED_STATE_QUEUE_SIZE; i != mqttQueueHead && !superseded; i = (i + 1) % WLED_STATE_QUEUE_SIZE)
+        superseded = mqttQueue[i].handler == msg.handler;
     }
-  } else if (strlen(topic) != 0) {
-    // non standard topic, check with usermods
-    usermods.onMqttMessage(topic, payloadStr);
-  } else {
-    // topmost topic (just wled/MAC)
-    parseMQTTBriPayload(payloadStr);
+    if (!superseded) switch (msg.handler) {
+      case MQTT_ROUTE_BRI:
+        parseMQTTBriPayload(msg.payload);
+        break;
+      case MQTT_ROUTE_COL:
+        colorFromDecOrHexString(col, msg.payload);
+        colorUpdated(CALL_MODE_DIRECT_CHANGE);
+        break;
+      case MQTT_ROUTE_API: { //HTTP API
+        String apireq = "win&";
+        apireq += msg.payload;
+        handleSet(nullptr, apireq);
+        break;
+      }
+      default:
+        if (msg.topic[0]) usermods.onMqttMessage(msg.topic, msg.payload);
+        else parseMQTTBriPayload(msg.payload); // stripped to nothing: a WLED topic subscribed before a topic change
+        break;
+    }
+    free(msg.payload);
+    msg.payload = nullptr;
+    __sync_synchronize(); // slot may only be reused once it is released
+    mqttQueueTail = (mqttQueueTail + 1) % WLED_STATE_QUEUE_SIZE;
   }
-  delete[] payloadStr;
 }
 
 
+static void publishMqttTopic(const char* subTopic, const char* payload, bool retain)
+{
+  char subuf[40];
+  strlcpy(subuf, mqttDeviceTopic, 33);
+  strcat_P(subuf, subTopic);
+  mqtt->publish(subuf, 0, retain, payload);
+}
+
+/*
+ * Called while doPublishMqtt is set. Changes within MQTT_PUBLISH_INTERVAL are published together,
+ * brightness and color only if they changed since they were last published.
+ */
 void publishMqtt()
 {
+  if (!WLED_MQTT_CONNECTED) { doPublishMqtt = false; return; }
+  if (millis() - lastMqttPublish < MQTT_PUBLISH_INTERVAL) return;
+  if (!mqttPublishBuf) mqttPublishBuf = (char*)malloc(MQTT_PUBLISH_BUFFER);
+  if (!mqttPublishBuf) { doPublishMqtt = false; return; }
+  #ifndef WLED_USE_DYNAMIC_JSON
+  if (mqttStateJson && !tryRequestJSONBufferLock(19)) return; //next loop
+  #endif
   doPublishMqtt = false;
-  if (!WLED_MQTT_CONNECTED) return;
+  lastMqttPublish = millis();
   DEBUG_PRINTLN(F("Publish MQTT"));
 
   char s[10];
-  char subuf[38];
-
-  sprintf_P(s, PSTR("%u"), bri);
-  strlcpy(subuf, mqttDeviceTopic, 33);
-  strcat_P(subuf, PSTR("/g"));
-  mqtt->publish(subuf, 0, true, s);         // retain message
-
-  sprintf_P(s, PSTR("#%06X"), (col[3] << 24) | (col[0] << 16) | (col[1] << 8) | (col[2]));
-  strlcpy(subuf, mqttDeviceTopic, 33);
-  strcat_P(subuf, PSTR("/c"));
-  mqtt->publish(subuf, 0, true, s);         // retain message
-
-  strlcpy(subuf, mqttDeviceTopic, 33);
-  strcat_P(subuf, PSTR("/status"));
-  mqtt->publish(subuf, 0, true, "online");  // retain message for a LWT
+  uint32_t c = (col[3] << 24) | (col[0] << 16) | (col[1] << 8) | (col[2]);
+  if (mqttRepublish || bri != mqttSentBri) {
+    sprintf_P(s, PSTR("%u"), bri);
+    publishMqttTopic(PSTR("/g"), s, true);          // retain message
+  }
+  if (mqttRepublish || c != mqttSentCol) {
+    sprintf_P(s, PSTR("#%06X"), c);
+    publishMqttTopic(PSTR("/c"), s, true);          // retain message
+  }
+  if (mqttRepublish) publishMqttTopic(PSTR("/status"), "online", true); // retain message for a LWT
+  mqttSentBri = bri;
+  mqttSentCol = c;
+  mqttRepublish = false;
 
-  char apires[1024];                        // allocating 1024 bytes from stack can be risky
-  XML_response(nullptr, apires);
-  strlcpy(subuf, mqttDeviceTopic, 33);
-  strcat_P(subuf, PSTR("/v"));
-  mqtt->publish(subuf, 0, false, apires);   // do not retain message
+  if (mqttStateJson) {
+    #ifdef WLED_USE_DYNAMIC_JSON
+    PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    #endif
+    doc.clear();
+    serializeState(doc.to<JsonObject>(), false, true, false, false); //no segments
+    size_t len = serializeJson(doc, mqttPublishBuf, MQTT_PUBLISH_BUFFER);
+    releaseJSONBufferLock();
+    if (len < MQTT_PUBLISH_BUFFER -1) publishMqttTopic(PSTR("/state"), mqttPublishBuf, false); //not if truncated
+  } else {
+    XML_response(nullptr, mqttPublishBuf);
+    publishMqttTopic(PSTR("/v"), mqttPublishBuf, false); // do not retain message
+  }
 }
 
 
@@ -156,6 +257,7 @@ bool initMqtt()
     mqtt = new AsyncMqttClient();
     mqtt->onMessage(onMqttMessage);
     mqtt->onConnect(onMqttConnect);
+    mqtt->onDisconnect([](AsyncMqttClientDisconnectReason reason) { usermods.publish(UM_EVENT_MQTT_DISCONNECTED, (uint8_t)reason); });
   }
   if (mqtt->connected()) return true;
 
@@ -181,4 +283,5 @@ bool initMqtt()
 #else
 bool initMqtt(){return false;}
 void publishMqtt(){}
+void handleMqtt(){}
 #endif
@@ -4,9 +4,30 @@
 
 /*
  * Acquires time from NTP server
+ * A sync queries up to WLED_NTP_SERVERS servers at once (for pool names like 0.wled.pool.ntp.org also 1., 2. ...),
+ * collects the replies for NTP_COLLECT_MS and uses the one with the shortest round trip. If that was slow, further
+ * rounds follow every NTP_REFINE_INTERVAL until one comes back within NTP_GOOD_RTT (about +-10ms).
+ * The time is also kept in RTC memory, so it is known right after a warm reboot (see restoreTime()).
  */
 //#define WLED_DEBUG_NTP
 #define NTP_SYNC_INTERVAL 42000UL //Get fresh NTP time about twice per day
+#ifndef WLED_NTP_SERVERS
+  #define WLED_NTP_SERVERS 3
+#endif
+#define NTP_COLLECT_MS       1500 //replies to a round are collected this long
+#define NTP_GOOD_RTT           20 //ms, the time is then within half of it
+#define NTP_REFINE_INTERVAL 30000 //ms between rounds while the round trip is worse
+#define NTP_REFINE_ROUNDS       4
+
+static IPAddress ntpIPs[WLED_NTP_SERVERS];
+static uint8_t    ntpServers = 0;     //queried in the current round
+static uint8_t    ntpReplies = 0;
+static bool       ntpRound = false;   //collecting replies
+static uint16_t   ntpBestRtt = UINT16_MAX;
+static Toki::Time ntpBestTime;        //server time of the best reply, corrected by half its round trip
+static uint32_t   ntpBestReceived = 0;
+static uint16_t   ntpSyncRtt = UINT16_MAX; //of the reply the clock was last set from
+static uint8_t    ntpRefine = 0;      //rounds left to improve on ntpSyncRtt
 
 Timezone* tz;
 
@@ -152,6 +173,7 @@ void updateTimezone() {
   tzCurrent = currentTimezone;
 
   tz = new Timezone(tcrDaylight, tcrStandard);
+  invalidateTimers();
 }
 
 void handleTime() {
@@ -169,35 +191,84 @@ void handleTime() {
     updateLocalTime();
     checkTimers();
     checkCountdown();
+    persistTime();
   }
 }
 
+//sets the clock from the best reply of the round, if any
+static void finishNTPRound()
+{
+  ntpRound = false;
+  if (ntpBestRtt == UINT16_MAX) return; //no reply, retried after 10s
+  bool fresh = millis() - ntpLastSyncTime > (1000*NTP_SYNC_INTERVAL);
+  if (fresh || ntpBestRtt < ntpSyncRtt) {
+    Toki::Time t = ntpBestTime;
+    toki.adjust(t, millis() - ntpBestReceived);
+    toki.setTime(t, ntpBestRtt <= NTP_GOOD_RTT ? TOKI_TS_NTP_P : TOKI_TS_NTP);
+    ntpSyncRtt = ntpBestRtt;
+    #ifdef WLED_DEBUG_NTP
+    Serial.print(F("NTP set from ")); Serial.print(ntpReplies); Serial.print(F(" replies, roundtrip "));
+    Serial.println(ntpBestRtt);
+    #endif
+
+    if (countdownTime - toki.second() > 0) countdownOverTriggered = false;
+    // if time changed re-calculate sunrise/sunset
+    updateLocalTime();
+    calculateSunriseAndSunset();
+  }
+  if (fresh) ntpRefine = NTP_REFINE_ROUNDS;
+  if (ntpRefine) ntpRefine--;
+  if (ntpSyncRtt <= NTP_GOOD_RTT) ntpRefine = 0;
+  ntpLastSyncTime = millis();
+}
+
 void handleNetworkTime()
 {
-  if (ntpEnabled && ntpConnected && millis() - ntpLastSyncTime > (1000*NTP_SYNC_INTERVAL) && WLED_CONNECTED)
+  if (!ntpEnabled || !ntpConnected || !WLED_CONNECTED) return;
+  if (ntpRound) {
+    while (checkNTPResponse());
+    if (ntpReplies >= ntpServers || millis() - ntpPacketSentTime > NTP_COLLECT_MS) finishNTPRound();
+    return;
+  }
+  bool due = millis() - ntpLastSyncTime > (1000*NTP_SYNC_INTERVAL) || (ntpRefine && millis() - ntpLastSyncTime > NTP_REFINE_INTERVAL);
+  if (due && millis() - ntpPacketSentTime > 10000)
   {
-    if (millis() - ntpPacketSentTime > 10000)
-    {
-      sendNTPPacket();
-      ntpPacketSentTime = millis();
-    }
-    if (checkNTPResponse())
-    {
-      ntpLastSyncTime = millis();
-    }
+    sendNTPPacket();
   }
 }
 
-void sendNTPPacket()
+//resolves the servers of a round: the configured one, for pool names ("0.wled.pool.ntp.org") also the next numbers
+static void resolveNTPServers()
 {
-  if (!ntpServerIP.fromString(ntpServerName)) //see if server is IP or domain
-  {
+  ntpServers = 0;
+  if (ntpServerIP.fromString(ntpServerName)) { //server is an IP
+    ntpIPs[ntpServers++] = ntpServerIP;
+    return;
+  }
+  char name[sizeof(ntpServerName)];
+  strlcpy(name, ntpServerName, sizeof(name));
+  bool pool = name[0] >= '0' && name[0] <= '9' && name[1] == '.';
+  for (uint8_t i = 0; i < (pool ? WLED_NTP_SERVERS : 1); i++) {
+    if (pool) name[0] = '0' + (ntpServerName[0] - '0' + i) % 4; //pools have 0. to 3.
+    IPAddress ip;
     #ifdef ESP8266
-    WiFi.hostByName(ntpServerName, ntpServerIP, 750);
+    if (!WiFi.hostByName(name, ip, 750)) continue;
     #else
-    WiFi.hostByName(ntpServerName, ntpServerIP);
+    if (!WiFi.hostByName(name, ip)) continue;
     #endif
+    bool known = false;
+    for (uint8_t j = 0; j < ntpServers; j++) known |= (ntpIPs[j] == ip);
+    if (!known) ntpIPs[ntpServers++] = ip;
   }
+  if (ntpServers) ntpServerIP = ntpIPs[0];
+}
+
+void sendNTPPacket()
+{
+  ntpPacketSentTime = millis();
+  resolveNTPServers();
+  if (!ntpServers) return;
+  while (ntpUdp.parsePacket()); //drops late replies of the last round
 
   DEBUG_PRINTLN(F("send NTP"));
   byte pbuf[NTP_PACKET_SIZE];
@@ -213,11 +284,19 @@ void sendNTPPacket()
   pbuf[14]  = 49;
   pbuf[15]  = 52;
 
-  ntpUdp.beginPacket(ntpServerIP, 123); //NTP requests are to port 123
-  ntpUdp.write(pbuf, NTP_PACKET_SIZE);
-  ntpUdp.endPacket();
+  //the servers are asked back to back, so all replies are measured from the same send time
+  ntpPacketSentTime = millis();
+  for (uint8_t i = 0; i < ntpServers; i++) {
+    ntpUdp.beginPacket(ntpIPs[i], 123); //NTP requests are to port 123
+    ntpUdp.write(pbuf, NTP_PACKET_SIZE);
+    ntpUdp.endPacket();
+  }
+  ntpReplies = 0;
+  ntpBestRtt = UINT16_MAX;
+  ntpRound = true;
 }
 
+//takes one reply of the current round, returns false if there was none
 bool checkNTPResponse()
 {
   int cb = ntpUdp.parsePacket();
@@ -227,21 +306,29 @@ bool checkNTPResponse()
   DEBUG_PRINT(F("NTP recv, l="));
   DEBUG_PRINTLN(cb);
   byte pbuf[NTP_PACKET_SIZE];
+  if (cb < NTP_PACKET_SIZE || !ntpRound) return true; //dropped with the next parsePacket()
   ntpUdp.read(pbuf, NTP_PACKET_SIZE); // read the packet into the buffer
+  ntpReplies++;
 
   Toki::Time arrived  = toki.fromNTP(pbuf + 32);
   Toki::Time departed = toki.fromNTP(pbuf + 40);
-  if (departed.sec == 0) return false;
+  if (departed.sec == 0) return true;
   //basic half roundtrip estimation
   uint32_t serverDelay = toki.msDifference(arrived, departed);
-  uint32_t offset = (ntpPacketReceivedTime - ntpPacketSentTime - serverDelay) >> 1;
+  uint32_t roundtrip = ntpPacketReceivedTime - ntpPacketSentTime;
+  if (serverDelay > roundtrip) serverDelay = roundtrip;
+  uint32_t offset = (roundtrip - serverDelay) >> 1;
   #ifdef WLED_DEBUG_NTP
   //the time the packet departed the NTP server
   toki.printTime(departed);
   #endif
 
   toki.adjust(departed, offset);
-  toki.setTime(departed, TOKI_TS_NTP);
+  if (roundtrip - serverDelay < ntpBestRtt) {
+    ntpBestRtt = roundtrip - serverDelay;
+    ntpBestTime = departed;
+    ntpBestReceived = ntpPacketReceivedTime;
+  }
 
   #ifdef WLED_DEBUG_NTP
   Serial.print("Arrived: ");
@@ -249,20 +336,63 @@ bool checkNTPResponse()
   Serial.print("Time: ");
   toki.printTime(departed);
   Serial.print("Roundtrip: ");
-  Serial.println(ntpPacketReceivedTime - ntpPacketSentTime);
+  Serial.println(roundtrip);
   Serial.print("Offset: ");
   Serial.println(offset);
   Serial.print("Serverdelay: ");
   Serial.println(serverDelay);
   #endif
-
-  if (countdownTime - toki.second() > 0) countdownOverTriggered = false;
-  // if time changed re-calculate sunrise/sunset
-  updateLocalTime();
-  calculateSunriseAndSunset();
   return true;
 }
 
+/*
+ * Time kept across warm reboots: saved to RTC memory every second, restored by setup() before usermods
+ * (the RTC usermod then overrides it with its clock). The seconds spent rebooting are not counted, so it is
+ * only second-accurate until the next NTP sync.
+ */
+#define PERSISTED_TIME_MAGIC 0x574C544DUL
+typedef struct {
+  uint32_t magic;
+  uint32_t sec;
+  uint32_t check;
+} persisted_time;
+
+#ifdef ARDUINO_ARCH_ESP32
+RTC_NOINIT_ATTR static persisted_time persistedTime;
+#else
+#ifndef WLED_RTC_TIME_BLOCK
+  #define WLED_RTC_TIME_BLOCK 64 //4 byte block of RTC user memory, below that OTA keeps its command
+#endif
+#endif
+
+static void persistTime()
+{
+  if (toki.getTimeSource() < TOKI_TS_SEC) return; //nothing worth keeping
+  persisted_time p;
+  p.magic = PERSISTED_TIME_MAGIC;
+  p.sec = toki.second() + 1; //rebooting takes about that long
+  p.check = p.magic ^ p.sec ^ 0xA5A5A5A5UL;
+  #ifdef ARDUINO_ARCH_ESP32
+  persistedTime = p;
+  #else
+  ESP.rtcUserMemoryWrite(WLED_RTC_TIME_BLOCK, (uint32_t*)&p, sizeof(p));
+  #endif
+}
+
+void restoreTime()
+{
+  persisted_time p;
+  #ifdef ARDUINO_ARCH_ESP32
+  p = persistedTime;
+  #else
+  if (!ESP.rtcUserMemoryRead(WLED_RTC_TIME_BLOCK, (uint32_t*)&p, sizeof(p))) return;
+  #endif
+  if (p.magic != PERSISTED_TIME_MAGIC || p.check != (p.magic ^ p.sec ^ 0xA5A5A5A5UL)) return; //power on
+  if (toki.getTimeSource() >= TOKI_TS_SEC) return;
+  toki.setTime(p.sec + millis() / 1000, TOKI_NO_MS_ACCURACY, TOKI_TS_SEC);
+  DEBUG_PRINTLN(F("Time restored from RTC memory"));
+}
+
 void updateLocalTime()
 {
   if (currentTimezone != tzCurrent) updateTimezone();
@@ -317,13 +447,11 @@ byte weekdayMondayFirst()
   return wd;
 }
 
-bool isTodayInDateRange(byte monthStart, byte dayStart, byte monthEnd, byte dayEnd)
+static bool isDateInRange(byte m, byte d, byte monthStart, byte dayStart, byte monthEnd, byte dayEnd)
 {
 	if (monthStart == 0 || dayStart == 0) return true;
 	if (monthEnd == 0) monthEnd = monthStart;
 	if (dayEnd == 0) dayEnd = 31;
-	byte d = day(localTime);
-	byte m = month(localTime);
 
 	if (monthStart < monthEnd) {
 		if (m > monthStart && m < monthEnd) return true;
@@ -343,66 +471,129 @@ bool isTodayInDateRange(byte monthStart, byte dayStart, byte monthEnd, byte dayE
 	return (m == monthStart && d >= dayStart && d <= dayEnd); //just the designated days this month
 }
 
+/*
+ * Timer engine: the next time (toki seconds) each timer fires is computed when the timers, the time zone or
+ * the clock change and after a timer fired. Each tick then only compares the time with the earliest one.
+ * Days are walked in local time, so DST changes are handled by the time zone rules, sun timers use the sun
+ * times of the day they fire on. Timers that do not fire within the searched days are looked at again then.
+ */
+#define TIMER_SLOTS         10
+#define TIMER_SEARCH_DAYS    8    //weekday and sun timers
+#define TIMER_RANGE_DAYS   366    //timers limited to a date range
+#define TIMER_LATE_MAX      60    //a timer missed by longer (time set forward) is skipped
+
+static uint32_t timerNext[TIMER_SLOTS];  //0: none within the searched days
+static uint32_t timerNextAny = 0;        //earliest of timerNext, or when to search again
+static uint32_t timerLastCheck = 0;
+static bool     timersDirty = true;
+
+void invalidateTimers()
+{
+  timersDirty = true;
+}
+
+int getSunriseUTC(int year, int month, int day, float lat, float lon, bool sunset);
+
+//toki second of the sun event (plus offset minutes) on a local day, 0 if there is none
+static uint32_t sunTimerOn(time_t dayLocal, bool isSunset, int8_t offsetMin)
+{
+  if (!(int)(longitude*10.) && !(int)(latitude*10.)) return 0;
+  int minUTC = getSunriseUTC(year(dayLocal), month(dayLocal), day(dayLocal), latitude, longitude, isSunset);
+  if (!minUTC) return 0;
+  if (minUTC < 0) minUTC += 24*60; // add a day if negative
+  return dayLocal + minUTC*60 + offsetMin*60 - utcOffsetSecs; //the date of dayLocal at 00:00 UTC, plus the event
+}
+
+static uint32_t findNextTimer(uint8_t i, uint32_t now, time_t today, uint32_t& searchUntil)
+{
+  if (!timerMacro[i] || !(timerWeekday[i] & 0x01)) return 0;
+  bool sun = (i >= 8);
+  bool ranged = !sun && ((timerMonth[i] >> 4) & 0x0F) && timerDay[i];
+  uint16_t days = ranged ? TIMER_RANGE_DAYS : TIMER_SEARCH_DAYS;
+
+  for (uint16_t d = 0; d < days; d++) {
+    time_t dayLocal = today + d * SECS_PER_DAY;
+    byte wd = weekday(dayLocal) -1;
+    if (wd == 0) wd = 7; //Monday first
+    if (!((timerWeekday[i] >> wd) & 0x01)) continue;
+
+    if (sun) {
+      uint32_t t = sunTimerOn(dayLocal, i == 9, timerMinutes[i]);
+      if (t > now) return t;
+      continue;
+    }
+    if (!isDateInRange(month(dayLocal), day(dayLocal), (timerMonth[i] >> 4) & 0x0F, timerDay[i], timerMonth[i] & 0x0F, timerDayEnd[i])) continue;
+    byte h0 = (timerHours[i] == 24) ? 0  : timerHours[i]; //24: every hour
+    byte h1 = (timerHours[i] == 24) ? 23 : timerHours[i];
+    if (h1 > 23) return 0;
+    for (byte h = h0; h <= h1; h++) {
+      uint32_t t = tz->toUTC(dayLocal + h * SECS_PER_HOUR + timerMinutes[i] * SECS_PER_MIN) - utcOffsetSecs;
+      if (t > now) return t;
+    }
+  }
+  uint32_t until = tz->toUTC(today + days * SECS_PER_DAY) - utcOffsetSecs;
+  if (until < searchUntil) searchUntil = until;
+  return 0;
+}
+
+static void scheduleTimers(uint32_t now)
+{
+  if (currentTimezone != tzCurrent) updateTimezone();
+  time_t localNow = tz->toLocal(now + utcOffsetSecs);
+  time_t today = localNow - (localNow % SECS_PER_DAY);
+  uint32_t searchUntil = UINT32_MAX;
+  timerNextAny = 0;
+  for (uint8_t i = 0; i < TIMER_SLOTS; i++) {
+    timerNext[i] = findNextTimer(i, now, today, searchUntil);
+    if (timerNext[i] && (!timerNextAny || timerNext[i] < timerNextAny)) timerNextAny = timerNext[i];
+  }
+  if (searchUntil != UINT32_MAX && (!timerNextAny || searchUntil < timerNextAny)) timerNextAny = searchUntil;
+  timersDirty = false;
+}
+
+//called once per second
 void checkTimers()
 {
+  uint32_t now = toki.second();
+  if (now < timerLastCheck || now - timerLastCheck > 5) timersDirty = true; //the clock was set
+  timerLastCheck = now;
+
   if (lastTimerMinute != minute(localTime)) //only check once a new minute begins
   {
     lastTimerMinute = minute(localTime);
-
     // re-calculate sunrise and sunset just after midnight
     if (!hour(localTime) && minute(localTime)==1) calculateSunriseAndSunset();
+  }
 
-    DEBUG_PRINTF("Local time: %02d:%02d\n", hour(localTime), minute(localTime));
-    for (uint8_t i = 0; i < 8; i++)
-    {
-      if (timerMacro[i] != 0
-          && (timerWeekday[i] & 0x01) //timer is enabled
-          && (timerHours[i] == hour(localTime) || timerHours[i] == 24) //if hour is set to 24, activate every hour 
-          && timerMinutes[i] == minute(localTime)
-          && ((timerWeekday[i] >> weekdayMondayFirst()) & 0x01) //timer should activate at current day of week
-          && isTodayInDateRange(((timerMonth[i] >> 4) & 0x0F), timerDay[i], timerMonth[i] & 0x0F, timerDayEnd[i])
-         )
-      {
-        unloadPlaylist();
-        applyPreset(timerMacro[i]);
-      }
-    }
-    // sunrise macro
-    if (sunrise) {
-      time_t tmp = sunrise + timerMinutes[8]*60;  // NOTE: may not be ok
-      DEBUG_PRINTF("Trigger time: %02d:%02d\n", hour(tmp), minute(tmp));
-      if (timerMacro[8] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
-          && (timerWeekday[8] & 0x01) //timer is enabled
-          && ((timerWeekday[8] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
-      {
-        unloadPlaylist();
-        applyPreset(timerMacro[8]);
-        DEBUG_PRINTF("Sunrise macro %d triggered.",timerMacro[8]);
-      }
-    }
-    // sunset macro
-    if (sunset) {
-      time_t tmp = sunset + timerMinutes[9]*60;  // NOTE: may not be ok
-      DEBUG_PRINTF("Trigger time: %02d:%02d\n", hour(tmp), minute(tmp));
-      if (timerMacro[9] != 0
-          && hour(tmp) == hour(localTime)
-          && minute(tmp) == minute(localTime)
-          && (timerWeekday[9] & 0x01) //timer is enabled
-          && ((timerWeekday[9] >> weekdayMondayFirst()) & 0x01)) //timer should activate at current day of week
-      {
-        unloadPlaylist();
-        applyPreset(timerMacro[9]);
-        DEBUG_PRINTF("Sunset macro %d triggered.",timerMacro[9]);
-      }
-    }
+  if (toki.getTimeSource() == TOKI_TS_NONE) return;
+  if (timersDirty) scheduleTimers(now);
+  if (!timerNextAny || now < timerNextAny) return;
+
+  for (uint8_t i = 0; i < TIMER_SLOTS; i++) {
+    if (!timerNext[i] || timerNext[i] > now) continue;
+    if (now - timerNext[i] > TIMER_LATE_MAX) continue;
+    DEBUG_PRINTF("Timer %d fires preset %d\n", i, timerMacro[i]);
+    unloadPlaylist();
+    applyPreset(timerMacro[i]);
+  }
+  scheduleTimers(now);
+}
+
+//upcoming timer events for /json/info
+void serializeTimers(JsonArray arr)
+{
+  for (uint8_t i = 0; i < TIMER_SLOTS; i++) {
+    if (!timerNext[i]) continue;
+    JsonObject t = arr.createNestedObject();
+    t["id"] = i;
+    t["ps"] = timerMacro[i];
+    t["t"]  = timerNext[i]; //unix time
   }
 }
 
 #define ZENITH -0.83
 // get sunrise (or sunset) time (in minutes) for a given day at a given geo location
-int getSunriseUTC(int year, int month, int day, float lat, float lon, bool sunset=false) {
+int getSunriseUTC(int year, int month, int day, float lat, float lon, bool sunset) {
   //1. first calculate the day of the year
   float N1 = 275 * month / 9;
   float N2 = (month + 9) / 12;
@@ -463,7 +654,7 @@ void calculateSunriseAndSunset() {
     tim_0.tm_sec = 0;
     tim_0.tm_isdst = 0;
 
-    int minUTC = getSunriseUTC(year(localTime), month(localTime), day(localTime), latitude, longitude);
+    int minUTC = getSunriseUTC(year(localTime), month(localTime), day(localTime), latitude, longitude, false);
     if (minUTC) {
       // there is a sunrise
       if (minUTC < 0) minUTC += 24*60; // add a day if negative
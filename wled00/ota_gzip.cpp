@@ -0,0 +1,169 @@
+#include "wled.h"
+
+/*
+ * Compressed firmware updates via /update (the .bin.gz written by pio-scripts/output_bins.py).
+ * ESP8266: the core's Updater takes gzip images as they are and the bootloader inflates them when copying.
+ * ESP32: the image is inflated while it is received by the ROM copy of miniz (tinfl) into a 32kB window,
+ * which is written to flash as it fills. The CRC32 and length in the gzip trailer are checked before the
+ * update is finished, Update.end() then verifies the image itself. Uncompressed images are written unchanged.
+ */
+#ifndef WLED_DISABLE_OTA
+
+#ifdef ARDUINO_ARCH_ESP32
+#include "rom/miniz.h"
+#include "rom/crc.h"
+
+#define GZIP_FLAG_HCRC    0x02
+#define GZIP_FLAG_EXTRA   0x04
+#define GZIP_FLAG_NAME    0x08
+#define GZIP_FLAG_COMMENT 0x10
+
+enum : uint8_t { GZ_HEADER, GZ_EXTRA_LEN, GZ_EXTRA, GZ_NAME, GZ_COMMENT, GZ_HCRC, GZ_DATA, GZ_TRAILER, GZ_DONE };
+
+typedef struct OtaInflater {
+  tinfl_decompressor inf;
+  uint8_t  window[TINFL_LZ_DICT_SIZE]; // output ring, also the back reference window
+  size_t   winPos;
+  uint32_t crc, size;                  // of the inflated image
+  uint8_t  state, flags;
+  uint16_t skip;                       // header bytes left in the current state
+  uint8_t  tail[10];                   // header, then trailer (CRC32, length)
+  uint8_t  tailLen;
+} ota_inflater;
+
+static ota_inflater* ota = nullptr;
+
+static void otaFree()
+{
+  free(ota);
+  ota = nullptr;
+}
+
+//next header state after the fixed part or an optional field
+static uint8_t gzNextState(uint8_t s, uint8_t flags)
+{
+  if (s < GZ_EXTRA_LEN && (flags & GZIP_FLAG_EXTRA))   return GZ_EXTRA_LEN;
+  if (s < GZ_NAME      && (flags & GZIP_FLAG_NAME))    return GZ_NAME;
+  if (s < GZ_COMMENT   && (flags & GZIP_FLAG_COMMENT)) return GZ_COMMENT;
+  if (s < GZ_HCRC      && (flags & GZIP_FLAG_HCRC))    return GZ_HCRC;
+  return GZ_DATA;
+}
+
+//returns the number of header bytes consumed
+static size_t gzHeader(const uint8_t* data, size_t len)
+{
+  size_t used = 0;
+  while (used < len && ota->state < GZ_DATA) {
+    uint8_t c = data[used++];
+    switch (ota->state) {
+      case GZ_HEADER:
+        ota->tail[ota->tailLen++] = c;
+        if (ota->tailLen < 10) break;
+        if (ota->tail[2] != 8) { Update.abort(); return len; } // deflate only
+        ota->flags = ota->tail[3];
+        ota->tailLen = 0;
+        ota->state = gzNextState(GZ_HEADER, ota->flags);
+        break;
+      case GZ_EXTRA_LEN:
+        ota->tail[ota->tailLen++] = c;
+        if (ota->tailLen < 2) break;
+        ota->skip = ota->tail[0] | (ota->tail[1] << 8);
+        ota->tailLen = 0;
+        ota->state = ota->skip ? GZ_EXTRA : gzNextState(GZ_EXTRA, ota->flags);
+        break;
+      case GZ_EXTRA:
+        if (--ota->skip == 0) ota->state = gzNextState(GZ_EXTRA, ota->flags);
+        break;
+      case GZ_NAME:
+      case GZ_COMMENT: // zero terminated
+        if (!c) ota->state = gzNextState(ota->state, ota->flags);
+        break;
+      case GZ_HCRC:
+        if (++ota->tailLen == 2) { ota->tailLen = 0; ota->state = GZ_DATA; }
+        break;
+    }
+  }
+  return used;
+}
+
+static void otaInflate(const uint8_t* data, size_t len)
+{
+  size_t used = gzHeader(data, len);
+  data += used; len -= used;
+  while (ota->state == GZ_DATA && !Update.hasError()) {
+    size_t inBytes = len, outBytes = TINFL_LZ_DICT_SIZE - ota->winPos;
+    tinfl_status st = tinfl_decompress(&ota->inf, data, &inBytes, ota->window, ota->window + ota->winPos, &outBytes, TINFL_FLAG_HAS_MORE_INPUT);
+    data += inBytes; len -= inBytes;
+    if (outBytes) {
+      Update.write(ota->window + ota->winPos, outBytes);
+      ota->crc = crc32_le(ota->crc, ota->window + ota->winPos, outBytes);
+      ota->size += outBytes;
+      ota->winPos = (ota->winPos + outBytes) & (TINFL_LZ_DICT_SIZE - 1);
+    }
+    if (st == TINFL_STATUS_DONE) ota->state = GZ_TRAILER;
+    else if (st < 0) { DEBUG_PRINTLN(F("OTA: inflate failed")); Update.abort(); }
+    else if (st == TINFL_STATUS_NEEDS_MORE_INPUT && !len) return;
+  }
+  while (ota->state == GZ_TRAILER && len--) {
+    ota->tail[ota->tailLen++] = *data++;
+    if (ota->tailLen == 8) ota->state = GZ_DONE;
+  }
+}
+#endif
+
+//called with the first chunk of the upload
+void otaBegin(const uint8_t* data, size_t len)
+{
+  #ifdef ESP8266
+  Update.runAsync(true);
+  #endif
+  Update.begin((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
+  #ifdef ARDUINO_ARCH_ESP32
+  otaFree();
+  if (len < 2 || data[0] != 0x1F || data[1] != 0x8B) return; // not gzip
+  DEBUG_PRINTLN(F("OTA: gzip image"));
+  ota = (ota_inflater*)malloc(sizeof(ota_inflater));
+  if (!ota) { DEBUG_PRINTLN(F("OTA: no memory to inflate")); Update.abort(); return; }
+  memset(ota, 0, sizeof(ota_inflater));
+  tinfl_init(&ota->inf);
+  #endif
+}
+
+void otaWrite(const uint8_t* data, size_t len)
+{
+  if (Update.hasError()) return;
+  #ifdef ARDUINO_ARCH_ESP32
+  if (ota) { otaInflate(data, len); return; }
+  #endif
+  Update.write((uint8_t*)data, len);
+}
+
+//called after the last chunk, returns true if the update was written and verified
+bool otaEnd()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  if (ota) {
+    bool ok = ota->state == GZ_DONE
+      && ota->crc  == (uint32_t)(ota->tail[0] | (ota->tail[1] << 8) | (ota->tail[2] << 16) | (ota->tail[3] << 24))
+      && ota->size == (uint32_t)(ota->tail[4] | (ota->tail[5] << 8) | (ota->tail[6] << 16) | (ota->tail[7] << 24));
+    otaFree();
+    if (!ok) {
+      DEBUG_PRINTLN(F("OTA: gzip image truncated or corrupt"));
+      if (!Update.hasError()) Update.abort();
+      return false;
+    }
+  }
+  #endif
+  return Update.end(true);
+}
+
+//drops an update that was begun but not completed
+void otaAbort()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  otaFree();
+  #endif
+  Update.end(false); // not finished, discards what was written
+}
+
+#endif
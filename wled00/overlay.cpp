@@ -4,6 +4,51 @@
  * Used to draw clock overlays over the strip
  */
 
+/*
+ * Overlay layer: runs of pixels with a fixed color, drawn over every frame. Overlays only rewrite their runs when
+ * their content changes (the analog clock once per second), composing a frame is a few setRange() calls.
+ * Runs belong to an owner (OVERLAY_OWNER_CLOCK or a usermod ID) and later runs are drawn over earlier ones.
+ */
+struct OverlayRun {
+  uint16_t start, stop; //inclusive
+  uint32_t color;
+  uint16_t owner;
+};
+
+static OverlayRun overlayRuns[WLED_MAX_OVERLAY_RUNS];
+static uint8_t overlayRunCount = 0;
+
+void overlayClear(uint16_t owner)
+{
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < overlayRunCount; i++) {
+    if (overlayRuns[i].owner != owner) overlayRuns[n++] = overlayRuns[i];
+  }
+  overlayRunCount = n;
+}
+
+//false if the layer is full
+bool overlaySetRange(uint16_t owner, uint16_t start, uint16_t stop, uint32_t color)
+{
+  if (stop < start) std::swap(start, stop);
+  if (overlayRunCount) { //extends the previous run
+    OverlayRun& last = overlayRuns[overlayRunCount -1];
+    if (last.owner == owner && last.color == color && last.stop +1 == start) { last.stop = stop; return true; }
+  }
+  if (overlayRunCount >= WLED_MAX_OVERLAY_RUNS) return false;
+  overlayRuns[overlayRunCount++] = {start, stop, color, owner};
+  return true;
+}
+
+static void overlayCompose()
+{
+  for (uint8_t i = 0; i < overlayRunCount; i++) {
+    const OverlayRun& r = overlayRuns[i];
+    if (r.start == r.stop) strip.setPixelColor(r.start, r.color);
+    else strip.setRange(r.start, r.stop, r.color);
+  }
+}
+
 void _overlayAnalogClock()
 {
   int overlaySize = overlayMax - overlayMin +1;
@@ -25,11 +70,11 @@ void _overlayAnalogClock()
   {
     if (secondPixel < analogClock12pixel)
     {
-      strip.setRange(analogClock12pixel, overlayMax, 0xFF0000);
-      strip.setRange(overlayMin, secondPixel, 0xFF0000);
+      overlaySetRange(OVERLAY_OWNER_CLOCK, analogClock12pixel, overlayMax, 0xFF0000);
+      overlaySetRange(OVERLAY_OWNER_CLOCK, overlayMin, secondPixel, 0xFF0000);
     } else
     {
-      strip.setRange(analogClock12pixel, secondPixel, 0xFF0000);
+      overlaySetRange(OVERLAY_OWNER_CLOCK, analogClock12pixel, secondPixel, 0xFF0000);
     }
   }
   if (analogClock5MinuteMarks)
@@ -38,12 +83,12 @@ void _overlayAnalogClock()
     {
       int pix = analogClock12pixel + round((overlaySize / 12.0) *i);
       if (pix > overlayMax) pix -= overlaySize;
-      strip.setPixelColor(pix, 0x00FFAA);
+      overlaySetPixel(OVERLAY_OWNER_CLOCK, pix, 0x00FFAA);
     }
   }
-  if (!analogClockSecondsTrail) strip.setPixelColor(secondPixel, 0xFF0000);
-  strip.setPixelColor(minutePixel, 0x00FF00);
-  strip.setPixelColor(hourPixel, 0x0000FF);
+  if (!analogClockSecondsTrail) overlaySetPixel(OVERLAY_OWNER_CLOCK, secondPixel, 0xFF0000);
+  overlaySetPixel(OVERLAY_OWNER_CLOCK, minutePixel, 0x00FF00);
+  overlaySetPixel(OVERLAY_OWNER_CLOCK, hourPixel, 0x0000FF);
 }
 
 
@@ -78,18 +123,41 @@ void _overlayAnalogCountdown()
     byte pixelCnt = perc*overlaySize;
     if (analogClock12pixel + pixelCnt > overlayMax)
     {
-      strip.setRange(analogClock12pixel, overlayMax, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
-      strip.setRange(overlayMin, overlayMin +pixelCnt -(1+ overlayMax -analogClock12pixel), ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      overlaySetRange(OVERLAY_OWNER_CLOCK, analogClock12pixel, overlayMax, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      overlaySetRange(OVERLAY_OWNER_CLOCK, overlayMin, overlayMin +pixelCnt -(1+ overlayMax -analogClock12pixel), ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
     } else
     {
-      strip.setRange(analogClock12pixel, analogClock12pixel + pixelCnt, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
+      overlaySetRange(OVERLAY_OWNER_CLOCK, analogClock12pixel, analogClock12pixel + pixelCnt, ((uint32_t)colSec[3] << 24)| ((uint32_t)colSec[0] << 16) | ((uint32_t)colSec[1] << 8) | colSec[2]);
     }
   }
 }
 
+//everything the clock depends on, it is drawn again when this changes
+static uint32_t clockOverlayKey()
+{
+  uint32_t key = countdownMode ? (uint32_t)toki.second() ^ countdownTime : (uint32_t)localTime;
+  key = key * 31 + (overlayMin | (overlayMax << 8) | (analogClock12pixel << 16));
+  key = key * 31 + (analogClockSecondsTrail | (analogClock5MinuteMarks << 1) | (countdownMode << 2));
+  return key * 31 + RGBW32(colSec[0], colSec[1], colSec[2], colSec[3]);
+}
+
 void handleOverlayDraw() {
+  static bool clockDrawn = false;
+  static uint32_t clockKey = 0;
   usermods.handleOverlayDraw();
-  if (overlayCurrent == 1) _overlayAnalogClock();
+  if (overlayCurrent == 1) {
+    uint32_t key = clockOverlayKey();
+    if (!clockDrawn || key != clockKey) {
+      overlayClear(OVERLAY_OWNER_CLOCK);
+      _overlayAnalogClock();
+      clockDrawn = true;
+      clockKey = key;
+    }
+  } else if (clockDrawn) {
+    overlayClear(OVERLAY_OWNER_CLOCK);
+    clockDrawn = false;
+  }
+  overlayCompose();
 }
 
 /*
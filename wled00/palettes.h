@@ -850,65 +850,66 @@ const byte candy2_gp[] PROGMEM = {
 // This will let us programmatically choose one based on
 // a number, rather than having to activate each explicitly
 // by name every time.
+// gradient palettes left out by WLED_PALETTE_SUBSET (see FX.h) are nullptr and not linked
 const byte* const gGradientPalettes[] PROGMEM = {
-  Sunset_Real_gp,               //13-00 Sunset
-  es_rivendell_15_gp,           //14-01 Rivendell
-  es_ocean_breeze_036_gp,       //15-02 Breeze
-  rgi_15_gp,                    //16-03 Red & Blue
-  retro2_16_gp,                 //17-04 Yellowout
-  Analogous_1_gp,               //18-05 Analogous
-  es_pinksplash_08_gp,          //19-06 Splash
-  Sunset_Yellow_gp,             //20-07 Pastel
-  Another_Sunset_gp,            //21-08 Sunset2
-  Beech_gp,                     //22-09 Beech
-  es_vintage_01_gp,             //23-10 Vintage
-  departure_gp,                 //24-11 Departure
-  es_landscape_64_gp,           //25-12 Landscape
-  es_landscape_33_gp,           //26-13 Beach
-  rainbowsherbet_gp,            //27-14 Sherbet
-  gr65_hult_gp,                 //28-15 Hult
-  gr64_hult_gp,                 //29-16 Hult64
-  GMT_drywet_gp,                //30-17 Drywet
-  ib_jul01_gp,                  //31-18 Jul
-  es_vintage_57_gp,             //32-19 Grintage
-  ib15_gp,                      //33-20 Rewhi
-  Tertiary_01_gp,               //34-21 Tertiary
-  lava_gp,                      //35-22 Fire
-  fierce_ice_gp,                //36-23 Icefire
-  Colorfull_gp,                 //37-24 Cyane
-  Pink_Purple_gp,               //38-25 Light Pink
-  es_autumn_19_gp,              //39-26 Autumn
-  BlacK_Blue_Magenta_White_gp,  //40-27 Magenta
-  BlacK_Magenta_Red_gp,         //41-28 Magred
-  BlacK_Red_Magenta_Yellow_gp,  //42-29 Yelmag
-  Blue_Cyan_Yellow_gp,          //43-30 Yelblu
-  Orange_Teal_gp,               //44-31 Orange & Teal
-  Tiamat_gp,                    //45-32 Tiamat
-  April_Night_gp,               //46-33 April Night
-  Orangery_gp,                  //47-34 Orangery
-  C9_gp,                        //48-35 C9
-  Sakura_gp,                    //49-36 Sakura
-  Aurora_gp,                    //50-37 Aurora
-  Atlantica_gp,                 //51-38 Atlantica
-  C9_2_gp,                      //52-39 C9 2
-  C9_new_gp,                    //53-40 C9 New
-  temperature_gp,               //54-41 Temperature
-  Aurora2_gp,                   //55-42 Aurora 2
-  retro_clown_gp,               //56-43 Retro Clown
-  candy_gp,                     //57-44 Candy
-  toxy_reaf_gp,                 //58-45 Toxy Reaf
-  fairy_reaf_gp,                //59-46 Fairy Reaf
-  semi_blue_gp,                 //60-47 Semi Blue
-  pink_candy_gp,                //61-48 Pink Candy
-  red_reaf_gp,                  //62-49 Red Reaf
-  aqua_flash_gp,                //63-50 Aqua Flash
-  yelblu_hot_gp,                //64-51 Yelblu Hot
-  lite_light_gp,                //65-52 Lite Light
-  red_flash_gp,                 //66-53 Red Flash
-  blink_red_gp,                 //67-54 Blink Red
-  red_shift_gp,                 //68-55 Red Shift
-  red_tide_gp,                  //69-56 Red Tide
-  candy2_gp                     //70-57 Candy2
+  PAL_ADD(13, Sunset_Real_gp),                //13-00 Sunset
+  PAL_ADD(14, es_rivendell_15_gp),            //14-01 Rivendell
+  PAL_ADD(15, es_ocean_breeze_036_gp),        //15-02 Breeze
+  PAL_ADD(16, rgi_15_gp),                     //16-03 Red & Blue
+  PAL_ADD(17, retro2_16_gp),                  //17-04 Yellowout
+  PAL_ADD(18, Analogous_1_gp),                //18-05 Analogous
+  PAL_ADD(19, es_pinksplash_08_gp),           //19-06 Splash
+  PAL_ADD(20, Sunset_Yellow_gp),              //20-07 Pastel
+  PAL_ADD(21, Another_Sunset_gp),             //21-08 Sunset2
+  PAL_ADD(22, Beech_gp),                      //22-09 Beech
+  PAL_ADD(23, es_vintage_01_gp),              //23-10 Vintage
+  PAL_ADD(24, departure_gp),                  //24-11 Departure
+  PAL_ADD(25, es_landscape_64_gp),            //25-12 Landscape
+  PAL_ADD(26, es_landscape_33_gp),            //26-13 Beach
+  PAL_ADD(27, rainbowsherbet_gp),             //27-14 Sherbet
+  PAL_ADD(28, gr65_hult_gp),                  //28-15 Hult
+  PAL_ADD(29, gr64_hult_gp),                  //29-16 Hult64
+  PAL_ADD(30, GMT_drywet_gp),                 //30-17 Drywet
+  PAL_ADD(31, ib_jul01_gp),                   //31-18 Jul
+  PAL_ADD(32, es_vintage_57_gp),              //32-19 Grintage
+  PAL_ADD(33, ib15_gp),                       //33-20 Rewhi
+  PAL_ADD(34, Tertiary_01_gp),                //34-21 Tertiary
+  PAL_ADD(35, lava_gp),                       //35-22 Fire
+  PAL_ADD(36, fierce_ice_gp),                 //36-23 Icefire
+  PAL_ADD(37, Colorfull_gp),                  //37-24 Cyane
+  PAL_ADD(38, Pink_Purple_gp),                //38-25 Light Pink
+  PAL_ADD(39, es_autumn_19_gp),               //39-26 Autumn
+  PAL_ADD(40, BlacK_Blue_Magenta_White_gp),   //40-27 Magenta
+  PAL_ADD(41, BlacK_Magenta_Red_gp),          //41-28 Magred
+  PAL_ADD(42, BlacK_Red_Magenta_Yellow_gp),   //42-29 Yelmag
+  PAL_ADD(43, Blue_Cyan_Yellow_gp),           //43-30 Yelblu
+  PAL_ADD(44, Orange_Teal_gp),                //44-31 Orange & Teal
+  PAL_ADD(45, Tiamat_gp),                     //45-32 Tiamat
+  PAL_ADD(46, April_Night_gp),                //46-33 April Night
+  PAL_ADD(47, Orangery_gp),                   //47-34 Orangery
+  PAL_ADD(48, C9_gp),                         //48-35 C9
+  PAL_ADD(49, Sakura_gp),                     //49-36 Sakura
+  PAL_ADD(50, Aurora_gp),                     //50-37 Aurora
+  PAL_ADD(51, Atlantica_gp),                  //51-38 Atlantica
+  PAL_ADD(52, C9_2_gp),                       //52-39 C9 2
+  PAL_ADD(53, C9_new_gp),                     //53-40 C9 New
+  PAL_ADD(54, temperature_gp),                //54-41 Temperature
+  PAL_ADD(55, Aurora2_gp),                    //55-42 Aurora 2
+  PAL_ADD(56, retro_clown_gp),                //56-43 Retro Clown
+  PAL_ADD(57, candy_gp),                      //57-44 Candy
+  PAL_ADD(58, toxy_reaf_gp),                  //58-45 Toxy Reaf
+  PAL_ADD(59, fairy_reaf_gp),                 //59-46 Fairy Reaf
+  PAL_ADD(60, semi_blue_gp),                  //60-47 Semi Blue
+  PAL_ADD(61, pink_candy_gp),                 //61-48 Pink Candy
+  PAL_ADD(62, red_reaf_gp),                   //62-49 Red Reaf
+  PAL_ADD(63, aqua_flash_gp),                 //63-50 Aqua Flash
+  PAL_ADD(64, yelblu_hot_gp),                 //64-51 Yelblu Hot
+  PAL_ADD(65, lite_light_gp),                 //65-52 Lite Light
+  PAL_ADD(66, red_flash_gp),                  //66-53 Red Flash
+  PAL_ADD(67, blink_red_gp),                  //67-54 Blink Red
+  PAL_ADD(68, red_shift_gp),                  //68-55 Red Shift
+  PAL_ADD(69, red_tide_gp),                   //69-56 Red Tide
+  PAL_ADD(70, candy2_gp)                      //70-57 Candy2
 };
 
 #endif
@@ -6,18 +6,24 @@
 
 typedef struct PlaylistEntry {
   uint8_t preset; //ID of the preset to apply
+  uint8_t bank;   //its preset bank, PRESET_BANK_ACTIVE for plain IDs
   uint16_t dur;   //Duration of the entry (in tenths of seconds)
   uint16_t tr;    //Duration of the transition TO this entry (in tenths of seconds)
-} ple;
+} __attribute__((packed)) ple; //6 bytes per entry, the length is only limited by the heap
+
+#ifndef PLAYLIST_PREFETCH_MS
+  #define PLAYLIST_PREFETCH_MS 1000 //the next preset is read into the preset cache this long before it is applied
+#endif
 
 byte           playlistRepeat = 1;        //how many times to repeat the playlist (0 = infinitely)
 byte           playlistEndPreset = 0;     //what preset to apply after playlist end (0 = stay on last preset)
 byte           playlistOptions = 0;       //bit 0: shuffle playlist after each iteration. bits 1-7 TBD
 
 PlaylistEntry *playlistEntries = nullptr;
-byte           playlistLen;               //number of playlist entries
-int8_t         playlistIndex = -1;
+uint16_t       playlistLen;               //number of playlist entries
+int16_t        playlistIndex = -1;
 uint16_t       playlistEntryDur = 0;      //duration of the current entry in tenths of seconds
+static unsigned long presetCycledTime = 0; //the current entry was applied
 
 //values we need to keep about the parent playlist while inside sub-playlist
 //int8_t         parentPlaylistIndex = -1;
@@ -57,17 +63,19 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
   unloadPlaylist();
   
   JsonArray presets = playlistObj["ps"];
-  playlistLen = presets.size();
+  playlistLen = min(presets.size(), (size_t)UINT16_MAX);
   if (playlistLen == 0) return -1;
-  if (playlistLen > 100) playlistLen = 100;
 
-  playlistEntries = new PlaylistEntry[playlistLen];
-  if (playlistEntries == nullptr) return -1;
+  playlistEntries = new (std::nothrow) PlaylistEntry[playlistLen];
+  if (playlistEntries == nullptr) { playlistLen = 0; return -1; }
 
-  byte it = 0;
-  for (int ps : presets) {
+  uint16_t it = 0;
+  for (JsonVariant ps : presets) { //ID or "bank:id"
     if (it >= playlistLen) break;
-    playlistEntries[it].preset = ps;
+    byte bank, index = 0;
+    if (!parsePresetRef(ps, &bank, &index)) bank = PRESET_BANK_ACTIVE;
+    playlistEntries[it].preset = index;
+    playlistEntries[it].bank = bank;
     it++;
   }
 
@@ -117,13 +125,35 @@ int16_t loadPlaylist(JsonObject playlistObj, byte presetId) {
 }
 
 
+int16_t getPlaylistIndex() {
+  return playlistIndex;
+}
+
+//continues a just loaded playlist at entry index, which is already shown (warm reboot, see resume.cpp)
+void resumePlaylist(int16_t index) {
+  if (currentPlaylist < 0 || index < 0 || index >= playlistLen) return;
+  playlistIndex = index;
+  playlistEntryDur = playlistEntries[index].dur;
+  presetCycledTime = millis();
+}
+
 void handlePlaylist() {
-  static unsigned long presetCycledTime = 0;
+  static bool nextPrefetched = false;
   // if fileDoc is not null JSON buffer is in use so just quit
   if (currentPlaylist < 0 || playlistEntries == nullptr || fileDoc != nullptr) return;
 
-  if (millis() - presetCycledTime > (100*playlistEntryDur)) {
+  unsigned long entryMs = 100UL * playlistEntryDur;
+  if (!nextPrefetched && entryMs > PLAYLIST_PREFETCH_MS && millis() - presetCycledTime > entryMs - PLAYLIST_PREFETCH_MS) {
+    nextPrefetched = true;
+    uint16_t next = (playlistIndex +1) % playlistLen;
+    if (next) prefetchPreset(playlistEntries[next].preset, playlistEntries[next].bank); // a shuffled roll-over is not known yet
+    else if (playlistRepeat == 1) prefetchPreset(playlistEndPreset);
+    else if (!(playlistOptions & PL_OPTION_SHUFFLE)) prefetchPreset(playlistEntries[0].preset, playlistEntries[0].bank);
+  }
+
+  if (millis() - presetCycledTime > entryMs) {
     presetCycledTime = millis();
+    nextPrefetched = false;
     if (bri == 0 || nightlightActive) return;
 
     ++playlistIndex %= playlistLen; // -1 at 1st run (limit to playlistLen)
@@ -143,6 +173,6 @@ void handlePlaylist() {
     jsonTransitionOnce = true;
     transitionDelayTemp = playlistEntries[playlistIndex].tr * 100;
     playlistEntryDur = playlistEntries[playlistIndex].dur;
-    applyPreset(playlistEntries[playlistIndex].preset);
+    applyPreset(playlistEntries[playlistIndex].preset, CALL_MODE_DIRECT_CHANGE, playlistEntries[playlistIndex].bank);
   }
 }
@@ -4,11 +4,241 @@
  * Methods to handle saving and loading presets to/from the filesystem
  */
 
-bool applyPreset(byte index, byte callMode)
+/*
+ * Recently applied presets are kept in RAM (PSRAM if available) as MessagePack, least recently used ones are
+ * evicted once PRESET_CACHE_SIZE bytes (1/32 of the PSRAM if larger) are taken. A cached preset is applied from its own document
+ * of the recorded size, without reading the file or waiting for the JSON buffer.
+ */
+#ifndef PRESET_CACHE_SIZE
+  #ifdef ESP8266
+  #define PRESET_CACHE_SIZE 2048
+  #else
+  #define PRESET_CACHE_SIZE 8192
+  #endif
+#endif
+#define PRESET_CACHE_ENTRIES 16
+
+#if PRESET_CACHE_SIZE > 0
+struct PresetCacheEntry {
+  uint8_t* data;    //MessagePack, nullptr: free
+  uint16_t len;
+  uint16_t docSize; //memory the document used when read from the file
+  uint16_t lastUse;
+  byte     id;
+  byte     bank;
+};
+
+static PresetCacheEntry presetCache[PRESET_CACHE_ENTRIES] = {};
+static size_t presetCacheUsed = 0;
+static uint16_t presetCacheClock = 0;
+static size_t presetCacheLimit = 0; //PRESET_CACHE_SIZE, more with PSRAM
+
+static inline size_t presetCacheSize()
+{
+  if (!presetCacheLimit) presetCacheLimit = scaledMemoryLimit(PRESET_CACHE_SIZE, 32);
+  return presetCacheLimit;
+}
+
+static void dropCachedEntry(PresetCacheEntry& e)
+{
+  free(e.data);
+  e.data = nullptr;
+  presetCacheUsed -= e.len;
+}
+
+//index 0: drop all presets of the bank
+void dropCachedPreset(byte index, byte bank)
+{
+  if (bank == PRESET_BANK_ACTIVE) bank = presetBank;
+  for (uint8_t i = 0; i < PRESET_CACHE_ENTRIES; i++) {
+    if (presetCache[i].data && presetCache[i].bank == bank && (!index || presetCache[i].id == index)) dropCachedEntry(presetCache[i]);
+  }
+}
+
+//takes an entry for len bytes of MessagePack, evicting the least recently used ones, nullptr if it does not fit
+static uint8_t* allocCachedPreset(byte bank, byte index, size_t len, size_t docSize)
+{
+  if (len > presetCacheSize()/2 || len > UINT16_MAX || docSize > UINT16_MAX) return nullptr;
+  dropCachedPreset(index, bank);
+
+  PresetCacheEntry* slot;
+  for (;;) { //evict least recently used until there is a free entry and enough space
+    PresetCacheEntry* lru = nullptr;
+    slot = nullptr;
+    for (uint8_t i = 0; i < PRESET_CACHE_ENTRIES; i++) {
+      if (!presetCache[i].data) { if (!slot) slot = &presetCache[i]; continue; }
+      if (!lru || uint16_t(presetCacheClock - presetCache[i].lastUse) > uint16_t(presetCacheClock - lru->lastUse)) lru = &presetCache[i];
+    }
+    if (slot && presetCacheUsed + len <= presetCacheSize()) break;
+    if (!lru) return nullptr;
+    dropCachedEntry(*lru);
+  }
+
+  slot->data = (uint8_t*) wledAlloc(len, ALLOC_COLD);
+  if (!slot->data) return nullptr;
+  slot->len = len;
+  slot->docSize = docSize;
+  slot->lastUse = ++presetCacheClock;
+  slot->id = index;
+  slot->bank = bank;
+  presetCacheUsed += len;
+  return slot->data;
+}
+
+static void cachePreset(byte bank, byte index, JsonDocument* doc)
+{
+  size_t len = measureMsgPack(*doc);
+  uint8_t* data = allocCachedPreset(bank, index, len, doc->memoryUsage());
+  if (data) serializeMsgPack(*doc, data, len);
+}
+
+//adds a preset that is already MessagePack (boot snapshot)
+void cachePresetMsgPack(byte bank, byte index, const uint8_t* msgPack, size_t len, size_t docSize)
+{
+  if (index == 0 || index >= 255 || bank >= WLED_PRESET_BANKS) return;
+  uint8_t* data = allocCachedPreset(bank, index, len, docSize);
+  if (data) memcpy(data, msgPack, len);
+}
+
+static PresetCacheEntry* findCachedPreset(byte bank, byte index)
+{
+  for (uint8_t i = 0; i < PRESET_CACHE_ENTRIES; i++) {
+    if (presetCache[i].data && presetCache[i].id == index && presetCache[i].bank == bank) return &presetCache[i];
+  }
+  return nullptr;
+}
+
+static bool applyCachedPreset(byte bank, byte index, byte callMode)
+{
+  PresetCacheEntry* e = findCachedPreset(bank, index);
+  if (!e) return false;
+  PSRAMDynamicJsonDocument doc(e->docSize);
+  if (doc.capacity() < e->docSize || deserializeMsgPack(doc, (const uint8_t*)e->data, e->len)) return false;
+  e->lastUse = ++presetCacheClock;
+  DEBUGFS_PRINTLN(F("Preset from cache"));
+  errorFlag = ERR_NONE;
+  deserializeState(doc.as<JsonObject>(), callMode, index);
+  return true;
+}
+
+//reads a preset into the cache ahead of applying it (playlists), skipped while the JSON buffer is in use
+void prefetchPreset(byte index, byte bank)
+{
+  if (bank == PRESET_BANK_ACTIVE) bank = presetBank;
+  if (index == 0 || index >= 255 || bank >= WLED_PRESET_BANKS || findCachedPreset(bank, index)) return;
+  char filename[16];
+  getPresetBankFile(filename, bank);
+  #ifdef WLED_USE_DYNAMIC_JSON
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  #else
+  if (!tryRequestJSONBufferLock(9)) return;
+  #endif
+  if (readObjectFromFileUsingId(filename, index, &doc) && !doc.overflowed()) {
+    JsonObject fdo = doc.as<JsonObject>();
+    if (fdo["ps"] == index) fdo.remove("ps");
+    cachePreset(bank, index, &doc);
+  }
+  releaseJSONBufferLock();
+}
+#else
+void dropCachedPreset(byte index, byte bank) {}
+void prefetchPreset(byte index, byte bank) {}
+void cachePresetMsgPack(byte bank, byte index, const uint8_t* msgPack, size_t len, size_t docSize) {}
+static void cachePreset(byte bank, byte index, JsonDocument* doc) {}
+static bool applyCachedPreset(byte bank, byte index, byte callMode) { return false; }
+#endif
+
+/*
+ * Preset banks are separate preset files. The active bank (presetBank) is the one presets are saved to and
+ * the only one with a resident preset index, presets of other banks can still be applied as "bank:id".
+ * Bank names are kept in /banks.json as {"<bank>":{"n":"name"}}.
+ */
+void getPresetBankFile(char* filename, byte bank)
+{
+  if (bank == PRESET_BANK_ACTIVE) bank = presetBank;
+  if (bank == 0) strcpy_P(filename, PSTR("/presets.json"));
+  else sprintf_P(filename, PSTR("/presets%d.json"), bank);
+}
+
+//"bank:id" or an ID of the active bank
+bool parsePresetRef(JsonVariant ref, byte* bank, byte* index)
+{
+  *bank = PRESET_BANK_ACTIVE;
+  const char* str = ref.as<const char*>();
+  const char* sep = str ? strchr(str, ':') : nullptr;
+  if (sep) {
+    int b = atoi(str), i = atoi(sep +1);
+    if (b < 0 || b >= WLED_PRESET_BANKS || i < 1 || i > 250) return false;
+    *bank = b;
+    *index = i;
+    return true;
+  }
+  if (!ref.is<int>() || ref.as<int>() < 1 || ref.as<int>() > 255) return false;
+  *index = ref.as<int>();
+  return true;
+}
+
+void setPresetBank(byte bank)
+{
+  if (bank >= WLED_PRESET_BANKS || bank == presetBank) return;
+  presetBank = bank;
+  currentPreset = 0;
+  dropPresetIndex(); //only the active bank is indexed
+  presetsModifiedTime = toki.second(); //UI reloads /presets.json
+  serializeConfig(); //the active bank is kept over reboots
+}
+
+void setPresetBankName(byte bank, const char* name)
+{
+  if (bank >= WLED_PRESET_BANKS) return;
+  StaticJsonDocument<JSON_OBJECT_SIZE(1) + 40> d;
+  if (name && *name) d["n"] = name;
+  writeObjectToFileUsingId("/banks.json", bank, &d);
+}
+
+//removes the presets and the name of a bank, bank 0 is only emptied of its name
+void deletePresetBank(byte bank)
+{
+  if (bank >= WLED_PRESET_BANKS) return;
+  if (bank) {
+    char filename[16];
+    getPresetBankFile(filename, bank);
+    if (bank == presetBank) setPresetBank(0);
+    WLED_FS.remove(filename);
+    fsCacheDrop(filename);
+    dropCachedPreset(0, bank);
+  }
+  setPresetBankName(bank, nullptr);
+  invalidateFSInfo();
+}
+
+//reads the preset into doc and applies it, streamed from the file if it does not fit into doc
+static void applyPresetUsingDoc(const char* filename, byte bank, byte index, JsonDocument* doc, byte callMode)
+{
+  errorFlag = readObjectFromFileUsingId(filename, index, doc) ? ERR_NONE : ERR_FS_PLOAD;
+  if (!errorFlag && doc->overflowed()) {
+    DEBUGFS_PRINTLN(F("Preset too large, streaming"));
+    errorFlag = applyObjectFromFileUsingId(filename, index, doc, callMode) ? ERR_NONE : ERR_FS_PLOAD;
+    return;
+  }
+  JsonObject fdo = doc->as<JsonObject>();
+  if (fdo["ps"] == index) fdo.remove("ps"); //remove load request for same presets to prevent recursive crash
+  if (!errorFlag && index < 255) cachePreset(bank, index, doc);
+  #ifdef WLED_DEBUG_FS
+    serializeJson(*doc, Serial);
+  #endif
+  deserializeState(fdo, callMode, index);
+}
+
+bool applyPreset(byte index, byte callMode, byte bank)
 {
   if (index == 0) return false;
+  if (bank == PRESET_BANK_ACTIVE) bank = presetBank;
+  if (bank >= WLED_PRESET_BANKS) return false;
 
-  const char *filename = index < 255 ? "/presets.json" : "/tmp.json";
+  char filename[16];
+  if (index < 255) getPresetBankFile(filename, bank);
+  else strcpy_P(filename, PSTR("/tmp.json"));
 
 	uint8_t core = 1;
 	//crude way to determine if this was called by a network request
@@ -16,35 +246,42 @@ bool applyPreset(byte index, byte callMode)
 	core = xPortGetCoreID();
 	#endif
 
+  if (index < 255) {
+    //a network request applying a preset holds the JSON buffer lock already, others take it like below
+    bool cached;
+    if (fileDoc && core) cached = applyCachedPreset(bank, index, callMode);
+    else {
+      #ifndef WLED_USE_DYNAMIC_JSON
+      if (!requestJSONBufferLock(9)) return false;
+      #endif
+      cached = applyCachedPreset(bank, index, callMode);
+      releaseJSONBufferLock();
+    }
+    if (cached) {
+      currentPreset = (bank == presetBank) ? index : 0; //IDs refer to the active bank
+      usermods.publish(UM_EVENT_PRESET, index);
+      return true;
+    }
+  }
+
 	//only allow use of fileDoc from the core responsible for network requests
 	//do not use active network request doc from preset called by main loop (playlist, schedule, ...)
   if (fileDoc && core) {
-    errorFlag = readObjectFromFileUsingId(filename, index, fileDoc) ? ERR_NONE : ERR_FS_PLOAD;
-    JsonObject fdo = fileDoc->as<JsonObject>();
-    if (fdo["ps"] == index) fdo.remove("ps"); //remove load request for same presets to prevent recursive crash
-    #ifdef WLED_DEBUG_FS
-      serializeJson(*fileDoc, Serial);
-    #endif
-    deserializeState(fdo, callMode, index);
+    applyPresetUsingDoc(filename, bank, index, fileDoc, callMode);
   } else {
     DEBUGFS_PRINTLN(F("Make read buf"));
     #ifdef WLED_USE_DYNAMIC_JSON
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
     #else
     if (!requestJSONBufferLock(9)) return false;
     #endif
-    errorFlag = readObjectFromFileUsingId(filename, index, &doc) ? ERR_NONE : ERR_FS_PLOAD;
-    JsonObject fdo = doc.as<JsonObject>();
-    if (fdo["ps"] == index) fdo.remove("ps");
-    #ifdef WLED_DEBUG_FS
-      serializeJson(doc, Serial);
-    #endif
-    deserializeState(fdo, callMode, index);
+    applyPresetUsingDoc(filename, bank, index, &doc, callMode);
     releaseJSONBufferLock();
   }
 
   if (!errorFlag) {
-    if (index < 255) currentPreset = index;
+    if (index < 255) currentPreset = (bank == presetBank) ? index : 0;
+    usermods.publish(UM_EVENT_PRESET, index);
     return true;
   }
   return false;
@@ -57,12 +294,14 @@ void savePreset(byte index, const char* pname, JsonObject saveobj)
   JsonObject sObj = saveobj;
 
   bool persist = (index != 255);
-  const char *filename = persist ? "/presets.json" : "/tmp.json";
+  char filename[16];
+  if (persist) getPresetBankFile(filename, PRESET_BANK_ACTIVE);
+  else strcpy_P(filename, PSTR("/tmp.json"));
 
   if (!fileDoc) {
     DEBUGFS_PRINTLN(F("Allocating saving buffer"));
     #ifdef WLED_USE_DYNAMIC_JSON
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
     #else
     if (!requestJSONBufferLock(10)) return;
     #endif
@@ -98,13 +337,21 @@ void savePreset(byte index, const char* pname, JsonObject saveobj)
 
     writeObjectToFileUsingId(filename, index, fileDoc);
   }
-  if (persist) presetsModifiedTime = toki.second(); //unix time
-  updateFSInfo();
+  if (persist) {
+    presetsModifiedTime = toki.second(); //unix time
+    dropCachedPreset(index);
+    if (index == bootPreset) dropBootSnapshot();
+  }
+  invalidateFSInfo();
 }
 
 void deletePreset(byte index) {
   StaticJsonDocument<24> empty;
-  writeObjectToFileUsingId("/presets.json", index, &empty);
+  char filename[16];
+  getPresetBankFile(filename, PRESET_BANK_ACTIVE);
+  writeObjectToFileUsingId(filename, index, &empty);
   presetsModifiedTime = toki.second(); //unix time
-  updateFSInfo();
+  dropCachedPreset(index);
+  if (index == bootPreset) dropBootSnapshot();
+  invalidateFSInfo();
 }
\ No newline at end of file
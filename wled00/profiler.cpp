@@ -0,0 +1,60 @@
+#include "wled.h"
+
+/*
+ * Frame profiler, see profiler.h
+ */
+#ifdef WLED_ENABLE_PROFILER
+
+static const char* const stageNames[PROF_STAGES] = {"pal", "abl", "show", "notif", "ws", "um"};
+
+void ProfilerClass::add(uint16_t* histogram, uint32_t us)
+{
+  uint8_t b = us ? 32 - __builtin_clz(us) : 0;
+  if (b >= PROFILER_BUCKETS) b = PROFILER_BUCKETS -1;
+  if (histogram[b] == UINT16_MAX) { // keep the distribution instead of saturating
+    for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) histogram[i] >>= 1;
+  }
+  histogram[b]++;
+}
+
+void ProfilerClass::reset()
+{
+  memset(_stage, 0, sizeof(_stage));
+  memset(_effect, 0, sizeof(_effect));
+  memset(_stageMax, 0, sizeof(_stageMax));
+}
+
+static void serializeHistogram(JsonArray arr, const uint16_t* histogram)
+{
+  for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) arr.add(histogram[i]);
+}
+
+static bool histogramEmpty(const uint16_t* histogram)
+{
+  for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) if (histogram[i]) return false;
+  return true;
+}
+
+void ProfilerClass::serialize(JsonObject root)
+{
+  JsonArray bounds = root.createNestedArray(F("us")); // upper bound of each bucket, last one is open ended
+  for (uint8_t i = 0; i < PROFILER_BUCKETS -1; i++) bounds.add(1UL << i);
+
+  JsonObject stages = root.createNestedObject(F("stages"));
+  JsonObject max = root.createNestedObject(F("max"));
+  for (uint8_t s = 0; s < PROF_STAGES; s++) {
+    serializeHistogram(stages.createNestedArray(stageNames[s]), _stage[s]);
+    max[stageNames[s]] = _stageMax[s];
+  }
+
+  JsonObject fx = root.createNestedObject(F("fx")); // by effect ID, only effects that ran
+  char id[4];
+  for (uint8_t m = 0; m < MODE_COUNT; m++) {
+    if (histogramEmpty(_effect[m])) continue;
+    itoa(m, id, 10);
+    serializeHistogram(fx.createNestedArray(id), _effect[m]);
+  }
+}
+
+ProfilerClass profiler = ProfilerClass();
+#endif
@@ -0,0 +1,61 @@
+#ifndef WLED_PROFILER_H
+#define WLED_PROFILER_H
+/*
+ * Build-time optional frame profiler (WLED_ENABLE_PROFILER)
+ * Execution times of effect functions and main loop stages are recorded in
+ * log2 bucketed histograms and served at /json/perf
+ */
+#ifdef WLED_ENABLE_PROFILER
+#include <Arduino.h>
+#include "src/dependencies/json/ArduinoJson-v6.h"
+#include "FX.h" // for MODE_COUNT
+
+// bucket 0 counts durations below 1us, bucket n durations in [2^(n-1), 2^n) us, the last bucket is open ended
+#define PROFILER_BUCKETS 16
+
+enum ProfilerStage : uint8_t {
+  PROF_PALETTE = 0,   // WS2812FX::handle_palette()
+  PROF_ABL,           // WS2812FX::estimateCurrentAndLimitBri()
+  PROF_BUS_SHOW,      // BusManager::show()
+  PROF_NOTIFICATIONS, // handleNotifications()
+  PROF_WS,            // handleWs()
+  PROF_USERMODS,      // UsermodManager::loop()
+  PROF_STAGES
+};
+
+class ProfilerClass {
+  private:
+    uint16_t _stage[PROF_STAGES][PROFILER_BUCKETS];
+    uint16_t _effect[MODE_COUNT][PROFILER_BUCKETS];
+    uint32_t _stageMax[PROF_STAGES];
+
+    static void add(uint16_t* histogram, uint32_t us);
+
+  public:
+    ProfilerClass() { reset(); }
+
+    inline void addStage(uint8_t stage, uint32_t us) {
+      if (stage >= PROF_STAGES) return;
+      add(_stage[stage], us);
+      if (us > _stageMax[stage]) _stageMax[stage] = us;
+    }
+    inline void addEffect(uint8_t mode, uint32_t us) {
+      if (mode < MODE_COUNT) add(_effect[mode], us);
+    }
+
+    void reset();
+    void serialize(JsonObject root);
+};
+
+extern ProfilerClass profiler;
+
+#define PROFILE_START(t)        uint32_t t = micros()
+#define PROFILE_STAGE(stage, t) profiler.addStage(stage, micros() - (t))
+#define PROFILE_EFFECT(mode, t) profiler.addEffect(mode, micros() - (t))
+#else
+#define PROFILE_START(t)
+#define PROFILE_STAGE(stage, t)
+#define PROFILE_EFFECT(mode, t)
+#endif
+
+#endif
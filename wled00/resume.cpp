@@ -0,0 +1,164 @@
+#include "wled.h"
+
+/*
+ * Warm resume: a compact copy of the live state (brightness, segments, preset and playlist position, realtime
+ * mode) in RTC memory, which survives OTA updates, crashes and watchdog resets but not a power cycle.
+ * It is written from the loop after every state change. beginStrip() restores it instead of applying the
+ * boot preset, so after a warm reboot the LEDs go on with what they showed instead of flashing the boot look.
+ * ESP8266 only has 512 bytes of RTC user memory (shared with OTA and the persisted time, see ntp.cpp), so the
+ * state is only kept there for up to 7 segments.
+ */
+#ifdef WLED_ENABLE_WARM_RESUME
+
+#ifdef ESP8266
+  #define RESUME_MAX_SEGMENTS 7
+  #ifndef WLED_RTC_RESUME_BLOCK
+    #define WLED_RTC_RESUME_BLOCK 67 //after the persisted time, up to the end (block 127)
+  #endif
+#else
+  #define RESUME_MAX_SEGMENTS MAX_NUM_SEGMENTS
+#endif
+#define RESUME_MAGIC 0x574C5253UL
+
+typedef struct ResumeSegment {
+  pixidx_t start, stop;
+  uint16_t offset, width;
+  uint8_t  id, mode, speed, intensity, palette, options, grouping, spacing, opacity, cct, layout2D, fps;
+  uint32_t colors[NUM_COLORS];
+} __attribute__((packed)) resume_segment; //32 bytes
+
+typedef struct ResumeState {
+  uint32_t magic;
+  uint32_t check;         //of the bytes after it, up to the last used segment
+  int16_t  playlist;      //currentPlaylist
+  int16_t  playlistIndex;
+  uint8_t  bri;           //target brightness
+  uint8_t  preset;        //currentPreset
+  uint8_t  realtime;      //realtimeMode
+  uint8_t  mainSegment;
+  uint8_t  segCount;
+  uint8_t  reserved[3];
+  ResumeSegment seg[RESUME_MAX_SEGMENTS];
+} __attribute__((packed)) resume_state;
+
+#ifdef ARDUINO_ARCH_ESP32
+RTC_NOINIT_ATTR static resume_state rtcResume;
+#endif
+
+static bool    resumeDirty = false;
+static uint8_t resumeRealtime = REALTIME_MODE_INACTIVE; //as last written
+
+static size_t resumeSize(uint8_t segCount) {
+  return offsetof(ResumeState, seg) + segCount * sizeof(ResumeSegment);
+}
+
+static uint32_t resumeCheck(const ResumeState& r) {
+  const uint8_t* p = (const uint8_t*)&r + offsetof(ResumeState, playlist);
+  size_t len = resumeSize(r.segCount) - offsetof(ResumeState, playlist);
+  uint32_t h = 2166136261UL; //FNV-1a
+  while (len--) h = (h ^ *p++) * 16777619UL;
+  return h;
+}
+
+//a warm reboot, RTC memory holds what was written before
+static bool warmReset() {
+  #ifdef ARDUINO_ARCH_ESP32
+  esp_reset_reason_t reason = esp_reset_reason();
+  return reason != ESP_RST_POWERON && reason != ESP_RST_BROWNOUT && reason != ESP_RST_UNKNOWN;
+  #else
+  uint32_t reason = ESP.getResetInfoPtr()->reason;
+  return reason != REASON_DEFAULT_RST && reason != REASON_DEEP_SLEEP_AWAKE;
+  #endif
+}
+
+//from stateUpdated(), the state is written by the next loop pass
+void markResumeState() {
+  resumeDirty = true;
+}
+
+void handleResume() {
+  if (!resumeDirty && realtimeMode == resumeRealtime) return;
+  resumeDirty = false;
+  resumeRealtime = realtimeMode;
+
+  #ifdef ARDUINO_ARCH_ESP32
+  ResumeState& r = rtcResume; //RTC slow memory is plain RAM
+  r.magic = 0; //invalid while written
+  #else
+  ResumeState r;
+  #endif
+  r.playlist = currentPlaylist;
+  r.playlistIndex = getPlaylistIndex();
+  r.bri = bri;
+  r.preset = currentPreset;
+  r.realtime = realtimeMode;
+  r.mainSegment = strip.getMainSegmentId();
+  r.segCount = 0;
+  memset(r.reserved, 0, sizeof(r.reserved));
+  for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+    WS2812FX::Segment& seg = strip.getSegment(i);
+    if (!seg.isActive()) continue;
+    if (r.segCount >= RESUME_MAX_SEGMENTS) { r.magic = 0; return; } //too many to keep, boot normally
+    ResumeSegment& s = r.seg[r.segCount++];
+    s.id = i;
+    s.start = seg.start; s.stop = seg.stop;
+    s.offset = seg.offset; s.width = seg.width;
+    s.mode = seg.mode; s.speed = seg.speed; s.intensity = seg.intensity; s.palette = seg.palette;
+    s.options = seg.options; s.grouping = seg.grouping; s.spacing = seg.spacing;
+    s.opacity = seg.opacity; s.cct = seg.cct; s.layout2D = seg.layout2D; s.fps = seg.fps;
+    memcpy(s.colors, seg.colors, sizeof(s.colors));
+  }
+  r.check = resumeCheck(r);
+  r.magic = RESUME_MAGIC;
+  #ifdef ESP8266
+  ESP.rtcUserMemoryWrite(WLED_RTC_RESUME_BLOCK, (uint32_t*)&r, (resumeSize(r.segCount) + 3) & ~3);
+  #endif
+}
+
+//from beginStrip(), true if the state before a warm reboot was restored (the boot preset is then not applied)
+bool restoreResumeState() {
+  if (!warmReset()) return false;
+  #ifdef ARDUINO_ARCH_ESP32
+  ResumeState& r = rtcResume;
+  #else
+  ResumeState r;
+  if (!ESP.rtcUserMemoryRead(WLED_RTC_RESUME_BLOCK, (uint32_t*)&r, sizeof(r))) return false;
+  #endif
+  if (r.magic != RESUME_MAGIC || r.segCount > RESUME_MAX_SEGMENTS || r.check != resumeCheck(r)) return false;
+  DEBUG_PRINTLN(F("Resuming state from RTC memory"));
+
+  //the playlist first, its preset may set brightness or segments, which the saved state then overrides
+  if (r.playlist > 0 && applyPreset(r.playlist, CALL_MODE_INIT)) resumePlaylist(r.playlistIndex);
+
+  for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+    bool kept = false;
+    for (uint8_t j = 0; j < r.segCount; j++) kept |= (r.seg[j].id == i);
+    if (!kept) strip.setSegment(i, 0, 0);
+  }
+  for (uint8_t j = 0; j < r.segCount; j++) {
+    ResumeSegment& s = r.seg[j];
+    if (s.id >= strip.getMaxSegments()) continue;
+    strip.setSegment(s.id, s.start, s.stop, s.grouping, s.spacing, s.offset);
+    strip.setSegment2D(s.id, s.width, s.layout2D);
+    WS2812FX::Segment& seg = strip.getSegment(s.id);
+    strip.setMode(s.id, s.mode);
+    seg.setSpeed(s.speed); seg.setIntensity(s.intensity); seg.setPalette(s.palette);
+    seg.options = s.options;
+    seg.opacity = s.opacity; seg.cct = s.cct; seg.fps = s.fps;
+    memcpy(seg.colors, s.colors, sizeof(seg.colors)); //no transition from the boot colors
+    seg.touch(SEG_DIFFERS_OPT | SEG_DIFFERS_BRI | SEG_DIFFERS_COL);
+    seg.refreshLightCapabilities();
+  }
+  strip.setMainSegmentId(r.mainSegment);
+  bri = r.bri;
+  if (bri) briLast = bri;
+  currentPreset = r.preset;
+  setValuesFromFirstSelectedSeg(); //colorUpdated() must not apply the boot values to the segments
+  stateChanged = false;            //and keep currentPreset
+  resumeRealtime = r.realtime;
+  //the LEDs still show the last realtime frame, nothing is rendered until the stream is back or times out
+  if (r.realtime != REALTIME_MODE_INACTIVE) realtimeLock(realtimeTimeoutMs, r.realtime);
+  return true;
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef WLED_RMT_SINGLE_H
+#define WLED_RMT_SINGLE_H
+
+/*
+ * RMT method with a single pixel buffer (WLED_USE_RMT_SINGLE_BUFFER, ESP32)
+ * The NeoPixelBus RMT methods keep an editing and a sending buffer, so the next frame can be drawn while
+ * the last one is on the wire. This one sends from the buffer the pixels are written to, it is encoded into
+ * pulses by the RMT translator at send time. As the translator reads it until the frame is out, getData()
+ * (used by every pixel access) waits for the send to finish, drawing no longer overlaps sending.
+ * Otherwise the same as NeoEsp32RmtMethodBase with a channel chosen at runtime.
+ */
+#ifdef ARDUINO_ARCH_ESP32
+#include "NeoPixelBus.h"
+
+template<typename T_SPEED> class NeoEsp32RmtSingleMethod {
+  public:
+  typedef NeoNoSettings SettingsObject;
+
+  NeoEsp32RmtSingleMethod(uint8_t pin, uint16_t pixelCount, size_t elementSize, size_t settingsSize, NeoBusChannel channel) :
+    _sizeData(pixelCount * elementSize + settingsSize), _pin(pin), _channel(static_cast<rmt_channel_t>(channel)) {
+    _data = static_cast<uint8_t*>(malloc(_sizeData));
+    if (_data) memset(_data, 0, _sizeData);
+  }
+
+  ~NeoEsp32RmtSingleMethod() {
+    rmt_wait_tx_done(_channel, RMT_SINGLE_TIMEOUT);
+    rmt_driver_uninstall(_channel);
+    gpio_matrix_out(_pin, SIG_GPIO_OUT_IDX, false, false);
+    pinMode(_pin, INPUT);
+    free(_data);
+  }
+
+  bool IsReadyToUpdate() const {
+    return rmt_wait_tx_done(_channel, 0) == ESP_OK;
+  }
+
+  void Initialize() {
+    rmt_config_t config = {};
+    config.rmt_mode = RMT_MODE_TX;
+    config.channel = _channel;
+    config.gpio_num = static_cast<gpio_num_t>(_pin);
+    config.mem_block_num = 1; //see PolyBus::planRmt()
+    config.tx_config.loop_en = false;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = T_SPEED::IdleLevel;
+    config.tx_config.carrier_en = false;
+    config.tx_config.carrier_level = RMT_CARRIER_LEVEL_LOW;
+    config.clk_div = T_SPEED::RmtClockDivider;
+    rmt_config(&config);
+    rmt_driver_install(_channel, 0, ESP_INTR_FLAG_IRAM | ESP_INTR_FLAG_LEVEL1);
+    rmt_translator_init(_channel, T_SPEED::Translate);
+  }
+
+  //the buffer stays as it is, there is nothing to keep consistent
+  void Update(bool) {
+    if (_data && rmt_wait_tx_done(_channel, RMT_SINGLE_TIMEOUT) == ESP_OK) rmt_write_sample(_channel, _data, _sizeData, false);
+  }
+
+  bool AlwaysUpdate() {
+    return false;
+  }
+
+  uint8_t* getData() const {
+    rmt_wait_tx_done(_channel, RMT_SINGLE_TIMEOUT);
+    return _data;
+  }
+
+  size_t getDataSize() const {
+    return _sizeData;
+  }
+
+  void applySettings(const SettingsObject&) {}
+
+  private:
+  static const TickType_t RMT_SINGLE_TIMEOUT = 10000 / portTICK_PERIOD_MS; //as NeoPixelBus, far longer than any frame
+  const size_t  _sizeData;
+  const uint8_t _pin;
+  const rmt_channel_t _channel;
+  uint8_t* _data;
+};
+
+typedef NeoEsp32RmtSingleMethod<NeoEsp32RmtSpeedWs2812x> NeoEsp32RmtSingleWs2812xMethod;
+typedef NeoEsp32RmtSingleMethod<NeoEsp32RmtSpeed400Kbps> NeoEsp32RmtSingle400KbpsMethod;
+
+#endif
+#endif
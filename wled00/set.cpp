@@ -78,7 +78,8 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     }
 
     uint8_t colorOrder, type, skip;
-    uint16_t length, start;
+    uint16_t length;
+    pixidx_t start;
     uint8_t pins[5] = {255, 255, 255, 255, 255};
 
     autoSegments = request->hasArg(F("MS"));
@@ -91,14 +92,14 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     strip.setTargetFps(request->arg(F("FR")).toInt());
 
     for (uint8_t s = 0; s < WLED_MAX_BUSSES; s++) {
-      char lp[4] = "L0"; lp[2] = 48+s; lp[3] = 0; //ascii 0-9 //strip data pin
-      char lc[4] = "LC"; lc[2] = 48+s; lc[3] = 0; //strip length
-      char co[4] = "CO"; co[2] = 48+s; co[3] = 0; //strip color order
-      char lt[4] = "LT"; lt[2] = 48+s; lt[3] = 0; //strip type
-      char ls[4] = "LS"; ls[2] = 48+s; ls[3] = 0; //strip start LED
-      char cv[4] = "CV"; cv[2] = 48+s; cv[3] = 0; //strip reverse
-      char sl[4] = "SL"; sl[2] = 48+s; sl[3] = 0; //skip first N LEDs
-      char rf[4] = "RF"; rf[2] = 48+s; rf[3] = 0; //refresh required
+      char lp[5] = "L0"; setBusFieldIndex(lp, s); //strip data pin
+      char lc[5] = "LC"; setBusFieldIndex(lc, s); //strip length
+      char co[5] = "CO"; setBusFieldIndex(co, s); //strip color order
+      char lt[5] = "LT"; setBusFieldIndex(lt, s); //strip type
+      char ls[5] = "LS"; setBusFieldIndex(ls, s); //strip start LED
+      char cv[5] = "CV"; setBusFieldIndex(cv, s); //strip reverse
+      char sl[5] = "SL"; setBusFieldIndex(sl, s); //skip first N LEDs
+      char rf[5] = "RF"; setBusFieldIndex(rf, s); //refresh required
       if (!request->hasArg(lp)) {
         DEBUG_PRINTLN(F("No data.")); break;
       }
@@ -121,6 +122,20 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       // actual finalization is done in WLED::loop() (removing old busses and adding new)
       if (busConfigs[s] != nullptr) delete busConfigs[s];
       busConfigs[s] = new BusConfig(type, pins, start, length, colorOrder, request->hasArg(cv), skip);
+      Bus* old = busses.getBus(s);
+      if (old && old->getSections() > 1 && old->getType() == busConfigs[s]->type) { // keep sections set up in cfg.json
+        uint8_t oldPins[5] = {255, 255, 255, 255, 255};
+        old->getPins(oldPins);
+        if (oldPins[0] == pins[0]) busConfigs[s]->setSectionPins(oldPins, old->sectionsMirrored());
+      }
+      if (old) busConfigs[s]->psu = old->psu; // as the power supply limits, only set in cfg.json
+      if (old && old->getType() == busConfigs[s]->type) {
+        busConfigs[s]->clockKHz = old->getClockKHz(); // SPI clock and network channel layout are only set in cfg.json
+        if (BusNetwork::isNetwork(type)) {
+          BusNetwork* nb = static_cast<BusNetwork*>(old);
+          busConfigs[s]->setNetOutput(nb->isRgbw(), nb->getUniverse(), nb->getChannel());
+        }
+      }
       doInitBusses = true;
     }
 
@@ -146,6 +161,9 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       irPin = -1;
     }
     irEnabled = request->arg(F("IT")).toInt();
+    #ifdef ARDUINO_ARCH_ESP32
+    PolyBus::rmtRxWanted() = irWantsRmt(irPin, irEnabled); // for the busses initialized next
+    #endif
     irApplyToAllSelected = !request->hasArg(F("MSO"));
 
     int hw_rly_pin = request->arg(F("RL")).toInt();
@@ -210,50 +228,15 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
   //SYNC
   if (subPage == 4)
   {
-    int t = request->arg(F("UP")).toInt();
-    if (t > 0) udpPort = t;
-    t = request->arg(F("U2")).toInt();
-    if (t > 0) udpPort2 = t;
-
-    syncGroups = request->arg(F("GS")).toInt();
-    receiveGroups = request->arg(F("GR")).toInt();
-
-    receiveNotificationBrightness = request->hasArg(F("RB"));
-    receiveNotificationColor = request->hasArg(F("RC"));
-    receiveNotificationEffects = request->hasArg(F("RX"));
-    receiveSegmentOptions = request->hasArg(F("SO"));
-    receiveSegmentBounds = request->hasArg(F("SG"));
+    setCfgSchemaFromForm(request, subPage); // ports, groups and checkboxes listed in cfgSchema (cfg.cpp)
     receiveNotifications = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects || receiveSegmentOptions);
     notifyDirectDefault = request->hasArg(F("SD"));
     notifyDirect = notifyDirectDefault;
-    notifyButton = request->hasArg(F("SB"));
-    notifyAlexa = request->hasArg(F("SA"));
-    notifyHue = request->hasArg(F("SH"));
-    notifyMacro = request->hasArg(F("SM"));
-    notifyTwice = request->hasArg(F("S2"));
-
-    nodeListEnabled = request->hasArg(F("NL"));
     if (!nodeListEnabled) Nodes.clear();
-    nodeBroadcastEnabled = request->hasArg(F("NB"));
-
-    receiveDirect = request->hasArg(F("RD"));
-    useMainSegmentOnly = request->hasArg(F("MO"));
-    e131SkipOutOfSequence = request->hasArg(F("ES"));
-    e131Multicast = request->hasArg(F("EM"));
-    t = request->arg(F("EP")).toInt();
-    if (t > 0) e131Port = t;
-    t = request->arg(F("EU")).toInt();
-    if (t >= 0  && t <= 63999) e131Universe = t;
-    t = request->arg(F("DA")).toInt();
-    if (t >= 0  && t <= 510) DMXAddress = t;
-    t = request->arg(F("DM")).toInt();
-    if (t >= DMX_MODE_DISABLED && t <= DMX_MODE_MULTIPLE_RGBW) DMXMode = t;
-    t = request->arg(F("ET")).toInt();
+
+    int t = request->arg(F("ET")).toInt();
     if (t > 99  && t <= 65000) realtimeTimeoutMs = t;
-    arlsForceMaxBri = request->hasArg(F("FB"));
-    arlsDisableGammaCorrection = request->hasArg(F("RG"));
-    t = request->arg(F("WO")).toInt();
-    if (t >= -255  && t <= 255) arlsOffset = t;
+    initE131Universes();
 
     alexaEnabled = request->hasArg(F("AL"));
     strlcpy(alexaInvocationName, request->arg(F("AI")).c_str(), 33);
@@ -378,6 +361,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
 				timerDayEnd[i] = request->arg(k).toInt();
       }
     }
+    invalidateTimers();
   }
 
   //SECURITY
@@ -386,6 +370,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
     if (request->hasArg(F("RS"))) //complete factory reset
     {
       WLED_FS.format();
+      doSerializeConfig = false; //a save still waiting would bring the old settings back
       clearEEPROM();
       serveMessage(request, 200, F("All Settings erased."), F("Connect to WLED-AP to setup again"),255);
       doReboot = true;
@@ -438,6 +423,9 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
       t = request->arg(argname).toInt();
       DMXFixtureMap[i] = t;
     }
+    RENDER_LOCK();
+    updateDMXMap();
+    RENDER_UNLOCK();
   }
   #endif
 
@@ -445,7 +433,7 @@ void handleSettingsSet(AsyncWebServerRequest *request, byte subPage)
   if (subPage == 8)
   {
     #ifdef WLED_USE_DYNAMIC_JSON
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
     #else
     if (!requestJSONBufferLock(5)) return;
     #endif
@@ -600,6 +588,7 @@ bool updateVal(const String* req, const char* key, byte* val, byte minv, byte ma
 bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
 {
   if (!(req.indexOf("win") >= 0)) return false;
+  RENDER_LOCK(); // may be called from network callbacks, do not change segments mid-frame
 
   int pos = 0;
   DEBUG_PRINT(F("API req: "));
@@ -642,8 +631,8 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   byte intensityIn = selseg.intensity;
   byte paletteIn   = selseg.palette;
 
-  uint16_t startI = selseg.start;
-  uint16_t stopI  = selseg.stop;
+  pixidx_t startI = selseg.start;
+  pixidx_t stopI  = selseg.stop;
   uint8_t  grpI   = selseg.grouping;
   uint16_t spcI   = selseg.spacing;
   pos = req.indexOf(F("&S=")); //segment start
@@ -836,9 +825,9 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
     WS2812FX::Segment& seg = strip.getSegment(i);
     if (i != selectedSeg && (singleSegment || !seg.isActive() || !seg.isSelected())) continue; // skip non main segments if not applying to all
     if (fxModeChanged)    strip.setMode(i, effectIn);
-    if (speedChanged)     seg.speed     = speedIn;
-    if (intensityChanged) seg.intensity = intensityIn;
-    if (paletteChanged)   seg.palette   = paletteIn;
+    if (speedChanged)     seg.setSpeed(speedIn);
+    if (intensityChanged) seg.setIntensity(intensityIn);
+    if (paletteChanged)   seg.setPalette(paletteIn);
   }
 
   //set advanced overlay
@@ -934,8 +923,8 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   if (pos > 0) {
     realtimeOverride = getNumVal(&req, pos);
     if (realtimeOverride > 2) realtimeOverride = REALTIME_OVERRIDE_ALWAYS;
-    if (realtimeMode && useMainSegmentOnly) {
-      strip.getMainSegment().setOption(SEG_OPTION_FREEZE, !realtimeOverride, strip.getMainSegmentId());
+    if (realtimeMode) {
+      strip.freezeLiveSegments(!realtimeOverride);
     }
   }
 
@@ -958,10 +947,14 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
   // you can add more if you need
 
   // global col[], effectCurrent, ... are updated in stateChanged()
-  if (!apply) return true; // when called by JSON API, do not call colorUpdated() here
+  if (!apply) {
+    RENDER_UNLOCK();
+    return true; // when called by JSON API, do not call colorUpdated() here
+  }
 
   pos = req.indexOf(F("&NN")); //do not send UDP notifications this time
   stateUpdated((pos > 0) ? CALL_MODE_NO_NOTIFY : CALL_MODE_DIRECT_CHANGE);
+  RENDER_UNLOCK();
 
   // internal call, does not send XML response
   pos = req.indexOf(F("IN"));
@@ -969,3 +962,93 @@ bool handleSet(AsyncWebServerRequest *request, const String& req, bool apply)
 
   return true;
 }
+
+
+/*
+ * Compact bulk API for automation systems, e.g. /bulk?A=128&0=x12,p5,c0FF8800&1=b64,c0FFFFFF
+ * A: brightness, T: 0 off, 1 on, 2 toggle, NN: do not notify
+ * <segment id> or * (all selected segments): comma separated tokens, a letter followed by its value
+ *   o on (0/1), b opacity, x effect, s speed, i intensity, p palette, c<slot><RRGGBB or WWRRGGBB> color
+ * Each value is scanned once, the request is applied with a single stateUpdated().
+ */
+static bool applyBulkSegment(uint8_t id, const char* tok)
+{
+  WS2812FX::Segment& seg = strip.getSegment(id);
+  while (*tok) {
+    char key = *tok++;
+    uint8_t slot = 0;
+    if (key == 'c') {
+      if (*tok < '0' || *tok > '2') return false;
+      slot = *tok++ - '0';
+    }
+    char* end;
+    uint32_t val = strtoul(tok, &end, (key == 'c') ? 16 : 10);
+    if (end == tok) return false;
+    uint8_t digits = end - tok;
+    uint8_t val8 = (val > 255) ? 255 : val;
+    switch (key) {
+      case 'o': seg.setOption(SEG_OPTION_ON, val, id); break;
+      case 'b': if (val8) seg.setOpacity(val8, id); seg.setOption(SEG_OPTION_ON, val8, id); break;
+      case 'x':
+        if (val >= strip.getModeCount()) return false;
+        if (currentPlaylist >= 0) unloadPlaylist();
+        strip.setMode(id, val);
+        break;
+      case 's': seg.speed     = val8; break;
+      case 'i': seg.intensity = val8; break;
+      case 'p':
+        if (val >= strip.getPaletteCount()) return false;
+        seg.palette = val;
+        break;
+      case 'c':
+        if (digits != 6 && digits != 8) return false;
+        seg.setColor(slot, val, id);
+        break;
+      default: return false;
+    }
+    if (*end == ',') end++;
+    else if (*end) return false;
+    tok = end;
+  }
+  return true;
+}
+
+void handleBulkSet(AsyncWebServerRequest *request)
+{
+  bool ok = true;
+  bool notify = true;
+  RENDER_LOCK(); // called from the network callback, do not change segments mid-frame
+
+  for (size_t i = 0; ok && i < request->params(); i++) {
+    AsyncWebParameter* p = request->getParam(i);
+    const char* name = p->name().c_str();
+    const char* val  = p->value().c_str();
+    if (isdigit(name[0])) {
+      char* end;
+      unsigned long id = strtoul(name, &end, 10); // checked before narrowing, 256 must not become segment 0
+      ok = !*end && id < strip.getMaxSegments() && strip.getSegment(id).isActive() && applyBulkSegment(id, val);
+    } else if (name[0] == '*' && !name[1]) {
+      for (uint8_t s = 0; ok && s < strip.getMaxSegments(); s++) {
+        WS2812FX::Segment& seg = strip.getSegment(s);
+        if (seg.isActive() && seg.isSelected()) ok = applyBulkSegment(s, val);
+      }
+    } else if (!strcmp_P(name, PSTR("A"))) {
+      bri = constrain(atoi(val), 0, 255);
+    } else if (!strcmp_P(name, PSTR("T"))) {
+      nightlightActive = false;
+      switch (atoi(val)) {
+        case 0: if (bri != 0) {briLast = bri; bri = 0;} break;
+        case 1: if (bri == 0) bri = briLast; break;
+        default: toggleOnOff();
+      }
+    } else if (!strcmp_P(name, PSTR("NN"))) {
+      notify = false;
+    } else ok = false;
+  }
+
+  stateUpdated(notify ? CALL_MODE_DIRECT_CHANGE : CALL_MODE_NO_NOTIFY); // parameters before a malformed one are applied
+  RENDER_UNLOCK();
+
+  if (ok) request->send(200, "application/json", F("{\"success\":true}"));
+  else    request->send(400, "application/json", F("{\"error\":4}"));
+}
@@ -1,5 +0,0 @@
-#include "BlynkSimpleEsp.h"
-
-WiFiClient _blynkWifiClient;
-BlynkArduinoClient _blynkTransport(_blynkWifiClient);
-BlynkWifi Blynk(_blynkTransport);
\ No newline at end of file
@@ -1,93 +0,0 @@
-/**
- * @file       BlynkSimpleEsp32.h
- * @author     Volodymyr Shymanskyy
- * @license    This project is released under the MIT License (MIT)
- * @copyright  Copyright (c) 2015 Volodymyr Shymanskyy
- * @date       Oct 2016
- * @brief
- *
- */
-
-#ifndef BlynkSimpleEsp_h
-#define BlynkSimpleEsp_h
-
-#define BLYNK_SEND_ATOMIC
-
-#include "Blynk/BlynkApiArduino.h"
-#include "Blynk/BlynkProtocol.h"
-#include "Blynk/BlynkArduinoClient.h"
-#ifdef ARDUINO_ARCH_ESP32
-#include <WiFi.h>
-#else
-#include <ESP8266WiFi.h>
-#endif
-
-class BlynkWifi
-    : public BlynkProtocol<BlynkArduinoClient>
-{
-    typedef BlynkProtocol<BlynkArduinoClient> Base;
-public:
-    BlynkWifi(BlynkArduinoClient& transp)
-        : Base(transp)
-    {}
-
-    void connectWiFi(const char* ssid, const char* pass)
-    {
-        BLYNK_LOG2(BLYNK_F("Connecting to "), ssid);
-        WiFi.mode(WIFI_STA);
-        if (pass && strlen(pass)) {
-            WiFi.begin(ssid, pass);
-        } else {
-            WiFi.begin(ssid);
-        }
-        while (WiFi.status() != WL_CONNECTED) {
-            BlynkDelay(500);
-        }
-        BLYNK_LOG1(BLYNK_F("Connected to WiFi"));
-
-        BLYNK_LOG_IP("IP: ", WiFi.localIP());
-    }
-
-    void config(const char* auth,
-                const char* domain = BLYNK_DEFAULT_DOMAIN,
-                uint16_t    port   = BLYNK_DEFAULT_PORT)
-    {
-        Base::begin(auth);
-        this->conn.begin(domain, port);
-    }
-
-    void config(const char* auth,
-                IPAddress   ip,
-                uint16_t    port = BLYNK_DEFAULT_PORT)
-    {
-        Base::begin(auth);
-        this->conn.begin(ip, port);
-    }
-
-    void begin(const char* auth,
-               const char* ssid,
-               const char* pass,
-               const char* domain = BLYNK_DEFAULT_DOMAIN,
-               uint16_t    port   = BLYNK_DEFAULT_PORT)
-    {
-        connectWiFi(ssid, pass);
-        config(auth, domain, port);
-        while(this->connect() != true) {}
-    }
-
-    void begin(const char* auth,
-               const char* ssid,
-               const char* pass,
-               IPAddress   ip,
-               uint16_t    port   = BLYNK_DEFAULT_PORT)
-    {
-        connectWiFi(ssid, pass);
-        config(auth, ip, port);
-        while(this->connect() != true) {}
-    }
-
-};
-
-extern BlynkWifi Blynk;
-
-#endif
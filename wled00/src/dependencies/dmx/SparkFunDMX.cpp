@@ -20,6 +20,7 @@ Distributed as-is; no warranty is given.
 
 #include "SparkFunDMX.h"
 #include <HardwareSerial.h>
+#include "driver/uart.h"
 
 #define dmxMaxChannel  512
 #define defaultMax 32
@@ -28,13 +29,15 @@ Distributed as-is; no warranty is given.
 #define DMXFORMAT      SERIAL_8N2
 #define BREAKSPEED     83333
 #define BREAKFORMAT    SERIAL_8N1
+#define DMX_UART       UART_NUM_2
+#define DMX_BREAK_BITS 25      // 100µs at 250kbit/s, DMX needs at least 88µs
 
 int enablePin = -1;		// disable the enable pin because it is not needed
 int rxPin = -1;       // disable the receiving pin because it is not needed
 int txPin = 2;        // transmit DMX data over this pin (default is pin 2)
 
 //DMX value array and size. Entry 0 will hold startbyte
-uint8_t dmxData[dmxMaxChannel] = {};
+uint8_t dmxData[dmxMaxChannel + 1] = {};
 int chanSize;
 int currentChannel = 0;
 
@@ -95,7 +98,17 @@ void SparkFunDMX::initWrite (int chanQuant) {
 
   chanSize = chanQuant + 1; //Add 1 for start code
 
-  DMXSerial.begin(DMXSPEED, DMXFORMAT, rxPin, txPin);
+  // the IDF driver sends from its TX ring buffer by interrupt and generates the break in hardware,
+  // so update() returns at once instead of waiting for the 23ms of a full universe
+  uart_config_t config = {};
+  config.baud_rate = DMXSPEED;
+  config.data_bits = UART_DATA_8_BITS;
+  config.parity    = UART_PARITY_DISABLE;
+  config.stop_bits = UART_STOP_BITS_2;
+  config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  uart_param_config(DMX_UART, &config);
+  uart_set_pin(DMX_UART, txPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+  uart_driver_install(DMX_UART, 256, 1024, 0, NULL, 0);
   pinMode(enablePin, OUTPUT);
   digitalWrite(enablePin, HIGH);
 }
@@ -116,22 +129,13 @@ void SparkFunDMX::write(int Channel, uint8_t value) {
 
 
 
-void SparkFunDMX::update() {
+bool SparkFunDMX::update() {
   if (_READWRITE == _WRITE)
   {
-    //Send DMX break
-    digitalWrite(txPin, HIGH);
-    DMXSerial.begin(BREAKSPEED, BREAKFORMAT, rxPin, txPin);//Begin the Serial port
-    DMXSerial.write(0);
-    DMXSerial.flush();
-    delay(1);
-    DMXSerial.end();
-    
-    //Send DMX data
-    DMXSerial.begin(DMXSPEED, DMXFORMAT, rxPin, txPin);//Begin the Serial port
-    DMXSerial.write(dmxData, chanSize);
-    DMXSerial.flush();
-    DMXSerial.end();//clear our DMX array, end the Hardware Serial port
+    //the break follows the data and so precedes the next frame, returns false while the last frame is still being sent
+    if (uart_wait_tx_done(DMX_UART, 0) != ESP_OK) return false;
+    uart_write_bytes_with_break(DMX_UART, (const char*)dmxData, chanSize, DMX_BREAK_BITS);
+    return true;
   }
   else if (_READWRITE == _READ)//In a perfect world, this function ends serial communication upon packet completion and attaches RX to a CHANGE interrupt so the start code can be read again
   { 
@@ -153,6 +157,7 @@ void SparkFunDMX::update() {
 	}
 	}
   }
+  return true;
 }
 
 // Function to update the DMX bus
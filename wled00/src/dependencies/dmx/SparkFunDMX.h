@@ -27,7 +27,7 @@ public:
   void initWrite(int maxChan);
   uint8_t read(int Channel);
   void write(int channel, uint8_t value);
-  void update();
+  bool update(); //write mode: false if the previous frame is still being sent
 private:
   uint8_t _startCodeValue = 0xFF;
   bool _READ = true;
@@ -40,6 +40,7 @@ ESPAsyncE131::ESPAsyncE131(e131_packet_callback_function callback) {
 
 bool ESPAsyncE131::begin(bool multicast, uint16_t port, uint16_t universe, uint8_t n) {
   bool success = false;
+  _multicast = false;
 
   if (multicast) {
 		success = initMulticast(port, universe, n);
@@ -50,6 +51,19 @@ bool ESPAsyncE131::begin(bool multicast, uint16_t port, uint16_t universe, uint8
   return success;
 }
 
+bool ESPAsyncE131::setMulticastUniverses(uint16_t universe, uint8_t n) {
+  if (!_multicast) return false;
+  if (!n) n = 1; // the listening group stays joined
+  uint32_t oldEnd = (uint32_t)_mcUniverse + _mcCount, newEnd = (uint32_t)universe + n;
+  for (uint32_t u = _mcUniverse; u < oldEnd; u++)
+    if (u < universe || u >= newEnd) joinUniverse(u, false);
+  for (uint32_t u = universe; u < newEnd; u++)
+    if (u < _mcUniverse || u >= oldEnd) joinUniverse(u, true);
+  _mcUniverse = universe;
+  _mcCount = n;
+  return true;
+}
+
 /////////////////////////////////////////////////////////
 //
 // Private init() members
@@ -73,16 +87,10 @@ bool ESPAsyncE131::initMulticast(uint16_t port, uint16_t universe, uint8_t n) {
     ((universe >> 0) & 0xff));
 
   if (udp.listenMulticast(address, port)) {
-    ip4_addr_t ifaddr;
-    ip4_addr_t multicast_addr;
-
-    ifaddr.addr = static_cast<uint32_t>(Network.localIP());
-    for (uint8_t i = 1; i < n; i++) {
-        multicast_addr.addr = static_cast<uint32_t>(IPAddress(239, 255,
-          (((universe + i) >> 8) & 0xff), (((universe + i) >> 0)
-          & 0xff)));
-      igmp_joingroup(&ifaddr, &multicast_addr);
-    }
+    for (uint8_t i = 1; i < n; i++) joinUniverse(universe + i, true);
+    _multicast = true;
+    _mcUniverse = universe;
+    _mcCount = n ? n : 1;
 
     udp.onPacket(std::bind(&ESPAsyncE131::parsePacket, this, std::placeholders::_1));
 
@@ -91,6 +99,17 @@ bool ESPAsyncE131::initMulticast(uint16_t port, uint16_t universe, uint8_t n) {
   return success;
 }
 
+void ESPAsyncE131::joinUniverse(uint16_t universe, bool join) {
+  ip4_addr_t ifaddr;
+  ip4_addr_t multicast_addr;
+
+  ifaddr.addr = static_cast<uint32_t>(Network.localIP());
+  multicast_addr.addr = static_cast<uint32_t>(IPAddress(239, 255,
+    ((universe >> 8) & 0xff), ((universe >> 0) & 0xff)));
+  if (join) igmp_joingroup(&ifaddr, &multicast_addr);
+  else      igmp_leavegroup(&ifaddr, &multicast_addr);
+}
+
 /////////////////////////////////////////////////////////
 //
 // Packet parsing - Private
@@ -110,8 +129,19 @@ void ESPAsyncE131::parsePacket(AsyncUDPPacket _packet) {
 	if (protocol == P_ARTNET) {
 		if (memcmp(sbuff->art_id, ESPAsyncE131::ART_ID, sizeof(sbuff->art_id)))
 			error = true; //not "Art-Net"
-		if (sbuff->art_opcode != ARTNET_OPCODE_OPDMX)
+		if (sbuff->art_opcode == ARTNET_OPCODE_OPSYNC)
+			protocol = P_ARTNET_SYNC;
+		else if (sbuff->art_opcode == ARTNET_OPCODE_OPPOLL && _packet.length() >= 14) {
+			protocol = P_ARTNET_POLL;
+			if (_packet.length() < 18) sbuff->poll_flags &= ~ARTNET_POLL_TARGETED; //no target range (before Art-Net 4)
+		}
+		else if (sbuff->art_opcode != ARTNET_OPCODE_OPDMX)
 			error = true; //not a DMX packet
+	} else if (htonl(sbuff->root_vector) == ESPAsyncE131::VECTOR_ROOT_EXTENDED) {
+		if (htonl(sbuff->sync_vector) == ESPAsyncE131::VECTOR_FRAME_SYNC)
+			protocol = P_E131_SYNC;
+		else
+			error = true; //universe discovery is not supported
 	} else { //E1.31 error handling
 		if (htonl(sbuff->root_vector) != ESPAsyncE131::VECTOR_ROOT)
 			error = true;
@@ -129,6 +159,7 @@ void ESPAsyncE131::parsePacket(AsyncUDPPacket _packet) {
   }
 
   if (!error) {
+    if (_repeater && _repeater(_packet.data(), _packet.length(), protocol, _packet.localPort(), *this)) return;
     _callback(sbuff, _packet.remoteIP(), protocol);
   }
 }
\ No newline at end of file
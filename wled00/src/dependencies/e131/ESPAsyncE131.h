@@ -51,13 +51,33 @@ typedef struct ip_addr ip4_addr_t;
 #define DDP_DEFAULT_PORT    4048
 
 #define DDP_PUSH_FLAG 0x01
+#define DDP_QUERY_FLAG 0x02
+#define DDP_REPLY_FLAG 0x04
 #define DDP_TIMECODE_FLAG 0x10
+#define DDP_FLAGS_VER1 0x40
 
-#define ARTNET_OPCODE_OPDMX 0x5000
+#define DDP_TYPE_RGB  1 // data type bits 5-3
+#define DDP_TYPE_RGBW 3
+
+#define DDP_ID_DISPLAY  1
+#define DDP_ID_CONTROL 246 // JSON control, config and status IDs up to 253 are not displayed
+#define DDP_ID_CONFIG  250
+#define DDP_ID_STATUS  251
+#define DDP_ID_ALL     255
+
+#define ARTNET_OPCODE_OPDMX  0x5000
+#define ARTNET_OPCODE_OPSYNC 0x5200
+#define ARTNET_OPCODE_OPPOLL 0x2000
+#define ARTNET_OPCODE_OPPOLLREPLY 0x2100
+
+#define ARTNET_POLL_TARGETED 0x20 //ArtPoll flag: only nodes with a port in the target range reply
 
 #define P_E131   0
 #define P_ARTNET 1
 #define P_DDP    2
+#define P_E131_SYNC   3 //E1.31 universe synchronization packet
+#define P_ARTNET_SYNC 4 //ArtSync
+#define P_ARTNET_POLL 5 //ArtPoll, discovery by a controller
 
 // E1.31 Packet Offsets
 #define E131_ROOT_PREAMBLE_SIZE 0
@@ -100,7 +120,7 @@ typedef union {
       uint32_t frame_vector;
       uint8_t  source_name[64];
       uint8_t  priority;
-      uint16_t reserved;
+      uint16_t sync_address;     //universe of the synchronization packets this data waits for, 0 if none
       uint8_t  sequence_number;
       uint8_t  options;
       uint16_t universe;
@@ -115,6 +135,15 @@ typedef union {
       uint8_t  property_values[513];
     } __attribute__((packed));
 	
+    struct { //E1.31 synchronization packet
+      uint8_t  sync_root[38];    //root layer as above
+      uint16_t sync_flength;
+      uint32_t sync_vector;
+      uint8_t  sync_sequence_number;
+      uint16_t sync_packet_address;
+      uint16_t sync_reserved;
+    } __attribute__((packed));
+
 	struct { //Art-Net packet
     uint8_t  art_id[8];
     uint16_t art_opcode;
@@ -127,6 +156,16 @@ typedef union {
     uint8_t  art_data[512];
   } __attribute__((packed));
 
+  struct { //ArtPoll packet
+    uint8_t  poll_id[8];
+    uint16_t poll_opcode;
+    uint16_t poll_protocol_ver;
+    uint8_t  poll_flags;
+    uint8_t  poll_diag_priority;
+    uint16_t poll_target_top;    //port-addresses (15 bit universes), big endian, if ARTNET_POLL_TARGETED
+    uint16_t poll_target_bottom;
+  } __attribute__((packed));
+
   struct { //DDP Header
     uint8_t flags;
     uint8_t sequenceNum;
@@ -154,31 +193,53 @@ typedef union {
 // new packet callback
 typedef void (*e131_packet_callback_function) (e131_packet_t* p, IPAddress clientIP, byte protocol);
 
+// raw packet hook, called before the packet callback with the receive buffer and the port it arrived on,
+// returns true if the packet is consumed (the packet callback is skipped)
+class ESPAsyncE131;
+typedef bool (*e131_repeat_callback_function) (uint8_t* data, size_t len, byte protocol, uint16_t port, ESPAsyncE131& via);
+
 class ESPAsyncE131 {
  private:
     // Constants for packet validation
     static const uint8_t ACN_ID[];
 	  static const uint8_t ART_ID[];
     static const uint32_t VECTOR_ROOT = 4;
+    static const uint32_t VECTOR_ROOT_EXTENDED = 8;
     static const uint32_t VECTOR_FRAME = 2;
+    static const uint32_t VECTOR_FRAME_SYNC = 1;
     static const uint8_t VECTOR_DMP = 2;
 
     AsyncUDP        udp;        // AsyncUDP
 
+    bool     _multicast = false;
+    uint16_t _mcUniverse = 0;   // first universe whose multicast group is joined
+    uint8_t  _mcCount = 0;      // groups joined
+
     // Internal Initializers
     bool initUnicast(uint16_t port);
     bool initMulticast(uint16_t port, uint16_t universe, uint8_t n = 1);
+    void joinUniverse(uint16_t universe, bool join);
 
     // Packet parser callback
     void parsePacket(AsyncUDPPacket _packet);
     
     e131_packet_callback_function _callback = nullptr;
+    e131_repeat_callback_function _repeater = nullptr;
 
  public:
     ESPAsyncE131(e131_packet_callback_function callback);
 
     // Generic UDP listener, no physical or IP configuration
     bool begin(bool multicast, uint16_t port = E131_DEFAULT_PORT, uint16_t universe = 1, uint8_t n = 1);
+
+    // Changes the joined multicast groups to universe .. universe+n-1, leaving only groups no longer needed
+    bool setMulticastUniverses(uint16_t universe, uint8_t n);
+    uint8_t getMulticastGroups() { return _multicast ? _mcCount : 0; }
+
+    // sees packets before they are processed, to send them on unchanged
+    void setRepeater(e131_repeat_callback_function repeater) { _repeater = repeater; }
+    // sends from the listening socket
+    bool send(const uint8_t* data, size_t len, IPAddress ip, uint16_t port) { return udp.writeTo(data, len, ip, port) == len; }
 };
 
 #endif  // ESPASYNCE131_H_
\ No newline at end of file
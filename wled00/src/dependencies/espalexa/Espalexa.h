@@ -62,6 +62,10 @@
 
 #define DEVICE_UNIQUE_ID_LENGTH 12
 
+#ifndef ESPALEXA_UDP_POLL_MS
+ #define ESPALEXA_UDP_POLL_MS 25 //SSDP discovery tolerates this latency, ESP32 parsePacket() allocates a buffer on every call
+#endif
+
 class Espalexa {
 private:
   //private member vars
@@ -85,6 +89,12 @@ private:
   IPAddress ipMulti;
   uint32_t mac24; //bottom 24 bits of mac
   String escapedMac=""; //lowercase mac address
+  uint32_t lastUdpPoll = 0;
+
+  //cached response to a request for all lights, rebuilt only if a device was added or changed
+  String lightsJson = "";
+  uint32_t lightsJsonRev = 0;
+  bool lightsJsonValid = false;
   
   //private member functions
   const char* modeString(EspalexaColorMode m)
@@ -150,11 +160,13 @@ private:
     char buf_col[80] = "";
     //color support
     if (static_cast<uint8_t>(dev->getType()) > 2)
-      //TODO: %f is not working for some reason on ESP8266 in v0.11.0 (was fine in 0.10.2). Need to investigate
-      //sprintf_P(buf_col,PSTR(",\"hue\":%u,\"sat\":%u,\"effect\":\"none\",\"xy\":[%f,%f]")
-      //  ,dev->getHue(), dev->getSat(), dev->getX(), dev->getY());
-      sprintf_P(buf_col,PSTR(",\"hue\":%u,\"sat\":%u,\"effect\":\"none\",\"xy\":[%s,%s]"),dev->getHue(), dev->getSat(),
-        ((String)dev->getX()).c_str(), ((String)dev->getY()).c_str());
+    {
+      //%f is not working on ESP8266 since v0.11.0, dtostrf() formats like String(float) without a heap copy
+      char buf_x[8], buf_y[8];
+      dtostrf(dev->getX(), 1, 2, buf_x);
+      dtostrf(dev->getY(), 1, 2, buf_y);
+      sprintf_P(buf_col,PSTR(",\"hue\":%u,\"sat\":%u,\"effect\":\"none\",\"xy\":[%s,%s]"),dev->getHue(), dev->getSat(), buf_x, buf_y);
+    }
       
     char buf_ct[16] = "";
     //white spectrum support
@@ -173,6 +185,36 @@ private:
     dev->getName().c_str(), modelidString(dev->getType()), static_cast<uint8_t>(dev->getType()), buf_lightid);
   }
   
+  //sum of the device revisions, changes whenever a device is added or any device state changes
+  uint32_t devicesRevision()
+  {
+    uint32_t rev = currentDeviceCount;
+    for (uint8_t i = 0; i < currentDeviceCount; i++) rev += devices[i]->getRevision();
+    return rev;
+  }
+
+  //all lights JSON object, the String keeps its capacity between rebuilds
+  const String& lightsJsonString()
+  {
+    uint32_t rev = devicesRevision();
+    if (lightsJsonValid && rev == lightsJsonRev) return lightsJson;
+
+    char buf[512];
+    lightsJson = "{";
+    for (uint8_t i = 0; i < currentDeviceCount; i++)
+    {
+      sprintf_P(buf, PSTR("\"%d\":"), encodeLightKey(i));
+      lightsJson += buf;
+      deviceJsonString(devices[i], buf);
+      lightsJson += buf;
+      if (i < currentDeviceCount-1) lightsJson += ',';
+    }
+    lightsJson += '}';
+    lightsJsonRev = rev;
+    lightsJsonValid = true;
+    return lightsJson;
+  }
+
   //Espalexa status page /espalexa
   #ifndef ESPALEXA_NO_SUBPAGE
   void servePage()
@@ -366,7 +408,9 @@ public:
     server->handleClient();
     #endif
     
-    if (!udpConnected) return;   
+    if (!udpConnected) return;
+    if (millis() - lastUdpPoll < ESPALEXA_UDP_POLL_MS) return;
+    lastUdpPoll = millis();
     int packetSize = espalexaUdp.parsePacket();    
     if (packetSize < 1) return; //no new udp packet
     
@@ -402,6 +446,7 @@ public:
     if (d == nullptr) return 0;
     d->setId(currentDeviceCount);
     devices[currentDeviceCount] = d;
+    lightsJsonValid = false;
     return ++currentDeviceCount;
   }
   
@@ -550,21 +595,7 @@ public:
       if (devId == 0) //client wants all lights
       {
         EA_DEBUGLN("lAll");
-        String jsonTemp = "{";
-        for (int i = 0; i<currentDeviceCount; i++)
-        {
-          jsonTemp += '"';
-          jsonTemp += encodeLightKey(i);
-          jsonTemp += '"';
-          jsonTemp += ':';
-
-          char buf[512];
-          deviceJsonString(devices[i], buf);
-          jsonTemp += buf;
-          if (i < currentDeviceCount-1) jsonTemp += ',';
-        }
-        jsonTemp += '}';
-        server->send(200, "application/json", jsonTemp);
+        server->send(200, "application/json", lightsJsonString());
       } else //client wants one light (devId)
       {
         EA_DEBUGLN(devId);
@@ -50,6 +50,11 @@ EspalexaDeviceType EspalexaDevice::getType()
   return _type;
 }
 
+uint32_t EspalexaDevice::getRevision()
+{
+  return _rev;
+}
+
 String EspalexaDevice::getName()
 {
   return _deviceName;
@@ -266,11 +271,14 @@ void EspalexaDevice::setId(uint8_t id)
 //you need to re-discover the device for the Alexa name to change
 void EspalexaDevice::setName(String name)
 {
+  if (_deviceName == name) return;
   _deviceName = name;
+  _rev++;
 }
 
 void EspalexaDevice::setValue(uint8_t val)
 {
+  if (val == _val) return;
   if (_val != 0)
   {
     _val_last = _val;
@@ -280,6 +288,7 @@ void EspalexaDevice::setValue(uint8_t val)
     _val_last = val;
   }
   _val = val;
+  _rev++;
 }
 
 void EspalexaDevice::setState(bool onoff)
@@ -306,6 +315,7 @@ void EspalexaDevice::setColorXY(float x, float y)
   _y = y;
   _rgb = 0;
   _mode = EspalexaColorMode::xy;
+  _rev++;
 }
 
 void EspalexaDevice::setColor(uint16_t hue, uint8_t sat)
@@ -314,6 +324,7 @@ void EspalexaDevice::setColor(uint16_t hue, uint8_t sat)
   _sat = sat;
   _rgb = 0;
   _mode = EspalexaColorMode::hs;
+  _rev++;
 }
 
 void EspalexaDevice::setColor(uint16_t ct)
@@ -321,17 +332,21 @@ void EspalexaDevice::setColor(uint16_t ct)
   _ct = ct;
   _rgb = 0;
   _mode =EspalexaColorMode::ct;
+  _rev++;
 }
 
 void EspalexaDevice::setColor(uint8_t r, uint8_t g, uint8_t b)
 {
+  uint32_t rgb = ((r << 16) | (g << 8) | b);
+  if (_mode == EspalexaColorMode::xy && _rgb == rgb && rgb) return; //unchanged, skip the conversion
   float X = r * 0.664511f + g * 0.154324f + b * 0.162028f;
   float Y = r * 0.283881f + g * 0.668433f + b * 0.047685f;
   float Z = r * 0.000088f + g * 0.072310f + b * 0.986039f;
   _x = X / (X + Y + Z);
   _y = Y / (X + Y + Z);
-  _rgb = ((r << 16) | (g << 8) | b);
+  _rgb = rgb;
   _mode = EspalexaColorMode::xy;
+  _rev++;
 }
 
 void EspalexaDevice::doCallback()
@@ -28,6 +28,7 @@ private:
   EspalexaDeviceType _type;
   EspalexaDeviceProperty _changed = EspalexaDeviceProperty::none;
   EspalexaColorMode _mode = EspalexaColorMode::xy;
+  uint32_t _rev = 0; //incremented on every change of the reported state
   
 public:
   EspalexaDevice();
@@ -57,6 +58,7 @@ public:
   uint8_t getW();
   EspalexaColorMode getColorMode();
   EspalexaDeviceType getType();
+  uint32_t getRevision();
   
   void setId(uint8_t id);
   void setPropertyChanged(EspalexaDeviceProperty p);
@@ -0,0 +1,74 @@
+#include "wled.h"
+
+/*
+ * Server-Sent Events at /events for integrations that cannot use WebSockets.
+ * A "state" event carrying the JSON state (without info) is sent whenever the WebSocket clients are updated
+ * and the state actually changed. Streams are capped at SSE_MAX_CLIENTS, further connections are closed.
+ */
+#ifdef WLED_ENABLE_SSE
+
+#ifndef SSE_MAX_CLIENTS
+  #ifdef ESP8266
+  #define SSE_MAX_CLIENTS 2
+  #else
+  #define SSE_MAX_CLIENTS 4
+  #endif
+#endif
+#define SSE_MAX_WAITING 2 // events queued per stream before pushes are held back, only the latest state matters
+
+static bool     ssePushPending = false; //held back or out of memory, retried from handleSse()
+static uint32_t sseLastHash = 0;        //FNV-1a of the last state sent
+static uint32_t sseEventId = 0;
+
+void initSse()
+{
+  sse.onConnect([](AsyncEventSourceClient *client) {
+    if (sse.count() > SSE_MAX_CLIENTS) { client->close(); return; }
+    sseLastHash = 0; //send the current state to the new stream (the others get it again)
+    ssePushPending = true;
+  });
+  server.addHandler(&sse);
+}
+
+void sendDataSse()
+{
+  if (!sse.count()) return;
+  ssePushPending = true;
+  if (sse.avgPacketsWaiting() >= SSE_MAX_WAITING) return;
+
+  #ifdef WLED_USE_DYNAMIC_JSON
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  JsonDocument* pDoc = &doc;
+  #else
+  JsonDocument* pDoc = requestJSONBuffer(18, false);
+  if (!pDoc) return;
+  #endif
+  serializeState(pDoc->to<JsonObject>());
+  size_t len = measureJson(*pDoc);
+  char* buf = (char*)malloc(len +1);
+  if (buf) serializeJson(*pDoc, buf, len +1);
+  #ifndef WLED_USE_DYNAMIC_JSON
+  releaseJSONBuffer(pDoc);
+  #endif
+  if (!buf) return;
+
+  uint32_t hash = 2166136261UL;
+  for (size_t i = 0; i < len; i++) hash = (hash ^ (uint8_t)buf[i]) * 16777619UL;
+  if (hash != sseLastHash) {
+    sse.send(buf, "state", ++sseEventId);
+    sseLastHash = hash;
+  }
+  free(buf);
+  ssePushPending = false;
+}
+
+void handleSse()
+{
+  if (ssePushPending) sendDataSse();
+}
+
+#else
+void initSse() {}
+void sendDataSse() {}
+void handleSse() {}
+#endif
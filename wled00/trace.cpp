@@ -0,0 +1,94 @@
+#include "wled.h"
+
+/*
+ * Event trace recorder, see trace.h
+ * GET /json/trace?on=1[&stop=40] clears the buffer and starts recording, stop= ends the recording by itself
+ * after a main loop iteration longer than the given ms, so the events leading up to a hitch are kept.
+ * GET /json/trace?on=0 stops, ?dl downloads the buffer as Chrome trace (recording is stopped first),
+ * without parameters the recorder status is returned.
+ */
+#ifdef WLED_ENABLE_TRACE
+
+static const char* const traceNames[TRACE_EVENT_TYPES] = {"loop", "segment", "show", "rt packet", "json lock", "file", "ws send", "usermod"};
+
+bool TracerClass::start(uint32_t stopAfterUs)
+{
+  _on = false;
+  if (!_events) _events = (trace_event*)malloc(WLED_TRACE_EVENTS * sizeof(trace_event));
+  if (!_events) return false;
+  _head = 0;
+  _lastLoop = 0;
+  _stopAfterUs = stopAfterUs;
+  _on = true;
+  return true;
+}
+
+void TracerClass::loopBoundary()
+{
+  if (!_on) return;
+  uint32_t now = micros();
+  if (_lastLoop) {
+    span(TRACE_LOOP, 0, _lastLoop);
+    if (_stopAfterUs && now - _lastLoop > _stopAfterUs) _on = false; // keep what led up to it
+  }
+  _lastLoop = now;
+}
+
+// writes the recorded events as Chrome trace JSON, one event per call of the chunk filler
+static void serveTraceFile(AsyncWebServerRequest* request)
+{
+  tracer.stop();
+  uint32_t count = tracer.count();
+  std::shared_ptr<uint32_t> pos = std::make_shared<uint32_t>(0); // 0 header, 1..count events, count+1 footer
+  AsyncWebServerResponse* response = request->beginChunkedResponse("application/json", [pos, count](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+    size_t len = 0;
+    while (*pos <= count + 1) {
+      char line[160];
+      int n;
+      if (*pos == 0) {
+        n = snprintf_P(line, sizeof(line), PSTR("{\"displayTimeUnit\":\"ms\",\"otherData\":{\"version\":\"%s\",\"recorded\":%u},\"traceEvents\":[\n"),
+                       versionString, (unsigned)tracer.recorded());
+      } else if (*pos == count + 1) {
+        n = snprintf_P(line, sizeof(line), PSTR("]}\n"));
+      } else {
+        const trace_event* e = tracer.event(*pos - 1);
+        uint32_t t0 = tracer.event(0)->start;
+        n = snprintf_P(line, sizeof(line), PSTR("%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%u}}\n"),
+                       *pos > 1 ? "," : "", e->type < TRACE_EVENT_TYPES ? traceNames[e->type] : "?",
+                       (unsigned)(e->start - t0), (unsigned)e->dur, e->core, e->arg);
+      }
+      if (n <= 0 || len + n > maxLen) break;
+      memcpy(buf + len, line, n);
+      len += n;
+      (*pos)++;
+    }
+    return len;
+  });
+  response->addHeader(F("Content-Disposition"), F("attachment; filename=\"wled_trace.json\""));
+  request->send(response);
+}
+
+void serveTrace(AsyncWebServerRequest* request)
+{
+  if (request->hasParam(F("dl"))) {
+    serveTraceFile(request);
+    return;
+  }
+  bool ok = true;
+  if (request->hasParam(F("on"))) {
+    if (request->getParam(F("on"))->value().toInt()) {
+      uint32_t stopMs = request->hasParam(F("stop")) ? request->getParam(F("stop"))->value().toInt() : 0;
+      ok = tracer.start(stopMs * 1000);
+    } else {
+      tracer.stop();
+    }
+  }
+  char json[96];
+  snprintf_P(json, sizeof(json), PSTR("{\"on\":%s,\"n\":%u,\"rec\":%u,\"cap\":%u,\"stop\":%u}"), tracer.isOn() ? "true" : "false",
+             (unsigned)tracer.count(), (unsigned)tracer.recorded(), (unsigned)WLED_TRACE_EVENTS, (unsigned)(tracer.stopAfter() / 1000));
+  request->send(ok ? 200 : 503, "application/json", json);
+}
+
+TracerClass tracer = TracerClass();
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef WLED_TRACE_H
+#define WLED_TRACE_H
+/*
+ * Build-time optional event trace recorder (WLED_ENABLE_TRACE)
+ * Timed events (main loop iterations, segment renders, bus show, realtime packets, JSON buffer locks,
+ * file access, websocket pushes, usermod loops) are written to a ring buffer without locking,
+ * so the most recent WLED_TRACE_EVENTS are kept. Recording is started and stopped via /json/trace,
+ * optionally stopping by itself after a main loop iteration exceeding a threshold, and the buffer
+ * is downloaded in Chrome trace format (load in ui.perfetto.dev or chrome://tracing), see trace.cpp
+ */
+#ifdef WLED_ENABLE_TRACE
+#include <Arduino.h>
+
+#ifndef WLED_TRACE_EVENTS
+  #ifdef ESP8266
+    #define WLED_TRACE_EVENTS 256   // 3kB
+  #else
+    #define WLED_TRACE_EVENTS 1024  // 12kB
+  #endif
+#endif
+static_assert((WLED_TRACE_EVENTS & (WLED_TRACE_EVENTS - 1)) == 0, "WLED_TRACE_EVENTS must be a power of 2");
+
+enum TraceEventType : uint8_t {
+  TRACE_LOOP = 0,   // main loop iteration
+  TRACE_SEGMENT,    // effect of a segment rendered, arg: segment
+  TRACE_SHOW,       // BusManager::show()
+  TRACE_RT_PACKET,  // realtime packet processed, arg: realtime mode
+  TRACE_JSON_LOCK,  // JSON buffer held, arg: module
+  TRACE_FILE,       // JSON object read or written, arg: 0 read, 1 write
+  TRACE_WS_SEND,    // websocket state push
+  TRACE_USERMOD,    // usermod loop(), arg: usermod ID
+  TRACE_EVENT_TYPES
+};
+
+typedef struct TraceEvent {
+  uint32_t start; // micros()
+  uint32_t dur;   // us
+  uint16_t arg;
+  uint8_t  type;
+  uint8_t  core;
+} trace_event;
+
+class TracerClass {
+  private:
+    trace_event* _events = nullptr;
+    volatile uint32_t _head = 0;  // events recorded since start, the next one goes to _head % WLED_TRACE_EVENTS
+    volatile bool _on = false;
+    uint32_t _stopAfterUs = 0;    // stop once a loop iteration takes longer, 0 to keep recording
+    uint32_t _lastLoop = 0;
+
+  public:
+    inline void span(uint8_t type, uint16_t arg, uint32_t start) {
+      if (!_on) return;
+      uint32_t now = micros();
+      #ifdef ARDUINO_ARCH_ESP32
+      uint32_t n = __atomic_fetch_add(&_head, 1, __ATOMIC_RELAXED); // render worker and network tasks record too
+      trace_event& e = _events[n & (WLED_TRACE_EVENTS - 1)];
+      e.core = xPortGetCoreID();
+      #else
+      trace_event& e = _events[_head++ & (WLED_TRACE_EVENTS - 1)];
+      e.core = 0;
+      #endif
+      e.start = start;
+      e.dur = now - start;
+      e.arg = arg;
+      e.type = type;
+    }
+    void loopBoundary(); // called at the start of each main loop iteration
+
+    bool start(uint32_t stopAfterUs);
+    void stop() { _on = false; }
+    inline bool isOn() const { return _on; }
+    inline uint32_t count() const { return _head < WLED_TRACE_EVENTS ? _head : WLED_TRACE_EVENTS; }
+    inline uint32_t recorded() const { return _head; }
+    inline uint32_t stopAfter() const { return _stopAfterUs; }
+    const trace_event* event(uint32_t i) const { // oldest first
+      return _events ? &_events[(_head - count() + i) & (WLED_TRACE_EVENTS - 1)] : nullptr;
+    }
+};
+
+extern TracerClass tracer;
+
+#define TRACE_START(t)          uint32_t t = micros()
+#define TRACE_SPAN(type, arg, t) tracer.span(type, arg, t)
+#define TRACE_LOOP_BOUNDARY()   tracer.loopBoundary()
+#else
+#define TRACE_START(t)
+#define TRACE_SPAN(type, arg, t)
+#define TRACE_LOOP_BOUNDARY()
+#endif
+
+#endif
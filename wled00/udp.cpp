@@ -6,27 +6,418 @@
 
 #define UDP_SEG_SIZE 28
 #define SEG_OFFSET (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE))
-#define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+0)
+#define UDP_SYNC_TRAILER_SIZE 7 //version 12: state version (4 bytes), flags and effect seed (2 bytes) after the last segment
+#define WLEDPACKETSIZE (41+(MAX_NUM_SEGMENTS*UDP_SEG_SIZE)+UDP_SYNC_TRAILER_SIZE)
+#define UDP_SYNC_FLAG_FULL 0x01      //packet contains all segments
+#define UDP_SYNC_FULL_EVERY 16       //every n-th notification contains all segments
+#define UDP_SYNC_RESYNC_REQUEST 250  //call mode byte of a resync request, ignored by receivers older than version 12
+#define UDP_SYNC_RESYNC_MS 250       //min. time between resync requests and between full state answers
+#define UDP_SYNC_PEERS 8             //senders whose state version is tracked
+#define UDP_CLOCK_REQUEST 251        //call mode byte of a clock sync request and its reply
+#define UDP_CLOCK_REPLY 252
+#define UDP_CLOCK_POLL_MS 2000       //time between clock requests to the clock source
+#define UDP_CLOCK_SAMPLES 4          //the sample with the lowest round trip of the last n is used
+#define UDP_CLOCK_MAX_RTT_US 100000  //slower replies are ignored
+#define UDP_CLOCK_STEP_US 20000      //larger offsets are corrected at once, smaller ones gradually
+#define UDP_CLOCK_MAX_MISSES 5       //unanswered requests until the source is considered not to support clock sync
 #define UDP_IN_MAXSIZE 1472
 #define PRESUMED_NETWORK_DELAY 3 //how many ms could it take on avg to reach the receiver? This will be added to transmitted times
 
-void notify(byte callMode, bool followUp)
+//receive buffer of the notifier and UDP realtime protocols, allocated once on first use
+//instead of a packet sized array on the stack (only 4k on ESP8266)
+static uint8_t* udpInBuffer = nullptr;
+
+#ifdef WLED_ENABLE_UDP_RX_TASK
+/*
+ * UDP receive task: the sockets are AsyncUDP listeners (like E1.31 and DDP), their callback runs in the async_udp task
+ * as soon as a packet arrives and copies it into a free slot of a small pool. handleNotifications() takes every queued
+ * packet each loop, so none waits for the next parsePacket() poll and bursts are not limited to one packet per loop.
+ * Packets arriving while all slots are taken are dropped and counted.
+ */
+struct UdpRxPacket {
+  IPAddress ip;
+  uint16_t  port;
+  uint16_t  len;
+  uint8_t   socket;
+  uint8_t   data[UDP_IN_MAXSIZE +1];
+};
+static AsyncUDP      udpRx[3];             // by UDP_SOCKET_*
+static UdpRxPacket*  udpRxSlots = nullptr;
+static QueueHandle_t udpRxQueue = nullptr; // indices of received packets
+static QueueHandle_t udpRxFree  = nullptr; // indices of free slots
+static uint32_t      udpRxDropped = 0;
+
+static void onUdpRxPacket(uint8_t socket, AsyncUDPPacket& packet)
 {
-  if (!udpConnected) return;
-  if (!syncGroups) return;
-  switch (callMode)
-  {
-    case CALL_MODE_INIT:          return;
-    case CALL_MODE_DIRECT_CHANGE: if (!notifyDirect) return; break;
-    case CALL_MODE_BUTTON:        if (!notifyButton) return; break;
-    case CALL_MODE_BUTTON_PRESET: if (!notifyButton) return; break;
-    case CALL_MODE_NIGHTLIGHT:    if (!notifyDirect) return; break;
-    case CALL_MODE_HUE:           if (!notifyHue)    return; break;
-    case CALL_MODE_PRESET_CYCLE:  if (!notifyDirect) return; break;
-    case CALL_MODE_BLYNK:         if (!notifyDirect) return; break;
-    case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
-    default: return;
+  size_t len = packet.length();
+  if (!len || len > UDP_IN_MAXSIZE) return;
+  uint8_t slot;
+  if (xQueueReceive(udpRxFree, &slot, 0) != pdTRUE) { udpRxDropped++; return; }
+  UdpRxPacket& p = udpRxSlots[slot];
+  p.ip     = packet.remoteIP();
+  p.port   = packet.remotePort();
+  p.len    = len;
+  p.socket = socket;
+  memcpy(p.data, packet.data(), len);
+  xQueueSend(udpRxQueue, &slot, 0);
+}
+#endif
+
+//starts listening on one of the UDP_SOCKET_* sockets, replaces WiFiUDP::begin()
+bool beginUdpSocket(uint8_t socket, uint16_t port)
+{
+  #ifdef WLED_ENABLE_UDP_RX_TASK
+  if (!udpRxSlots) {
+    udpRxSlots = (UdpRxPacket*) malloc(WLED_UDP_RX_SLOTS * sizeof(UdpRxPacket));
+    if (!udpRxSlots) return false;
+    udpRxQueue = xQueueCreate(WLED_UDP_RX_SLOTS, sizeof(uint8_t));
+    udpRxFree  = xQueueCreate(WLED_UDP_RX_SLOTS, sizeof(uint8_t));
+    for (uint8_t i = 0; i < WLED_UDP_RX_SLOTS; i++) xQueueSend(udpRxFree, &i, 0);
+  }
+  AsyncUDP& udp = udpRx[socket];
+  if (!udp.listen(port)) return false; // closes a previous listener
+  udp.onPacket([socket](AsyncUDPPacket& packet) { onUdpRxPacket(socket, packet); });
+  return true;
+  #else
+  switch (socket) {
+    case UDP_SOCKET_NOTIFIER:  return notifierUdp.begin(port);
+    case UDP_SOCKET_RGB:       return rgbUdp.begin(port);
+    case UDP_SOCKET_NOTIFIER2: return notifier2Udp.begin(port);
+  }
+  return false;
+  #endif
+}
+
+//sends from the port of the socket, so replies reach its listener
+static void sendUdp(uint8_t socket, IPAddress ip, uint16_t port, const uint8_t* data, size_t len)
+{
+  #ifdef WLED_ENABLE_UDP_RX_TASK
+  udpRx[socket].writeTo(data, len, ip, port);
+  #else
+  WiFiUDP& udp = (socket == UDP_SOCKET_NOTIFIER2) ? notifier2Udp : notifierUdp;
+  udp.beginPacket(ip, port);
+  udp.write(data, len);
+  udp.endPacket();
+  #endif
+}
+
+/*
+ * Realtime mapping: the LEDs each stream pixel is written to, built from realtimeRegions by initRealtimeMap().
+ * Stored by stream pixel (rtMapFirst[p] .. rtMapFirst[p+1] index rtMapDest), so a packet costs one lookup per pixel.
+ */
+static uint16_t  rtMapLen = 0;          // stream pixels covered, 0 if not mapping
+static uint16_t* rtMapFirst = nullptr;  // rtMapLen+1 offsets into rtMapDest
+static uint16_t* rtMapDest = nullptr;   // LED indices
+
+//LEDs realtime input can address, stream and LED indices of realtime data are 16 bit (see WLED_PIXEL_INDEX_32)
+uint16_t getRealtimeLedCount()
+{
+  pixidx_t len = strip.getLengthTotal();
+  return len > UINT16_MAX ? UINT16_MAX : len;
+}
+
+//stream pixels the regions cover, 0 without mapping
+uint16_t getRealtimeStreamLength()
+{
+  uint32_t len = 0;
+  for (uint8_t r = 0; r < realtimeRegionCount; r++) len = MAX(len, (uint32_t)realtimeRegions[r].start + realtimeRegions[r].len);
+  return MIN(len, UINT16_MAX);
+}
+
+//must be called when the regions, the LED count or the bounds of mapped segments change (done on entering realtime mode)
+void initRealtimeMap()
+{
+  RENDER_LOCK(); // the tables are used from the async UDP task
+  free(rtMapFirst); rtMapFirst = nullptr;
+  free(rtMapDest);  rtMapDest = nullptr;
+  rtMapLen = getRealtimeStreamLength();
+  if (!rtMapLen) {
+    RENDER_UNLOCK();
+    return;
   }
+
+  //resolve the destination ranges, clipped to the strip
+  uint16_t totalLen = getRealtimeLedCount();
+  uint16_t dst[WLED_MAX_REALTIME_REGIONS], dstLen[WLED_MAX_REALTIME_REGIONS];
+  uint32_t total = 0;
+  for (uint8_t r = 0; r < realtimeRegionCount; r++) {
+    const realtime_region &rg = realtimeRegions[r];
+    dst[r] = rg.dst; dstLen[r] = rg.dstLen ? rg.dstLen : rg.len;
+    if (rg.seg) {
+      if (rg.dst >= strip.getMaxSegments() || !strip.getSegment(rg.dst).isActive()) { dstLen[r] = 0; continue; }
+      WS2812FX::Segment &seg = strip.getSegment(rg.dst);
+      if (seg.start >= totalLen) { dstLen[r] = 0; continue; }
+      dst[r] = seg.start; dstLen[r] = seg.stop - seg.start;
+    }
+    if (!rg.len || dst[r] >= totalLen) dstLen[r] = 0;
+    else if (dst[r] + dstLen[r] > totalLen) dstLen[r] = totalLen - dst[r];
+    total += dstLen[r];
+  }
+
+  if (total <= UINT16_MAX) {
+    rtMapFirst = (uint16_t*) calloc(rtMapLen + 1, sizeof(uint16_t));
+    rtMapDest  = (uint16_t*) malloc(total * sizeof(uint16_t) + 1);
+  }
+  if (!rtMapFirst || !rtMapDest) {
+    free(rtMapFirst); rtMapFirst = nullptr;
+    free(rtMapDest);  rtMapDest = nullptr;
+    rtMapLen = 0;
+    RENDER_UNLOCK();
+    DEBUG_PRINTLN(F("Realtime map too large, not mapping."));
+    return;
+  }
+
+  //nearest stream pixel of each LED, counted per stream pixel then filled in (counting sort)
+  for (uint8_t pass = 0; pass < 2; pass++) {
+    for (uint8_t r = 0; r < realtimeRegionCount; r++) {
+      const realtime_region &rg = realtimeRegions[r];
+      for (uint16_t k = 0; k < dstLen[r]; k++) {
+        uint16_t src = rg.start + (uint32_t)(rg.rev ? dstLen[r] - 1 - k : k) * rg.len / dstLen[r];
+        if (pass) rtMapDest[rtMapFirst[src]++] = dst[r] + k;
+        else      rtMapFirst[src + 1]++;
+      }
+    }
+    if (pass) { // fill advanced each offset to the next pixel's, shift back
+      memmove(rtMapFirst + 1, rtMapFirst, rtMapLen * sizeof(uint16_t));
+      rtMapFirst[0] = 0;
+    } else {
+      for (uint16_t p = 0; p < rtMapLen; p++) rtMapFirst[p + 1] += rtMapFirst[p];
+    }
+  }
+  RENDER_UNLOCK();
+  DEBUG_PRINTF("Realtime map: %u stream pixels onto %u LEDs\n", rtMapLen, total);
+}
+
+#ifdef WLED_ENABLE_JITTER_BUFFER
+/*
+ * Realtime jitter buffer: complete frames of network protocols are queued as raw RGBW and shown
+ * at the smoothed arrival interval, once JITTER_BUFFER_TARGET frames are queued.
+ * Allocated on the first realtime pixel, freed when realtime mode ends.
+ */
+#ifndef JITTER_BUFFER_FRAMES
+  #define JITTER_BUFFER_FRAMES 3
+#endif
+#define JITTER_BUFFER_TARGET (JITTER_BUFFER_FRAMES - 1)
+
+static uint8_t* jbFrames = nullptr;     // JITTER_BUFFER_FRAMES queued frames + 1 being received
+static uint16_t jbLen = 0;              // LEDs per frame
+static uint8_t  jbHead = 0;             // oldest queued frame
+static bool     jbWritten = false;      // pixels were received since the last frame was queued
+static bool     jbPrimed = false;       // presenting, false while (re)filling to the target depth
+static uint16_t jbInterval = 0;         // smoothed frame interval in ms
+static unsigned long jbLastArrival = 0;
+static unsigned long jbNextShow = 0;
+
+static inline uint8_t* jbSlot(uint8_t n) {
+  return jbFrames + (uint32_t)((jbHead + n) % (JITTER_BUFFER_FRAMES + 1)) * jbLen * 4;
+}
+
+static void freeJitterBuffer() {
+  free(jbFrames);
+  jbFrames = nullptr;
+  jbQueueDepth = 0;
+  jbWritten = jbPrimed = false;
+  jbInterval = 0;
+  jbLastArrival = 0;
+}
+
+//frame being received, nullptr if the buffer is not used
+static uint8_t* jbFillFrame() {
+  if (realtimeMode == REALTIME_MODE_INACTIVE || realtimeMode == REALTIME_MODE_GENERIC || realtimeMode == REALTIME_MODE_ADALIGHT) return nullptr;
+  uint16_t totalLen = getRealtimeLedCount();
+  if (jbFrames && jbLen != totalLen) freeJitterBuffer();
+  if (!jbFrames) {
+    jbLen = totalLen;
+    jbHead = 0;
+    jbFrames = (uint8_t*) calloc(JITTER_BUFFER_FRAMES + 1, (size_t)jbLen * 4); // black, as realtimeLock() clears the strip
+    if (!jbFrames) return nullptr;
+  }
+  jbWritten = true;
+  return jbSlot(jbQueueDepth);
+}
+#endif
+
+#ifdef WLED_ENABLE_RT_INTERPOLATION
+/*
+ * Realtime motion interpolation: the previous and the latest complete frame of network protocols are kept as raw
+ * RGBW, and every local frame shows a blend that moves from the previous to the latest one over the smoothed arrival
+ * interval. Low rate sources get smooth motion at the local frame rate, at the cost of trailing them by one frame.
+ * Allocated on the first realtime pixel, freed when realtime mode ends.
+ */
+static uint8_t* ipFrames = nullptr;     // 3 frames: previous, latest and the one being received, rotated by ipPrev
+static uint16_t ipLen = 0;              // LEDs per frame
+static uint8_t  ipPrev = 0;             // slot of the previous frame, the latest follows, then the one being received
+static uint8_t  ipCount = 0;            // complete frames received, up to 2
+static bool     ipWritten = false;      // pixels were received since the last frame was completed
+static bool     ipSettled = false;      // the latest frame has been shown unblended, nothing to do until the next one
+static uint16_t ipInterval = 0;         // smoothed frame interval in ms
+static unsigned long ipArrival = 0;     // millis() the latest frame was completed
+static unsigned long ipLastShow = 0;
+
+static inline uint8_t* ipSlot(uint8_t n) {
+  return ipFrames + (uint32_t)((ipPrev + n) % 3) * ipLen * 4;
+}
+
+static void freeInterpolation() {
+  free(ipFrames);
+  ipFrames = nullptr;
+  ipCount = 0;
+  ipWritten = ipSettled = false;
+  ipInterval = 0;
+  ipArrival = 0;
+}
+
+//frame being received, nullptr if interpolation is not used
+static uint8_t* ipFillFrame() {
+  if (realtimeMode == REALTIME_MODE_INACTIVE || realtimeMode == REALTIME_MODE_GENERIC || realtimeMode == REALTIME_MODE_ADALIGHT) return nullptr;
+  uint16_t totalLen = getRealtimeLedCount();
+  if (ipFrames && ipLen != totalLen) freeInterpolation();
+  if (!ipFrames) {
+    ipLen = totalLen;
+    ipPrev = 0;
+    ipFrames = (uint8_t*) calloc(3, (size_t)ipLen * 4); // black, as realtimeLock() clears the strip
+    if (!ipFrames) return nullptr;
+  }
+  ipWritten = true;
+  return ipSlot(2);
+}
+
+//called from handleNotifications(), shows the blend of the previous and latest frame for the current time
+static void handleInterpolation()
+{
+  if (!ipFrames || !ipCount || ipSettled || busses.getBusyTime()) return;
+  if (realtimeOverride) return;
+  unsigned long now = millis();
+  if (now - ipLastShow < 1000U / strip.getTargetFps()) return;
+  ipLastShow = now;
+  uint32_t elapsed = now - ipArrival;
+  uint8_t progress = (ipCount < 2 || !ipInterval || elapsed >= ipInterval) ? 255 : elapsed * 255 / ipInterval;
+  ipSettled = (progress == 255);
+
+  bool gamma = !arlsDisableGammaCorrection && strip.gammaCorrectCol;
+  const uint8_t* prev = ipSlot(0);
+  const uint8_t* next = ipSlot(1);
+  uint32_t block[64];
+  for (uint16_t i = 0; i < ipLen; i += 64) {
+    uint16_t n = MIN(ipLen - i, 64);
+    if (progress == 255) memcpy(block, next + i * 4, n * 4);
+    else {
+      for (uint16_t k = 0; k < n; k++) {
+        uint32_t a, b; // the blend works per byte, so the RGBW byte order needs no unpacking
+        memcpy(&a, prev + (i + k) * 4, 4);
+        memcpy(&b, next + (i + k) * 4, 4);
+        block[k] = blendPacked(a, b, progress);
+      }
+    }
+    strip.setRealtimePixels(i, n, (const uint8_t*)block, 4, gamma);
+  }
+  strip.show();
+}
+#endif
+
+//called when all pixel data of a realtime frame has been received
+//returns true if it was queued by the jitter buffer or interpolator, otherwise the caller shows it
+bool queueRealtimeFrame()
+{
+  rtStats.push++;
+  if (e131NewData) rtStats.drop++; // the previous frame has not been shown yet
+  #ifdef WLED_ENABLE_RT_INTERPOLATION
+  if (!ipFrames || !ipWritten) return false;
+  ipWritten = false;
+  unsigned long now = millis();
+  unsigned long gap = now - ipArrival;
+  if (ipArrival && gap < 1000) ipInterval = ipInterval ? (ipInterval * 7 + gap + 4) / 8 : gap;
+  ipArrival = now;
+  if (ipCount < 2) ipCount++;
+  ipPrev = (ipPrev + 1) % 3; // the latest becomes the previous, the received one the latest
+  memcpy(ipSlot(2), ipSlot(1), (size_t)ipLen * 4); // packets may update only part of the next frame
+  ipSettled = false;
+  return true;
+  #endif
+  #ifdef WLED_ENABLE_JITTER_BUFFER
+  if (!jbFrames || !jbWritten) return false;
+  jbWritten = false;
+  unsigned long now = millis();
+  unsigned long gap = now - jbLastArrival;
+  if (jbLastArrival && gap < 1000) jbInterval = jbInterval ? (jbInterval * 7 + gap + 4) / 8 : gap;
+  jbLastArrival = now;
+  if (jbQueueDepth == JITTER_BUFFER_FRAMES) { // discard the oldest frame
+    jbHead = (jbHead + 1) % (JITTER_BUFFER_FRAMES + 1);
+    jbQueueDepth--;
+    jbDroppedFrames++;
+    rtStats.drop++;
+  }
+  jbQueueDepth++;
+  memcpy(jbSlot(jbQueueDepth), jbSlot(jbQueueDepth - 1), (size_t)jbLen * 4); // packets may update only part of the next frame
+  return true;
+  #else
+  return false;
+  #endif
+}
+
+//called from handleNotifications(), shows the oldest queued frame when it is due
+static void handleJitterBuffer()
+{
+  #ifdef WLED_ENABLE_JITTER_BUFFER
+  if (!jbFrames || busses.getBusyTime()) return;
+  if (realtimeOverride) {
+    jbQueueDepth = 0;
+    return;
+  }
+  unsigned long now = millis();
+  if (!jbPrimed) {
+    if (jbQueueDepth < JITTER_BUFFER_TARGET) return;
+    jbPrimed = true;
+    jbNextShow = now;
+  }
+  if ((long)(now - jbNextShow) < 0) return;
+  if (!jbQueueDepth) { // underrun, refill before presenting again
+    jbLateFrames++;
+    jbPrimed = false;
+    return;
+  }
+  strip.setRealtimePixels(0, jbLen, jbSlot(0), 4, !arlsDisableGammaCorrection && strip.gammaCorrectCol);
+  strip.show();
+  jbHead = (jbHead + 1) % (JITTER_BUFFER_FRAMES + 1);
+  jbQueueDepth--;
+  //steer towards the target depth so the latency stays constant
+  uint16_t interval = jbInterval;
+  if (jbQueueDepth >= JITTER_BUFFER_TARGET) interval -= interval / 8;
+  else if (!jbQueueDepth)                   interval += interval / 8;
+  jbNextShow += interval;
+  if ((long)(now - jbNextShow) > (long)jbInterval) jbNextShow = now + interval; // do not catch up after a stall
+  #endif
+}
+
+/*
+ * Version 12 sync: only segments whose state changed since the last notification are sent, with a state version
+ * counter after the last segment. Version 11 receivers already look segments up by id, so they apply the deltas too.
+ * A receiver that misses a version asks the sender for a full state, which is broadcast to all receivers.
+ */
+static uint32_t syncStateVersion = 0;             // incremented with each notification (not the follow-up)
+static uint32_t syncSegHash[MAX_NUM_SEGMENTS];    // segment state as of the last notification
+static bool     syncSegSent[MAX_NUM_SEGMENTS];    // segments of the last notification, sent again by the follow-up
+static bool     syncResyncPending = false;        // a receiver asked for the full state
+static byte     notifyPendingCallMode = CALL_MODE_INIT; // change waiting for the end of the coalescing window
+static unsigned long syncFullSentTime = 0;
+static unsigned long syncResyncRequestTime = 0;
+
+struct SyncPeer {
+  uint32_t ip;
+  uint32_t version;
+  bool     synced;  // all versions since the last full state received
+};
+static SyncPeer syncPeers[UDP_SYNC_PEERS] = {};
+static uint8_t  syncPeerNext = 0;                 // entry replaced by the next unknown sender
+
+static uint32_t hashSyncSegment(const uint8_t* p) {
+  uint32_t h = 2166136261UL; // FNV-1a
+  for (uint8_t i = 0; i < UDP_SEG_SIZE; i++) h = (h ^ p[i]) * 16777619UL;
+  return h;
+}
+
+static void sendSyncPacket(byte callMode, bool followUp, bool full)
+{
   byte udpOut[WLEDPACKETSIZE];
   WS2812FX::Segment& mainseg = strip.getMainSegment();
   udpOut[0] = 0; //0: wled notifier protocol 1: WARLS protocol
@@ -46,7 +437,8 @@ void notify(byte callMode, bool followUp)
   //3: supports FX intensity, 24 byte packet 4: supports transitionDelay 5: sup palette
   //6: supports timebase syncing, 29 byte packet 7: supports tertiary color 8: supports sys time sync, 36 byte packet
   //9: supports sync groups, 37 byte packet 10: supports CCT, 39 byte packet 11: per segment options, variable packet length (40+MAX_NUM_SEGMENTS*3)
-  udpOut[11] = 11;
+  //12: changed segments only, byte 39 is the number of segments sent, followed by state version and flags
+  udpOut[11] = 12;
   col = mainseg.colors[1];
   udpOut[12] = R(col);
   udpOut[13] = G(col);
@@ -89,11 +481,15 @@ void notify(byte callMode, bool followUp)
   udpOut[37] = strip.hasCCTBus() ? 0 : 255; //check this is 0 for the next value to be significant
   udpOut[38] = mainseg.cct;
 
-  udpOut[39] = strip.getMaxSegments();
+  if (!followUp) {
+    syncStateVersion++;
+    if (syncStateVersion % UDP_SYNC_FULL_EVERY == 1) full = true; //also the first one after boot
+  }
+  uint8_t numSegs = 0;
   udpOut[40] = UDP_SEG_SIZE; //size of each loop iteration (one segment)
   for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
     WS2812FX::Segment &selseg = strip.getSegment(i);
-    uint16_t ofs = 41 + i*UDP_SEG_SIZE; //start of segment offset byte
+    uint16_t ofs = 41 + numSegs*UDP_SEG_SIZE; //start of segment offset byte
     udpOut[0 +ofs] = i;
     udpOut[1 +ofs] = selseg.start >> 8;
     udpOut[2 +ofs] = selseg.start & 0xFF;
@@ -122,39 +518,290 @@ void notify(byte callMode, bool followUp)
     udpOut[25+ofs] = B(selseg.colors[2]);
     udpOut[26+ofs] = W(selseg.colors[2]);
     udpOut[27+ofs] = selseg.cct;
-  }
 
-  //uint16_t offs = SEG_OFFSET;
-  //next value to be added has index: udpOut[offs + 0]
+    uint32_t h = hashSyncSegment(udpOut + ofs);
+    if (!followUp) syncSegSent[i] = full || h != syncSegHash[i];
+    syncSegHash[i] = h;
+    if (full || syncSegSent[i]) numSegs++; //keep the entry, else it is overwritten by the next segment
+  }
+  udpOut[39] = numSegs;
+
+  uint16_t offs = 41 + numSegs*UDP_SEG_SIZE; //state version and flags after the last segment
+  udpOut[offs +0] = (syncStateVersion >> 24) & 0xFF;
+  udpOut[offs +1] = (syncStateVersion >> 16) & 0xFF;
+  udpOut[offs +2] = (syncStateVersion >>  8) & 0xFF;
+  udpOut[offs +3] = (syncStateVersion >>  0) & 0xFF;
+  udpOut[offs +4] = full ? UDP_SYNC_FLAG_FULL : 0;
+  udpOut[offs +5] = strip.effectSeed >> 8;
+  udpOut[offs +6] = strip.effectSeed & 0xFF;
+  if (full) syncFullSentTime = millis();
+  //next value to be added has index: udpOut[offs + UDP_SYNC_TRAILER_SIZE]
 
   IPAddress broadcastIp;
   broadcastIp = ~uint32_t(Network.subnetMask()) | uint32_t(Network.gatewayIP());
 
-  notifierUdp.beginPacket(broadcastIp, udpPort);
-  notifierUdp.write(udpOut, WLEDPACKETSIZE);
-  notifierUdp.endPacket();
+  #ifdef WLED_ENABLE_ESPNOW
+  espNowSendSync(udpOut, offs + UDP_SYNC_TRAILER_SIZE); // first, it does not wait for the access point
+  #endif
+  sendUdp(UDP_SOCKET_NOTIFIER, broadcastIp, udpPort, udpOut, offs + UDP_SYNC_TRAILER_SIZE);
+}
+
+void notify(byte callMode, bool followUp)
+{
+  if (!udpConnected) return;
+  if (!syncGroups) return;
+  switch (callMode)
+  {
+    case CALL_MODE_INIT:          return;
+    case CALL_MODE_DIRECT_CHANGE: if (!notifyDirect) return; break;
+    case CALL_MODE_BUTTON:        if (!notifyButton) return; break;
+    case CALL_MODE_BUTTON_PRESET: if (!notifyButton) return; break;
+    case CALL_MODE_NIGHTLIGHT:    if (!notifyDirect) return; break;
+    case CALL_MODE_HUE:           if (!notifyHue)    return; break;
+    case CALL_MODE_PRESET_CYCLE:  if (!notifyDirect) return; break;
+    case CALL_MODE_BLYNK:         if (!notifyDirect) return; break;
+    case CALL_MODE_ALEXA:         if (!notifyAlexa)  return; break;
+    default: return;
+  }
+  //changes within notifyCoalesceMs of the last packet are sent together by handleNotifications() once the window has passed,
+  //the packet is built then, so it carries the final state
+  if (!followUp && notifyCoalesceMs && millis() - notificationSentTime < notifyCoalesceMs) {
+    notifyPendingCallMode = callMode;
+    return;
+  }
+  notifyPendingCallMode = CALL_MODE_INIT;
+  sendSyncPacket(callMode, followUp, false);
   notificationSentCallMode = callMode;
   notificationSentTime = millis();
   notificationTwoRequired = (followUp)? false:notifyTwice;
 }
 
+//asks a version 12 sender for its full state after a missed notification
+static void requestSyncResync(IPAddress ip, uint16_t port)
+{
+  if (millis() - syncResyncRequestTime < UDP_SYNC_RESYNC_MS) return;
+  syncResyncRequestTime = millis();
+  uint8_t req[4] = {0, UDP_SYNC_RESYNC_REQUEST, 12, receiveGroups};
+  sendUdp(UDP_SOCKET_NOTIFIER, ip, port, req, sizeof(req));
+}
+
+//tracks the state version of the sender, returns false for a repeated notification (notifyTwice)
+static bool checkSyncVersion(IPAddress ip, uint16_t port, uint32_t version, bool full)
+{
+  SyncPeer* peer = nullptr;
+  for (uint8_t i = 0; i < UDP_SYNC_PEERS; i++) {
+    if (syncPeers[i].ip == uint32_t(ip)) { peer = &syncPeers[i]; break; }
+  }
+  if (!peer) {
+    peer = &syncPeers[syncPeerNext];
+    syncPeerNext = (syncPeerNext +1) % UDP_SYNC_PEERS;
+    peer->ip = ip;
+    peer->synced = false;
+  } else if (peer->synced && version == peer->version) return false;
+
+  bool inOrder = full || (peer->synced && version == peer->version +1);
+  if (!inOrder) requestSyncResync(ip, port); //notifications were lost or we have not seen this sender yet
+  peer->synced = inOrder;
+  peer->version = version;
+  return true;
+}
+
+/*
+ * Clock sync: the effect clock (strip.timebase) follows the sender of the last notification that synced effects.
+ * The offset is measured by request / reply pairs with round trip compensation (NTP style) and applied gradually,
+ * so all nodes render the same frame for the same strip.now. Coarse timebase sync from notifications is skipped while locked.
+ */
+struct ClockSample {
+  uint32_t offset; // source clock minus local micros()
+  uint32_t rtt;
+};
+static ClockSample clockSamples[UDP_CLOCK_SAMPLES];
+static uint8_t  clockSampleCount = 0;
+static uint8_t  clockSampleNext = 0;
+static IPAddress clockSource;                // 0.0.0.0 if none
+static uint16_t clockSourcePort = 0;
+static bool     clockSourceDead = false;     // no replies, firmware without clock sync
+static uint8_t  clockMisses = 0;
+static uint8_t  clockSeq = 0;
+static bool     clockPending = false;
+static uint32_t clockRequestTime = 0;        // micros() of the pending request
+static unsigned long clockPollTime = 0;
+static unsigned long clockLockTime = 0;      // millis() of the last accepted sample
+static int32_t  clockOffset = 0;             // last measured error of the effect clock, us
+static uint32_t clockJitter = 0;             // average change of the measured offset, us
+static uint32_t clockRtt = 0;
+static int32_t  clockCarry = 0;              // correction below 1 ms not yet applied to the timebase
+
+static inline uint32_t effectClockMicros() {
+  return micros() + strip.timebase * 1000UL; // wraps every 71 minutes, only differences are used
+}
+
+static bool clockSyncLocked(IPAddress ip) {
+  return syncClock && clockSampleCount && ip == clockSource && millis() - clockLockTime < 4*UDP_CLOCK_POLL_MS;
+}
+
+//the sender of an applied effect notification becomes the clock source
+static void setClockSource(IPAddress ip, uint16_t port) {
+  if (ip == clockSource) return;
+  clockSource = ip;
+  clockSourcePort = port;
+  clockSourceDead = false;
+  clockMisses = clockSampleCount = 0;
+  clockPending = false;
+  clockPollTime = 0;
+}
+
+static void handleClockSync() {
+  if (!syncClock || !clockSource || clockSourceDead) return;
+  if (millis() - clockPollTime < UDP_CLOCK_POLL_MS) return;
+  clockPollTime = millis();
+  if (clockPending && ++clockMisses >= UDP_CLOCK_MAX_MISSES) {
+    clockSourceDead = true;
+    DEBUG_PRINTLN(F("Clock source does not reply."));
+    return;
+  }
+  clockRequestTime = micros();
+  uint8_t req[7] = {0, UDP_CLOCK_REQUEST, ++clockSeq,
+    uint8_t(clockRequestTime >> 24), uint8_t(clockRequestTime >> 16), uint8_t(clockRequestTime >> 8), uint8_t(clockRequestTime)};
+  clockPending = true;
+  sendUdp(UDP_SOCKET_NOTIFIER, clockSource, clockSourcePort, req, sizeof(req));
+}
+
+static void answerClockRequest(uint8_t socket, IPAddress ip, uint16_t port, const uint8_t* in) {
+  uint32_t t = effectClockMicros();
+  uint8_t reply[11] = {0, UDP_CLOCK_REPLY, in[2], in[3], in[4], in[5], in[6],
+    uint8_t(t >> 24), uint8_t(t >> 16), uint8_t(t >> 8), uint8_t(t)};
+  sendUdp(socket, ip, port, reply, sizeof(reply));
+}
+
+static void handleClockReply(IPAddress ip, const uint8_t* in) {
+  uint32_t now = micros();
+  if (!clockPending || ip != clockSource || in[2] != clockSeq) return;
+  uint32_t sent = (in[3] << 24) | (in[4] << 16) | (in[5] << 8) | in[6];
+  if (sent != clockRequestTime) return;
+  clockPending = false;
+  clockMisses = 0;
+  uint32_t rtt = now - sent;
+  if (rtt > UDP_CLOCK_MAX_RTT_US) return;
+  uint32_t source = (in[7] << 24) | (in[8] << 16) | (in[9] << 8) | in[10];
+
+  ClockSample &smp = clockSamples[clockSampleNext];
+  smp.offset = source + rtt/2 - now;
+  smp.rtt = rtt;
+  clockSampleNext = (clockSampleNext +1) % UDP_CLOCK_SAMPLES;
+  if (clockSampleCount < UDP_CLOCK_SAMPLES) clockSampleCount++;
+  const ClockSample* best = &smp; // queueing delays only make the round trip longer, the fastest sample is the most accurate
+  for (uint8_t i = 0; i < clockSampleCount; i++) if (clockSamples[i].rtt < best->rtt) best = &clockSamples[i];
+
+  int32_t err = int32_t(best->offset - strip.timebase * 1000UL);
+  clockJitter = (clockJitter * 7 + (uint32_t)abs(err - clockOffset)) / 8;
+  clockOffset = err;
+  clockRtt = best->rtt;
+  clockLockTime = millis();
+  if (abs(err) > UDP_CLOCK_STEP_US) { // first sample or source changed time
+    strip.timebase += (err + (err < 0 ? -500 : 500)) / 1000;
+    clockCarry = 0;
+    return;
+  }
+  clockCarry += err / 4; // slew, frames do not skip
+  int32_t ms = clockCarry / 1000;
+  strip.timebase += ms;
+  clockCarry -= ms * 1000;
+}
+
+void serializeClockSync(JsonObject root)
+{
+  if (!syncClock || !clockSource) return;
+  JsonObject clk = root.createNestedObject(F("clock"));
+  clk[F("src")]  = clockSource.toString();
+  clk[F("lock")] = clockSyncLocked(clockSource);
+  clk[F("ofs")]  = clockOffset; // us
+  clk[F("jit")]  = clockJitter;
+  clk[F("rtt")]  = clockRtt;
+}
+
+// realtime sources seen recently: the one streaming (owner) keeps the LEDs until a source of higher priority
+// sends or it is silent for RT_SOURCE_LOSS_MS, packets of the others are dropped before their pixels are decoded
+#define RT_MAX_SOURCES 4
+#define RT_SOURCE_LOSS_MS 2500 // E1.31 network data loss timeout
+
+typedef struct RealtimeSource {
+  IPAddress ip;        // 0.0.0.0 for serial and wired DMX
+  uint32_t  lastSeen;
+  uint32_t  rx;        // packets accepted
+  uint32_t  drop;      // packets dropped for the owner
+  uint8_t   mode;      // REALTIME_MODE_*, 0 if unused
+  uint8_t   prio;
+} realtime_source;
+
+static RealtimeSource rtSources[RT_MAX_SOURCES];
+static int8_t rtOwner = -1;
+
+//true if a packet of mode md from ip may be shown, prio overrides the configured priority of the mode (E1.31)
+bool realtimeAccept(byte md, IPAddress ip, int16_t prio)
+{
+  uint32_t now = millis();
+  int8_t idx = -1, oldest = -1;
+  for (uint8_t i = 0; i < RT_MAX_SOURCES; i++) {
+    RealtimeSource &s = rtSources[i];
+    if (s.mode == md && s.ip == ip) { idx = i; break; }
+    if (i == rtOwner) continue;
+    if (oldest < 0 || !s.mode || (rtSources[oldest].mode && now - s.lastSeen > now - rtSources[oldest].lastSeen)) oldest = i;
+  }
+  if (idx < 0) { // replaces the source silent for the longest time
+    idx = oldest;
+    rtSources[idx] = {ip, now, 0, 0, md, 0};
+  }
+  RealtimeSource &s = rtSources[idx];
+  s.prio = (prio >= 0) ? prio : realtimePriority[md < REALTIME_MODE_COUNT ? md : 0];
+  s.lastSeen = now;
+
+  if (realtimeMode == REALTIME_MODE_INACTIVE || realtimeMode == REALTIME_MODE_GENERIC) rtOwner = -1;
+  if (rtOwner >= 0 && rtOwner != idx) {
+    RealtimeSource &o = rtSources[rtOwner];
+    if (now - o.lastSeen < RT_SOURCE_LOSS_MS && o.prio >= s.prio) {
+      s.drop++;
+      return false;
+    }
+    DEBUG_PRINTF("Realtime source %s (mode %u) takes over\n", ip.toString().c_str(), md);
+  }
+  rtOwner = idx;
+  s.rx++;
+  return true;
+}
+
+//the recent realtime sources for the info object
+void serializeRealtimeSources(JsonObject root)
+{
+  JsonArray srcs = root.createNestedArray(F("rtsrc"));
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < RT_MAX_SOURCES; i++) {
+    RealtimeSource &s = rtSources[i];
+    if (!s.mode) continue;
+    JsonObject src = srcs.createNestedObject();
+    src["ip"]      = s.ip.toString();
+    src["mode"]    = s.mode;
+    src[F("prio")] = s.prio;
+    src["rx"]      = s.rx;
+    src[F("drop")] = s.drop;
+    src[F("age")]  = (now - s.lastSeen) / 1000; // s since the last packet
+    src[F("own")]  = (i == rtOwner);
+  }
+  #ifdef WLED_ENABLE_UDP_RX_TASK
+  root[F("udpdrop")] = udpRxDropped; // packets the loop could not keep up with
+  #endif
+}
+
 void realtimeLock(uint32_t timeoutMs, byte md)
 {
+  if (!realtimeMode && (realtimeRegionCount || rtMapLen)) initRealtimeMap(); // segment bounds or regions may have changed
   if (!realtimeMode && !realtimeOverride) {
-    uint16_t stop, start;
-    if (useMainSegmentOnly) {
-      WS2812FX::Segment& mainseg = strip.getMainSegment();
-      start = mainseg.start;
-      stop  = mainseg.stop;
-      mainseg.setOption(SEG_OPTION_FREEZE, true, strip.getMainSegmentId());
-    } else {
-      start = 0;
-      stop  = strip.getLengthTotal();
-    }
-    // clear strip/segment
-    for (uint16_t i = start; i < stop; i++) strip.setPixelColor(i,0,0,0,0);
-    // if WLED was off and using main segment only, freeze non-main segments so they stay off
-    if (useMainSegmentOnly && bri == 0) {
+    bool layered = strip.hasLiveSegments();
+    // clear strip/live segments
+    if (layered) strip.freezeLiveSegments(true, true);
+    else for (uint16_t i = 0; i < strip.getLengthTotal(); i++) strip.setPixelColor(i,0,0,0,0);
+    // if WLED was off and using live segments, freeze the others so they stay off
+    if (layered && bri == 0) {
       for (uint8_t s=0; s < strip.getMaxSegments(); s++) {
         strip.getSegment(s).setOption(SEG_OPTION_FREEZE, true, s);
       }
@@ -168,6 +815,7 @@ void realtimeLock(uint32_t timeoutMs, byte md)
   if (realtimeTimeout != UINT32_MAX) {
     realtimeTimeout = (timeoutMs == 255001 || timeoutMs == 65000) ? UINT32_MAX : millis() + timeoutMs;
   }
+  if (md != realtimeMode) LOG_I("Realtime mode %u from %u.%u.%u.%u", md, realtimeIP[0], realtimeIP[1], realtimeIP[2], realtimeIP[3]);
   realtimeMode = md;
 
   if (realtimeOverride) return;
@@ -177,259 +825,281 @@ void realtimeLock(uint32_t timeoutMs, byte md)
 
 void exitRealtime() {
   if (!realtimeMode) return;
+  LOG_I("Realtime mode %u ended", realtimeMode);
   if (realtimeOverride == REALTIME_OVERRIDE_ONCE) realtimeOverride = REALTIME_OVERRIDE_NONE;
   strip.setBrightness(scaledBri(bri));
   realtimeTimeout = 0; // cancel realtime mode immediately
   realtimeMode = REALTIME_MODE_INACTIVE; // inform UI immediately
   realtimeIP[0] = 0;
-  if (useMainSegmentOnly) { // unfreeze live segment again
-    strip.getMainSegment().setOption(SEG_OPTION_FREEZE, false, strip.getMainSegmentId());
-  }
+  rtOwner = -1;
+  #ifdef WLED_ENABLE_JITTER_BUFFER
+  freeJitterBuffer();
+  #endif
+  #ifdef WLED_ENABLE_RT_INTERPOLATION
+  freeInterpolation();
+  #endif
+  strip.freezeLiveSegments(false); // unfreeze live segments again
 }
 
 
 #define TMP2NET_OUT_PORT 65442
 
-void sendTPM2Ack() {
-  notifierUdp.beginPacket(notifierUdp.remoteIP(), TMP2NET_OUT_PORT);
+static void sendTPM2Ack(IPAddress ip) {
   uint8_t response_ack = 0xac;
-  notifierUdp.write(&response_ack, 1);
-  notifierUdp.endPacket();
+  sendUdp(UDP_SOCKET_NOTIFIER, ip, TMP2NET_OUT_PORT, &response_ack, 1);
 }
 
 
-void handleNotifications()
+//counts a realtime packet and the time spent on it, from micros() when it was picked up
+void countRealtimePacket(uint32_t startUs)
 {
-  IPAddress localIP;
-
-  //send second notification if enabled
-  if(udpConnected && notificationTwoRequired && millis()-notificationSentTime > 250){
-    notify(notificationSentCallMode,true);
-  }
-  
-  if (e131NewData && millis() - strip.getLastShow() > 15)
-  {
-    e131NewData = false;
-    strip.show();
-  }
-
-  //unlock strip when realtime UDP times out
-  if (realtimeMode && millis() > realtimeTimeout) exitRealtime();
+  uint32_t us = MIN(micros() - startUs, UINT16_MAX);
+  rtStats.rx++;
+  rtStats.procAvg = (7 * rtStats.procAvg + us + 4) >> 3;
+  if (us > rtStats.procMax) rtStats.procMax = us;
+  TRACE_SPAN(TRACE_RT_PACKET, realtimeMode, startUs);
+}
 
-  //receive UDP notifications
-  if (!udpConnected) return;
-    
-  bool isSupp = false;
-  uint16_t packetSize = notifierUdp.parsePacket();
-  if (!packetSize && udp2Connected) {
-    packetSize = notifier2Udp.parsePacket();
-    isSupp = true;
-  }
+//applies a notification (version 0..12) from sender, which takes resync and clock requests at port
+static void applyNotification(const uint8_t* udpIn, uint16_t len, IPAddress sender, uint16_t port)
+{
+  //ignore notification if received within a second after sending a notification ourselves
+  if (millis() - notificationSentTime < 1000) return;
+  if (udpIn[1] > 199) return; //do not receive custom versions
 
-  //hyperion / raw RGB
-  if (!packetSize && udpRgbConnected) {
-    packetSize = rgbUdp.parsePacket();
-    if (packetSize) {
-      if (!receiveDirect) return;
-      if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return;
-      realtimeIP = rgbUdp.remoteIP();
-      DEBUG_PRINTLN(rgbUdp.remoteIP());
-      uint8_t lbuf[packetSize];
-      rgbUdp.read(lbuf, packetSize);
-      realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
-      if (realtimeOverride) return;
-      uint16_t id = 0;
-      uint16_t totalLen = strip.getLengthTotal();
-      for (uint16_t i = 0; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, lbuf[i], lbuf[i+1], lbuf[i+2], 0);
-        id++; if (id >= totalLen) break;
-      }
-      strip.show();
-      return;
-    } 
+  //compatibilityVersionByte: 
+  byte version = udpIn[11];
+
+  // if we are not part of any sync group ignore message
+  if (version < 9 || version > 199) {
+    // legacy senders are treated as if sending in sync group 1 only
+    if (!(receiveGroups & 0x01)) return;
+  } else if (!(receiveGroups & udpIn[36])) return;
+
+  if (version > 11 && version < 200) {
+    uint16_t offs = 41 + udpIn[39]*udpIn[40];
+    if (len < offs + 5) return; // effect seed is optional
+    uint32_t stateVersion = (udpIn[offs] << 24) | (udpIn[offs+1] << 16) | (udpIn[offs+2] << 8) | (udpIn[offs+3]);
+    if (!checkSyncVersion(sender, port, stateVersion, udpIn[offs+4] & UDP_SYNC_FLAG_FULL)) return;
   }
-
-  if (!(receiveNotifications || receiveDirect)) return;
   
-  localIP = Network.localIP();
-  //notifier and UDP realtime
-  if (!packetSize || packetSize > UDP_IN_MAXSIZE) return;
-  if (!isSupp && notifierUdp.remoteIP() == localIP) return; //don't process broadcasts we send ourselves
-
-  uint8_t udpIn[packetSize +1];
-  uint16_t len;
-  if (isSupp) len = notifier2Udp.read(udpIn, packetSize);
-  else        len =  notifierUdp.read(udpIn, packetSize);
-
-  // WLED nodes info notifications
-  if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
-    if (!nodeListEnabled || notifier2Udp.remoteIP() == localIP) return;
-
-    uint8_t unit = udpIn[39];
-    NodesMap::iterator it = Nodes.find(unit);
-    if (it == Nodes.end() && Nodes.size() < WLED_MAX_NODES) { // Create a new element when not present
-      Nodes[unit].age = 0;
-      it = Nodes.find(unit);
+  bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
+
+  //apply colors from notification to main segment, only if not syncing full segments
+  if ((receiveNotificationColor || !someSel) && (version < 11 || !receiveSegmentOptions)) {
+    // primary color, only apply white if intented (version > 0)
+    strip.setColor(0, RGBW32(udpIn[3], udpIn[4], udpIn[5], (version > 0) ? udpIn[10] : 0));
+    if (version > 1) {
+      strip.setColor(1, RGBW32(udpIn[12], udpIn[13], udpIn[14], udpIn[15])); // secondary color
     }
-
-    if (it != Nodes.end()) {
-      for (byte x = 0; x < 4; x++) {
-        it->second.ip[x] = udpIn[x + 2];
+    if (version > 6) {
+      strip.setColor(2, RGBW32(udpIn[20], udpIn[21], udpIn[22], udpIn[23])); // tertiary color
+      if (version > 9 && version < 200 && udpIn[37] < 255) { // valid CCT/Kelvin value
+        uint8_t cct = udpIn[38];
+        if (udpIn[37] > 0) { //Kelvin
+          cct = (((udpIn[37] << 8) + udpIn[38]) - 1900) >> 5; 
+        }
+        strip.setCCT(cct);
       }
-      it->second.age = 0; // reset 'age counter'
-      char tmpNodeName[33] = { 0 };
-      memcpy(&tmpNodeName[0], reinterpret_cast<byte *>(&udpIn[6]), 32);
-      tmpNodeName[32]     = 0;
-      it->second.nodeName = tmpNodeName;
-      it->second.nodeName.trim();
-      it->second.nodeType = udpIn[38];
-      uint32_t build = 0;
-      if (len >= 44)
-        for (byte i=0; i<sizeof(uint32_t); i++)
-          build |= udpIn[40+i]<<(8*i);
-      it->second.build = build;
     }
-    return;
   }
 
-  //wled notifier, ignore if realtime packets active
-  if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
+  bool timebaseUpdated = false;
+  //apply effects from notification
+  bool applyEffects = (receiveNotificationEffects || !someSel);
+  if (version < 200)
   {
-    //ignore notification if received within a second after sending a notification ourselves
-    if (millis() - notificationSentTime < 1000) return;
-    if (udpIn[1] > 199) return; //do not receive custom versions
-
-    //compatibilityVersionByte: 
-    byte version = udpIn[11];
-
-    // if we are not part of any sync group ignore message
-    if (version < 9 || version > 199) {
-      // legacy senders are treated as if sending in sync group 1 only
-      if (!(receiveGroups & 0x01)) return;
-    } else if (!(receiveGroups & udpIn[36])) return;
-    
-    bool someSel = (receiveNotificationBrightness || receiveNotificationColor || receiveNotificationEffects);
-
-    //apply colors from notification to main segment, only if not syncing full segments
-    if ((receiveNotificationColor || !someSel) && (version < 11 || !receiveSegmentOptions)) {
-      // primary color, only apply white if intented (version > 0)
-      strip.setColor(0, RGBW32(udpIn[3], udpIn[4], udpIn[5], (version > 0) ? udpIn[10] : 0));
-      if (version > 1) {
-        strip.setColor(1, RGBW32(udpIn[12], udpIn[13], udpIn[14], udpIn[15])); // secondary color
-      }
-      if (version > 6) {
-        strip.setColor(2, RGBW32(udpIn[20], udpIn[21], udpIn[22], udpIn[23])); // tertiary color
-        if (version > 9 && version < 200 && udpIn[37] < 255) { // valid CCT/Kelvin value
-          uint8_t cct = udpIn[38];
-          if (udpIn[37] > 0) { //Kelvin
-            cct = (((udpIn[37] << 8) + udpIn[38]) - 1900) >> 5; 
-          }
-          strip.setCCT(cct);
+    if (applyEffects && currentPlaylist >= 0) unloadPlaylist();
+    if (version > 10 && (receiveSegmentOptions || receiveSegmentBounds)) {
+      uint8_t numSrcSegs = udpIn[39];
+      for (uint8_t i = 0; i < numSrcSegs; i++) {
+        uint16_t ofs = 41 + i*udpIn[40]; //start of segment offset byte
+        uint8_t id = udpIn[0 +ofs];
+        if (id >= strip.getMaxSegments()) continue;
+        WS2812FX::Segment& selseg = strip.getSegment(id);
+        uint16_t start  = (udpIn[1+ofs] << 8 | udpIn[2+ofs]);
+        uint16_t stop   = (udpIn[3+ofs] << 8 | udpIn[4+ofs]);
+        uint16_t offset = (udpIn[7+ofs] << 8 | udpIn[8+ofs]);
+        if (!receiveSegmentOptions) {
+          strip.setSegment(id, start, stop, selseg.grouping, selseg.spacing, offset);
+          continue;
         }
-      }
-    }
-
-    bool timebaseUpdated = false;
-    //apply effects from notification
-    bool applyEffects = (receiveNotificationEffects || !someSel);
-    if (version < 200)
-    {
-      if (applyEffects && currentPlaylist >= 0) unloadPlaylist();
-      if (version > 10 && (receiveSegmentOptions || receiveSegmentBounds)) {
-        uint8_t numSrcSegs = udpIn[39];
-        for (uint8_t i = 0; i < numSrcSegs; i++) {
-          uint16_t ofs = 41 + i*udpIn[40]; //start of segment offset byte
-          uint8_t id = udpIn[0 +ofs];
-          if (id > strip.getMaxSegments()) continue;
-          WS2812FX::Segment& selseg = strip.getSegment(id);
-          uint16_t start  = (udpIn[1+ofs] << 8 | udpIn[2+ofs]);
-          uint16_t stop   = (udpIn[3+ofs] << 8 | udpIn[4+ofs]);
-          uint16_t offset = (udpIn[7+ofs] << 8 | udpIn[8+ofs]);
-          if (!receiveSegmentOptions) {
-            strip.setSegment(id, start, stop, selseg.grouping, selseg.spacing, offset);
-            continue;
-          }
-          for (uint8_t j = 0; j<4; j++) selseg.setOption(j, (udpIn[9 +ofs] >> j) & 0x01); //only take into account mirrored, selected, on, reversed
-          selseg.setOpacity(udpIn[10+ofs], id);
-          if (applyEffects) {
-            strip.setMode(id,  udpIn[11+ofs]);
-            selseg.speed     = udpIn[12+ofs];
-            selseg.intensity = udpIn[13+ofs];
-            selseg.palette   = udpIn[14+ofs];
-          }
-          if (receiveNotificationColor || !someSel) {
-            selseg.setColor(0, RGBW32(udpIn[15+ofs],udpIn[16+ofs],udpIn[17+ofs],udpIn[18+ofs]), id);
-            selseg.setColor(1, RGBW32(udpIn[19+ofs],udpIn[20+ofs],udpIn[21+ofs],udpIn[22+ofs]), id);
-            selseg.setColor(2, RGBW32(udpIn[23+ofs],udpIn[24+ofs],udpIn[25+ofs],udpIn[26+ofs]), id);
-            selseg.setCCT(udpIn[27+ofs], id);
-          }
-          //setSegment() also properly resets segments
-          if (receiveSegmentBounds) {
-            strip.setSegment(id, start, stop, udpIn[5+ofs], udpIn[6+ofs], offset);
-          } else {
-            strip.setSegment(id, selseg.start, selseg.stop, udpIn[5+ofs], udpIn[6+ofs], selseg.offset);
-          }
+        for (uint8_t j = 0; j<4; j++) selseg.setOption(j, (udpIn[9 +ofs] >> j) & 0x01); //only take into account mirrored, selected, on, reversed
+        selseg.setOpacity(udpIn[10+ofs], id);
+        if (applyEffects) {
+          strip.setMode(id,  udpIn[11+ofs]);
+          selseg.speed     = udpIn[12+ofs];
+          selseg.intensity = udpIn[13+ofs];
+          selseg.palette   = udpIn[14+ofs];
         }
-        stateChanged = true;
-      }
-      
-      // simple effect sync, applies to all selected segments
-      if (applyEffects && (version < 11 || !receiveSegmentOptions)) {
-        for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
-          WS2812FX::Segment& seg = strip.getSegment(i);
-          if (!seg.isActive() || !seg.isSelected()) continue;
-          if (udpIn[8] < strip.getModeCount()) strip.setMode(i, udpIn[8]);
-          seg.speed = udpIn[9];
-          if (version > 2) seg.intensity = udpIn[16];
-          if (version > 4 && udpIn[19] < strip.getPaletteCount()) seg.palette = udpIn[19];
+        if (receiveNotificationColor || !someSel) {
+          selseg.setColor(0, RGBW32(udpIn[15+ofs],udpIn[16+ofs],udpIn[17+ofs],udpIn[18+ofs]), id);
+          selseg.setColor(1, RGBW32(udpIn[19+ofs],udpIn[20+ofs],udpIn[21+ofs],udpIn[22+ofs]), id);
+          selseg.setColor(2, RGBW32(udpIn[23+ofs],udpIn[24+ofs],udpIn[25+ofs],udpIn[26+ofs]), id);
+          selseg.setCCT(udpIn[27+ofs], id);
+        }
+        //setSegment() also properly resets segments
+        if (receiveSegmentBounds) {
+          strip.setSegment(id, start, stop, udpIn[5+ofs], udpIn[6+ofs], offset);
+        } else {
+          strip.setSegment(id, selseg.start, selseg.stop, udpIn[5+ofs], udpIn[6+ofs], selseg.offset);
         }
-        stateChanged = true;
       }
+      stateChanged = true;
+    }
+    
+    // simple effect sync, applies to all selected segments
+    if (applyEffects && (version < 11 || !receiveSegmentOptions)) {
+      for (uint8_t i = 0; i < strip.getMaxSegments(); i++) {
+        WS2812FX::Segment& seg = strip.getSegment(i);
+        if (!seg.isActive() || !seg.isSelected()) continue;
+        if (udpIn[8] < strip.getModeCount()) strip.setMode(i, udpIn[8]);
+        seg.speed = udpIn[9];
+        if (version > 2) seg.intensity = udpIn[16];
+        if (version > 4 && udpIn[19] < strip.getPaletteCount()) seg.palette = udpIn[19];
+      }
+      stateChanged = true;
+    }
 
-      if (applyEffects && version > 5) {
+    if (applyEffects && version > 5) {
+      if (!clockSyncLocked(sender)) { //the measured clock is more accurate
         uint32_t t = (udpIn[25] << 24) | (udpIn[26] << 16) | (udpIn[27] << 8) | (udpIn[28]);
         t += PRESUMED_NETWORK_DELAY; //adjust trivially for network delay
         t -= millis();
         strip.timebase = t;
         timebaseUpdated = true;
       }
+      setClockSource(sender, port);
+      uint16_t offs = 41 + udpIn[39]*udpIn[40];
+      if (version > 11 && len >= offs + UDP_SYNC_TRAILER_SIZE) strip.effectSeed = (udpIn[offs+5] << 8) | udpIn[offs+6]; // same random numbers as the sender
     }
+  }
 
-    //adjust system time, but only if sender is more accurate than self
-    if (version > 7 && version < 200)
-    {
-      Toki::Time tm;
-      tm.sec = (udpIn[30] << 24) | (udpIn[31] << 16) | (udpIn[32] << 8) | (udpIn[33]);
-      tm.ms = (udpIn[34] << 8) | (udpIn[35]);
-      if (udpIn[29] > toki.getTimeSource()) { //if sender's time source is more accurate
-        toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
-        uint8_t ts = TOKI_TS_UDP;
-        if (udpIn[29] > 99) ts = TOKI_TS_UDP_NTP;
-        else if (udpIn[29] >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
-        toki.setTime(tm, ts);
-      } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
-        Toki::Time myTime = toki.getTime();
-        uint32_t diff = toki.msDifference(tm, myTime);
-        strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
-        if (toki.isLater(tm, myTime)) {
-          strip.timebase += diff;
-        } else {
-          strip.timebase -= diff;
-        }
+  //adjust system time, but only if sender is more accurate than self
+  if (version > 7 && version < 200)
+  {
+    Toki::Time tm;
+    tm.sec = (udpIn[30] << 24) | (udpIn[31] << 16) | (udpIn[32] << 8) | (udpIn[33]);
+    tm.ms = (udpIn[34] << 8) | (udpIn[35]);
+    if (udpIn[29] > toki.getTimeSource()) { //if sender's time source is more accurate
+      toki.adjust(tm, PRESUMED_NETWORK_DELAY); //adjust trivially for network delay
+      uint8_t ts = TOKI_TS_UDP;
+      if (udpIn[29] > 99) ts = TOKI_TS_UDP_NTP;
+      else if (udpIn[29] >= TOKI_TS_SEC) ts = TOKI_TS_UDP_SEC;
+      toki.setTime(tm, ts);
+    } else if (timebaseUpdated && toki.getTimeSource() > 99) { //if we both have good times, get a more accurate timebase
+      Toki::Time myTime = toki.getTime();
+      uint32_t diff = toki.msDifference(tm, myTime);
+      strip.timebase -= PRESUMED_NETWORK_DELAY; //no need to presume, use difference between NTP times at send and receive points
+      if (toki.isLater(tm, myTime)) {
+        strip.timebase += diff;
+      } else {
+        strip.timebase -= diff;
       }
     }
-    
-    if (version > 3)
-    {
-      transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
+  }
+  
+  if (version > 3)
+  {
+    transitionDelayTemp = ((udpIn[17] << 0) & 0xFF) + ((udpIn[18] << 8) & 0xFF00);
+  }
+
+  nightlightActive = udpIn[6];
+  if (nightlightActive) nightlightDelayMins = udpIn[7];
+  
+  if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
+  stateUpdated(CALL_MODE_NOTIFICATION);
+}
+
+//hyperion / raw RGB, true if the packet is to be shown
+static bool acceptHyperionPacket(uint16_t packetSize, IPAddress remoteIP)
+{
+  if (!receiveDirect) return false;
+  if (packetSize > UDP_IN_MAXSIZE || packetSize < 3) return false;
+  if (!realtimeAccept(REALTIME_MODE_HYPERION, remoteIP)) return false;
+  realtimeIP = remoteIP;
+  DEBUG_PRINTLN(remoteIP);
+  realtimeLock(realtimeTimeoutMs, REALTIME_MODE_HYPERION);
+  return !realtimeOverride;
+}
+
+//notifier and UDP realtime, udpIn has room for a terminating 0 after packetSize bytes
+static void handleUdpPacket(uint8_t* udpIn, uint16_t packetSize, IPAddress remoteIP, uint16_t remotePort, bool isSupp, uint32_t rxStart)
+{
+  IPAddress localIP = Network.localIP();
+  if (!isSupp && remoteIP == localIP) return; //don't process broadcasts we send ourselves
+  uint16_t len = packetSize;
+
+  //clock sync, answered regardless of the notifier settings so any node can use this one as clock source
+  if (udpIn[0] == 0 && udpIn[1] == UDP_CLOCK_REQUEST && len >= 7) {
+    answerClockRequest(isSupp ? UDP_SOCKET_NOTIFIER2 : UDP_SOCKET_NOTIFIER, remoteIP, remotePort, udpIn);
+    return;
+  }
+  if (udpIn[0] == 0 && udpIn[1] == UDP_CLOCK_REPLY && len >= 11) {
+    handleClockReply(remoteIP, udpIn);
+    return;
+  }
+
+  //resync request of a version 12 receiver
+  if (udpIn[0] == 0 && udpIn[1] == UDP_SYNC_RESYNC_REQUEST && len >= 4) {
+    if (syncGroups & udpIn[3]) syncResyncPending = true;
+    return;
+  }
+
+  if (!(receiveNotifications || receiveDirect)) return;
+
+  // WLED nodes info notifications
+  if (isSupp && udpIn[0] == 255 && udpIn[1] == 1 && len >= 40) {
+    if (!(nodeListEnabled || streamRole == STREAM_ROLE_MASTER) || remoteIP == localIP) return;
+
+    //keyed by the sender address, the IP in the packet is 4.3.2.1 for all nodes in AP mode
+    NodeStruct* node = Nodes.add(remoteIP); // nullptr if the table is full
+    if (node) {
+      node->unit = udpIn[39];
+      node->age = 0; // reset 'age counter'
+      uint8_t n = 0, first = 0;
+      while (first < NODE_NAME_LEN && udpIn[6 + first] == ' ') first++;
+      for (uint8_t i = first; i < NODE_NAME_LEN && udpIn[6 + i]; i++) node->nodeName[n++] = udpIn[6 + i];
+      while (n && isspace(node->nodeName[n-1])) n--;
+      node->nodeName[n] = 0;
+      node->nodeType = udpIn[38];
+      uint32_t build = 0;
+      if (len >= 44)
+        for (byte i=0; i<sizeof(uint32_t); i++)
+          build |= udpIn[40+i]<<(8*i);
+      node->build = build;
+      uint8_t flags = 0, order = 0, groups = 0;
+      uint16_t leds = 0;
+      if (len >= 49) {
+        flags  = udpIn[44];
+        order  = udpIn[45];
+        leds   = udpIn[46] | (udpIn[47] << 8);
+        groups = udpIn[48];
+      }
+      if (streamRole == STREAM_ROLE_MASTER && (flags != node->streamFlags || order != node->streamOrder || leds != node->leds || groups != node->groups))
+        invalidateStreamFollowers(); // joined or changed
+      node->streamFlags = flags;
+      node->streamOrder = order;
+      node->leds        = leds;
+      node->groups      = groups;
+      #ifdef WLED_ENABLE_FLEET_OTA
+      if (len >= 60) {
+        node->fleetVariant  = udpIn[49] | (udpIn[50] << 8) | (udpIn[51] << 16) | ((uint32_t)udpIn[52] << 24);
+        node->fleetImage    = udpIn[53] | (udpIn[54] << 8) | (udpIn[55] << 16) | ((uint32_t)udpIn[56] << 24);
+        node->fleetFlags    = udpIn[57];
+        node->fleetProgress = udpIn[58];
+        node->fleetMinutes  = udpIn[59];
+        fleetPeer(node);
+      }
+      #endif
     }
+    return;
+  }
 
-    nightlightActive = udpIn[6];
-    if (nightlightActive) nightlightDelayMins = udpIn[7];
-    
-    if (receiveNotificationBrightness || !someSel) bri = udpIn[2];
-    stateUpdated(CALL_MODE_NOTIFICATION);
+  //wled notifier, ignore if realtime packets active
+  if (udpIn[0] == 0 && !realtimeMode && receiveNotifications)
+  {
+    applyNotification(udpIn, len, remoteIP, isSupp ? udpPort2 : udpPort);
     return;
   }
 
@@ -442,11 +1112,12 @@ void handleNotifications()
     //if the number of LEDs in your installation doesn't allow that, please include padding bytes at the end of the last packet
     byte tpmType = udpIn[1];
     if (tpmType == 0xaa) { //TPM2.NET polling, expect answer
-      sendTPM2Ack(); return;
+      sendTPM2Ack(remoteIP); return;
     }
     if (tpmType != 0xda) return; //return if notTPM2.NET data
 
-    realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
+    if (!realtimeAccept(REALTIME_MODE_TPM2NET, remoteIP)) return;
+    realtimeIP = remoteIP;
     realtimeLock(realtimeTimeoutMs, REALTIME_MODE_TPM2NET);
     if (realtimeOverride) return;
 
@@ -456,30 +1127,23 @@ void handleNotifications()
     byte numPackets = udpIn[5];
 
     uint16_t id = (tpmPayloadFrameSize/3)*(packetNum-1); //start LED
-    uint16_t totalLen = strip.getLengthTotal();
-    for (uint16_t i = 6; i < tpmPayloadFrameSize + 4; i += 3)
-    {
-      if (id < totalLen)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-      else break;
-    }
+    setRealtimePixels(id, tpmPayloadFrameSize/3, udpIn + 6, 3);
     if (tpmPacketCount == numPackets) //reset packet count and show if all packets were received
     {
       tpmPacketCount = 0;
-      strip.show();
+      if (!queueRealtimeFrame()) strip.show();
     }
+    countRealtimePacket(rxStart);
     return;
   }
 
   //UDP realtime: 1 warls 2 drgb 3 drgbw
   if (udpIn[0] > 0 && udpIn[0] < 5)
   {
-    realtimeIP = (isSupp) ? notifier2Udp.remoteIP() : notifierUdp.remoteIP();
-    DEBUG_PRINTLN(realtimeIP);
     if (packetSize < 2) return;
+    if (!realtimeAccept(REALTIME_MODE_UDP, remoteIP)) return;
+    realtimeIP = remoteIP;
+    DEBUG_PRINTLN(realtimeIP);
 
     if (udpIn[1] == 0)
     {
@@ -490,7 +1154,6 @@ void handleNotifications()
     }
     if (realtimeOverride) return;
 
-    uint16_t totalLen = strip.getLengthTotal();
     if (udpIn[0] == 1) //warls
     {
       for (uint16_t i = 2; i < packetSize -3; i += 4)
@@ -499,42 +1162,21 @@ void handleNotifications()
       }
     } else if (udpIn[0] == 2) //drgb
     {
-      uint16_t id = 0;
-      for (uint16_t i = 2; i < packetSize -2; i += 3)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-
-        id++; if (id >= totalLen) break;
-      }
+      setRealtimePixels(0, (packetSize -2) / 3, udpIn + 2, 3);
     } else if (udpIn[0] == 3) //drgbw
     {
-      uint16_t id = 0;
-      for (uint16_t i = 2; i < packetSize -3; i += 4)
-      {
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        
-        id++; if (id >= totalLen) break;
-      }
-    } else if (udpIn[0] == 4) //dnrgb
+      setRealtimePixels(0, (packetSize -2) / 4, udpIn + 2, 4);
+    } else if (udpIn[0] == 4 && packetSize > 4) //dnrgb
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (uint16_t i = 4; i < packetSize -2; i += 3)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], 0);
-        id++;
-      }
-    } else if (udpIn[0] == 5) //dnrgbw
+      setRealtimePixels(id, (packetSize -4) / 3, udpIn + 4, 3);
+    } else if (udpIn[0] == 5 && packetSize > 4) //dnrgbw
     {
       uint16_t id = ((udpIn[3] << 0) & 0xFF) + ((udpIn[2] << 8) & 0xFF00);
-      for (uint16_t i = 4; i < packetSize -2; i += 4)
-      {
-        if (id >= totalLen) break;
-        setRealtimePixel(id, udpIn[i], udpIn[i+1], udpIn[i+2], udpIn[i+3]);
-        id++;
-      }
+      setRealtimePixels(id, (packetSize -4) / 4, udpIn + 4, 4);
     }
-    strip.show();
+    if (!queueRealtimeFrame()) strip.show();
+    countRealtimePacket(rxStart);
     return;
   }
 
@@ -553,19 +1195,188 @@ void handleNotifications()
   }
 }
 
+void handleNotifications()
+{
+  //send coalesced changes, a pending change schedules its own follow-up
+  if (notifyPendingCallMode != CALL_MODE_INIT) {
+    if (millis() - notificationSentTime >= notifyCoalesceMs) {
+      byte callMode = notifyPendingCallMode;
+      notifyPendingCallMode = CALL_MODE_INIT;
+      notify(callMode);
+    }
+  } else
+  //send second notification if enabled
+  if(udpConnected && notificationTwoRequired && millis()-notificationSentTime > 250){
+    notify(notificationSentCallMode,true);
+  }
+
+  handleClockSync();
+
+  //answer resync requests with the full state, one broadcast serves all receivers that asked
+  if (udpConnected && syncResyncPending && millis() - syncFullSentTime > UDP_SYNC_RESYNC_MS) {
+    syncResyncPending = false;
+    if (syncGroups) sendSyncPacket(CALL_MODE_NOTIFICATION, false, true);
+  }
+  
+  handleE131();
+  handleJitterBuffer();
+  #ifdef WLED_ENABLE_RT_INTERPOLATION
+  handleInterpolation();
+  #endif
+  if (e131NewData && !busses.getBusyTime())
+  {
+    e131NewData = false;
+    strip.show();
+  }
+
+  //unlock strip when realtime UDP times out
+  if (realtimeMode && millis() > realtimeTimeout) exitRealtime();
+
+  #ifdef WLED_ENABLE_ESPNOW
+  //notifications received over ESP-NOW, the UDP copy arriving later is dropped by its state version
+  if (!udpInBuffer) udpInBuffer = (uint8_t*) malloc(UDP_IN_MAXSIZE +1);
+  IPAddress espNowSender;
+  uint16_t espNowLen, espNowPort;
+  if (udpInBuffer && espNowReceive(udpInBuffer, espNowLen, espNowSender, espNowPort)) {
+    if (udpInBuffer[0] == 0 && espNowLen > 40 && !realtimeMode && receiveNotifications)
+      applyNotification(udpInBuffer, espNowLen, espNowSender, espNowPort);
+    return;
+  }
+  #endif
+
+  //receive UDP notifications
+  if (!udpConnected) return;
+
+  #ifdef WLED_ENABLE_UDP_RX_TASK
+  //all packets received since the last loop
+  uint8_t slot;
+  while (xQueueReceive(udpRxQueue, &slot, 0) == pdTRUE) {
+    uint32_t rxStart = micros(); // realtime packet processing time
+    UdpRxPacket& p = udpRxSlots[slot];
+    if (p.socket == UDP_SOCKET_RGB) {
+      if (acceptHyperionPacket(p.len, p.ip)) {
+        setRealtimePixels(0, p.len / 3, p.data, 3);
+        if (!queueRealtimeFrame()) strip.show();
+        countRealtimePacket(rxStart);
+      }
+    } else handleUdpPacket(p.data, p.len, p.ip, p.port, p.socket == UDP_SOCKET_NOTIFIER2, rxStart);
+    xQueueSend(udpRxFree, &slot, 0);
+  }
+  #else
+  uint32_t rxStart = micros(); // realtime packet processing time
+  bool isSupp = false;
+  uint16_t packetSize = notifierUdp.parsePacket();
+  if (!packetSize && udp2Connected) {
+    packetSize = notifier2Udp.parsePacket();
+    isSupp = true;
+  }
+
+  //hyperion / raw RGB
+  if (!packetSize && udpRgbConnected) {
+    packetSize = rgbUdp.parsePacket();
+    if (packetSize) {
+      if (!acceptHyperionPacket(packetSize, rgbUdp.remoteIP())) return;
+      //decode in blocks straight from the socket, no copy of the whole packet
+      uint8_t block[64*3];
+      uint16_t id = 0;
+      for (uint16_t left = packetSize - packetSize % 3; left > 0;) {
+        uint16_t n = MIN(left, sizeof(block));
+        rgbUdp.read(block, n);
+        setRealtimePixels(id, n / 3, block, 3);
+        id += n / 3; left -= n;
+      }
+      if (!queueRealtimeFrame()) strip.show();
+      countRealtimePacket(rxStart);
+      return;
+    } 
+  }
+
+  //notifier and UDP realtime
+  if (!packetSize || packetSize > UDP_IN_MAXSIZE) return;
+
+  if (!udpInBuffer) udpInBuffer = (uint8_t*) malloc(UDP_IN_MAXSIZE +1);
+  if (!udpInBuffer) return;
+  WiFiUDP& udp = isSupp ? notifier2Udp : notifierUdp;
+  uint16_t len = udp.read(udpInBuffer, packetSize);
+  handleUdpPacket(udpInBuffer, len, udp.remoteIP(), udp.remotePort(), isSupp, rxStart);
+  #endif
+}
+
+
+#if defined(WLED_ENABLE_JITTER_BUFFER) || defined(WLED_ENABLE_RT_INTERPOLATION)
+//raw RGBW frame incoming realtime pixels are captured in, nullptr to write them to the strip
+static inline uint8_t* realtimeFillFrame()
+{
+  #ifdef WLED_ENABLE_JITTER_BUFFER
+  return jbFillFrame();
+  #else
+  return ipFillFrame();
+  #endif
+}
+#endif
+
+//writes one realtime pixel to the given LED
+static void writeRealtimePixel(uint16_t pix, const uint8_t* data, uint8_t stride)
+{
+  #if defined(WLED_ENABLE_JITTER_BUFFER) || defined(WLED_ENABLE_RT_INTERPOLATION)
+  uint8_t* frame = realtimeFillFrame();
+  if (frame) {
+    frame += pix * 4;
+    frame[0] = data[0]; frame[1] = data[1]; frame[2] = data[2]; frame[3] = stride > 3 ? data[3] : 0;
+    return;
+  }
+  #endif
+  strip.setRealtimePixels(pix, 1, data, stride, !arlsDisableGammaCorrection && strip.gammaCorrectCol);
+}
+
+//writes stream pixels through the realtime map
+static void setMappedPixels(uint16_t start, uint16_t count, const uint8_t* data, uint8_t stride)
+{
+  if (start >= rtMapLen) return;
+  if ((uint32_t)start + count > rtMapLen) count = rtMapLen - start;
+  for (uint16_t p = start; p < start + count; p++, data += stride) {
+    for (uint16_t k = rtMapFirst[p]; k < rtMapFirst[p + 1]; k++) writeRealtimePixel(rtMapDest[k], data, stride);
+  }
+}
 
 void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
 {
-  uint16_t pix = i + arlsOffset;
-  if (pix < strip.getLengthTotal())
+  if (rtMapLen) {
+    const uint8_t data[4] = {r, g, b, w};
+    setMappedPixels(i, 1, data, 4);
+    return;
+  }
+  uint32_t pix = (uint32_t)i + arlsOffset;
+  if (pix < getRealtimeLedCount())
   {
-    if (!arlsDisableGammaCorrection && strip.gammaCorrectCol)
-    {
-      strip.setPixelColor(pix, strip.gamma8(r), strip.gamma8(g), strip.gamma8(b), strip.gamma8(w));
-    } else {
-      strip.setPixelColor(pix, r, g, b, w);
+    const uint8_t data[4] = {r, g, b, w};
+    writeRealtimePixel(pix, data, 4);
+  }
+}
+
+//sets count consecutive realtime pixels from packed R,G,B(,W) data (stride bytes per pixel, W is read if stride > 3),
+//clipped to the strip once instead of per pixel
+void setRealtimePixels(uint16_t start, uint16_t count, const uint8_t* data, uint8_t stride)
+{
+  if (rtMapLen) {
+    setMappedPixels(start, count, data, stride);
+    return;
+  }
+  uint32_t pix = (uint32_t)start + arlsOffset;
+  uint16_t totalLen = getRealtimeLedCount();
+  if (pix >= totalLen || !count) return;
+  if (pix + count > totalLen) count = totalLen - pix;
+  #if defined(WLED_ENABLE_JITTER_BUFFER) || defined(WLED_ENABLE_RT_INTERPOLATION)
+  uint8_t* frame = realtimeFillFrame();
+  if (frame) {
+    frame += pix * 4;
+    for (uint16_t i = 0; i < count; i++, data += stride, frame += 4) {
+      frame[0] = data[0]; frame[1] = data[1]; frame[2] = data[2]; frame[3] = stride > 3 ? data[3] : 0;
     }
+    return;
   }
+  #endif
+  strip.setRealtimePixels(pix, count, data, stride, !arlsDisableGammaCorrection && strip.gammaCorrectCol);
 }
 
 /*********************************************************************************************\
@@ -573,21 +1384,82 @@ void setRealtimePixel(uint16_t i, byte r, byte g, byte b, byte w)
 \*********************************************************************************************/
 void refreshNodeList()
 {
-  for (NodesMap::iterator it = Nodes.begin(); it != Nodes.end();) {
-    bool mustRemove = true;
+  static unsigned long lastAged = 0;
+  if (lastAged && millis() - lastAged < NODE_AGE_INTERVAL) return; // the housekeeping timer restarts on reconnects
+  lastAged = millis();
+  Nodes.age(10);
+  if (streamRole != STREAM_ROLE_MASTER) return;
+  for (uint16_t i = 0; i < Nodes.capacity(); i++) {
+    NodeStruct* node = Nodes.at(i);
+    if (node && (node->streamFlags & NODE_STREAM_FOLLOWER) && node->age == STREAM_FOLLOWER_MAX_AGE +1) invalidateStreamFollowers(); // left
+  }
+}
+
+/*********************************************************************************************\
+   Pixel streaming: the master appends a DDP bus for each follower of its sync groups to its own LEDs,
+   ordered by the follower's stream order, and renders them as one strip. Followers need nothing
+   but their announcements, DDP puts them into realtime mode.
+\*********************************************************************************************/
+static bool streamFollowersChanged = false;
+
+void invalidateStreamFollowers()
+{
+  streamFollowersChanged = true;
+}
 
-    if (it->second.ip[0] != 0) {
-      if (it->second.age < 10) {
-        it->second.age++;
-        mustRemove = false;
-        ++it;
+static inline bool isStreamFollower(const NodeStruct* node)
+{
+  return (node->streamFlags & NODE_STREAM_FOLLOWER) && node->leds && node->age <= STREAM_FOLLOWER_MAX_AGE && (node->groups & syncGroups);
+}
+
+//call from the main loop, rebuilds the follower busses after a follower joined or left
+void handleStreamFollowers()
+{
+  if (!streamFollowersChanged || doInitBusses) return;
+  streamFollowersChanged = false;
+
+  NodeStruct* followers[WLED_MAX_BUSSES];
+  uint8_t n = 0, maxFollowers = WLED_MAX_BUSSES - busses.getNumConfiguredBusses();
+  if (streamRole == STREAM_ROLE_MASTER) {
+    for (uint16_t i = 0; i < Nodes.capacity() && n < maxFollowers; i++) {
+      NodeStruct* node = Nodes.at(i);
+      if (!node || !isStreamFollower(node)) continue;
+      uint8_t j = n++; // insertion sort by stream order, then IP for a stable layout
+      while (j && (followers[j-1]->streamOrder > node->streamOrder ||
+                  (followers[j-1]->streamOrder == node->streamOrder && ntohl(followers[j-1]->ip) > ntohl(node->ip)))) {
+        followers[j] = followers[j-1];
+        j--;
       }
+      followers[j] = node;
     }
+  }
+  if (!n && busses.getNumConfiguredBusses() == busses.getNumBusses()) return; // none before and after
 
-    if (mustRemove) {
-      it = Nodes.erase(it);
-    }
+  pixidx_t start = 0;
+  for (uint8_t i = 0; i < busses.getNumConfiguredBusses(); i++) {
+    Bus* bus = busses.getBus(i);
+    start = MAX(start, bus->getStart() + bus->getLength());
   }
+  BusConfig* cfgs[WLED_MAX_BUSSES +1] = {nullptr};
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < n; i++) {
+    NodeStruct* node = followers[i];
+    if (start + node->leds > MAX_LEDS) break;
+    uint8_t pins[4] = {node->ip[0], node->ip[1], node->ip[2], node->ip[3]};
+    BusConfig* bc = new BusConfig(TYPE_NET_DDP_RGB, pins, start, node->leds, COL_ORDER_RGB);
+    bc->setNetOutput(node->streamFlags & NODE_STREAM_RGBW, 0, 0);
+    bc->follower = true;
+    cfgs[count++] = bc;
+    start += node->leds;
+    DEBUG_PRINTF("Stream follower %s: %u LEDs\n", node->ip.toString().c_str(), node->leds);
+  }
+
+  bool aligned = strip.checkSegmentAlignment();
+  busses.setFollowers(cfgs);
+  strip.finalizeInit();
+  if (aligned) strip.makeAutoSegments();
+  else strip.fixInvalidSegments();
+  if (realtimeMode) initRealtimeMap();
 }
 
 /*********************************************************************************************\
@@ -608,10 +1480,24 @@ void sendSysInfoUDP()
   // 38: 1 byte node type id
   // 39: 1 byte node id
   // 40: 4 byte version ID
-  // 44 bytes total
+  // 44: 1 byte stream flags (NODE_STREAM_...)
+  // 45: 1 byte stream order
+  // 46: 2 byte LED count
+  // 48: 1 byte receive groups
+  // 49: 4 byte image variant (fleet OTA builds only, see fleet.cpp)
+  // 53: 4 byte image ID
+  // 57: 1 byte fleet flags (FLEET_...)
+  // 58: 1 byte image download progress
+  // 59: 1 byte rollout minutes left
+  // 49 bytes total, 60 with fleet OTA
 
   // send my info to the world...
-  uint8_t data[44] = {0};
+  #ifdef WLED_ENABLE_FLEET_OTA
+  uint8_t data[60] = {0};
+  fleetAnnounce(data);
+  #else
+  uint8_t data[49] = {0};
+  #endif
   data[0] = 255;
   data[1] = 1;
   
@@ -632,10 +1518,17 @@ void sendSysInfoUDP()
   for (byte i=0; i<sizeof(uint32_t); i++)
     data[40+i] = (build>>(8*i)) & 0xFF;
 
+  if (streamRole == STREAM_ROLE_FOLLOWER) {
+    data[44] = NODE_STREAM_FOLLOWER | (strip.hasWhiteChannel() ? NODE_STREAM_RGBW : 0);
+    data[45] = streamOrder;
+  }
+  uint16_t leds = getRealtimeLedCount(); //LEDs a leader can stream to
+  data[46] = leds & 0xFF;
+  data[47] = leds >> 8;
+  data[48] = receiveGroups;
+
   IPAddress broadcastIP(255, 255, 255, 255);
-  notifier2Udp.beginPacket(broadcastIP, udpPort2);
-  notifier2Udp.write(data, sizeof(data));
-  notifier2Udp.endPacket();
+  sendUdp(UDP_SOCKET_NOTIFIER2, broadcastIP, udpPort2, data, sizeof(data));
 }
 
 
@@ -661,93 +1554,232 @@ void sendSysInfoUDP()
 // 1440 channels per packet
 #define DDP_CHANNELS_PER_PACKET 1440 // 480 leds
 
+#define E131_OUT_HEADER_LEN   126 // up to and including the DMX start code
+#define E131_OUT_SYNC_LEN      49
+#define ARTNET_OUT_HEADER_LEN  18
+#define ARTNET_OUT_SYNC_LEN    14
+#define NET_OUT_UNIVERSE_SIZE 512 // LEDs do not straddle universes, 170 RGB / 128 RGBW LEDs each as expected by WLED receivers
+
+#define NET_OUT_PACKET_SIZE (DDP_HEADER_LEN + DDP_CHANNELS_PER_PACKET) // largest of the three protocols
+
+static WiFiUDP  netOutUdp;              // shared by all network busses, the destination is set per packet
+static uint8_t* netOutPacket = nullptr; // packet being sent, the E1.31 / Art-Net header is built once per protocol
+static uint8_t  netOutType = 255;       // protocol whose header netOutPacket holds
+static uint8_t  e131OutSequence = 0;
+static uint8_t  artnetOutSequence = 0;
+
+static inline void putFlagsLength(uint8_t* p, uint16_t len) { // E1.31 PDU flags and length
+  p[0] = 0x70 | (len >> 8);
+  p[1] = len;
+}
+
+//payload of a packet, the bus buffer already holds the channels in output order
+static void copyNetOutChannels(uint8_t* d, const uint8_t* s, uint16_t channels, uint8_t bri) {
+  if (bri == 255) {
+    memcpy(d, s, channels);
+  } else {
+    for (uint16_t i = 0; i < channels; i++) d[i] = scale8(s[i], bri);
+  }
+}
+
+//E1.31 root layer, shared by data and sync packets (the CID is derived from the MAC, so it stays the same across reboots)
+static void buildE131Root(uint8_t* p, uint8_t vector) {
+  p[E131_ROOT_PREAMBLE_SIZE +1] = 0x10;
+  memcpy_P(p + E131_ROOT_ID, PSTR("ASC-E1.17\0\0\0"), 12);
+  p[E131_ROOT_VECTOR +3] = vector;
+  memcpy_P(p + E131_ROOT_CID, PSTR("WLED-E131-"), 10);
+  for (uint8_t i = 0; i < 6; i++) p[E131_ROOT_CID + 10 + i] = strtoul(escapedMac.substring(i*2, i*2 +2).c_str(), nullptr, 16);
+}
+
+static void buildNetOutHeader(uint8_t type) {
+  uint8_t* p = netOutPacket;
+  memset(p, 0, E131_OUT_HEADER_LEN);
+  if (type == 1) { // E1.31 data packet, lengths, sequence and universe are set per packet
+    buildE131Root(p, 0x04);
+    p[E131_FRAME_VECTOR +3] = 0x02;
+    strlcpy((char*)p + E131_FRAME_SOURCE, serverDescription, 64);
+    p[E131_FRAME_PRIORITY] = 100;
+    p[E131_DMP_VECTOR] = 0x02;
+    p[E131_DMP_TYPE] = 0xa1;
+    p[E131_DMP_ADDR_INC +1] = 1;
+  } else { // ArtDmx, sequence, universe and length are set per packet
+    memcpy_P(p, PSTR("Art-Net"), 8);
+    p[9]  = ARTNET_OPCODE_OPDMX >> 8; // opcode is little endian
+    p[11] = 14;                       // protocol version
+  }
+  netOutType = type;
+}
+
+//pixels of output o in universe u: first LED and count, returns the first channel or -1 if none
+static int16_t netOutUniverseRange(const NetOutput &o, uint16_t u, uint16_t &first, uint16_t &leds) {
+  uint8_t  cpl  = o.rgbw ? 4 : 3;
+  uint16_t ch   = o.channel % NET_OUT_UNIVERSE_SIZE;
+  uint16_t inFirst = (NET_OUT_UNIVERSE_SIZE - ch) / cpl, perUniverse = NET_OUT_UNIVERSE_SIZE / cpl;
+  if (u < o.universe) return -1;
+  if (u == o.universe) {
+    first = 0;
+    leds  = MIN(o.leds, inFirst);
+    return leds ? ch : -1;
+  }
+  uint32_t f = inFirst + (uint32_t)(u - o.universe - 1) * perUniverse;
+  if (f >= o.leds) return -1;
+  first = f;
+  leds  = MIN(o.leds - f, perUniverse);
+  return 0;
+}
+
+//sends universe u merged from all outputs to this destination, returns false if none covers it
+static bool sendNetOutUniverse(IPAddress client, uint8_t type, uint16_t u, uint16_t syncUniverse, const NetOutput* outs, uint8_t count, bool &ok) {
+  uint16_t header = (type == 1) ? E131_OUT_HEADER_LEN : ARTNET_OUT_HEADER_LEN;
+  uint8_t* p = netOutPacket;
+  uint16_t channels = 0;
+  for (uint8_t n = 0; n < count; n++) {
+    uint16_t first, leds;
+    int16_t ch = netOutUniverseRange(outs[n], u, first, leds);
+    if (ch < 0) continue;
+    uint8_t cpl = outs[n].rgbw ? 4 : 3;
+    if (ch > channels) memset(p + header + channels, 0, ch - channels); // gap between fixtures
+    copyNetOutChannels(p + header + ch, outs[n].data + first * cpl, leds * cpl, outs[n].bri);
+    channels = MAX(channels, ch + leds * cpl);
+  }
+  if (!channels) return false;
+
+  if (type == 1) {
+    uint16_t len = E131_OUT_HEADER_LEN + channels;
+    putFlagsLength(p + E131_ROOT_FLENGTH,  len - E131_ROOT_FLENGTH);
+    putFlagsLength(p + E131_FRAME_FLENGTH, len - E131_FRAME_FLENGTH);
+    putFlagsLength(p + E131_DMP_FLENGTH,   len - E131_DMP_FLENGTH);
+    p[E131_FRAME_RESERVED]    = syncUniverse >> 8; p[E131_FRAME_RESERVED +1] = syncUniverse;
+    p[E131_FRAME_SEQ]         = e131OutSequence;
+    p[E131_FRAME_UNIVERSE]    = u >> 8;            p[E131_FRAME_UNIVERSE +1] = u;
+    p[E131_DMP_COUNT]         = (channels + 1) >> 8;
+    p[E131_DMP_COUNT +1]      = channels + 1;
+  } else {
+    if (channels & 1) p[header + channels++] = 0; // ArtDmx length must be even
+    p[12] = artnetOutSequence;
+    p[14] = u; p[15] = u >> 8;  // SubUni and Net
+    p[16] = channels >> 8; p[17] = channels;
+  }
+  ok = netOutUdp.beginPacket(client, type == 1 ? E131_DEFAULT_PORT : ARTNET_DEFAULT_PORT);
+  if (ok) {
+    netOutUdp.write(p, header + channels);
+    ok = netOutUdp.endPacket();
+  }
+  return true;
+}
+
+static void sendNetOutSync(IPAddress client, uint8_t type, uint16_t syncUniverse) {
+  uint8_t p[E131_OUT_SYNC_LEN] = {0};
+  uint16_t len;
+  if (type == 1) {
+    buildE131Root(p, 0x08); // VECTOR_ROOT_E131_EXTENDED
+    putFlagsLength(p + E131_ROOT_FLENGTH, E131_OUT_SYNC_LEN - E131_ROOT_FLENGTH);
+    putFlagsLength(p + E131_FRAME_FLENGTH, E131_OUT_SYNC_LEN - E131_FRAME_FLENGTH);
+    p[E131_FRAME_VECTOR +3] = 0x01; // VECTOR_E131_EXTENDED_SYNCHRONIZATION
+    p[44] = e131OutSequence;
+    p[45] = syncUniverse >> 8;
+    p[46] = syncUniverse;
+    len = E131_OUT_SYNC_LEN;
+  } else {
+    memcpy_P(p, PSTR("Art-Net"), 8);
+    p[9]  = ARTNET_OPCODE_OPSYNC >> 8;
+    p[11] = 14;
+    len = ARTNET_OUT_SYNC_LEN;
+  }
+  if (!netOutUdp.beginPacket(client, type == 1 ? E131_DEFAULT_PORT : ARTNET_DEFAULT_PORT)) return;
+  netOutUdp.write(p, len);
+  netOutUdp.endPacket();
+}
+
 //
 // Send real time UDP updates to the specified client
 //
 // type   - protocol type (0=DDP, 1=E1.31, 2=ArtNet)
 // client - the IP address to send to
-// length - the number of pixels
-// buffer - a buffer of at least length*4 bytes long
-// isRGBW - true if the buffer contains 4 components per pixel
+// outs   - the network busses sending to this client, each with its pixel buffer (3 or 4 channels per pixel),
+//          brightness and start: DDP data offset in channel, E1.31/Art-Net universe and channel in it
+// count  - number of outputs
 
 uint8_t sequenceNumber = 0; // this needs to be shared across all outputs
 
-uint8_t realtimeBroadcast(uint8_t type, IPAddress client, uint16_t length, uint8_t *buffer, uint8_t bri, bool isRGBW)  {
-  if (!(apActive || interfacesInited) || !client[0] || !length) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap 
+uint8_t realtimeBroadcast(uint8_t type, IPAddress client, const NetOutput* outs, uint8_t count)  {
+  if (!(apActive || interfacesInited) || !client[0] || !count) return 1;  // network not initialised or dummy/unset IP address  031522 ajn added check for ap 
 
-  WiFiUDP ddpUdp;
+  if (!netOutPacket) netOutPacket = (uint8_t*) malloc(NET_OUT_PACKET_SIZE);
+  if (!netOutPacket) return 1;
 
   switch (type) {
-    case 0: // DDP
+    case 0: // DDP, each output sends its own channel range, the last packet to the client pushes
     {
-      // calculate the number of UDP packets we need to send
-      uint16_t channelCount = length * 3; // 1 channel for every R,G,B value
-      uint16_t packetCount = ((channelCount-1) / DDP_CHANNELS_PER_PACKET) +1;
-
-      // there are 3 channels per RGB pixel
-      uint32_t channel = 0; // TODO: allow specifying the start channel
-      // the current position in the buffer 
-      uint16_t bufferOffset = 0;
-
-      for (uint16_t currentPacket = 0; currentPacket < packetCount; currentPacket++) {
-        if (sequenceNumber > 15) sequenceNumber = 0;
-
-        if (!ddpUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
-          DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
-          return 1; // problem
-        }
-
-        // the amount of data is AFTER the header in the current packet
-        uint16_t packetSize = DDP_CHANNELS_PER_PACKET;
-
-        uint8_t flags = DDP_FLAGS1_VER1;
-        if (currentPacket == (packetCount - 1)) {
-          // last packet, set the push flag
-          // TODO: determine if we want to send an empty push packet to each destination after sending the pixel data
-          flags = DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH;
-          if (channelCount % DDP_CHANNELS_PER_PACKET) {
-            packetSize = channelCount % DDP_CHANNELS_PER_PACKET;
+      uint8_t* p = netOutPacket;
+      netOutType = 0; // E1.31 / Art-Net header overwritten
+      for (uint8_t n = 0; n < count; n++) {
+        const NetOutput &o = outs[n];
+        uint8_t  cpl = o.rgbw ? 4 : 3;
+        uint32_t channelCount = (uint32_t)o.leds * cpl;
+        uint32_t sent = 0;
+        while (sent < channelCount) {
+          // the amount of data is AFTER the header in the current packet
+          uint16_t packetSize = MIN(channelCount - sent, DDP_CHANNELS_PER_PACKET); // 1440 holds whole RGB and RGBW pixels
+          uint32_t channel = o.channel + sent;
+          bool last = (n == count -1) && sent + packetSize >= channelCount;
+
+          /*0*/p[0] = last ? DDP_FLAGS1_VER1 | DDP_FLAGS1_PUSH : DDP_FLAGS1_VER1;
+          /*1*/p[1] = sequenceNumber++ & 0x0F; // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
+          /*2*/p[2] = o.rgbw ? (DDP_TYPE_RGBW << 3) | 3 : 0; // RGBW 8 bit, RGB is the default
+          /*3*/p[3] = DDP_ID_DISPLAY;
+          // data offset in bytes, 32-bit number, MSB first
+          /*4*/p[4] = 0xFF & (channel >> 24);
+          /*5*/p[5] = 0xFF & (channel >> 16);
+          /*6*/p[6] = 0xFF & (channel >>  8);
+          /*7*/p[7] = 0xFF & (channel      );
+          // data length in bytes, 16-bit number, MSB first
+          /*8*/p[8] = 0xFF & (packetSize >> 8);
+          /*9*/p[9] = 0xFF & (packetSize     );
+          if (sequenceNumber > 15) sequenceNumber = 0;
+
+          copyNetOutChannels(p + DDP_HEADER_LEN, o.data + sent, packetSize, o.bri);
+
+          if (!netOutUdp.beginPacket(client, DDP_DEFAULT_PORT)) {  // port defined in ESPAsyncE131.h
+            DEBUG_PRINTLN(F("WiFiUDP.beginPacket returned an error"));
+            return 1; // problem
           }
+          netOutUdp.write(p, DDP_HEADER_LEN + packetSize);
+          if (!netOutUdp.endPacket()) {
+            DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
+            return 1; // problem
+          }
+          sent += packetSize;
         }
-
-        // write the header
-        /*0*/ddpUdp.write(flags);
-        /*1*/ddpUdp.write(sequenceNumber++ & 0x0F); // sequence may be unnecessary unless we are sending twice (as requested in Sync settings)
-        /*2*/ddpUdp.write(0);
-        /*3*/ddpUdp.write(DDP_ID_DISPLAY);
-        // data offset in bytes, 32-bit number, MSB first
-        /*4*/ddpUdp.write(0xFF & (channel >> 24));
-        /*5*/ddpUdp.write(0xFF & (channel >> 16));
-        /*6*/ddpUdp.write(0xFF & (channel >>  8));
-        /*7*/ddpUdp.write(0xFF & (channel      ));
-        // data length in bytes, 16-bit number, MSB first
-        /*8*/ddpUdp.write(0xFF & (packetSize >> 8));
-        /*9*/ddpUdp.write(0xFF & (packetSize     ));
-
-        // write the colors, the write write(const uint8_t *buffer, size_t size) 
-        // function is just a loop internally too
-        for (uint16_t i = 0; i < packetSize; i += 3) {
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // R
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // G
-          ddpUdp.write(scale8(buffer[bufferOffset++], bri)); // B
-          if (isRGBW) bufferOffset++;
-        }
-
-        if (!ddpUdp.endPacket()) {            
-          DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
-          return 1; // problem
-        }
-
-        channel += packetSize;
       }
     } break;
 
     case 1: //E1.31
-    {
-    } break;
-
     case 2: //ArtNet
     {
+      if (netOutType != type) buildNetOutHeader(type);
+      //universes of all outputs to this client, a universe shared by several outputs is sent once
+      uint16_t first = UINT16_MAX, last = 0;
+      for (uint8_t n = 0; n < count; n++) {
+        uint8_t  cpl = outs[n].rgbw ? 4 : 3;
+        uint16_t inFirst = (NET_OUT_UNIVERSE_SIZE - outs[n].channel % NET_OUT_UNIVERSE_SIZE) / cpl;
+        uint16_t end = outs[n].universe;
+        if (outs[n].leds > inFirst) end += (outs[n].leds - inFirst + NET_OUT_UNIVERSE_SIZE / cpl - 1) / (NET_OUT_UNIVERSE_SIZE / cpl);
+        first = MIN(first, outs[n].universe);
+        last  = MAX(last, end);
+      }
+      uint16_t syncUniverse = (netOutSync && first) ? first : 0; // the first universe carries the sync packets
+      bool ok = true;
+      for (uint32_t u = first; u <= last; u++) {
+        sendNetOutUniverse(client, type, u, syncUniverse, outs, count, ok);
+        if (!ok) {
+          DEBUG_PRINTLN(F("WiFiUDP.endPacket returned an error"));
+          return 1; // problem
+        }
+      }
+      if (netOutSync) sendNetOutSync(client, type, syncUniverse);
+      if (type == 1) e131OutSequence++;
+      else if (++artnetOutSequence == 0) artnetOutSequence = 1; // 0 disables sequencing in Art-Net
     } break;
   }
   return 0;
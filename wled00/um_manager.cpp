@@ -4,7 +4,183 @@
  */
 
 //Usermod Manager internals
-void UsermodManager::loop()              { for (byte i = 0; i < numMods; i++) ums[i]->loop();  }
+
+/*
+ * Usermods are called once their interval passed, starting with the one deferred first in the previous pass.
+ * Once WLED_USERMOD_BUDGET_US is spent, the remaining ones wait for the next pass (unless USERMOD_PRIORITY_HIGH),
+ * so a slow usermod cannot hold back the strip. One that took longer than the whole budget by itself is not
+ * called again until its runtime has passed once more.
+ */
+void UsermodManager::loop()
+{
+  uint32_t passStart = micros();
+  handleTasks();
+  uint32_t now = millis();
+  bool deferred = false;
+  byte first = nextMod < numMods ? nextMod : 0;
+  for (byte n = 0; n < numMods; n++) {
+    byte i = (first + n) % numMods;
+    LoopStats& st = stats[i];
+    uint32_t interval = ums[i]->getLoopInterval();
+    if (st.holdOff > interval) interval = st.holdOff;
+    if (st.runs && now - st.lastRun < interval) continue;
+
+    uint32_t spent = micros() - passStart;
+    uint8_t prio = ums[i]->getLoopPriority();
+    if ((prio == USERMOD_PRIORITY_NORMAL && spent >= WLED_USERMOD_BUDGET_US)
+      || (prio == USERMOD_PRIORITY_LOW && spent >= WLED_USERMOD_BUDGET_US/2)) {
+      st.deferrals++;
+      if (!deferred) nextMod = i;
+      deferred = true;
+      continue;
+    }
+
+    uint32_t start = micros();
+    ums[i]->loop();
+    uint32_t us = micros() - start;
+    TRACE_SPAN(TRACE_USERMOD, ums[i]->getId(), start);
+    st.lastRun = now;
+    st.runs++;
+    st.totalUs += us;
+    if (us > st.maxUs) st.maxUs = us;
+    st.holdOff = 0;
+    if (us > WLED_USERMOD_BUDGET_US && prio != USERMOD_PRIORITY_HIGH) {
+      st.overruns++;
+      st.holdOff = us / 1000;
+    }
+  }
+  if (!deferred) nextMod = 0;
+}
+
+/*
+ * Usermod tasks take blocking I/O (sensor conversions, display transfers) out of loop().
+ * Slots are only taken and freed by loop(), on ESP32 a queue hands their index to the worker task
+ * and another one returns it, so the argument is owned by the worker until onTaskDone().
+ */
+#ifdef WLED_USERMOD_TASK
+static QueueHandle_t umTaskQueue = nullptr, umDoneQueue = nullptr;
+
+void UsermodManager::workerTask(void* param)
+{
+  Task* t = (Task*)param;
+  uint8_t slot;
+  for (;;) {
+    if (xQueueReceive(umTaskQueue, &slot, portMAX_DELAY) != pdTRUE) continue;
+    while (!t[slot].um->runTask(t[slot].id, t[slot].arg)) vTaskDelay(1);
+    xQueueSend(umDoneQueue, &slot, portMAX_DELAY);
+  }
+}
+#endif
+
+bool UsermodManager::isTaskPending(Usermod* um, uint8_t taskId)
+{
+  for (uint8_t i = 0; i < WLED_MAX_USERMOD_TASKS; i++) {
+    if (tasks[i].um == um && tasks[i].id == taskId) return true;
+  }
+  return false;
+}
+
+//false if the same task is still pending or all slots are taken
+bool UsermodManager::startTask(Usermod* um, uint8_t taskId, void* arg)
+{
+  if (!um || isTaskPending(um, taskId)) return false;
+  uint8_t slot = 0;
+  while (slot < WLED_MAX_USERMOD_TASKS && tasks[slot].um) slot++;
+  if (slot == WLED_MAX_USERMOD_TASKS) return false;
+
+  #ifdef WLED_USERMOD_TASK
+  if (!umTaskQueue) { //started with the first task
+    umTaskQueue = xQueueCreate(WLED_MAX_USERMOD_TASKS, sizeof(uint8_t));
+    umDoneQueue = xQueueCreate(WLED_MAX_USERMOD_TASKS, sizeof(uint8_t));
+    if (!umTaskQueue || !umDoneQueue
+      || xTaskCreatePinnedToCore(workerTask, "usermod", WLED_USERMOD_TASK_STACK, tasks, 1, nullptr, WLED_USERMOD_TASK_CORE) != pdPASS) {
+      if (umTaskQueue) vQueueDelete(umTaskQueue);
+      if (umDoneQueue) vQueueDelete(umDoneQueue);
+      umTaskQueue = umDoneQueue = nullptr;
+      return false;
+    }
+  }
+  #endif
+
+  tasks[slot].um  = um;
+  tasks[slot].arg = arg;
+  tasks[slot].id  = taskId;
+  #ifdef WLED_USERMOD_TASK
+  xQueueSend(umTaskQueue, &slot, 0); //cannot be full, there are as many slots
+  #endif
+  return true;
+}
+
+//delivers finished tasks, on ESP8266 runs one step of each pending one
+void UsermodManager::handleTasks()
+{
+  #ifdef WLED_USERMOD_TASK
+  uint8_t slot;
+  while (umDoneQueue && xQueueReceive(umDoneQueue, &slot, 0) == pdTRUE) {
+    Task t = tasks[slot];
+    tasks[slot].um = nullptr;
+    t.um->onTaskDone(t.id, t.arg);
+  }
+  #else
+  for (uint8_t i = 0; i < WLED_MAX_USERMOD_TASKS; i++) {
+    if (!tasks[i].um || !tasks[i].um->runTask(tasks[i].id, tasks[i].arg)) continue;
+    Task t = tasks[i];
+    tasks[i].um = nullptr;
+    t.um->onTaskDone(t.id, t.arg);
+  }
+  #endif
+}
+
+//per usermod runtime accounting for /json/info, the maxima are reset when read
+void UsermodManager::serializeLoopStats(JsonArray arr)
+{
+  for (byte i = 0; i < numMods; i++) {
+    LoopStats& st = stats[i];
+    JsonObject o = arr.createNestedObject();
+    o["id"]  = ums[i]->getId();
+    o["n"]   = st.runs;
+    o[F("avg")] = st.runs ? st.totalUs / st.runs : 0; //us
+    o[F("max")] = st.maxUs;
+    o[F("ovr")] = st.overruns;
+    o[F("def")] = st.deferrals;
+    st.maxUs = 0;
+  }
+}
+
+//runtime of the i-th usermod for the metrics export, does not reset the maximum
+bool UsermodManager::getLoopStats(byte i, uint16_t& id, uint32_t& runs, uint32_t& avgUs, uint32_t& maxUs)
+{
+  if (i >= numMods) return false;
+  id    = ums[i]->getId();
+  runs  = stats[i].runs;
+  avgUs = runs ? stats[i].totalUs / runs : 0;
+  maxUs = stats[i].maxUs;
+  return true;
+}
+
+//ms until the next usermod loop() is due, 0 if one runs on every pass or a task is pending
+uint32_t UsermodManager::getIdleTime()
+{
+  for (uint8_t i = 0; i < WLED_MAX_USERMOD_TASKS; i++) if (tasks[i].um) return 0;
+  uint32_t now = millis();
+  uint32_t idle = UINT32_MAX;
+  for (byte i = 0; i < numMods; i++) {
+    LoopStats& st = stats[i];
+    uint32_t interval = ums[i]->getLoopInterval();
+    if (st.holdOff > interval) interval = st.holdOff;
+    if (!interval || !st.runs || now - st.lastRun >= interval) return 0;
+    if (interval - (now - st.lastRun) < idle) idle = interval - (now - st.lastRun);
+  }
+  return idle;
+}
+
+uint32_t UsermodManager::getMemUsage()
+{
+  uint32_t mem = 0;
+  for (byte i = 0; i < numMods; i++) mem += ums[i]->getMemUsage();
+  return mem;
+}
+
 void UsermodManager::handleOverlayDraw() { for (byte i = 0; i < numMods; i++) ums[i]->handleOverlayDraw(); }
 bool UsermodManager::handleButton(uint8_t b) { 
   bool overrideIO = false;
@@ -28,6 +204,9 @@ bool UsermodManager::readFromConfig(JsonObject& obj)    {
   }
   return allComplete;
 }
+void UsermodManager::publish(uint16_t event, uint8_t arg) {
+  for (byte i = 0; i < numMods; i++) if (ums[i]->getEventMask() & event) ums[i]->onEvent(event, arg);
+}
 void UsermodManager::onMqttConnect(bool sessionPresent) { for (byte i = 0; i < numMods; i++) ums[i]->onMqttConnect(sessionPresent); }
 bool UsermodManager::onMqttMessage(char* topic, char* payload) {
   for (byte i = 0; i < numMods; i++) if (ums[i]->onMqttMessage(topic, payload)) return true;
@@ -3,25 +3,100 @@
 #include "const.h"
 
 //threading/network callback details: https://github.com/Aircoookie/WLED/pull/2336#discussion_r762276994
-bool requestJSONBufferLock(uint8_t module)
-{
-  unsigned long now = millis();
+#ifdef ARDUINO_ARCH_ESP32
+static portMUX_TYPE jsonBufferMux = portMUX_INITIALIZER_UNLOCKED;
+#define JSON_BUFFER_ENTER() portENTER_CRITICAL(&jsonBufferMux)
+#define JSON_BUFFER_EXIT()  portEXIT_CRITICAL(&jsonBufferMux)
+#else
+#define JSON_BUFFER_ENTER()
+#define JSON_BUFFER_EXIT()
+#endif
 
-  while (jsonBufferLock && millis()-now < 1000) delay(1); // wait for a second for buffer lock
+#ifdef WLED_ENABLE_TRACE
+static uint32_t jsonLockStart = 0; // the global doc was locked at
+#endif
 
-  if (millis()-now >= 1000) {
-    DEBUG_PRINT(F("ERROR: Locking JSON buffer failed! ("));
-    DEBUG_PRINT(jsonBufferLock);
-    DEBUG_PRINTLN(")");
-    return false; // waiting time-outed
-  }
+#if WLED_JSON_POOL_SIZE > 0
+// documents that can be used instead of the global doc when no fileDoc semantics are needed (serializing responses)
+static JsonDocument* jsonPool[WLED_JSON_POOL_SIZE] = {nullptr};
+static volatile uint8_t jsonPoolLock[WLED_JSON_POOL_SIZE] = {0};
+#ifdef WLED_ENABLE_TRACE
+static uint32_t jsonPoolLockStart[WLED_JSON_POOL_SIZE] = {0};
+#endif
+#endif
 
-  jsonBufferLock = module ? module : 255;
+static void countJSONBufferContention(uint8_t module)
+{
+  if (module >= WLED_JSON_LOCK_MODULES) module = 0;
+  if (jsonBufferContention[module] < UINT16_MAX) jsonBufferContention[module]++;
+}
+
+static bool lockJSONBuffer(uint8_t module)
+{
+  bool locked = false;
+  JSON_BUFFER_ENTER();
+  if (!jsonBufferLock) {
+    jsonBufferLock = module ? module : 255;
+    locked = true;
+  }
+  JSON_BUFFER_EXIT();
+  if (!locked) return false;
+  #ifdef WLED_ENABLE_TRACE
+  jsonLockStart = micros();
+  #endif
   fileDoc = &doc;  // used for applying presets (presets.cpp)
   doc.clear();
   return true;
 }
 
+static JsonDocument* lockPooledJSONBuffer(uint8_t module)
+{
+  #if WLED_JSON_POOL_SIZE > 0
+  int8_t slot = -1;
+  JSON_BUFFER_ENTER();
+  for (uint8_t i = 0; i < WLED_JSON_POOL_SIZE; i++) {
+    if (jsonPool[i] && !jsonPoolLock[i]) {
+      jsonPoolLock[i] = module ? module : 255;
+      slot = i;
+      break;
+    }
+  }
+  JSON_BUFFER_EXIT();
+  if (slot >= 0) {
+    #ifdef WLED_ENABLE_TRACE
+    jsonPoolLockStart[slot] = micros();
+    #endif
+    jsonPool[slot]->clear();
+    return jsonPool[slot];
+  }
+  #endif
+  return lockJSONBuffer(module) ? &doc : nullptr;
+}
+
+bool requestJSONBufferLock(uint8_t module)
+{
+  if (lockJSONBuffer(module)) return true;
+  countJSONBufferContention(module);
+
+  unsigned long now = millis();
+  while (millis()-now < 1000) { // wait for a second for buffer lock
+    delay(1);
+    if (lockJSONBuffer(module)) return true;
+  }
+
+  DEBUG_PRINT(F("ERROR: Locking JSON buffer failed! ("));
+  DEBUG_PRINT(jsonBufferLock);
+  DEBUG_PRINTLN(")");
+  return false; // waiting time-outed
+}
+
+// does not wait, returns false if the buffer is in use
+bool tryRequestJSONBufferLock(uint8_t module)
+{
+  if (lockJSONBuffer(module)) return true;
+  countJSONBufferContention(module);
+  return false;
+}
 
 void releaseJSONBufferLock()
 {
@@ -29,9 +104,120 @@ void releaseJSONBufferLock()
   DEBUG_PRINT(jsonBufferLock);
   DEBUG_PRINTLN(")");
   fileDoc = nullptr;
+  TRACE_SPAN(TRACE_JSON_LOCK, jsonBufferLock, jsonLockStart);
   jsonBufferLock = 0;
 }
 
+// allocate pooled documents once so serializing responses does not fragment the heap
+void initJSONBufferPool()
+{
+  #if WLED_JSON_POOL_SIZE > 0
+  uint8_t poolSize = WLED_JSON_POOL_SIZE;
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  if (!psramFound()) poolSize = 1; // do not use up the heap
+  #endif
+  for (uint8_t i = 0; i < poolSize; i++) {
+    if (jsonPool[i]) continue;
+    PSRAMDynamicJsonDocument* buffer = new PSRAMDynamicJsonDocument(JSON_BUFFER_SIZE);
+    if (!buffer) break;
+    if (!buffer->capacity()) { delete buffer; memAllocFailed(MEM_JSON); break; } // out of memory
+    jsonPool[i] = buffer;
+  }
+  #endif
+}
+
+// heap held by the global document and the pool
+static uint32_t jsonBufferMemUsage()
+{
+  uint32_t mem = 0;
+  #ifndef WLED_USE_DYNAMIC_JSON
+  mem += JSON_BUFFER_SIZE;
+  #endif
+  #if WLED_JSON_POOL_SIZE > 0
+  for (uint8_t i = 0; i < WLED_JSON_POOL_SIZE; i++) if (jsonPool[i]) mem += jsonPool[i]->capacity();
+  #endif
+  return mem;
+}
+
+void memAllocFailed(uint8_t subsystem)
+{
+  if (subsystem >= MEM_SUBSYSTEMS) return;
+  if (memAllocFailures[subsystem] < UINT16_MAX) memAllocFailures[subsystem]++;
+  LOG_W("Allocation failed, subsystem %u", subsystem);
+}
+
+// heap by subsystem (MEM_... order) and failed allocations, the largest free block and fragmentation in %
+void serializeMemStats(JsonObject root)
+{
+  uint32_t used[MEM_SUBSYSTEMS] = {0};
+  used[MEM_BUSSES]   = busses.getMemUsage();
+  used[MEM_SEGMENTS] = strip.getUsedSegmentData() + strip.getUsedSegmentBuffers();
+  used[MEM_LEDMAP]   = strip.getLedmapLength() * sizeof(uint16_t);
+  used[MEM_JSON]     = jsonBufferMemUsage();
+  used[MEM_WS]       = wsMemUsage();
+  used[MEM_USERMODS] = usermods.getMemUsage();
+  JsonArray u = root.createNestedArray("u");
+  JsonArray f = root.createNestedArray("f");
+  for (uint8_t i = 0; i < MEM_SUBSYSTEMS; i++) {
+    u.add(used[i]);
+    f.add(memAllocFailures[i]);
+  }
+  uint32_t block = maxAllocatable(ALLOC_HOT);
+  root[F("block")] = block;
+  #ifdef ESP8266
+  root[F("frag")] = ESP.getHeapFragmentation();
+  #else
+  uint32_t heap = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  root[F("frag")] = heap ? 100 - (block * 100) / heap : 0;
+  #endif
+}
+
+// returns a free pooled document or the global doc (locked), nullptr if none became available
+// the returned document must not be used for applying presets as fileDoc may not point to it
+JsonDocument* requestJSONBuffer(uint8_t module, bool wait)
+{
+  JsonDocument* buffer = lockPooledJSONBuffer(module);
+  if (buffer) return buffer;
+  countJSONBufferContention(module);
+  if (!wait) return nullptr;
+
+  unsigned long now = millis();
+  while (millis()-now < 1000) {
+    delay(1);
+    buffer = lockPooledJSONBuffer(module);
+    if (buffer) return buffer;
+  }
+  DEBUG_PRINTLN(F("ERROR: No JSON buffer available!"));
+  return nullptr;
+}
+
+void releaseJSONBuffer(JsonDocument* buffer)
+{
+  if (buffer == &doc) {
+    releaseJSONBufferLock();
+    return;
+  }
+  #if WLED_JSON_POOL_SIZE > 0
+  for (uint8_t i = 0; i < WLED_JSON_POOL_SIZE; i++) {
+    if (jsonPool[i] == buffer) {
+      TRACE_SPAN(TRACE_JSON_LOCK, jsonPoolLock[i], jsonPoolLockStart[i]);
+      jsonPoolLock[i] = 0;
+      return;
+    }
+  }
+  #endif
+}
+
+
+// appends the decimal bus index to a two character LED settings field name ("LT" -> "LT12"), name must hold 5 chars
+void setBusFieldIndex(char* name, uint8_t s)
+{
+  uint8_t i = 2;
+  if (s > 9) name[i++] = 48 + s / 10;
+  name[i++] = 48 + s % 10;
+  name[i] = 0;
+}
+
 
 // extracts effect mode (or palette) name from names serialized string
 // caller must provide large enough buffer for name (incluing SR extensions)!
@@ -66,3 +252,30 @@ uint8_t extractModeName(uint8_t mode, const char *src, char *dest, uint8_t maxLe
   dest[printedChars] = '\0';
   return strlen(dest);
 }
+
+static uint8_t copyIndexedName(const char *src, const uint16_t *pos, const uint8_t *lens, uint8_t count, uint8_t i, char *dest, uint8_t maxLen)
+{
+  uint8_t n = 0;
+  if (i < count) {
+    n = pgm_read_byte(lens + i);
+    if (n > maxLen) n = maxLen;
+    memcpy_P(dest, src + pgm_read_word(pos + i), n);
+  }
+  dest[n] = '\0';
+  return n;
+}
+
+// effect name by index, from the positions generated into fx_names.h instead of scanning JSON_mode_names
+uint8_t extractFxName(uint8_t mode, char *dest, uint8_t maxLen)
+{
+  return copyIndexedName(JSON_mode_names, JSON_mode_name_pos, JSON_mode_name_len, FX_NAME_COUNT, mode, dest, maxLen);
+}
+
+uint8_t extractPaletteName(uint8_t palette, char *dest, uint8_t maxLen)
+{
+  if (palette >= PAL_NAME_COUNT && palette < strip.getPaletteCount()) { // user palette
+    int n = snprintf_P(dest, maxLen +1, PSTR("Custom %u"), palette - PAL_NAME_COUNT +1);
+    return MIN(n, maxLen);
+  }
+  return copyIndexedName(JSON_palette_names, JSON_palette_name_pos, JSON_palette_name_len, PAL_NAME_COUNT, palette, dest, maxLen);
+}
@@ -0,0 +1,119 @@
+#include "wled.h"
+
+/*
+ * Fast WiFi (re)connect (WLED_ENABLE_FAST_RECONNECT)
+ * The access point (BSSID, channel) of the last connection is kept in /wifi.bin, so after a reboot or a
+ * dropped connection the station associates directly with it instead of scanning all channels first.
+ * With "nw.fastip" the DHCP lease is reused as well, which skips DHCP but means the address is not renewed
+ * until the next reconnect, so only use it with an address reserved for the node on the router.
+ * If the directed attempt does not connect within WLED_WIFI_FAST_MS the normal connect with scan and DHCP
+ * follows, and is used until a connection succeeds again.
+ */
+#ifdef WLED_ENABLE_FAST_RECONNECT
+
+#ifndef WLED_WIFI_FAST_MS
+  #define WLED_WIFI_FAST_MS 4000
+#endif
+#define WIFI_CACHE_FILE    "/wifi.bin"
+#define WIFI_CACHE_VERSION 1
+
+struct WifiCache {
+  char     magic[2];      // "WC"
+  uint8_t  version;
+  uint8_t  channel;
+  char     ssid[33];
+  uint8_t  bssid[6];
+  uint8_t  ip[4], gateway[4], subnet[4], dns[4];
+};
+
+enum : uint8_t { FAST_NONE, FAST_TRYING, FAST_FAILED };
+
+static WifiCache cache;
+static bool     cacheLoaded = false;
+static bool     cacheValid = false;
+static uint8_t  fastState = FAST_NONE;
+static bool     fastLease = false;     // the attempt uses the cached lease
+static unsigned long assocStart = 0;
+static uint16_t assocMs = 0;           // begin() to connected of the last connection
+static uint8_t  assocPath = 0;         // 0 scan and DHCP, 1 directed, 2 directed with cached lease
+static uint16_t connects = 0;
+
+static void loadWifiCache()
+{
+  cacheLoaded = true;
+  File f = WLED_FS.open(WIFI_CACHE_FILE, "r");
+  if (!f) return;
+  cacheValid = f.read((uint8_t*)&cache, sizeof(cache)) == sizeof(cache)
+            && cache.magic[0] == 'W' && cache.magic[1] == 'C' && cache.version == WIFI_CACHE_VERSION;
+  f.close();
+}
+
+//called by initConnection() instead of WiFi.begin(), returns false if the normal connect is to be used
+bool wifiFastBegin()
+{
+  assocStart = millis();
+  if (!cacheLoaded) loadWifiCache();
+  if (fastState == FAST_FAILED || !cacheValid || strncmp(cache.ssid, clientSSID, sizeof(cache.ssid)) != 0
+      || !cache.channel || cache.channel > 14) {
+    fastState = FAST_NONE;
+    fastLease = false;
+    return false;
+  }
+  fastLease = wifiFastIP && staticIP[0] == 0 && cache.ip[0] != 0;
+  if (fastLease) {
+    WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.subnet), IPAddress(cache.dns));
+  }
+  DEBUG_PRINTF("Fast connect to %02X:%02X:%02X:%02X:%02X:%02X on channel %u\n",
+               cache.bssid[0], cache.bssid[1], cache.bssid[2], cache.bssid[3], cache.bssid[4], cache.bssid[5], cache.channel);
+  WiFi.begin(clientSSID, clientPass, cache.channel, cache.bssid);
+  fastState = FAST_TRYING;
+  return true;
+}
+
+//true once a directed attempt has not connected in time, then the normal connect is to be started
+bool wifiFastFailed(unsigned long elapsed)
+{
+  if (fastState != FAST_TRYING || elapsed < WLED_WIFI_FAST_MS) return false;
+  DEBUG_PRINTLN(F("Fast connect failed, scanning."));
+  fastState = FAST_FAILED;
+  return true;
+}
+
+//newly connected, records the timing and keeps the access point and lease if they changed
+void wifiFastConnected()
+{
+  assocMs = min(millis() - assocStart, (unsigned long)UINT16_MAX);
+  assocPath = fastState == FAST_TRYING ? (fastLease ? 2 : 1) : 0;
+  fastState = FAST_NONE;
+  connects++;
+  DEBUG_PRINTF("WiFi connected in %u ms (path %u)\n", assocMs, assocPath);
+
+  WifiCache c;
+  memset(&c, 0, sizeof(c));
+  c.magic[0] = 'W'; c.magic[1] = 'C';
+  c.version = WIFI_CACHE_VERSION;
+  c.channel = WiFi.channel();
+  strlcpy(c.ssid, clientSSID, sizeof(c.ssid));
+  const uint8_t* bssid = WiFi.BSSID();
+  if (bssid) memcpy(c.bssid, bssid, sizeof(c.bssid));
+  IPAddress ip = Network.localIP(), gw = WiFi.gatewayIP(), sn = WiFi.subnetMask(), dns = WiFi.dnsIP();
+  for (uint8_t i = 0; i < 4; i++) {
+    c.ip[i] = ip[i]; c.gateway[i] = gw[i]; c.subnet[i] = sn[i]; c.dns[i] = dns[i];
+  }
+  if (cacheValid && memcmp(&c, &cache, sizeof(c)) == 0) return; // spare the flash
+  cache = c;
+  cacheValid = true;
+  File f = WLED_FS.open(WIFI_CACHE_FILE, "w");
+  if (!f) return;
+  f.write((const uint8_t*)&cache, sizeof(cache));
+  f.close();
+}
+
+void serializeWifiTiming(JsonObject wifi)
+{
+  wifi[F("assoc")] = assocMs;   // ms from begin() to connected
+  wifi[F("path")]  = assocPath;
+  wifi[F("conn")]  = connects;  // connections since boot
+}
+
+#endif
@@ -119,27 +119,71 @@ void WiFiEvent(WiFiEvent_t event)
   }
 }
 
+//while WARLS/E1.31/Adalight etc. stream to the whole strip, polls only the realtime sources
+//and returns true until the next housekeeping pass (connection, time, buttons, usermods, web sockets) is due
+bool WLED::realtimeLoop()
+{
+  static unsigned long lastPoll = 0;
+  static unsigned long lastHousekeeping = 0;
+  if (!realtimeMode || realtimeOverride || strip.hasLiveSegments()) {
+    lastPoll = 0;
+    return false;
+  }
+
+  unsigned long now = micros();
+  if (lastPoll) {
+    uint32_t gap = now - lastPoll;
+    realtimeLoopAvg = (realtimeLoopAvg * 7 + gap) / 8;
+    if (gap > realtimeLoopMax) realtimeLoopMax = gap;
+  }
+  lastPoll = now;
+
+  if (millis() - lastHousekeeping >= WLED_RT_HOUSEKEEPING_MS || doReboot || doInitBusses || doCloseFile) {
+    lastHousekeeping = millis();
+    return false; // full loop pass, includes the realtime sources
+  }
+  RENDER_LOCK();
+  handleSerial();
+  PROFILE_START(notifStart);
+  handleNotifications();
+  PROFILE_STAGE(PROF_NOTIFICATIONS, notifStart);
+  RENDER_UNLOCK();
+  return true;
+}
+
 void WLED::loop()
 {
   #ifdef WLED_DEBUG
   static unsigned long maxUsermodMillis = 0;
   #endif
+  TRACE_LOOP_BOUNDARY();
+
+  if (realtimeLoop()) {
+    #ifdef WLED_DEBUG
+    loops++;
+    #endif
+    return;
+  }
 
   handleTime();
   handleIR();        // 2nd call to function needed for ESP32 to return valid results -- should be good for ESP8266, too
   handleConnection();
+  RENDER_LOCK(); // strip state is only modified between frames
+  handleStateQueue();
+  handleMqtt();
   handleSerial();
+  PROFILE_START(notifStart);
   handleNotifications();
+  PROFILE_STAGE(PROF_NOTIFICATIONS, notifStart);
   handleTransitions();
-#ifdef WLED_ENABLE_DMX
-  handleDMX();
-#endif
   userLoop();
 
   #ifdef WLED_DEBUG
   unsigned long usermodMillis = millis();
   #endif
+  PROFILE_START(umStart);
   usermods.loop();
+  PROFILE_STAGE(PROF_USERMODS, umStart);
   #ifdef WLED_DEBUG
   usermodMillis = millis() - usermodMillis;
   if (usermodMillis > maxUsermodMillis) maxUsermodMillis = usermodMillis;
@@ -151,22 +195,37 @@ void WLED::loop()
   #ifndef WLED_DISABLE_ALEXA
   handleAlexa();
   #endif
+  RENDER_UNLOCK();
 
   yield();
 
-  if (doReboot && !doInitBusses) // if busses have to be inited & saved, wait until next iteration
+  if (doReboot && !doInitBusses && !doSerializeConfig) // if busses have to be inited & saved, wait until next iteration
     reset();
   if (doCloseFile) {
     closeFile();
     yield();
   }
+  handleFileUpload();
+  #ifdef WLED_ENABLE_ADAPTIVE_QUALITY
+  bool housekeeping = !strip.deferHousekeeping(); // frames are late, file system and node list maintenance can wait
+  #else
+  const bool housekeeping = true;
+  #endif
+  if (housekeeping) {
+    handlePresetLog();
+    handleFSInfo();
+    #ifdef ESP8266
+    handleTimeWait();
+    #endif
+  }
 
-  if (!realtimeMode || realtimeOverride || (realtimeMode && useMainSegmentOnly))  // block stuff if WARLS/Adalight is enabled
+  if (!realtimeMode || realtimeOverride || (realtimeMode && strip.hasLiveSegments()))  // block stuff if WARLS/Adalight is enabled
   {
     if (apActive) dnsServer.processNextRequest();
     #ifndef WLED_DISABLE_OTA
     if (WLED_CONNECTED && aOtaEnabled) ArduinoOTA.handle();
     #endif
+    RENDER_LOCK();
     handleNightlight();
     handlePlaylist();
     yield();
@@ -183,12 +242,17 @@ void WLED::loop()
 
     yield();
 
-    if (!offMode || strip.isOffRefreshRequired())
+    #ifndef WLED_ENABLE_RENDER_TASK
+    if (!offMode || strip.isOffRefreshRequired()) {
       strip.service();
+    }
 #ifdef ESP8266
-    else if (!noWifiSleep)
+    else if (!noWifiSleep) {
       delay(1); //required to make sure ESP enters modem sleep (see #1184)
+    }
 #endif
+    #endif
+    RENDER_UNLOCK();
   }
   yield();
 #ifdef ESP8266
@@ -202,47 +266,75 @@ void WLED::loop()
     ntpLastSyncTime = 0;
     strip.restartRuntime();
   }
-  if (millis() - lastMqttReconnectAttempt > 30000) {
+  if (housekeeping && millis() - lastMqttReconnectAttempt > 30000) {
     lastMqttReconnectAttempt = millis();
     initMqtt();
     yield();
     // refresh WLED nodes list
     refreshNodeList();
-    if (nodeBroadcastEnabled) sendSysInfoUDP();
+    if (nodeBroadcastEnabled || streamRole == STREAM_ROLE_FOLLOWER) sendSysInfoUDP();
     yield();
   }
 
+  //settings are written outside the render lock and after a delay, so outputs (i.e. the new ones
+  //of a bus re-init) get their frames before the file system blocks
+  if (doSerializeConfig) handleConfigSave();
+
   //LED settings have been saved, re-init busses
-  //This code block causes severe FPS drop on ESP32 with the original "if (busConfigs[0] != nullptr)" conditional. Investigate! 
+  RENDER_LOCK();
   if (doInitBusses) {
     doInitBusses = false;
     DEBUG_PRINTLN(F("Re-init busses."));
     bool aligned = strip.checkSegmentAlignment(); //see if old segments match old bus(ses)
-    busses.removeAll();
-    uint32_t mem = 0;
-    for (uint8_t i = 0; i < WLED_MAX_BUSSES; i++) {
-      if (busConfigs[i] == nullptr) break;
-      mem += BusManager::memUsage(*busConfigs[i]);
-      if (mem <= MAX_LED_MEMORY) {
-        busses.add(*busConfigs[i]);
-      }
-      delete busConfigs[i]; busConfigs[i] = nullptr;
+    if (busses.reconfigure(busConfigs)) { //only recreates the busses that changed
+      strip.finalizeInit();
+      loadLedmap = 0;
+      if (aligned) strip.makeAutoSegments();
+      else strip.fixInvalidSegments();
+    } else {
+      strip.finalizeInit(false); //same pixels, effects keep running
+      strip.fixInvalidSegments(); //bus types may have changed
     }
-    strip.finalizeInit();
-    loadLedmap = 0;
-    if (aligned) strip.makeAutoSegments();
-    else strip.fixInvalidSegments();
-    yield();
+    initE131Universes();
+    if (realtimeMode) initRealtimeMap();
+    invalidateStreamFollowers(); // removed with the other busses
     serializeConfig();
   }
+  handleStreamFollowers();
   if (loadLedmap >= 0) {
-    strip.deserializeMap(loadLedmap);
+    strip.loadMapAsync(loadLedmap);
     loadLedmap = -1;
   }
+  strip.handleMapLoad(); //between frames, swaps in a completed ledmap
+  #ifdef WLED_ENABLE_BENCHMARK
+  handleBenchmark();
+  #endif
+  #ifdef WLED_ENABLE_BAKE
+  handleBake();
+  #endif
+  #ifdef WLED_ENABLE_WARM_RESUME
+  handleResume();
+  #endif
 
   yield();
+  PROFILE_START(wsStart);
   handleWs();
+  handleSse();
+  PROFILE_STAGE(PROF_WS, wsStart);
+  #ifdef WLED_ENABLE_METRICS
+  handleMetrics();
+  #endif
+  #ifdef WLED_ENABLE_LOG
+  handleLog();
+  #endif
+  #ifdef WLED_ENABLE_AUDIO
+  handleAudio();
+  #endif
   handleStatusLED();
+  RENDER_UNLOCK();
+  #ifdef WLED_ENABLE_FLEET_OTA
+  handleFleet(); // may download an image for seconds, the render task keeps running
+  #endif
 
 // DEBUG serial logging (every 30s)
 #ifdef WLED_DEBUG
@@ -276,6 +368,57 @@ void WLED::loop()
   loops++;
 #endif        // WLED_DEBUG
   toki.resetTick();
+  idleSleep();
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+static TaskHandle_t loopTaskHandle = nullptr;
+#endif
+extern bool wsPushPending;
+
+// ends a running idleSleep() early, for state changes made by network callbacks
+void wakeLoop()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  if (loopTaskHandle && xTaskGetCurrentTaskHandle() != loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+  #endif
+}
+
+void IRAM_ATTR wakeLoopFromISR()
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  if (!loopTaskHandle) return;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(loopTaskHandle, &woken);
+  if (woken) portYIELD_FROM_ISR();
+  #endif
+}
+
+// sleeps until the strip, a usermod or a polled input is due, instead of spinning through loop().
+// ESP32 blocks on a task notification, so the idle task can lower power and wakeLoop() ends it early.
+// ESP8266 delay()s, which also lets the modem sleep
+void WLED::idleSleep()
+{
+  #ifndef WLED_DISABLE_IDLE_SLEEP
+  if (realtimeMode || transitionActive || nightlightActive) return;
+  if (interfaceUpdateCallMode || doPublishMqtt || doCloseFile || doReboot || doInitBusses || doSerializeConfig || loadLedmap >= 0 || strip.isMapLoading()) return;
+  #ifdef WLED_ENABLE_PRESET_LOG
+  if (doImportPresets) return;
+  #endif
+  if (wsPushPending || Serial.available()) return;
+  uint32_t idle = WLED_IDLE_MAX_MS;
+  #ifndef WLED_ENABLE_RENDER_TASK
+  if (!offMode || strip.isOffRefreshRequired()) idle = min(idle, strip.getIdleTime());
+  #endif
+  idle = min(idle, usermods.getIdleTime());
+  if (idle < 2) return; // not worth a context switch
+  #ifdef ARDUINO_ARCH_ESP32
+  if (!loopTaskHandle) loopTaskHandle = xTaskGetCurrentTaskHandle();
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(idle));
+  #else
+  delay(idle);
+  #endif
+  #endif
 }
 
 void WLED::setup()
@@ -284,8 +427,17 @@ void WLED::setup()
   WRITE_PERI_REG(RTC_CNTL_BROWN_OUT_REG, 0); //disable brownout detection
   #endif
 
+  #ifdef WLED_ENABLE_ADALIGHT
+  Serial.setRxBufferSize(WLED_SERIAL_RX_BUFFER); //must be set before begin(), holds a full frame at high baud rates
+  #endif
   Serial.begin(115200);
   Serial.setTimeout(50);
+  #ifdef WLED_ENABLE_LOG
+  initLog();
+  #endif
+  #ifdef WLED_ENABLE_RENDER_TASK
+  renderMutex = xSemaphoreCreateRecursiveMutex();
+  #endif
   DEBUG_PRINTLN();
   DEBUG_PRINT(F("---WLED "));
   DEBUG_PRINT(versionString);
@@ -310,6 +462,8 @@ void WLED::setup()
   }
   #endif
 
+  initJSONBufferPool();
+
   //DEBUG_PRINT(F("LEDs inited. heap usage ~"));
   //DEBUG_PRINTLN(heapPreAlloc - ESP.getFreeHeap());
 
@@ -335,9 +489,20 @@ void WLED::setup()
   if (!fsinit) {
     DEBUGFS_PRINTLN(F("FS failed!"));
     errorFlag = ERR_FS_BEGIN;
-  } else deEEP();
+  } else {
+    deEEP();
+    initPresetLog();
+  }
   updateFSInfo();
 
+  //with a boot snapshot (see cfg.cpp) the LEDs come on before cfg.json is parsed
+  bool fastBoot = fsinit && loadBootSnapshot();
+  if (fastBoot) {
+    DEBUG_PRINTLN(F("Initializing strip from boot snapshot"));
+    beginStrip();
+    if (!realtimeMode) strip.service(); // a resumed realtime mode keeps the last frame until new data arrives
+  }
+
   DEBUG_PRINTLN(F("Reading config"));
   deserializeConfigFromFS();
 
@@ -349,8 +514,14 @@ void WLED::setup()
   }
 #endif
 
-  DEBUG_PRINTLN(F("Initializing strip"));
-  beginStrip();
+  if (fastBoot) {
+    initE131Universes(); // E1.31 settings are only known now
+  } else {
+    DEBUG_PRINTLN(F("Initializing strip"));
+    beginStrip();
+  }
+
+  restoreTime(); // before usermods, an RTC usermod knows better
 
   DEBUG_PRINTLN(F("Usermods setup"));
   userSetup();
@@ -366,7 +537,11 @@ void WLED::setup()
   #ifdef WLED_ENABLE_ADALIGHT
   //Serial RX (Adalight, Improv, Serial JSON) only possible if GPIO3 unused
   //Serial TX (Debug, Improv, Serial JSON) only possible if GPIO1 unused
-  if (!pinManager.isPinAllocated(3) && !pinManager.isPinAllocated(1)) {
+  bool serialFree = !pinManager.isPinAllocated(3) && !pinManager.isPinAllocated(1);
+  #ifdef WLED_SERIAL_USB
+  serialFree = true; //native USB is not on GPIO 1/3
+  #endif
+  if (serialFree) {
     Serial.println(F("Ada"));
   }
   #endif
@@ -394,6 +569,9 @@ void WLED::setup()
 #endif
 
   strip.service();
+  #ifdef WLED_ENABLE_RENDER_TASK
+  xTaskCreatePinnedToCore(renderTask, "render", WLED_RENDER_TASK_STACK, nullptr, 1, &renderTaskHandle, WLED_RENDER_TASK_CORE);
+  #endif
 
 #ifndef WLED_DISABLE_OTA
   if (aOtaEnabled) {
@@ -410,6 +588,14 @@ void WLED::setup()
 #ifdef WLED_ENABLE_DMX
   initDMX();
 #endif
+#ifdef WLED_ENABLE_DMX_INPUT
+  initDMXInput();
+#endif
+  e131.setRepeater(repeatRealtimePacket);
+  ddp.setRepeater(repeatRealtimePacket);
+#ifdef WLED_ENABLE_AUDIO
+  initAudio();
+#endif
 
 #ifdef WLED_ENABLE_ADALIGHT
   if (Serial.available() > 0 && Serial.peek() == 'I') handleImprovPacket();
@@ -423,10 +609,38 @@ void WLED::setup()
   #endif
 }
 
+#ifdef WLED_ENABLE_RENDER_TASK
+// replaces strip.service() in loop(). Effect computation overlaps with network handling in loop()
+// and the RMT/I2S transmission of the previous frame, which NeoPixelBus sends from its own buffer
+void WLED::renderTask(void* parameter)
+{
+  #ifdef WLED_ENABLE_FRAME_TIMER
+  strip.startFrameTimer();
+  #endif
+  for (;;) {
+    #ifdef WLED_ENABLE_FRAME_TIMER
+    strip.waitFrameTick(); // loop() and network callbacks take the lock meanwhile
+    #endif
+    RENDER_LOCK();
+    #ifdef WLED_ENABLE_FRAME_TIMER
+    strip.showFrame(); // on the tick, then render the next frame ahead
+    #endif
+    if ((!realtimeMode || realtimeOverride || strip.hasLiveSegments()) && (!offMode || strip.isOffRefreshRequired()))
+      strip.service();
+    RENDER_UNLOCK();
+    #ifndef WLED_ENABLE_FRAME_TIMER
+    vTaskDelay(1); // let loop() and network callbacks take the lock
+    #endif
+  }
+}
+#endif
+
 void WLED::beginStrip()
 {
   // Initialize NeoPixel Strip and button
   strip.finalizeInit(); // busses created during deserializeConfig()
+  strip.loadCustomPalettes(); // before the boot preset may select one
+  initE131Universes();
   strip.deserializeMap();
   strip.makeAutoSegments();
   strip.setBrightness(0);
@@ -438,7 +652,11 @@ void WLED::beginStrip()
   } else {
     briLast = briS; bri = 0;
   }
-  if (bootPreset > 0) {
+  bool resumed = false;
+  #ifdef WLED_ENABLE_WARM_RESUME
+  resumed = restoreResumeState(); // after a warm reboot the LEDs go on with the state before it
+  #endif
+  if (bootPreset > 0 && !resumed) {
     applyPreset(bootPreset, CALL_MODE_INIT);
   }
   colorUpdated(CALL_MODE_INIT);
@@ -467,15 +685,15 @@ void WLED::initAP(bool resetAP)
     DEBUG_PRINTLN(F("Init AP interfaces"));
     server.begin();
     if (udpPort > 0 && udpPort != ntpLocalPort) {
-      udpConnected = notifierUdp.begin(udpPort);
+      udpConnected = beginUdpSocket(UDP_SOCKET_NOTIFIER, udpPort);
     }
     if (udpRgbPort > 0 && udpRgbPort != ntpLocalPort && udpRgbPort != udpPort) {
-      udpRgbConnected = rgbUdp.begin(udpRgbPort);
+      udpRgbConnected = beginUdpSocket(UDP_SOCKET_RGB, udpRgbPort);
     }
     if (udpPort2 > 0 && udpPort2 != ntpLocalPort && udpPort2 != udpPort && udpPort2 != udpRgbPort) {
-      udp2Connected = notifier2Udp.begin(udpPort2);
+      udp2Connected = beginUdpSocket(UDP_SOCKET_NOTIFIER2, udpPort2);
     }
-    e131.begin(false, e131Port, e131Universe, E131_MAX_UNIVERSE_COUNT);
+    e131.begin(false, e131Port, e131Universe, MIN(e131UniverseCount, E131_MAX_UNIVERSE_COUNT));
     ddp.begin(false, DDP_DEFAULT_PORT);
 
     dnsServer.setErrorReplyCode(DNSReplyCode::NoError);
@@ -617,6 +835,9 @@ void WLED::initConnection()
   WiFi.hostname(hostname);
 #endif
 
+#ifdef WLED_ENABLE_FAST_RECONNECT
+  if (!wifiFastBegin())
+#endif
   WiFi.begin(clientSSID, clientPass);
 
 #ifdef ARDUINO_ARCH_ESP32
@@ -666,19 +887,22 @@ void WLED::initInterfaces()
   server.begin();
 
   if (udpPort > 0 && udpPort != ntpLocalPort) {
-    udpConnected = notifierUdp.begin(udpPort);
+    udpConnected = beginUdpSocket(UDP_SOCKET_NOTIFIER, udpPort);
     if (udpConnected && udpRgbPort != udpPort)
-      udpRgbConnected = rgbUdp.begin(udpRgbPort);
+      udpRgbConnected = beginUdpSocket(UDP_SOCKET_RGB, udpRgbPort);
     if (udpConnected && udpPort2 != udpPort && udpPort2 != udpRgbPort)
-      udp2Connected = notifier2Udp.begin(udpPort2);
+      udp2Connected = beginUdpSocket(UDP_SOCKET_NOTIFIER2, udpPort2);
   }
   if (ntpEnabled)
     ntpConnected = ntpUdp.begin(ntpLocalPort);
+#ifdef WLED_ENABLE_ESPNOW
+  espNowBegin();
+#endif
 
 #ifndef WLED_DISABLE_BLYNK
   initBlynk(blynkApiKey, blynkHost, blynkPort);
 #endif
-  e131.begin(e131Multicast, e131Port, e131Universe, E131_MAX_UNIVERSE_COUNT);
+  e131.begin(e131Multicast, e131Port, e131Universe, MIN(e131UniverseCount, E131_MAX_UNIVERSE_COUNT));
   ddp.begin(false, DDP_DEFAULT_PORT);
   reconnectHue();
   initMqtt();
@@ -744,9 +968,14 @@ void WLED::handleConnection()
   if (!Network.isConnected()) {
     if (interfacesInited) {
       DEBUG_PRINTLN(F("Disconnected!"));
+      LOG_W("Network disconnected");
       interfacesInited = false;
+      usermods.publish(UM_EVENT_DISCONNECTED);
       initConnection();
     }
+    #ifdef WLED_ENABLE_FAST_RECONNECT
+    if (wifiFastFailed(now - lastReconnectAttempt)) initConnection(); // directed attempt failed, scan
+    #endif
     //send improv failed 6 seconds after second init attempt (24 sec. after provisioning)
     if (improvActive > 2 && now - lastReconnectAttempt > 6000) {
       sendImprovStateResponse(0x03, true);
@@ -762,6 +991,10 @@ void WLED::handleConnection()
     DEBUG_PRINTLN("");
     DEBUG_PRINT(F("Connected! IP address: "));
     DEBUG_PRINTLN(Network.localIP());
+    LOG_I("Connected, IP %u.%u.%u.%u", Network.localIP()[0], Network.localIP()[1], Network.localIP()[2], Network.localIP()[3]);
+    #ifdef WLED_ENABLE_FAST_RECONNECT
+    if (!Network.isEthernet()) wifiFastConnected();
+    #endif
     if (improvActive) {
       if (improvError == 3) sendImprovStateResponse(0x00, true);
       sendImprovStateResponse(0x04);
@@ -770,6 +1003,7 @@ void WLED::handleConnection()
     initInterfaces();
     userConnected();
     usermods.connected();
+    usermods.publish(UM_EVENT_CONNECTED);
 
     // shut down AP
     if (apBehavior != AP_BEHAVIOR_ALWAYS && apActive) {
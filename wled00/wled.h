@@ -33,13 +33,55 @@
 #endif
 #define WLED_ENABLE_ADALIGHT     // saves 500b only (uses GPIO3 (RX) for serial)
 //#define WLED_ENABLE_DMX          // uses 3.5kb (use LEDPIN other than 2)
+//#define WLED_ENABLE_DMX_INPUT    // ESP32 only: wired DMX512 receiver on WLED_DMX_INPUT_PIN, fed into the E1.31 DMX mode handling
+//#define WLED_ENABLE_AUDIO        // ESP32 only: I2S microphone analysis on the second core for sound reactive effects and usermods, see audio.h (~8kB RAM)
 //#define WLED_ENABLE_JSONLIVE     // peek LED output via /json/live (WS binary peek is always enabled)
+//#define WLED_ENABLE_RENDER_TASK  // ESP32 only: compute effects and send LED data in a separate task pinned to WLED_RENDER_TASK_CORE
+//#define WLED_ENABLE_FRAME_TIMER  // ESP32 only: a hardware timer paces the render task at the target FPS, frames are rendered ahead and sent on the tick (requires WLED_ENABLE_RENDER_TASK)
+//#define WLED_ENABLE_UDP_RX_TASK  // ESP32 only: receive sync, UDP realtime and Hyperion packets as they arrive (AsyncUDP) instead of polling the sockets once per loop
+//#define WLED_ENABLE_PARALLEL_RENDER // ESP32 only: render segments on both cores (requires WLED_USE_SEGMENT_BUFFERS)
+//#define WLED_ENABLE_PROFILER     // effect and main loop stage timing histograms via /json/perf (uses ~4kb RAM)
+//#define WLED_ENABLE_BENCHMARK    // run effects on device via /json/bench and report time per frame and heap use
+//#define WLED_ENABLE_BAKE         // render the main segment's effect into a file for the Playback effect via /json/bake
+//#define WLED_ENABLE_METRICS      // push counters (FPS, frame times, heap, RSSI, realtime rates, current, usermods) as StatsD or Influx lines over UDP
+//#define WLED_ENABLE_LOG          // leveled log in a RAM ring buffer, drained to Serial and / or syslog (UDP), viewable via /json/log, see log.h (6kB RAM)
+//#define WLED_ENABLE_TRACE        // record timed events in a ring buffer, downloadable as Chrome trace via /json/trace (12kB RAM while in use)
+//#define WLED_ENABLE_ADAPTIVE_QUALITY // lower segment update rates and defer housekeeping while frames are late, see FX.h
+//#define WLED_ENABLE_JITTER_BUFFER // present network realtime frames at a steady rate (4 bytes per LED per buffered frame while live)
+//#define WLED_ENABLE_RT_INTERPOLATION // blend between network realtime frames at the local frame rate (12 bytes per LED while live)
+#if defined(WLED_ENABLE_RT_INTERPOLATION) && defined(WLED_ENABLE_JITTER_BUFFER)
+  #undef WLED_ENABLE_RT_INTERPOLATION      // both capture the incoming frames, the jitter buffer takes precedence
+#endif
+//#define WLED_ENABLE_ESPNOW       // send and receive sync notifications over ESP-NOW too, node to node without the access point
+//#define WLED_ENABLE_FLEET_OTA    // nodes update each other from the node list, see fleet.cpp (requires OTA)
+#if defined(WLED_ENABLE_FLEET_OTA) && defined(WLED_DISABLE_OTA)
+  #undef WLED_ENABLE_FLEET_OTA
+#endif
+#if defined(WLED_ENABLE_AUDIO) && !defined(ARDUINO_ARCH_ESP32)
+  #undef WLED_ENABLE_AUDIO
+#endif
+//#define WLED_ENABLE_PRESET_LOG   // store presets as an append only log with background compaction instead of patching presets.json in place
+//#define WLED_USE_RMT_SINGLE_BUFFER // ESP32: RMT busses send from the pixel buffer, halves their memory (drawing waits for the last frame to be sent)
+//#define WLED_DISABLE_NET_OUTPUT_TASK // ESP32: send network busses from show() instead of a background task (saves 3 bytes per LED and 4kb stack)
+//#define WLED_PIXEL_INDEX_32      // ESP32: 32 bit strip pixel indices for more than 65535 LEDs in total (PSRAM), segments and busses stay below 65536 each
 #ifndef WLED_DISABLE_LOXONE
   #define WLED_ENABLE_LOXONE       // uses 1.2kb
 #endif
 #ifndef WLED_DISABLE_WEBSOCKETS
   #define WLED_ENABLE_WEBSOCKETS
 #endif
+#ifndef WLED_DISABLE_SSE
+  #define WLED_ENABLE_SSE          // state change events at /events
+#endif
+#ifndef WLED_DISABLE_BOOT_SNAPSHOT
+  #define WLED_ENABLE_BOOT_SNAPSHOT // start the LEDs from /boot.bin before cfg.json is parsed
+#endif
+#ifndef WLED_DISABLE_WARM_RESUME
+  #define WLED_ENABLE_WARM_RESUME  // keep the live state in RTC memory and go on with it after OTA, crash or watchdog resets
+#endif
+#ifndef WLED_DISABLE_FAST_RECONNECT
+  #define WLED_ENABLE_FAST_RECONNECT // connect to the last access point (/wifi.bin) without scanning
+#endif
 
 #define WLED_ENABLE_FS_EDITOR      // enable /edit page for editing FS content. Will also be disabled with OTA lock
 
@@ -82,6 +124,36 @@
 
 #include "src/dependencies/network/Network.h"
 
+#if defined(WLED_ENABLE_UDP_RX_TASK) && defined(ESP8266)
+  #undef WLED_ENABLE_UDP_RX_TASK
+#endif
+
+#ifdef WLED_ENABLE_RENDER_TASK
+  #ifdef ESP8266
+    #undef WLED_ENABLE_RENDER_TASK
+  #else
+    #ifndef WLED_RENDER_TASK_CORE
+      #define WLED_RENDER_TASK_CORE 0 //loop() runs on core 1
+    #endif
+    #ifndef WLED_RENDER_TASK_STACK
+      #define WLED_RENDER_TASK_STACK 8192
+    #endif
+  #endif
+#endif
+#if defined(WLED_ENABLE_FRAME_TIMER) && !defined(WLED_ENABLE_RENDER_TASK)
+  #undef WLED_ENABLE_FRAME_TIMER
+#endif
+
+#ifdef ARDUINO_ARCH_ESP32
+  #define WLED_USERMOD_TASK // usermod tasks run on a worker task instead of in steps from loop()
+  #ifndef WLED_USERMOD_TASK_CORE
+    #define WLED_USERMOD_TASK_CORE 0
+  #endif
+  #ifndef WLED_USERMOD_TASK_STACK
+    #define WLED_USERMOD_TASK_STACK 4096
+  #endif
+#endif
+
 #ifdef WLED_USE_MY_CONFIG
   #include "my_config.h"
 #endif
@@ -106,9 +178,6 @@
   // #define ESPALEXA_DEBUG
   #include "src/dependencies/espalexa/Espalexa.h"
 #endif
-#ifndef WLED_DISABLE_BLYNK
-  #include "src/dependencies/blynk/BlynkSimpleEsp.h"
-#endif
 
 #ifdef WLED_ENABLE_DMX
  #ifdef ESP8266
@@ -125,6 +194,8 @@
 #include "src/dependencies/json/AsyncJson-v6.h"
 #include "src/dependencies/json/ArduinoJson-v6.h"
 
+#include "wled_alloc.h"
+
 // ESP32-WROVER features SPI RAM (aka PSRAM) which can be allocated using ps_malloc()
 // we can create custom PSRAMDynamicJsonDocument to use such feature (replacing DynamicJsonDocument)
 // The following is a construct to enable code to compile without it.
@@ -133,8 +204,9 @@
 #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
 struct PSRAM_Allocator {
   void* allocate(size_t size) {
-    if (psramFound()) return ps_malloc(size); // use PSRAM if it exists
-    else              return malloc(size);    // fallback
+    void* p = wledAlloc(size, ALLOC_COLD); // PSRAM if it exists
+    if (!p) memAllocFailed(MEM_JSON);
+    return p;
   }
   void deallocate(void* pointer) {
     free(pointer);
@@ -145,6 +217,7 @@ using PSRAMDynamicJsonDocument = BasicJsonDocument<PSRAM_Allocator>;
 #define PSRAMDynamicJsonDocument DynamicJsonDocument
 #endif
 
+#include "gzip_stream.h"
 #include "fcn_declare.h"
 #include "html_ui.h"
 #include "html_settings.h"
@@ -155,6 +228,10 @@ using PSRAMDynamicJsonDocument = BasicJsonDocument<PSRAM_Allocator>;
 #include "NodeStruct.h"
 #include "pin_manager.h"
 #include "bus_manager.h"
+#include "profiler.h"
+#include "trace.h"
+#include "log.h"
+#include "audio.h"
 
 #ifndef CLIENT_SSID
   #define CLIENT_SSID DEFAULT_CLIENT_SSID
@@ -259,6 +336,9 @@ WLED_GLOBAL byte apBehavior _INIT(AP_BEHAVIOR_BOOT_NO_CONN);       // access poi
 WLED_GLOBAL IPAddress staticIP      _INIT_N(((  0,   0,  0,  0))); // static IP of ESP
 WLED_GLOBAL IPAddress staticGateway _INIT_N(((  0,   0,  0,  0))); // gateway (router) IP
 WLED_GLOBAL IPAddress staticSubnet  _INIT_N(((255, 255, 255, 0))); // most common subnet in home networks
+#ifdef WLED_ENABLE_FAST_RECONNECT
+WLED_GLOBAL bool wifiFastIP _INIT(false);                          // reuse the last DHCP lease when connecting (needs an address reserved on the router)
+#endif
 #ifdef ARDUINO_ARCH_ESP32
 WLED_GLOBAL bool noWifiSleep _INIT(true);                          // disabling modem sleep modes will increase heat output and power usage, but may help with connection issues
 #else
@@ -305,9 +385,27 @@ WLED_GLOBAL char serverDescription[33] _INIT(SERVERNAME);  // use predefined nam
 WLED_GLOBAL bool syncToggleReceive     _INIT(false);   // UIs which only have a single button for sync should toggle send+receive if this is true, only send otherwise
 
 // Sync CONFIG
-WLED_GLOBAL NodesMap Nodes;
+WLED_GLOBAL NodeTable Nodes _INIT_N(((WLED_MAX_NODES)));
 WLED_GLOBAL bool nodeListEnabled _INIT(true);
 WLED_GLOBAL bool nodeBroadcastEnabled _INIT(true);
+WLED_GLOBAL byte streamRole _INIT(STREAM_ROLE_NONE);   // pixel streaming between nodes, STREAM_ROLE_...
+WLED_GLOBAL byte streamOrder _INIT(0);                 // follower: position in the master's virtual strip (lowest first)
+#ifdef WLED_ENABLE_METRICS
+WLED_GLOBAL byte metricsFormat _INIT(METRICS_OFF);     // METRICS_...
+WLED_GLOBAL IPAddress metricsIP _INIT_N(((0, 0, 0, 0)));
+WLED_GLOBAL uint16_t metricsPort _INIT(8125);
+WLED_GLOBAL uint16_t metricsInterval _INIT(10);        // s
+#endif
+#ifdef WLED_ENABLE_LOG
+WLED_GLOBAL bool logSerial _INIT(false);               // log lines to Serial (verbosity: logger.level)
+WLED_GLOBAL IPAddress logSyslogIP _INIT_N(((0, 0, 0, 0))); // syslog server, 0.0.0.0: none
+WLED_GLOBAL uint16_t logSyslogPort _INIT(514);
+#endif
+#ifdef WLED_ENABLE_AUDIO
+WLED_GLOBAL byte audioSyncMode _INIT(AUDIO_SYNC_OFF);  // AUDIO_SYNC_...
+WLED_GLOBAL uint16_t audioSyncPort _INIT(11988);
+WLED_GLOBAL byte audioSquelch _INIT(64);               // levels below are silence, in 1/16 of a doubling of the band magnitude
+#endif
 
 WLED_GLOBAL byte buttonType[WLED_MAX_BUTTONS]  _INIT({BTN_TYPE_PUSH});
 #if defined(IRTYPE) && defined(IRPIN)
@@ -328,12 +426,17 @@ WLED_GLOBAL bool receiveNotificationColor      _INIT(true);       // apply color
 WLED_GLOBAL bool receiveNotificationEffects    _INIT(true);       // apply effects setup
 WLED_GLOBAL bool receiveSegmentOptions         _INIT(false);      // apply segment options
 WLED_GLOBAL bool receiveSegmentBounds          _INIT(false);      // apply segment bounds (start, stop, offset)
+WLED_GLOBAL bool syncClock                     _INIT(true);       // measure and follow the effect clock of the node sending effects
 WLED_GLOBAL bool notifyDirect _INIT(false);                       // send notification if change via UI or HTTP API
 WLED_GLOBAL bool notifyButton _INIT(false);                       // send if updated by button or infrared remote
 WLED_GLOBAL bool notifyAlexa  _INIT(false);                       // send notification if updated via Alexa
 WLED_GLOBAL bool notifyMacro  _INIT(false);                       // send notification for macro
 WLED_GLOBAL bool notifyHue    _INIT(true);                        // send notification if Hue light changes
 WLED_GLOBAL bool notifyTwice  _INIT(false);                       // notifications use UDP: enable if devices don't sync reliably
+WLED_GLOBAL uint16_t notifyCoalesceMs _INIT(40);                  // changes within this time of the last notification are sent together, 0 to send each one
+#ifdef WLED_ENABLE_ESPNOW
+WLED_GLOBAL bool espNowSync _INIT(false);                         // notifications also over ESP-NOW (all nodes on the channel of the access point)
+#endif
 
 WLED_GLOBAL bool alexaEnabled _INIT(false);                       // enable device discovery by Amazon Echo
 WLED_GLOBAL char alexaInvocationName[33] _INIT("Light");          // speech control name of device. Choose something voice-to-text can understand
@@ -363,9 +466,10 @@ WLED_GLOBAL uint16_t e131Port _INIT(5568);                        // DMX in port
 WLED_GLOBAL byte DMXMode _INIT(DMX_MODE_MULTIPLE_RGB);            // DMX mode (s.a.)
 WLED_GLOBAL uint16_t DMXAddress _INIT(1);                         // DMX start address of fixture, a.k.a. first Channel [for E1.31 (sACN) protocol]
 WLED_GLOBAL byte DMXOldDimmer _INIT(0);                           // only update brightness on change
-WLED_GLOBAL byte e131LastSequenceNumber[E131_MAX_UNIVERSE_COUNT]; // to detect packet loss
+WLED_GLOBAL uint8_t e131UniverseCount _INIT(1);                   // universes received, sized from LED count and DMX mode (initE131Universes())
 WLED_GLOBAL bool e131Multicast _INIT(false);                      // multicast or unicast
 WLED_GLOBAL bool e131SkipOutOfSequence _INIT(false);              // freeze instead of flickering
+WLED_GLOBAL bool e131UsePriority _INIT(false);                    // arbitrate E1.31 sources by the priority in their packets
 
 WLED_GLOBAL bool mqttEnabled _INIT(false);
 WLED_GLOBAL char mqttDeviceTopic[33] _INIT("");            // main MQTT topic (individual per device, default is wled/mac)
@@ -375,6 +479,7 @@ WLED_GLOBAL char mqttUser[41] _INIT("");                   // optional: username
 WLED_GLOBAL char mqttPass[65] _INIT("");                   // optional: password for MQTT auth
 WLED_GLOBAL char mqttClientID[41] _INIT("");               // override the client ID
 WLED_GLOBAL uint16_t mqttPort _INIT(1883);
+WLED_GLOBAL bool mqttStateJson _INIT(false);               // publish the compact JSON state to <device topic>/state instead of XML to /v
 
 #ifndef WLED_DISABLE_HUESYNC
 WLED_GLOBAL bool huePollingEnabled _INIT(false);           // poll hue bridge for light state
@@ -418,6 +523,9 @@ WLED_GLOBAL byte macroDoublePress[WLED_MAX_BUTTONS]   _INIT({0});
 WLED_GLOBAL bool otaLock     _INIT(false);  // prevents OTA firmware updates without password. ALWAYS enable if system exposed to any public networks
 WLED_GLOBAL bool wifiLock    _INIT(false);  // prevents access to WiFi settings when OTA lock is enabled
 WLED_GLOBAL bool aOtaEnabled _INIT(true);   // ArduinoOTA allows easy updates directly from the IDE. Careful, it does not auto-disable when OTA lock is on
+#ifdef WLED_ENABLE_FLEET_OTA
+WLED_GLOBAL bool fleetOTA    _INIT(false);  // pull newer firmware from peers during a rollout (never while OTA is locked)
+#endif
 
 WLED_GLOBAL uint16_t userVar0 _INIT(0), userVar1 _INIT(0); //available for use in usermod
 
@@ -447,7 +555,7 @@ WLED_GLOBAL bool transitionActive _INIT(false);
 WLED_GLOBAL uint16_t transitionDelayDefault _INIT(transitionDelay);
 WLED_GLOBAL uint16_t transitionDelayTemp _INIT(transitionDelay);
 WLED_GLOBAL unsigned long transitionStartTime;
-WLED_GLOBAL float tperLast _INIT(0);        // crossfade transition progress, 0.0f - 1.0f
+WLED_GLOBAL uint16_t transitionProgress _INIT(0); // crossfade transition progress last applied, 0 - 65535
 WLED_GLOBAL bool jsonTransitionOnce _INIT(false);
 
 // nightlight
@@ -490,6 +598,7 @@ WLED_GLOBAL byte effectSpeed _INIT(128);
 WLED_GLOBAL byte effectIntensity _INIT(128);
 WLED_GLOBAL byte effectPalette _INIT(0);
 WLED_GLOBAL bool stateChanged _INIT(false);
+WLED_GLOBAL uint32_t stateChangeCount _INIT(1); // bumped by stateUpdated(), X-State-Version of /json/state for polling with ?since=
 
 // network
 WLED_GLOBAL bool udpConnected _INIT(false), udp2Connected _INIT(false), udpRgbConnected _INIT(false);
@@ -500,7 +609,7 @@ WLED_GLOBAL bool showWelcomePage _INIT(false);
 // hue
 WLED_GLOBAL byte hueError _INIT(HUE_ERROR_INACTIVE);
 // WLED_GLOBAL uint16_t hueFailCount _INIT(0);
-WLED_GLOBAL float hueXLast _INIT(0), hueYLast _INIT(0);
+WLED_GLOBAL uint16_t hueXLast _INIT(0), hueYLast _INIT(0); // 1/10000
 WLED_GLOBAL uint16_t hueHueLast _INIT(0), hueCtLast _INIT(0);
 WLED_GLOBAL byte hueSatLast _INIT(0), hueBriLast _INIT(0);
 WLED_GLOBAL unsigned long hueLastRequestSent _INIT(0);
@@ -546,6 +655,51 @@ WLED_GLOBAL unsigned long realtimeTimeout _INIT(0);
 WLED_GLOBAL uint8_t tpmPacketCount _INIT(0);
 WLED_GLOBAL uint16_t tpmPayloadFrameSize _INIT(0);
 WLED_GLOBAL bool useMainSegmentOnly _INIT(false);
+// priority of each realtime mode (index) when two sources send at once, the higher one takes over, equal ones keep the first
+WLED_GLOBAL byte realtimePriority[REALTIME_MODE_COUNT] _INIT_N(({ 0, 0, 100, 100, 100, 100, 100, 100, 100, 100 }));
+// realtime mapping: stream pixels [start, start+len) are scaled onto LEDs [dst, dst+dstLen), none means 1:1 from arlsOffset
+typedef struct RealtimeRegion {
+  uint16_t start;   // first stream pixel
+  uint16_t len;     // stream pixels
+  uint16_t dst;     // first LED, or segment ID if seg is set
+  uint16_t dstLen;  // LEDs, 0 for len (or the segment length)
+  bool     rev;     // mirrored
+  bool     seg;     // dst is a segment, mapped onto its current bounds
+} realtime_region;
+WLED_GLOBAL realtime_region realtimeRegions[WLED_MAX_REALTIME_REGIONS];
+WLED_GLOBAL byte realtimeRegionCount _INIT(0);
+WLED_GLOBAL bool netOutSync _INIT(false);          // network busses follow each E1.31 / Art-Net frame by a sync packet
+// repeater: received universes and DDP ranges are sent on to other nodes as they arrive, see repeatRealtimePacket()
+typedef struct RepeatTarget {
+  IPAddress ip;
+  uint16_t  uni;      // first E1.31 / Art-Net universe sent on
+  uint16_t  uniCount; // universes, 0: none
+  int16_t   uniShift; // added to the universe of the packets sent
+  uint32_t  ddpStart; // first DDP channel sent on
+  uint32_t  ddpLen;   // DDP channels, 0: none
+  int32_t   ddpShift; // added to the channel offset of the DDP packets sent
+} repeat_target;
+WLED_GLOBAL repeat_target repeatTargets[WLED_MAX_REPEAT_TARGETS];
+WLED_GLOBAL byte repeatTargetCount _INIT(0);
+WLED_GLOBAL bool repeaterLocal _INIT(true);        // repeated packets are shown locally as well
+WLED_GLOBAL uint32_t realtimeLoopAvg _INIT(0); // us between realtime source polls (smoothed) while streaming
+WLED_GLOBAL uint32_t realtimeLoopMax _INIT(0); // longest since last read by /json/info
+// realtime ingest counters since boot, reported in /json/info "rts" (see tools/rt_load.py)
+typedef struct RealtimeStats {
+  uint32_t rx;      // realtime packets received (E1.31, Art-Net, DDP, UDP realtime, TPM2.NET, Hyperion)
+  uint32_t seq;     // rejected as out of sequence
+  uint32_t drop;    // frames replaced by the next one before they were shown, or discarded by the jitter buffer
+  uint32_t push;    // complete frames
+  uint32_t fwd;     // packets sent on by the repeater
+  uint16_t procAvg; // us to process a packet (smoothed)
+  uint16_t procMax; // longest since last read by /json/info
+} realtime_stats;
+WLED_GLOBAL realtime_stats rtStats;
+#ifdef WLED_ENABLE_JITTER_BUFFER
+WLED_GLOBAL uint8_t  jbQueueDepth _INIT(0);    // realtime frames waiting to be shown
+WLED_GLOBAL uint32_t jbLateFrames _INIT(0);    // times the buffer ran empty when a frame was due
+WLED_GLOBAL uint32_t jbDroppedFrames _INIT(0); // frames discarded because the buffer was full
+#endif
 
 // mqtt
 WLED_GLOBAL unsigned long lastMqttReconnectAttempt _INIT(0);
@@ -585,11 +739,16 @@ WLED_GLOBAL uint16_t olen _INIT(0);
 WLED_GLOBAL size_t fsBytesUsed _INIT(0);
 WLED_GLOBAL size_t fsBytesTotal _INIT(0);
 WLED_GLOBAL unsigned long presetsModifiedTime _INIT(0L);
+WLED_GLOBAL uint16_t configVersion _INIT(0);   // bumped when the configuration is written, invalidates cached info and settings JS
 WLED_GLOBAL JsonDocument* fileDoc;
 WLED_GLOBAL bool doCloseFile _INIT(false);
+#ifdef WLED_ENABLE_PRESET_LOG
+WLED_GLOBAL bool doImportPresets _INIT(false); // presets.json was uploaded, import it into the preset log
+#endif
 
 // presets
 WLED_GLOBAL byte currentPreset _INIT(0);
+WLED_GLOBAL byte presetBank _INIT(0);      // active preset bank, the one presets are saved to and /presets.json serves
 
 WLED_GLOBAL byte errorFlag _INIT(0);
 
@@ -604,6 +763,9 @@ WLED_GLOBAL AsyncWebServer server _INIT_N(((80)));
 #ifdef WLED_ENABLE_WEBSOCKETS
 WLED_GLOBAL AsyncWebSocket ws _INIT_N((("/ws")));
 #endif
+#ifdef WLED_ENABLE_SSE
+WLED_GLOBAL AsyncEventSource sse _INIT_N((("/events")));
+#endif
 WLED_GLOBAL AsyncClient* hueClient _INIT(NULL);
 WLED_GLOBAL AsyncMqttClient* mqtt _INIT(NULL);
 
@@ -617,8 +779,20 @@ WLED_GLOBAL bool e131NewData _INIT(false);
 // led fx library object
 WLED_GLOBAL BusManager busses _INIT(BusManager());
 WLED_GLOBAL WS2812FX strip _INIT(WS2812FX());
+
+#ifdef WLED_ENABLE_RENDER_TASK
+// held by the render task while a frame is computed and sent, take it before modifying segments or busses
+WLED_GLOBAL SemaphoreHandle_t renderMutex _INIT(nullptr);
+WLED_GLOBAL TaskHandle_t renderTaskHandle _INIT(nullptr);
+#define RENDER_LOCK()   do { if (renderMutex) xSemaphoreTakeRecursive(renderMutex, portMAX_DELAY); } while (0)
+#define RENDER_UNLOCK() do { if (renderMutex) xSemaphoreGiveRecursive(renderMutex); } while (0)
+#else
+#define RENDER_LOCK()
+#define RENDER_UNLOCK()
+#endif
 WLED_GLOBAL BusConfig* busConfigs[WLED_MAX_BUSSES] _INIT({nullptr}); //temporary, to remember values from network callback until after
 WLED_GLOBAL bool doInitBusses _INIT(false);
+WLED_GLOBAL bool doSerializeConfig _INIT(false); // settings waiting for handleConfigSave()
 WLED_GLOBAL int8_t loadLedmap _INIT(-1);
 
 // Usermod manager
@@ -629,6 +803,8 @@ WLED_GLOBAL UsermodManager usermods _INIT(UsermodManager());
 WLED_GLOBAL StaticJsonDocument<JSON_BUFFER_SIZE> doc;
 #endif
 WLED_GLOBAL volatile uint8_t jsonBufferLock _INIT(0);
+WLED_GLOBAL uint16_t jsonBufferContention[WLED_JSON_LOCK_MODULES] _INIT({0}); // times a module found no free JSON buffer
+WLED_GLOBAL uint16_t memAllocFailures[MEM_SUBSYSTEMS] _INIT({0}); // allocations failed or refused per subsystem, see wled_alloc.h
 
 // enable additional debug output
 #ifdef WLED_DEBUG
@@ -695,6 +871,7 @@ public:
   void setup();
 
   void loop();
+  bool realtimeLoop();
   void reset();
 
   void beginStrip();
@@ -704,5 +881,9 @@ public:
   void initConnection();
   void initInterfaces();
   void handleStatusLED();
+  void idleSleep();
+  #ifdef WLED_ENABLE_RENDER_TASK
+  static void renderTask(void* parameter);
+  #endif
 };
 #endif        // WLED_H
@@ -0,0 +1,97 @@
+#ifndef WLED_ALLOC_H
+#define WLED_ALLOC_H
+
+/*
+ * Allocation policy for large buffers.
+ * On ESP32 boards with PSRAM (WLED_USE_PSRAM) cold buffers, which are large or not touched on every pixel
+ * (ledmaps, effect data, JSON documents, the preset cache, network bus data), are placed in PSRAM.
+ * Hot buffers (segment render buffers and maps read for every pixel, anything handed to DMA) stay in
+ * internal RAM. Without PSRAM both use the regular heap. Release with free().
+ * Large buffers of the subsystems below are admitted against the largest free block, failures are
+ * counted per subsystem, so running out of memory shows in /json/info instead of failing silently.
+ */
+
+#include <Arduino.h>
+#ifdef ARDUINO_ARCH_ESP32
+  #include <esp_heap_caps.h>
+#endif
+
+#define ALLOC_HOT  0
+#define ALLOC_COLD 1
+
+// subsystems for memory accounting, reported in /json/info "mem"
+#define MEM_BUSSES     0
+#define MEM_SEGMENTS   1 // effect data, render buffers and segment maps
+#define MEM_LEDMAP     2
+#define MEM_JSON       3
+#define MEM_WS         4
+#define MEM_USERMODS   5
+#define MEM_SUBSYSTEMS 6
+
+// internal heap that must stay free when a large buffer is admitted (WiFi, TCP and the web server need it)
+#ifndef WLED_HEAP_RESERVE
+  #define WLED_HEAP_RESERVE 6144
+#endif
+
+void memAllocFailed(uint8_t subsystem); // counts an allocation that failed or was refused, see util.cpp
+
+inline bool hasPSRAM()
+{
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  return psramFound();
+  #else
+  return false;
+  #endif
+}
+
+inline void* wledAlloc(size_t size, uint8_t allocClass)
+{
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  if (psramFound()) {
+    // with CONFIG_SPIRAM_USE_MALLOC plain malloc() may return PSRAM for large blocks, so hot buffers ask for internal RAM
+    void* p = heap_caps_malloc(size, (allocClass == ALLOC_COLD ? MALLOC_CAP_SPIRAM : MALLOC_CAP_INTERNAL) | MALLOC_CAP_8BIT);
+    if (p) return p;
+  }
+  #endif
+  return malloc(size);
+}
+
+//largest block that can be allocated in one piece for the given class
+inline uint32_t maxAllocatable(uint8_t allocClass)
+{
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  if (allocClass == ALLOC_COLD && psramFound()) return heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  #endif
+  #ifdef ESP8266
+  return ESP.getMaxFreeBlockSize();
+  #else
+  return heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  #endif
+}
+
+//true if size bytes fit in one block while leaving the heap reserve, count a refusal otherwise
+inline bool memAdmit(uint32_t size, uint8_t allocClass, uint8_t subsystem)
+{
+  uint32_t avail = maxAllocatable(allocClass);
+  uint32_t reserve = (allocClass == ALLOC_COLD && hasPSRAM()) ? 0 : WLED_HEAP_RESERVE;
+  if (size + reserve <= avail) return true;
+  memAllocFailed(subsystem);
+  return false;
+}
+
+/*
+ * A memory limit sized for internal RAM, raised to 1/share of the free PSRAM on boards that have it.
+ * Meant to be evaluated once at boot.
+ */
+inline uint32_t scaledMemoryLimit(uint32_t internalLimit, uint8_t share)
+{
+  #if defined(ARDUINO_ARCH_ESP32) && defined(WLED_USE_PSRAM)
+  if (psramFound()) {
+    uint32_t limit = ESP.getFreePsram() / share;
+    if (limit > internalLimit) return limit;
+  }
+  #endif
+  return internalLimit;
+}
+
+#endif
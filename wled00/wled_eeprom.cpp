@@ -371,11 +371,14 @@ void applyMacro(byte index) {
 // De-EEPROM routine, upgrade from previous versions to v0.11
 void deEEP() {
   if (WLED_FS.exists("/presets.json")) return;
+  #ifdef WLED_ENABLE_PRESET_LOG
+  if (WLED_FS.exists("/presets.log")) return;
+  #endif
   
   DEBUG_PRINTLN(F("Preset file not found, attempting to load from EEPROM"));
   DEBUGFS_PRINTLN(F("Allocating saving buffer for dEEP"));
   #ifdef WLED_USE_DYNAMIC_JSON
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+  PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
   #else
   if (!requestJSONBufferLock(8)) return;
   #endif
@@ -459,6 +462,7 @@ void deEEP() {
   }
   serializeJson(doc, f);
   f.close();
+  fsCacheDrop("/presets.json");
 
   releaseJSONBufferLock();
 
@@ -11,44 +11,116 @@ enum class AdaState {
   Header_CountHi,
   Header_CountLo,
   Header_CountCheck,
-  Data_Red,
-  Data_Green,
-  Data_Blue,
+  Data,
   TPM2_Header_Type,
   TPM2_Header_CountHi,
   TPM2_Header_CountLo,
 };
 
+#ifdef WLED_SERIAL_USB
+  #define ADA_BLOCK_PIXELS 256 //pixels copied from the USB CDC buffer per block
+#else
+  #define ADA_BLOCK_PIXELS 64 //pixels copied from the UART buffer per block
+#endif
+
 uint16_t currentBaud = 1152; //default baudrate 115200 (divided by 100)
 
+//native USB: nothing to send on, GPIO 1 and 3 are not the serial port
+static inline bool serialTxFree()
+{
+  #ifdef WLED_SERIAL_USB
+  return true;
+  #else
+  return !pinManager.isPinAllocated(1) || pinManager.getPinOwner(1) == PinOwner::DebugOut;
+  #endif
+}
+
 void updateBaudRate(uint32_t rate){
+  #ifdef WLED_SERIAL_USB
+  return; //USB CDC runs at USB speed, restarting it would drop the connection
+  #endif
   uint16_t rate100 = rate/100;
   if (rate100 == currentBaud || rate100 < 96) return;
   currentBaud = rate100;
 
-  if (!pinManager.isPinAllocated(1) || pinManager.getPinOwner(1) == PinOwner::DebugOut){
+  if (serialTxFree()){
     Serial.print(F("Baud is now ")); Serial.println(rate);
   }
 
   Serial.flush();
   Serial.begin(rate);
 }
+
+//sends the LED colors as a tpm2 data frame, either RGB with white added to each channel or RGBW
+static void sendTPM2Frame(bool rgbw)
+{
+  uint8_t cpl = rgbw ? 4 : 3;
+  pixidx_t total = strip.getLengthTotal();
+  uint16_t used = total > UINT16_MAX/cpl ? UINT16_MAX/cpl : total; //tpm2 frames have a 16 bit size
+  uint16_t len = used*cpl;
+  byte buf[ADA_BLOCK_PIXELS*4];
+  Serial.write(0xC9); Serial.write(0xDA);
+  Serial.write(highByte(len));
+  Serial.write(lowByte(len));
+  uint16_t n = 0;
+  for (uint16_t i=0; i < used; i++) {
+    uint32_t c = strip.getPixelColor(i);
+    if (rgbw) {
+      buf[n++] = R(c); buf[n++] = G(c); buf[n++] = B(c); buf[n++] = W(c);
+    } else {
+      buf[n++] = qadd8(W(c), R(c)); //simple RGBW -> RGB map
+      buf[n++] = qadd8(W(c), G(c));
+      buf[n++] = qadd8(W(c), B(c));
+    }
+    if (n > sizeof(buf) - cpl || i == used-1) {
+      Serial.write(buf, n);
+      n = 0;
+    }
+  }
+  Serial.write(0x36); Serial.write('\n');
+}
   
 void handleSerial()
 {
+  #ifndef WLED_SERIAL_USB
   if (pinManager.isPinAllocated(3)) return;
+  #endif
   
   #ifdef WLED_ENABLE_ADALIGHT
   static auto state = AdaState::Header_A;
   static uint16_t count = 0;
   static uint16_t pixel = 0;
   static byte check = 0x00;
-  static byte red   = 0x00;
-  static byte green = 0x00;
+  static byte pixelBuf[ADA_BLOCK_PIXELS*3];
+  static uint8_t partial = 0; //bytes of an incomplete pixel at the start of pixelBuf
+  static bool accepted = false; //the frame is shown, no network source of higher priority is streaming
 
   while (Serial.available() > 0)
   {
-    yield();
+    if (state == AdaState::Data) {
+      //copy pixel data in blocks straight from the UART buffer, a pixel may span two blocks
+      size_t n = Serial.available();
+      size_t want = (size_t)count*3 - partial;
+      if (n > want) n = want;
+      if (n > sizeof(pixelBuf) - partial) n = sizeof(pixelBuf) - partial;
+      n = Serial.readBytes(pixelBuf + partial, n) + partial;
+      uint16_t px = n / 3;
+      if (px && accepted && !realtimeOverride) setRealtimePixels(pixel, px, pixelBuf, 3);
+      pixel += px;
+      count -= px;
+      partial = n - px*3;
+      if (partial) memmove(pixelBuf, pixelBuf + px*3, partial);
+      if (!count) {
+        if (accepted) {
+          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
+          if (!realtimeOverride) strip.show();
+        }
+        state = AdaState::Header_A;
+        return; //let the main loop run between frames
+      }
+      continue;
+    }
+
     byte next = Serial.peek();
     switch (state) {
       case AdaState::Header_A:
@@ -72,34 +144,23 @@ void handleSerial()
         } else if (next == 0xB7) {updateBaudRate(1500000);
         
         } else if (next == 'l') { //RGB(W) LED data return as JSON array. Slow, but easy to use on the other end.
-          if (!pinManager.isPinAllocated(1) || pinManager.getPinOwner(1) == PinOwner::DebugOut){
-            uint16_t used = strip.getLengthTotal();
+          if (serialTxFree()){
+            pixidx_t used = strip.getLengthTotal();
             Serial.write('[');
-            for (uint16_t i=0; i<used; i+=1) {
+            for (pixidx_t i=0; i<used; i+=1) {
               Serial.print(strip.getPixelColor(i));
               if (i != used-1) Serial.write(',');
             }
             Serial.println("]");
           }  
         } else if (next == 'L') { //RGB LED data returned as bytes in tpm2 format. Faster, and slightly less easy to use on the other end.
-          if (!pinManager.isPinAllocated(1) || pinManager.getPinOwner(1) == PinOwner::DebugOut) {
-            Serial.write(0xC9); Serial.write(0xDA);
-            uint16_t used = strip.getLengthTotal();
-            uint16_t len = used*3;
-            Serial.write(highByte(len));
-            Serial.write(lowByte(len));
-            for (uint16_t i=0; i < used; i++) {
-              uint32_t c = strip.getPixelColor(i);
-              Serial.write(qadd8(W(c), R(c))); //R, add white channel to RGB channels as a simple RGBW -> RGB map
-              Serial.write(qadd8(W(c), G(c))); //G
-              Serial.write(qadd8(W(c), B(c))); //B
-            }
-            Serial.write(0x36); Serial.write('\n');
-          }
+          if (serialTxFree()) sendTPM2Frame(false);
+        } else if (next == 'W') { //RGBW LED data returned as bytes in tpm2 format, binary equivalent of 'l'
+          if (serialTxFree()) sendTPM2Frame(true);
         } else if (next == '{') { //JSON API
           bool verboseResponse = false;
           #ifdef WLED_USE_DYNAMIC_JSON
-          DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+          PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
           #else
           if (!requestJSONBufferLock(16)) return;
           #endif
@@ -111,7 +172,7 @@ void handleSerial()
           }
           verboseResponse = deserializeState(doc.as<JsonObject>());
           //only send response if TX pin is unused for other purposes
-          if (verboseResponse && (!pinManager.isPinAllocated(1) || pinManager.getPinOwner(1) == PinOwner::DebugOut)) {
+          if (verboseResponse && serialTxFree()) {
             doc.clear();
             JsonObject state = doc.createNestedObject("state");
             serializeState(state);
@@ -134,6 +195,7 @@ void handleSerial()
         break;
       case AdaState::Header_CountHi:
         pixel = 0;
+        partial = 0;
         count = next * 0x100;
         check = next;
         state = AdaState::Header_CountLo;
@@ -144,8 +206,9 @@ void handleSerial()
         state = AdaState::Header_CountCheck;
         break;
       case AdaState::Header_CountCheck:
-        if (check == next) state = AdaState::Data_Red;
+        if (check == next) state = AdaState::Data;
         else               state = AdaState::Header_A;
+        accepted = realtimeAccept(REALTIME_MODE_ADALIGHT, IPAddress(0,0,0,0));
         break;
       case AdaState::TPM2_Header_Type:
         state = AdaState::Header_A; //(unsupported) TPM2 command or invalid type
@@ -154,32 +217,16 @@ void handleSerial()
         break;
       case AdaState::TPM2_Header_CountHi:
         pixel = 0;
-        count = (next * 0x100) /3;
+        partial = 0;
+        count = next * 0x100;
         state = AdaState::TPM2_Header_CountLo;
         break;
       case AdaState::TPM2_Header_CountLo:
-        count += next /3;
-        state = AdaState::Data_Red;
-        break;
-      case AdaState::Data_Red:
-        red   = next;
-        state = AdaState::Data_Green;
-        break;
-      case AdaState::Data_Green:
-        green = next;
-        state = AdaState::Data_Blue;
-        break;
-      case AdaState::Data_Blue:
-        byte blue  = next;
-        if (!realtimeOverride) setRealtimePixel(pixel++, red, green, blue, 0);
-        if (--count > 0) state = AdaState::Data_Red;
-        else {
-          realtimeLock(realtimeTimeoutMs, REALTIME_MODE_ADALIGHT);
-
-          if (!realtimeOverride) strip.show();
-          state = AdaState::Header_A;
-        }
+        count = (count + next) /3;
+        state = count ? AdaState::Data : AdaState::Header_A;
+        accepted = realtimeAccept(REALTIME_MODE_ADALIGHT, IPAddress(0,0,0,0));
         break;
+      default: break;
     }
     Serial.read(); //discard the byte
   }
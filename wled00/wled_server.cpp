@@ -1,4 +1,7 @@
 #include "wled.h"
+#ifdef ESP8266
+  #include <lwip/priv/tcp_priv.h> //tcp_tw_pcbs
+#endif
 
 /*
  * Integrated HTTP web server page declarations
@@ -15,24 +18,174 @@ bool isIp(String str) {
   return true;
 }
 
+/*
+ * Uploads are buffered: the network callback only copies the chunks into a ring buffer, the main loop writes
+ * them to UPLOAD_TMP_FILE in small steps (handleFileUpload()) and the complete file replaces the target.
+ * While the buffer is full, the ESP32 callback waits for the loop, which also holds back the TCP window.
+ * ESP8266 callbacks must not wait, they write the buffered data themselves in that case.
+ */
+#ifndef WLED_UPLOAD_BUFFER
+  #ifdef ESP8266
+  #define WLED_UPLOAD_BUFFER 2048
+  #else
+  #define WLED_UPLOAD_BUFFER 8192
+  #endif
+#endif
+#define UPLOAD_TMP_FILE    "/upload.tmp"
+#define UPLOAD_DRAIN_BYTES 1024 // written per loop pass
+#define UPLOAD_TIMEOUT     5000 // ms a callback waits for the loop to make room
+
+static uint8_t* uploadBuf = nullptr;
+static volatile size_t uploadHead = 0;   // bytes received, advanced by the callback
+static volatile size_t uploadTail = 0;   // bytes written, advanced by drainUpload()
+static volatile bool   uploadFailed = false;
+static volatile bool   uploadAborted = false; // client gone before the last chunk
+static AsyncWebServerRequest* uploadRequest = nullptr;
+static File uploadFile;
+
+static void drainUpload(size_t maxBytes)
+{
+  while (maxBytes && uploadHead != uploadTail) {
+    size_t pos = uploadTail % WLED_UPLOAD_BUFFER;
+    size_t n = uploadHead - uploadTail;
+    if (n > WLED_UPLOAD_BUFFER - pos) n = WLED_UPLOAD_BUFFER - pos; //up to the end of the ring
+    if (n > maxBytes) n = maxBytes;
+    if (uploadFile.write(uploadBuf + pos, n) != n) uploadFailed = true;
+    uploadTail += n;
+    maxBytes -= n;
+  }
+}
+
+//waits until there is room in the buffer, or the buffer is empty if all is set
+static bool waitForUpload(bool all)
+{
+  #ifdef ARDUINO_ARCH_ESP32
+  unsigned long start = millis();
+  while (all ? (uploadHead != uploadTail) : (uploadHead - uploadTail >= WLED_UPLOAD_BUFFER)) {
+    if (millis() - start > UPLOAD_TIMEOUT) return false;
+    vTaskDelay(1);
+  }
+  #else
+  drainUpload(all ? SIZE_MAX : WLED_UPLOAD_BUFFER);
+  #endif
+  return !uploadFailed;
+}
+
+static void endUpload()
+{
+  uploadFile.close();
+  free(uploadBuf);
+  uploadBuf = nullptr;
+  uploadRequest = nullptr;
+}
+
+//JSON files must at least start like one, a broken upload would otherwise replace working settings or presets
+static bool uploadLooksValid(const String& filename)
+{
+  if (!filename.endsWith(".json")) return true;
+  File f = WLED_FS.open(UPLOAD_TMP_FILE, "r");
+  int c = ' ';
+  while (f && f.available() && isspace(c)) c = f.read();
+  f.close();
+  return c == '{' || c == '[';
+}
+
+//replaces the target by the uploaded file and lets the modules that keep data derived from it know
+static bool finishUpload(const String& filename)
+{
+  uploadFile.close();
+  if (uploadFailed || !uploadLooksValid(filename)) {
+    WLED_FS.remove(UPLOAD_TMP_FILE);
+    return false;
+  }
+  if (!WLED_FS.rename(UPLOAD_TMP_FILE, filename)) { //not every FS replaces an existing file on rename
+    WLED_FS.remove(filename);
+    if (!WLED_FS.rename(UPLOAD_TMP_FILE, filename)) return false;
+  }
+  fsCacheDrop(filename.c_str());
+  invalidateFSInfo();
+  for (byte bank = 0; bank < WLED_PRESET_BANKS; bank++) {
+    char bankFile[16];
+    getPresetBankFile(bankFile, bank);
+    if (filename != bankFile) continue;
+    if (bank == presetBank) {
+      presetsModifiedTime = toki.second();
+      dropPresetIndex();
+      dropBootSnapshot();
+    }
+    dropCachedPreset(0, bank);
+    #ifdef WLED_ENABLE_PRESET_LOG
+    if (bank == 0) doImportPresets = true;
+    #endif
+  }
+  if (filename == "/cfg.json") dropBootSnapshot();
+  if (filename == "/ir.json") dropIRTable();
+  if (filename.startsWith("/palette") && filename.endsWith(".bin")) strip.reloadCustomPalettes();
+  if (filename.startsWith("/ledmap") && filename.endsWith(".json")) { //binary table is made again on the next load
+    String binName = filename.substring(0, filename.length() -5) + ".bin";
+    WLED_FS.remove(binName);
+  }
+  return true;
+}
+
 void handleUpload(AsyncWebServerRequest *request, const String& filename, size_t index, uint8_t *data, size_t len, bool final){
   if (otaLock) {
     if (final) request->send(500, "text/plain", F("Please unlock OTA in security settings!"));
     return;
   }
-  if(!index){
-    request->_tempFile = WLED_FS.open(filename, "w");
+  if (!index && !uploadRequest) {
     DEBUG_PRINT("Uploading ");
     DEBUG_PRINTLN(filename);
-    if (filename == "/presets.json") presetsModifiedTime = toki.second();
+    uploadBuf = (uint8_t*)malloc(WLED_UPLOAD_BUFFER);
+    uploadFile = WLED_FS.open(UPLOAD_TMP_FILE, "w");
+    uploadHead = uploadTail = 0;
+    uploadFailed = !uploadBuf || !uploadFile;
+    uploadAborted = false;
+    uploadRequest = request;
+    httpOnDisconnect(request, [request](){ if (uploadRequest == request) uploadAborted = true; });
   }
-  if (len) {
-    request->_tempFile.write(data,len);
+  if (request != uploadRequest) { //only one upload at a time
+    if (final) request->send(503, "text/plain", F("Upload in progress"));
+    return;
   }
-  if(final){
-    request->_tempFile.close();
-    request->send(200, "text/plain", F("File Uploaded!"));
+
+  while (len && !uploadFailed) {
+    size_t room = WLED_UPLOAD_BUFFER - (uploadHead - uploadTail);
+    if (!room) {
+      if (!waitForUpload(false)) uploadFailed = true;
+      continue;
+    }
+    size_t pos = uploadHead % WLED_UPLOAD_BUFFER;
+    size_t n = len;
+    if (n > room) n = room;
+    if (n > WLED_UPLOAD_BUFFER - pos) n = WLED_UPLOAD_BUFFER - pos;
+    memcpy(uploadBuf + pos, data, n);
+    uploadHead += n;
+    data += n;
+    len -= n;
+  }
+
+  if (final) {
+    if (!uploadFailed && !waitForUpload(true)) uploadFailed = true;
+    bool success = finishUpload(filename);
+    endUpload();
+    if (success) request->send(200, "text/plain", F("File Uploaded!"));
+    else         request->send(500, "text/plain", F("Upload failed!"));
+  }
+}
+
+//writes buffered upload data from the main loop
+void handleFileUpload()
+{
+  if (!uploadRequest) return;
+  if (uploadAborted) {
+    DEBUG_PRINTLN(F("Upload aborted"));
+    uploadFile.close();
+    WLED_FS.remove(UPLOAD_TMP_FILE);
+    endUpload();
+    return;
   }
+  drainUpload(UPLOAD_DRAIN_BYTES);
 }
 
 bool captivePortal(AsyncWebServerRequest *request)
@@ -52,8 +205,138 @@ bool captivePortal(AsyncWebServerRequest *request)
   return false;
 }
 
+//true if the raw JSON body may contain a "v" key (full state requested in the response)
+bool mayRequestVerbose(const uint8_t* body, size_t len)
+{
+  for (size_t i = 2; i < len; i++) {
+    if (body[i] == '"' && body[i-1] == 'v' && body[i-2] == '"') return true;
+  }
+  return false;
+}
+
+/*
+ * HTTP connection accounting. The web server answers a single request per connection and closes it, so
+ * every client request costs a TCP connection. HttpClientHandler is attached first and sees each request
+ * once its headers are in: it takes one of WLED_MAX_HTTP_CLIENTS fixed slots until the connection closes,
+ * or answers 503 right away if none is free, before any buffers are allocated for the request.
+ * WebSocket and SSE connections are long-lived and not counted. Slot times give the request latency
+ * (headers received to connection closed) for /json/info "http".
+ * Code that needs to know when a request is gone uses httpOnDisconnect(), as a request has one handler.
+ */
+#ifndef WLED_MAX_HTTP_CLIENTS
+  #ifdef ESP8266
+  #define WLED_MAX_HTTP_CLIENTS 4
+  #else
+  #define WLED_MAX_HTTP_CLIENTS 8
+  #endif
+#endif
+#ifdef ESP8266
+  #define WLED_MAX_TIME_WAIT 4 // closed connections lwIP keeps for 2 minutes, ~200 bytes of heap each
+#endif
+
+struct HttpSlot {
+  AsyncWebServerRequest* request;
+  uint32_t start; // millis() when the headers were in
+  ArDisconnectHandler onDone;
+};
+static HttpSlot httpSlots[WLED_MAX_HTTP_CLIENTS];
+static uint8_t  httpOpen = 0, httpPeak = 0;
+static uint32_t httpRequests = 0, httpRejected = 0;
+static uint32_t httpLatSum = 0, httpLatCount = 0, httpLatMax = 0; //ms, reset when read
+
+static void httpRequestDone(AsyncWebServerRequest* request)
+{
+  for (uint8_t i = 0; i < WLED_MAX_HTTP_CLIENTS; i++) {
+    HttpSlot& slot = httpSlots[i];
+    if (slot.request != request) continue;
+    uint32_t ms = millis() - slot.start;
+    httpLatSum += ms; httpLatCount++;
+    if (ms > httpLatMax) httpLatMax = ms;
+    ArDisconnectHandler fn = slot.onDone;
+    slot.request = nullptr;
+    slot.onDone = nullptr;
+    if (httpOpen) httpOpen--;
+    if (fn) fn();
+    return;
+  }
+}
+
+class HttpClientHandler : public AsyncWebHandler {
+  public:
+  bool canHandle(AsyncWebServerRequest* request) override {
+    const String& url = request->url();
+    if (url == "/ws" || url == "/events") return false;
+    httpRequests++;
+    for (uint8_t i = 0; i < WLED_MAX_HTTP_CLIENTS; i++) {
+      if (httpSlots[i].request) continue;
+      httpSlots[i].request = request;
+      httpSlots[i].start = millis();
+      if (++httpOpen > httpPeak) httpPeak = httpOpen;
+      request->onDisconnect([request](){ httpRequestDone(request); });
+      return false; // served by the actual handler
+    }
+    httpRejected++;
+    return true;
+  }
+  void handleRequest(AsyncWebServerRequest* request) override {
+    AsyncWebServerResponse* response = request->beginResponse(503, "text/plain", F("Too many connections"));
+    response->addHeader(F("Retry-After"), "1");
+    request->send(response);
+  }
+  bool isRequestHandlerTrivial() override { return true; } // no body is read
+};
+
+//instead of request->onDisconnect(), which would replace the accounting
+void httpOnDisconnect(AsyncWebServerRequest* request, ArDisconnectHandler fn)
+{
+  for (uint8_t i = 0; i < WLED_MAX_HTTP_CLIENTS; i++) {
+    if (httpSlots[i].request == request) { httpSlots[i].onDone = fn; return; }
+  }
+  request->onDisconnect(fn);
+}
+
+#ifdef ESP8266
+//a client opening a connection per request leaves one in TIME_WAIT each, this drops the oldest beyond WLED_MAX_TIME_WAIT
+static uint8_t countTimeWait()
+{
+  uint8_t n = 0;
+  for (struct tcp_pcb* pcb = tcp_tw_pcbs; pcb; pcb = pcb->next) n++;
+  return n;
+}
+
+void handleTimeWait()
+{
+  uint8_t n = countTimeWait();
+  while (n-- > WLED_MAX_TIME_WAIT) {
+    struct tcp_pcb* oldest = tcp_tw_pcbs;
+    for (struct tcp_pcb* pcb = tcp_tw_pcbs; pcb; pcb = pcb->next) {
+      if ((uint32_t)(tcp_ticks - pcb->tmr) > (uint32_t)(tcp_ticks - oldest->tmr)) oldest = pcb;
+    }
+    tcp_abort(oldest);
+  }
+}
+#endif
+
+void serializeHttpStats(JsonObject root)
+{
+  root[F("open")] = httpOpen;
+  root[F("max")]  = WLED_MAX_HTTP_CLIENTS;
+  root[F("peak")] = httpPeak;
+  root[F("req")]  = httpRequests;
+  root[F("rej")]  = httpRejected;
+  root[F("lat")]  = httpLatCount ? httpLatSum / httpLatCount : 0; //ms, average since the last read
+  root[F("latmax")] = httpLatMax;
+  #ifdef ESP8266
+  root[F("tw")]   = countTimeWait();
+  #endif
+  httpLatSum = httpLatCount = httpLatMax = 0;
+  httpPeak = httpOpen;
+}
+
 void initServer()
 {
+  server.addHandler(new HttpClientHandler()); //first, sees every request
+
   //CORS compatiblity
   DefaultHeaders::Instance().addHeader(F("Access-Control-Allow-Origin"), "*");
   DefaultHeaders::Instance().addHeader(F("Access-Control-Allow-Methods"), "*");
@@ -102,25 +385,41 @@ void initServer()
     serveJson(request);
   });
 
+  server.on("/bulk", HTTP_GET | HTTP_POST, [](AsyncWebServerRequest *request){
+    handleBulkSet(request);
+  });
+
   AsyncCallbackJsonWebHandler* handler = new AsyncCallbackJsonWebHandler("/json", [](AsyncWebServerRequest *request) {
     bool verboseResponse = false;
-    bool isConfig = false;
+    bool isConfig = request->url().indexOf("cfg") > -1;
+    //state changes that do not need the resulting state in the response are applied between frames
+    if (!isConfig && !mayRequestVerbose((const uint8_t*)(request->_tempObject), request->contentLength())
+        && queueStateRequest((const uint8_t*)(request->_tempObject), request->contentLength())) {
+      request->send(200, "application/json", F("{\"success\":true}"));
+      return;
+    }
     { //scope JsonDocument so it releases its buffer
       #ifdef WLED_USE_DYNAMIC_JSON
-      DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+      PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
       #else
-      if (!requestJSONBufferLock(14)) return;
+      if (!tryRequestJSONBufferLock(14)) { serveJsonOverload(request); return; } //do not block the network task
       #endif
 
       DeserializationError error = deserializeJson(doc, (uint8_t*)(request->_tempObject));
       JsonObject root = doc.as<JsonObject>();
+      if (error == DeserializationError::NoMemory && !isConfig) {
+        //too large for the document, apply it one segment at a time
+        verboseResponse = deserializeStateStream((const uint8_t*)(request->_tempObject), request->contentLength(), &doc);
+        releaseJSONBufferLock();
+        if (verboseResponse) { serveJson(request); return; }
+        request->send(200, "application/json", F("{\"success\":true}"));
+        return;
+      }
       if (error || root.isNull()) {
         releaseJSONBufferLock();
         request->send(400, "application/json", F("{\"error\":9}"));
         return;
       }
-      const String& url = request->url();
-      isConfig = url.indexOf("cfg") > -1;
       if (!isConfig) {
         #ifdef WLED_DEBUG
           DEBUG_PRINTLN(F("Serialized HTTP"));
@@ -203,14 +502,11 @@ void initServer()
     },[](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final){
       if(!index){
         DEBUG_PRINTLN(F("OTA Update Start"));
-        #ifdef ESP8266
-        Update.runAsync(true);
-        #endif
-        Update.begin((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000);
+        otaBegin(data, len);
       }
-      if(!Update.hasError()) Update.write(data, len);
+      otaWrite(data, len);
       if(final){
-        if(Update.end(true)){
+        if(otaEnd()){
           DEBUG_PRINTLN(F("Update Success"));
         } else {
           DEBUG_PRINTLN(F("Update Failed"));
@@ -218,6 +514,11 @@ void initServer()
       }
     });
     
+    #ifdef WLED_ENABLE_FLEET_OTA
+    server.on("/fleet.bin", HTTP_GET, [](AsyncWebServerRequest *request){
+      serveFleetImage(request);
+    });
+    #endif
     #else
     server.on("/update", HTTP_GET, [](AsyncWebServerRequest *request){
       serveMessage(request, 501, "Not implemented", F("OTA updating is disabled in this build."), 254);
@@ -251,6 +552,7 @@ void initServer()
   #ifdef WLED_ENABLE_WEBSOCKETS
   server.addHandler(&ws);
   #endif
+  initSse();
   
   //called when the url is not defined here, ajax-in; get-settings
   server.onNotFound([](AsyncWebServerRequest *request){
@@ -286,17 +588,17 @@ void serveIndexOrWelcome(AsyncWebServerRequest *request)
   }
 }
 
-bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request)
+bool handleIfNoneMatchCacheHeader(AsyncWebServerRequest* request, const String& eTag)
 {
   AsyncWebHeader* header = request->getHeader("If-None-Match");
-  if (header && header->value() == String(VERSION)) {
+  if (header && header->value() == eTag) {
     request->send(304);
     return true;
   }
   return false;
 }
 
-void setStaticContentCacheHeaders(AsyncWebServerResponse *response)
+void setStaticContentCacheHeaders(AsyncWebServerResponse *response, const String& eTag)
 {
   #ifndef WLED_DEBUG
   //this header name is misleading, "no-cache" will not disable cache,
@@ -305,19 +607,60 @@ void setStaticContentCacheHeaders(AsyncWebServerResponse *response)
   #else
   response->addHeader(F("Cache-Control"),"no-store,max-age=0"); // prevent caching if debug build
   #endif
-  response->addHeader(F("ETag"), String(VERSION));
+  response->addHeader(F("ETag"), eTag);
+}
+
+bool acceptsGzip(AsyncWebServerRequest* request)
+{
+  #ifdef WLED_DISABLE_GZIP_RESPONSES
+  return false;
+  #else
+  AsyncWebHeader* header = request->getHeader("Accept-Encoding");
+  return header && header->value().indexOf("gzip") >= 0;
+  #endif
+}
+
+//chunked response compressing the content of source while it is sent, nullptr if the client does not accept gzip
+//or the compressor does not fit the heap (send the content uncompressed then)
+AsyncWebServerResponse* beginGzipResponse(AsyncWebServerRequest* request, const String& contentType, GzipSource source)
+{
+  if (!acceptsGzip(request) || ESP.getFreeHeap() < sizeof(GzipStream) + WLED_GZIP_MIN_HEAP) return nullptr;
+  std::shared_ptr<GzipStream> gz(new (std::nothrow) GzipStream(source)); //freed with the response
+  if (!gz) return nullptr;
+  AsyncWebServerResponse *response = request->beginChunkedResponse(contentType, [gz](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+    return gz->fill(buf, maxLen);
+  });
+  response->addHeader(F("Content-Encoding"), "gzip");
+  response->addHeader(F("Vary"), F("Accept-Encoding"));
+  return response;
+}
+
+//response sending content compressed before (see gzipBuffer()), which is kept while it is sent
+AsyncWebServerResponse* beginGzipResponse(AsyncWebServerRequest* request, const String& contentType, std::shared_ptr<std::vector<uint8_t>> gz)
+{
+  AsyncWebServerResponse *response = request->beginResponse(contentType, gz->size(), [gz](uint8_t* buf, size_t maxLen, size_t index) -> size_t {
+    if (index >= gz->size()) return 0;
+    size_t len = min(maxLen, gz->size() - index);
+    memcpy(buf, gz->data() + index, len);
+    return len;
+  });
+  response->addHeader(F("Content-Encoding"), "gzip");
+  response->addHeader(F("Vary"), F("Accept-Encoding"));
+  return response;
 }
 
 void serveIndex(AsyncWebServerRequest* request)
 {
   if (handleFileRead(request, "/index.htm")) return;
 
-  if (handleIfNoneMatchCacheHeader(request)) return;
+  //content hash of the UI, stays valid across firmware updates that do not change it
+  String eTag = FPSTR(PAGE_index_hash);
+  if (handleIfNoneMatchCacheHeader(request, eTag)) return;
 
   AsyncWebServerResponse *response = request->beginResponse_P(200, "text/html", PAGE_index, PAGE_index_L);
 
   response->addHeader(F("Content-Encoding"),"gzip");
-  setStaticContentCacheHeaders(response);
+  setStaticContentCacheHeaders(response, eTag);
   request->send(response);
 }
 
@@ -369,10 +712,23 @@ void serveMessage(AsyncWebServerRequest* request, uint16_t code, const String& h
 String settingsProcessor(const String& var)
 {
   if (var == "CSS") {
+    //pages without live values (IP, current, sunrise, Hue status) are kept until the configuration is written
+    static String cachedJS;
+    static byte cachedPage = 0;
+    static uint16_t cachedVersion = 0;
+    bool cacheable = (optionType == 3 || (optionType >= 6 && optionType <= 8));
+    if (cacheable && cachedPage == optionType && cachedVersion == configVersion) return cachedJS;
+
     char buf[SETTINGS_STACK_BUF_SIZE];
     buf[0] = 0;
     getSettingsJS(optionType, buf);
     //Serial.println(uxTaskGetStackHighWaterMark(NULL));
+    if (cacheable) {
+      cachedJS = buf;
+      cachedPage = optionType;
+      cachedVersion = configVersion;
+      return cachedJS;
+    }
     return String(buf);
   }
   
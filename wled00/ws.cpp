@@ -10,6 +10,78 @@ unsigned long wsLastLiveTime = 0;
 //uint8_t* wsFrameBuffer = nullptr;
 
 #define WS_LIVE_INTERVAL 40
+#define WS_MAX_BINARY_CLIENTS 4
+
+uint32_t wsBinaryClients[WS_MAX_BINARY_CLIENTS] = {0}; //clients that asked for binary state with {"bin":true}
+
+static void setWsBinaryClient(uint32_t clientId, bool binary);
+static bool sendStateBinaryWs(uint32_t clientId);
+
+/*
+ * Topic subscriptions with {"sub":["state","seg","info","live"]}, an empty list goes back to full pushes.
+ * Subscribers get {"d":<push>,"state":{..},"info":{..}} with only the top level fields and segments that changed
+ * since the last message their send queue accepted (removed segments as {"id":n,"stop":0}).
+ * Subscribing again or {"v":true} sends a full snapshot.
+ */
+#define WS_TOPIC_STATE  0x01
+#define WS_TOPIC_SEG    0x02
+#define WS_TOPIC_INFO   0x04
+#define WS_TOPIC_LIVE   0x08
+
+#ifndef WS_MAX_SUBSCRIBERS
+  #ifdef ESP8266
+  #define WS_MAX_SUBSCRIBERS 2
+  #else
+  #define WS_MAX_SUBSCRIBERS 4
+  #endif
+#endif
+#define WS_DIFF_STATE_KEYS 16 // fields past these are sent every time
+#define WS_DIFF_INFO_KEYS  40
+
+struct WsSubscriber {
+  uint32_t id;
+  uint8_t  topics;
+  uint32_t stateHash[WS_DIFF_STATE_KEYS]; // 0: not sent
+  uint32_t infoHash[WS_DIFF_INFO_KEYS];
+  uint32_t segHash[MAX_NUM_SEGMENTS];     // 0: not sent or inactive
+};
+
+WsSubscriber* wsSubscribers[WS_MAX_SUBSCRIBERS] = {nullptr}; //allocated on subscription
+uint32_t wsPushCount = 0;
+bool wsPushPending = false; //a push ran out of memory, retried from handleWs()
+
+static WsSubscriber* getWsSubscriber(uint32_t clientId);
+static void setWsSubscriber(uint32_t clientId, uint8_t topics);
+static void setWsLiveStream(uint32_t clientId, JsonVariant lv);
+
+/*
+ * Per-client send queues: state is only queued while the client has fewer than WS_CLIENT_QUEUE messages waiting,
+ * so a client on a weak link does not pile up heap. A push it cannot take marks it pending, once its queue drained
+ * it gets the state of that moment, the versions in between are never sent. A client whose queue stays full for
+ * WS_CLIENT_STALL_MS is disconnected, the other clients are not affected.
+ */
+#ifndef WS_CLIENT_QUEUE
+  #ifdef ESP8266
+  #define WS_CLIENT_QUEUE 2
+  #else
+  #define WS_CLIENT_QUEUE 4
+  #endif
+#endif
+#define WS_CLIENT_STALL_MS 10000
+#define WS_MAX_PENDING     8
+
+struct WsPending {
+  uint32_t id;          // 0: free
+  unsigned long since;  // queue full since
+};
+
+static WsPending wsPending[WS_MAX_PENDING] = {};
+static uint32_t wsCollapsed = 0;  // pushes not queued for a full client
+static uint32_t wsSlowClosed = 0; // clients disconnected for falling behind
+
+static void pushWs(AsyncWebSocketClient * client, bool snapshot);
+static bool wsCanQueue(AsyncWebSocketClient * client);
+static void clearWsPending(uint32_t clientId);
 
 void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventType type, void * arg, uint8_t *data, size_t len)
 {
@@ -19,6 +91,10 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   } else if(type == WS_EVT_DISCONNECT){
     //client disconnected
     if (client->id() == wsLiveClientId) wsLiveClientId = 0;
+    setWsBinaryClient(client->id(), false);
+    setWsSubscriber(client->id(), 0);
+    setWsLiveStream(client->id(), JsonVariant());
+    clearWsPending(client->id());
   } else if(type == WS_EVT_DATA){
     //data packet
     AwsFrameInfo * info = (AwsFrameInfo*)arg;
@@ -32,10 +108,14 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
           client->text(F("pong"));
           return;
         }
+        //state changes are applied from the main loop between frames
+        if (queueStateRequest(data, len, client->id())) return;
+
+        //queue full, handle directly
         bool verboseResponse = false;
         { //scope JsonDocument so it releases its buffer
           #ifdef WLED_USE_DYNAMIC_JSON
-          DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+          PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
           #else
           if (!requestJSONBufferLock(11)) return;
           #endif
@@ -46,23 +126,10 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
             releaseJSONBufferLock();
             return;
           }
-          if (root["v"] && root.size() == 1) {
-            //if the received value is just "{"v":true}", send only to this client
-            verboseResponse = true;
-          } else if (root.containsKey("lv"))
-          {
-            wsLiveClientId = root["lv"] ? client->id() : 0;
-          } else {
-            verboseResponse = deserializeState(root);
-            if (!interfaceUpdateCallMode) {
-              //special case, only on playlist load, avoid sending twice in rapid succession
-              if (millis() - lastInterfaceUpdate > (INTERFACE_UPDATE_COOLDOWN -300)) verboseResponse = false;
-            }
-          }
+          verboseResponse = applyWsState(root, client->id());
           releaseJSONBufferLock(); // will clean fileDoc
         }
-        //update if it takes longer than 300ms until next "broadcast"
-        if (verboseResponse && (millis() - lastInterfaceUpdate < (INTERFACE_UPDATE_COOLDOWN -300) || !interfaceUpdateCallMode)) sendDataWs(client);
+        if (verboseResponse) sendDataWs(client);
       }
     } else {
       //message is comprised of multiple frames or the frame is split into multiple packets
@@ -92,39 +159,351 @@ void wsEvent(AsyncWebSocket * server, AsyncWebSocketClient * client, AwsEventTyp
   }
 }
 
+static void setWsBinaryClient(uint32_t clientId, bool binary)
+{
+  for (uint8_t i = 0; i < WS_MAX_BINARY_CLIENTS; i++) {
+    if (wsBinaryClients[i] == clientId) wsBinaryClients[i] = 0;
+  }
+  if (!binary) return;
+  for (uint8_t i = 0; i < WS_MAX_BINARY_CLIENTS; i++) {
+    if (!wsBinaryClients[i]) { wsBinaryClients[i] = clientId; return; }
+  }
+}
+
+//binary state straight into the message buffer, no JsonDocument
+static bool sendStateBinaryWs(uint32_t clientId)
+{
+  AsyncWebSocketClient * wsc = ws.client(clientId);
+  if (!wsc) return false;
+  if (!wsCanQueue(wsc)) return true; //sent once its queue drained
+  AsyncWebSocketMessageBuffer * buffer = ws.makeBuffer(getBinaryStateSize());
+  if (!buffer) { memAllocFailed(MEM_WS); return false; } //out of memory
+  serializeStateBinary(buffer->get());
+  wsc->binary(buffer);
+  return true;
+}
+
+//false if the client's queue is full, it is then marked to get the latest state once it drained
+static bool wsCanQueue(AsyncWebSocketClient * client)
+{
+  if (client->queueLength() < WS_CLIENT_QUEUE) return true;
+  wsCollapsed++;
+  WsPending* slot = nullptr;
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) {
+    if (wsPending[i].id == client->id()) return false;
+    if (!slot && !wsPending[i].id) slot = &wsPending[i];
+  }
+  if (slot) { slot->id = client->id(); slot->since = millis(); } //else it waits for the next push
+  return false;
+}
+
+static void clearWsPending(uint32_t clientId)
+{
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) if (wsPending[i].id == clientId) wsPending[i].id = 0;
+}
+
+//clients that drained their queue get the current state, those that stayed full too long are dropped
+static void handleWsPending()
+{
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) {
+    WsPending& p = wsPending[i];
+    if (!p.id) continue;
+    AsyncWebSocketClient * c = ws.client(p.id);
+    if (!c) { p.id = 0; continue; }
+    if (c->queueLength() >= WS_CLIENT_QUEUE) {
+      if (millis() - p.since < WS_CLIENT_STALL_MS) continue;
+      DEBUG_PRINTF("WS client %u too slow, closing.\n", p.id);
+      p.id = 0;
+      wsSlowClosed++;
+      c->close(1013); //try again later
+      continue;
+    }
+    p.id = 0;
+    pushWs(c, false);
+  }
+}
+
+static WsSubscriber* getWsSubscriber(uint32_t clientId)
+{
+  for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS; i++) {
+    if (wsSubscribers[i] && wsSubscribers[i]->id == clientId) return wsSubscribers[i];
+  }
+  return nullptr;
+}
+
+static void setWsSubscriber(uint32_t clientId, uint8_t topics)
+{
+  if (topics & WS_TOPIC_LIVE) wsLiveClientId = clientId;
+  else if (clientId == wsLiveClientId) wsLiveClientId = 0;
+  topics &= ~WS_TOPIC_LIVE; //the live view is not part of the JSON push
+
+  WsSubscriber* s = getWsSubscriber(clientId);
+  if (!topics) {
+    for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS && s; i++) {
+      if (wsSubscribers[i] != s) continue;
+      delete s;
+      wsSubscribers[i] = nullptr;
+    }
+    return;
+  }
+  for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS && !s; i++) {
+    if (wsSubscribers[i]) continue;
+    s = wsSubscribers[i] = new (std::nothrow) WsSubscriber;
+    if (!s) { memAllocFailed(MEM_WS); break; }
+  }
+  if (!s) return; //all taken or out of memory, the client stays on full pushes
+  memset(s, 0, sizeof(WsSubscriber)); //full snapshot first
+  s->id = clientId;
+  s->topics = topics;
+}
+
+//FNV-1a of the serialized JSON, used as an ArduinoJson writer
+class WsHashWriter {
+  public:
+  uint32_t hash = 2166136261UL;
+  size_t write(uint8_t c) { hash = (hash ^ c) * 16777619UL; return 1; }
+  size_t write(const uint8_t* s, size_t n) { for (size_t i = 0; i < n; i++) write(s[i]); return n; }
+};
+
+//counts the message on the first pass (buf == nullptr) and writes it into the message buffer on the second
+class WsDiffWriter {
+  public:
+  uint8_t* buf = nullptr;
+  size_t   len = 0;
+  size_t write(uint8_t c) { if (buf) buf[len] = c; len++; return 1; }
+  size_t write(const uint8_t* s, size_t n) { if (buf) memcpy(buf + len, s, n); len += n; return n; }
+  void   print(const char* s) { write((const uint8_t*)s, strlen(s)); }
+  void   print(uint32_t n) { char tmp[11]; sprintf_P(tmp, PSTR("%u"), (unsigned)n); print(tmp); }
+};
+
+//hashes of the pushed state, shared by all subscribers of one push
+struct WsPushHashes {
+  uint32_t   state[WS_DIFF_STATE_KEYS];
+  uint32_t   info[WS_DIFF_INFO_KEYS];
+  uint32_t   seg[MAX_NUM_SEGMENTS];
+  JsonObject segObj[MAX_NUM_SEGMENTS];
+};
+
+static uint32_t hashJsonPair(const char* key, JsonVariantConst value)
+{
+  WsHashWriter h;
+  h.write((const uint8_t*)key, strlen(key));
+  serializeJson(value, h);
+  return h.hash ? h.hash : 1;
+}
+
+//fields are compared by position, a field that moves is just sent again
+static void hashJsonFields(JsonObject obj, uint32_t* hashes, uint8_t keys, const char* skip)
+{
+  uint8_t pos = 0;
+  for (JsonPair kv : obj) {
+    if (pos >= keys) break;
+    if (skip && !strcmp(kv.key().c_str(), skip)) continue;
+    hashes[pos++] = hashJsonPair(kv.key().c_str(), kv.value());
+  }
+}
+
+//writes ,"name":{ and the changed fields, returns true if the object was opened
+static bool writeJsonDiff(WsDiffWriter& w, const char* name, JsonObject obj, const uint32_t* cur, const uint32_t* sent, uint8_t keys, const char* skip)
+{
+  uint8_t pos = 0;
+  bool open = false;
+  for (JsonPair kv : obj) {
+    const char* key = kv.key().c_str();
+    if (skip && !strcmp(key, skip)) continue;
+    bool same = (pos < keys && cur[pos] == sent[pos]);
+    pos++;
+    if (same) continue;
+    if (!open) { w.print(",\""); w.print(name); w.print("\":{"); open = true; }
+    else w.print(",");
+    w.print("\""); w.print(key); w.print("\":");
+    serializeJson(kv.value(), w);
+  }
+  return open;
+}
+
+//returns false if nothing changed for this subscriber
+static bool writeDiffWs(WsDiffWriter& w, WsSubscriber* s, JsonObject state, JsonObject info, const WsPushHashes& cur)
+{
+  bool changed = false;
+  w.len = 0;
+  w.print("{\"d\":"); w.print(wsPushCount);
+
+  bool open = false;
+  if (s->topics & WS_TOPIC_STATE) open = writeJsonDiff(w, "state", state, cur.state, s->stateHash, WS_DIFF_STATE_KEYS, "seg");
+  if (s->topics & WS_TOPIC_SEG) {
+    bool segOpen = false;
+    for (uint8_t id = 0; id < MAX_NUM_SEGMENTS; id++) {
+      if (cur.seg[id] == s->segHash[id]) continue;
+      if (!segOpen) { w.print(open ? ",\"seg\":[" : ",\"state\":{\"seg\":["); open = segOpen = true; }
+      else w.print(",");
+      if (cur.seg[id]) serializeJson(cur.segObj[id], w);
+      else { w.print("{\"id\":"); w.print(id); w.print(",\"stop\":0}"); } //removed
+    }
+    if (segOpen) w.print("]");
+  }
+  if (open) { w.print("}"); changed = true; }
+
+  if ((s->topics & WS_TOPIC_INFO) && writeJsonDiff(w, "info", info, cur.info, s->infoHash, WS_DIFF_INFO_KEYS, nullptr)) {
+    w.print("}");
+    changed = true;
+  }
+  w.print("}");
+  return changed;
+}
+
+static bool sendDiffWs(WsSubscriber* s, JsonObject state, JsonObject info, const WsPushHashes& cur)
+{
+  AsyncWebSocketClient * wsc = ws.client(s->id);
+  if (!wsc) return true;
+  if (!wsCanQueue(wsc)) return true; //not queued, its fields stay changed until its queue drained
+
+  WsDiffWriter w;
+  if (!writeDiffWs(w, s, state, info, cur)) return true;
+  AsyncWebSocketMessageBuffer * buffer = ws.makeBuffer(w.len);
+  if (!buffer) { memAllocFailed(MEM_WS); return false; } //out of memory
+  w.buf = buffer->get();
+  writeDiffWs(w, s, state, info, cur);
+  wsc->text(buffer);
+
+  if (s->topics & WS_TOPIC_STATE) memcpy(s->stateHash, cur.state, sizeof(s->stateHash));
+  if (s->topics & WS_TOPIC_SEG)   memcpy(s->segHash,   cur.seg,   sizeof(s->segHash));
+  if (s->topics & WS_TOPIC_INFO)  memcpy(s->infoHash,  cur.info,  sizeof(s->infoHash));
+  return true;
+}
+
+//diffs to all subscribers, or only to the given one
+static bool pushDiffsWs(JsonObject state, JsonObject info, AsyncWebSocketClient * client)
+{
+  WsPushHashes* cur = new (std::nothrow) WsPushHashes(); //zeroed, too large for the async callbacks' stack
+  if (!cur) return false;
+  hashJsonFields(state, cur->state, WS_DIFF_STATE_KEYS, "seg");
+  hashJsonFields(info,  cur->info,  WS_DIFF_INFO_KEYS,  nullptr);
+  for (JsonObject seg0 : state["seg"].as<JsonArray>()) {
+    uint8_t id = seg0["id"];
+    if (id >= MAX_NUM_SEGMENTS) continue;
+    cur->seg[id] = hashJsonPair("", seg0);
+    cur->segObj[id] = seg0;
+  }
+
+  bool success = true;
+  wsPushCount++;
+  for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS; i++) {
+    WsSubscriber* s = wsSubscribers[i];
+    if (!s || (client && client->id() != s->id)) continue;
+    success &= sendDiffWs(s, state, info, *cur);
+  }
+  delete cur;
+  return success;
+}
+
+//returns true if the sending client should receive the full state
+bool applyWsState(JsonObject root, uint32_t clientId)
+{
+  bool verboseResponse = false;
+  if (root["v"] && root.size() == 1) {
+    //if the received value is just "{"v":true}", send only to this client
+    verboseResponse = true;
+  } else if (root.containsKey("lv"))
+  {
+    setWsLiveStream(clientId, root["lv"]); //full resolution stream if an object
+    if (!root["lv"].is<JsonObject>()) wsLiveClientId = root["lv"] ? clientId : 0;
+    else if (wsLiveClientId == clientId) wsLiveClientId = 0;
+  } else if (root.containsKey("bin") && root.size() == 1)
+  {
+    //state updates to this client are sent in the binary format of /json/state?fmt=bin in addition
+    setWsBinaryClient(clientId, root["bin"]);
+    if (root["bin"]) sendStateBinaryWs(clientId);
+  } else if (root.containsKey("sub") && root.size() == 1)
+  {
+    uint8_t topics = 0;
+    for (JsonVariant t : root["sub"].as<JsonArray>()) {
+      const char* topic = t | "";
+      if      (!strcmp_P(topic, PSTR("state"))) topics |= WS_TOPIC_STATE;
+      else if (!strcmp_P(topic, PSTR("seg")))   topics |= WS_TOPIC_SEG;
+      else if (!strcmp_P(topic, PSTR("info")))  topics |= WS_TOPIC_INFO;
+      else if (!strcmp_P(topic, PSTR("live")))  topics |= WS_TOPIC_LIVE;
+    }
+    setWsSubscriber(clientId, topics);
+    return true; //snapshot right away, or the full state when unsubscribed
+  } else {
+    verboseResponse = deserializeState(root);
+    if (!interfaceUpdateCallMode) {
+      //special case, only on playlist load, avoid sending twice in rapid succession
+      if (millis() - lastInterfaceUpdate > (INTERFACE_UPDATE_COOLDOWN -300)) verboseResponse = false;
+    }
+  }
+  //update if it takes longer than 300ms until next "broadcast"
+  return verboseResponse && (millis() - lastInterfaceUpdate < (INTERFACE_UPDATE_COOLDOWN -300) || !interfaceUpdateCallMode);
+}
+
 void sendDataWs(AsyncWebSocketClient * client)
+{
+  pushWs(client, true);
+}
+
+//state to all clients, or to the given one (snapshot: a subscriber gets all fields, not just the changed ones)
+static void pushWs(AsyncWebSocketClient * client, bool snapshot)
 {
   if (!ws.count()) return;
-  AsyncWebSocketMessageBuffer * buffer;
+  wsPushPending = false;
+  TRACE_START(traceStart);
+
+  uint8_t subscribers = 0;
+  bool clientSubscribed = false;
+  for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS; i++) {
+    if (!wsSubscribers[i]) continue;
+    subscribers++;
+    if (client && client->id() == wsSubscribers[i]->id) {
+      clientSubscribed = true;
+      if (snapshot) memset(wsSubscribers[i]->stateHash, 0, sizeof(WsSubscriber) - offsetof(WsSubscriber, stateHash)); //full snapshot
+    }
+  }
+  bool fullPush = client ? !clientSubscribed : (ws.count() > subscribers);
 
   { //scope JsonDocument so it releases its buffer
     #ifdef WLED_USE_DYNAMIC_JSON
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    PSRAMDynamicJsonDocument doc(JSON_BUFFER_SIZE);
+    JsonDocument* pDoc = nullptr;
     #else
-    if (!requestJSONBufferLock(12)) return;
+    JsonDocument* pDoc = requestJSONBuffer(12);
+    if (!pDoc) { wsPushPending = true; return; }
+    JsonDocument& doc = *pDoc;
     #endif
     JsonObject state = doc.createNestedObject("state");
     serializeState(state);
     JsonObject info  = doc.createNestedObject("info");
     serializeInfo(info);
-    size_t len = measureJson(doc);
-    size_t heap1 = ESP.getFreeHeap();
-    buffer = ws.makeBuffer(len); // will not allocate correct memory sometimes
-    size_t heap2 = ESP.getFreeHeap();
-    if (!buffer || heap1-heap2<len) {
-      releaseJSONBufferLock();
-      ws.closeAll(1013); //code 1013 = temporary overload, try again later
-      ws.cleanupClients(0); //disconnect all clients to release memory
-      return; //out of memory
+
+    if (fullPush) {
+      size_t len = measureJson(doc);
+      size_t heap1 = ESP.getFreeHeap();
+      AsyncWebSocketMessageBuffer * buffer = ws.makeBuffer(len); // will not allocate correct memory sometimes
+      size_t heap2 = ESP.getFreeHeap();
+      if (!buffer || heap1-heap2<len) {
+        //out of memory, keep the clients and try again shortly
+        memAllocFailed(MEM_WS);
+        releaseJSONBuffer(pDoc);
+        wsPushPending = true;
+        return;
+      }
+      serializeJson(doc, (char *)buffer->get(), len +1);
+      if (client) {
+        if (wsCanQueue(client)) client->text(buffer);
+      } else {
+        for (auto c : ws.getClients()) {
+          if (c->status() == WS_CONNECTED && !getWsSubscriber(c->id()) && wsCanQueue(c)) c->text(buffer);
+        }
+      }
     }
-    serializeJson(doc, (char *)buffer->get(), len +1);
-    releaseJSONBufferLock();
-  } 
-  if (client) {
-    client->text(buffer);
-  } else {
-    ws.textAll(buffer);
+    if ((!client || clientSubscribed) && subscribers && !pushDiffsWs(state, info, client)) wsPushPending = true;
+    releaseJSONBuffer(pDoc);
+  }
+  for (uint8_t i = 0; i < WS_MAX_BINARY_CLIENTS; i++) {
+    if (!wsBinaryClients[i] || (client && client->id() != wsBinaryClients[i])) continue;
+    if (!sendStateBinaryWs(wsBinaryClients[i])) wsBinaryClients[i] = 0; //gone
   }
+  TRACE_SPAN(TRACE_WS_SEND, 0, traceStart);
 }
 
 #define MAX_LIVE_LEDS_WS 256
@@ -134,17 +513,17 @@ bool sendLiveLedsWs(uint32_t wsClient)
   AsyncWebSocketClient * wsc = ws.client(wsClient);
   if (!wsc || wsc->queueLength() > 0) return false; //only send if queue free
 
-  uint16_t used = strip.getLengthTotal();
-  uint16_t n = ((used -1)/MAX_LIVE_LEDS_WS) +1; //only serve every n'th LED if count over MAX_LIVE_LEDS_WS
+  pixidx_t used = strip.getLengthTotal();
+  pixidx_t n = ((used -1)/MAX_LIVE_LEDS_WS) +1; //only serve every n'th LED if count over MAX_LIVE_LEDS_WS
   uint16_t bufSize = 2 + (used/n)*3;
   AsyncWebSocketMessageBuffer * wsBuf = ws.makeBuffer(bufSize);
-  if (!wsBuf) return false; //out of memory
+  if (!wsBuf) { memAllocFailed(MEM_WS); return false; } //out of memory
   uint8_t* buffer = wsBuf->get();
   buffer[0] = 'L';
   buffer[1] = 1; //version
 
   uint16_t pos = 2;
-  for (uint16_t i= 0; pos < bufSize -2; i += n)
+  for (pixidx_t i= 0; pos < bufSize -2; i += n)
   {
     uint32_t c = strip.getPixelColor(i);
     buffer[pos++] = qadd8(W(c), R(c)); //R, add white channel to RGB channels as a simple RGBW -> RGB map
@@ -156,8 +535,174 @@ bool sendLiveLedsWs(uint32_t wsClient)
   return true;
 }
 
+/*
+ * Full resolution live view, opted in with {"lv":{"fps":15,"enc":2}} ({"lv":false} ends it).
+ * Binary frames: 0 'L'  1 version 2  2 encoding  3 flags (bit0 key frame)  4-5 LEDs  6-7 width (ledmap.json, 0: strip)
+ * 8-9 frame number, all little endian, followed by the pixels as R,G,B (white added to RGB as in version 1) and
+ * WS_LIVE_ENC_RAW:   all pixels
+ * WS_LIVE_ENC_RLE:   runs of count (1-255), R, G, B
+ * WS_LIVE_ENC_DELTA: spans of start (2), count (2), count pixels that changed since the last frame, key frames are raw
+ * Frames are skipped while the client still has one queued, a delta is always against the last queued frame.
+ */
+#define WS_LIVE_ENC_RAW    0
+#define WS_LIVE_ENC_RLE    1
+#define WS_LIVE_ENC_DELTA  2
+#define WS_LIVE_HEADER     10
+#define WS_LIVE_KEYFRAMES  50 // every n'th delta frame is a key frame
+#define WS_LIVE_MAX_FPS    40
+
+#ifndef WS_MAX_LIVE_STREAMS
+  #ifdef ESP8266
+  #define WS_MAX_LIVE_STREAMS 1
+  #else
+  #define WS_MAX_LIVE_STREAMS 2
+  #endif
+#endif
+
+struct WsLiveStream {
+  uint32_t id;       // 0: free
+  uint16_t interval; // ms between frames
+  uint16_t frame;
+  uint16_t len;      // LEDs in pixels/prev
+  uint8_t  enc;
+  bool     prevValid;
+  unsigned long lastSent;
+  uint8_t* pixels;   // frame being encoded (RLE, delta)
+  uint8_t* prev;     // last queued frame (delta)
+};
+
+WsLiveStream wsLiveStreams[WS_MAX_LIVE_STREAMS] = {};
+
+static void freeLiveStream(WsLiveStream& s)
+{
+  free(s.pixels); free(s.prev);
+  s = WsLiveStream();
+}
+
+static void setWsLiveStream(uint32_t clientId, JsonVariant lv)
+{
+  WsLiveStream* s = nullptr;
+  for (uint8_t i = 0; i < WS_MAX_LIVE_STREAMS; i++) {
+    if (wsLiveStreams[i].id == clientId) freeLiveStream(wsLiveStreams[i]);
+    if (!s && !wsLiveStreams[i].id) s = &wsLiveStreams[i];
+  }
+  if (!lv.is<JsonObject>() || !s) return;
+  uint8_t fps = constrain(lv["fps"] | 15, 1, WS_LIVE_MAX_FPS);
+  s->id = clientId;
+  s->interval = 1000 / fps;
+  s->enc = constrain(lv["enc"] | WS_LIVE_ENC_RAW, WS_LIVE_ENC_RAW, WS_LIVE_ENC_DELTA);
+}
+
+//RGB of len pixels from n, bulk read from the bus output buffers
+static void readLivePixels(uint8_t* dst, uint16_t n, uint16_t len)
+{
+  uint32_t cols[64];
+  while (len) {
+    uint16_t count = len < 64 ? len : 64;
+    busses.getPixelColors(n, count, cols);
+    for (uint16_t k = 0; k < count; k++) {
+      uint32_t c = cols[k];
+      *dst++ = qadd8(W(c), R(c)); //add white channel to RGB channels as a simple RGBW -> RGB map
+      *dst++ = qadd8(W(c), G(c));
+      *dst++ = qadd8(W(c), B(c));
+    }
+    n += count; len -= count;
+  }
+}
+
+//encodes s.pixels, returns the payload size, only counts if out is nullptr
+static size_t encodeLivePixels(WsLiveStream& s, uint8_t* out, bool key)
+{
+  size_t size = 0;
+  const uint8_t* px = s.pixels;
+  if (s.enc == WS_LIVE_ENC_RLE) {
+    for (uint16_t i = 0; i < s.len;) {
+      uint16_t run = 1;
+      while (run < 255 && i + run < s.len && !memcmp(px + i*3, px + (i+run)*3, 3)) run++;
+      if (out) { out[size] = run; memcpy(out + size +1, px + i*3, 3); }
+      size += 4;
+      i += run;
+    }
+    return size;
+  }
+  if (key) { //raw
+    if (out) memcpy(out, px, s.len * 3);
+    return s.len * 3;
+  }
+  for (uint16_t i = 0; i < s.len;) { //delta, spans of changed pixels
+    if (!memcmp(px + i*3, s.prev + i*3, 3)) { i++; continue; }
+    uint16_t start = i;
+    while (i < s.len && memcmp(px + i*3, s.prev + i*3, 3)) i++;
+    uint16_t count = i - start;
+    if (out) {
+      out[size] = start & 0xFF; out[size+1] = start >> 8;
+      out[size+2] = count & 0xFF; out[size+3] = count >> 8;
+      memcpy(out + size +4, px + start*3, count*3);
+    }
+    size += 4 + count*3;
+  }
+  return size;
+}
+
+static bool sendLiveStreamWs(WsLiveStream& s)
+{
+  AsyncWebSocketClient * wsc = ws.client(s.id);
+  if (!wsc) { freeLiveStream(s); return true; }
+  if (wsc->queueLength() > 0) return false; //frame skipped, the client has not taken the last one yet
+
+  pixidx_t total = strip.getLengthTotal();
+  uint16_t used = total > UINT16_MAX ? UINT16_MAX : total; //the frame header has 16 bit, larger strips show their start
+  if (s.enc != WS_LIVE_ENC_RAW && s.len != used) {
+    free(s.pixels); free(s.prev);
+    s.pixels = (uint8_t*) malloc(used * 3);
+    s.prev   = (s.enc == WS_LIVE_ENC_DELTA && s.pixels) ? (uint8_t*) malloc(used * 3) : nullptr;
+    s.prevValid = false;
+    s.len = used;
+    if (!s.pixels || (s.enc == WS_LIVE_ENC_DELTA && !s.prev)) { //out of memory, stream uncompressed
+      memAllocFailed(MEM_WS);
+      free(s.pixels); free(s.prev);
+      s.pixels = s.prev = nullptr;
+      s.enc = WS_LIVE_ENC_RAW;
+    }
+  }
+
+  bool key = (s.enc != WS_LIVE_ENC_DELTA) || !s.prevValid || (s.frame % WS_LIVE_KEYFRAMES == 0);
+  size_t size = used * 3;
+  if (s.enc != WS_LIVE_ENC_RAW) {
+    readLivePixels(s.pixels, 0, used);
+    size = encodeLivePixels(s, nullptr, key);
+    if (!size) return true; //nothing changed
+  }
+
+  AsyncWebSocketMessageBuffer * wsBuf = ws.makeBuffer(WS_LIVE_HEADER + size);
+  if (!wsBuf) { memAllocFailed(MEM_WS); return false; } //out of memory
+  uint8_t* buffer = wsBuf->get();
+  uint16_t width = strip.getLedmapWidth();
+  buffer[0] = 'L';
+  buffer[1] = 2; //version
+  buffer[2] = s.enc;
+  buffer[3] = key;
+  buffer[4] = used & 0xFF;  buffer[5] = used >> 8;
+  buffer[6] = width & 0xFF; buffer[7] = width >> 8;
+  buffer[8] = s.frame & 0xFF; buffer[9] = s.frame >> 8;
+  if (s.enc == WS_LIVE_ENC_RAW) readLivePixels(buffer + WS_LIVE_HEADER, 0, used); //straight into the message
+  else encodeLivePixels(s, buffer + WS_LIVE_HEADER, key);
+  wsc->binary(wsBuf);
+
+  if (s.enc == WS_LIVE_ENC_DELTA) { std::swap(s.pixels, s.prev); s.prevValid = true; }
+  s.frame++;
+  return true;
+}
+
 void handleWs()
 {
+  for (uint8_t i = 0; i < WS_MAX_LIVE_STREAMS; i++) {
+    WsLiveStream& s = wsLiveStreams[i];
+    if (!s.id || millis() - s.lastSent < s.interval) continue;
+    s.lastSent = millis();
+    if (!sendLiveStreamWs(s)) s.lastSent -= s.interval / 2; //try again sooner
+  }
+
   if (millis() - wsLastLiveTime > WS_LIVE_INTERVAL)
   {
     #ifdef ESP8266
@@ -165,6 +710,8 @@ void handleWs()
     #else
     ws.cleanupClients();
     #endif
+    if (wsPushPending) sendDataWs();
+    handleWsPending();
     bool success = true;
     if (wsLiveClientId)
       success = sendLiveLedsWs(wsLiveClientId);
@@ -173,7 +720,36 @@ void handleWs()
   }
 }
 
+//heap held by subscriptions and live stream buffers, not the messages queued in the web server
+uint32_t wsMemUsage()
+{
+  uint32_t mem = 0;
+  for (uint8_t i = 0; i < WS_MAX_SUBSCRIBERS; i++) if (wsSubscribers[i]) mem += sizeof(WsSubscriber);
+  for (uint8_t i = 0; i < WS_MAX_LIVE_STREAMS; i++) {
+    WsLiveStream& s = wsLiveStreams[i];
+    if (s.pixels) mem += s.len * 3;
+    if (s.prev)   mem += s.len * 3;
+  }
+  return mem;
+}
+
+void serializeWsQueues(JsonObject root)
+{
+  JsonObject q = root.createNestedObject(F("wsq"));
+  uint8_t depth = 0, pending = 0;
+  for (auto c : ws.getClients()) {
+    if (c->status() == WS_CONNECTED && c->queueLength() > depth) depth = c->queueLength();
+  }
+  for (uint8_t i = 0; i < WS_MAX_PENDING; i++) if (wsPending[i].id) pending++;
+  q[F("max")]  = depth;           // longest client queue
+  q[F("lim")]  = WS_CLIENT_QUEUE;
+  q[F("pend")] = pending;         // clients waiting for their queue to drain
+  q[F("skip")] = wsCollapsed;
+  q[F("drop")] = wsSlowClosed;
+}
+
 #else
 void handleWs() {}
 void sendDataWs(AsyncWebSocketClient * client) {}
+uint32_t wsMemUsage() { return 0; }
 #endif
\ No newline at end of file
@@ -386,20 +386,21 @@ void getSettingsJS(byte subPage, char* dest)
     sappend('v',SET_F("FR"),strip.getTargetFps());
     sappend('v',SET_F("AW"),strip.autoWhiteMode);
 
-    for (uint8_t s=0; s < busses.getNumBusses(); s++) {
+    for (uint8_t s=0; s < busses.getNumConfiguredBusses(); s++) { // stream followers are added automatically
       Bus* bus = busses.getBus(s);
       if (bus == nullptr) continue;
-      char lp[4] = "L0"; lp[2] = 48+s; lp[3] = 0; //ascii 0-9 //strip data pin
-      char lc[4] = "LC"; lc[2] = 48+s; lc[3] = 0; //strip length
-      char co[4] = "CO"; co[2] = 48+s; co[3] = 0; //strip color order
-      char lt[4] = "LT"; lt[2] = 48+s; lt[3] = 0; //strip type
-      char ls[4] = "LS"; ls[2] = 48+s; ls[3] = 0; //strip start LED
-      char cv[4] = "CV"; cv[2] = 48+s; cv[3] = 0; //strip reverse
-      char sl[4] = "SL"; sl[2] = 48+s; sl[3] = 0; //skip 1st LED
-      char rf[4] = "RF"; rf[2] = 48+s; rf[3] = 0; //off refresh
+      char lp[5] = "L0"; setBusFieldIndex(lp, s); //strip data pin
+      char lc[5] = "LC"; setBusFieldIndex(lc, s); //strip length
+      char co[5] = "CO"; setBusFieldIndex(co, s); //strip color order
+      char lt[5] = "LT"; setBusFieldIndex(lt, s); //strip type
+      char ls[5] = "LS"; setBusFieldIndex(ls, s); //strip start LED
+      char cv[5] = "CV"; setBusFieldIndex(cv, s); //strip reverse
+      char sl[5] = "SL"; setBusFieldIndex(sl, s); //skip 1st LED
+      char rf[5] = "RF"; setBusFieldIndex(rf, s); //off refresh
       oappend(SET_F("addLEDs(1);"));
       uint8_t pins[5];
       uint8_t nPins = bus->getPins(pins);
+      if (bus->getSections() > 1) nPins = 1; // section pins are not part of the settings page
       for (uint8_t i = 0; i < nPins; i++) {
         lp[1] = 48+i;
         if (pinManager.isPinOk(pins[i]) || bus->getType()>=TYPE_NET_DDP_RGB) sappend('v',lp,pins[i]);
@@ -473,40 +474,11 @@ void getSettingsJS(byte subPage, char* dest)
 
   if (subPage == 4)
   {
-    sappend('v',SET_F("UP"),udpPort);
-    sappend('v',SET_F("U2"),udpPort2);
-    sappend('v',SET_F("GS"),syncGroups);
-    sappend('v',SET_F("GR"),receiveGroups);
-
-    sappend('c',SET_F("RB"),receiveNotificationBrightness);
-    sappend('c',SET_F("RC"),receiveNotificationColor);
-    sappend('c',SET_F("RX"),receiveNotificationEffects);
-    sappend('c',SET_F("SO"),receiveSegmentOptions);
-    sappend('c',SET_F("SG"),receiveSegmentBounds);
+    getCfgSchemaJS(subPage); // ports, groups and checkboxes listed in cfgSchema (cfg.cpp)
     sappend('c',SET_F("SD"),notifyDirectDefault);
-    sappend('c',SET_F("SB"),notifyButton);
-    sappend('c',SET_F("SH"),notifyHue);
-    sappend('c',SET_F("SM"),notifyMacro);
-    sappend('c',SET_F("S2"),notifyTwice);
-
-    sappend('c',SET_F("NL"),nodeListEnabled);
-    sappend('c',SET_F("NB"),nodeBroadcastEnabled);
-
-    sappend('c',SET_F("RD"),receiveDirect);
-    sappend('c',SET_F("MO"),useMainSegmentOnly);
-    sappend('v',SET_F("EP"),e131Port);
-    sappend('c',SET_F("ES"),e131SkipOutOfSequence);
-    sappend('c',SET_F("EM"),e131Multicast);
-    sappend('v',SET_F("EU"),e131Universe);
-    sappend('v',SET_F("DA"),DMXAddress);
-    sappend('v',SET_F("DM"),DMXMode);
     sappend('v',SET_F("ET"),realtimeTimeoutMs);
-    sappend('c',SET_F("FB"),arlsForceMaxBri);
-    sappend('c',SET_F("RG"),arlsDisableGammaCorrection);
-    sappend('v',SET_F("WO"),arlsOffset);
     sappend('c',SET_F("AL"),alexaEnabled);
     sappends('s',SET_F("AI"),alexaInvocationName);
-    sappend('c',SET_F("SA"),notifyAlexa);
     sappends('s',SET_F("BK"),(char*)((blynkEnabled)?SET_F("Hidden"):""));
     #ifndef WLED_DISABLE_BLYNK
     sappends('s',SET_F("BH"),blynkHost);